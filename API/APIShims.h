@@ -29,6 +29,7 @@
 #include "CallFrame.h"
 #include "GCActivityCallback.h"
 #include "JSLock.h"
+#include "Watchdog.h"
 #include <wtf/WTFThreadData.h>
 
 namespace JSC {
@@ -38,18 +39,24 @@ protected:
     APIEntryShimWithoutLock(JSGlobalData* globalData, bool registerThread)
         : m_globalData(globalData)
         , m_entryIdentifierTable(wtfThreadData().setCurrentIdentifierTable(globalData->identifierTable))
+        , m_watchdog(globalData->watchdog)
     {
         UNUSED_PARAM(registerThread);
+        ASSERT(globalData->isOnConfinedThread());
 #if ENABLE(JSC_MULTIPLE_THREADS)
-        if (registerThread)
+        if (registerThread && !globalData->isThreadConfined())
             globalData->heap.machineThreads().addCurrentThread();
 #endif
         m_globalData->heap.activityCallback()->synchronize();
         m_globalData->timeoutChecker.start();
+        if (m_watchdog)
+            m_watchdog->willEnterVM();
     }
 
     ~APIEntryShimWithoutLock()
     {
+        if (m_watchdog)
+            m_watchdog->didExitVM();
         m_globalData->timeoutChecker.stop();
         wtfThreadData().setCurrentIdentifierTable(m_entryIdentifierTable);
     }
@@ -57,6 +64,9 @@ protected:
 private:
     JSGlobalData* m_globalData;
     IdentifierTable* m_entryIdentifierTable;
+    // Captured on entry so that a watchdog created while inside the VM is
+    // not told about an exit it never saw the entry for.
+    Watchdog* m_watchdog;
 };
 
 class APIEntryShim : public APIEntryShimWithoutLock {
@@ -64,25 +74,29 @@ public:
     // Normal API entry
     APIEntryShim(ExecState* exec, bool registerThread = true)
         : APIEntryShimWithoutLock(&exec->globalData(), registerThread)
-        , m_lock(exec)
+        , m_lock(lockBehavior(&exec->globalData()))
     {
     }
 
     // JSPropertyNameAccumulator only has a globalData.
     APIEntryShim(JSGlobalData* globalData, bool registerThread = true)
         : APIEntryShimWithoutLock(globalData, registerThread)
-        , m_lock(globalData->isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
+        , m_lock(lockBehavior(globalData))
     {
     }
 
 private:
+    // Only the shared instance locks for real. The inline JSLock constructor makes that check
+    // free in release builds for everything else, thread-confined groups included.
+    static JSLockBehavior lockBehavior(JSGlobalData* globalData) { return globalData->isSharedInstance() ? LockForReal : SilenceAssertionsOnly; }
+
     JSLock m_lock;
 };
 
 class APICallbackShim {
 public:
     APICallbackShim(ExecState* exec)
-        : m_dropAllLocks(exec)
+        : m_dropAllLocks(exec->globalData().isThreadConfined() ? JSLock::DropAllLocks::DropNone : JSLock::DropAllLocks::DropAll, exec)
         , m_globalData(&exec->globalData())
     {
         wtfThreadData().resetCurrentIdentifierTable();
@@ -30,7 +30,9 @@
 #include "APICast.h"
 #include "APIShims.h"
 #include "OpaqueJSString.h"
+#include "ScriptSourceCache.h"
 #include "SourceCode.h"
+#include <JSSettingsEA.h>
 #include <interpreter/CallFrame.h>
 #include <runtime/InitializeThreading.h>
 #include <runtime/Completion.h>
@@ -50,7 +52,10 @@ JSValueRef JSEvaluateScript(JSContextRef ctx, JSStringRef script, JSObjectRef th
 
     // evaluate sets "this" to the global object if it is NULL
     JSGlobalObject* globalObject = exec->dynamicGlobalObject();
-    SourceCode source = makeSource(script->ustring(), sourceURL->ustring(), startingLineNumber);
+    // Parsing has to happen here, on the thread that owns the context group. The parser
+    // allocates Identifiers from that thread's identifier table and function bodies are
+    // only syntax checked until first call, so the eager cost is a single lexing pass.
+    SourceCode source = exec->globalData().scriptSourceCache->sourceFor(script->ustring(), sourceURL->ustring(), startingLineNumber, JSGetCompressedSourceThreshold());
 
     JSValue evaluationException;
     JSValue returnValue = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), source, jsThisObject, &evaluationException);
@@ -45,6 +45,51 @@ region.
 */
 JS_EXPORT void JSReportExtraMemoryCost(JSContextRef ctx, size_t size) AVAILABLE_IN_WEBKIT_VERSION_4_0;
 
+/*! @typedef JSValueHandleRef A strong reference that keeps a JavaScript value alive until it is released. */
+typedef struct OpaqueJSValueHandle* JSValueHandleRef;
+
+/*!
+@function
+@abstract Protects a JavaScript value from garbage collection through a handle.
+@param ctx The execution context to use.
+@param value The JSValue to protect. This may be NULL.
+@result A JSValueHandle that keeps value alive until it is passed to JSValueHandleRelease.
+@discussion Unlike JSValueProtect, which counts protections in a hash table
+searched on every call, a handle is a slot in the garbage collector's handle
+heap: creating, updating and releasing one take constant time, and the
+collector visits handles in sequence rather than walking a hash table. Use
+handles when native code protects many values, for instance one per native
+object wrapping a JavaScript object.
+*/
+JS_EXPORT JSValueHandleRef JSValueHandleCreate(JSContextRef ctx, JSValueRef value);
+
+/*!
+@function
+@abstract Gets the value a JavaScript value handle protects.
+@param ctx The execution context to use.
+@param handle The JSValueHandle whose value you want to get.
+@result The JSValue handle protects, or NULL if it was created with NULL.
+*/
+JS_EXPORT JSValueRef JSValueHandleGetValue(JSContextRef ctx, JSValueHandleRef handle);
+
+/*!
+@function
+@abstract Changes the value a JavaScript value handle protects.
+@param ctx The execution context to use.
+@param handle The JSValueHandle whose value you want to set.
+@param value The JSValue to protect instead. This may be NULL.
+@discussion The value handle previously protected becomes eligible for garbage collection, unless something else keeps it alive.
+*/
+JS_EXPORT void JSValueHandleSetValue(JSContextRef ctx, JSValueHandleRef handle, JSValueRef value);
+
+/*!
+@function
+@abstract Releases a JavaScript value handle.
+@param ctx The execution context to use.
+@param handle The JSValueHandle to release. Its value becomes eligible for garbage collection, unless something else keeps it alive.
+*/
+JS_EXPORT void JSValueHandleRelease(JSContextRef ctx, JSValueHandleRef handle);
+
 #ifdef __cplusplus
 }
 #endif
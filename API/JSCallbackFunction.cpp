@@ -42,9 +42,10 @@ ASSERT_CLASS_FITS_IN_CELL(JSCallbackFunction);
 
 const ClassInfo JSCallbackFunction::s_info = { "CallbackFunction", &InternalFunction::s_info, 0, 0 };
 
-JSCallbackFunction::JSCallbackFunction(JSGlobalObject* globalObject, JSObjectCallAsFunctionCallback callback)
+JSCallbackFunction::JSCallbackFunction(JSGlobalObject* globalObject, JSObjectCallAsFunctionCallback callback, JSFunctionAttributes attributes)
     : InternalFunction(globalObject, globalObject->callbackFunctionStructure())
     , m_callback(callback)
+    , m_attributes(attributes)
 {
 }
 
@@ -77,9 +78,36 @@ EncodedJSValue JSCallbackFunction::call(ExecState* exec)
     return JSValue::encode(toJS(exec, result));
 }
 
+// For callbacks that promise not to call back into JavaScript, throw, or block: the
+// locks stay held across the call, and on JSVALUE64, where a JSValueRef is an encoded
+// JSValue, the callback reads its arguments straight out of the register file.
+EncodedJSValue JSCallbackFunction::callDoesNotReenter(ExecState* exec)
+{
+    JSContextRef execRef = toRef(exec);
+    JSObjectRef functionRef = toRef(exec->callee());
+    JSObjectRef thisObjRef = toRef(exec->hostThisValue().toThisObject(exec));
+
+    int argumentCount = static_cast<int>(exec->argumentCount());
+#if USE(JSVALUE64)
+    const JSValueRef* arguments = reinterpret_cast<const JSValueRef*>(exec->registers() + exec->hostThisRegister() + 1);
+#else
+    Vector<JSValueRef, 16> argumentVector(argumentCount);
+    for (int i = 0; i < argumentCount; i++)
+        argumentVector[i] = toRef(exec, exec->argument(i));
+    const JSValueRef* arguments = argumentVector.data();
+#endif
+
+    JSValueRef exception = 0;
+    JSValueRef result = static_cast<JSCallbackFunction*>(toJS(functionRef))->m_callback(execRef, functionRef, thisObjRef, argumentCount, arguments, &exception);
+    if (UNLIKELY(!!exception))
+        throwError(exec, toJS(exec, exception));
+
+    return JSValue::encode(toJS(exec, result));
+}
+
 CallType JSCallbackFunction::getCallData(CallData& callData)
 {
-    callData.native.function = call;
+    callData.native.function = (m_attributes & kJSFunctionAttributeDoesNotReenter) ? callDoesNotReenter : call;
     return CallTypeHost;
 }
 
@@ -28,20 +28,21 @@
 
 #include "InternalFunction.h"
 #include "JSObjectRef.h"
+#include "JSObjectRefPrivate.h"
 
 namespace JSC {
 
 class JSCallbackFunction : public InternalFunction {
 protected:
-    JSCallbackFunction(JSGlobalObject*, JSObjectCallAsFunctionCallback);
+    JSCallbackFunction(JSGlobalObject*, JSObjectCallAsFunctionCallback, JSFunctionAttributes);
     void finishCreation(JSGlobalData&, const Identifier& name);
 
 public:
     typedef InternalFunction Base;
 
-    static JSCallbackFunction* create(ExecState* exec, JSGlobalObject* globalObject, JSObjectCallAsFunctionCallback callback, const Identifier& name)
+    static JSCallbackFunction* create(ExecState* exec, JSGlobalObject* globalObject, JSObjectCallAsFunctionCallback callback, const Identifier& name, JSFunctionAttributes attributes = kJSFunctionAttributeNone)
     {
-        JSCallbackFunction* function = new (allocateCell<JSCallbackFunction>(*exec->heap())) JSCallbackFunction(globalObject, callback);
+        JSCallbackFunction* function = new (allocateCell<JSCallbackFunction>(*exec->heap())) JSCallbackFunction(globalObject, callback, attributes);
         function->finishCreation(exec->globalData(), name);
         return function;
     }
@@ -59,8 +60,10 @@ private:
     virtual CallType getCallData(CallData&);
 
     static EncodedJSValue JSC_HOST_CALL call(ExecState*);
+    static EncodedJSValue JSC_HOST_CALL callDoesNotReenter(ExecState*);
 
     JSObjectCallAsFunctionCallback m_callback;
+    JSFunctionAttributes m_attributes;
 };
 
 } // namespace JSC
@@ -154,6 +154,10 @@ public:
     { 
         return Structure::create(globalData, globalObject, proto, TypeInfo(ObjectType, StructureFlags), &s_info); 
     }
+
+    // A Structure only ever used by objects of one class identifies that class, so property accesses
+    // on it may be cached whenever none of the class chain's callbacks can change what a lookup finds.
+    static Structure* createStructureForClass(JSGlobalData&, JSGlobalObject*, JSValue proto, JSClassRef);
     
     JSValue getPrivateProperty(const Identifier& propertyName) const
     {
@@ -211,6 +215,7 @@ private:
     static EncodedJSValue JSC_HOST_CALL construct(ExecState*);
    
     JSValue getStaticValue(ExecState*, const Identifier&);
+    static JSValue staticValueGetter(ExecState*, JSValue, const Identifier&);
     static JSValue staticFunctionGetter(ExecState*, JSValue, const Identifier&);
     static JSValue callbackGetter(ExecState*, JSValue, const Identifier&);
 
@@ -49,6 +49,18 @@ inline JSCallbackObject<Parent>* JSCallbackObject<Parent>::asCallbackObject(JSVa
     return static_cast<JSCallbackObject*>(asObject(value));
 }
 
+template <class Parent>
+Structure* JSCallbackObject<Parent>::createStructureForClass(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue proto, JSClassRef classRef)
+{
+    unsigned flags = StructureFlags;
+    bool hasLookupCallbacks = false;
+    for (JSClassRef jsClass = classRef; jsClass && !hasLookupCallbacks; jsClass = jsClass->parentClass)
+        hasLookupCallbacks = jsClass->hasProperty || jsClass->getProperty || jsClass->setProperty;
+    if (!hasLookupCallbacks)
+        flags &= ~ProhibitsPropertyCaching;
+    return Structure::create(globalData, globalObject, proto, TypeInfo(ObjectType, flags), &s_info);
+}
+
 template <class Parent>
 JSCallbackObject<Parent>::JSCallbackObject(ExecState* exec, Structure* structure, JSClassRef jsClass, void* data)
     : Parent(exec->globalData(), structure)
@@ -131,6 +143,9 @@ bool JSCallbackObject<Parent>::getOwnPropertySlot(ExecState* exec, const Identif
     JSContextRef ctx = toRef(exec);
     JSObjectRef thisRef = toRef(this);
     RefPtr<OpaqueJSString> propertyNameRef;
+    // Only Structures made by createStructureForClass drop this flag, so what this lookup finds is
+    // fixed by the Structure and the JIT may cache it.
+    bool isCacheable = !Parent::structure()->typeInfo().prohibitsPropertyCaching();
     
     for (JSClassRef jsClass = classRef(); jsClass; jsClass = jsClass->parentClass) {
         // optional optimization to bypass getProperty in cases when we only need to know if the property exists
@@ -166,7 +181,10 @@ bool JSCallbackObject<Parent>::getOwnPropertySlot(ExecState* exec, const Identif
             if (staticValues->contains(propertyName.impl())) {
                 JSValue value = getStaticValue(exec, propertyName);
                 if (value) {
-                    slot.setValue(value);
+                    if (isCacheable)
+                        slot.setCacheableCustomValue(this, value, staticValueGetter);
+                    else
+                        slot.setValue(value);
                     return true;
                 }
             }
@@ -174,6 +192,9 @@ bool JSCallbackObject<Parent>::getOwnPropertySlot(ExecState* exec, const Identif
         
         if (OpaqueJSClassStaticFunctionsTable* staticFunctions = jsClass->staticFunctions(exec)) {
             if (staticFunctions->contains(propertyName.impl())) {
+                // Once the function object has been made it is an ordinary property, which can be cached.
+                if (isCacheable && Parent::getOwnPropertySlot(exec, propertyName, slot))
+                    return true;
                 slot.setCustom(this, staticFunctionGetter);
                 return true;
             }
@@ -560,6 +581,33 @@ JSValue JSCallbackObject<Parent>::getStaticValue(ExecState* exec, const Identifi
     return JSValue();
 }
 
+// Called directly by JIT caches of static values, which skip getOwnPropertySlot.
+template <class Parent>
+JSValue JSCallbackObject<Parent>::staticValueGetter(ExecState* exec, JSValue slotParent, const Identifier& propertyName)
+{
+    JSCallbackObject* thisObj = asCallbackObject(slotParent);
+    if (JSValue value = thisObj->getStaticValue(exec, propertyName))
+        return value;
+
+    // Every getter declined. Cacheable classes have no lookup callbacks, so what
+    // getOwnPropertySlot would have found next is a static function, an own
+    // property, or something on the prototype chain.
+    for (JSClassRef jsClass = thisObj->classRef(); jsClass; jsClass = jsClass->parentClass) {
+        if (OpaqueJSClassStaticFunctionsTable* staticFunctions = jsClass->staticFunctions(exec)) {
+            if (staticFunctions->contains(propertyName.impl()))
+                return staticFunctionGetter(exec, slotParent, propertyName);
+        }
+    }
+
+    PropertySlot slot(thisObj);
+    if (thisObj->Parent::getOwnPropertySlot(exec, propertyName, slot))
+        return slot.getValue(exec, propertyName);
+    JSValue prototype = thisObj->prototype();
+    if (prototype.isObject() && asObject(prototype)->getPropertySlot(exec, propertyName, slot))
+        return slot.getValue(exec, propertyName);
+    return jsUndefined();
+}
+
 template <class Parent>
 JSValue JSCallbackObject<Parent>::staticFunctionGetter(ExecState* exec, JSValue slotParent, const Identifier& propertyName)
 {
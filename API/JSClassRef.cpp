@@ -251,11 +251,26 @@ JSObject* OpaqueJSClass::prototype(ExecState* exec)
 
     if (!jsClassData.cachedPrototype) {
         // Recursive, but should be good enough for our purposes
-        jsClassData.cachedPrototype.set(exec->globalData(), JSCallbackObject<JSNonFinalObject>::create(exec, exec->lexicalGlobalObject(), exec->lexicalGlobalObject()->callbackObjectStructure(), prototypeClass, &jsClassData), 0); // set jsClassData as the object's private data, so it can clear our reference on destruction
-        if (parentClass) {
-            if (JSObject* prototype = parentClass->prototype(exec))
-                jsClassData.cachedPrototype->setPrototype(exec->globalData(), prototype);
-        }
+        JSObject* parentPrototype = parentClass ? parentClass->prototype(exec) : 0;
+        if (!parentPrototype)
+            parentPrototype = exec->lexicalGlobalObject()->objectPrototype();
+        jsClassData.cachedPrototype.set(exec->globalData(), JSCallbackObject<JSNonFinalObject>::create(exec, exec->lexicalGlobalObject(), prototypeClass->structure(exec, parentPrototype), prototypeClass, &jsClassData), 0); // set jsClassData as the object's private data, so it can clear our reference on destruction
     }
     return jsClassData.cachedPrototype.get();
 }
+
+// Objects of one class share a Structure, rather than each making its own with a prototype
+// transition, so that accesses to them can be cached.
+Structure* OpaqueJSClass::structure(ExecState* exec, JSObject* prototype)
+{
+    OpaqueJSClassContextData& jsClassData = contextData(exec);
+    JSGlobalObject* globalObject = exec->lexicalGlobalObject();
+
+    // Context data is shared by every global object in a context group.
+    Structure* structure = jsClassData.cachedStructure.get();
+    if (!structure || structure->globalObject() != globalObject || structure->storedPrototype() != prototype) {
+        structure = JSCallbackObject<JSNonFinalObject>::createStructureForClass(exec->globalData(), globalObject, prototype, this);
+        jsClassData.cachedStructure.set(exec->globalData(), structure, 0);
+    }
+    return structure;
+}
@@ -83,6 +83,7 @@ public:
     OpaqueJSClassStaticValuesTable* staticValues;
     OpaqueJSClassStaticFunctionsTable* staticFunctions;
     JSC::Weak<JSC::JSObject> cachedPrototype;
+    JSC::Weak<JSC::Structure> cachedStructure;
 };
 
 struct OpaqueJSClass : public ThreadSafeRefCounted<OpaqueJSClass> {
@@ -94,6 +95,7 @@ struct OpaqueJSClass : public ThreadSafeRefCounted<OpaqueJSClass> {
     OpaqueJSClassStaticValuesTable* staticValues(JSC::ExecState*);
     OpaqueJSClassStaticFunctionsTable* staticFunctions(JSC::ExecState*);
     JSC::JSObject* prototype(JSC::ExecState*);
+    JSC::Structure* structure(JSC::ExecState*, JSC::JSObject* prototype);
 
     OpaqueJSClass* parentClass;
     OpaqueJSClass* prototypeClass;
@@ -53,6 +53,35 @@ JSContextGroupRef JSContextGroupCreate()
     return toRef(JSGlobalData::createContextGroup(ThreadStackTypeSmall).leakRef());
 }
 
+JSContextGroupRef JSContextGroupCreateThreadConfined()
+{
+    initializeThreading();
+    RefPtr<JSGlobalData> globalData = JSGlobalData::createContextGroup(ThreadStackTypeSmall);
+    globalData->setThreadConfined();
+    return toRef(globalData.release().leakRef());
+}
+
+JSContextGroupRef JSContextGroupCreateThreadConfinedSharingBuiltins(JSContextGroupRef group)
+{
+    initializeThreading();
+    JSGlobalData* builtinsSource = toJS(group);
+    if (builtinsSource->globalDataType != JSGlobalData::APIContextGroup || !builtinsSource->isThreadConfined() || !builtinsSource->isOnConfinedThread())
+        return 0;
+    return toRef(JSGlobalData::createContextGroupSharingBuiltins(builtinsSource, ThreadStackTypeSmall).leakRef());
+}
+
+void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef group, unsigned limit)
+{
+    JSGlobalData* globalData = toJS(group);
+    APIEntryShim entryShim(globalData);
+    if (!globalData->watchdog) {
+        if (!limit)
+            return;
+        globalData->watchdog = new Watchdog(globalData);
+    }
+    globalData->watchdog->setTimeLimit(limit);
+}
+
 JSContextGroupRef JSContextGroupRetain(JSContextGroupRef group)
 {
     toJS(group)->ref();
@@ -93,7 +122,8 @@ JSGlobalContextRef JSGlobalContextCreateInGroup(JSContextGroupRef group, JSClass
     APIEntryShim entryShim(globalData.get(), false);
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
-    globalData->makeUsableFromMultipleThreads();
+    if (!globalData->isThreadConfined())
+        globalData->makeUsableFromMultipleThreads();
 #endif
 
     if (!globalObjectClass) {
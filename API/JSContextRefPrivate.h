@@ -54,6 +54,42 @@ JS_EXPORT JSGlobalContextRef JSContextGetGlobalContext(JSContextRef ctx);
 @result A string containing the backtrace
 */
 JS_EXPORT JSStringRef JSContextCreateBacktrace(JSContextRef ctx, unsigned maxStackSize) AVAILABLE_IN_WEBKIT_VERSION_4_0;
+
+/*!
+@function
+@abstract Creates a JavaScript context group that may only be used from the calling thread.
+@result The created JSContextGroup.
+@discussion The group and every context created in it must only ever be used from the thread
+ that called this function, including retaining and releasing them. In exchange, entering and
+ leaving JavaScript through the API, and calling back out of it, skip the locking and thread
+ registration done for other groups. Debug builds assert that the calling thread is the right one.
+*/
+JS_EXPORT JSContextGroupRef JSContextGroupCreateThreadConfined(void);
+
+/*!
+@function
+@abstract Creates a thread-confined JavaScript context group that shares built-in data with another.
+@param group A group created by JSContextGroupCreateThreadConfined on the calling thread.
+@result The created JSContextGroup, or NULL if group is not thread-confined to the calling thread.
+@discussion The new group has its own heap, but shares group's identifier table, the names the
+ engine uses internally and the property tables of the built-in objects, so each extra group costs
+ less memory and identifiers are only stored once. Both groups must only be used from the calling
+ thread. Either may be released first.
+*/
+JS_EXPORT JSContextGroupRef JSContextGroupCreateThreadConfinedSharingBuiltins(JSContextGroupRef group);
+
+/*!
+@function
+@abstract Limits how long script may run each time the API enters a context group.
+@param group The JSContextGroup to limit.
+@param limit The limit in milliseconds, or 0 to remove it.
+@discussion The limit is enforced by a watchdog thread, created the first time a limit is set,
+ which terminates the script with an uncatchable exception once it has run past the limit.
+ Termination is noticed at the engine's periodic execution checks, so it can come slightly late,
+ and script blocked in a native callback is not interrupted until it returns. Nested entries
+ from callbacks count toward the outermost entry's limit.
+*/
+JS_EXPORT void JSContextGroupSetExecutionTimeLimit(JSContextGroupRef group, unsigned limit);
     
 #ifdef __cplusplus
 }
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2012 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSMessageQueueRefPrivate.h"
+
+#include "APICast.h"
+#include "APIShims.h"
+#include "Error.h"
+#include "JSArray.h"
+#include "JSGlobalObject.h"
+#include "JSTypedArray.h"
+#include "PropertyNameArray.h"
+#include <wtf/HashMap.h>
+#include <wtf/MessageQueue.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+using namespace JSC;
+
+namespace {
+
+enum CloneTag {
+    UndefinedTag,
+    NullTag,
+    TrueTag,
+    FalseTag,
+    NumberTag,
+    StringTag,
+    ArrayTag,
+    ObjectTag,
+    ArrayBufferTag,
+    TypedArrayTag,
+    ObjectReferenceTag
+};
+
+// Deeper values are rejected rather than risk running out of machine stack.
+static const unsigned maximumCloneDepth = 2048;
+
+// A value taken out of one heap in a form another thread can rebuild in its own.
+// m_code holds a tag for each value followed by its operands; numbers, strings
+// and buffers are stored on the side and referred to by index. Every object gets
+// an index in the order it is first written, which the reader reproduces, so a
+// repeated object is written as a reference to that index.
+class ClonedValue {
+    WTF_MAKE_NONCOPYABLE(ClonedValue); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static PassOwnPtr<ClonedValue> create(ExecState*, JSValue);
+
+    JSValue deserialize(ExecState*) const;
+
+private:
+    typedef HashMap<JSObject*, unsigned> ObjectIndexMap;
+    typedef HashMap<ArrayBufferStorage*, unsigned> BufferIndexMap;
+
+    ClonedValue() { }
+
+    bool write(ExecState*, JSValue, unsigned depth, ObjectIndexMap&, BufferIndexMap&);
+    void writeString(StringImpl*);
+    unsigned bufferIndex(ArrayBufferStorage*, BufferIndexMap&);
+
+    JSValue read(ExecState*, size_t& position, MarkedArgumentBuffer& objects, Vector<JSArrayBuffer*>& buffers, MarkedArgumentBuffer& bufferObjects) const;
+    JSArrayBuffer* bufferAt(ExecState*, unsigned index, Vector<JSArrayBuffer*>& buffers, MarkedArgumentBuffer& bufferObjects) const;
+
+    Vector<unsigned> m_code;
+    Vector<double> m_numbers;
+    Vector<RefPtr<StringImpl> > m_strings;
+    Vector<RefPtr<ArrayBufferStorage> > m_buffers;
+};
+
+PassOwnPtr<ClonedValue> ClonedValue::create(ExecState* exec, JSValue value)
+{
+    OwnPtr<ClonedValue> clone = adoptPtr(new ClonedValue);
+    ObjectIndexMap objects;
+    BufferIndexMap buffers;
+    if (!clone->write(exec, value, 0, objects, buffers))
+        return nullptr;
+    return clone.release();
+}
+
+void ClonedValue::writeString(StringImpl* string)
+{
+    // crossThreadString hands over a shared buffer when the string has one and
+    // copies the characters otherwise; either way the result belongs to no heap.
+    m_code.append(StringTag);
+    m_code.append(m_strings.size());
+    m_strings.append(string ? string->crossThreadString() : PassRefPtr<StringImpl>(StringImpl::empty()));
+}
+
+unsigned ClonedValue::bufferIndex(ArrayBufferStorage* storage, BufferIndexMap& buffers)
+{
+    std::pair<BufferIndexMap::iterator, bool> result = buffers.add(storage, m_buffers.size());
+    if (result.second)
+        m_buffers.append(storage);
+    return result.first->second;
+}
+
+bool ClonedValue::write(ExecState* exec, JSValue value, unsigned depth, ObjectIndexMap& objects, BufferIndexMap& buffers)
+{
+    if (value.isUndefined()) {
+        m_code.append(UndefinedTag);
+        return true;
+    }
+    if (value.isNull()) {
+        m_code.append(NullTag);
+        return true;
+    }
+    if (value.isBoolean()) {
+        m_code.append(value.getBoolean() ? TrueTag : FalseTag);
+        return true;
+    }
+    if (value.isNumber()) {
+        m_code.append(NumberTag);
+        m_code.append(m_numbers.size());
+        m_numbers.append(value.uncheckedGetNumber());
+        return true;
+    }
+    if (value.isString()) {
+        UString string = asString(value)->value(exec);
+        if (exec->hadException())
+            return false;
+        writeString(string.impl());
+        return true;
+    }
+
+    ASSERT(value.isObject());
+    JSObject* object = asObject(value);
+    ObjectIndexMap::iterator found = objects.find(object);
+    if (found != objects.end()) {
+        m_code.append(ObjectReferenceTag);
+        m_code.append(found->second);
+        return true;
+    }
+
+    CallData callData;
+    if (getCallData(object, callData) != CallTypeNone) {
+        throwError(exec, createTypeError(exec, "Functions cannot be posted to a message queue."));
+        return false;
+    }
+    if (depth >= maximumCloneDepth) {
+        throwError(exec, createRangeError(exec, "Value is nested too deeply to be posted to a message queue."));
+        return false;
+    }
+    objects.add(object, objects.size());
+
+    if (object->inherits(&JSArrayBuffer::s_info)) {
+        m_code.append(ArrayBufferTag);
+        m_code.append(bufferIndex(asArrayBuffer(object)->storage(), buffers));
+        return true;
+    }
+
+    if (isJSTypedArray(&exec->globalData(), object)) {
+        JSTypedArray* array = asTypedArray(object);
+        m_code.append(TypedArrayTag);
+        m_code.append(array->type());
+        m_code.append(bufferIndex(array->storage(), buffers));
+        m_code.append(array->byteOffset());
+        m_code.append(array->length());
+        return true;
+    }
+
+    if (isJSArray(&exec->globalData(), object)) {
+        JSArray* array = asArray(object);
+        unsigned length = array->length();
+        m_code.append(ArrayTag);
+        m_code.append(length);
+        for (unsigned i = 0; i < length; ++i) {
+            JSValue element = array->get(exec, i);
+            if (exec->hadException())
+                return false;
+            if (!write(exec, element, depth + 1, objects, buffers))
+                return false;
+        }
+        return true;
+    }
+
+    PropertyNameArray propertyNames(exec);
+    object->getOwnPropertyNames(exec, propertyNames);
+    m_code.append(ObjectTag);
+    m_code.append(propertyNames.size());
+    for (size_t i = 0; i < propertyNames.size(); ++i) {
+        const Identifier& propertyName = propertyNames[i];
+        JSValue propertyValue = object->get(exec, propertyName);
+        if (exec->hadException())
+            return false;
+        writeString(propertyName.impl());
+        if (!write(exec, propertyValue, depth + 1, objects, buffers))
+            return false;
+    }
+    return true;
+}
+
+JSValue ClonedValue::deserialize(ExecState* exec) const
+{
+    // The rebuilt objects are only reachable from here until the value is
+    // returned, so they are kept in marked lists.
+    MarkedArgumentBuffer objects;
+    MarkedArgumentBuffer bufferObjects;
+    Vector<JSArrayBuffer*> buffers(m_buffers.size());
+    buffers.fill(0);
+    size_t position = 0;
+    JSValue result = read(exec, position, objects, buffers, bufferObjects);
+    ASSERT(position == m_code.size());
+    return result;
+}
+
+JSArrayBuffer* ClonedValue::bufferAt(ExecState* exec, unsigned index, Vector<JSArrayBuffer*>& buffers, MarkedArgumentBuffer& bufferObjects) const
+{
+    if (!buffers[index]) {
+        buffers[index] = JSArrayBuffer::create(exec, exec->lexicalGlobalObject()->arrayBufferStructure(), m_buffers[index]);
+        bufferObjects.append(buffers[index]);
+    }
+    return buffers[index];
+}
+
+JSValue ClonedValue::read(ExecState* exec, size_t& position, MarkedArgumentBuffer& objects, Vector<JSArrayBuffer*>& buffers, MarkedArgumentBuffer& bufferObjects) const
+{
+    switch (m_code[position++]) {
+    case UndefinedTag:
+        return jsUndefined();
+    case NullTag:
+        return jsNull();
+    case TrueTag:
+        return jsBoolean(true);
+    case FalseTag:
+        return jsBoolean(false);
+    case NumberTag:
+        return jsNumber(m_numbers[m_code[position++]]);
+    case StringTag:
+        return jsString(exec, UString(m_strings[m_code[position++]].get()));
+    case ObjectReferenceTag:
+        return objects.at(m_code[position++]);
+    case ArrayBufferTag: {
+        JSArrayBuffer* buffer = bufferAt(exec, m_code[position++], buffers, bufferObjects);
+        objects.append(buffer);
+        return buffer;
+    }
+    case TypedArrayTag: {
+        TypedArrayType type = static_cast<TypedArrayType>(m_code[position++]);
+        JSArrayBuffer* buffer = bufferAt(exec, m_code[position++], buffers, bufferObjects);
+        unsigned byteOffset = m_code[position++];
+        unsigned length = m_code[position++];
+        JSTypedArray* array = JSTypedArray::create(exec, exec->lexicalGlobalObject()->typedArrayStructure(type), type, buffer, byteOffset, length);
+        objects.append(array);
+        return array;
+    }
+    case ArrayTag: {
+        unsigned length = m_code[position++];
+        JSArray* array = constructEmptyArray(exec, length);
+        objects.append(array);
+        for (unsigned i = 0; i < length; ++i)
+            array->put(exec, i, read(exec, position, objects, buffers, bufferObjects));
+        return array;
+    }
+    case ObjectTag: {
+        unsigned propertyCount = m_code[position++];
+        JSObject* object = constructEmptyObject(exec);
+        objects.append(object);
+        for (unsigned i = 0; i < propertyCount; ++i) {
+            ASSERT(m_code[position] == StringTag);
+            Identifier propertyName(exec, UString(m_strings[m_code[position + 1]].get()));
+            position += 2;
+            object->putDirect(exec->globalData(), propertyName, read(exec, position, objects, buffers, bufferObjects));
+        }
+        return object;
+    }
+    }
+
+    ASSERT_NOT_REACHED();
+    return jsUndefined();
+}
+
+} // namespace
+
+struct OpaqueJSMessageQueue : public ThreadSafeRefCounted<OpaqueJSMessageQueue> {
+    MessageQueue<ClonedValue> messages;
+};
+
+JSMessageQueueRef JSMessageQueueCreate()
+{
+    return adoptRef(new OpaqueJSMessageQueue).leakRef();
+}
+
+JSMessageQueueRef JSMessageQueueRetain(JSMessageQueueRef queue)
+{
+    queue->ref();
+    return queue;
+}
+
+void JSMessageQueueRelease(JSMessageQueueRef queue)
+{
+    queue->deref();
+}
+
+bool JSMessageQueuePost(JSContextRef ctx, JSMessageQueueRef queue, JSValueRef value, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    OwnPtr<ClonedValue> message = ClonedValue::create(exec, toJS(exec, value));
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        return false;
+    }
+
+    queue->messages.append(message.release());
+    return true;
+}
+
+JSValueRef JSMessageQueueReceive(JSContextRef ctx, JSMessageQueueRef queue, bool waitForMessage)
+{
+    // Wait before entering the VM, so a blocked receiver does not hold its group.
+    OwnPtr<ClonedValue> message = waitForMessage ? queue->messages.waitForMessage() : queue->messages.tryGetMessage();
+    if (!message)
+        return 0;
+
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    return toRef(exec, message->deserialize(exec));
+}
+
+void JSMessageQueueClose(JSMessageQueueRef queue)
+{
+    queue->messages.kill();
+}
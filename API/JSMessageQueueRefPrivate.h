@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2012 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JSMessageQueueRefPrivate_h
+#define JSMessageQueueRefPrivate_h
+
+#include <JavaScriptCore/JSContextRef.h>
+#include <JavaScriptCore/JSValueRef.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @typedef JSMessageQueueRef A queue of values passed between context groups, possibly on different threads. */
+typedef struct OpaqueJSMessageQueue* JSMessageQueueRef;
+
+/*!
+@function
+@abstract Creates a message queue.
+@result The created JSMessageQueue. Ownership follows the Create Rule.
+@discussion A message queue is not tied to any context group. It may be retained, released, posted to
+ and received from on any thread.
+*/
+JS_EXPORT JSMessageQueueRef JSMessageQueueCreate(void);
+
+/*!
+@function
+@abstract Retains a message queue.
+@param queue The JSMessageQueue to retain.
+@result A JSMessageQueue that is the same as queue.
+*/
+JS_EXPORT JSMessageQueueRef JSMessageQueueRetain(JSMessageQueueRef queue);
+
+/*!
+@function
+@abstract Releases a message queue.
+@param queue The JSMessageQueue to release. Messages that were never received are discarded with it.
+*/
+JS_EXPORT void JSMessageQueueRelease(JSMessageQueueRef queue);
+
+/*!
+@function
+@abstract Clones a value and appends it to a message queue.
+@param ctx The execution context to use.
+@param queue The JSMessageQueue to post to.
+@param value The JSValue to post.
+@param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result true if the value was posted, otherwise false.
+@discussion The value is cloned without going through a string: undefined, null, booleans, numbers and
+ strings are copied; arrays and other objects are cloned from their elements and enumerable own
+ properties, keeping shared and cyclic references. Strings large enough to have a shared buffer are
+ passed without copying their characters. The bytes of ArrayBuffers, including those under typed arrays,
+ are shared rather than copied, so both sides see later writes to them. Functions cannot be posted.
+*/
+JS_EXPORT bool JSMessageQueuePost(JSContextRef ctx, JSMessageQueueRef queue, JSValueRef value, JSValueRef* exception);
+
+/*!
+@function
+@abstract Removes the oldest message from a message queue and rebuilds it in a context.
+@param ctx The execution context in which to rebuild the message.
+@param queue The JSMessageQueue to receive from.
+@param waitForMessage Whether to block until a message is posted, or the queue is closed, if the queue is empty.
+@result The received JSValue, or NULL if there was no message.
+@discussion The calling thread does not hold the context group while it waits.
+*/
+JS_EXPORT JSValueRef JSMessageQueueReceive(JSContextRef ctx, JSMessageQueueRef queue, bool waitForMessage);
+
+/*!
+@function
+@abstract Closes a message queue.
+@param queue The JSMessageQueue to close.
+@discussion Waiting receivers return NULL, and no message is received from the queue afterwards.
+*/
+JS_EXPORT void JSMessageQueueClose(JSMessageQueueRef queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSMessageQueueRefPrivate_h */
@@ -31,6 +31,7 @@
 #include "APICast.h"
 #include "CodeBlock.h"
 #include "DateConstructor.h"
+#include "Error.h"
 #include "ErrorConstructor.h"
 #include "FunctionConstructor.h"
 #include "Identifier.h"
@@ -45,6 +46,7 @@
 #include "JSObject.h"
 #include "JSRetainPtr.h"
 #include "JSString.h"
+#include "JSTypedArray.h"
 #include "JSValueRef.h"
 #include "ObjectPrototype.h"
 #include "PropertyNameArray.h"
@@ -81,9 +83,10 @@ JSObjectRef JSObjectMake(JSContextRef ctx, JSClassRef jsClass, void* data)
     if (!jsClass)
         return toRef(constructEmptyObject(exec));
 
-    JSCallbackObject<JSNonFinalObject>* object = JSCallbackObject<JSNonFinalObject>::create(exec, exec->lexicalGlobalObject(), exec->lexicalGlobalObject()->callbackObjectStructure(), jsClass, data);
-    if (JSObject* prototype = jsClass->prototype(exec))
-        object->setPrototype(exec->globalData(), prototype);
+    JSObject* prototype = jsClass->prototype(exec);
+    if (!prototype)
+        prototype = exec->lexicalGlobalObject()->objectPrototype();
+    JSCallbackObject<JSNonFinalObject>* object = JSCallbackObject<JSNonFinalObject>::create(exec, exec->lexicalGlobalObject(), jsClass->structure(exec, prototype), jsClass, data);
 
     return toRef(object);
 }
@@ -98,6 +101,16 @@ JSObjectRef JSObjectMakeFunctionWithCallback(JSContextRef ctx, JSStringRef name,
     return toRef(JSCallbackFunction::create(exec, exec->lexicalGlobalObject(), callAsFunction, nameID));
 }
 
+JSObjectRef JSObjectMakeFunctionWithCallbackAndAttributes(JSContextRef ctx, JSStringRef name, JSObjectCallAsFunctionCallback callAsFunction, JSFunctionAttributes attributes)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    Identifier nameID = name ? name->identifier(&exec->globalData()) : Identifier(exec, "anonymous");
+
+    return toRef(JSCallbackFunction::create(exec, exec->lexicalGlobalObject(), callAsFunction, nameID, attributes));
+}
+
 JSObjectRef JSObjectMakeConstructor(JSContextRef ctx, JSClassRef jsClass, JSObjectCallAsConstructorCallback callAsConstructor)
 {
     ExecState* exec = toJS(ctx);
@@ -287,6 +300,94 @@ void JSObjectSetProperty(JSContextRef ctx, JSObjectRef object, JSStringRef prope
     }
 }
 
+struct OpaqueJSPropertyHandle {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    OpaqueJSPropertyHandle(JSGlobalData* globalData, const Identifier& identifier)
+        : refCount(1)
+        , globalData(globalData)
+        , identifier(identifier)
+    {
+    }
+
+    unsigned refCount;
+    JSGlobalData* globalData;
+    Identifier identifier;
+};
+
+JSPropertyHandleRef JSPropertyHandleCreate(JSContextRef ctx, JSStringRef propertyName)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSGlobalData* globalData = &exec->globalData();
+    return new OpaqueJSPropertyHandle(globalData, propertyName->identifier(globalData));
+}
+
+JSPropertyHandleRef JSPropertyHandleRetain(JSPropertyHandleRef handle)
+{
+    ++handle->refCount;
+    return handle;
+}
+
+void JSPropertyHandleRelease(JSPropertyHandleRef handle)
+{
+    if (--handle->refCount == 0) {
+        APIEntryShim entryShim(handle->globalData, false);
+        delete handle;
+    }
+}
+
+void JSObjectGetProperties(JSContextRef ctx, JSObjectRef object, size_t count, const JSPropertyHandleRef properties[], JSValueRef values[], JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* jsObject = toJS(object);
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT(properties[i]->globalData == &exec->globalData());
+        JSValue jsValue = jsObject->get(exec, properties[i]->identifier);
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            for (; i < count; ++i)
+                values[i] = 0;
+            return;
+        }
+        values[i] = toRef(exec, jsValue);
+    }
+}
+
+void JSObjectSetProperties(JSContextRef ctx, JSObjectRef object, size_t count, const JSPropertyHandleRef properties[], const JSValueRef values[], JSPropertyAttributes attributes, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* jsObject = toJS(object);
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT(properties[i]->globalData == &exec->globalData());
+        const Identifier& name = properties[i]->identifier;
+        JSValue jsValue = toJS(exec, values[i]);
+
+        if (attributes && !jsObject->hasProperty(exec, name))
+            jsObject->putWithAttributes(exec, name, jsValue, attributes);
+        else {
+            PutPropertySlot slot;
+            jsObject->put(exec, name, jsValue, slot);
+        }
+
+        if (exec->hadException()) {
+            if (exception)
+                *exception = toRef(exec, exec->exception());
+            exec->clearException();
+            return;
+        }
+    }
+}
+
 JSValueRef JSObjectGetPropertyAtIndex(JSContextRef ctx, JSObjectRef object, unsigned propertyIndex, JSValueRef* exception)
 {
     ExecState* exec = toJS(ctx);
@@ -413,6 +514,152 @@ bool JSObjectDeletePrivateProperty(JSContextRef ctx, JSObjectRef object, JSStrin
     return false;
 }
 
+bool JSObjectFillTypedArrayWithRandomValues(JSContextRef ctx, JSObjectRef object)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    JSObject* jsObject = toJS(object);
+    if (!isJSTypedArray(&exec->globalData(), jsObject))
+        return false;
+
+    JSTypedArray* array = asTypedArray(jsObject);
+    JSGlobalObject* globalObject = exec->lexicalGlobalObject();
+    unsigned length = array->length();
+    if (array->type() == TypedArrayFloat64) {
+        double* data = reinterpret_cast<double*>(array->baseAddress());
+        for (unsigned i = 0; i < length; ++i)
+            data[i] = globalObject->weakRandomNumber();
+        return true;
+    }
+    if (array->type() == TypedArrayFloat32) {
+        // Keep 24 bits so the float stays exact and strictly below 1.
+        float* data = reinterpret_cast<float*>(array->baseAddress());
+        for (unsigned i = 0; i < length; ++i)
+            data[i] = (globalObject->weakRandomUint32() >> 8) * (1.0f / 16777216.0f);
+        return true;
+    }
+
+    char* data = array->baseAddress();
+    unsigned byteLength = array->byteLength();
+    for (unsigned offset = 0; offset < byteLength; offset += sizeof(unsigned)) {
+        unsigned bits = globalObject->weakRandomUint32();
+        memcpy(data + offset, &bits, std::min<unsigned>(sizeof(unsigned), byteLength - offset));
+    }
+    return true;
+}
+
+COMPILE_ASSERT(static_cast<int>(kJSTypedArrayTypeInt8Array) == static_cast<int>(TypedArrayInt8), JSTypedArrayType_matches_TypedArrayType);
+COMPILE_ASSERT(static_cast<int>(kJSTypedArrayTypeFloat64Array) == static_cast<int>(TypedArrayFloat64), JSTypedArrayType_matches_TypedArrayType);
+COMPILE_ASSERT(static_cast<int>(kJSTypedArrayTypeArrayBuffer) == static_cast<int>(numberOfTypedArrayTypes), JSTypedArrayType_has_no_gaps);
+
+static void deallocateNothing(void*, void*)
+{
+}
+
+static JSArrayBuffer* makeArrayBufferWithBytesNoCopy(ExecState* exec, void* bytes, size_t byteLength, JSTypedArrayBytesDeallocator deallocator, void* deallocatorContext)
+{
+    if (byteLength > std::numeric_limits<unsigned>::max()) {
+        throwError(exec, createRangeError(exec, "ArrayBuffer size is too large"));
+        return 0;
+    }
+    RefPtr<ArrayBufferStorage> storage = ArrayBufferStorage::createExternal(static_cast<char*>(bytes), static_cast<unsigned>(byteLength), deallocator ? deallocator : deallocateNothing, deallocatorContext);
+    return JSArrayBuffer::create(exec, exec->lexicalGlobalObject()->arrayBufferStructure(), storage.release());
+}
+
+JSObjectRef JSObjectMakeArrayBufferWithBytesNoCopy(JSContextRef ctx, void* bytes, size_t byteLength, JSTypedArrayBytesDeallocator deallocator, void* deallocatorContext, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* result = makeArrayBufferWithBytesNoCopy(exec, bytes, byteLength, deallocator, deallocatorContext);
+
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        result = 0;
+    }
+
+    return toRef(result);
+}
+
+JSObjectRef JSObjectMakeTypedArrayWithBytesNoCopy(JSContextRef ctx, JSTypedArrayType arrayType, void* bytes, size_t byteLength, JSTypedArrayBytesDeallocator deallocator, void* deallocatorContext, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* result = 0;
+    if (static_cast<unsigned>(arrayType) >= numberOfTypedArrayTypes)
+        throwError(exec, createTypeError(exec, "Not a typed array type"));
+    else {
+        TypedArrayType type = static_cast<TypedArrayType>(arrayType);
+        unsigned elementSize = elementSizeForTypedArray(type);
+        if (byteLength % elementSize)
+            throwError(exec, createRangeError(exec, "Byte length is not a multiple of the element size"));
+        else if (JSArrayBuffer* buffer = makeArrayBufferWithBytesNoCopy(exec, bytes, byteLength, deallocator, deallocatorContext))
+            result = JSTypedArray::create(exec, exec->lexicalGlobalObject()->typedArrayStructure(type), type, buffer, 0, static_cast<unsigned>(byteLength / elementSize));
+    }
+
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        result = 0;
+    }
+
+    return toRef(result);
+}
+
+JSTypedArrayType JSValueGetTypedArrayType(JSContextRef ctx, JSValueRef value)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSValue jsValue = toJS(exec, value);
+    if (isJSTypedArray(&exec->globalData(), jsValue))
+        return static_cast<JSTypedArrayType>(asTypedArray(jsValue)->type());
+    if (jsValue.inherits(&JSArrayBuffer::s_info))
+        return kJSTypedArrayTypeArrayBuffer;
+    return kJSTypedArrayTypeNone;
+}
+
+void* JSObjectGetTypedArrayBytesPtr(JSContextRef ctx, JSObjectRef object)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* jsObject = toJS(object);
+    if (isJSTypedArray(&exec->globalData(), jsObject))
+        return asTypedArray(jsObject)->baseAddress();
+    if (jsObject->inherits(&JSArrayBuffer::s_info))
+        return asArrayBuffer(jsObject)->storage()->data();
+    return 0;
+}
+
+size_t JSObjectGetTypedArrayByteLength(JSContextRef ctx, JSObjectRef object)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* jsObject = toJS(object);
+    if (isJSTypedArray(&exec->globalData(), jsObject))
+        return asTypedArray(jsObject)->byteLength();
+    if (jsObject->inherits(&JSArrayBuffer::s_info))
+        return asArrayBuffer(jsObject)->storage()->byteLength();
+    return 0;
+}
+
+size_t JSObjectGetTypedArrayLength(JSContextRef ctx, JSObjectRef object)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSObject* jsObject = toJS(object);
+    if (isJSTypedArray(&exec->globalData(), jsObject))
+        return asTypedArray(jsObject)->length();
+    return 0;
+}
+
 bool JSObjectIsFunction(JSContextRef, JSObjectRef object)
 {
     CallData callData;
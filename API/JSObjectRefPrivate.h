@@ -32,6 +32,52 @@
 extern "C" {
 #endif
 
+/*! @typedef JSPropertyHandleRef A property name interned once for use with one context group's batch property functions. */
+typedef struct OpaqueJSPropertyHandle* JSPropertyHandleRef;
+
+/*!
+@enum JSFunctionAttribute
+@constant kJSFunctionAttributeNone Specifies that a function has no special attributes.
+@constant kJSFunctionAttributeDoesNotReenter Specifies that a function's callback never calls back into JavaScript and returns quickly. It may still report an error through its exception argument. Such callbacks run without the locks being dropped and, where possible, receive their arguments without copying.
+*/
+enum {
+    kJSFunctionAttributeNone = 0,
+    kJSFunctionAttributeDoesNotReenter = 1 << 0
+};
+
+/*!
+@typedef JSFunctionAttributes
+@abstract A set of JSFunctionAttributes. Combine multiple attributes by logically ORing them together.
+*/
+typedef unsigned JSFunctionAttributes;
+
+/*!
+@enum JSTypedArrayType
+@abstract The kinds of typed array and buffer objects.
+@constant kJSTypedArrayTypeNone Not a typed array or ArrayBuffer.
+@constant kJSTypedArrayTypeArrayBuffer An ArrayBuffer.
+*/
+typedef enum {
+    kJSTypedArrayTypeInt8Array,
+    kJSTypedArrayTypeUint8Array,
+    kJSTypedArrayTypeInt16Array,
+    kJSTypedArrayTypeUint16Array,
+    kJSTypedArrayTypeInt32Array,
+    kJSTypedArrayTypeUint32Array,
+    kJSTypedArrayTypeFloat32Array,
+    kJSTypedArrayTypeFloat64Array,
+    kJSTypedArrayTypeArrayBuffer,
+    kJSTypedArrayTypeNone
+} JSTypedArrayType;
+
+/*!
+@typedef JSTypedArrayBytesDeallocator
+@abstract The callback invoked when JavaScriptCore no longer needs bytes passed to JSObjectMakeArrayBufferWithBytesNoCopy or JSObjectMakeTypedArrayWithBytesNoCopy.
+@param bytes The bytes originally passed in.
+@param deallocatorContext The context originally passed in.
+*/
+typedef void (*JSTypedArrayBytesDeallocator)(void* bytes, void* deallocatorContext);
+
 /*!
  @function
  @abstract Sets a private property on an object.  This private property cannot be accessed from within JavaScript.
@@ -67,6 +113,145 @@ JS_EXPORT JSValueRef JSObjectGetPrivateProperty(JSContextRef ctx, JSObjectRef ob
  */
 JS_EXPORT bool JSObjectDeletePrivateProperty(JSContextRef ctx, JSObjectRef object, JSStringRef propertyName);
 
+/*!
+ @function
+ @abstract Creates a JavaScript function whose callback may be called with less overhead.
+ @param ctx The execution context to use.
+ @param name A JSString containing the function's name. This will be used when converting the function to string. Pass NULL to create an anonymous function.
+ @param callAsFunction The JSObjectCallAsFunctionCallback to invoke when the function is called.
+ @param attributes A logically ORed set of JSFunctionAttributes to give to the function.
+ @result A JSObject that is a function, like one made by JSObjectMakeFunctionWithCallback.
+ @discussion With kJSFunctionAttributeDoesNotReenter, calls from JavaScript skip the lock and identifier table handoff that let other threads run during a callback, and the arguments array may point directly into the JavaScript stack, so it is valid only until the callback returns. The callback may still create values, for example with JSValueMakeNumber, and may set its exception argument to throw one, for example for arguments of the wrong type, but must not evaluate scripts, call JavaScript functions, get or set properties that may run JavaScript, or wait on another thread that uses the same context group.
+ */
+JS_EXPORT JSObjectRef JSObjectMakeFunctionWithCallbackAndAttributes(JSContextRef ctx, JSStringRef name, JSObjectCallAsFunctionCallback callAsFunction, JSFunctionAttributes attributes);
+
+/*!
+ @function
+ @abstract Fills a typed array with pseudo-random values from a context's Math.random generator.
+ @param ctx The execution context whose generator to use.
+ @param object The typed array to fill.
+ @result true if object is a typed array, otherwise false.
+ @discussion Float64Array elements continue the Math.random sequence; Float32Array elements are uniform in [0, 1) at single precision. Integer arrays receive uniformly distributed bits. Like Math.random, the values are not suitable for cryptographic use.
+ */
+JS_EXPORT bool JSObjectFillTypedArrayWithRandomValues(JSContextRef ctx, JSObjectRef object);
+
+/*!
+ @function
+ @abstract Creates an ArrayBuffer over bytes the caller owns, without copying them.
+ @param ctx The execution context to use.
+ @param bytes The bytes the ArrayBuffer will refer to.
+ @param byteLength The number of bytes; at most 4GB - 1.
+ @param deallocator The callback to invoke once neither the ArrayBuffer nor any view onto it is alive. Pass NULL if the bytes outlive the JavaScript virtual machine.
+ @param deallocatorContext The value passed to deallocator.
+ @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+ @result The ArrayBuffer, or NULL if byteLength is too large, in which case deallocator is not called.
+ @discussion JavaScript and the caller see the same memory, so writes on either side are visible to the other. Since the bytes are released when the collector finalizes their last owner, and ArrayBuffers posted through a JSMessageQueue are shared with the receiving heap, deallocator may be called on any thread and must not call into JavaScriptCore.
+ */
+JS_EXPORT JSObjectRef JSObjectMakeArrayBufferWithBytesNoCopy(JSContextRef ctx, void* bytes, size_t byteLength, JSTypedArrayBytesDeallocator deallocator, void* deallocatorContext, JSValueRef* exception);
+
+/*!
+ @function
+ @abstract Creates a typed array, and the ArrayBuffer under it, over bytes the caller owns, without copying them.
+ @param ctx The execution context to use.
+ @param arrayType The element type of the array. Must not be kJSTypedArrayTypeArrayBuffer or kJSTypedArrayTypeNone.
+ @param bytes The bytes the array will refer to, aligned for its element type.
+ @param byteLength The number of bytes; a multiple of the element size, and at most 4GB - 1.
+ @param deallocator The callback to invoke once neither the array nor its buffer is alive. Pass NULL if the bytes outlive the JavaScript virtual machine.
+ @param deallocatorContext The value passed to deallocator.
+ @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+ @result The typed array, or NULL if arrayType or byteLength is invalid, in which case deallocator is not called.
+ @discussion See JSObjectMakeArrayBufferWithBytesNoCopy for when deallocator runs.
+ */
+JS_EXPORT JSObjectRef JSObjectMakeTypedArrayWithBytesNoCopy(JSContextRef ctx, JSTypedArrayType arrayType, void* bytes, size_t byteLength, JSTypedArrayBytesDeallocator deallocator, void* deallocatorContext, JSValueRef* exception);
+
+/*!
+ @function
+ @abstract Tests whether a JavaScript value is a typed array or an ArrayBuffer, and of what type.
+ @param ctx The execution context to use.
+ @param value The JSValue to test.
+ @result The type of value, or kJSTypedArrayTypeNone if it is neither a typed array nor an ArrayBuffer.
+ */
+JS_EXPORT JSTypedArrayType JSValueGetTypedArrayType(JSContextRef ctx, JSValueRef value);
+
+/*!
+ @function
+ @abstract Gets a pointer to the elements of a typed array or the bytes of an ArrayBuffer.
+ @param ctx The execution context to use.
+ @param object The typed array or ArrayBuffer.
+ @result A pointer to the first element of object, or NULL if object is neither a typed array nor an ArrayBuffer.
+ @discussion The pointer stays valid, and its memory does not move, for as long as object is alive; keep object alive (for example with JSValueProtect) while using it. For a typed array, the pointer already includes the view's byte offset.
+ */
+JS_EXPORT void* JSObjectGetTypedArrayBytesPtr(JSContextRef ctx, JSObjectRef object);
+
+/*!
+ @function
+ @abstract Gets the length in bytes of a typed array or ArrayBuffer.
+ @param ctx The execution context to use.
+ @param object The typed array or ArrayBuffer.
+ @result The number of bytes JSObjectGetTypedArrayBytesPtr refers to, or 0 if object is neither a typed array nor an ArrayBuffer.
+ */
+JS_EXPORT size_t JSObjectGetTypedArrayByteLength(JSContextRef ctx, JSObjectRef object);
+
+/*!
+ @function
+ @abstract Gets the number of elements in a typed array.
+ @param ctx The execution context to use.
+ @param object The typed array.
+ @result The length of object, or 0 if object is not a typed array.
+ */
+JS_EXPORT size_t JSObjectGetTypedArrayLength(JSContextRef ctx, JSObjectRef object);
+
+/*!
+ @function
+ @abstract Interns a property name for use with JSObjectGetProperties and JSObjectSetProperties.
+ @param ctx The execution context whose context group the handle will be used with.
+ @param propertyName A JSString containing the property's name.
+ @result A JSPropertyHandle with a retain count of 1. Ownership follows the Create Rule.
+ */
+JS_EXPORT JSPropertyHandleRef JSPropertyHandleCreate(JSContextRef ctx, JSStringRef propertyName);
+
+/*!
+ @function
+ @abstract Retains a JavaScript property handle.
+ @param handle The JSPropertyHandle to retain.
+ @result A JSPropertyHandle that is the same as handle.
+ */
+JS_EXPORT JSPropertyHandleRef JSPropertyHandleRetain(JSPropertyHandleRef handle);
+
+/*!
+ @function
+ @abstract Releases a JavaScript property handle.
+ @param handle The JSPropertyHandle to release.
+ */
+JS_EXPORT void JSPropertyHandleRelease(JSPropertyHandleRef handle);
+
+/*!
+ @function
+ @abstract Gets several properties from an object in one call.
+ @param ctx The execution context to use.
+ @param object The JSObject whose properties you want to get.
+ @param count The number of properties to get.
+ @param properties An array of count JSPropertyHandles naming the properties, created for ctx's context group.
+ @param values An array of count JSValues that receives the properties' values, or undefined for properties the object does not have.
+ @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+ @discussion This is equivalent to calling JSObjectGetProperty for each property in order, but enters the engine only once. If a getter throws, the remaining entries of values are set to NULL.
+ */
+JS_EXPORT void JSObjectGetProperties(JSContextRef ctx, JSObjectRef object, size_t count, const JSPropertyHandleRef properties[], JSValueRef values[], JSValueRef* exception);
+
+/*!
+ @function
+ @abstract Sets several properties on an object in one call.
+ @param ctx The execution context to use.
+ @param object The JSObject whose properties you want to set.
+ @param count The number of properties to set.
+ @param properties An array of count JSPropertyHandles naming the properties, created for ctx's context group.
+ @param values An array of count JSValues to use as the properties' values.
+ @param attributes A logically ORed set of JSPropertyAttributes to give to properties that do not exist yet.
+ @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+ @discussion This is equivalent to calling JSObjectSetProperty for each property in order, but enters the engine only once. If a setter throws, the remaining properties are not set.
+ */
+JS_EXPORT void JSObjectSetProperties(JSContextRef ctx, JSObjectRef object, size_t count, const JSPropertyHandleRef properties[], const JSValueRef values[], JSPropertyAttributes attributes, JSValueRef* exception);
+
 #ifdef __cplusplus
 }
 #endif
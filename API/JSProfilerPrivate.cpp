@@ -27,8 +27,13 @@
 #include "JSProfilerPrivate.h"
 
 #include "APICast.h"
+#include "AllocationProfiler.h"
+#include "APIShims.h"
+#include "CodeBlock.h"
+#include "Executable.h"
 #include "OpaqueJSString.h"
 #include "Profiler.h"
+#include "SamplingProfiler.h"
 
 using namespace JSC;
 
@@ -44,3 +49,174 @@ void JSEndProfiling(JSContextRef ctx, JSStringRef title)
     profiler->stopProfiling(exec, title->ustring());
 }
 
+void JSStartSamplingProfiler(JSContextRef ctx, JSStringRef title, unsigned samplingInterval)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSGlobalData& globalData = exec->globalData();
+    delete globalData.samplingProfiler;
+    globalData.samplingProfiler = new SamplingProfiler(title->ustring(), samplingInterval);
+}
+
+static void reportSampledNode(ProfileNode* node, unsigned depth, JSSampledFunctionCallback callback, void* userData)
+{
+    RefPtr<OpaqueJSString> functionName = OpaqueJSString::create(node->functionName());
+    RefPtr<OpaqueJSString> sourceURL = OpaqueJSString::create(node->url());
+    callback(functionName.get(), sourceURL.get(), node->lineNumber(), depth, node->actualTotalTime(), node->actualSelfTime(), userData);
+
+    const Vector<RefPtr<ProfileNode> >& children = node->children();
+    for (size_t i = 0; i < children.size(); ++i)
+        reportSampledNode(children[i].get(), depth + 1, callback, userData);
+}
+
+unsigned JSStopSamplingProfiler(JSContextRef ctx, JSSampledFunctionCallback callback, void* userData)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSGlobalData& globalData = exec->globalData();
+    OwnPtr<SamplingProfiler> samplingProfiler = adoptPtr(globalData.samplingProfiler);
+    globalData.samplingProfiler = 0;
+    if (!samplingProfiler)
+        return 0;
+
+    if (callback) {
+        const Vector<RefPtr<ProfileNode> >& children = samplingProfiler->profile()->head()->children();
+        for (size_t i = 0; i < children.size(); ++i)
+            reportSampledNode(children[i].get(), 1, callback, userData);
+    }
+
+    return samplingProfiler->sampleCount();
+}
+
+unsigned JSReportSamplingProfilerOpcodes(JSContextRef ctx, JSSampledOpcodeCallback callback, void* userData)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    SamplingProfiler* samplingProfiler = exec->globalData().samplingProfiler;
+    if (!samplingProfiler)
+        return 0;
+
+    for (int i = 0; i < numOpcodeIDs; ++i) {
+        OpcodeID opcodeID = static_cast<OpcodeID>(i);
+        unsigned interpreterSamples = samplingProfiler->opcodeSampleCount(opcodeID, SamplingProfiler::InterpreterTier);
+        unsigned baselineJITSamples = samplingProfiler->opcodeSampleCount(opcodeID, SamplingProfiler::BaselineJITTier);
+        unsigned optimizedJITSamples = samplingProfiler->opcodeSampleCount(opcodeID, SamplingProfiler::DFGJITTier);
+        if (interpreterSamples || baselineJITSamples || optimizedJITSamples)
+            callback(opcodeNames[i], interpreterSamples, baselineJITSamples, optimizedJITSamples, userData);
+    }
+
+    return samplingProfiler->samplesWithDFGCodeOnStack();
+}
+
+#if ENABLE(JIT)
+static const char* inlineCacheKindName(InlineCacheSiteStatistics::Kind kind)
+{
+    switch (kind) {
+    case InlineCacheSiteStatistics::PropertyAccess:
+        return "property";
+    case InlineCacheSiteStatistics::MethodCheck:
+        return "method";
+    case InlineCacheSiteStatistics::Call:
+        return "call";
+    case InlineCacheSiteStatistics::GlobalResolve:
+        return "global";
+    case InlineCacheSiteStatistics::StringKeyedAccess:
+        return "keyed";
+    }
+    ASSERT_NOT_REACHED();
+    return "";
+}
+
+struct InlineCacheSiteReport {
+    RefPtr<OpaqueJSString> functionName;
+    RefPtr<OpaqueJSString> sourceURL;
+    unsigned lineNumber;
+    InlineCacheSiteStatistics statistics;
+};
+#endif
+
+unsigned JSReportInlineCacheStatistics(JSContextRef ctx, JSInlineCacheSiteCallback callback, void* userData)
+{
+#if ENABLE(JIT)
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    Vector<JSGlobalData::InlineCacheSite> sites;
+    exec->globalData().collectInlineCacheStatistics(sites);
+
+    // The strings are made before any callback runs, since a callback that runs script
+    // could collect the executables the sites point at.
+    Vector<InlineCacheSiteReport> reports;
+    unsigned genericSiteCount = 0;
+    for (size_t i = 0; i < sites.size(); ++i) {
+        FunctionExecutable* executable = sites[i].first;
+        const InlineCacheSiteStatistics& statistics = sites[i].second;
+        if (statistics.isGeneric)
+            ++genericSiteCount;
+        if (!callback || (!statistics.repatchCount && !statistics.isGeneric))
+            continue;
+        InlineCacheSiteReport report;
+        report.functionName = OpaqueJSString::create(executable->name().ustring());
+        report.sourceURL = OpaqueJSString::create(executable->sourceURL());
+        report.lineNumber = statistics.lineNumber >= 0 ? statistics.lineNumber : executable->lineNo();
+        report.statistics = statistics;
+        reports.append(report);
+    }
+
+    for (size_t i = 0; i < reports.size(); ++i) {
+        const InlineCacheSiteReport& report = reports[i];
+        callback(report.functionName.get(), report.sourceURL.get(), report.lineNumber, inlineCacheKindName(report.statistics.kind),
+            report.statistics.repatchCount, report.statistics.structureCount, report.statistics.isGeneric, userData);
+    }
+
+    return genericSiteCount;
+#else
+    UNUSED_PARAM(ctx);
+    UNUSED_PARAM(callback);
+    UNUSED_PARAM(userData);
+    return 0;
+#endif
+}
+
+void JSStartAllocationProfiler(JSContextRef ctx, unsigned sampleInterval)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    exec->globalData().heap.startAllocationProfiling(sampleInterval);
+}
+
+size_t JSStopAllocationProfiler(JSContextRef ctx, JSAllocationSiteCallback callback, void* userData)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    OwnPtr<AllocationProfiler> allocationProfiler = exec->globalData().heap.stopAllocationProfiling();
+    if (!allocationProfiler)
+        return 0;
+
+    if (callback) {
+        const Vector<AllocationProfiler::Site>& sites = allocationProfiler->sites();
+        for (size_t i = 0; i < sites.size(); ++i) {
+            const AllocationProfiler::Site& site = sites[i];
+            Vector<RefPtr<OpaqueJSString>, AllocationProfiler::maxStackDepth> strings;
+            JSStringRef functionNames[AllocationProfiler::maxStackDepth];
+            JSStringRef sourceURLs[AllocationProfiler::maxStackDepth];
+            unsigned lineNumbers[AllocationProfiler::maxStackDepth];
+            for (size_t j = 0; j < site.stack.size(); ++j) {
+                strings.append(OpaqueJSString::create(site.stack[j].m_name));
+                functionNames[j] = strings.last().get();
+                strings.append(OpaqueJSString::create(site.stack[j].m_url));
+                sourceURLs[j] = strings.last().get();
+                lineNumbers[j] = site.stack[j].m_lineNumber;
+            }
+            callback(functionNames, sourceURLs, lineNumbers, site.stack.size(), site.kind == AllocationProfiler::PropertyStorageAllocation,
+                site.sampleCount, site.sampledBytes, site.checkedCount, site.survivorCount, userData);
+        }
+    }
+
+    return allocationProfiler->sampleCount();
+}
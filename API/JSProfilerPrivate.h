@@ -56,6 +56,132 @@ JS_EXPORT void JSStartProfiling(JSContextRef ctx, JSStringRef title);
 */
 JS_EXPORT void JSEndProfiling(JSContextRef ctx, JSStringRef title);
 
+/*!
+@function JSStartSamplingProfiler
+@abstract Starts a sampling profile for the context's group.
+@param ctx The execution context to use.
+@param title The title of the profile.
+@param samplingInterval The CPU time, in milliseconds, to aim for between samples.
+@discussion Unlike JSStartProfiling, this does not instrument calls. The stack is
+ recorded at the engine's periodic execution checks, which happen on loop back edges,
+ so code that never loops between entries from the embedder may not be sampled.
+ Starting a sampling profile while one is running discards the running one.
+*/
+JS_EXPORT void JSStartSamplingProfiler(JSContextRef ctx, JSStringRef title, unsigned samplingInterval);
+
+/*!
+@typedef JSSampledFunctionCallback
+@abstract The callback invoked for every node of a sampling profile, in pre-order.
+@param functionName The name of the function.
+@param sourceURL The URL of the script that defines the function.
+@param lineNumber The line on which the function starts.
+@param depth The depth of the node, 1 for functions called from the embedder.
+@param totalTime The milliseconds attributed to this function and its callees.
+@param selfTime The milliseconds attributed to this function alone.
+@param userData The userData passed to JSStopSamplingProfiler.
+*/
+typedef void (*JSSampledFunctionCallback)(JSStringRef functionName, JSStringRef sourceURL, unsigned lineNumber, unsigned depth, double totalTime, double selfTime, void* userData);
+
+/*!
+@function JSStopSamplingProfiler
+@abstract Stops the context group's sampling profile and reports its call tree.
+@param ctx The execution context to use.
+@param callback The callback to invoke for every node of the profile, or NULL.
+@param userData A pointer passed through to callback.
+@result The number of samples taken, or 0 if no sampling profile was running.
+*/
+JS_EXPORT unsigned JSStopSamplingProfiler(JSContextRef ctx, JSSampledFunctionCallback callback, void* userData);
+
+/*!
+@typedef JSSampledOpcodeCallback
+@abstract The callback invoked for every bytecode opcode a sampling profile has seen.
+@param opcodeName The name of the opcode, such as "op_get_by_id".
+@param interpreterSamples The samples taken while the interpreter ran the opcode.
+@param baselineJITSamples The samples taken while baseline JIT code for the opcode ran.
+@param optimizedJITSamples The samples taken while optimized JIT code for the opcode ran.
+@param userData The userData passed to JSReportSamplingProfilerOpcodes.
+*/
+typedef void (*JSSampledOpcodeCallback)(const char* opcodeName, unsigned interpreterSamples, unsigned baselineJITSamples, unsigned optimizedJITSamples, void* userData);
+
+/*!
+@function JSReportSamplingProfilerOpcodes
+@abstract Reports the opcodes the context group's running sampling profile has seen.
+@param ctx The execution context to use.
+@param callback The callback to invoke for every opcode with at least one sample.
+@param userData A pointer passed through to callback.
+@result The number of samples taken while optimized code was on the stack, or 0 if no sampling profile is running.
+@discussion Call this before JSStopSamplingProfiler. Only samples taken at the engine's own
+ checks have an opcode. Optimized code makes no such checks, so its time is mostly seen
+ through the result and through the opcodes of the code it calls.
+*/
+JS_EXPORT unsigned JSReportSamplingProfilerOpcodes(JSContextRef ctx, JSSampledOpcodeCallback callback, void* userData);
+
+/*!
+@function JSStartAllocationProfiler
+@abstract Starts attributing the context group's heap allocations to the code that makes them.
+@param ctx The execution context to use.
+@param sampleInterval The number of allocations between samples. 0 samples every allocation.
+@discussion Objects, arrays, strings, functions and property storage allocated in the heap are
+ sampled. Objects the JIT allocates inline are not. Starting an allocation profile while one is
+ running discards the running one.
+*/
+JS_EXPORT void JSStartAllocationProfiler(JSContextRef ctx, unsigned sampleInterval);
+
+/*!
+@typedef JSAllocationSiteCallback
+@abstract The callback invoked for every allocation site an allocation profile has seen.
+@param functionNames The names of the functions on the stack, innermost first.
+@param sourceURLs The URLs of the scripts that define those functions.
+@param lineNumbers For the innermost function, the line on which it starts; for the others, the
+ line of their call to the function inside them, or the line on which they start if it is not known.
+@param depth The number of functions on the stack, up to 4. 0 for allocations made outside JavaScript.
+@param isPropertyStorage Whether the samples are of property storage rather than of cells.
+@param sampleCount The allocations sampled at this site.
+@param sampledBytes The bytes of those allocations.
+@param checkedCount The sampled cells that have been through a collection since they were allocated.
+@param survivorCount The checked cells that survived it. Always 0 for property storage.
+@param userData The userData passed to JSStopAllocationProfiler.
+*/
+typedef void (*JSAllocationSiteCallback)(const JSStringRef* functionNames, const JSStringRef* sourceURLs, const unsigned* lineNumbers, unsigned depth, bool isPropertyStorage, size_t sampleCount, size_t sampledBytes, size_t checkedCount, size_t survivorCount, void* userData);
+
+/*!
+@function JSStopAllocationProfiler
+@abstract Stops the context group's allocation profile and reports its sites.
+@param ctx The execution context to use.
+@param callback The callback to invoke for every allocation site, or NULL.
+@param userData A pointer passed through to callback.
+@result The number of allocations sampled, or 0 if no allocation profile was running.
+@discussion Multiply counts and bytes by the sample interval to estimate the totals.
+*/
+JS_EXPORT size_t JSStopAllocationProfiler(JSContextRef ctx, JSAllocationSiteCallback callback, void* userData);
+
+/*!
+@typedef JSInlineCacheSiteCallback
+@abstract The callback invoked for every inline cache that has been repatched or has gone generic.
+@param functionName The name of the function containing the site.
+@param sourceURL The URL of the script that defines the function.
+@param lineNumber The line of the site, or the line on which the function starts if it is not known.
+@param kind The kind of site: "property", "method", "call", "global" or "keyed".
+@param repatchCount The number of times the site has been patched to cache something new.
+@param structureCount The number of structures, or callees, the site currently checks for.
+@param isGeneric Whether the site has given up on caching and always takes the slow path.
+@param userData The userData passed to JSReportInlineCacheStatistics.
+*/
+typedef void (*JSInlineCacheSiteCallback)(JSStringRef functionName, JSStringRef sourceURL, unsigned lineNumber, const char* kind, unsigned repatchCount, unsigned structureCount, bool isGeneric, void* userData);
+
+/*!
+@function JSReportInlineCacheStatistics
+@abstract Reports the inline caches of the context group's compiled functions.
+@param ctx The execution context to use.
+@param callback The callback to invoke for every site that has been repatched or has gone generic, or NULL.
+@param userData A pointer passed through to callback.
+@result The number of sites that have gone generic.
+@discussion Sites that cache more than one structure are polymorphic; sites that have gone generic
+ are megamorphic and usually the first thing worth fixing. Only function code is covered, and
+ nothing is reported when the JIT is disabled.
+*/
+JS_EXPORT unsigned JSReportInlineCacheStatistics(JSContextRef ctx, JSInlineCacheSiteCallback callback, void* userData);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSScriptRefPrivate.h"
+
+#include "APICast.h"
+#include "APIShims.h"
+#include "Completion.h"
+#include "Executable.h"
+#include "JSGlobalObject.h"
+#include "OpaqueJSString.h"
+#include "ScriptSourceCache.h"
+#include "SourceCode.h"
+#include "Strong.h"
+#include <JSSettingsEA.h>
+
+using namespace JSC;
+
+struct OpaqueJSScript {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    OpaqueJSScript(JSGlobalData* globalData, const SourceCode& source)
+        : refCount(1)
+        , globalData(globalData)
+        , source(source)
+    {
+    }
+
+    unsigned refCount;
+    JSGlobalData* globalData;
+    SourceCode source;
+    // The program compiled for globalObject by the last evaluation.
+    Strong<JSGlobalObject> globalObject;
+    Strong<ProgramExecutable> program;
+};
+
+JSScriptRef JSScriptCreate(JSContextRef ctx, JSStringRef script, JSStringRef sourceURL, int startingLineNumber, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSGlobalData* globalData = &exec->globalData();
+    SourceCode source = globalData->scriptSourceCache->sourceFor(script->ustring(), sourceURL->ustring(), startingLineNumber, JSGetCompressedSourceThreshold());
+
+    JSValue syntaxException;
+    if (!checkSyntax(exec->dynamicGlobalObject()->globalExec(), source, &syntaxException)) {
+        if (exception)
+            *exception = toRef(exec, syntaxException);
+        return 0;
+    }
+
+    return new OpaqueJSScript(globalData, source);
+}
+
+JSScriptRef JSScriptRetain(JSScriptRef script)
+{
+    ++script->refCount;
+    return script;
+}
+
+void JSScriptRelease(JSScriptRef script)
+{
+    if (--script->refCount == 0) {
+        APIEntryShim entryShim(script->globalData, false);
+        delete script;
+    }
+}
+
+JSValueRef JSScriptEvaluate(JSContextRef ctx, JSScriptRef script, JSObjectRef thisObject, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    ASSERT(script->globalData == &exec->globalData());
+
+    JSGlobalData& globalData = exec->globalData();
+    JSGlobalObject* globalObject = exec->dynamicGlobalObject();
+
+    // Compiling a program declares its globals and creates its top-level functions, so a
+    // program found to declare functions when it was compiled is not run a second time.
+    ProgramExecutable* program = script->program.get();
+    if (!program || script->globalObject.get() != globalObject || program->declaresFunctions()) {
+        program = ProgramExecutable::create(globalObject->globalExec(), script->source);
+        script->globalObject.set(globalData, globalObject);
+        script->program.set(globalData, program);
+    }
+
+    JSValue evaluationException;
+    JSValue returnValue = evaluate(globalObject->globalExec(), globalObject->globalScopeChain(), program, toJS(thisObject), &evaluationException);
+
+    if (evaluationException) {
+        if (exception)
+            *exception = toRef(exec, evaluationException);
+        return 0;
+    }
+
+    if (returnValue)
+        return toRef(exec, returnValue);
+
+    return toRef(exec, jsUndefined());
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2010 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JSScriptRefPrivate_h
+#define JSScriptRefPrivate_h
+
+#include <JavaScriptCore/JSContextRef.h>
+#include <JavaScriptCore/JSStringRef.h>
+#include <JavaScriptCore/JSValueRef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @typedef JSScriptRef A script whose compiled code is kept between evaluations. */
+typedef struct OpaqueJSScript* JSScriptRef;
+
+/*!
+@function
+@abstract Creates a script that can be evaluated many times without being parsed and compiled again.
+@param ctx The execution context to use.
+@param script A JSString containing the script's source code.
+@param sourceURL A JSString containing a URL for the script's source file. This is only used when reporting exceptions. Pass NULL if you do not care to include source file information in exceptions.
+@param startingLineNumber An integer value specifying the script's starting line number in the file located at sourceURL. This is only used when reporting exceptions.
+@param exception A pointer to a JSValueRef in which to store a syntax error exception, if any. Pass NULL if you do not care to store a syntax error exception.
+@result The created JSScript, or NULL if the script has a syntax error. Ownership follows the Create Rule.
+@discussion The script is only syntax checked here. It is compiled on its first evaluation, for the global object it is first evaluated in.
+*/
+JS_EXPORT JSScriptRef JSScriptCreate(JSContextRef ctx, JSStringRef script, JSStringRef sourceURL, int startingLineNumber, JSValueRef* exception);
+
+/*!
+@function
+@abstract Retains a JavaScript script.
+@param script The JSScript to retain.
+@result A JSScript that is the same as script.
+*/
+JS_EXPORT JSScriptRef JSScriptRetain(JSScriptRef script);
+
+/*!
+@function
+@abstract Releases a JavaScript script.
+@param script The JSScript to release.
+*/
+JS_EXPORT void JSScriptRelease(JSScriptRef script);
+
+/*!
+@function
+@abstract Evaluates a script created by JSScriptCreate.
+@param ctx The execution context to use. It must be in the context group the script was created in.
+@param script The JSScript to evaluate.
+@param thisObject The object to use as "this," or NULL to use the global object as "this."
+@param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+@result The JSValue that results from evaluating script, or NULL if an exception is thrown.
+@discussion This behaves like JSEvaluateScript with the same arguments. The compiled code is reused while the script keeps being evaluated in the same global context. A script that declares functions at its top level is compiled again for every evaluation, since the function objects are created as part of compiling it.
+*/
+JS_EXPORT JSValueRef JSScriptEvaluate(JSContextRef ctx, JSScriptRef script, JSObjectRef thisObject, JSValueRef* exception);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSScriptRefPrivate_h */
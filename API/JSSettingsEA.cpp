@@ -28,25 +28,72 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "config.h"
 #include "JSSettingsEA.h"
+
+#include "APICast.h"
+#include "APIShims.h"
+#include "CodeBlock.h"
+#include "CompressedSourceProvider.h"
+#include "HeapSnapshot.h"
+#include "JITCodeLog.h"
+#include "JITDiagnostics.h"
+#include "MemoryStatistics.h"
+#include "PauseTelemetry.h"
 #include "Profiler.h"
+#include "RegExp.h"
+#include "Tracing.h"
+#include <wtf/Vector.h>
 
 struct JSSettingsEAPrivate
 {
     size_t    mJavaScriptStackSize;	    // In bytes.  This is the approximate stack size in bytes and not the capacity of the stack array.
     size_t	  mJavaScriptHeapWatermark;	
+    size_t    mJavaScriptHeapHardLimit;
+    unsigned  mNumberOfGCMarkers;
+    unsigned  mCodeAgingCollections;
+    size_t    mSharedSourceCacheSize;
+    unsigned  mScriptSourceCacheSize;
+    unsigned  mCompressedSourceThreshold;
+    unsigned  mNumericStringCacheSize;
+    unsigned  mRegExpMatchLimit;
+    unsigned  mRegExpTimeLimit;         // In milliseconds.
+    size_t    mRegExpJITCodeBudget;
 	bool      mPrintExceptions;
     const char8_t*  mdefaultLocale;
 
 	JSCallstackCallback mCallstackCallback;
+    JSCompactCallstackCallback mCompactCallstackCallback;
     JSLogCallback mLogCallback;
+    JSMemoryPressureCallback mMemoryPressureCallback;
+    JSTraceCallback mTraceCallback;
+    JSPauseCallback mPauseCallback;
+    JSJITCodeCallback mJITCodeCallback;
+    JSOptimizeCallback mOptimizeCallback;
+    JSOptimizationDiagnosticsCallback mOptimizationDiagnosticsCallback;
 
     JSSettingsEAPrivate(void)
     : mJavaScriptStackSize(128 * 1024)
 	, mJavaScriptHeapWatermark(1 * 1024 * 1024)
+    , mJavaScriptHeapHardLimit(0)
+    , mNumberOfGCMarkers(1)
+    , mCodeAgingCollections(0)
+    , mSharedSourceCacheSize(0)
+    , mScriptSourceCacheSize(0)
+    , mCompressedSourceThreshold(0)
+    , mNumericStringCacheSize(64)
+    , mRegExpMatchLimit(1000000)
+    , mRegExpTimeLimit(0)
+    , mRegExpJITCodeBudget(0)
     , mPrintExceptions(false)
 	, mdefaultLocale(NULL)
     , mCallstackCallback(NULL)
+    , mCompactCallstackCallback(NULL)
     , mLogCallback(NULL) 
+    , mMemoryPressureCallback(NULL)
+    , mTraceCallback(NULL)
+    , mPauseCallback(NULL)
+    , mJITCodeCallback(NULL)
+    , mOptimizeCallback(NULL)
+    , mOptimizationDiagnosticsCallback(NULL)
 	{
         // Do nothing.
     }
@@ -75,6 +122,388 @@ size_t JSGetHeapWatermark(void)
 	return sSettingsJS.mJavaScriptHeapWatermark;
 }
 
+void JSSetHeapHardLimit(size_t size)
+{
+    sSettingsJS.mJavaScriptHeapHardLimit = size;
+}
+
+size_t JSGetHeapHardLimit(void)
+{
+    return sSettingsJS.mJavaScriptHeapHardLimit;
+}
+
+void JSSetMemoryPressureCallback(JSMemoryPressureCallback callback)
+{
+    sSettingsJS.mMemoryPressureCallback = callback;
+}
+
+JSMemoryPressureCallback JSGetMemoryPressureCallback(void)
+{
+    return sSettingsJS.mMemoryPressureCallback;
+}
+
+void JSSetAllocationTagCallback(JSAllocationTagCallback callback)
+{
+    WTF::setFastMallocTagHook(callback);
+}
+
+JSAllocationTagCallback JSGetAllocationTagCallback(void)
+{
+    return WTF::fastMallocTagHook();
+}
+
+void JSSetNumberOfGCMarkers(unsigned count)
+{
+    sSettingsJS.mNumberOfGCMarkers = count;
+}
+
+unsigned JSGetNumberOfGCMarkers(void)
+{
+    return sSettingsJS.mNumberOfGCMarkers;
+}
+
+void JSSetCodeAgingCollections(unsigned count)
+{
+    sSettingsJS.mCodeAgingCollections = count;
+}
+
+unsigned JSGetCodeAgingCollections(void)
+{
+    return sSettingsJS.mCodeAgingCollections;
+}
+
+void JSSetSharedSourceCacheSize(size_t size)
+{
+    sSettingsJS.mSharedSourceCacheSize = size;
+}
+
+size_t JSGetSharedSourceCacheSize(void)
+{
+    return sSettingsJS.mSharedSourceCacheSize;
+}
+
+void JSSetScriptSourceCacheSize(unsigned scripts)
+{
+    sSettingsJS.mScriptSourceCacheSize = scripts;
+}
+
+unsigned JSGetScriptSourceCacheSize(void)
+{
+    return sSettingsJS.mScriptSourceCacheSize;
+}
+
+void JSSetCompressedSourceThreshold(unsigned characters)
+{
+    sSettingsJS.mCompressedSourceThreshold = characters;
+}
+
+unsigned JSGetCompressedSourceThreshold(void)
+{
+    return sSettingsJS.mCompressedSourceThreshold;
+}
+
+void JSDiscardDecompressedSources(void)
+{
+    JSC::CompressedSourceProvider::discardDecompressedSources();
+}
+
+void JSSetNumericStringCacheSize(unsigned entries)
+{
+    sSettingsJS.mNumericStringCacheSize = entries;
+}
+
+unsigned JSGetNumericStringCacheSize(void)
+{
+    return sSettingsJS.mNumericStringCacheSize;
+}
+
+unsigned JSGetRegExpInterpreterFallbackCount(void)
+{
+    return JSC::RegExp::interpreterFallbackCount();
+}
+
+void JSSetRegExpMatchLimit(unsigned steps)
+{
+    sSettingsJS.mRegExpMatchLimit = steps;
+}
+
+unsigned JSGetRegExpMatchLimit(void)
+{
+    return sSettingsJS.mRegExpMatchLimit;
+}
+
+void JSSetRegExpTimeLimit(unsigned milliseconds)
+{
+    sSettingsJS.mRegExpTimeLimit = milliseconds;
+}
+
+unsigned JSGetRegExpTimeLimit(void)
+{
+    return sSettingsJS.mRegExpTimeLimit;
+}
+
+void JSSetRegExpJITCodeBudget(size_t bytes)
+{
+    sSettingsJS.mRegExpJITCodeBudget = bytes;
+}
+
+size_t JSGetRegExpJITCodeBudget(void)
+{
+    return sSettingsJS.mRegExpJITCodeBudget;
+}
+
+bool JSCollectIncremental(JSContextRef ctx, unsigned microseconds)
+{
+    if (!ctx)
+        return false;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    return exec->globalData().heap.collectIncrementally(microseconds / 1000000.0);
+}
+
+bool JSIdleNotification(JSContextRef ctx, unsigned microseconds)
+{
+    if (!ctx)
+        return false;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    return exec->globalData().heap.activityCallback()->didBecomeIdle(microseconds / 1000000.0);
+}
+
+COMPILE_ASSERT(static_cast<int>(kJSHeapPhaseCount) == static_cast<int>(JSC::NumberOfGCPhases), JSHeapPhase_matches_GCPhase);
+COMPILE_ASSERT(WTF_ARRAY_LENGTH(((JSHeapPhaseStatistics*)0)->histogram) == JSC::GCPhaseStatistics::histogramSize, JSHeapPhaseStatistics_histogram_matches_GCPhaseStatistics);
+
+bool JSGetHeapStatistics(JSContextRef ctx, JSHeapStatistics* stats)
+{
+    if (!ctx || !stats)
+        return false;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    JSC::HeapStatistics heapStats = JSC::heapStatistics(exec->globalData().heap);
+    stats->size = heapStats.size;
+    stats->capacity = heapStats.capacity;
+    stats->largeObjectBytes = heapStats.largeObjectBytes;
+    stats->collectionCount = heapStats.collectionCount;
+    stats->liveBytesAfterLastCollection = heapStats.liveBytesAfterLastCollection;
+    stats->bytesFreed = heapStats.bytesFreed;
+    stats->bytesPromoted = heapStats.bytesPromoted;
+    for (size_t i = 0; i < kJSHeapPhaseCount; ++i) {
+        const JSC::GCPhaseStatistics& phase = heapStats.phases[i];
+        stats->phases[i].count = phase.count;
+        stats->phases[i].totalTime = phase.totalTime;
+        stats->phases[i].maxTime = phase.maxTime;
+        for (size_t j = 0; j < JSC::GCPhaseStatistics::histogramSize; ++j)
+            stats->phases[i].histogram[j] = phase.histogram[j];
+    }
+    return true;
+}
+
+size_t JSGetHeapSizeClassStatistics(JSContextRef ctx, JSHeapSizeClassStatistics* sizeClasses, size_t capacity)
+{
+    if (!ctx)
+        return 0;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    JSC::HeapStatistics heapStats = JSC::heapStatistics(exec->globalData().heap);
+    size_t count = heapStats.sizeClasses.size();
+    for (size_t i = 0; i < count && i < capacity; ++i) {
+        const JSC::SizeClassStatistics& sizeClass = heapStats.sizeClasses[i];
+        sizeClasses[i].cellSize = sizeClass.cellSize;
+        sizeClasses[i].blockCount = sizeClass.blockCount;
+        sizeClasses[i].cellCount = sizeClass.cellCount;
+        sizeClasses[i].liveCellCount = sizeClass.liveCellCount;
+    }
+    return count;
+}
+
+size_t JSGetMemoryBreakdown(JSContextRef ctx, JSMemoryBreakdown* breakdown, JSClassMemoryStatistics* classes, size_t capacity)
+{
+    if (!ctx || !breakdown)
+        return 0;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    JSC::MemoryBreakdown memory = JSC::memoryBreakdown(exec->globalData());
+    breakdown->propertyStorageBytes = memory.propertyStorageBytes;
+    breakdown->arrayStorageBytes = memory.arrayStorageBytes;
+    breakdown->stringCount = memory.stringCount;
+    breakdown->stringBytes = memory.stringBytes;
+    breakdown->ropeCount = memory.ropeCount;
+    breakdown->ropeBytes = memory.ropeBytes;
+    breakdown->structureCount = memory.structureCount;
+    breakdown->propertyTableBytes = memory.propertyTableBytes;
+    breakdown->codeBlockCount = memory.codeBlockCount;
+    breakdown->bytecodeBytes = memory.bytecodeBytes;
+    breakdown->codeBlockSideTableBytes = memory.codeBlockSideTableBytes;
+    breakdown->baselineJITBytes = memory.baselineJITBytes;
+    breakdown->optimizingJITBytes = memory.DFGJITBytes;
+    breakdown->regExpCount = memory.regExpCount;
+    breakdown->regExpJITBytes = memory.regExpJITBytes;
+    breakdown->regExpBytecodeBytes = memory.regExpBytecodeBytes;
+    breakdown->sourceProviderCount = memory.sourceProviderCount;
+    breakdown->sourceBytes = memory.sourceBytes;
+    breakdown->parserArenaPeakBytes = memory.parserArenaPeakBytes;
+
+    JSC::GlobalMemoryStatistics global = JSC::globalMemoryStatistics();
+    breakdown->stackBytes = global.stackBytes;
+    breakdown->executableBytes = global.JITBytes;
+
+    size_t count = memory.classes.size();
+    for (size_t i = 0; i < count && i < capacity; ++i) {
+        const JSC::ClassMemoryStatistics& classStatistics = memory.classes[i];
+        classes[i].className = classStatistics.classInfo->className;
+        classes[i].cellCount = classStatistics.cellCount;
+        classes[i].cellBytes = classStatistics.cellBytes;
+    }
+    return count;
+}
+
+COMPILE_ASSERT(static_cast<int>(kJSCompilationTierCount) == static_cast<int>(JSC::CompilationStatistics::NumberOfTiers), JSCompilationTier_matches_CompilationStatistics_Tier);
+
+bool JSGetCompilationStatistics(JSContextRef ctx, JSCompilationStatistics* stats)
+{
+    if (!ctx || !stats)
+        return false;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    const JSC::CompilationStatistics& compilationStats = exec->globalData().compilationStatistics;
+    for (size_t i = 0; i < kJSCompilationTierCount; ++i) {
+        const JSC::CompilationStatistics::TierStatistics& tier = compilationStats.tiers[i];
+        stats->tiers[i].count = tier.count;
+        stats->tiers[i].totalTime = tier.totalTime;
+        stats->tiers[i].maxTime = tier.maxTime;
+        stats->tiers[i].codeBytes = tier.totalSize;
+    }
+    stats->reoptimizationCount = compilationStats.reoptimizationCount;
+    return true;
+}
+
+bool JSWriteHeapSnapshot(JSContextRef ctx, JSHeapSnapshotWriter writer, void* userData)
+{
+    if (!ctx || !writer)
+        return false;
+
+    JSC::ExecState* exec = toJS(ctx);
+    JSC::APIEntryShim entryShim(exec, false);
+
+    JSC::HeapSnapshot snapshot;
+    exec->globalData().heap.takeHeapSnapshot(snapshot);
+    if (!snapshot.cellCount())
+        return false;
+
+    WTF::Vector<char> json;
+    snapshot.writeJSON(json);
+    writer(json.data(), json.size(), userData);
+    return true;
+}
+
+#if !HAVE(DTRACE)
+namespace JSC {
+
+TraceCallback traceCallback = 0;
+
+COMPILE_ASSERT(static_cast<int>(kJSTraceExecutablePoolGrow) == static_cast<int>(TraceExecutablePoolGrow), JSTraceEvent_matches_TraceEvent);
+
+static void forwardTraceEvent(TraceEvent event, const void* subject, size_t arg0, size_t arg1)
+{
+    if (JSTraceCallback callback = sSettingsJS.mTraceCallback)
+        callback(static_cast<JSTraceEvent>(event), subject, arg0, arg1);
+}
+
+} // namespace JSC
+#endif
+
+void JSSetTraceCallback(JSTraceCallback callback)
+{
+    sSettingsJS.mTraceCallback = callback;
+#if !HAVE(DTRACE)
+    JSC::traceCallback = callback ? JSC::forwardTraceEvent : 0;
+#endif
+}
+
+JSTraceCallback JSGetTraceCallback(void)
+{
+    return sSettingsJS.mTraceCallback;
+}
+
+namespace JSC {
+
+PauseCallback pauseCallback = 0;
+
+COMPILE_ASSERT(static_cast<int>(kJSPauseExecutableMemoryExhaustion) == static_cast<int>(ExecutableMemoryExhaustionPause), JSPauseKind_matches_PauseKind);
+
+static void forwardPauseEvent(const PauseEvent& event)
+{
+    JSPauseCallback callback = sSettingsJS.mPauseCallback;
+    if (!callback)
+        return;
+
+    JSPauseEvent pauseEvent;
+    pauseEvent.kind = static_cast<JSPauseKind>(event.kind);
+    pauseEvent.isEnd = event.isEnd;
+    pauseEvent.detail = event.detail;
+    pauseEvent.startTime = event.startTime;
+    pauseEvent.duration = event.duration;
+    pauseEvent.bytes = event.bytes;
+    callback(&pauseEvent);
+}
+
+} // namespace JSC
+
+void JSSetPauseCallback(JSPauseCallback callback)
+{
+    sSettingsJS.mPauseCallback = callback;
+    JSC::pauseCallback = callback ? JSC::forwardPauseEvent : 0;
+}
+
+JSPauseCallback JSGetPauseCallback(void)
+{
+    return sSettingsJS.mPauseCallback;
+}
+
+void JSSetJITCodeCallback(JSJITCodeCallback callback)
+{
+    sSettingsJS.mJITCodeCallback = callback;
+    JSC::JITCodeLog::setCallback(callback);
+}
+
+JSJITCodeCallback JSGetJITCodeCallback(void)
+{
+    return sSettingsJS.mJITCodeCallback;
+}
+
+void JSSetOptimizeCallback(JSOptimizeCallback callback)
+{
+    sSettingsJS.mOptimizeCallback = callback;
+}
+
+JSOptimizeCallback JSGetOptimizeCallback(void)
+{
+    return sSettingsJS.mOptimizeCallback;
+}
+
+void JSSetOptimizationDiagnosticsCallback(JSOptimizationDiagnosticsCallback callback)
+{
+    sSettingsJS.mOptimizationDiagnosticsCallback = callback;
+    JSC::JITDiagnostics::setCallback(callback);
+}
+
+JSOptimizationDiagnosticsCallback JSGetOptimizationDiagnosticsCallback(void)
+{
+    return sSettingsJS.mOptimizationDiagnosticsCallback;
+}
+
 void JSSetPrintExceptions(bool active)
 {
     sSettingsJS.mPrintExceptions = active;            
@@ -105,6 +534,36 @@ JSCallstackCallback JSGetCallstackCallback(void)
     return sSettingsJS.mCallstackCallback;
 }
 
+void JSSetCompactCallstackCallback(JSCompactCallstackCallback callback)
+{
+    sSettingsJS.mCompactCallstackCallback = callback;
+}
+
+JSCompactCallstackCallback JSGetCompactCallstackCallback(void)
+{
+    return sSettingsJS.mCompactCallstackCallback;
+}
+
+bool JSSymbolizeCallstackFrame(const JSCallstackFrame& frame, eastl::string8* nameOut, int* lineOut, eastl::string8* urlOut)
+{
+    JSC::CodeBlock* codeBlock = static_cast<JSC::CodeBlock*>(frame.codeBlock);
+    if (!codeBlock)
+        return false;
+
+    JSC::ScriptExecutable* executable = codeBlock->ownerExecutable();
+    if (nameOut) {
+        if (codeBlock->codeType() == JSC::FunctionCode)
+            *nameOut = static_cast<JSC::FunctionExecutable*>(executable)->name().ustring().ascii().data();
+        else
+            nameOut->clear();
+    }
+    if (lineOut)
+        *lineOut = codeBlock->lineNumberForBytecodeOffset(frame.bytecodeOffset);
+    if (urlOut)
+        *urlOut = executable->sourceURL().ascii().data();
+    return true;
+}
+
 // Not exactly a setting so might need to move this to a different location but is EA platform specific.  
 void JSFinalize(void)
 {
@@ -31,10 +31,14 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define JSSettingsEA_h
 
 #include "JSBase.h"
+#include <stddef.h>
+#ifdef __cplusplus
 #include <eastl/string.h>
 #include <eastl/vector.h>
+#endif
 
-/* Javascript configurable settings */
+/* Javascript configurable settings. The parts that need EASTL are C++ only; the rest can be
+   included from C. */
 
 // For setting the stack size used by the RegisterFile
 void JSSetStackSize(size_t  size);
@@ -43,10 +47,350 @@ size_t JSGetStackSize(void);
 void JSSetHeapWatermark(size_t  size);
 size_t JSGetHeapWatermark(void);
 
+// For a hard cap on the GC heap, its large backing stores and cached blocks, the extra memory
+// reported since the last collection, and JIT memory. 0, the default, means no cap. An allocation
+// that would go past the cap first sheds what the engine can rebuild: it discards JIT code, clears
+// the parser and regular expression caches, and collects all garbage. If that still isn't enough
+// room, the callback is called with the bytes in use and requested. Returning true lets the
+// allocation go ahead; returning false, or having no callback, fails it. The failure throws an out
+// of memory error where the allocation can fail, such as array storage growth. Cell allocations
+// always go ahead.
+typedef bool (*JSMemoryPressureCallback)(size_t bytesInUse, size_t bytesRequested, size_t hardLimit);
+void JSSetHeapHardLimit(size_t size);
+size_t JSGetHeapHardLimit(void);
+void JSSetMemoryPressureCallback(JSMemoryPressureCallback callback);
+JSMemoryPressureCallback JSGetMemoryPressureCallback(void);
+
+// For attributing malloc memory to engine subsystems. The callback is called with entering true
+// when the calling thread starts parsing, generating bytecode, compiling JIT code, compiling a
+// regular expression or collecting garbage, and with the same tag and false when it finishes, so
+// a memory tracker can push and pop the tag around the allocations in between. Tags nest and are
+// string literals such as "JSC/Parser".
+typedef void (*JSAllocationTagCallback)(const char* tag, bool entering);
+void JSSetAllocationTagCallback(JSAllocationTagCallback callback);
+JSAllocationTagCallback JSGetAllocationTagCallback(void);
+
+// For parallel marking (ENABLE_PARALLEL_GC). This is the total number of threads that
+// mark, including the collecting thread; 1 means serial marking. Read when a heap is created.
+void JSSetNumberOfGCMarkers(unsigned count);
+unsigned JSGetNumberOfGCMarkers(void);
+
+// For discarding the code of functions that have stopped running. On the first entry into
+// JavaScript after a collection, the bytecode and JIT code of each function that hasn't been
+// called since the last count such rounds is thrown away, and regenerated if the function is
+// called again. Calls between JIT code are unlinked at each round so that they are noticed.
+// 0, the default, turns this off; code is then only discarded when JIT memory runs low.
+void JSSetCodeAgingCollections(unsigned count);
+unsigned JSGetCodeAgingCollections(void);
+
+// For sharing pre-parse results between contexts. Function boundaries found while parsing a
+// script are kept, up to this many bytes in total, keyed by the script's text, so that the same
+// script loaded into another context (or after a reload) can skip those functions when parsing.
+// Scripts are evicted oldest first. 0, the default, turns this off.
+void JSSetSharedSourceCacheSize(size_t size);
+size_t JSGetSharedSourceCacheSize(void);
+
+// For sharing scripts between the contexts of a group. The group remembers this many of the
+// scripts of at least 1K characters most recently passed to JSEvaluateScript, by text, URL and
+// starting line, and the same script evaluated in another context of the group reuses the
+// text and the function boundaries found so far instead of copying them. Scripts are evicted
+// least recently evaluated first. Read when a context group is created. 0, the default, turns
+// this off.
+void JSSetScriptSourceCacheSize(unsigned scripts);
+unsigned JSGetScriptSourceCacheSize(void);
+
+// For keeping script text compressed in memory. Scripts passed to JSEvaluateScript that are at
+// least this many characters long are stored compressed in 8K-character chunks, and a chunk is
+// only unpacked when a function in it is compiled or converted to a string. 0, the default,
+// turns this off. Unpacked text stays resident until JSDiscardDecompressedSources() is called,
+// which must only happen while no script is being evaluated, e.g. between frames.
+void JSSetCompressedSourceThreshold(unsigned characters);
+unsigned JSGetCompressedSourceThreshold(void);
+void JSDiscardDecompressedSources(void);
+
+// For number-to-string conversion. The number of recently converted doubles, ints and unsigneds
+// each context remembers the string for, rounded up to a power of two between 16 and 16K.
+// Read when a context group is created. The default is 64.
+void JSSetNumericStringCacheSize(unsigned entries);
+unsigned JSGetNumericStringCacheSize(void);
+
+// For finding regular expressions worth rewriting. The number of patterns, across all contexts,
+// that were compiled for the interpreter because the regexp JIT does not support something they
+// use, such as a backreference. Enable the kJSTraceRegExpCompileEnd trace to see which ones.
+unsigned JSGetRegExpInterpreterFallbackCount(void);
+
+// For bounding regular expression backtracking. A match that takes more than the given number
+// of interpreter steps, or more than the given number of milliseconds, is abandoned with a
+// catchable Error and reported through the log callback. The default is 1,000,000 steps and no
+// time limit; 0 turns either limit off. Patterns that can backtrack catastrophically (groups with
+// a variable count around variable-count terms or alternatives) and are compiled while a time
+// limit or a step limit other than the default is set run in the interpreter, because JIT code
+// has no point at which to count steps or check the clock. These have C linkage so that C
+// embedders and tests can set them.
+#ifdef __cplusplus
+extern "C" {
+#endif
+JS_EXPORT void JSSetRegExpMatchLimit(unsigned steps);
+JS_EXPORT unsigned JSGetRegExpMatchLimit(void);
+JS_EXPORT void JSSetRegExpTimeLimit(unsigned milliseconds);
+JS_EXPORT unsigned JSGetRegExpTimeLimit(void);
+#ifdef __cplusplus
+}
+#endif
+
+// For capping the executable memory used by regular expressions. Once the JIT code of a context
+// group's regular expressions exceeds this many bytes, the least recently matched ones drop their
+// code and are compiled again on their next match. Read when a context group is created. The
+// default, 0, means no limit.
+void JSSetRegExpJITCodeBudget(size_t bytes);
+size_t JSGetRegExpJITCodeBudget(void);
+
+// For incremental marking (ENABLE_INCREMENTAL_MARKING). Call at a frame boundary to spend up
+// to the given number of microseconds marking. A marking cycle starts once the heap is halfway
+// to its watermark; when its marking is done the cycle finishes with one short pause that
+// rescans the roots. Returns true if that pause ran, i.e. the heap was collected.
+bool JSCollectIncremental(JSContextRef ctx, unsigned microseconds);
+
+// For idle-time collection. Call when the engine has the given number of microseconds to spare,
+// such as the time left until the next frame. That time goes on an incremental marking slice or
+// a collection the heap would otherwise need soon. Once nothing has been collected for two
+// seconds it goes on a full collection that shrinks the heap, and then on releasing cached
+// blocks. Nothing starts that isn't expected to fit in the time given. Returns true if the
+// heap was collected.
+bool JSIdleNotification(JSContextRef ctx, unsigned microseconds);
+
+// For heap instrumentation. Times are in seconds. Bucket i of a phase's histogram counts pauses
+// shorter than 2^i half-milliseconds, and the last bucket counts everything longer. Marking the
+// roots includes harvesting weak references, and a sweep is the lazy sweeping done by one trip
+// through the allocation slow path. Freed and promoted bytes are totals since the heap was created.
+typedef enum JSHeapPhase
+{
+    kJSHeapPhaseMarkRoots,
+    kJSHeapPhaseHarvestWeakReferences,
+    kJSHeapPhaseFinalize,
+    kJSHeapPhaseSweep,
+    kJSHeapPhaseShrink,
+    kJSHeapPhaseCount
+} JSHeapPhase;
+
+typedef struct JSHeapPhaseStatistics
+{
+    size_t count;
+    double totalTime;
+    double maxTime;
+    size_t histogram[8];
+} JSHeapPhaseStatistics;
+
+typedef struct JSHeapStatistics
+{
+    size_t size;
+    size_t capacity;
+    size_t largeObjectBytes;
+    size_t collectionCount;
+    size_t liveBytesAfterLastCollection;
+    size_t bytesFreed;
+    size_t bytesPromoted;
+    JSHeapPhaseStatistics phases[kJSHeapPhaseCount];
+} JSHeapStatistics;
+
+typedef struct JSHeapSizeClassStatistics
+{
+    size_t cellSize;
+    size_t blockCount;
+    size_t cellCount;
+    size_t liveCellCount;
+} JSHeapSizeClassStatistics;
+
+bool JSGetHeapStatistics(JSContextRef ctx, JSHeapStatistics* stats);
+// Copies up to capacity size classes, smallest cells first, and returns the number of size classes in use.
+size_t JSGetHeapSizeClassStatistics(JSContextRef ctx, JSHeapSizeClassStatistics* sizeClasses, size_t capacity);
+
+// For trimming memory. Where the memory of the context group goes, in bytes, as of the last
+// collection plus cells allocated since; call JSGarbageCollect() first for live memory only.
+// This walks the whole heap. Strings and source providers shared by several owners are counted
+// once. Strings are always 16-bit, and ropes are counted by the characters they will need once
+// resolved. The side tables of code blocks are everything but their instructions and machine
+// code. The parser arena figure is the most one parse has held. The stack and executable memory
+// figures are process wide; the heap totals are in JSHeapStatistics.
+typedef struct JSMemoryBreakdown
+{
+    size_t propertyStorageBytes;
+    size_t arrayStorageBytes;
+    size_t stringCount;
+    size_t stringBytes;
+    size_t ropeCount;
+    size_t ropeBytes;
+    size_t structureCount;
+    size_t propertyTableBytes;
+    size_t codeBlockCount;
+    size_t bytecodeBytes;
+    size_t codeBlockSideTableBytes;
+    size_t baselineJITBytes;
+    size_t optimizingJITBytes;
+    size_t regExpCount;
+    size_t regExpJITBytes;
+    size_t regExpBytecodeBytes;
+    size_t sourceProviderCount;
+    size_t sourceBytes;
+    size_t parserArenaPeakBytes;
+    size_t stackBytes;
+    size_t executableBytes;
+} JSMemoryBreakdown;
+
+typedef struct JSClassMemoryStatistics
+{
+    const char* className;
+    size_t cellCount;
+    size_t cellBytes;
+} JSClassMemoryStatistics;
+
+// Fills in the breakdown, copies up to capacity classes of cells, largest first, and returns the
+// number of classes with cells in the heap.
+size_t JSGetMemoryBreakdown(JSContextRef ctx, JSMemoryBreakdown* breakdown, JSClassMemoryStatistics* classes, size_t capacity);
+
+// For tuning tier-up thresholds and sizing the executable pool. Totals since the context group was
+// created; times are in seconds. The code bytes of the bytecode tier are bytes of instructions, and
+// those of the other tiers bytes of machine code. A RegExp compile that falls back to the
+// interpreter counts with no code bytes. Reoptimizations count optimized code thrown away after
+// too many speculation failures, each of which is followed by another optimizing compile.
+typedef enum JSCompilationTier
+{
+    kJSCompilationTierBytecode,
+    kJSCompilationTierBaselineJIT,
+    kJSCompilationTierOptimizingJIT,
+    kJSCompilationTierRegExp,
+    kJSCompilationTierCount
+} JSCompilationTier;
+
+typedef struct JSCompilationTierStatistics
+{
+    size_t count;
+    double totalTime;
+    double maxTime;
+    size_t codeBytes;
+} JSCompilationTierStatistics;
+
+typedef struct JSCompilationStatistics
+{
+    JSCompilationTierStatistics tiers[kJSCompilationTierCount];
+    size_t reoptimizationCount;
+} JSCompilationStatistics;
+
+bool JSGetCompilationStatistics(JSContextRef ctx, JSCompilationStatistics* stats);
+
+// For heap snapshots. Collects all garbage, then hands the writer a JSON description of every live
+// cell, by class and structure, and of every reference from a root or a cell to another cell. The
+// format is documented in heap/HeapSnapshot.h. The writer is called once, before this returns.
+typedef void (*JSHeapSnapshotWriter)(const char* data, size_t length, void* userData);
+bool JSWriteHeapSnapshot(JSContextRef ctx, JSHeapSnapshotWriter writer, void* userData);
+
+// For tracing. Without DTrace, the engine's static probes (see runtime/Tracing.h) call this, if
+// it is set; with DTrace they go to DTrace instead. The meaning of subject, arg0 and arg1 depends
+// on the event:
+// - GC begin, marked, end: nothing.
+// - GC heap size: arg0 and arg1 are the heap's bytes before and after the collection.
+// - GC phase begin and end: arg0 is a JSHeapPhase, arg1 the bytes allocated since the last collection.
+// - JIT compile begin and end: subject is the code block, arg0 the tier (0 baseline, 1 DFG), and
+//   arg1, at the end, the machine code bytes, or 0 if the compile was abandoned.
+// - OSR entry and exit: subject is the optimized code block, arg0 the bytecode index. Exits are
+//   only reported by code compiled while the callback was set.
+// - RegExp compile begin and end: subject is the pattern as a UTF-8 string, and arg0, at the end,
+//   is 1 if it was compiled to machine code.
+// - Executable pool growth: arg0 is the bytes of JIT memory reserved or committed.
+// The callback runs on the thread that caused the event, at times when the engine can't be used.
+typedef enum JSTraceEvent
+{
+    kJSTraceGCBegin,
+    kJSTraceGCMarked,
+    kJSTraceGCEnd,
+    kJSTraceGCHeapSize,
+    kJSTraceGCPhaseBegin,
+    kJSTraceGCPhaseEnd,
+    kJSTraceJITCompileBegin,
+    kJSTraceJITCompileEnd,
+    kJSTraceOSREntry,
+    kJSTraceOSRExit,
+    kJSTraceRegExpCompileBegin,
+    kJSTraceRegExpCompileEnd,
+    kJSTraceExecutablePoolGrow
+} JSTraceEvent;
+
+typedef void (*JSTraceCallback)(JSTraceEvent event, const void* subject, size_t arg0, size_t arg1);
+void JSSetTraceCallback(JSTraceCallback callback);
+JSTraceCallback JSGetTraceCallback(void);
+
+// For frame telemetry. Called at the start and the end of each time the engine holds up the
+// thread running JavaScript, with isEnd false and then true. Times are in seconds on the clock
+// of monotonicallyIncreasingTime(); duration is only set at the end. The meaning of detail and
+// bytes depends on the kind:
+// - Garbage collection: detail is 0 for a full collection and 1 for a nursery collection, bytes
+//   the heap size at the start and, at the end, the heap size left.
+// - GC phase: detail is a JSHeapPhase, bytes what has been allocated since the last collection.
+//   Phases nest inside collections, except sweeps, which happen on the allocation slow path.
+// - Compilation: detail is a JSCompilationTier, bytes 0 at the start and the code generated at
+//   the end, or 0 if the compilation was abandoned.
+// - Register file growth: bytes is the memory committed for the JavaScript stack.
+// - Executable memory exhaustion: bytes is the allocation that did not fit while JIT code is
+//   thrown away to make room.
+// Events can nest, and an end is always reported for a start that was. The cost without a
+// callback is a load and a branch per event, so the callback can be left on in shipped builds.
+typedef enum JSPauseKind
+{
+    kJSPauseGarbageCollection,
+    kJSPauseGCPhase,
+    kJSPauseCompilation,
+    kJSPauseRegisterFileGrowth,
+    kJSPauseExecutableMemoryExhaustion
+} JSPauseKind;
+
+typedef struct JSPauseEvent
+{
+    JSPauseKind kind;
+    bool isEnd;
+    int detail;
+    double startTime;
+    double duration;
+    size_t bytes;
+} JSPauseEvent;
+
+typedef void (*JSPauseCallback)(const JSPauseEvent* event);
+void JSSetPauseCallback(JSPauseCallback callback);
+JSPauseCallback JSGetPauseCallback(void);
+
+// For native profilers. Each block of JIT code is reported once, when it is generated, with its
+// start address, size in bytes and a name such as "baseline <function> <url>:<line>", "DFG ...",
+// "RegExp (8-bit)", "JIT thunk" or "JIT stub". Code is not reported when it is freed, and its
+// memory may later hold other code, so the latest report for an address is the one that counts.
+// On Linux the same records can also be appended to /tmp/perf-<pid>.map for perf by setting the
+// JavaScriptCorePerfMap environment variable. The callback may run on any thread generating code.
+typedef void (*JSJITCodeCallback)(const void* start, size_t size, const char* name);
+void JSSetJITCodeCallback(JSJITCodeCallback callback);
+JSJITCodeCallback JSGetJITCodeCallback(void);
+
+// For spreading out tier-up stalls. Called on the thread running JavaScript just before a hot
+// function (or a hot loop in it) is recompiled with the optimizing JIT, with the number of
+// bytecode instructions in it; compile time grows with this. Returning false defers the
+// compilation: the function keeps running its baseline code and asks again after a further
+// warm-up period. Compilation always happens synchronously on the thread that asked.
+typedef bool (*JSOptimizeCallback)(size_t instructionCount);
+void JSSetOptimizeCallback(JSOptimizeCallback callback);
+JSOptimizeCallback JSGetOptimizeCallback(void);
+
+// For finding out why hot code stays in the baseline JIT or keeps leaving optimized code. Called
+// with one line at a time, prefixed with the code block it is about: why a function could not be
+// optimized (for instance the first unsupported opcode), the type predictions and speculation
+// checks the optimizing JIT compiled with, and each OSR entry, failed entry and exit, with the
+// bytecode index and the operation whose speculation failed. Exits are only reported from code
+// optimized while a callback was set. Meant for development builds; the messages are not stable.
+typedef void (*JSOptimizationDiagnosticsCallback)(const char* message);
+void JSSetOptimizationDiagnosticsCallback(JSOptimizationDiagnosticsCallback callback);
+JSOptimizationDiagnosticsCallback JSGetOptimizationDiagnosticsCallback(void);
+
 // For exception printing
 void JSSetPrintExceptions(bool active);
 bool JSPrintExceptionsEnabled(void);
 
+#ifdef __cplusplus
 // For setting default locale
 void JSSetDefaultLocale(const char8_t* pLocale);
 const char8_t* JSGetDefaultLocale();
@@ -55,13 +399,35 @@ const char8_t* JSGetDefaultLocale();
 typedef void (*JSCallstackCallback)(const eastl::vector<eastl::string8> &names, const eastl::vector<eastl::string8> &args, const eastl::vector<int> &lines, const eastl::vector<eastl::string8> &urls);
 void JSSetCallstackCallback(JSCallstackCallback callback);
 JSCallstackCallback JSGetCallstackCallback(void);
+#endif
+
+// For cheap callstack capturing. When set, this callback is used for uncaught exceptions instead of
+// the one above. It gets the raw frames, innermost first and at most JSCompactCallstackMaxFrames of
+// them, from a buffer on the stack; no strings are built and no arguments are converted. Each frame's
+// bytecodeOffset is that of the instruction executing in it. The frames are only valid during the
+// callback: JSSymbolizeCallstackFrame turns the ones the embedder wants into a function name (empty
+// for global and eval code), a line and a URL.
+typedef struct JSCallstackFrame
+{
+    void* codeBlock;
+    unsigned bytecodeOffset;
+} JSCallstackFrame;
+enum { JSCompactCallstackMaxFrames = 64 };
+typedef void (*JSCompactCallstackCallback)(const JSCallstackFrame* frames, size_t frameCount);
+void JSSetCompactCallstackCallback(JSCompactCallstackCallback callback);
+JSCompactCallstackCallback JSGetCompactCallstackCallback(void);
+#ifdef __cplusplus
+bool JSSymbolizeCallstackFrame(const JSCallstackFrame& frame, eastl::string8* nameOut, int* lineOut, eastl::string8* urlOut);
+#endif
 
 // For leak fixes on general shutdown.
 void JSFinalize(void);
 
+#ifdef __cplusplus
 // Assertion/Logging
 typedef void (*JSLogCallback)(const eastl::string8 &message, bool shouldAssert);
 void JSSetLogCallback(JSLogCallback callback);
 JSLogCallback JSGetLogCallback(void);
+#endif
 
 #endif /* JSSettingsEA_h */
@@ -25,6 +25,7 @@
 
 #include "config.h"
 #include "JSStringRef.h"
+#include "JSStringRefPrivate.h"
 
 #include "InitializeThreading.h"
 #include "OpaqueJSString.h"
@@ -39,6 +40,16 @@ JSStringRef JSStringCreateWithCharacters(const JSChar* chars, size_t numChars)
     return OpaqueJSString::create(chars, numChars).leakRef();
 }
 
+static void releaseNothing(const JSChar*, void*)
+{
+}
+
+JSStringRef JSStringCreateWithCharactersNoCopy(const JSChar* chars, size_t numChars, JSStringCharactersReleaseCallback release, void* context)
+{
+    initializeThreading();
+    return OpaqueJSString::createExternal(chars, numChars, release ? release : releaseNothing, context).leakRef();
+}
+
 JSStringRef JSStringCreateWithUTF8CString(const char* string)
 {
     initializeThreading();
@@ -177,6 +177,32 @@ JS_EXPORT bool JSStringIsEqual(JSStringRef a, JSStringRef b);
 */
 JS_EXPORT bool JSStringIsEqualToUTF8CString(JSStringRef a, const char* b);
 
+/* JSValueWriteJSONString is declared here rather than in JSValueRef.h because its callback takes JSChar, which JSValueRef.h precedes. */
+
+/*!
+@typedef JSValueJSONChunkCallback
+@abstract Receives one piece of the text produced by JSValueWriteJSONString.
+@param characters The characters of this piece. They are only valid for the duration of the call.
+@param length The number of characters in this piece.
+@param userData The userData passed to JSValueWriteJSONString.
+@result true to continue serializing, false to stop.
+*/
+typedef bool (*JSValueJSONChunkCallback)(const JSChar* characters, size_t length, void* userData);
+
+/*!
+ @function
+ @abstract       Serializes a JS value to JSON, delivering the text to a callback in pieces instead of creating a string.
+ @param ctx      The execution context to use.
+ @param value    The value to serialize.
+ @param indent   The number of spaces to indent when nesting, as for JSValueCreateJSONString.
+ @param callback The callback that receives the serialized text, in order.
+ @param userData An argument passed to each invocation of callback.
+ @param exception A pointer to a JSValueRef in which to store an exception, if any. Pass NULL if you do not care to store an exception.
+ @result         true if the whole value was serialized. false if the value has no JSON representation, an exception was thrown or the callback stopped; the pieces delivered so far are then incomplete.
+ @discussion     The pieces are at most a few tens of kilobytes each, so the serialized text is never held in memory as a whole.
+ */
+JS_EXPORT bool JSValueWriteJSONString(JSContextRef ctx, JSValueRef value, unsigned indent, JSValueJSONChunkCallback callback, void* userData, JSValueRef* exception);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2008 Apple Computer, Inc.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE COMPUTER, INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE COMPUTER, INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#ifndef JSStringRefPrivate_h
+#define JSStringRefPrivate_h
+
+#include <JavaScriptCore/JSStringRef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+@typedef JSStringCharactersReleaseCallback
+@abstract The callback invoked when JavaScriptCore no longer needs a buffer passed to JSStringCreateWithCharactersNoCopy.
+@param characters The buffer originally passed to JSStringCreateWithCharactersNoCopy.
+@param context The context originally passed to JSStringCreateWithCharactersNoCopy.
+*/
+typedef void (*JSStringCharactersReleaseCallback)(const JSChar* characters, void* context);
+
+/*!
+@function
+@abstract Creates a JavaScript string that refers to a buffer of Unicode characters without copying it.
+@param chars The buffer of Unicode characters to refer to.
+@param numChars The number of characters in chars.
+@param release The callback to invoke once neither the returned string nor any JavaScript string made from it is alive. Pass NULL if the buffer outlives the JavaScript virtual machine.
+@param context The value passed to release.
+@result A JSString containing chars. Ownership follows the Create Rule.
+@discussion The contents of chars must not change until release is called. Since JavaScript strings may be collected on a different thread, release may be called on any thread.
+*/
+JS_EXPORT JSStringRef JSStringCreateWithCharactersNoCopy(const JSChar* chars, size_t numChars, JSStringCharactersReleaseCallback release, void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JSStringRefPrivate_h */
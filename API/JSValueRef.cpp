@@ -28,6 +28,8 @@
 
 #include "APICast.h"
 #include "APIShims.h"
+#include "HandleHeap.h"
+#include "JSBasePrivate.h"
 #include "JSCallbackObject.h"
 
 #include <runtime/JSGlobalObject.h>
@@ -256,6 +258,23 @@ JSStringRef JSValueCreateJSONString(JSContextRef ctx, JSValueRef apiValue, unsig
     return OpaqueJSString::create(result).leakRef();
 }
 
+bool JSValueWriteJSONString(JSContextRef ctx, JSValueRef apiValue, unsigned indent, JSValueJSONChunkCallback callback, void* userData, JSValueRef* exception)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+    JSValue value = toJS(exec, apiValue);
+    bool succeeded = JSONStringify(exec, value, indent, callback, userData);
+    if (exception)
+        *exception = 0;
+    if (exec->hadException()) {
+        if (exception)
+            *exception = toRef(exec, exec->exception());
+        exec->clearException();
+        return false;
+    }
+    return succeeded;
+}
+
 bool JSValueToBoolean(JSContextRef ctx, JSValueRef value)
 {
     ExecState* exec = toJS(ctx);
@@ -333,3 +352,53 @@ void JSValueUnprotect(JSContextRef ctx, JSValueRef value)
     JSValue jsValue = toJSForGC(exec, value);
     gcUnprotect(jsValue);
 }
+
+// A JSValueHandleRef is the handle heap slot itself, so handles cost no
+// allocation beyond the slot.
+static inline HandleSlot toHandleSlot(JSValueHandleRef handle)
+{
+    return reinterpret_cast<HandleSlot>(handle);
+}
+
+static inline void setHandleValue(ExecState* exec, HandleSlot slot, JSValueRef value)
+{
+    JSValue jsValue = value ? toJSForGC(exec, value) : JSValue();
+    HandleHeap::heapFor(slot)->writeBarrier(slot, jsValue);
+    *slot = jsValue;
+}
+
+JSValueHandleRef JSValueHandleCreate(JSContextRef ctx, JSValueRef value)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    HandleSlot slot = exec->globalData().allocateGlobalHandle();
+    setHandleValue(exec, slot, value);
+    return reinterpret_cast<JSValueHandleRef>(slot);
+}
+
+JSValueRef JSValueHandleGetValue(JSContextRef ctx, JSValueHandleRef handle)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    JSValue jsValue = *toHandleSlot(handle);
+    return jsValue ? toRef(exec, jsValue) : 0;
+}
+
+void JSValueHandleSetValue(JSContextRef ctx, JSValueHandleRef handle, JSValueRef value)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    setHandleValue(exec, toHandleSlot(handle), value);
+}
+
+void JSValueHandleRelease(JSContextRef ctx, JSValueHandleRef handle)
+{
+    ExecState* exec = toJS(ctx);
+    APIEntryShim entryShim(exec);
+
+    HandleSlot slot = toHandleSlot(handle);
+    HandleHeap::heapFor(slot)->deallocate(slot);
+}
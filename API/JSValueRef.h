@@ -281,6 +281,8 @@ JS_EXPORT JSObjectRef JSValueToObject(JSContextRef ctx, JSValueRef value, JSValu
 @discussion Use this method when you want to store a JSValue in a global or on the heap, where the garbage collector will not be able to discover your reference to it.
  
 A value may be protected multiple times and must be unprotected an equal number of times before becoming eligible for garbage collection.
+
+To protect many values, use the handles in JSBasePrivate.h, which protect and release values in constant time.
 */
 JS_EXPORT void JSValueProtect(JSContextRef ctx, JSValueRef value);
 
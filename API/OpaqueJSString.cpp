@@ -41,11 +41,23 @@ PassRefPtr<OpaqueJSString> OpaqueJSString::create(const UString& ustring)
 
 UString OpaqueJSString::ustring() const
 {
-    if (this && m_characters)
+    if (this && m_characters) {
+        // Borrowed characters are shared rather than copied; the StringImpl keeps us, and so the
+        // embedder's buffer, alive. The ref count is thread safe, so it may drop on any thread.
+        if (m_release && m_length) {
+            const_cast<OpaqueJSString*>(this)->ref();
+            return UString(StringImpl::createExternal(m_characters, m_length, derefFromExternalString, const_cast<OpaqueJSString*>(this)));
+        }
         return UString(m_characters, m_length);
+    }
     return UString();
 }
 
+void OpaqueJSString::derefFromExternalString(const UChar*, void* context)
+{
+    static_cast<OpaqueJSString*>(context)->deref();
+}
+
 Identifier OpaqueJSString::identifier(JSGlobalData* globalData) const
 {
     if (!this || !m_characters)
@@ -47,6 +47,13 @@ struct OpaqueJSString : public ThreadSafeRefCounted<OpaqueJSString> {
 
     static PassRefPtr<OpaqueJSString> create(const JSC::UString&);
 
+    // Borrows characters until release is called, once the string and every
+    // JavaScript string made from it are gone.
+    static PassRefPtr<OpaqueJSString> createExternal(const UChar* characters, unsigned length, void (*release)(const UChar*, void*), void* context)
+    {
+        return adoptRef(new OpaqueJSString(characters, length, release, context));
+    }
+
     UChar* characters() { return this ? m_characters : 0; }
     unsigned length() { return this ? m_length : 0; }
 
@@ -59,23 +66,42 @@ private:
     OpaqueJSString()
         : m_characters(0)
         , m_length(0)
+        , m_release(0)
+        , m_releaseContext(0)
     {
     }
 
     OpaqueJSString(const UChar* characters, unsigned length)
         : m_length(length)
+        , m_release(0)
+        , m_releaseContext(0)
     {
         m_characters = new UChar[length];
         memcpy(m_characters, characters, length * sizeof(UChar));
     }
 
+    OpaqueJSString(const UChar* characters, unsigned length, void (*release)(const UChar*, void*), void* context)
+        : m_characters(const_cast<UChar*>(characters))
+        , m_length(length)
+        , m_release(release)
+        , m_releaseContext(context)
+    {
+    }
+
     ~OpaqueJSString()
     {
-        delete[] m_characters;
+        if (m_release)
+            m_release(m_characters, m_releaseContext);
+        else
+            delete[] m_characters;
     }
 
+    static void derefFromExternalString(const UChar*, void*);
+
     UChar* m_characters;
     unsigned m_length;
+    void (*m_release)(const UChar*, void*);
+    void* m_releaseContext;
 };
 
 #endif
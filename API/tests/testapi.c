@@ -26,7 +26,12 @@
 #include "JavaScriptCore.h"
 #include "JSBasePrivate.h"
 #include "JSContextRefPrivate.h"
+#include "JSMessageQueueRefPrivate.h"
 #include "JSObjectRefPrivate.h"
+#include "JSProfilerPrivate.h"
+#include "JSScriptRefPrivate.h"
+#include "JSSettingsEA.h"
+#include "JSStringRefPrivate.h"
 #include <math.h>
 #define ASSERT_DISABLED 0
 #include <wtf/Assertions.h>
@@ -124,6 +129,67 @@ static void assertEqualsAsCharactersPtr(JSValueRef value, const char* expectedVa
     JSStringRelease(valueAsString);
 }
 
+typedef struct {
+    char buffer[64];
+    size_t length;
+    unsigned chunks;
+    bool stop;
+} JSONChunkAccumulator;
+
+static bool accumulateJSONChunk(const JSChar* characters, size_t length, void* userData)
+{
+    JSONChunkAccumulator* accumulator = (JSONChunkAccumulator*)userData;
+    accumulator->chunks++;
+    if (accumulator->stop)
+        return false;
+    for (size_t i = 0; i < length && accumulator->length < sizeof(accumulator->buffer) - 1; ++i)
+        accumulator->buffer[accumulator->length++] = (char)characters[i];
+    accumulator->buffer[accumulator->length] = '\0';
+    return true;
+}
+
+static void countExternalRelease(const JSChar* characters, void* context)
+{
+    UNUSED_PARAM(characters);
+    ++*(int*)context;
+}
+
+static void countSampledOpcode(const char* opcodeName, unsigned interpreterSamples, unsigned baselineJITSamples, unsigned optimizedJITSamples, void* userData)
+{
+    ASSERT(!strncmp(opcodeName, "op_", 3));
+    ASSERT(interpreterSamples || baselineJITSamples || optimizedJITSamples);
+    ++*(unsigned*)userData;
+}
+
+static void countInlineCacheSite(JSStringRef functionName, JSStringRef sourceURL, unsigned lineNumber, const char* kind, unsigned repatchCount, unsigned structureCount, bool isGeneric, void* userData)
+{
+    UNUSED_PARAM(functionName);
+    UNUSED_PARAM(sourceURL);
+    UNUSED_PARAM(lineNumber);
+    UNUSED_PARAM(structureCount);
+    ASSERT(kind && *kind);
+    ASSERT(repatchCount || isGeneric);
+    ++*(unsigned*)userData;
+}
+
+static void countAllocationSite(const JSStringRef* functionNames, const JSStringRef* sourceURLs, const unsigned* lineNumbers, unsigned depth, bool isPropertyStorage, size_t sampleCount, size_t sampledBytes, size_t checkedCount, size_t survivorCount, void* userData)
+{
+    UNUSED_PARAM(functionNames);
+    UNUSED_PARAM(sourceURLs);
+    UNUSED_PARAM(lineNumbers);
+    UNUSED_PARAM(isPropertyStorage);
+    ASSERT(depth <= 4);
+    ASSERT(sampleCount && sampledBytes);
+    ASSERT(survivorCount <= checkedCount && checkedCount <= sampleCount);
+    *(size_t*)userData += sampleCount;
+}
+
+static void countBytesDeallocation(void* bytes, void* deallocatorContext)
+{
+    UNUSED_PARAM(bytes);
+    ++*(int*)deallocatorContext;
+}
+
 static bool timeZoneIsPST()
 {
     char timeZoneName[70];
@@ -853,6 +919,24 @@ static JSValueRef functionGC(JSContextRef context, JSObjectRef function, JSObjec
     return JSValueMakeUndefined(context);
 }
 
+static JSValueRef addNumbers_callAsFunction(JSContextRef ctx, JSObjectRef functionObject, JSObjectRef thisObject, size_t argumentCount, const JSValueRef arguments[], JSValueRef* exception)
+{
+    UNUSED_PARAM(functionObject);
+    UNUSED_PARAM(thisObject);
+
+    double sum = 0;
+    size_t i;
+    for (i = 0; i < argumentCount; ++i) {
+        if (!JSValueIsNumber(ctx, arguments[i])) {
+            // Throw the index of the first argument that isn't a number.
+            *exception = JSValueMakeNumber(ctx, i);
+            return JSValueMakeUndefined(ctx);
+        }
+        sum += JSValueToNumber(ctx, arguments[i], NULL);
+    }
+    return JSValueMakeNumber(ctx, sum);
+}
+
 static JSStaticValue globalObject_staticValues[] = {
     { "globalStaticValue", globalObject_get, globalObject_set, kJSPropertyAttributeNone },
     { 0, 0, 0, 0 }
@@ -1123,6 +1207,146 @@ int main(int argc, char* argv[])
     } else
         printf("PASS: Retrieved private property.\n");
 
+    JSStringRef batchNames[2] = { JSStringCreateWithUTF8CString("x"), JSStringCreateWithUTF8CString("y") };
+    JSPropertyHandleRef batchHandles[2] = { JSPropertyHandleCreate(context, batchNames[0]), JSPropertyHandleCreate(context, batchNames[1]) };
+    JSValueRef batchValues[2] = { JSValueMakeNumber(context, 3), JSValueMakeNumber(context, 4) };
+    JSObjectRef batchObject = JSObjectMake(context, 0, 0);
+    JSObjectSetProperties(context, batchObject, 2, batchHandles, batchValues, kJSPropertyAttributeNone, 0);
+    assertEqualsAsNumber(JSObjectGetProperty(context, batchObject, batchNames[1], 0), 4);
+    batchValues[0] = batchValues[1] = 0;
+    JSObjectGetProperties(context, batchObject, 2, batchHandles, batchValues, 0);
+    assertEqualsAsNumber(batchValues[0], 3);
+    assertEqualsAsNumber(batchValues[1], 4);
+    JSPropertyHandleRelease(batchHandles[0]);
+    JSPropertyHandleRelease(batchHandles[1]);
+    JSStringRelease(batchNames[0]);
+    JSStringRelease(batchNames[1]);
+
+    JSValueHandleRef valueHandle = JSValueHandleCreate(context, JSObjectMakeArray(context, 0, 0, 0));
+    JSGarbageCollect(context);
+    ASSERT(JSValueIsObject(context, JSValueHandleGetValue(context, valueHandle)));
+    JSValueHandleSetValue(context, valueHandle, JSValueMakeNumber(context, 5));
+    assertEqualsAsNumber(JSValueHandleGetValue(context, valueHandle), 5);
+    JSValueHandleSetValue(context, valueHandle, 0);
+    ASSERT(!JSValueHandleGetValue(context, valueHandle));
+    JSValueHandleRelease(context, valueHandle);
+
+    JSStringRef counterSource = JSStringCreateWithUTF8CString("scriptCounter = (typeof scriptCounter == 'number' ? scriptCounter : 0) + 1");
+    JSScriptRef counterScript = JSScriptCreate(context, counterSource, NULL, 1, NULL);
+    JSScriptEvaluate(context, counterScript, NULL, NULL);
+    JSScriptEvaluate(context, counterScript, NULL, NULL);
+    assertEqualsAsNumber(JSScriptEvaluate(context, counterScript, NULL, NULL), 3);
+    JSScriptRelease(counterScript);
+    JSStringRelease(counterSource);
+
+    JSStringRef declaringSource = JSStringCreateWithUTF8CString("function scriptDeclared() { return 7; } scriptDeclared()");
+    JSStringRef clobberSource = JSStringCreateWithUTF8CString("scriptDeclared = 0");
+    JSScriptRef declaringScript = JSScriptCreate(context, declaringSource, NULL, 1, NULL);
+    assertEqualsAsNumber(JSScriptEvaluate(context, declaringScript, NULL, NULL), 7);
+    JSEvaluateScript(context, clobberSource, NULL, NULL, 1, NULL);
+    assertEqualsAsNumber(JSScriptEvaluate(context, declaringScript, NULL, NULL), 7);
+    JSScriptRelease(declaringScript);
+    JSStringRelease(clobberSource);
+    JSStringRelease(declaringSource);
+
+    JSStringRef badScriptSource = JSStringCreateWithUTF8CString("var x = ;");
+    JSValueRef scriptException = NULL;
+    if (JSScriptCreate(context, badScriptSource, NULL, 1, &scriptException) || !scriptException) {
+        printf("FAIL: JSScriptCreate accepted a syntax error.\n");
+        failed = 1;
+    } else
+        printf("PASS: JSScriptCreate reported a syntax error.\n");
+    JSStringRelease(badScriptSource);
+
+    JSMessageQueueRef messageQueue = JSMessageQueueCreate();
+    JSGlobalContextRef receivingContext = JSGlobalContextCreateInGroup(NULL, NULL);
+    JSStringRef messageSource = JSStringCreateWithUTF8CString("var message = { n: 1, s: 'str', list: [1, 2], bytes: new Uint8Array([7, 8]) }; message.self = message; message");
+    JSStringRef receivedName = JSStringCreateWithUTF8CString("received");
+    JSStringRef checkSource = JSStringCreateWithUTF8CString("received.self === received && received.n === 1 && received.s === 'str' && received.list[1] === 2 && received.bytes[1] === 8");
+    ASSERT(JSMessageQueuePost(context, messageQueue, JSEvaluateScript(context, messageSource, NULL, NULL, 1, NULL), NULL));
+    JSValueRef received = JSMessageQueueReceive(receivingContext, messageQueue, false);
+    ASSERT(received);
+    JSObjectSetProperty(receivingContext, JSContextGetGlobalObject(receivingContext), receivedName, received, kJSPropertyAttributeNone, NULL);
+    assertEqualsAsBoolean(JSEvaluateScript(receivingContext, checkSource, NULL, NULL, 1, NULL), true);
+    ASSERT(!JSMessageQueueReceive(receivingContext, messageQueue, false));
+    JSValueRef postException = NULL;
+    ASSERT(!JSMessageQueuePost(context, messageQueue, JSObjectMakeFunction(context, NULL, 0, NULL, receivedName, NULL, 1, NULL), &postException));
+    ASSERT(postException);
+    JSStringRelease(checkSource);
+    JSStringRelease(receivedName);
+    JSStringRelease(messageSource);
+    JSGlobalContextRelease(receivingContext);
+    JSMessageQueueRelease(messageQueue);
+
+    JSStringRef spinSource = JSStringCreateWithUTF8CString("while (true) { }");
+    JSValueRef spinException = NULL;
+    JSContextGroupSetExecutionTimeLimit(JSContextGetGroup(context), 50);
+    JSEvaluateScript(context, spinSource, NULL, NULL, 1, &spinException);
+    JSContextGroupSetExecutionTimeLimit(JSContextGetGroup(context), 0);
+    if (!spinException) {
+        printf("FAIL: An infinite loop was not terminated by the execution time limit.\n");
+        failed = 1;
+    } else
+        printf("PASS: An infinite loop was terminated by the execution time limit.\n");
+    JSStringRelease(spinSource);
+    JSStringRef afterSpinSource = JSStringCreateWithUTF8CString("1 + 1");
+    assertEqualsAsNumber(JSEvaluateScript(context, afterSpinSource, NULL, NULL, 1, NULL), 2);
+    JSStringRelease(afterSpinSource);
+
+    ASSERT(!JSStopSamplingProfiler(context, NULL, NULL));
+    JSStringRef samplingTitle = JSStringCreateWithUTF8CString("sampling");
+    JSStringRef samplingSource = JSStringCreateWithUTF8CString("for (var i = 0; i < 100000; ++i) { }");
+    unsigned sampledOpcodeCount = 0;
+    JSStartSamplingProfiler(context, samplingTitle, 1);
+    JSEvaluateScript(context, samplingSource, NULL, NULL, 1, NULL);
+    JSReportSamplingProfilerOpcodes(context, countSampledOpcode, &sampledOpcodeCount);
+    JSStopSamplingProfiler(context, NULL, NULL);
+    ASSERT(!JSReportSamplingProfilerOpcodes(context, countSampledOpcode, &sampledOpcodeCount));
+    ASSERT(!JSStopSamplingProfiler(context, NULL, NULL));
+    JSStringRelease(samplingSource);
+    JSStringRelease(samplingTitle);
+
+    JSStringRef polymorphicSource = JSStringCreateWithUTF8CString("function getX(o) { return o.x; } for (var i = 0; i < 1000; ++i) { var o = { x: i }; o['y' + (i % 8)] = i; getX(o); }");
+    unsigned inlineCacheSiteCount = 0;
+    JSEvaluateScript(context, polymorphicSource, NULL, NULL, 1, NULL);
+    JSReportInlineCacheStatistics(context, countInlineCacheSite, &inlineCacheSiteCount);
+    JSStringRelease(polymorphicSource);
+
+    ASSERT(!JSStopAllocationProfiler(context, NULL, NULL));
+    JSStringRef allocatingSource = JSStringCreateWithUTF8CString("function makePoint(i) { return { x: i, y: [i] }; } for (var i = 0; i < 10000; ++i) makePoint(i);");
+    size_t sampledAllocationCount = 0;
+    JSStartAllocationProfiler(context, 16);
+    JSEvaluateScript(context, allocatingSource, NULL, NULL, 1, NULL);
+    JSGarbageCollect(context);
+    size_t allocationSampleCount = JSStopAllocationProfiler(context, countAllocationSite, &sampledAllocationCount);
+    ASSERT(allocationSampleCount == sampledAllocationCount);
+    ASSERT(!JSStopAllocationProfiler(context, NULL, NULL));
+    JSStringRelease(allocatingSource);
+
+    static const JSChar externalCharacters[] = { 'a', 'b', 'c' };
+    int externalReleaseCount = 0;
+    JSStringRef externalString = JSStringCreateWithCharactersNoCopy(externalCharacters, 3, countExternalRelease, &externalReleaseCount);
+    ASSERT(JSStringGetCharactersPtr(externalString) == externalCharacters);
+    ASSERT(JSStringIsEqualToUTF8CString(externalString, "abc"));
+    ASSERT(!externalReleaseCount);
+    JSStringRelease(externalString);
+    ASSERT(externalReleaseCount == 1);
+
+    static float externalFloats[4];
+    int bytesDeallocationCount = 0;
+    JSObjectRef externalFloatArray = JSObjectMakeTypedArrayWithBytesNoCopy(context, kJSTypedArrayTypeFloat32Array, externalFloats, sizeof(externalFloats), countBytesDeallocation, &bytesDeallocationCount, NULL);
+    ASSERT(JSValueGetTypedArrayType(context, externalFloatArray) == kJSTypedArrayTypeFloat32Array);
+    ASSERT(JSObjectGetTypedArrayBytesPtr(context, externalFloatArray) == externalFloats);
+    ASSERT(JSObjectGetTypedArrayLength(context, externalFloatArray) == 4);
+    ASSERT(JSObjectGetTypedArrayByteLength(context, externalFloatArray) == sizeof(externalFloats));
+    JSObjectSetPropertyAtIndex(context, externalFloatArray, 2, JSValueMakeNumber(context, 1.5), NULL);
+    ASSERT(externalFloats[2] == 1.5f);
+    JSValueRef bytesException = NULL;
+    ASSERT(!JSObjectMakeTypedArrayWithBytesNoCopy(context, kJSTypedArrayTypeFloat64Array, externalFloats, 3, countBytesDeallocation, &bytesDeallocationCount, &bytesException));
+    ASSERT(bytesException);
+    ASSERT(JSValueGetTypedArrayType(context, JSValueMakeNumber(context, 1)) == kJSTypedArrayTypeNone);
+    ASSERT(!bytesDeallocationCount);
+
     JSStringRef validJSON = JSStringCreateWithUTF8CString("{\"aProperty\":true}");
     JSValueRef jsonObject = JSValueMakeFromJSONString(context, validJSON);
     JSStringRelease(validJSON);
@@ -1179,6 +1403,21 @@ int main(int argc, char* argv[])
         failed = 1;
     } else
         printf("PASS: set exception on serialisation error\n");
+
+    JSONChunkAccumulator accumulator = { { 0 }, 0, 0, false };
+    if (!JSValueWriteJSONString(context, jsonObject, 0, accumulateJSONChunk, &accumulator, 0) || strcmp(accumulator.buffer, "{\"aProperty\":true}")) {
+        printf("FAIL: Did not correctly write JSON to a chunk callback.\n");
+        failed = 1;
+    } else
+        printf("PASS: Correctly wrote JSON to a chunk callback.\n");
+
+    accumulator.stop = true;
+    accumulator.chunks = 0;
+    if (JSValueWriteJSONString(context, jsonObject, 0, accumulateJSONChunk, &accumulator, 0) || accumulator.chunks != 1) {
+        printf("FAIL: Did not stop writing JSON when the chunk callback returned false.\n");
+        failed = 1;
+    } else
+        printf("PASS: Stopped writing JSON when the chunk callback returned false.\n");
     // Conversions that throw exceptions
     exception = NULL;
     ASSERT(NULL == JSValueToObject(context, jsNull, &exception));
@@ -1382,6 +1621,41 @@ int main(int argc, char* argv[])
     ASSERT(!JSObjectSetPrivate(printFunction, (void*)1));
     ASSERT(!JSObjectGetPrivate(printFunction));
 
+    JSStringRef addNumbers = JSStringCreateWithUTF8CString("addNumbers");
+    JSObjectRef addNumbersFunction = JSObjectMakeFunctionWithCallbackAndAttributes(context, addNumbers, addNumbers_callAsFunction, kJSFunctionAttributeDoesNotReenter);
+    JSObjectSetProperty(context, globalObject, addNumbers, addNumbersFunction, kJSPropertyAttributeNone, NULL);
+    JSStringRelease(addNumbers);
+    JSStringRef addNumbersScript = JSStringCreateWithUTF8CString("var total = 0; for (var i = 0; i < 100; ++i) total += addNumbers(i, 0.5, -i); total + addNumbers()");
+    assertEqualsAsNumber(JSEvaluateScript(context, addNumbersScript, NULL, NULL, 1, NULL), 50);
+    JSStringRelease(addNumbersScript);
+    addNumbersScript = JSStringCreateWithUTF8CString("var thrown; try { addNumbers(1, 'two'); } catch (e) { thrown = e; } thrown");
+    assertEqualsAsNumber(JSEvaluateScript(context, addNumbersScript, NULL, NULL, 1, NULL), 1);
+    JSStringRelease(addNumbersScript);
+
+    // Arithmetic, comparisons and branches on values that are constant within a block, run hot enough
+    // for the optimizing JIT to fold them; NaN, negative zero and the sign of % must survive the folding.
+    JSStringRef foldingScript = JSStringCreateWithUTF8CString(
+        "function folded() {"
+        "    var seven = 7, minusThree = -3, zero = 0;"
+        "    var result = (seven % minusThree) * 100 + (seven - minusThree) * 10 + seven * zero;"
+        "    if (seven < minusThree) result = -1;"
+        "    if (!(zero / zero == zero / zero)) result += 1;"
+        "    if (1 / (zero * minusThree) < 0) result += 2;"
+        "    return result;"
+        "}"
+        "var total = 0; for (var i = 0; i < 10000; ++i) total += folded(); total / 10000");
+    assertEqualsAsNumber(JSEvaluateScript(context, foldingScript, NULL, NULL, 1, NULL), 203);
+    JSStringRelease(foldingScript);
+
+    // With only a step limit set, a pattern that backtracks catastrophically still runs out of budget
+    // rather than running unbounded in JIT code.
+    unsigned defaultRegExpMatchLimit = JSGetRegExpMatchLimit();
+    JSSetRegExpMatchLimit(10000);
+    JSStringRef backtrackingScript = JSStringCreateWithUTF8CString("var tooComplex = false; try { /(x+x+)+y/.test('xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx'); } catch (e) { tooComplex = true; } tooComplex");
+    assertEqualsAsBoolean(JSEvaluateScript(context, backtrackingScript, NULL, NULL, 1, NULL), true);
+    JSStringRelease(backtrackingScript);
+    JSSetRegExpMatchLimit(defaultRegExpMatchLimit);
+
     JSStringRef myConstructorIString = JSStringCreateWithUTF8CString("MyConstructor");
     JSObjectRef myConstructor = JSObjectMakeConstructor(context, NULL, myConstructor_callAsConstructor);
     JSObjectSetProperty(context, globalObject, myConstructorIString, myConstructor, kJSPropertyAttributeNone, NULL);
@@ -1553,6 +1827,27 @@ int main(int argc, char* argv[])
 
     printf("PASS: Infinite prototype chain does not occur.\n");
 
+    JSContextGroupRef confinedGroup = JSContextGroupCreateThreadConfined();
+    JSGlobalContextRef confinedContext = JSGlobalContextCreateInGroup(confinedGroup, NULL);
+    JSStringRef confinedFunctionName = JSStringCreateWithUTF8CString("baseCall");
+    JSObjectRef confinedFunction = JSObjectMakeFunctionWithCallback(confinedContext, confinedFunctionName, Base_callAsFunction);
+    JSObjectSetProperty(confinedContext, JSContextGetGlobalObject(confinedContext), confinedFunctionName, confinedFunction, kJSPropertyAttributeNone, NULL);
+    JSStringRef confinedScript = JSStringCreateWithUTF8CString("var sum = 0; for (var i = 0; i < 100; ++i) sum += baseCall(); sum");
+    assertEqualsAsNumber(JSEvaluateScript(confinedContext, confinedScript, NULL, NULL, 1, NULL), 100);
+    JSStringRelease(confinedScript);
+    JSStringRelease(confinedFunctionName);
+
+    JSContextGroupRef sharingGroup = JSContextGroupCreateThreadConfinedSharingBuiltins(confinedGroup);
+    ASSERT(sharingGroup);
+    JSGlobalContextRef sharingContext = JSGlobalContextCreateInGroup(sharingGroup, NULL);
+    JSGlobalContextRelease(confinedContext);
+    JSContextGroupRelease(confinedGroup);
+    JSStringRef sharingScript = JSStringCreateWithUTF8CString("Math.max.length + [3, 1, 2].sort().join('').length + 'abc'.toUpperCase().charCodeAt(0)");
+    assertEqualsAsNumber(JSEvaluateScript(sharingContext, sharingScript, NULL, NULL, 1, NULL), 70);
+    JSStringRelease(sharingScript);
+    JSGlobalContextRelease(sharingContext);
+    JSContextGroupRelease(sharingGroup);
+
     if (checkForCycleInPrototypeChain())
         printf("PASS: A cycle in a prototype chain can't be created.\n");
     else {
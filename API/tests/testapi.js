@@ -211,6 +211,13 @@ shouldBe("derived2.baseOnly = 0", 1);
 shouldBe("derived2.derivedOnly = 0", 2)
 shouldBe("derived2.protoDup = 0", 2);
 
+// Objects of one class share a Structure, so these accesses get cached; results must not change.
+function readStatics(o) { return o.baseDup + o.baseOnly * 10 + o.protoOnly() * 100; }
+var staticsSum = 0;
+for (var i = 0; i < 100; ++i)
+    staticsSum += readStatics(i & 1 ? derived : derived2) + readStatics(new Derived());
+shouldBe("staticsSum", 200 * 212);
+
 shouldBe('Object.getOwnPropertyDescriptor(derived, "baseProto")', undefined);
 shouldBe('Object.getOwnPropertyDescriptor(derived, "baseProtoDup")', undefined);
 var baseDupDescriptor = Object.getOwnPropertyDescriptor(derived, "baseDup");
@@ -55,7 +55,9 @@ SOURCES += \
     API/JSCallbackObject.cpp \
     API/JSClassRef.cpp \
     API/JSContextRef.cpp \
+    API/JSMessageQueueRef.cpp \
     API/JSObjectRef.cpp \
+    API/JSScriptRef.cpp \
     API/JSStringRef.cpp \
     API/JSValueRef.cpp \
     API/OpaqueJSString.cpp \
@@ -76,6 +78,8 @@ SOURCES += \
     heap/HandleHeap.cpp \
     heap/HandleStack.cpp \
     heap/Heap.cpp \
+    heap/HeapSnapshot.cpp \
+    heap/LargeObjectSpace.cpp \
     heap/MachineStackMarker.cpp \
     heap/MarkStack.cpp \
     heap/MarkedBlock.cpp \
@@ -86,11 +90,14 @@ SOURCES += \
     debugger/DebuggerCallFrame.cpp \
     debugger/Debugger.cpp \
     dfg/DFGByteCodeParser.cpp \
+    dfg/DFGCSE.cpp \
+    dfg/DFGConstantFolding.cpp \
     dfg/DFGGraph.cpp \
     dfg/DFGJITCodeGenerator.cpp \
     dfg/DFGJITCompiler.cpp \
     dfg/DFGNonSpeculativeJIT.cpp \
     dfg/DFGOperations.cpp \
+    dfg/DFGRangeAnalysis.cpp \
     dfg/DFGSpeculativeJIT.cpp \
     interpreter/CallFrame.cpp \
     interpreter/Interpreter.cpp \
@@ -100,6 +107,8 @@ SOURCES += \
     jit/JITArithmetic.cpp \
     jit/JITArithmetic32_64.cpp \
     jit/JITCall.cpp \
+    jit/JITCodeLog.cpp \
+    jit/JITDiagnostics.cpp \
     jit/JITCall32_64.cpp \
     jit/JIT.cpp \
     jit/JITOpcodes.cpp \
@@ -108,16 +117,20 @@ SOURCES += \
     jit/JITPropertyAccess32_64.cpp \
     jit/JITStubs.cpp \
     jit/ThunkGenerators.cpp \
+    parser/CompressedSourceProvider.cpp \
     parser/JSParser.cpp \
     parser/Lexer.cpp \
     parser/Nodes.cpp \
     parser/ParserArena.cpp \
     parser/Parser.cpp \
+    parser/ScriptSourceCache.cpp \
     parser/SourceProviderCache.cpp \
+    profiler/AllocationProfiler.cpp \
     profiler/Profile.cpp \
     profiler/ProfileGenerator.cpp \
     profiler/ProfileNode.cpp \
     profiler/Profiler.cpp \
+    profiler/SamplingProfiler.cpp \
     runtime/ArgList.cpp \
     runtime/Arguments.cpp \
     runtime/ArrayConstructor.cpp \
@@ -162,6 +175,7 @@ SOURCES += \
     runtime/JSPropertyNameIterator.cpp \
     runtime/JSStaticScopeObject.cpp \
     runtime/JSString.cpp \
+    runtime/JSTypedArray.cpp \
     runtime/JSValue.cpp \
     runtime/JSVariableObject.cpp \
     runtime/JSWrapperObject.cpp \
@@ -197,6 +211,7 @@ SOURCES += \
     runtime/Structure.cpp \
     runtime/TimeoutChecker.cpp \
     runtime/UString.cpp \
+    runtime/Watchdog.cpp \
     yarr/YarrJIT.cpp \
 
 *sh4* {
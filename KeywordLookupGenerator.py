@@ -191,60 +191,8 @@ for k, v in keywords:
 trie.coalesce()
 trie.fillOut()
 print("// This file was generated by KeywordLookupGenerator.py.  Do not edit.")
-print("""
-#if CPU(NEEDS_ALIGNED_ACCESS)
-
-#define COMPARE_CHARACTERS2(address, char1, char2) \\
-    (((address)[0] == char1) && ((address)[1] == char2))
-#define COMPARE_CHARACTERS4(address, char1, char2, char3, char4) \\
-    (COMPARE_CHARACTERS2(address, char1, char2) && COMPARE_CHARACTERS2((address) + 2, char3, char4))
-
-#else // CPU(NEEDS_ALIGNED_ACCESS)
-
-#if CPU(BIG_ENDIAN)
-
-#define CHARPAIR_TOUINT32(a, b) \\
-    ((((uint32_t)(a)) << 16) + (uint32_t)(b))
-#define CHARQUAD_TOUINT64(a, b, c, d) \\
-    ((((uint64_t)(CHARPAIR_TOUINT32(a, b))) << 32) + CHARPAIR_TOUINT32(c, d))
-
-#else // CPU(BIG_ENDIAN)
-
-#define CHARPAIR_TOUINT32(a, b) \\
-    ((((uint32_t)(b)) << 16) + (uint32_t)(a))
-#define CHARQUAD_TOUINT64(a, b, c, d) \\
-    ((((uint64_t)(CHARPAIR_TOUINT32(c, d))) << 32) + CHARPAIR_TOUINT32(a, b))
-
-#endif // CPU(BIG_ENDIAN)
-
-
-#define COMPARE_CHARACTERS2(address, char1, char2) \\
-    (((uint32_t*)(address))[0] == CHARPAIR_TOUINT32(char1, char2))
-
-#if CPU(X86_64)
-
-#define COMPARE_CHARACTERS4(address, char1, char2, char3, char4) \\
-    (((uint64_t*)(address))[0] == CHARQUAD_TOUINT64(char1, char2, char3, char4))
-
-#else // CPU(X86_64)
-
-#define COMPARE_CHARACTERS4(address, char1, char2, char3, char4) \\
-    (COMPARE_CHARACTERS2(address, char1, char2) && COMPARE_CHARACTERS2((address) + 2, char3, char4))
-
-#endif // CPU(X86_64)
-
-#endif // CPU(NEEDS_ALIGNED_ACCESS)
-
-#define COMPARE_CHARACTERS3(address, char1, char2, char3) \\
-    (COMPARE_CHARACTERS2(address, char1, char2) && ((address)[2] == (char3)))
-#define COMPARE_CHARACTERS5(address, char1, char2, char3, char4, char5) \\
-    (COMPARE_CHARACTERS4(address, char1, char2, char3, char4) && ((address)[4] == (char5)))
-#define COMPARE_CHARACTERS6(address, char1, char2, char3, char4, char5, char6) \\
-    (COMPARE_CHARACTERS4(address, char1, char2, char3, char4) && COMPARE_CHARACTERS2(address + 4, char5, char6))
-#define COMPARE_CHARACTERS7(address, char1, char2, char3, char4, char5, char6, char7) \\
-    (COMPARE_CHARACTERS4(address, char1, char2, char3, char4) && COMPARE_CHARACTERS4(address + 3, char4, char5, char6, char7))
-#define COMPARE_CHARACTERS8(address, char1, char2, char3, char4, char5, char6, char7, char8) \\
-    (COMPARE_CHARACTERS4(address, char1, char2, char3, char4) && COMPARE_CHARACTERS4(address + 4, char5, char6, char7, char8))
-""")
+print("")
+print("#include \"CharacterComparisons.h\"")
+print("")
 
 trie.printAsC()
@@ -31,6 +31,7 @@
 #define DUMP_LINK_STATISTICS 0
 #define DUMP_CODE 0
 
+#include "JITCodeLog.h"
 #include <MacroAssembler.h>
 #include <wtf/Noncopyable.h>
 
@@ -166,11 +167,14 @@ public:
     // Upon completion of all patching either 'finalizeCode()' or 'finalizeCodeAddendum()' should be called
     // once to complete generation of the code.  'finalizeCode()' is suited to situations
     // where the executable pool must also be retained, the lighter-weight 'finalizeCodeAddendum()' is
-    // suited to adding to an existing allocation.
-    CodeRef finalizeCode()
+    // suited to adding to an existing allocation. The name is what JITCodeLog reports the code as.
+    CodeRef finalizeCode(const char* name = 0)
     {
         performFinalization();
 
+        if (JITCodeLog::isEnabled())
+            JITCodeLog::log(code(), m_size, name ? name : "JIT stub");
+
         return CodeRef(m_executableMemory);
     }
 
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef AllocationSiteProfile_h
+#define AllocationSiteProfile_h
+
+#include "Heap.h"
+
+namespace JSC {
+
+class CodeBlock;
+
+// Tracks how many of the objects allocated by one op_new_object, op_new_array,
+// op_new_array_buffer or op_new_func survive their first collection. Every
+// samplingInterval-th allocation is sampled, and the heap checks whether the
+// sampled cell was marked by the next collection. A site whose objects mostly
+// survive is pretenured: it allocates straight into old space, so that nursery
+// collections don't have to trace its objects before promoting them. This
+// only does anything with ENABLE(GGC).
+struct AllocationSiteProfile {
+    static const int samplingInterval = 32;
+    static const unsigned minimumSamplesToPretenure = 16;
+    static const unsigned pretenuringSurvivalPercentage = 90;
+    static const unsigned maximumSamples = 256; // Older samples are forgotten by halving the counts.
+
+    AllocationSiteProfile()
+        : countdown(samplingInterval)
+        , sampleCount(0)
+        , survivorCount(0)
+        , shouldPretenure(false)
+    {
+    }
+
+    void didSample(bool survived)
+    {
+        sampleCount++;
+        if (survived)
+            survivorCount++;
+        if (sampleCount >= minimumSamplesToPretenure && survivorCount * 100 >= sampleCount * pretenuringSurvivalPercentage)
+            shouldPretenure = true;
+        if (sampleCount == maximumSamples) {
+            sampleCount /= 2;
+            survivorCount /= 2;
+        }
+    }
+
+    // Decremented by every allocation. The JIT does this inline, and only
+    // calls out once it reaches zero.
+    int32_t countdown;
+    unsigned sampleCount;
+    unsigned survivorCount;
+    bool shouldPretenure;
+};
+
+// Wraps an allocation at a profiled site. If the site's countdown has run
+// out, this either samples the allocation or, for a pretenured site, makes
+// the next cell allocation go to old space. The site's own cell must be the
+// first one it allocates, which holds for every profiled opcode.
+class AllocationSiteScope {
+    WTF_MAKE_NONCOPYABLE(AllocationSiteScope);
+public:
+    enum CountdownMode { DecrementCountdown, CountdownWasDecremented };
+
+    AllocationSiteScope(Heap&, CodeBlock*, AllocationSiteProfile&, CountdownMode);
+    ~AllocationSiteScope();
+
+    template<typename T> T* didAllocate(T*);
+
+#if ENABLE(GGC)
+private:
+    Heap& m_heap;
+    CodeBlock* m_codeBlock;
+    AllocationSiteProfile& m_profile;
+    bool m_isSampling;
+#endif
+};
+
+#if ENABLE(GGC)
+inline AllocationSiteScope::AllocationSiteScope(Heap& heap, CodeBlock* codeBlock, AllocationSiteProfile& profile, CountdownMode countdownMode)
+    : m_heap(heap)
+    , m_codeBlock(codeBlock)
+    , m_profile(profile)
+    , m_isSampling(false)
+{
+    if (countdownMode == DecrementCountdown)
+        profile.countdown--;
+    if (profile.countdown > 0)
+        return;
+
+    // A pretenured site comes back here for every allocation, since the
+    // JIT's inline allocation always allocates in new space.
+    if (profile.shouldPretenure) {
+        profile.countdown = 1;
+        heap.pretenureNextAllocation();
+        return;
+    }
+    profile.countdown = AllocationSiteProfile::samplingInterval;
+    m_isSampling = true;
+}
+
+inline AllocationSiteScope::~AllocationSiteScope()
+{
+    // In case the site didn't get as far as allocating.
+    m_heap.cancelPretenuring();
+}
+
+template<typename T> inline T* AllocationSiteScope::didAllocate(T* cell)
+{
+    if (m_isSampling)
+        m_heap.sampleAllocation(cell, m_codeBlock, &m_profile);
+    return cell;
+}
+#else
+inline AllocationSiteScope::AllocationSiteScope(Heap&, CodeBlock*, AllocationSiteProfile&, CountdownMode)
+{
+}
+
+inline AllocationSiteScope::~AllocationSiteScope()
+{
+}
+
+template<typename T> inline T* AllocationSiteScope::didAllocate(T* cell)
+{
+    return cell;
+}
+#endif
+
+} // namespace JSC
+
+#endif // AllocationSiteProfile_h
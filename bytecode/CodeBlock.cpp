@@ -35,6 +35,7 @@
 #include "Debugger.h"
 #include "Interpreter.h"
 #include "JIT.h"
+#include "JITDiagnostics.h"
 #include "JSActivation.h"
 #include "JSFunction.h"
 #include "JSStaticScopeObject.h"
@@ -260,6 +261,9 @@ static void printStructureStubInfo(const StructureStubInfo& stubInfo, unsigned i
     case access_put_by_id_replace:
         printf("  [%4d] %s: %s\n", instructionOffset, "put_by_id_replace", pointerToSourceString(stubInfo.u.putByIdReplace.baseObjectStructure).utf8().data());
         return;
+    case access_put_by_id_setter:
+        printf("  [%4d] %s: %s, %s (%u)\n", instructionOffset, "put_by_id_setter", pointerToSourceString(stubInfo.u.putByIdSetter.baseObjectStructure).utf8().data(), pointerToSourceString(stubInfo.u.putByIdSetter.chain).utf8().data(), stubInfo.u.putByIdSetter.count);
+        return;
     case access_unset:
         printf("  [%4d] %s\n", instructionOffset, "unset");
         return;
@@ -523,21 +527,24 @@ void CodeBlock::dump(ExecState* exec, const Vector<Instruction>::const_iterator&
         }
         case op_new_object: {
             int r0 = (++it)->u.operand;
-            printf("[%4d] new_object\t %s\n", location, registerName(exec, r0).data());
+            int profileIndex = (++it)->u.operand;
+            printf("[%4d] new_object\t %s, alloc%d\n", location, registerName(exec, r0).data(), profileIndex);
             break;
         }
         case op_new_array: {
             int dst = (++it)->u.operand;
             int argv = (++it)->u.operand;
             int argc = (++it)->u.operand;
-            printf("[%4d] new_array\t %s, %s, %d\n", location, registerName(exec, dst).data(), registerName(exec, argv).data(), argc);
+            int profileIndex = (++it)->u.operand;
+            printf("[%4d] new_array\t %s, %s, %d, alloc%d\n", location, registerName(exec, dst).data(), registerName(exec, argv).data(), argc, profileIndex);
             break;
         }
         case op_new_array_buffer: {
             int dst = (++it)->u.operand;
             int argv = (++it)->u.operand;
             int argc = (++it)->u.operand;
-            printf("[%4d] new_array_buffer %s, %d, %d\n", location, registerName(exec, dst).data(), argv, argc);
+            int profileIndex = (++it)->u.operand;
+            printf("[%4d] new_array_buffer %s, %d, %d, alloc%d\n", location, registerName(exec, dst).data(), argv, argc, profileIndex);
             break;
         }
         case op_new_regexp: {
@@ -724,6 +731,7 @@ void CodeBlock::dump(ExecState* exec, const Vector<Instruction>::const_iterator&
         }
         case op_in: {
             printBinaryOp(exec, location, it, "in");
+            ++it;
             break;
         }
         case op_resolve: {
@@ -1105,7 +1113,8 @@ void CodeBlock::dump(ExecState* exec, const Vector<Instruction>::const_iterator&
             int r0 = (++it)->u.operand;
             int f0 = (++it)->u.operand;
             int shouldCheck = (++it)->u.operand;
-            printf("[%4d] new_func\t\t %s, f%d, %s\n", location, registerName(exec, r0).data(), f0, shouldCheck ? "<Checked>" : "<Unchecked>");
+            int profileIndex = (++it)->u.operand;
+            printf("[%4d] new_func\t\t %s, f%d, %s, alloc%d\n", location, registerName(exec, r0).data(), f0, shouldCheck ? "<Checked>" : "<Unchecked>", profileIndex);
             break;
         }
         case op_new_func_exp: {
@@ -1406,6 +1415,33 @@ void CodeBlock::dumpStatistics()
 #endif
 }
 
+size_t CodeBlock::sideTableBytes() const
+{
+    size_t size = sizeInBytes(m_inInstructions) + sizeInBytes(m_jumpTargets) + sizeInBytes(m_loopTargets)
+        + sizeInBytes(m_identifiers) + sizeInBytes(m_constantRegisters) + sizeInBytes(m_functionDecls) + sizeInBytes(m_functionExprs)
+        + m_allocationSiteProfiles.size() * sizeof(AllocationSiteProfile);
+#if ENABLE(INTERPRETER)
+    size += sizeInBytes(m_propertyAccessInstructions) + sizeInBytes(m_globalResolveInstructions);
+#endif
+#if ENABLE(JIT)
+    size += sizeInBytes(m_structureStubInfos) + sizeInBytes(m_globalResolveInfos) + sizeInBytes(m_byValStringCacheInfos) + sizeInBytes(m_callLinkInfos) + sizeInBytes(m_methodCallLinkInfos);
+#endif
+#if ENABLE(VALUE_PROFILER)
+    size += m_valueProfiles.size() * sizeof(ValueProfile);
+#endif
+    if (m_rareData) {
+        size += sizeof(RareData) + sizeInBytes(m_rareData->m_exceptionHandlers) + sizeInBytes(m_rareData->m_regexps)
+            + sizeInBytes(m_rareData->m_immediateSwitchJumpTables) + sizeInBytes(m_rareData->m_characterSwitchJumpTables) + sizeInBytes(m_rareData->m_stringSwitchJumpTables)
+            + m_rareData->m_expressionInfo.sizeInMemory() + m_rareData->m_lineInfo.sizeInMemory();
+        for (size_t i = 0; i < m_rareData->m_constantBuffers.size(); ++i)
+            size += sizeInBytes(m_rareData->m_constantBuffers[i]);
+#if ENABLE(JIT)
+        size += sizeInBytes(m_rareData->m_callReturnIndexVector);
+#endif
+    }
+    return size;
+}
+
 CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlobalObject *globalObject, PassRefPtr<SourceProvider> sourceProvider, unsigned sourceOffset, SymbolTable* symTab, bool isConstructor, PassOwnPtr<CodeBlock> alternative)
     : m_globalObject(globalObject->globalData(), ownerExecutable, globalObject)
     , m_heap(&m_globalObject->globalData().heap)
@@ -1418,17 +1454,23 @@ CodeBlock::CodeBlock(ScriptExecutable* ownerExecutable, CodeType codeType, JSGlo
 #ifndef NDEBUG
     , m_instructionCount(0)
 #endif
+    , m_bytecodeGenerationTime(0)
+    , m_machineCodeGenerationTime(0)
+    , m_bytecodeSize(0)
     , m_argumentsRegister(-1)
     , m_needsFullScopeChain(ownerExecutable->needsActivation())
     , m_usesEval(ownerExecutable->usesEval())
     , m_isNumericCompareFunction(false)
     , m_isStrictMode(ownerExecutable->isStrictMode())
+    , m_hasDebugHooks(false)
     , m_codeType(codeType)
     , m_source(sourceProvider)
     , m_sourceOffset(sourceOffset)
     , m_symbolTable(symTab)
     , m_alternative(alternative)
     , m_optimizationDelayCounter(0)
+    , m_reoptimizationRetryCounter(0)
+    , m_speculativeFailCounter(0)
 {
     ASSERT(m_source);
     
@@ -1444,6 +1486,11 @@ CodeBlock::~CodeBlock()
 #if ENABLE(VERBOSE_VALUE_PROFILE)
     dumpValueProfiles();
 #endif
+
+#if ENABLE(GGC)
+    if (m_globalData)
+        m_globalData->heap.forgetAllocationSamples(this);
+#endif
     
 #if ENABLE(JIT)
     // We may be destroyed before any CodeBlocks that refer to us are destroyed.
@@ -1528,6 +1575,10 @@ void CodeBlock::visitAggregate(SlotVisitor& visitor)
     
     if (!!m_alternative)
         m_alternative->visitAggregate(visitor);
+#if ENABLE(JIT)
+    for (size_t i = 0; i < m_jettisonedReplacements.size(); ++i)
+        m_jettisonedReplacements[i]->visitAggregate(visitor);
+#endif
     visitor.append(&m_globalObject);
     visitor.append(&m_ownerExecutable);
     if (m_rareData) {
@@ -1547,6 +1598,10 @@ void CodeBlock::visitAggregate(SlotVisitor& visitor)
         if (callLinkInfo(i).isLinked())
             visitor.append(&callLinkInfo(i).callee);
 #endif
+    for (size_t size = m_inInstructions.size(), i = 0; i < size; ++i) {
+        if (m_instructions[m_inInstructions[i]].u.structure)
+            visitor.append(&m_instructions[m_inInstructions[i]].u.structure);
+    }
 #if ENABLE(INTERPRETER)
     for (size_t size = m_propertyAccessInstructions.size(), i = 0; i < size; ++i)
         visitStructures(visitor, &m_instructions[m_propertyAccessInstructions[i]]);
@@ -1559,6 +1614,11 @@ void CodeBlock::visitAggregate(SlotVisitor& visitor)
             visitor.append(&m_globalResolveInfos[i].structure);
     }
 
+    for (size_t size = m_byValStringCacheInfos.size(), i = 0; i < size; ++i) {
+        if (m_byValStringCacheInfos[i].structure)
+            visitor.append(&m_byValStringCacheInfos[i].structure);
+    }
+
     for (size_t size = m_structureStubInfos.size(), i = 0; i < size; ++i)
         m_structureStubInfos[i].visitAggregate(visitor);
 
@@ -1660,21 +1720,10 @@ int CodeBlock::lineNumberForBytecodeOffset(unsigned bytecodeOffset)
     if (!m_rareData)
         return m_ownerExecutable->source().firstLine();
 
-    Vector<LineInfo>& lineInfo = m_rareData->m_lineInfo;
-
-    int low = 0;
-    int high = lineInfo.size();
-    while (low < high) {
-        int mid = low + (high - low) / 2;
-        if (lineInfo[mid].instructionOffset <= bytecodeOffset)
-            low = mid + 1;
-        else
-            high = mid;
-    }
-
-    if (!low)
+    LineInfo lineInfo;
+    if (!m_rareData->m_lineInfo.find(bytecodeOffset, lineInfo))
         return m_ownerExecutable->source().firstLine();
-    return lineInfo[low - 1].lineNumber;
+    return lineInfo.lineNumber;
 }
 
 void CodeBlock::expressionRangeForBytecodeOffset(unsigned bytecodeOffset, int& divot, int& startOffset, int& endOffset)
@@ -1688,29 +1737,19 @@ void CodeBlock::expressionRangeForBytecodeOffset(unsigned bytecodeOffset, int& d
         return;
     }
 
-    Vector<ExpressionRangeInfo>& expressionInfo = m_rareData->m_expressionInfo;
-
-    int low = 0;
-    int high = expressionInfo.size();
-    while (low < high) {
-        int mid = low + (high - low) / 2;
-        if (expressionInfo[mid].instructionOffset <= bytecodeOffset)
-            low = mid + 1;
-        else
-            high = mid;
-    }
-
-    ASSERT(low);
-    if (!low) {
+    ExpressionRangeInfo expressionInfo;
+    bool found = m_rareData->m_expressionInfo.find(bytecodeOffset, expressionInfo);
+    ASSERT(found);
+    if (!found) {
         startOffset = 0;
         endOffset = 0;
         divot = 0;
         return;
     }
 
-    startOffset = expressionInfo[low - 1].startOffset;
-    endOffset = expressionInfo[low - 1].endOffset;
-    divot = expressionInfo[low - 1].divotPoint + m_sourceOffset;
+    startOffset = expressionInfo.startOffset;
+    endOffset = expressionInfo.endOffset;
+    divot = expressionInfo.divotPoint + m_sourceOffset;
     return;
 }
 
@@ -1760,6 +1799,8 @@ bool CodeBlock::hasGlobalResolveInfoAtBytecodeOffset(unsigned bytecodeOffset)
 void CodeBlock::shrinkToFit()
 {
     m_instructions.shrinkToFit();
+    m_inInstructions.shrinkToFit();
+    m_varsToInitialize.shrinkToFit();
 
 #if ENABLE(INTERPRETER)
     m_propertyAccessInstructions.shrinkToFit();
@@ -1768,6 +1809,7 @@ void CodeBlock::shrinkToFit()
 #if ENABLE(JIT)
     m_structureStubInfos.shrinkToFit();
     m_globalResolveInfos.shrinkToFit();
+    m_byValStringCacheInfos.shrinkToFit();
     m_callLinkInfos.shrinkToFit();
 #endif
 
@@ -1818,6 +1860,91 @@ void CallLinkInfo::unlink(JSGlobalData& globalData, RepatchBuffer& repatchBuffer
         remove();
 }
 
+// Like bytecodeOffset(ReturnAddressPtr), but returns -1 for a location that has no entry
+// instead of asserting, since call sites made by the DFG are not all in the table.
+int CodeBlock::lineNumberForCallReturnLocation(void* returnLocation)
+{
+    if (!m_rareData || !m_jitCode)
+        return -1;
+    intptr_t offset = reinterpret_cast<intptr_t>(returnLocation) - reinterpret_cast<intptr_t>(m_jitCode.addressForCall().executableAddress());
+    if (offset < 0 || static_cast<size_t>(offset) >= m_jitCode.size())
+        return -1;
+    Vector<CallReturnOffsetToBytecodeOffset>& callIndices = m_rareData->m_callReturnIndexVector;
+    unsigned callReturnOffset = static_cast<unsigned>(offset);
+    size_t low = 0;
+    size_t high = callIndices.size();
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (callIndices[middle].callReturnOffset < callReturnOffset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == callIndices.size() || callIndices[low].callReturnOffset != callReturnOffset)
+        return -1;
+    return lineNumberForBytecodeOffset(callIndices[low].bytecodeOffset);
+}
+
+void CodeBlock::inlineCacheStatistics(Vector<InlineCacheSiteStatistics>& sites)
+{
+    for (size_t i = 0; i < m_structureStubInfos.size(); ++i) {
+        StructureStubInfo& stubInfo = m_structureStubInfos[i];
+        InlineCacheSiteStatistics site;
+        site.kind = InlineCacheSiteStatistics::PropertyAccess;
+        site.lineNumber = lineNumberForCallReturnLocation(stubInfo.callReturnLocation.executableAddress());
+        site.repatchCount = stubInfo.repatchCount;
+        site.structureCount = stubInfo.structureCount();
+        site.isGeneric = stubInfo.isGeneric;
+        sites.append(site);
+    }
+
+    for (size_t i = 0; i < m_methodCallLinkInfos.size(); ++i) {
+        MethodCallLinkInfo& methodInfo = m_methodCallLinkInfos[i];
+        // A method check caches once; if that fails it becomes a plain get_by_id.
+        bool isCached = methodInfo.cachedStructure;
+        InlineCacheSiteStatistics site;
+        site.kind = InlineCacheSiteStatistics::MethodCheck;
+        site.lineNumber = lineNumberForCallReturnLocation(methodInfo.callReturnLocation.executableAddress());
+        site.repatchCount = isCached;
+        site.structureCount = isCached;
+        site.isGeneric = methodInfo.seen && !isCached;
+        sites.append(site);
+    }
+
+    for (size_t i = 0; i < m_callLinkInfos.size(); ++i) {
+        CallLinkInfo& callLinkInfo = m_callLinkInfos[i];
+        InlineCacheSiteStatistics site;
+        site.kind = InlineCacheSiteStatistics::Call;
+        site.lineNumber = lineNumberForCallReturnLocation(callLinkInfo.callReturnLocation.executableAddress());
+        site.repatchCount = callLinkInfo.linkCount;
+        site.structureCount = callLinkInfo.isLinked();
+        site.isGeneric = callLinkInfo.isVirtual;
+        sites.append(site);
+    }
+
+    for (size_t i = 0; i < m_globalResolveInfos.size(); ++i) {
+        GlobalResolveInfo& globalResolveInfo = m_globalResolveInfos[i];
+        InlineCacheSiteStatistics site;
+        site.kind = InlineCacheSiteStatistics::GlobalResolve;
+        site.lineNumber = lineNumberForBytecodeOffset(globalResolveInfo.bytecodeOffset);
+        site.repatchCount = globalResolveInfo.repatchCount;
+        site.structureCount = !!globalResolveInfo.structure;
+        site.isGeneric = false;
+        sites.append(site);
+    }
+
+    for (size_t i = 0; i < m_byValStringCacheInfos.size(); ++i) {
+        ByValStringCacheInfo& cacheInfo = m_byValStringCacheInfos[i];
+        InlineCacheSiteStatistics site;
+        site.kind = InlineCacheSiteStatistics::StringKeyedAccess;
+        site.lineNumber = lineNumberForBytecodeOffset(cacheInfo.bytecodeOffset);
+        site.repatchCount = cacheInfo.repatchCount;
+        site.structureCount = !!cacheInfo.structure;
+        site.isGeneric = cacheInfo.isGeneric();
+        sites.append(site);
+    }
+}
+
 void CodeBlock::unlinkCalls()
 {
     if (!!m_alternative)
@@ -1931,10 +2058,56 @@ bool EvalCodeBlock::canCompileWithDFG()
 
 bool FunctionCodeBlock::canCompileWithDFG()
 {
-    if (m_isConstructor)
+    if (m_isConstructor) {
+        if (!DFG::mightCompileFunctionForConstruct(this)) {
+            if (JITDiagnostics::isEnabled())
+                JITDiagnostics::log(this, "not optimized: constructors are not supported");
+            return false;
+        }
         return DFG::canCompileFunctionForConstruct(this);
+    }
     return DFG::canCompileFunctionForCall(this);
 }
+
+PassOwnPtr<CodeBlock> ProgramCodeBlock::jettison()
+{
+    ASSERT(getJITType() != JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    return static_cast<ProgramExecutable*>(ownerExecutable())->jettisonOptimizedCode();
+}
+
+PassOwnPtr<CodeBlock> EvalCodeBlock::jettison()
+{
+    ASSERT(getJITType() != JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    return static_cast<EvalExecutable*>(ownerExecutable())->jettisonOptimizedCode();
+}
+
+PassOwnPtr<CodeBlock> FunctionCodeBlock::jettison()
+{
+    ASSERT(getJITType() != JITCode::BaselineJIT);
+    ASSERT(this == replacement());
+    return static_cast<FunctionExecutable*>(ownerExecutable())->jettisonOptimizedCodeFor(m_isConstructor ? CodeForConstruct : CodeForCall);
+}
+
+void CodeBlock::reoptimize()
+{
+    ASSERT(hasOptimizedReplacement());
+#if ENABLE(JIT_VERBOSE_OSR)
+    printf("Jettisoning %p, the replacement of %p, after %u speculation failures.\n", replacement(), this, replacement()->m_speculativeFailCounter);
+#endif
+    m_jettisonedReplacements.append(replacement()->jettison());
+    ASSERT(replacement() == this);
+    ++m_globalData->compilationStatistics.reoptimizationCount;
+    
+    if (++m_reoptimizationRetryCounter >= maximumReoptimizationRetries) {
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(this, "giving up on optimizing after %u reoptimizations", static_cast<unsigned>(m_reoptimizationRetryCounter));
+        dontOptimizeAnytimeSoon();
+        return;
+    }
+    optimizeAfterWarmUp();
+}
 #endif
 
 #if ENABLE(VALUE_PROFILER)
@@ -30,7 +30,9 @@
 #ifndef CodeBlock_h
 #define CodeBlock_h
 
+#include "AllocationSiteProfile.h"
 #include "CompactJITCodeMap.h"
+#include "DeltaEncodedTable.h"
 #include "EvalCodeCache.h"
 #include "Instruction.h"
 #include "JITCode.h"
@@ -93,11 +95,55 @@ namespace JSC {
         uint32_t divotPoint : 25;
         uint32_t startOffset : 7;
         uint32_t endOffset : 7;
+
+        // For DeltaEncodedTable.
+        static const unsigned numberOfFields = 4;
+        int32_t field(unsigned index) const
+        {
+            switch (index) {
+            case 0:
+                return instructionOffset;
+            case 1:
+                return divotPoint;
+            case 2:
+                return startOffset;
+            default:
+                return endOffset;
+            }
+        }
+        void setField(unsigned index, int32_t value)
+        {
+            switch (index) {
+            case 0:
+                instructionOffset = value;
+                break;
+            case 1:
+                divotPoint = value;
+                break;
+            case 2:
+                startOffset = value;
+                break;
+            default:
+                endOffset = value;
+                break;
+            }
+        }
     };
 
     struct LineInfo {
         uint32_t instructionOffset;
         int32_t lineNumber;
+
+        // For DeltaEncodedTable.
+        static const unsigned numberOfFields = 2;
+        int32_t field(unsigned index) const { return index ? lineNumber : static_cast<int32_t>(instructionOffset); }
+        void setField(unsigned index, int32_t value)
+        {
+            if (index)
+                lineNumber = value;
+            else
+                instructionOffset = value;
+        }
     };
 
 #if ENABLE(JIT)
@@ -106,6 +152,8 @@ namespace JSC {
             : hasSeenShouldRepatch(false)
             , isCall(false)
             , isDFG(false)
+            , isVirtual(false)
+            , linkCount(0)
         {
         }
         
@@ -122,6 +170,8 @@ namespace JSC {
         bool hasSeenShouldRepatch : 1;
         bool isCall : 1;
         bool isDFG : 1;
+        bool isVirtual : 1; // The last link attempt could not link the callee, so calls dispatch virtually.
+        unsigned linkCount; // For the inline cache statistics.
 
         bool isLinked() { return callee; }
         void unlink(JSGlobalData&, RepatchBuffer&);
@@ -167,12 +217,47 @@ namespace JSC {
         GlobalResolveInfo(unsigned bytecodeOffset)
             : offset(0)
             , bytecodeOffset(bytecodeOffset)
+            , repatchCount(0)
+        {
+        }
+
+        WriteBarrier<Structure> structure;
+        unsigned offset;
+        unsigned bytecodeOffset;
+        unsigned repatchCount; // Times the cached structure was (re)set, for the inline cache statistics.
+    };
+
+    // The own property a get_by_val or put_by_val site last reached with a string subscript. The
+    // baseline JIT checks the subscript's StringImpl and the base's Structure against it before
+    // hashing the key into the PropertyTable.
+    struct ByValStringCacheInfo {
+        ByValStringCacheInfo(unsigned bytecodeOffset)
+            : offset(0)
+            , bytecodeOffset(bytecodeOffset)
+            , repatchCount(0)
         {
         }
 
+        // A site that keeps meeting new keys or Structures is left to the generic lookup.
+        static const unsigned maximumRepatchCount = 8;
+        bool isGeneric() const { return repatchCount >= maximumRepatchCount; }
+
         WriteBarrier<Structure> structure;
+        RefPtr<StringImpl> key;
         unsigned offset;
         unsigned bytecodeOffset;
+        unsigned repatchCount;
+    };
+
+    // One inline cache of a CodeBlock, as reported by CodeBlock::inlineCacheStatistics().
+    struct InlineCacheSiteStatistics {
+        enum Kind { PropertyAccess, MethodCheck, Call, GlobalResolve, StringKeyedAccess };
+
+        Kind kind;
+        int lineNumber; // -1 if the site cannot be mapped back to its bytecode.
+        unsigned repatchCount;
+        unsigned structureCount; // The structures (or callees) the cache currently checks for.
+        bool isGeneric; // The site has given up on caching.
     };
 
     // This structure is used to map from a call return location
@@ -235,6 +320,15 @@ namespace JSC {
         void visitWeakReferences(SlotVisitor&);
 
         static void dumpStatistics();
+        // The memory held by everything but the instructions and the machine code, in bytes.
+        size_t sideTableBytes() const;
+
+#if ENABLE(JIT)
+        void inlineCacheStatistics(Vector<InlineCacheSiteStatistics>&);
+        // The line of the call that returns to returnLocation, or -1 if returnLocation is not
+        // a call return location in this code block's machine code.
+        int lineNumberForCallReturnLocation(void* returnLocation);
+#endif
 
 #if !defined(NDEBUG) || ENABLE_OPCODE_SAMPLING
         void dump(ExecState*) const;
@@ -332,6 +426,19 @@ namespace JSC {
         void setInstructionCount(unsigned instructionCount) { m_instructionCount = instructionCount; }
 #endif
 
+        // What producing this code block cost, kept after its bytecode is discarded. Times are
+        // in seconds; the machine code size is that of getJITCode().
+        double bytecodeGenerationTime() const { return m_bytecodeGenerationTime; }
+        double machineCodeGenerationTime() const { return m_machineCodeGenerationTime; }
+        size_t bytecodeSize() const { return m_bytecodeSize; }
+        unsigned reoptimizationCount() const { return m_reoptimizationRetryCounter; }
+        void didGenerateBytecode(double seconds)
+        {
+            m_bytecodeGenerationTime = seconds;
+            m_bytecodeSize = m_instructions.size() * sizeof(Instruction);
+        }
+        void didGenerateMachineCode(double seconds) { m_machineCodeGenerationTime = seconds; }
+
 #if ENABLE(JIT)
         void setJITCode(const JITCode& code, MacroAssemblerCodePtr codeWithArityCheck)
         {
@@ -339,6 +446,7 @@ namespace JSC {
             m_jitCodeWithArityCheck = codeWithArityCheck;
         }
         JITCode& getJITCode() { return m_jitCode; }
+        MacroAssemblerCodePtr getJITCodeWithArityCheck() { return m_jitCodeWithArityCheck; }
         JITCode::JITType getJITType() { return m_jitCode.jitType(); }
         ExecutableMemoryHandle* executableMemory() { return getJITCode().getExecutableMemory(); }
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*) = 0;
@@ -358,6 +466,13 @@ namespace JSC {
 #endif
             return result;
         }
+        // Removes this optimized CodeBlock from its executable, which goes back
+        // to running the baseline code. Frames may still be executing the
+        // optimized code, so ownership of it passes to the caller.
+        virtual PassOwnPtr<CodeBlock> jettison() = 0;
+        // Called on the baseline CodeBlock to throw away an optimized replacement
+        // that exits too often.
+        void reoptimize();
 #else
         JITCode::JITType getJITType() { return JITCode::BaselineJIT; }
 #endif
@@ -374,6 +489,8 @@ namespace JSC {
         bool needsFullScopeChain() const { return m_needsFullScopeChain; }
         void setUsesEval(bool usesEval) { m_usesEval = usesEval; }
         bool usesEval() const { return m_usesEval; }
+        void setHasDebugHooks(bool hasDebugHooks) { m_hasDebugHooks = hasDebugHooks; }
+        bool hasDebugHooks() const { return m_hasDebugHooks; }
         
         void setArgumentsRegister(int argumentsRegister)
         {
@@ -411,6 +528,12 @@ namespace JSC {
 
         void clearEvalCache();
 
+        void addInInstruction(unsigned inInstruction) { m_inInstructions.append(inInstruction); }
+
+        // The locals op_enter sets to undefined: all but those the entry code writes before it can read them.
+        const Vector<int>& varsToInitialize() const { return m_varsToInitialize; }
+        void setVarsToInitialize(Vector<int>& vars) { m_varsToInitialize.swap(vars); }
+
 #if ENABLE(INTERPRETER)
         void addPropertyAccessInstruction(unsigned propertyAccessInstruction)
         {
@@ -437,6 +560,13 @@ namespace JSC {
         GlobalResolveInfo& globalResolveInfo(int index) { return m_globalResolveInfos[index]; }
         bool hasGlobalResolveInfoAtBytecodeOffset(unsigned bytecodeOffset);
 
+        void addByValStringCacheInfo(unsigned byValInstruction)
+        {
+            if (m_globalData->canUseJIT())
+                m_byValStringCacheInfos.append(ByValStringCacheInfo(byValInstruction));
+        }
+        ByValStringCacheInfo& byValStringCacheInfo(int index) { return m_byValStringCacheInfos[index]; }
+
         void setNumberOfCallLinkInfos(size_t size) { m_callLinkInfos.grow(size); }
         size_t numberOfCallLinkInfos() const { return m_callLinkInfos.size(); }
         CallLinkInfo& callLinkInfo(int index) { return m_callLinkInfos[index]; }
@@ -469,6 +599,13 @@ namespace JSC {
         }
 #endif
 
+        unsigned addAllocationSiteProfile()
+        {
+            m_allocationSiteProfiles.append(AllocationSiteProfile());
+            return m_allocationSiteProfiles.size() - 1;
+        }
+        AllocationSiteProfile& allocationSiteProfile(int index) { return m_allocationSiteProfiles[index]; }
+
         unsigned globalResolveInfoCount() const
         {
 #if ENABLE(JIT)    
@@ -493,7 +630,7 @@ namespace JSC {
         void addLineInfo(unsigned bytecodeOffset, int lineNo)
         {
             createRareDataIfNecessary();
-            Vector<LineInfo>& lineInfo = m_rareData->m_lineInfo;
+            DeltaEncodedTable<LineInfo>& lineInfo = m_rareData->m_lineInfo;
             if (!lineInfo.size() || lineInfo.last().lineNumber != lineNo) {
                 LineInfo info = { bytecodeOffset, lineNo };
                 lineInfo.append(info);
@@ -689,6 +826,29 @@ namespace JSC {
             m_executeCounter = -100;
         }
         
+        // Incremented by every OSR exit from optimized code. An optimized
+        // CodeBlock that exits this often is assumed to have speculated on value
+        // profiles that no longer hold. The baseline code, which keeps profiling
+        // after each exit, jettisons it at its next optimization trigger and so
+        // recompiles with the new profiles. After a few such recompiles we stop
+        // trying, rather than thrash between the two tiers.
+        uint32_t* addressOfSpeculativeFailCounter()
+        {
+            return &m_speculativeFailCounter;
+        }
+        
+        uint32_t largeFailCountThreshold()
+        {
+            return 100;
+        }
+        
+        bool shouldReoptimizeNow()
+        {
+            return m_speculativeFailCounter >= largeFailCountThreshold();
+        }
+        
+        static const unsigned maximumReoptimizationRetries = 3;
+        
         // The amount by which the JIT will increment m_executeCounter.
         static const unsigned executeCounterIncrementForLoop = 1;
         static const unsigned executeCounterIncrementForReturn = 15;
@@ -737,6 +897,9 @@ namespace JSC {
 #ifndef NDEBUG
         unsigned m_instructionCount;
 #endif
+        double m_bytecodeGenerationTime;
+        double m_machineCodeGenerationTime;
+        size_t m_bytecodeSize;
 
         int m_thisRegister;
         int m_argumentsRegister;
@@ -746,12 +909,16 @@ namespace JSC {
         bool m_usesEval;
         bool m_isNumericCompareFunction;
         bool m_isStrictMode;
+        bool m_hasDebugHooks;
 
         CodeType m_codeType;
 
         RefPtr<SourceProvider> m_source;
         unsigned m_sourceOffset;
 
+        // Offsets of the Structure cache operand of each op_in; used by both the interpreter and the JIT.
+        Vector<unsigned> m_inInstructions;
+        Vector<int> m_varsToInitialize;
 #if ENABLE(INTERPRETER)
         Vector<unsigned> m_propertyAccessInstructions;
         Vector<unsigned> m_globalResolveInstructions;
@@ -759,6 +926,7 @@ namespace JSC {
 #if ENABLE(JIT)
         Vector<StructureStubInfo> m_structureStubInfos;
         Vector<GlobalResolveInfo> m_globalResolveInfos;
+        Vector<ByValStringCacheInfo> m_byValStringCacheInfos;
         Vector<CallLinkInfo> m_callLinkInfos;
         Vector<MethodCallLinkInfo> m_methodCallLinkInfos;
         JITCode m_jitCode;
@@ -771,6 +939,8 @@ namespace JSC {
 #if ENABLE(VALUE_PROFILER)
         SegmentedVector<ValueProfile, 8> m_valueProfiles;
 #endif
+        // Segmented so that the JIT can point at a profile's countdown.
+        SegmentedVector<AllocationSiteProfile, 8> m_allocationSiteProfiles;
 
         Vector<unsigned> m_jumpTargets;
         Vector<unsigned> m_loopTargets;
@@ -790,6 +960,13 @@ namespace JSC {
 
         int32_t m_executeCounter;
         uint8_t m_optimizationDelayCounter;
+        uint8_t m_reoptimizationRetryCounter;
+        uint32_t m_speculativeFailCounter;
+#if ENABLE(JIT)
+        // Optimized replacements jettisoned by reoptimize(), which may still
+        // have frames on the stack.
+        Vector<OwnPtr<CodeBlock> > m_jettisonedReplacements;
+#endif
 
         struct RareData {
            WTF_MAKE_FAST_ALLOCATED;
@@ -809,10 +986,11 @@ namespace JSC {
 
             EvalCodeCache m_evalCodeCache;
 
-            // Expression info - present if debugging.
-            Vector<ExpressionRangeInfo> m_expressionInfo;
+            // Expression info - present if debugging. This and the line info are only read
+            // to report errors and stack traces, so they are kept delta-encoded.
+            DeltaEncodedTable<ExpressionRangeInfo> m_expressionInfo;
             // Line info - present if profiling or debugging.
-            Vector<LineInfo> m_lineInfo;
+            DeltaEncodedTable<LineInfo> m_lineInfo;
 #if ENABLE(JIT)
             Vector<CallReturnOffsetToBytecodeOffset> m_callReturnIndexVector;
 #endif
@@ -849,6 +1027,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual CodeBlock* replacement();
         virtual bool canCompileWithDFG();
+        virtual PassOwnPtr<CodeBlock> jettison();
 #endif
     };
 
@@ -875,6 +1054,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual CodeBlock* replacement();
         virtual bool canCompileWithDFG();
+        virtual PassOwnPtr<CodeBlock> jettison();
 #endif
 
     private:
@@ -902,6 +1082,7 @@ namespace JSC {
         virtual JSObject* compileOptimized(ExecState*, ScopeChainNode*);
         virtual CodeBlock* replacement();
         virtual bool canCompileWithDFG();
+        virtual PassOwnPtr<CodeBlock> jettison();
 #endif
     };
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef DeltaEncodedTable_h
+#define DeltaEncodedTable_h
+
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+// A table of entries that is built in order of their first field, a bytecode
+// offset, and looked up by it. Entries are stored as the differences from the
+// previous entry, written as zigzag variable-length integers, which for line and
+// expression info usually takes a byte per field. Every checkpointInterval-th
+// entry is also kept decoded, along with where the entries after it start, so a
+// lookup binary searches the checkpoints and decodes at most one interval.
+//
+// Entry must provide numberOfFields, field(unsigned) and setField(unsigned, int32_t).
+template<typename Entry>
+class DeltaEncodedTable {
+public:
+    static const unsigned checkpointInterval = 32;
+
+    DeltaEncodedTable()
+        : m_size(0)
+    {
+        for (unsigned i = 0; i < Entry::numberOfFields; ++i)
+            m_last.setField(i, 0);
+    }
+
+    size_t size() const { return m_size; }
+
+    const Entry& last() const
+    {
+        ASSERT(m_size);
+        return m_last;
+    }
+
+    void append(const Entry& entry)
+    {
+        ASSERT(!m_size || static_cast<uint32_t>(entry.field(0)) >= static_cast<uint32_t>(m_last.field(0)));
+        for (unsigned i = 0; i < Entry::numberOfFields; ++i)
+            appendDelta(static_cast<int64_t>(entry.field(i)) - m_last.field(i));
+        if (!(m_size % checkpointInterval)) {
+            Checkpoint checkpoint = { entry, m_bytes.size() };
+            m_checkpoints.append(checkpoint);
+        }
+        m_last = entry;
+        ++m_size;
+    }
+
+    // Finds the last entry whose first field is at most offset. Returns false if there is none.
+    bool find(uint32_t offset, Entry& result) const
+    {
+        size_t low = 0;
+        size_t high = m_checkpoints.size();
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (static_cast<uint32_t>(m_checkpoints[mid].entry.field(0)) <= offset)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        if (!low)
+            return false;
+
+        const Checkpoint& checkpoint = m_checkpoints[low - 1];
+        result = checkpoint.entry;
+        size_t position = checkpoint.position;
+        for (size_t index = (low - 1) * checkpointInterval + 1; index < m_size && index % checkpointInterval; ++index) {
+            Entry next;
+            for (unsigned i = 0; i < Entry::numberOfFields; ++i)
+                next.setField(i, static_cast<int32_t>(result.field(i) + readDelta(position)));
+            if (static_cast<uint32_t>(next.field(0)) > offset)
+                break;
+            result = next;
+        }
+        return true;
+    }
+
+    void shrinkToFit()
+    {
+        m_bytes.shrinkToFit();
+        m_checkpoints.shrinkToFit();
+    }
+
+    size_t sizeInMemory() const { return m_bytes.capacity() + m_checkpoints.capacity() * sizeof(Checkpoint); }
+
+private:
+    struct Checkpoint {
+        Entry entry;
+        size_t position;
+    };
+
+    void appendDelta(int64_t delta)
+    {
+        uint64_t value = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        while (value >= 0x80) {
+            m_bytes.append(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        m_bytes.append(static_cast<uint8_t>(value));
+    }
+
+    int64_t readDelta(size_t& position) const
+    {
+        uint64_t value = 0;
+        unsigned shift = 0;
+        uint8_t byte;
+        do {
+            byte = m_bytes[position++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    Vector<uint8_t> m_bytes;
+    Vector<Checkpoint> m_checkpoints;
+    size_t m_size;
+    Entry m_last;
+};
+
+} // namespace JSC
+
+#endif // DeltaEncodedTable_h
@@ -168,6 +168,10 @@ namespace JSC {
 
         Instruction(PropertySlot::GetValueFunc getterFunc) { u.getterFunc = getterFunc; }
 
+        // Every slot is pointer-sized because the interpreter caches Structures, chains,
+        // cells and getters in place, and the computed-goto interpreter stores opcodes as
+        // label addresses. A narrower operand encoding would first need those caches moved
+        // out of the instruction stream, as the JIT already does with StructureStubInfo.
         union {
             Opcode opcode;
             int operand;
@@ -49,6 +49,13 @@ namespace JSC {
         StringOffsetTable offsetTable;
 #if ENABLE(JIT)
         CodeLocationLabel ctiDefault; // FIXME: it should not be necessary to store this.
+
+        // For tables too large to search inline, the JIT looks identifiers up by
+        // (hash >> ctiHashShift) & (ctiHashKeys.size() - 1), which it picks so that no
+        // two cases share a slot. Empty slots have a null key.
+        Vector<StringImpl*> ctiHashKeys;
+        Vector<void*> ctiHashTargets;
+        unsigned ctiHashShift;
 #endif
 
         inline int32_t offsetForValue(StringImpl* value, int32_t defaultOffset)
@@ -46,9 +46,9 @@ namespace JSC {
         macro(op_get_callee, 2) \
         macro(op_convert_this, 2) \
         \
-        macro(op_new_object, 2) \
-        macro(op_new_array, 4) \
-        macro(op_new_array_buffer, 4) \
+        macro(op_new_object, 3) \
+        macro(op_new_array, 5) \
+        macro(op_new_array_buffer, 5) \
         macro(op_new_regexp, 3) \
         macro(op_mov, 3) \
         \
@@ -93,7 +93,7 @@ namespace JSC {
         macro(op_is_string, 3) \
         macro(op_is_object, 3) \
         macro(op_is_function, 3) \
-        macro(op_in, 4) \
+        macro(op_in, 5) \
         \
         macro(op_resolve, 3) \
         macro(op_resolve_skip, 4) \
@@ -162,7 +162,7 @@ namespace JSC {
         macro(op_switch_char, 4) \
         macro(op_switch_string, 4) \
         \
-        macro(op_new_func, 4) \
+        macro(op_new_func, 5) \
         macro(op_new_func_exp, 3) \
         macro(op_call, 4) \
         macro(op_call_eval, 4) \
@@ -229,13 +229,14 @@ namespace JSC {
     typedef OpcodeID Opcode;
 #endif
 
+    // Also used by release builds, to report a sampling profile's opcodes.
+    extern const char* const opcodeNames[];
+
 #if !defined(NDEBUG) || ENABLE(OPCODE_SAMPLING) || ENABLE(CODEBLOCK_SAMPLING) || ENABLE(OPCODE_STATS)
 
 #define PADDING_STRING "                                "
 #define PADDING_STRING_LENGTH static_cast<unsigned>(strlen(PADDING_STRING))
 
-    extern const char* const opcodeNames[];
-
     inline const char* padOpcodeName(OpcodeID op, unsigned width)
     {
         unsigned pad = width - strlen(opcodeNames[op]);
@@ -34,7 +34,6 @@
 
 namespace JSC {
 
-#ifndef NDEBUG
 const char* predictionToString(PredictedType value)
 {
     static const int size = 96;
@@ -80,7 +79,6 @@ const char* predictionToString(PredictedType value)
     
     return description;
 }
-#endif
 
 PredictedType predictionFromValue(JSValue value)
 {
@@ -105,9 +105,7 @@ inline bool isStrongPrediction(PredictedType value)
     return !!(value & StrongPredictionTag);
 }
 
-#ifndef NDEBUG
 const char* predictionToString(PredictedType value);
-#endif
 
 inline PredictedType mergePredictions(PredictedType left, PredictedType right)
 {
@@ -50,6 +50,7 @@ void StructureStubInfo::deref()
     case access_get_by_id_chain:
     case access_put_by_id_transition:
     case access_put_by_id_replace:
+    case access_put_by_id_setter:
     case access_unset:
     case access_get_by_id_generic:
     case access_put_by_id_generic:
@@ -94,6 +95,10 @@ void StructureStubInfo::visitAggregate(SlotVisitor& visitor)
     case access_put_by_id_replace:
         visitor.append(&u.putByIdReplace.baseObjectStructure);
         return;
+    case access_put_by_id_setter:
+        visitor.append(&u.putByIdSetter.baseObjectStructure);
+        visitor.append(&u.putByIdSetter.chain);
+        return;
     case access_unset:
     case access_get_by_id_generic:
     case access_put_by_id_generic:
@@ -43,6 +43,7 @@ namespace JSC {
         access_get_by_id_proto_list,
         access_put_by_id_transition,
         access_put_by_id_replace,
+        access_put_by_id_setter,
         access_unset,
         access_get_by_id_generic,
         access_put_by_id_generic,
@@ -54,12 +55,15 @@ namespace JSC {
         StructureStubInfo()
             : accessType(access_unset)
             , seen(false)
+            , isGeneric(false)
+            , repatchCount(0)
         {
         }
 
         void initGetByIdSelf(JSGlobalData& globalData, JSCell* owner, Structure* baseObjectStructure)
         {
             accessType = access_get_by_id_self;
+            ++repatchCount;
 
             u.getByIdSelf.baseObjectStructure.set(globalData, owner, baseObjectStructure);
         }
@@ -67,6 +71,7 @@ namespace JSC {
         void initGetByIdProto(JSGlobalData& globalData, JSCell* owner, Structure* baseObjectStructure, Structure* prototypeStructure)
         {
             accessType = access_get_by_id_proto;
+            ++repatchCount;
 
             u.getByIdProto.baseObjectStructure.set(globalData, owner, baseObjectStructure);
             u.getByIdProto.prototypeStructure.set(globalData, owner, prototypeStructure);
@@ -75,6 +80,7 @@ namespace JSC {
         void initGetByIdChain(JSGlobalData& globalData, JSCell* owner, Structure* baseObjectStructure, StructureChain* chain)
         {
             accessType = access_get_by_id_chain;
+            ++repatchCount;
 
             u.getByIdChain.baseObjectStructure.set(globalData, owner, baseObjectStructure);
             u.getByIdChain.chain.set(globalData, owner, chain);
@@ -83,6 +89,7 @@ namespace JSC {
         void initGetByIdSelfList(PolymorphicAccessStructureList* structureList, int listSize)
         {
             accessType = access_get_by_id_self_list;
+            ++repatchCount;
 
             u.getByIdProtoList.structureList = structureList;
             u.getByIdProtoList.listSize = listSize;
@@ -91,6 +98,7 @@ namespace JSC {
         void initGetByIdProtoList(PolymorphicAccessStructureList* structureList, int listSize)
         {
             accessType = access_get_by_id_proto_list;
+            ++repatchCount;
 
             u.getByIdProtoList.structureList = structureList;
             u.getByIdProtoList.listSize = listSize;
@@ -101,6 +109,7 @@ namespace JSC {
         void initPutByIdTransition(JSGlobalData& globalData, JSCell* owner, Structure* previousStructure, Structure* structure, StructureChain* chain)
         {
             accessType = access_put_by_id_transition;
+            ++repatchCount;
 
             u.putByIdTransition.previousStructure.set(globalData, owner, previousStructure);
             u.putByIdTransition.structure.set(globalData, owner, structure);
@@ -110,10 +119,22 @@ namespace JSC {
         void initPutByIdReplace(JSGlobalData& globalData, JSCell* owner, Structure* baseObjectStructure)
         {
             accessType = access_put_by_id_replace;
+            ++repatchCount;
     
             u.putByIdReplace.baseObjectStructure.set(globalData, owner, baseObjectStructure);
         }
 
+        void initPutByIdSetter(JSGlobalData& globalData, JSCell* owner, Structure* baseObjectStructure, StructureChain* chain, unsigned count, size_t cachedOffset)
+        {
+            accessType = access_put_by_id_setter;
+            ++repatchCount;
+
+            u.putByIdSetter.baseObjectStructure.set(globalData, owner, baseObjectStructure);
+            u.putByIdSetter.chain.set(globalData, owner, chain);
+            u.putByIdSetter.count = count;
+            u.putByIdSetter.cachedOffset = cachedOffset;
+        }
+
         void deref();
         void visitAggregate(SlotVisitor&);
 
@@ -127,8 +148,42 @@ namespace JSC {
             seen = true;
         }
 
+        // Called when a polymorphic list gains an entry without being reinitialized.
+        void didGrowList()
+        {
+            ++repatchCount;
+        }
+
+        // Called when the site gives up on caching and its slow case no longer repatches.
+        void setGeneric()
+        {
+            isGeneric = true;
+        }
+
+        // The structures the site's cache currently checks for.
+        int structureCount() const
+        {
+            switch (accessType) {
+            case access_unset:
+            case access_get_by_id_generic:
+            case access_put_by_id_generic:
+            case access_get_array_length:
+            case access_get_string_length:
+                return 0;
+            case access_get_by_id_self_list:
+                return u.getByIdSelfList.listSize;
+            case access_get_by_id_proto_list:
+                return u.getByIdProtoList.listSize;
+            default:
+                return 1;
+            }
+        }
+
         int8_t accessType;
         int8_t seen;
+        // Inline cache statistics, reported by CodeBlock::inlineCacheStatistics().
+        int8_t isGeneric;
+        unsigned repatchCount;
         
 #if ENABLE(DFG_JIT)
         int8_t baseGPR;
@@ -171,6 +226,12 @@ namespace JSC {
             struct {
                 WriteBarrierBase<Structure> baseObjectStructure;
             } putByIdReplace;
+            struct {
+                WriteBarrierBase<Structure> baseObjectStructure;
+                WriteBarrierBase<StructureChain> chain;
+                unsigned count; // Number of prototypes between the base and the object holding the accessor.
+                size_t cachedOffset;
+            } putByIdSetter;
         } u;
 
         MacroAssemblerCodeRef stubRoutine;
@@ -33,8 +33,10 @@
 #include "BatchedTransitionOptimizer.h"
 #include "JSFunction.h"
 #include "Interpreter.h"
+#include "PauseTelemetry.h"
 #include "ScopeChain.h"
 #include "UString.h"
+#include <wtf/CurrentTime.h>
 
 using namespace std;
 
@@ -139,9 +141,21 @@ bool BytecodeGenerator::dumpsGeneratedCode()
 
 JSObject* BytecodeGenerator::generate()
 {
+    FastMallocTagScope tagScope("JSC/Bytecode");
+    double startTime = currentTime();
+    PauseScope pause(CompilationPause, CompilationStatistics::BytecodeTier, 0);
+
     m_codeBlock->setThisRegister(m_thisRegister.index());
+    m_codeBlock->setHasDebugHooks(m_shouldEmitDebugHooks);
+
+    // Long functions would otherwise regrow the instruction stream dozens of times, since Vector
+    // grows by a quarter at a time. Scripts average well over one instruction slot per four source
+    // characters, so this stays under the final size, and shrinkToFit() trims any excess below.
+    instructions().reserveCapacity(max<size_t>(instructions().size(), m_scopeNode->source().length() / 4));
 
     m_scopeNode->emitBytecode(*this);
+    threadJumps();
+    computeVarsToInitialize();
 
 #ifndef NDEBUG
     m_codeBlock->setInstructionCount(m_codeBlock->instructions().size());
@@ -155,11 +169,195 @@ JSObject* BytecodeGenerator::generate()
 
     m_codeBlock->shrinkToFit();
 
+    double generationTime = currentTime() - startTime;
+    m_codeBlock->didGenerateBytecode(generationTime);
+    pause.setBytes(m_codeBlock->bytecodeSize());
+    m_globalData->compilationStatistics.record(CompilationStatistics::BytecodeTier, generationTime, m_codeBlock->bytecodeSize());
+
     if (m_expressionTooDeep)
         return createOutOfMemoryError(m_scopeChain->globalObject.get());
     return 0;
 }
 
+// Returns the offset of the operand holding the jump offset of a forward jump, or 0 for other opcodes.
+static unsigned forwardJumpOffsetOperand(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_jmp:
+        return 1;
+    case op_jtrue:
+    case op_jfalse:
+    case op_jeq_null:
+    case op_jneq_null:
+        return 2;
+    case op_jneq_ptr:
+    case op_jless:
+    case op_jlesseq:
+    case op_jgreater:
+    case op_jgreatereq:
+    case op_jnless:
+    case op_jnlesseq:
+    case op_jngreater:
+    case op_jngreatereq:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+// Control flow that ends in nested statements leaves chains of forward jumps, such as a jump out
+// of an inner if landing on the jump out of an outer one. This retargets each forward jump at
+// the end of its chain, and replaces a jump to a return with the return itself. Both keep every
+// instruction in place, so no offsets held elsewhere in the CodeBlock need remapping, and all
+// new targets are labels already.
+void BytecodeGenerator::threadJumps()
+{
+    Vector<Instruction>& instructions = this->instructions();
+    Interpreter* interpreter = globalData()->interpreter;
+    for (size_t i = 0; i < instructions.size(); i += opcodeLengths[interpreter->getOpcodeID(instructions[i].u.opcode)]) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        unsigned offsetOperand = forwardJumpOffsetOperand(opcodeID);
+        if (!offsetOperand || instructions[i + offsetOperand].u.operand <= 0)
+            continue;
+
+        // op_jmp is only ever emitted for forward jumps, so the chain cannot loop.
+        size_t target = i + instructions[i + offsetOperand].u.operand;
+        while (interpreter->getOpcodeID(instructions[target].u.opcode) == op_jmp)
+            target += instructions[target + 1].u.operand;
+        instructions[i + offsetOperand].u.operand = target - i;
+
+        if (opcodeID == op_jmp && interpreter->getOpcodeID(instructions[target].u.opcode) == op_ret) {
+            COMPILE_ASSERT(OPCODE_LENGTH(op_jmp) == OPCODE_LENGTH(op_ret), jump_to_return_can_be_replaced_in_place);
+            instructions[i] = instructions[target];
+            instructions[i + 1] = instructions[target + 1];
+        }
+    }
+}
+
+// Opcodes whose first operand is a register they write without reading it first, and whose other
+// operands are single registers or immediates.
+static bool writesFirstOperandOnly(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_init_lazy_reg:
+    case op_get_callee:
+    case op_new_object:
+    case op_new_regexp:
+    case op_new_func_exp:
+    case op_mov:
+    case op_not:
+    case op_eq:
+    case op_eq_null:
+    case op_neq:
+    case op_neq_null:
+    case op_stricteq:
+    case op_nstricteq:
+    case op_less:
+    case op_lesseq:
+    case op_greater:
+    case op_greatereq:
+    case op_to_jsnumber:
+    case op_negate:
+    case op_add:
+    case op_mul:
+    case op_div:
+    case op_mod:
+    case op_sub:
+    case op_lshift:
+    case op_rshift:
+    case op_urshift:
+    case op_bitand:
+    case op_bitxor:
+    case op_bitor:
+    case op_bitnot:
+    case op_typeof:
+    case op_resolve:
+    case op_resolve_skip:
+    case op_resolve_global:
+    case op_resolve_base:
+    case op_get_scoped_var:
+    case op_get_global_var:
+    case op_get_by_id:
+    case op_get_by_val:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Opcodes with no register result, whose operands are single registers or immediates.
+static bool readsOperandsOnly(OpcodeID opcodeID)
+{
+    switch (opcodeID) {
+    case op_enter:
+    case op_convert_this:
+    case op_create_this:
+    case op_put_scoped_var:
+    case op_put_global_var:
+    case op_put_by_id:
+    case op_put_by_val:
+    case op_put_by_index:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Initializing every local to undefined in op_enter costs short functions with large frames on every
+// call. A local that the entry code writes before anything can read it doesn't need it:
+// until the first jump target or exception handler nothing else runs in this frame, and the
+// register file is scanned conservatively, so a stale value in the register is harmless.
+// Captured locals are always initialized, since closures and the debugger may read them at any
+// time. Operands are treated as reads whatever their role, which can only keep a local
+// initialized needlessly; an opcode not known to this scan ends it.
+enum VarState { Unseen, WrittenFirst, ReadFirst };
+
+void BytecodeGenerator::computeVarsToInitialize()
+{
+    int numVars = m_codeBlock->m_numVars;
+    int firstUncapturedVar = m_codeBlock->m_numCapturedVars;
+    Vector<VarState> states(numVars);
+    states.fill(Unseen);
+
+    size_t end = instructions().size();
+    for (size_t i = 0; i < m_codeBlock->numberOfJumpTargets(); ++i) {
+        if (m_codeBlock->jumpTarget(i)) {
+            end = min<size_t>(end, m_codeBlock->jumpTarget(i));
+            break;
+        }
+    }
+    for (size_t i = 0; i < m_codeBlock->numberOfExceptionHandlers(); ++i)
+        end = min<size_t>(end, m_codeBlock->exceptionHandler(i).start);
+
+    Vector<Instruction>& instructions = this->instructions();
+    Interpreter* interpreter = globalData()->interpreter;
+    for (size_t i = 0; i < end; i += opcodeLengths[interpreter->getOpcodeID(instructions[i].u.opcode)]) {
+        OpcodeID opcodeID = interpreter->getOpcodeID(instructions[i].u.opcode);
+        // new_func reads its destination when it is one of the lazily created functions.
+        bool writesFirstOperand = writesFirstOperandOnly(opcodeID) || (opcodeID == op_new_func && !instructions[i + 3].u.operand);
+        if (!writesFirstOperand && !readsOperandsOnly(opcodeID))
+            break;
+
+        for (int j = writesFirstOperand ? 2 : 1; j < opcodeLengths[opcodeID]; ++j) {
+            int operand = instructions[i + j].u.operand;
+            if (operand >= firstUncapturedVar && operand < numVars && states[operand] == Unseen)
+                states[operand] = ReadFirst;
+        }
+        if (writesFirstOperand) {
+            int dst = instructions[i + 1].u.operand;
+            if (dst >= firstUncapturedVar && dst < numVars && states[dst] == Unseen)
+                states[dst] = WrittenFirst;
+        }
+    }
+
+    Vector<int> varsToInitialize;
+    for (int i = 0; i < numVars; ++i) {
+        if (states[i] != WrittenFirst)
+            varsToInitialize.append(i);
+    }
+    m_codeBlock->setVarsToInitialize(varsToInitialize);
+}
+
 bool BytecodeGenerator::addVar(const Identifier& ident, bool isConstant, RegisterID*& r0)
 {
     int index = m_calleeRegisters.size();
@@ -315,7 +513,10 @@ BytecodeGenerator::BytecodeGenerator(FunctionBodyNode* functionBody, ScopeChainN
         emitInitLazyRegister(argumentsRegister);
         emitInitLazyRegister(unmodifiedArgumentsRegister);
         
-        if (m_codeBlock->isStrictMode()) {
+        // Strict mode arguments objects must not observe assignments to named
+        // parameters, so they have to be snapshotted on entry. Without named
+        // parameters nothing can change the values, and creation stays lazy.
+        if (m_codeBlock->isStrictMode() && functionBody->parameters()->size()) {
             emitOpcode(op_create_arguments);
             instructions().append(argumentsRegister->index());
         }
@@ -1047,6 +1248,11 @@ RegisterID* BytecodeGenerator::emitBinaryOp(OpcodeID opcodeID, RegisterID* dst,
         opcodeID == op_add || opcodeID == op_mul || opcodeID == op_sub || opcodeID == op_div)
         instructions().append(types.toInt());
 
+    if (opcodeID == op_in) {
+        m_codeBlock->addInInstruction(instructions().size());
+        instructions().append(0);
+    }
+
     return dst;
 }
 
@@ -1058,11 +1264,15 @@ RegisterID* BytecodeGenerator::emitEqualityOp(OpcodeID opcodeID, RegisterID* dst
 
         retrieveLastUnaryOp(dstIndex, srcIndex);
 
-        if (src1->index() == dstIndex
-            && src1->isTemporary()
-            && m_codeBlock->isConstantRegisterIndex(src2->index())
-            && m_codeBlock->constantRegister(src2->index()).get().isString()) {
-            const UString& value = asString(m_codeBlock->constantRegister(src2->index()).get())->tryGetValue();
+        // Equality is symmetric, so 'typeof x == "string"' and '"string" == typeof x' fuse alike.
+        RegisterID* typeofResult = src1->index() == dstIndex ? src1 : src2;
+        RegisterID* typeName = typeofResult == src1 ? src2 : src1;
+
+        if (typeofResult->index() == dstIndex
+            && typeofResult->isTemporary()
+            && m_codeBlock->isConstantRegisterIndex(typeName->index())
+            && m_codeBlock->constantRegister(typeName->index()).get().isString()) {
+            const UString& value = asString(m_codeBlock->constantRegister(typeName->index()).get())->tryGetValue();
             if (value == "undefined") {
                 rewindUnaryOp();
                 emitOpcode(op_is_undefined);
@@ -1240,7 +1450,10 @@ RegisterID* BytecodeGenerator::emitResolve(RegisterID* dst, const Identifier& pr
         instructions().append(addConstant(property));
         return dst;
     }
-    if (shouldAvoidResolveGlobal()) {
+    // Directly indexed global variables need no GlobalResolveInfo, so keep them
+    // direct even once we have stopped handing out resolve caches.
+    bool canIndexDirectly = globalObject && index != missingSymbolMarker() && !requiresDynamicChecks;
+    if (shouldAvoidResolveGlobal() && !canIndexDirectly) {
         globalObject = 0;
         requiresDynamicChecks = true;
     }
@@ -1589,6 +1802,9 @@ RegisterID* BytecodeGenerator::emitGetByVal(RegisterID* dst, RegisterID* base, R
             return dst;
         }
     }
+#if ENABLE(JIT)
+    m_codeBlock->addByValStringCacheInfo(instructions().size());
+#endif
     emitOpcode(op_get_by_val);
     instructions().append(dst->index());
     instructions().append(base->index());
@@ -1598,6 +1814,9 @@ RegisterID* BytecodeGenerator::emitGetByVal(RegisterID* dst, RegisterID* base, R
 
 RegisterID* BytecodeGenerator::emitPutByVal(RegisterID* base, RegisterID* property, RegisterID* value)
 {
+#if ENABLE(JIT)
+    m_codeBlock->addByValStringCacheInfo(instructions().size());
+#endif
     emitOpcode(op_put_by_val);
     instructions().append(base->index());
     instructions().append(property->index());
@@ -1627,6 +1846,7 @@ RegisterID* BytecodeGenerator::emitNewObject(RegisterID* dst)
 {
     emitOpcode(op_new_object);
     instructions().append(dst->index());
+    instructions().append(m_codeBlock->addAllocationSiteProfile());
     return dst;
 }
 
@@ -1680,6 +1900,7 @@ RegisterID* BytecodeGenerator::emitNewArray(RegisterID* dst, ElementNode* elemen
             instructions().append(dst->index());
             instructions().append(constantBufferIndex);
             instructions().append(length);
+            instructions().append(m_codeBlock->addAllocationSiteProfile());
             return dst;
         }
     }
@@ -1697,6 +1918,7 @@ RegisterID* BytecodeGenerator::emitNewArray(RegisterID* dst, ElementNode* elemen
     instructions().append(dst->index());
     instructions().append(argv.size() ? argv[0]->index() : 0); // argv
     instructions().append(argv.size()); // argc
+    instructions().append(m_codeBlock->addAllocationSiteProfile());
     return dst;
 }
 
@@ -1720,6 +1942,7 @@ RegisterID* BytecodeGenerator::emitNewFunctionInternal(RegisterID* dst, unsigned
     instructions().append(dst->index());
     instructions().append(index);
     instructions().append(doNullCheck);
+    instructions().append(m_codeBlock->addAllocationSiteProfile());
     return dst;
 }
 
@@ -1756,16 +1979,22 @@ void BytecodeGenerator::createArgumentsIfNecessary()
     if (!m_codeBlock->usesArguments())
         return;
 
-    // If we're in strict mode we tear off the arguments on function
-    // entry, so there's no need to check if we need to create them
-    // now
-    if (m_codeBlock->isStrictMode())
+    // If we're in strict mode and have named parameters we tear off the
+    // arguments on function entry, so there's no need to check if we need
+    // to create them now
+    if (m_codeBlock->isStrictMode() && m_codeBlock->m_numParameters > 1)
         return;
 
     emitOpcode(op_create_arguments);
     instructions().append(m_codeBlock->argumentsRegister());
 }
 
+// The activation is only needed once a closure that captures one of our variables
+// can exist, so it is created just before each function is instantiated (the opcode
+// is a no-op if it already exists), and op_tear_off_activation does nothing if it
+// never was. We cannot elide it further by proving the closure does not escape: a
+// callback handed to forEach or any other call is an argument to an arbitrary
+// function, and nothing here can see what that function does with it.
 void BytecodeGenerator::createActivationIfNecessary()
 {
     if (m_hasCreatedActivation)
@@ -84,6 +84,88 @@ inline void Recompiler::operator()(JSCell* cell)
         m_sourceProviders.add(executable->source().provider(), exec);
 }
 
+// Functions with code live on the stack, which can't be discarded under them. Only
+// conservative roots are needed, since a running function's callee is in its call frame.
+static void collectExecutingFunctions(JSGlobalData* globalData, HashSet<FunctionExecutable*>& executingFunctions)
+{
+    if (!globalData->dynamicGlobalObject)
+        return;
+
+    HashSet<JSCell*> roots;
+    globalData->heap.getConservativeRegisterRoots(roots);
+    HashSet<JSCell*>::iterator end = roots.end();
+    for (HashSet<JSCell*>::iterator ptr = roots.begin(); ptr != end; ++ptr) {
+        JSCell* cell = *ptr;
+        if (cell->inherits(&FunctionExecutable::s_info))
+            executingFunctions.add(static_cast<FunctionExecutable*>(cell));
+        else if (cell->inherits(&JSFunction::s_info) && !asFunction(cell)->isHostFunction())
+            executingFunctions.add(asFunction(cell)->jsExecutable());
+    }
+}
+
+class DebugHookDiscarder : public MarkedBlock::VoidFunctor {
+public:
+    DebugHookDiscarder(JSGlobalData* globalData, JSGlobalObject* globalObject)
+        : m_globalObject(globalObject)
+    {
+        collectExecutingFunctions(globalData, m_executingFunctions);
+    }
+
+    void operator()(JSCell* cell)
+    {
+        if (!cell->inherits(&JSFunction::s_info))
+            return;
+
+        JSFunction* function = asFunction(cell);
+        if (function->executable()->isHostFunction() || function->scope()->globalObject.get() != m_globalObject)
+            return;
+
+        FunctionExecutable* executable = function->jsExecutable();
+        if (executable->hasDebugHooks() && !m_executingFunctions.contains(executable))
+            executable->discardCode();
+    }
+
+private:
+    JSGlobalObject* m_globalObject;
+    HashSet<FunctionExecutable*> m_executingFunctions;
+};
+
+class BreakpointRecompiler : public MarkedBlock::VoidFunctor {
+public:
+    BreakpointRecompiler(JSGlobalData* globalData, Debugger* debugger, intptr_t sourceID, int lineNumber)
+        : m_debugger(debugger)
+        , m_sourceID(sourceID)
+        , m_lineNumber(lineNumber)
+    {
+        collectExecutingFunctions(globalData, m_executingFunctions);
+    }
+
+    void operator()(JSCell* cell)
+    {
+        if (!cell->inherits(&JSFunction::s_info))
+            return;
+
+        JSFunction* function = asFunction(cell);
+        if (function->executable()->isHostFunction() || function->scope()->globalObject->debugger() != m_debugger)
+            return;
+
+        FunctionExecutable* executable = function->jsExecutable();
+        if (executable->sourceID() != m_sourceID || m_lineNumber < executable->lineNo() || m_lineNumber > executable->lastLine())
+            return;
+        if (!executable->isGeneratedForCall() && !executable->isGeneratedForConstruct())
+            return;
+        if (executable->hasDebugHooks() || m_executingFunctions.contains(executable))
+            return;
+        executable->discardCode();
+    }
+
+private:
+    Debugger* m_debugger;
+    intptr_t m_sourceID;
+    int m_lineNumber;
+    HashSet<FunctionExecutable*> m_executingFunctions;
+};
+
 } // namespace
 
 namespace JSC {
@@ -107,6 +189,10 @@ void Debugger::detach(JSGlobalObject* globalObject)
     ASSERT(m_globalObjects.contains(globalObject));
     m_globalObjects.remove(globalObject);
     globalObject->setDebugger(0);
+
+    JSGlobalData* globalData = &globalObject->globalData();
+    DebugHookDiscarder discarder(globalData, globalObject);
+    globalData->heap.forEachCell(discarder);
 }
 
 void Debugger::recompileAllJSFunctions(JSGlobalData* globalData)
@@ -121,6 +207,12 @@ void Debugger::recompileAllJSFunctions(JSGlobalData* globalData)
     globalData->heap.forEachCell(recompiler);
 }
 
+void Debugger::recompileFunctionsForBreakpoint(JSGlobalData* globalData, intptr_t sourceID, int lineNumber)
+{
+    BreakpointRecompiler recompiler(globalData, this, sourceID, lineNumber);
+    globalData->heap.forEachCell(recompiler);
+}
+
 JSValue evaluateInGlobalCallFrame(const UString& script, JSValue& exception, JSGlobalObject* globalObject)
 {
     CallFrame* globalCallFrame = globalObject->globalExec();
@@ -39,6 +39,10 @@ namespace JSC {
         virtual ~Debugger();
 
         void attach(JSGlobalObject*);
+
+        // Also discards the code of the global object's functions that was compiled with
+        // debug hooks, so they run at full speed again. Functions still on the stack keep
+        // their code until it is next discarded.
         virtual void detach(JSGlobalObject*);
 
         virtual void sourceParsed(ExecState*, SourceProvider*, int errorLineNumber, const UString& errorMessage) = 0;
@@ -53,6 +57,11 @@ namespace JSC {
 
         void recompileAllJSFunctions(JSGlobalData*);
 
+        // Code compiled before the debugger was attached has no debug hooks and can't stop at a
+        // breakpoint. This gives only the functions in the source that span lineNumber such
+        // code fresh code with hooks on their next call. Functions on the stack are left alone.
+        void recompileFunctionsForBreakpoint(JSGlobalData*, intptr_t sourceID, int lineNumber);
+
     private:
         HashSet<JSGlobalObject*> m_globalObjects;
     };
@@ -28,8 +28,10 @@
 
 #if ENABLE(DFG_JIT)
 
-#include "DFGAliasTracker.h"
+#include "DFGCSE.h"
+#include "DFGConstantFolding.h"
 #include "DFGCapabilities.h"
+#include "DFGRangeAnalysis.h"
 #include "DFGScoreBoard.h"
 #include "CodeBlock.h"
 
@@ -585,8 +587,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             m_constants[i] = ConstantRecord();
     }
 
-    AliasTracker aliases(m_graph);
-
     Interpreter* interpreter = m_globalData->interpreter;
     Instruction* instructionsBegin = m_codeBlock->instructions().begin();
     unsigned blockBegin = m_currentIndex;
@@ -829,6 +829,30 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NEXT_OPCODE(op_not);
         }
 
+        case op_is_undefined: {
+            NodeIndex value = get(currentInstruction[2].u.operand);
+            set(currentInstruction[1].u.operand, addToGraph(IsUndefined, value));
+            NEXT_OPCODE(op_is_undefined);
+        }
+
+        case op_is_boolean: {
+            NodeIndex value = get(currentInstruction[2].u.operand);
+            set(currentInstruction[1].u.operand, addToGraph(IsBoolean, value));
+            NEXT_OPCODE(op_is_boolean);
+        }
+
+        case op_is_number: {
+            NodeIndex value = get(currentInstruction[2].u.operand);
+            set(currentInstruction[1].u.operand, addToGraph(IsNumber, value));
+            NEXT_OPCODE(op_is_number);
+        }
+
+        case op_is_string: {
+            NodeIndex value = get(currentInstruction[2].u.operand);
+            set(currentInstruction[1].u.operand, addToGraph(IsString, value));
+            NEXT_OPCODE(op_is_string);
+        }
+
         case op_less: {
             ARITHMETIC_OP();
             NodeIndex op1 = get(currentInstruction[2].u.operand);
@@ -915,10 +939,9 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             weaklyPredictArray(base);
             weaklyPredictInt32(property);
 
-            NodeIndex getByVal = addToGraph(GetByVal, OpInfo(0), OpInfo(PredictNone), base, property, aliases.lookupGetByVal(base, property));
+            NodeIndex getByVal = addToGraph(GetByVal, OpInfo(0), OpInfo(PredictNone), base, property);
             set(currentInstruction[1].u.operand, getByVal);
             stronglyPredict(getByVal);
-            aliases.recordGetByVal(getByVal);
 
             NEXT_OPCODE(op_get_by_val);
         }
@@ -930,9 +953,7 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             weaklyPredictArray(base);
             weaklyPredictInt32(property);
 
-            NodeIndex aliasedGet = aliases.lookupGetByVal(base, property);
-            NodeIndex putByVal = addToGraph(aliasedGet != NoNode ? PutByValAlias : PutByVal, base, property, value);
-            aliases.recordPutByVal(putByVal);
+            addToGraph(PutByVal, base, property, value);
 
             NEXT_OPCODE(op_put_by_val);
         }
@@ -948,7 +969,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NodeIndex getMethod = addToGraph(GetMethod, OpInfo(identifier), OpInfo(PredictNone), base);
             set(getInstruction[1].u.operand, getMethod);
             stronglyPredict(getMethod);
-            aliases.recordGetMethod(getMethod);
             
             m_currentIndex += OPCODE_LENGTH(op_method_check) + OPCODE_LENGTH(op_get_by_id);
             continue;
@@ -962,7 +982,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NodeIndex getById = addToGraph(GetById, OpInfo(identifier), OpInfo(PredictNone), base);
             set(currentInstruction[1].u.operand, getById);
             stronglyPredict(getById);
-            aliases.recordGetById(getById);
 
             NEXT_OPCODE(op_get_by_id);
         }
@@ -974,13 +993,10 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             unsigned identifier = currentInstruction[2].u.operand;
             bool direct = currentInstruction[8].u.operand;
 
-            if (direct) {
-                NodeIndex putByIdDirect = addToGraph(PutByIdDirect, OpInfo(identifier), base, value);
-                aliases.recordPutByIdDirect(putByIdDirect);
-            } else {
-                NodeIndex putById = addToGraph(PutById, OpInfo(identifier), base, value);
-                aliases.recordPutById(putById);
-            }
+            if (direct)
+                addToGraph(PutByIdDirect, OpInfo(identifier), base, value);
+            else
+                addToGraph(PutById, OpInfo(identifier), base, value);
 
             NEXT_OPCODE(op_put_by_id);
         }
@@ -997,6 +1013,44 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             NEXT_OPCODE(op_put_global_var);
         }
 
+        case op_get_scoped_var: {
+            // A function with a full scope chain needs the activation register checked
+            // before skipping the top scope; such functions begin with op_init_lazy_reg,
+            // which we do not compile.
+            ASSERT(m_codeBlock->codeType() != FunctionCode || !m_codeBlock->needsFullScopeChain());
+            NodeIndex getScopedVar = addToGraph(GetScopedVar, OpInfo(currentInstruction[2].u.operand), OpInfo(currentInstruction[3].u.operand));
+            set(currentInstruction[1].u.operand, getScopedVar);
+            NEXT_OPCODE(op_get_scoped_var);
+        }
+
+        case op_put_scoped_var: {
+            ASSERT(m_codeBlock->codeType() != FunctionCode || !m_codeBlock->needsFullScopeChain());
+            NodeIndex value = get(currentInstruction[3].u.operand);
+            addToGraph(PutScopedVar, OpInfo(currentInstruction[1].u.operand), OpInfo(currentInstruction[2].u.operand), value);
+            NEXT_OPCODE(op_put_scoped_var);
+        }
+
+        // === Object and array literals. ===
+
+        case op_new_object: {
+            NodeIndex newObject = addToGraph(NewObject, OpInfo(currentInstruction[2].u.operand));
+            set(currentInstruction[1].u.operand, newObject);
+            NEXT_OPCODE(op_new_object);
+        }
+
+        case op_new_array: {
+            int firstArg = currentInstruction[2].u.operand;
+            unsigned argCount = currentInstruction[3].u.operand;
+            for (unsigned argIdx = 0; argIdx < argCount; ++argIdx)
+                addVarArgChild(get(firstArg + argIdx));
+            NodeIndex newArray = addToGraph(Node::VarArg, NewArray, OpInfo(currentInstruction[4].u.operand), OpInfo(0));
+            set(currentInstruction[1].u.operand, newArray);
+            // The elements are passed to the allocation in the parameter slots.
+            if (argCount > m_parameterSlots)
+                m_parameterSlots = argCount;
+            NEXT_OPCODE(op_new_array);
+        }
+
         // === Block terminators. ===
 
         case op_jmp: {
@@ -1172,14 +1226,16 @@ bool ByteCodeParser::parseBlock(unsigned limit)
             LAST_OPCODE(op_end);
             
         case op_call: {
-            NodeIndex call = addCall(interpreter, currentInstruction, Call);
-            aliases.recordCall(call);
+            // Calls are never inlined. Inlining would need a CodeOrigin that names an inline call
+            // frame as well as a bytecode index, OSR exit and exception unwinding that rebuild one
+            // baseline frame per inlined callee, and a node that speculates on the callee, none of
+            // which this DFG has; for now the linked call in the DFG's code is the fast path.
+            addCall(interpreter, currentInstruction, Call);
             NEXT_OPCODE(op_call);
         }
             
         case op_construct: {
-            NodeIndex construct = addCall(interpreter, currentInstruction, Construct);
-            aliases.recordConstruct(construct);
+            addCall(interpreter, currentInstruction, Construct);
             NEXT_OPCODE(op_construct);
         }
             
@@ -1192,7 +1248,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
             NodeIndex resolve = addToGraph(Resolve, OpInfo(identifier));
             set(currentInstruction[1].u.operand, resolve);
-            aliases.recordResolve(resolve);
 
             NEXT_OPCODE(op_resolve);
         }
@@ -1203,7 +1258,6 @@ bool ByteCodeParser::parseBlock(unsigned limit)
 
             NodeIndex resolve = addToGraph(currentInstruction[3].u.operand ? ResolveBaseStrictPut : ResolveBase, OpInfo(identifier));
             set(currentInstruction[1].u.operand, resolve);
-            aliases.recordResolve(resolve);
 
             NEXT_OPCODE(op_resolve_base);
         }
@@ -1357,6 +1411,11 @@ bool ByteCodeParser::parse()
     // Set during construction.
     ASSERT(!m_currentIndex);
 
+    // Each bytecode becomes a few nodes, about one for every two instruction slots, so sizing the
+    // graph up front spares large functions the repeated copying of every node as it grows.
+    m_graph.reserveCapacity(m_codeBlock->instructions().size() / 2);
+    m_graph.m_blocks.reserveCapacity(m_codeBlock->numberOfJumpTargets() + 1);
+
     for (unsigned jumpTargetIndex = 0; jumpTargetIndex <= m_codeBlock->numberOfJumpTargets(); ++jumpTargetIndex) {
         // The maximum bytecode offset to go into the current basicblock is either the next jump target, or the end of the instructions.
         unsigned limit = jumpTargetIndex < m_codeBlock->numberOfJumpTargets() ? m_codeBlock->jumpTarget(jumpTargetIndex) : m_codeBlock->instructions().size();
@@ -1384,6 +1443,10 @@ bool ByteCodeParser::parse()
     processPhiStack<LocalPhiStack>();
     processPhiStack<ArgumentPhiStack>();
 
+    performConstantFolding(m_graph, m_codeBlock);
+    performCSE(m_graph);
+    performRangeAnalysis(m_graph, m_codeBlock);
+
     allocateVirtualRegisters();
 
 #if ENABLE(DFG_DEBUG_VERBOSE)
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "DFGCSE.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "DFGGraph.h"
+
+namespace JSC { namespace DFG {
+
+// === CSE ===
+//
+// This class performs common subexpression elimination over each basic block
+// in turn. Nodes are visited in order; a node that computes a value already
+// available within the block is recorded in m_replacements, and every later
+// reference to it is redirected to the earlier value (moving the reference
+// counts along with it), so that the replaced node is left with a refCount of
+// zero and is not generated. Since we have no dominator information in this
+// graph, nothing is carried across block boundaries.
+class CSE {
+public:
+    CSE(Graph& graph)
+        : m_graph(graph)
+    {
+        m_replacements.resize(m_graph.size());
+        for (unsigned i = 0; i < m_graph.size(); ++i)
+            m_replacements[i] = NoNode;
+    }
+
+    void run()
+    {
+        for (BlockIndex block = 0; block < m_graph.m_blocks.size(); ++block)
+            performBlockCSE(*m_graph.m_blocks[block]);
+    }
+
+private:
+    // Nodes with no side effects whose result depends only on their children.
+    bool isPure(Node& node)
+    {
+        switch (node.op) {
+        case BitAnd:
+        case BitOr:
+        case BitXor:
+        case BitLShift:
+        case BitRShift:
+        case BitURShift:
+        case UInt32ToNumber:
+        case ArithAdd:
+        case ArithSub:
+        case ArithMul:
+        case ArithDiv:
+        case ArithMod:
+        case CompareStrictEq:
+        case LogicalNot:
+        case IsUndefined:
+        case IsBoolean:
+        case IsNumber:
+        case IsString:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Returns true if the node may write to the heap or run arbitrary code (getters,
+    // setters, valueOf, calls), invalidating any load we have seen so far. This is
+    // deliberately conservative: it must hold on the non-speculative path too.
+    bool clobbersWorld(Node& node)
+    {
+        if (isPure(node))
+            return false;
+
+        switch (node.op) {
+        case JSConstant:
+        case GetLocal:
+        case SetLocal:
+        case Phi:
+        case GetGlobalVar:
+        case PutGlobalVar:
+        case GetScopedVar:
+        case PutScopedVar:
+        case NewObject:
+        case NewArray:
+        case CheckHasInstance:
+        case Breakpoint:
+        case DFG::Jump:
+        case Branch:
+        case Return:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    // The earliest node that could compute the same value as a node with these
+    // children; nothing before the last of them can.
+    NodeIndex startIndexForChildren(NodeIndex child1, NodeIndex child2, NodeIndex child3)
+    {
+        NodeIndex start = m_start;
+        if (child1 != NoNode && child1 >= start)
+            start = child1 + 1;
+        if (child2 != NoNode && child2 >= start)
+            start = child2 + 1;
+        if (child3 != NoNode && child3 >= start)
+            start = child3 + 1;
+        return start;
+    }
+
+    NodeIndex pureCSE(Node& node)
+    {
+        NodeIndex child1 = node.child1();
+        NodeIndex child2 = node.child2();
+        NodeIndex child3 = node.child3();
+
+        NodeIndex start = startIndexForChildren(child1, child2, child3);
+        for (NodeIndex index = m_compileIndex; index-- > start;) {
+            if (m_replacements[index] != NoNode)
+                continue;
+
+            Node& otherNode = m_graph[index];
+            if (node.op != otherNode.op)
+                continue;
+            if (child1 != otherNode.child1() || child2 != otherNode.child2() || child3 != otherNode.child3())
+                continue;
+
+            return index;
+        }
+        return NoNode;
+    }
+
+    NodeIndex globalVarLoadElimination(unsigned varNumber)
+    {
+        for (NodeIndex index = m_compileIndex; index-- > m_start;) {
+            // Nodes that have been replaced are not generated, so have no effects.
+            if (m_replacements[index] != NoNode)
+                continue;
+
+            Node& node = m_graph[index];
+            switch (node.op) {
+            case GetGlobalVar:
+                if (node.varNumber() == varNumber)
+                    return index;
+                break;
+            case PutGlobalVar:
+                if (node.varNumber() == varNumber)
+                    return node.child1();
+                break;
+            default:
+                break;
+            }
+            if (clobbersWorld(node))
+                break;
+        }
+        return NoNode;
+    }
+
+    // Try to detect situations where a by-val access follows a GetByVal to the same
+    // property; in these cases, we may be able to omit the subsequent get, or the bounds
+    // check on a subsequent put, on the speculative path, where we know conditions hold
+    // to make this safe (for example, on the speculative path we will not have allowed
+    // getter access, and a GetByVal either loads from the array storage or bails out).
+    // Any intervening access that may change the array's contents or length, or call
+    // out to arbitrary code, ends the search.
+    NodeIndex getByValLoadElimination(NodeIndex base, NodeIndex property)
+    {
+        for (NodeIndex index = m_compileIndex; index-- > m_start;) {
+            if (m_replacements[index] != NoNode)
+                continue;
+
+            Node& node = m_graph[index];
+            switch (node.op) {
+            case GetByVal:
+                // This check ensures the accesses alias, provided that the subscript is an
+                // integer index (this is good enough; the speculative path will only generate
+                // optimized accesses to handle integer subscripts).
+                if (node.child1() == base && equalIgnoringLaterNumericConversion(node.child2(), property))
+                    return index;
+                break;
+            case PutByVal:
+            case PutByValAlias:
+            case GetById:
+            case GetMethod:
+            case PutById:
+            case PutByIdDirect:
+            case Call:
+            case Construct:
+            case Resolve:
+            case ResolveBase:
+            case ResolveBaseStrictPut:
+                return NoNode;
+            default:
+                break;
+            }
+        }
+        return NoNode;
+    }
+
+    // This method returns true for arguments:
+    //   - (X, X)
+    //   - (X, ValueToNumber(X))
+    //   - (X, ValueToInt32(X))
+    bool equalIgnoringLaterNumericConversion(NodeIndex op1, NodeIndex op2)
+    {
+        if (op1 == op2)
+            return true;
+        Node& node2 = m_graph[op2];
+        return (node2.op == ValueToNumber || node2.op == ValueToInt32) && op1 == node2.child1();
+    }
+
+    // Redirect a reference to a replaced node to its replacement. References held
+    // by nodes that are not generated were never counted, so only live nodes move
+    // the reference count.
+    void canonicalize(NodeIndex& child, bool isLive)
+    {
+        if (child == NoNode)
+            return;
+
+        NodeIndex replacement = m_replacements[child];
+        if (replacement == NoNode)
+            return;
+
+        if (isLive) {
+            m_graph.ref(replacement);
+            m_graph.deref(child);
+        }
+        child = replacement;
+    }
+
+    void setReplacement(NodeIndex replacement)
+    {
+        if (replacement == NoNode)
+            return;
+
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("  @%u -> @%u", m_compileIndex, replacement);
+#endif
+
+        m_replacements[m_compileIndex] = replacement;
+
+        // 'mustGenerate' nodes hold a reference on themselves; drop it so that the
+        // node dies once the remaining references have moved to the replacement.
+        if (m_graph[m_compileIndex].mustGenerate())
+            m_graph.deref(m_compileIndex);
+    }
+
+    void performNodeCSE(Node& node)
+    {
+        bool isLive = node.shouldGenerate();
+
+        if (node.op & NodeHasVarArgs) {
+            for (unsigned childIdx = node.firstChild(); childIdx < node.firstChild() + node.numChildren(); childIdx++)
+                canonicalize(m_graph.m_varArgChildren[childIdx], isLive);
+        } else {
+            canonicalize(node.children.fixed.child1, isLive);
+            canonicalize(node.children.fixed.child2, isLive);
+            canonicalize(node.children.fixed.child3, isLive);
+        }
+
+        if (!isLive)
+            return;
+
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("   %s[%u]:", Graph::opName(node.op), m_compileIndex);
+#endif
+
+        switch (node.op) {
+        case BitAnd:
+        case BitOr:
+        case BitXor:
+        case BitLShift:
+        case BitRShift:
+        case BitURShift:
+        case UInt32ToNumber:
+        case ArithAdd:
+        case ArithSub:
+        case ArithMul:
+        case ArithDiv:
+        case ArithMod:
+        case CompareStrictEq:
+        case LogicalNot:
+        case IsUndefined:
+        case IsBoolean:
+        case IsNumber:
+        case IsString:
+            setReplacement(pureCSE(node));
+            break;
+
+        case GetGlobalVar:
+            setReplacement(globalVarLoadElimination(node.varNumber()));
+            break;
+
+        case GetByVal: {
+            if (node.child3() != NoNode)
+                break;
+            NodeIndex alias = getByValLoadElimination(node.child1(), node.child2());
+            if (alias == NoNode)
+                break;
+#if ENABLE(DFG_DEBUG_VERBOSE)
+            printf("  aliases @%u", alias);
+#endif
+            m_graph.ref(alias);
+            node.children.fixed.child3 = alias;
+            break;
+        }
+
+        case PutByVal:
+            if (getByValLoadElimination(node.child1(), node.child2()) != NoNode) {
+#if ENABLE(DFG_DEBUG_VERBOSE)
+                printf("  -> PutByValAlias");
+#endif
+                node.op = PutByValAlias;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("\n");
+#endif
+    }
+
+    void performBlockCSE(BasicBlock& block)
+    {
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("Performing CSE on block starting at bc#%u\n", block.bytecodeBegin);
+#endif
+        m_start = block.begin;
+        for (m_compileIndex = block.begin; m_compileIndex < block.end; ++m_compileIndex)
+            performNodeCSE(m_graph[m_compileIndex]);
+    }
+
+    Graph& m_graph;
+
+    NodeIndex m_start;
+    NodeIndex m_compileIndex;
+
+    Vector<NodeIndex, 16> m_replacements;
+};
+
+void performCSE(Graph& graph)
+{
+    CSE cse(graph);
+    cse.run();
+}
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
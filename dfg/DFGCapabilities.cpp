@@ -28,11 +28,18 @@
 
 #include "CodeBlock.h"
 #include "Interpreter.h"
+#include "JITDiagnostics.h"
 
 namespace JSC { namespace DFG {
 
 #if ENABLE(DFG_JIT)
 
+static void reportUnsupportedOpcode(CodeBlock* codeBlock, OpcodeID opcodeID, unsigned bytecodeOffset)
+{
+    if (JITDiagnostics::isEnabled())
+        JITDiagnostics::log(codeBlock, "not optimized: %s at bc#%u is not supported", opcodeNames[opcodeID], bytecodeOffset);
+}
+
 bool canCompileOpcodes(CodeBlock* codeBlock)
 {
     Interpreter* interpreter = codeBlock->globalData()->interpreter;
@@ -41,11 +48,13 @@ bool canCompileOpcodes(CodeBlock* codeBlock)
     
     for (unsigned bytecodeOffset = 0; bytecodeOffset < instructionCount; ) {
         switch (interpreter->getOpcodeID(instructionsBegin[bytecodeOffset].u.opcode)) {
-#define DEFINE_OP(opcode, length)           \
-        case opcode:                        \
-            if (!canCompileOpcode(opcode))  \
-                return false;               \
-            bytecodeOffset += length;       \
+#define DEFINE_OP(opcode, length)                                           \
+        case opcode:                                                        \
+            if (!canCompileOpcode(opcode)) {                                \
+                reportUnsupportedOpcode(codeBlock, opcode, bytecodeOffset); \
+                return false;                                               \
+            }                                                               \
+            bytecodeOffset += length;                                       \
             break;
             FOR_EACH_OPCODE_ID(DEFINE_OP)
 #undef DEFINE_OP
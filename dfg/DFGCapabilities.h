@@ -67,6 +67,10 @@ inline bool canCompileOpcode(OpcodeID opcodeID)
     case op_check_has_instance:
     case op_instanceof:
     case op_not:
+    case op_is_undefined:
+    case op_is_boolean:
+    case op_is_number:
+    case op_is_string:
     case op_less:
     case op_lesseq:
     case op_greater:
@@ -84,6 +88,10 @@ inline bool canCompileOpcode(OpcodeID opcodeID)
     case op_put_by_id:
     case op_get_global_var:
     case op_put_global_var:
+    case op_get_scoped_var:
+    case op_put_scoped_var:
+    case op_new_object:
+    case op_new_array:
     case op_jmp:
     case op_loop:
     case op_jtrue:
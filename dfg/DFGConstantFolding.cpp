@@ -0,0 +1,369 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "config.h"
+#include "DFGConstantFolding.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "CodeBlock.h"
+#include "DFGGraph.h"
+#include <wtf/MathExtras.h>
+
+namespace JSC { namespace DFG {
+
+// === ConstantFolding ===
+//
+// This class folds nodes whose operands are all JSConstants into JSConstants of
+// their own, visiting nodes in order so that chains of folds resolve in one
+// pass. A Branch on a constant then becomes a Jump, and blocks that can no
+// longer be reached from the entry block (or from an OSR entry point) have
+// their nodes killed. Nothing dead is removed from the graph: nodes that lose
+// their last reference are simply not generated, which is all the dead-code
+// elimination the code generators need. Values only flow between blocks
+// through locals, which we do not track, so only constants within a block are
+// seen; operations that need an ExecState to evaluate (e.g. on strings) are
+// left alone.
+class ConstantFolding {
+public:
+    ConstantFolding(Graph& graph, CodeBlock* codeBlock)
+        : m_graph(graph)
+        , m_codeBlock(codeBlock)
+        , m_changedControlFlow(false)
+    {
+    }
+
+    void run()
+    {
+        for (m_compileIndex = 0; m_compileIndex < m_graph.size(); ++m_compileIndex)
+            foldNode(m_graph[m_compileIndex]);
+
+        if (m_changedControlFlow)
+            killUnreachableBlocks();
+    }
+
+private:
+    bool isConstant(NodeIndex nodeIndex)
+    {
+        return nodeIndex != NoNode && m_graph[nodeIndex].isConstant();
+    }
+
+    JSValue valueOfConstant(NodeIndex nodeIndex)
+    {
+        return m_graph[nodeIndex].valueOfJSConstant(m_codeBlock);
+    }
+
+    // Returns the index of a constant register holding the value, adding one if needed.
+    unsigned constantNumberFor(JSValue value)
+    {
+        unsigned numberOfConstants = m_codeBlock->numberOfConstantRegisters();
+        for (unsigned constant = 0; constant < numberOfConstants; ++constant) {
+            if (JSValue::encode(m_codeBlock->getConstant(FirstConstantRegisterIndex + constant)) == JSValue::encode(value))
+                return constant;
+        }
+        m_codeBlock->addConstant(value);
+        return numberOfConstants;
+    }
+
+    // Computes the value of a pure node whose children are all constants, if we can.
+    bool evaluate(Node& node, JSValue& result)
+    {
+        if (!isConstant(node.child1()) || node.child3() != NoNode)
+            return false;
+        JSValue left = valueOfConstant(node.child1());
+
+        if (node.child2() == NoNode) {
+            switch (node.op) {
+            case UInt32ToNumber:
+                if (!left.isInt32())
+                    return false;
+                result = jsNumber(static_cast<uint32_t>(left.asInt32()));
+                return true;
+            case LogicalNot:
+                if (left.isBoolean())
+                    result = jsBoolean(!left.getBoolean());
+                else if (left.isNumber())
+                    result = jsBoolean(!left.uncheckedGetNumber() || isnan(left.uncheckedGetNumber()));
+                else
+                    return false;
+                return true;
+            case IsUndefined:
+                // A constant cell could masquerade as undefined; leave those to the code.
+                if (left.isCell())
+                    return false;
+                result = jsBoolean(left.isUndefined());
+                return true;
+            case IsBoolean:
+                result = jsBoolean(left.isBoolean());
+                return true;
+            case IsNumber:
+                result = jsBoolean(left.isNumber());
+                return true;
+            case IsString:
+                result = jsBoolean(left.isString());
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        if (!isConstant(node.child2()))
+            return false;
+        JSValue right = valueOfConstant(node.child2());
+
+        switch (node.op) {
+        case BitAnd:
+        case BitOr:
+        case BitXor:
+        case BitLShift:
+        case BitRShift:
+        case BitURShift: {
+            if (!left.isInt32() || !right.isInt32())
+                return false;
+            int32_t a = left.asInt32();
+            int32_t b = right.asInt32();
+            int32_t value;
+            switch (node.op) {
+            case BitAnd:
+                value = a & b;
+                break;
+            case BitOr:
+                value = a | b;
+                break;
+            case BitXor:
+                value = a ^ b;
+                break;
+            case BitLShift:
+                value = a << (b & 0x1f);
+                break;
+            case BitRShift:
+                value = a >> (b & 0x1f);
+                break;
+            default:
+                // The result is boxed by a subsequent UInt32ToNumber.
+                value = static_cast<int32_t>(static_cast<uint32_t>(a) >> (b & 0x1f));
+                break;
+            }
+            result = jsNumber(value);
+            return true;
+        }
+
+        case ArithAdd:
+        case ArithSub:
+        case ArithMul:
+        case ArithDiv:
+        case ArithMod: {
+            if (!left.isNumber() || !right.isNumber())
+                return false;
+            double a = left.uncheckedGetNumber();
+            double b = right.uncheckedGetNumber();
+            double value;
+            switch (node.op) {
+            case ArithAdd:
+                value = a + b;
+                break;
+            case ArithSub:
+                value = a - b;
+                break;
+            case ArithMul:
+                value = a * b;
+                break;
+            case ArithDiv:
+                value = a / b;
+                break;
+            default:
+                value = fmod(a, b);
+                break;
+            }
+            result = jsNumber(value);
+            return true;
+        }
+
+        case CompareLess:
+        case CompareLessEq:
+        case CompareGreater:
+        case CompareGreaterEq:
+        case CompareEq:
+        case CompareStrictEq: {
+            if (left.isBoolean() && right.isBoolean() && (node.op == CompareEq || node.op == CompareStrictEq)) {
+                result = jsBoolean(left.getBoolean() == right.getBoolean());
+                return true;
+            }
+            if (!left.isNumber() || !right.isNumber())
+                return false;
+            double a = left.uncheckedGetNumber();
+            double b = right.uncheckedGetNumber();
+            bool value;
+            switch (node.op) {
+            case CompareLess:
+                value = a < b;
+                break;
+            case CompareLessEq:
+                value = a <= b;
+                break;
+            case CompareGreater:
+                value = a > b;
+                break;
+            case CompareGreaterEq:
+                value = a >= b;
+                break;
+            default:
+                value = a == b;
+                break;
+            }
+            result = jsBoolean(value);
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    // Drop the node's references to its children, which it no longer uses.
+    void derefChildren(Node& node)
+    {
+        NodeIndex child1 = node.child1();
+        NodeIndex child2 = node.child2();
+        node.children.fixed.child1 = NoNode;
+        node.children.fixed.child2 = NoNode;
+        node.children.fixed.child3 = NoNode;
+        if (child1 != NoNode)
+            m_graph.deref(child1);
+        if (child2 != NoNode)
+            m_graph.deref(child2);
+    }
+
+    void foldNode(Node& node)
+    {
+        if (!node.shouldGenerate() || (node.op & NodeHasVarArgs))
+            return;
+
+        if (node.op == Branch) {
+            if (!isConstant(node.child1()))
+                return;
+            JSValue condition = valueOfConstant(node.child1());
+            bool taken;
+            if (condition.isBoolean())
+                taken = condition.getBoolean();
+            else if (condition.isInt32())
+                taken = condition.asInt32();
+            else if (condition.isUndefinedOrNull())
+                taken = false;
+            else
+                return;
+
+#if ENABLE(DFG_DEBUG_VERBOSE)
+            printf("  @%u -> Jump\n", m_compileIndex);
+#endif
+            unsigned target = taken ? node.takenBytecodeOffset() : node.notTakenBytecodeOffset();
+            derefChildren(node);
+            // Both are 'mustGenerate', so the node keeps its reference on itself.
+            m_graph[m_compileIndex] = Node(DFG::Jump, node.codeOrigin, OpInfo(target));
+            m_graph[m_compileIndex].ref();
+            m_changedControlFlow = true;
+            return;
+        }
+
+        JSValue value;
+        if (!evaluate(node, value))
+            return;
+
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("  @%u -> JSConstant\n", m_compileIndex);
+#endif
+        unsigned refCount = node.refCount();
+        if (node.mustGenerate())
+            --refCount;
+        derefChildren(node);
+        m_graph[m_compileIndex] = Node(JSConstant, node.codeOrigin, OpInfo(constantNumberFor(value)));
+        for (unsigned i = 0; i < refCount; ++i)
+            m_graph[m_compileIndex].ref();
+    }
+
+    void killUnreachableBlocks()
+    {
+        Vector<bool, 16> reachable(m_graph.m_blocks.size());
+        Vector<BlockIndex, 16> worklist;
+        for (BlockIndex block = 0; block < m_graph.m_blocks.size(); ++block) {
+            reachable[block] = !block || m_graph.m_blocks[block]->isOSRTarget;
+            if (reachable[block])
+                worklist.append(block);
+        }
+
+        while (!worklist.isEmpty()) {
+            BasicBlock& block = *m_graph.m_blocks[worklist.last()];
+            worklist.removeLast();
+
+            Node& terminal = m_graph[block.end - 1];
+            ASSERT(terminal.isTerminal());
+            if (terminal.isJump() || terminal.isBranch())
+                markReachable(terminal.takenBytecodeOffset(), reachable, worklist);
+            if (terminal.isBranch())
+                markReachable(terminal.notTakenBytecodeOffset(), reachable, worklist);
+        }
+
+        for (BlockIndex blockIndex = 0; blockIndex < m_graph.m_blocks.size(); ++blockIndex) {
+            if (reachable[blockIndex])
+                continue;
+            BasicBlock& block = *m_graph.m_blocks[blockIndex];
+#if ENABLE(DFG_DEBUG_VERBOSE)
+            printf("Killing unreachable block starting at bc#%u\n", block.bytecodeBegin);
+#endif
+            // Dropping the self-references of the 'mustGenerate' nodes releases everything
+            // they kept alive. Values still referenced by a Phi in a reachable block stay
+            // alive; the code generated for them is never executed.
+            for (NodeIndex index = block.begin; index < block.end; ++index) {
+                Node& node = m_graph[index];
+                if (node.mustGenerate() && node.shouldGenerate())
+                    m_graph.deref(index);
+            }
+        }
+    }
+
+    void markReachable(unsigned bytecodeOffset, Vector<bool, 16>& reachable, Vector<BlockIndex, 16>& worklist)
+    {
+        BlockIndex block = m_graph.blockIndexForBytecodeOffset(bytecodeOffset);
+        if (reachable[block])
+            return;
+        reachable[block] = true;
+        worklist.append(block);
+    }
+
+    Graph& m_graph;
+    CodeBlock* m_codeBlock;
+
+    NodeIndex m_compileIndex;
+    bool m_changedControlFlow;
+};
+
+void performConstantFolding(Graph& graph, CodeBlock* codeBlock)
+{
+    ConstantFolding constantFolding(graph, codeBlock);
+    constantFolding.run();
+}
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
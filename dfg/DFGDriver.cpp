@@ -31,21 +31,51 @@
 #include "DFGByteCodeParser.h"
 #include "DFGJITCompiler.h"
 #include "DFGPropagator.h"
+#include "JITDiagnostics.h"
+#include "PauseTelemetry.h"
+#include "Tracing.h"
+#include <wtf/CurrentTime.h>
 
 namespace JSC { namespace DFG {
 
+static void logPredictions(Graph& dfg, CodeBlock* codeBlock)
+{
+    PredictionTracker& predictions = dfg.predictions();
+    for (unsigned i = 0; i < predictions.numberOfArguments(); ++i)
+        JITDiagnostics::log(codeBlock, "argument %u predicted %s", i, predictionToString(predictions.getArgumentPrediction(i)));
+    for (unsigned i = 0; i < predictions.numberOfVariables(); ++i)
+        JITDiagnostics::log(codeBlock, "variable r%u predicted %s", i, predictionToString(predictions.getPrediction(i)));
+    
+    for (NodeIndex nodeIndex = 0; nodeIndex < dfg.size(); ++nodeIndex) {
+        Node& node = dfg[nodeIndex];
+        if (!node.shouldGenerate() || !node.hasPrediction())
+            continue;
+        JITDiagnostics::log(codeBlock, "bc#%u %s predicted %s", node.codeOrigin.bytecodeIndex(), Graph::opName(node.op), predictionToString(node.getPrediction()));
+    }
+}
+
 enum CompileMode { CompileFunction, CompileOther };
 inline bool compile(CompileMode compileMode, ExecState* exec, ExecState* calleeArgsExec, CodeBlock* codeBlock, JITCode& jitCode, MacroAssemblerCodePtr* jitCodeWithArityCheck)
 {
+    double startTime = currentTime();
+    PauseScope pause(CompilationPause, CompilationStatistics::DFGJITTier, 0);
+    JAVASCRIPTCORE_JIT_COMPILE_BEGIN(codeBlock, 1);
+
     JSGlobalData* globalData = &exec->globalData();
     Graph dfg(codeBlock->m_numParameters, codeBlock->m_numVars);
-    if (!parse(dfg, globalData, codeBlock))
+    if (!parse(dfg, globalData, codeBlock)) {
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock, "not optimized: the bytecode parser gave up");
+        JAVASCRIPTCORE_JIT_COMPILE_END(codeBlock, 1, 0);
         return false;
+    }
     
     if (compileMode == CompileFunction)
         dfg.predictArgumentTypes(calleeArgsExec, codeBlock);
     
     propagate(dfg, globalData, codeBlock);
+    if (JITDiagnostics::isEnabled())
+        logPredictions(dfg, codeBlock);
     
 #if ENABLE(DYNAMIC_OPTIMIZATION)
     // Save the predictions we've made, so that OSR entry can verify them. Predictions
@@ -69,6 +99,14 @@ inline bool compile(CompileMode compileMode, ExecState* exec, ExecState* calleeA
         
         dataFlowJIT.compile(jitCode);
     }
+
+    JAVASCRIPTCORE_JIT_COMPILE_END(codeBlock, 1, jitCode.size());
+
+    // Parses that fail are not counted; they are cheap and leave no code behind.
+    double compileTime = currentTime() - startTime;
+    codeBlock->didGenerateMachineCode(compileTime);
+    globalData->compilationStatistics.record(CompilationStatistics::DFGJITTier, compileTime, jitCode.size());
+    pause.setBytes(jitCode.size());
     return true;
 }
 
@@ -72,6 +72,13 @@ public:
         return registerForIndex[index];
     }
 
+    // Values held in registers preserved by the C calling convention survive calls
+    // out to operations, so need not be saved and restored around them.
+    static bool isCalleeSave(GPRReg reg)
+    {
+        return reg == regT3;
+    }
+
     static unsigned toIndex(GPRReg reg)
     {
         ASSERT(reg != InvalidGPRReg);
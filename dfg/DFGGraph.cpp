@@ -32,8 +32,6 @@
 
 namespace JSC { namespace DFG {
 
-#ifndef NDEBUG
-
 // Creates an array of stringized names.
 static const char* dfgOpNames[] = {
 #define STRINGIZE_DFG_OP_ENUM(opcode, flags) #opcode ,
@@ -46,6 +44,8 @@ const char *Graph::opName(NodeType op)
     return dfgOpNames[op & NodeIdMask];
 }
 
+#ifndef NDEBUG
+
 void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
 {
     Node& node = at(nodeIndex);
@@ -76,6 +76,7 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
     //         $#   - the index in the CodeBlock of a constant { for numeric constants the value is displayed | for integers, in both decimal and hex }.
     //         id#  - the index in the CodeBlock of an identifier { if codeBlock is passed to dump(), the string representation is displayed }.
     //         var# - the index of a var on the global object, used by GetGlobalVar/PutGlobalVar operations.
+    //         skip# - the scope chain depth of a var, used by GetScopedVar/PutScopedVar operations.
     printf("% 4d:%s<%c%u:", (int)nodeIndex, skipped ? "  skipped  " : "           ", mustGenerate ? '!' : ' ', refCount);
     if (node.hasResult() && !skipped)
         printf("%u", node.virtualRegister());
@@ -105,6 +106,10 @@ void Graph::dump(NodeIndex nodeIndex, CodeBlock* codeBlock)
         printf("%svar%u", hasPrinted ? ", " : "", node.varNumber());
         hasPrinted = true;
     }
+    if (node.hasScopedVar()) {
+        printf("%svar%u, skip%u", hasPrinted ? ", " : "", node.scopedVarIndex(), node.scopeChainDepth());
+        hasPrinted = true;
+    }
     if (node.hasIdentifier()) {
         if (codeBlock)
             printf("%sid%u{%s}", hasPrinted ? ", " : "", node.identifierNumber(), codeBlock->identifier(node.identifierNumber()).ustring().utf8().data());
@@ -193,6 +198,32 @@ void Graph::refChildren(NodeIndex op)
     }
 }
 
+void Graph::derefChildren(NodeIndex op)
+{
+    Node& node = at(op);
+
+    if (node.op & NodeHasVarArgs) {
+        for (unsigned childIdx = node.firstChild(); childIdx < node.firstChild() + node.numChildren(); childIdx++)
+            deref(m_varArgChildren[childIdx]);
+    } else {
+        if (node.child1() == NoNode) {
+            ASSERT(node.child2() == NoNode && node.child3() == NoNode);
+            return;
+        }
+        deref(node.child1());
+
+        if (node.child2() == NoNode) {
+            ASSERT(node.child3() == NoNode);
+            return;
+        }
+        deref(node.child2());
+
+        if (node.child3() == NoNode)
+            return;
+        deref(node.child3());
+    }
+}
+
 void Graph::predictArgumentTypes(ExecState* exec, CodeBlock* codeBlock)
 {
     if (exec) {
@@ -107,6 +107,15 @@ public:
             refChildren(nodeIndex);
     }
 
+    // Drop a reference to a node.
+    void deref(NodeIndex nodeIndex)
+    {
+        Node& node = at(nodeIndex);
+        // If the value (after decrementing) is at refCount zero then we need to deref its children.
+        if (node.deref())
+            derefChildren(nodeIndex);
+    }
+
 #ifndef NDEBUG
     // CodeBlock is optional, but may allow additional information to be dumped (e.g. Identifier names).
     void dump(CodeBlock* = 0);
@@ -152,6 +161,8 @@ public:
             break;
         case GetById:
         case GetMethod:
+        case GetArrayLength:
+        case GetStringLength:
         case GetByVal:
         case Call:
         case Construct:
@@ -188,6 +199,8 @@ public:
             return getGlobalVarPrediction(nodePtr->varNumber());
         case GetById:
         case GetMethod:
+        case GetArrayLength:
+        case GetStringLength:
         case GetByVal:
         case Call:
         case Construct:
@@ -240,9 +253,7 @@ public:
         return at(nodeIndex).valueOfBooleanConstant(codeBlock);
     }
 
-#ifndef NDEBUG
     static const char *opName(NodeType);
-#endif
 
     void predictArgumentTypes(ExecState*, CodeBlock*);
 
@@ -252,6 +263,7 @@ private:
 
     // When a node's refCount goes from 0 to 1, it must (logically) recursively ref all of its children, and vice versa.
     void refChildren(NodeIndex);
+    void derefChildren(NodeIndex);
 
     PredictionTracker m_predictions;
 };
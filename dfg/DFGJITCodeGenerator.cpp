@@ -495,6 +495,13 @@ void JITCodeGenerator::writeBarrier(MacroAssembler& jit, GPRReg owner, GPRReg sc
 #if ENABLE(WRITE_BARRIER_PROFILING)
     JITCompiler::emitCount(jit, WriteBarrierCounters::jitCounterFor(useKind));
 #endif
+
+#if ENABLE(GGC)
+    // See JIT::emitWriteBarrier().
+    jit.move(owner, scratch);
+    jit.andPtr(MacroAssembler::TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+    jit.store32(MacroAssembler::TrustedImm32(1), MacroAssembler::Address(scratch, MarkedBlock::offsetOfIsRemembered()));
+#endif
 }
 
 void JITCodeGenerator::cachedPutById(GPRReg baseGPR, GPRReg valueGPR, GPRReg scratchGPR, unsigned identifierNumber, PutKind putKind, JITCompiler::Jump slowPathTarget)
@@ -1065,6 +1072,51 @@ void JITCodeGenerator::nonSpeculativeLogicalNot(Node& node)
     jsValueResult(resultGPR, m_compileIndex, DataFormatJSBoolean, UseChildrenCalledExplicitly);
 }
 
+void JITCodeGenerator::nonSpeculativeIsType(Node& node)
+{
+    JSValueOperand value(this, node.child1());
+    GPRTemporary result(this);
+
+    GPRReg valueGPR = value.gpr();
+    GPRReg resultGPR = result.gpr();
+
+    JITCompiler::JumpList isType;
+    JITCompiler::JumpList notType;
+
+    switch (node.op) {
+    case IsUndefined:
+        isType.append(m_jit.branchPtr(JITCompiler::Equal, valueGPR, JITCompiler::TrustedImmPtr(JSValue::encode(jsUndefined()))));
+        notType.append(m_jit.branchTestPtr(JITCompiler::NonZero, valueGPR, GPRInfo::tagMaskRegister));
+        m_jit.loadPtr(JITCompiler::Address(valueGPR, JSCell::structureOffset()), resultGPR);
+        isType.append(m_jit.branchTest8(JITCompiler::NonZero, JITCompiler::Address(resultGPR, Structure::typeInfoFlagsOffset()), JITCompiler::TrustedImm32(MasqueradesAsUndefined)));
+        break;
+    case IsBoolean:
+        m_jit.move(valueGPR, resultGPR);
+        m_jit.xorPtr(TrustedImm32(static_cast<int32_t>(ValueFalse)), resultGPR);
+        isType.append(m_jit.branchTestPtr(JITCompiler::Zero, resultGPR, TrustedImm32(static_cast<int32_t>(~1))));
+        break;
+    case IsNumber:
+        isType.append(m_jit.branchTestPtr(JITCompiler::NonZero, valueGPR, GPRInfo::tagTypeNumberRegister));
+        break;
+    case IsString:
+        notType.append(m_jit.branchTestPtr(JITCompiler::NonZero, valueGPR, GPRInfo::tagMaskRegister));
+        isType.append(m_jit.branchPtr(JITCompiler::Equal, JITCompiler::Address(valueGPR), JITCompiler::TrustedImmPtr(m_jit.globalData()->jsStringVPtr)));
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+    }
+
+    notType.link(&m_jit);
+    m_jit.move(JITCompiler::TrustedImmPtr(JSValue::encode(jsBoolean(false))), resultGPR);
+    JITCompiler::Jump done = m_jit.jump();
+
+    isType.link(&m_jit);
+    m_jit.move(JITCompiler::TrustedImmPtr(JSValue::encode(jsBoolean(true))), resultGPR);
+
+    done.link(&m_jit);
+    jsValueResult(resultGPR, m_compileIndex, DataFormatJSBoolean);
+}
+
 void JITCodeGenerator::emitCall(Node& node)
 {
     P_DFGOperation_E slowCallFunction;
@@ -1151,6 +1203,87 @@ void JITCodeGenerator::emitCall(Node& node)
     m_jit.addJSCall(fastCall, slowCall, targetToCheck, isCall, m_jit.graph()[m_compileIndex].codeOrigin);
 }
 
+void JITCodeGenerator::emitNewArray(Node& node)
+{
+    // The elements are stored to the parameter slots at the top of the register
+    // file, where the allocation reads them as its argument list.
+    int numElements = node.numChildren();
+    for (int elementIdx = 0; elementIdx < numElements; elementIdx++) {
+        NodeIndex elementNodeIndex = m_jit.graph().m_varArgChildren[node.firstChild() + elementIdx];
+        JSValueOperand element(this, elementNodeIndex);
+        GPRReg elementGPR = element.gpr();
+        use(elementNodeIndex);
+
+        m_jit.storePtr(elementGPR, addressOfCallData(-numElements + elementIdx));
+    }
+
+    flushRegisters();
+
+    GPRResult result(this);
+    m_jit.addPtr(Imm32((m_jit.codeBlock()->m_numCalleeRegisters - numElements) * sizeof(Register)), GPRInfo::callFrameRegister, GPRInfo::argumentGPR1);
+    callOperation(operationNewArray, result.gpr(), GPRInfo::argumentGPR1, numElements, &m_jit.codeBlock()->allocationSiteProfile(node.allocationSiteProfileIndex()));
+
+    jsValueResult(result.gpr(), m_compileIndex, DataFormatJSCell, UseChildrenCalledExplicitly);
+}
+
+void JITCodeGenerator::emitAllocateJSFinalObject(MacroAssembler::TrustedImmPtr structure, GPRReg resultGPR, GPRReg scratchGPR, MacroAssembler::JumpList& slowPath)
+{
+    NewSpace::SizeClass* sizeClass = &m_jit.globalData()->heap.sizeClassFor(sizeof(JSFinalObject));
+    m_jit.loadPtr(&sizeClass->firstFreeCell, resultGPR);
+    MacroAssembler::Jump popFreeList = m_jit.branchTestPtr(MacroAssembler::NonZero, resultGPR);
+
+    // There is no free list, so bump allocate out of a fresh block.
+    m_jit.loadPtr(&sizeClass->bumpPointer, resultGPR);
+    m_jit.loadPtr(&sizeClass->bumpEnd, scratchGPR);
+    slowPath.append(m_jit.branchPtr(MacroAssembler::AboveOrEqual, resultGPR, scratchGPR));
+    m_jit.addPtr(MacroAssembler::TrustedImm32(static_cast<int32_t>(sizeClass->cellSize)), resultGPR, scratchGPR);
+    m_jit.storePtr(scratchGPR, &sizeClass->bumpPointer);
+    MacroAssembler::Jump initialize = m_jit.jump();
+
+    popFreeList.link(&m_jit);
+    m_jit.loadPtr(MacroAssembler::Address(resultGPR), scratchGPR);
+    m_jit.storePtr(scratchGPR, &sizeClass->firstFreeCell);
+
+    initialize.link(&m_jit);
+    m_jit.storePtr(MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsFinalObjectVPtr), MacroAssembler::Address(resultGPR));
+    m_jit.storePtr(structure, MacroAssembler::Address(resultGPR, JSCell::structureOffset()));
+    m_jit.storePtr(MacroAssembler::TrustedImmPtr(0), MacroAssembler::Address(resultGPR, JSObject::offsetOfInheritorID()));
+    m_jit.addPtr(MacroAssembler::TrustedImm32(sizeof(JSObject)), resultGPR, scratchGPR);
+    m_jit.storePtr(scratchGPR, MacroAssembler::Address(resultGPR, JSFinalObject::offsetOfPropertyStorage()));
+}
+
+void JITCodeGenerator::emitNewObject(Node& node)
+{
+    AllocationSiteProfile* profile = &m_jit.codeBlock()->allocationSiteProfile(node.allocationSiteProfileIndex());
+
+    GPRTemporary result(this);
+    GPRTemporary scratch(this);
+    GPRReg resultGPR = result.gpr();
+    GPRReg scratchGPR = scratch.gpr();
+
+    MacroAssembler::JumpList slowPath;
+#if ENABLE(GGC)
+    // Lets the operation sample or pretenure the site once its countdown runs out, as the
+    // baseline JIT's op_new_object does.
+    m_jit.move(MacroAssembler::TrustedImmPtr(&profile->countdown), scratchGPR);
+    m_jit.sub32(MacroAssembler::TrustedImm32(1), MacroAssembler::Address(scratchGPR));
+    slowPath.append(m_jit.branch32(MacroAssembler::LessThanOrEqual, MacroAssembler::Address(scratchGPR), MacroAssembler::TrustedImm32(0)));
+#endif
+    emitAllocateJSFinalObject(MacroAssembler::TrustedImmPtr(m_jit.codeBlock()->globalObject()->emptyObjectStructure()), resultGPR, scratchGPR, slowPath);
+    MacroAssembler::Jump done = m_jit.jump();
+
+    slowPath.link(&m_jit);
+    silentSpillAllRegisters(resultGPR);
+    m_jit.move(MacroAssembler::TrustedImmPtr(profile), GPRInfo::argumentGPR1);
+    m_jit.move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
+    appendCallWithExceptionCheck(operationNewObject);
+    m_jit.move(GPRInfo::returnValueGPR, resultGPR);
+    silentFillAllRegisters(resultGPR);
+
+    done.link(&m_jit);
+    jsValueResult(resultGPR, m_compileIndex, DataFormatJSCell);
+}
+
 void JITCodeGenerator::speculationCheck(MacroAssembler::Jump jumpToFail)
 {
     ASSERT(m_isSpeculative);
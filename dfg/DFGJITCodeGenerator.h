@@ -217,7 +217,7 @@ protected:
         ASSERT(info.registerFormat() != DataFormatNone);
         ASSERT(info.registerFormat() != DataFormatDouble);
 
-        if (!info.needsSpill() || (info.gpr() == exclude))
+        if (!info.needsSpill() || (info.gpr() == exclude) || GPRInfo::isCalleeSave(info.gpr()))
             return;
 
         DataFormat registerFormat = info.registerFormat();
@@ -252,7 +252,7 @@ protected:
     void silentFillGPR(VirtualRegister spillMe, GPRReg exclude = InvalidGPRReg)
     {
         GenerationInfo& info = m_generationInfo[spillMe];
-        if (info.gpr() == exclude)
+        if (info.gpr() == exclude || GPRInfo::isCalleeSave(info.gpr()))
             return;
 
         NodeIndex nodeIndex = info.nodeIndex();
@@ -580,6 +580,7 @@ protected:
     void emitBranch(Node&);
     
     void nonSpeculativeLogicalNot(Node&);
+    void nonSpeculativeIsType(Node&);
     
     MacroAssembler::Address addressOfCallData(int idx)
     {
@@ -587,6 +588,12 @@ protected:
     }
     
     void emitCall(Node&);
+    void emitNewArray(Node&);
+    void emitNewObject(Node&);
+
+    // Allocates a JSFinalObject from its size class's free list or bump pointer, as the baseline
+    // JIT does, and adds a jump to slowPath for when neither has a cell to give.
+    void emitAllocateJSFinalObject(MacroAssembler::TrustedImmPtr structure, GPRReg resultGPR, GPRReg scratchGPR, MacroAssembler::JumpList& slowPath);
     
     void speculationCheck(MacroAssembler::Jump jumpToFail);
 
@@ -837,6 +844,18 @@ protected:
     {
         callOperation((J_DFGOperation_EJP)operation, result, arg1, identifier);
     }
+    void callOperation(J_DFGOperation_EPSP operation, GPRReg result, GPRReg arg1, size_t size, void* pointer)
+    {
+        ASSERT(isFlushed());
+
+        m_jit.move(arg1, GPRInfo::argumentGPR1);
+        m_jit.move(JITCompiler::TrustedImm32(static_cast<int32_t>(size)), GPRInfo::argumentGPR2);
+        m_jit.move(JITCompiler::TrustedImmPtr(pointer), GPRInfo::argumentGPR3);
+        m_jit.move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
+
+        appendCallWithExceptionCheck(operation);
+        m_jit.move(GPRInfo::returnValueGPR, result);
+    }
     void callOperation(J_DFGOperation_EJ operation, GPRReg result, GPRReg arg1)
     {
         ASSERT(isFlushed());
@@ -34,8 +34,11 @@
 #include "DFGOperations.h"
 #include "DFGRegisterBank.h"
 #include "DFGSpeculativeJIT.h"
+#include "JITCodeLog.h"
+#include "JITDiagnostics.h"
 #include "JSGlobalData.h"
 #include "LinkBuffer.h"
+#include "Tracing.h"
 
 namespace JSC { namespace DFG {
 
@@ -423,6 +426,23 @@ void JITCompiler::exitSpeculativeWithOSR(const OSRExit& exit, SpeculationRecover
     
     store32(Imm32(codeBlock()->alternative()->counterValueForOptimizeAfterWarmUp()), codeBlock()->alternative()->addressOfExecuteCounter());
     
+    //     The exit also counts against this code, so that the old JIT's next
+    //     optimization trigger can tell whether to jettison it and recompile
+    //     (see CodeBlock::shouldReoptimizeNow()).
+    
+    add32(TrustedImm32(1), AbsoluteAddress(codeBlock()->addressOfSpeculativeFailCounter()));
+
+    //     Every value is in the register file by now, so the exit can call
+    //     out to fire the probe, or to report itself. The call frame still
+    //     says it's optimized.
+
+    if (JAVASCRIPTCORE_OSR_EXIT_ENABLED() || JITDiagnostics::isEnabled()) {
+        move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
+        move(TrustedImm32(exit.m_bytecodeIndex), GPRInfo::argumentGPR1);
+        move(TrustedImmPtr(Graph::opName(m_graph[exit.m_nodeIndex].op)), GPRInfo::argumentGPR2);
+        appendCall(operationTraceOSRExit);
+    }
+    
     // 12) Load the result of the last bytecode operation into regT0.
     
     if (exit.m_lastSetOperand != std::numeric_limits<int>::max())
@@ -463,8 +483,13 @@ void JITCompiler::linkOSRExits(SpeculativeJIT& speculative)
     OSRExitVector::Iterator exitsIter = speculative.osrExits().begin();
     OSRExitVector::Iterator exitsEnd = speculative.osrExits().end();
     
+    if (JITDiagnostics::isEnabled())
+        JITDiagnostics::log(codeBlock(), "%u speculation checks", static_cast<unsigned>(speculative.osrExits().size()));
+    
     while (exitsIter != exitsEnd) {
         const OSRExit& exit = *exitsIter;
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock(), "speculation check at bc#%u in %s", exit.m_bytecodeIndex, Graph::opName(m_graph[exit.m_nodeIndex].op));
         exitSpeculativeWithOSR(exit, speculative.speculationRecovery(exit.m_recoveryIndex), decodedCodeMap);
         ++exitsIter;
     }
@@ -1004,7 +1029,7 @@ void JITCompiler::jumpFromSpeculativeToNonSpeculative(const SpeculationCheck& ch
         DataFormat dataFormat = check.m_gprInfo[index].format;
         VirtualRegister virtualRegister = graph()[nodeIndex].virtualRegister();
         
-        ASSERT(dataFormat == DataFormatInteger || DataFormatCell || dataFormat & DataFormatJS);
+        ASSERT(dataFormat == DataFormatInteger || dataFormat == DataFormatCell || dataFormat & DataFormatJS);
         if (dataFormat == DataFormatInteger)
             orPtr(GPRInfo::tagTypeNumberRegister, GPRInfo::toRegister(index));
         storePtr(GPRInfo::toRegister(index), addressFor(virtualRegister));
@@ -1237,6 +1262,9 @@ void JITCompiler::compileBody()
         linkSpeculationChecks(speculative, nonSpeculative);
 #endif
     } else {
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(m_codeBlock, "speculative compilation failed, compiling without speculation");
+        
         // If compilation through the SpeculativeJIT failed, throw away the code we generated.
         m_calls.clear();
         m_propertyAccesses.clear();
@@ -1347,7 +1375,7 @@ void JITCompiler::compile(JITCode& entry)
     // Link
     LinkBuffer linkBuffer(*m_globalData, this);
     link(linkBuffer);
-    entry = JITCode(linkBuffer.finalizeCode(), JITCode::DFGJIT);
+    entry = JITCode(linkBuffer.finalizeCode(JITCodeLog::isEnabled() ? JITCodeLog::describe(m_codeBlock, "DFG").data() : 0), JITCode::DFGJIT);
 }
 
 void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWithArityCheck)
@@ -1411,7 +1439,7 @@ void JITCompiler::compileFunction(JITCode& entry, MacroAssemblerCodePtr& entryWi
     linkBuffer.link(callArityCheck, m_codeBlock->m_isConstructor ? cti_op_construct_arityCheck : cti_op_call_arityCheck);
 
     entryWithArityCheck = linkBuffer.locationOf(arityCheck);
-    entry = JITCode(linkBuffer.finalizeCode(), JITCode::DFGJIT);
+    entry = JITCode(linkBuffer.finalizeCode(JITCodeLog::isEnabled() ? JITCodeLog::describe(m_codeBlock, "DFG").data() : 0), JITCode::DFGJIT);
 }
 
 #if ENABLE(DFG_JIT_ASSERT)
@@ -198,9 +198,13 @@ public:
         m_calls.append(CallRecord(call, FunctionPtr(), codeOrigin));
     }
 
+    // Calls out from JIT code record the frame in topCallFrame first, as the
+    // baseline JIT's stub calls do, so that the callee can find the stack.
+
     // Add a call out from JIT code, without an exception check.
     void appendCall(const FunctionPtr& function)
     {
+        storePtr(GPRInfo::callFrameRegister, &globalData()->topCallFrame);
         m_calls.append(CallRecord(call(), function));
         // FIXME: should be able to JIT_ASSERT here that globalData->exception is null on return back to JIT code.
     }
@@ -208,6 +212,7 @@ public:
     // Add a call out from JIT code, with an exception check.
     Call appendCallWithExceptionCheck(const FunctionPtr& function, CodeOrigin codeOrigin)
     {
+        storePtr(GPRInfo::callFrameRegister, &globalData()->topCallFrame);
         Call functionCall = call();
         Jump exceptionCheck = branchTestPtr(NonZero, AbsoluteAddress(&globalData()->exception));
         m_calls.append(CallRecord(functionCall, function, exceptionCheck, codeOrigin));
@@ -217,6 +222,7 @@ public:
     // Add a call out from JIT code, with a fast exception check that tests if the return value is zero.
     Call appendCallWithFastExceptionCheck(const FunctionPtr& function, CodeOrigin codeOrigin)
     {
+        storePtr(GPRInfo::callFrameRegister, &globalData()->topCallFrame);
         Call functionCall = call();
         Jump exceptionCheck = branchTestPtr(Zero, GPRInfo::returnValueGPR);
         m_calls.append(CallRecord(functionCall, function, exceptionCheck, codeOrigin));
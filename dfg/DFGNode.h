@@ -126,6 +126,10 @@ private:
 #define NodeResultInt32   0x3000
 #define NodeResultBoolean 0x4000
 
+// Facts about arithmetic nodes (those with hasArithNodeFlags()) established by range analysis.
+#define NodeArithCannotOverflow        0x1 // the result always fits in an int32 when the operands are int32s.
+#define NodeArithCannotBeNegativeZero  0x2
+
 // This macro defines a set of information about all known node types, used to populate NodeId, NodeType below.
 #define FOR_EACH_DFG_OP(macro) \
     /* Nodes for constants. */\
@@ -175,8 +179,18 @@ private:
     macro(PutById, NodeMustGenerate) \
     macro(PutByIdDirect, NodeMustGenerate) \
     macro(GetMethod, NodeResultJS | NodeMustGenerate) \
+    /* GetById of 'length' on a value predicted to be an array or a string; */\
+    /* these are introduced by fixup and keep the GetById's identifier. */\
+    macro(GetArrayLength, NodeResultJS | NodeMustGenerate) \
+    macro(GetStringLength, NodeResultJS | NodeMustGenerate) \
     macro(GetGlobalVar, NodeResultJS | NodeMustGenerate) \
     macro(PutGlobalVar, NodeMustGenerate) \
+    macro(GetScopedVar, NodeResultJS | NodeMustGenerate) \
+    macro(PutScopedVar, NodeMustGenerate) \
+    \
+    /* Object and array literals. */\
+    macro(NewObject, NodeResultJS | NodeMustGenerate) \
+    macro(NewArray, NodeResultJS | NodeMustGenerate | NodeHasVarArgs) \
     \
     /* Nodes for comparison operations. */\
     macro(CompareLess, NodeResultBoolean | NodeMustGenerate) \
@@ -200,6 +214,10 @@ private:
     macro(CheckHasInstance, NodeMustGenerate) \
     macro(InstanceOf, NodeResultBoolean) \
     macro(LogicalNot, NodeResultBoolean) \
+    macro(IsUndefined, NodeResultBoolean) \
+    macro(IsBoolean, NodeResultBoolean) \
+    macro(IsNumber, NodeResultBoolean) \
+    macro(IsString, NodeResultBoolean) \
     \
     /* Block terminals. */\
     macro(Jump, NodeMustGenerate | NodeIsTerminal | NodeIsJump) \
@@ -242,6 +260,7 @@ struct Node {
         , codeOrigin(codeOrigin)
         , m_virtualRegister(InvalidVirtualRegister)
         , m_refCount(0)
+        , m_opInfo(0)
     {
         ASSERT(!(op & NodeHasVarArgs));
         children.fixed.child1 = child1;
@@ -373,6 +392,7 @@ struct Node {
     bool hasIdentifier()
     {
         return op == GetById || op == PutById || op == PutByIdDirect || op == GetMethod
+            || op == GetArrayLength || op == GetStringLength
             || op == Resolve || op == ResolveBase || op == ResolveBaseStrictPut;
     }
 #endif
@@ -394,6 +414,62 @@ struct Node {
         return m_opInfo;
     }
 
+    bool hasScopedVar()
+    {
+        return op == GetScopedVar || op == PutScopedVar;
+    }
+
+    // The index of the var in the variable object that holds it.
+    unsigned scopedVarIndex()
+    {
+        ASSERT(hasScopedVar());
+        return m_opInfo;
+    }
+
+    // The number of scope chain nodes to skip to reach the variable object.
+    unsigned scopeChainDepth()
+    {
+        ASSERT(hasScopedVar());
+        return m_opInfo2;
+    }
+
+    bool hasAllocationSiteProfile()
+    {
+        return op == NewObject || op == NewArray;
+    }
+
+    unsigned allocationSiteProfileIndex()
+    {
+        ASSERT(hasAllocationSiteProfile());
+        return m_opInfo;
+    }
+
+    bool hasArithNodeFlags()
+    {
+        switch (op) {
+        case ValueAdd:
+        case ArithAdd:
+        case ArithSub:
+        case ArithMul:
+        case UInt32ToNumber:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    unsigned arithNodeFlags()
+    {
+        ASSERT(hasArithNodeFlags());
+        return m_opInfo;
+    }
+
+    void setArithNodeFlags(unsigned flags)
+    {
+        ASSERT(hasArithNodeFlags());
+        m_opInfo = flags;
+    }
+
     bool hasResult()
     {
         return op & NodeResultMask;
@@ -451,6 +527,8 @@ struct Node {
         switch (op) {
         case GetById:
         case GetMethod:
+        case GetArrayLength:
+        case GetStringLength:
         case GetByVal:
         case Call:
         case Construct:
@@ -514,6 +592,13 @@ struct Node {
         return !m_refCount++;
     }
 
+    // returns true when ref count passes from 1 to 0.
+    bool deref()
+    {
+        ASSERT(m_refCount);
+        return !--m_refCount;
+    }
+
     unsigned adjustedRefCount()
     {
         return mustGenerate() ? m_refCount - 1 : m_refCount;
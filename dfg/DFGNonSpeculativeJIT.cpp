@@ -26,6 +26,7 @@
 #include "config.h"
 #include "DFGNonSpeculativeJIT.h"
 
+#include "Arguments.h"
 #include "DFGSpeculativeJIT.h"
 
 #if ENABLE(DFG_JIT)
@@ -763,7 +764,7 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         if (!isKnownInteger(node.child1()) || !isKnownInteger(node.child2())) {
             silentSpillAllRegisters(X86Registers::edx);
             setupTwoStubArgs<FPRInfo::argumentFPR0, FPRInfo::argumentFPR1>(op1FPR, op2FPR);
-            m_jit.appendCall(fmod);
+            m_jit.appendCall(static_cast<double (*)(double, double)>(fmod));
             boxDouble(FPRInfo::returnValueFPR, X86Registers::edx);
             silentFillAllRegisters(X86Registers::edx);
         }
@@ -782,6 +783,13 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         break;
     }
 
+    case IsUndefined:
+    case IsBoolean:
+    case IsNumber:
+    case IsString:
+        nonSpeculativeIsType(node);
+        break;
+
     case CompareLess:
         if (nonSpeculativeCompare(node, MacroAssembler::LessThan, operationCompareLess))
             return;
@@ -831,11 +839,13 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
 
         GPRTemporary storage(this);
         GPRTemporary cleanIndex(this);
+        GPRTemporary scratch(this);
 
         GPRReg baseGPR = base.gpr();
         GPRReg propertyGPR = property.gpr();
         GPRReg storageGPR = storage.gpr();
         GPRReg cleanIndexGPR = cleanIndex.gpr();
+        GPRReg scratchGPR = scratch.gpr();
         
         base.use();
         property.use();
@@ -844,25 +854,49 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
 
         JITCompiler::Jump propertyNotInt = m_jit.branchPtr(MacroAssembler::Below, propertyGPR, GPRInfo::tagTypeNumberRegister);
 
+        m_jit.zeroExtend32ToPtr(propertyGPR, cleanIndexGPR);
+
         // Get the array storage. We haven't yet checked this is a JSArray, so this is only safe if
         // an access with offset JSArray::storageOffset() is valid for all JSCells!
         m_jit.loadPtr(MacroAssembler::Address(baseGPR, JSArray::storageOffset()), storageGPR);
 
         JITCompiler::Jump baseNotArray = m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr));
 
-        m_jit.zeroExtend32ToPtr(propertyGPR, cleanIndexGPR);
-
         JITCompiler::Jump outOfBounds = m_jit.branch32(MacroAssembler::AboveOrEqual, cleanIndexGPR, MacroAssembler::Address(baseGPR, JSArray::vectorLengthOffset()));
 
         m_jit.loadPtr(MacroAssembler::BaseIndex(storageGPR, cleanIndexGPR, MacroAssembler::ScalePtr, OBJECT_OFFSETOF(ArrayStorage, m_vector[0])), storageGPR);
 
         JITCompiler::Jump loadFailed = m_jit.branchTestPtr(MacroAssembler::Zero, storageGPR);
 
-        JITCompiler::Jump done = m_jit.jump();
+        JITCompiler::JumpList done;
+        done.append(m_jit.jump());
+
+        // An Arguments object that escaped: read the argument from the registers it aliases, or
+        // from its copy of the extra arguments.
+        baseNotArray.link(&m_jit);
+        JITCompiler::JumpList notArgument;
+        notArgument.append(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR, JSCell::structureOffset()), MacroAssembler::TrustedImmPtr(m_jit.codeBlock()->globalObject()->argumentsStructure())));
+        m_jit.loadPtr(MacroAssembler::Address(baseGPR, Arguments::offsetOfData()), storageGPR);
+        notArgument.append(m_jit.branchTestPtr(MacroAssembler::NonZero, MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, deletedArguments))));
+        notArgument.append(m_jit.branch32(MacroAssembler::AboveOrEqual, cleanIndexGPR, MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, numArguments))));
+
+        JITCompiler::Jump isExtraArgument = m_jit.branch32(MacroAssembler::AboveOrEqual, cleanIndexGPR, MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, numParameters)));
+        m_jit.loadPtr(MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, firstParameterIndex)), scratchGPR);
+        m_jit.addPtr(cleanIndexGPR, scratchGPR);
+        m_jit.loadPtr(MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, registers)), storageGPR);
+        m_jit.loadPtr(MacroAssembler::BaseIndex(storageGPR, scratchGPR, MacroAssembler::ScalePtr), storageGPR);
+        done.append(m_jit.jump());
+
+        isExtraArgument.link(&m_jit);
+        m_jit.move(cleanIndexGPR, scratchGPR);
+        m_jit.sub32(MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, numParameters)), scratchGPR);
+        m_jit.loadPtr(MacroAssembler::Address(storageGPR, OBJECT_OFFSETOF(ArgumentsData, extraArguments)), storageGPR);
+        m_jit.loadPtr(MacroAssembler::BaseIndex(storageGPR, scratchGPR, MacroAssembler::ScalePtr), storageGPR);
+        done.append(m_jit.jump());
 
         baseNotCell.link(&m_jit);
         propertyNotInt.link(&m_jit);
-        baseNotArray.link(&m_jit);
+        notArgument.link(&m_jit);
         outOfBounds.link(&m_jit);
         loadFailed.link(&m_jit);
 
@@ -933,7 +967,7 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         silentSpillAllRegisters(InvalidGPRReg);
         setupStubArguments(baseGPR, propertyGPR, valueGPR);
         m_jit.move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
-        JITCompiler::Call functionCall = appendCallWithExceptionCheck(m_jit.codeBlock()->isStrictMode() ? operationPutByValStrict : operationPutByValNonStrict);
+        appendCallWithExceptionCheck(m_jit.codeBlock()->isStrictMode() ? operationPutByValStrict : operationPutByValNonStrict);
         silentFillAllRegisters(InvalidGPRReg);
         
         done.link(&m_jit);
@@ -942,7 +976,10 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         break;
     }
 
-    case GetById: {
+    case GetById:
+    case GetArrayLength:
+    case GetStringLength: {
+        // Fixup only specializes 'length' accesses for the speculative path.
         JSValueOperand base(this, node.child1());
         GPRReg baseGPR = base.gpr();
         GPRTemporary result(this, base);
@@ -1052,6 +1089,43 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         break;
     }
 
+    case GetScopedVar: {
+        GPRTemporary result(this);
+        GPRReg resultGPR = result.gpr();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, resultGPR);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(JITCompiler::Address(resultGPR, OBJECT_OFFSETOF(ScopeChainNode, next)), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, OBJECT_OFFSETOF(ScopeChainNode, object)), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, JSVariableObject::offsetOfRegisters()), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, node.scopedVarIndex() * sizeof(Register)), resultGPR);
+
+        jsValueResult(resultGPR, m_compileIndex);
+        break;
+    }
+
+    case PutScopedVar: {
+        JSValueOperand value(this, node.child1());
+        GPRTemporary scope(this);
+        GPRTemporary scratch(this);
+
+        GPRReg scopeReg = scope.gpr();
+        GPRReg scratchReg = scratch.gpr();
+
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, scopeReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(JITCompiler::Address(scopeReg, OBJECT_OFFSETOF(ScopeChainNode, next)), scopeReg);
+        m_jit.loadPtr(JITCompiler::Address(scopeReg, OBJECT_OFFSETOF(ScopeChainNode, object)), scopeReg);
+
+        writeBarrier(m_jit, scopeReg, scratchReg, WriteBarrierForVariableAccess);
+
+        m_jit.loadPtr(JITCompiler::Address(scopeReg, JSVariableObject::offsetOfRegisters()), scratchReg);
+        m_jit.storePtr(value.gpr(), JITCompiler::Address(scratchReg, node.scopedVarIndex() * sizeof(Register)));
+
+        noResult(m_compileIndex);
+        break;
+    }
+
     case DFG::Jump: {
         BlockIndex taken = m_jit.graph().blockIndexForBytecodeOffset(node.takenBytecodeOffset());
         if (taken != (m_block + 1))
@@ -1133,8 +1207,7 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         base.use();
         prototype.use();
 
-        // Check that operands are cells (base is checked by CheckHasInstance, so we can just assert).
-        MacroAssembler::Jump valueNotCell = m_jit.branchTestPtr(MacroAssembler::NonZero, valueReg, GPRInfo::tagMaskRegister);
+        // Check that prototype is a cell (base is checked by CheckHasInstance, so we can just assert).
         m_jit.jitAssertIsCell(baseReg);
         MacroAssembler::Jump prototypeNotCell = m_jit.branchTestPtr(MacroAssembler::NonZero, prototypeReg, GPRInfo::tagMaskRegister);
 
@@ -1142,6 +1215,9 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         m_jit.loadPtr(MacroAssembler::Address(baseReg, JSCell::structureOffset()), scratchReg);
         MacroAssembler::Jump notDefaultHasInstance = m_jit.branchTest8(MacroAssembler::Zero, MacroAssembler::Address(scratchReg, Structure::typeInfoFlagsOffset()), TrustedImm32(ImplementsDefaultHasInstance));
 
+        // A value that is not a cell has no prototype chain, so it is not an instance.
+        MacroAssembler::Jump valueNotCell = m_jit.branchTestPtr(MacroAssembler::NonZero, valueReg, GPRInfo::tagMaskRegister);
+
         // Check that prototype is an object
         m_jit.loadPtr(MacroAssembler::Address(prototypeReg, JSCell::structureOffset()), scratchReg);
         MacroAssembler::Jump protoNotObject = m_jit.branchIfNotObject(scratchReg);
@@ -1157,12 +1233,12 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         m_jit.branchTestPtr(MacroAssembler::Zero, scratchReg, GPRInfo::tagMaskRegister).linkTo(loop, &m_jit);
 
         // No match - result is false.
+        valueNotCell.link(&m_jit);
         m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(false))), scratchReg);
         MacroAssembler::Jump wasNotInstance = m_jit.jump();
 
         // Link to here if any checks fail that require us to try calling out to an operation to help,
         // e.g. for an API overridden HasInstance.
-        valueNotCell.link(&m_jit);
         prototypeNotCell.link(&m_jit);
         notDefaultHasInstance.link(&m_jit);
         protoNotObject.link(&m_jit);
@@ -1224,6 +1300,14 @@ void NonSpeculativeJIT::compile(SpeculationCheckIndexIterator& checkIterator, No
         jsValueResult(result.gpr(), m_compileIndex);
         break;
     }
+
+    case NewObject:
+        emitNewObject(node);
+        break;
+
+    case NewArray:
+        emitNewArray(node);
+        break;
     }
 
     if (node.hasResult() && node.mustGenerate())
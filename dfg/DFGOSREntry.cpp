@@ -32,6 +32,8 @@
 #include "CodeBlock.h"
 #include "DFGNode.h"
 #include "JIT.h"
+#include "JITDiagnostics.h"
+#include "Tracing.h"
 
 namespace JSC { namespace DFG {
 
@@ -46,6 +48,9 @@ inline bool predictionIsValid(JSGlobalData* globalData, JSValue value, Predicted
     if (isArrayPrediction(type))
         return isJSArray(globalData, value);
     
+    if (isCellPrediction(type))
+        return value.isCell();
+    
     if (isBooleanPrediction(type))
         return value.isBoolean();
     
@@ -88,6 +93,8 @@ void* prepareOSREntry(ExecState* exec, CodeBlock* codeBlock, unsigned bytecodeIn
 #if ENABLE(JIT_VERBOSE_OSR)
         printf("    OSR failed because of a missing JIT code map.\n");
 #endif
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock, "OSR entry at bc#%u failed: no OSR entrypoints", bytecodeIndex);
         return 0;
     }
 #endif
@@ -110,14 +117,19 @@ void* prepareOSREntry(ExecState* exec, CodeBlock* codeBlock, unsigned bytecodeIn
     
     PredictionTracker* predictions = baselineCodeBlock->predictions();
     
-    if (predictions->numberOfArguments() > exec->argumentCountIncludingThis())
+    if (predictions->numberOfArguments() > exec->argumentCountIncludingThis()) {
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock, "OSR entry at bc#%u failed: called with %u arguments, compiled for %u", bytecodeIndex, static_cast<unsigned>(exec->argumentCountIncludingThis()), predictions->numberOfArguments());
         return 0;
+    }
     
     for (unsigned i = 1; i < predictions->numberOfArguments(); ++i) {
         if (!predictionIsValid(globalData, exec->argument(i - 1), predictions->getArgumentPrediction(i))) {
 #if ENABLE(JIT_VERBOSE_OSR)
             printf("    OSR failed because argument %u is %s, expected %s.\n", i, exec->argument(i - 1).description(), predictionToString(predictions->getArgumentPrediction(i)));
 #endif
+            if (JITDiagnostics::isEnabled())
+                JITDiagnostics::log(codeBlock, "OSR entry at bc#%u failed: argument %u is not %s", bytecodeIndex, i, predictionToString(predictions->getArgumentPrediction(i)));
             return 0;
         }
     }
@@ -130,6 +142,8 @@ void* prepareOSREntry(ExecState* exec, CodeBlock* codeBlock, unsigned bytecodeIn
 #if ENABLE(JIT_VERBOSE_OSR)
             printf("    OSR failed because variable %u is %s, expected %s.\n", i, exec->registers()[i].jsValue().description(), predictionToString(predictions->getPrediction(i)));
 #endif
+            if (JITDiagnostics::isEnabled())
+                JITDiagnostics::log(codeBlock, "OSR entry at bc#%u failed: variable r%u is not %s", bytecodeIndex, i, predictionToString(predictions->getPrediction(i)));
             return 0;
         }
     }
@@ -145,6 +159,8 @@ void* prepareOSREntry(ExecState* exec, CodeBlock* codeBlock, unsigned bytecodeIn
 #if ENABLE(JIT_VERBOSE_OSR)
         printf("    OSR failed because stack growth failed..\n");
 #endif
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock, "OSR entry at bc#%u failed: could not grow the register file", bytecodeIndex);
         return 0;
     }
     
@@ -184,6 +200,9 @@ void* prepareOSREntry(ExecState* exec, CodeBlock* codeBlock, unsigned bytecodeIn
 #if ENABLE(JIT_VERBOSE_OSR)
     printf("    OSR returning machine code address %p.\n", result);
 #endif
+    JAVASCRIPTCORE_OSR_ENTRY(codeBlock, bytecodeIndex);
+    if (JITDiagnostics::isEnabled())
+        JITDiagnostics::log(codeBlock, "OSR entry at bc#%u", bytecodeIndex);
     
     return result;
 #else // ENABLE(DFG_OSR_ENTRY)
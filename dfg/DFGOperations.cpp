@@ -31,9 +31,12 @@
 #include "CodeBlock.h"
 #include "DFGRepatch.h"
 #include "Interpreter.h"
+#include "JITDiagnostics.h"
 #include "JSByteArray.h"
+#include "JSTypedArray.h"
 #include "JSGlobalData.h"
 #include "Operations.h"
+#include "Tracing.h"
 
 #define FUNCTION_WRAPPER_WITH_RETURN_ADDRESS(function, register) \
     asm( \
@@ -78,6 +81,20 @@ static inline void putByVal(ExecState* exec, JSValue baseValue, uint32_t index,
         }
     }
 
+    if (isJSTypedArray(globalData, baseValue) && asTypedArray(baseValue)->canAccessIndex(index)) {
+        JSTypedArray* typedArray = asTypedArray(baseValue);
+        if (value.isInt32()) {
+            typedArray->setIndex(index, value.asInt32());
+            return;
+        }
+
+        double dValue = 0;
+        if (value.getNumber(dValue)) {
+            typedArray->setIndex(index, dValue);
+            return;
+        }
+    }
+
     baseValue.put(exec, index, value);
 }
 
@@ -194,6 +211,9 @@ static inline EncodedJSValue getByVal(ExecState* exec, JSCell* base, uint32_t in
     if (isJSByteArray(globalData, base) && asByteArray(base)->canAccessIndex(index))
         return JSValue::encode(asByteArray(base)->getIndex(exec, index));
 
+    if (isJSTypedArray(globalData, base) && asTypedArray(base)->canAccessIndex(index))
+        return JSValue::encode(asTypedArray(base)->getIndex(index));
+
     return JSValue::encode(JSValue(base).get(exec, index));
 }
 
@@ -654,6 +674,20 @@ EncodedJSValue operationResolveBaseStrictPut(ExecState* exec, Identifier* proper
     return JSValue::encode(base);
 }
 
+EncodedJSValue operationNewObject(ExecState* exec, void* allocationSiteProfile)
+{
+    // Unlike the baseline JIT, the DFG does not count down to the site's next sample inline.
+    AllocationSiteScope allocationSite(exec->globalData().heap, exec->codeBlock(), *static_cast<AllocationSiteProfile*>(allocationSiteProfile), AllocationSiteScope::DecrementCountdown);
+    return JSValue::encode(allocationSite.didAllocate(constructEmptyObject(exec)));
+}
+
+EncodedJSValue operationNewArray(ExecState* exec, void* buffer, size_t size, void* allocationSiteProfile)
+{
+    ArgList argList(static_cast<Register*>(buffer), static_cast<int>(size));
+    AllocationSiteScope allocationSite(exec->globalData().heap, exec->codeBlock(), *static_cast<AllocationSiteProfile*>(allocationSiteProfile), AllocationSiteScope::DecrementCountdown);
+    return JSValue::encode(allocationSite.didAllocate(constructArray(exec, argList)));
+}
+
 void operationThrowHasInstanceError(ExecState* exec, EncodedJSValue encodedBase)
 {
     JSValue base = JSValue::decode(encodedBase);
@@ -692,6 +726,15 @@ RegisterSizedBoolean dfgConvertJSValueToBoolean(ExecState* exec, EncodedJSValue
     return JSValue::decode(encodedOp).toBoolean(exec);
 }
 
+#if ENABLE(DFG_OSR_EXIT)
+void operationTraceOSRExit(ExecState* exec, int32_t bytecodeIndex, const char* nodeName)
+{
+    JAVASCRIPTCORE_OSR_EXIT(exec->codeBlock(), bytecodeIndex);
+    if (JITDiagnostics::isEnabled())
+        JITDiagnostics::log(exec->codeBlock(), "OSR exit at bc#%d: %s speculation failed", bytecodeIndex, nodeName);
+}
+#endif
+
 #if ENABLE(DFG_VERBOSE_SPECULATION_FAILURE)
 void debugOperationPrintSpeculationFailure(ExecState*, void* debugInfoRaw)
 {
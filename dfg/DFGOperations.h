@@ -46,6 +46,7 @@ typedef EncodedJSValue (*J_DFGOperation_EJP)(ExecState*, EncodedJSValue, void*);
 typedef EncodedJSValue (*J_DFGOperation_EJI)(ExecState*, EncodedJSValue, Identifier*);
 typedef EncodedJSValue (*J_DFGOperation_EP)(ExecState*, void*);
 typedef EncodedJSValue (*J_DFGOperation_EI)(ExecState*, Identifier*);
+typedef EncodedJSValue (*J_DFGOperation_EPSP)(ExecState*, void*, size_t, void*);
 typedef RegisterSizedBoolean (*Z_DFGOperation_EJ)(ExecState*, EncodedJSValue);
 typedef RegisterSizedBoolean (*Z_DFGOperation_EJJ)(ExecState*, EncodedJSValue, EncodedJSValue);
 typedef void (*V_DFGOperation_EJJJ)(ExecState*, EncodedJSValue, EncodedJSValue, EncodedJSValue);
@@ -73,6 +74,8 @@ EncodedJSValue operationInstanceOf(ExecState*, EncodedJSValue value, EncodedJSVa
 EncodedJSValue operationResolve(ExecState*, Identifier*);
 EncodedJSValue operationResolveBase(ExecState*, Identifier*);
 EncodedJSValue operationResolveBaseStrictPut(ExecState*, Identifier*);
+EncodedJSValue operationNewObject(ExecState*, void* allocationSiteProfile);
+EncodedJSValue operationNewArray(ExecState*, void* buffer, size_t size, void* allocationSiteProfile);
 void operationThrowHasInstanceError(ExecState*, EncodedJSValue base);
 void operationPutByValStrict(ExecState*, EncodedJSValue encodedBase, EncodedJSValue encodedProperty, EncodedJSValue encodedValue);
 void operationPutByValNonStrict(ExecState*, EncodedJSValue encodedBase, EncodedJSValue encodedProperty, EncodedJSValue encodedValue);
@@ -116,6 +119,11 @@ double dfgConvertJSValueToNumber(ExecState*, EncodedJSValue);
 int32_t dfgConvertJSValueToInt32(ExecState*, EncodedJSValue);
 RegisterSizedBoolean dfgConvertJSValueToBoolean(ExecState*, EncodedJSValue);
 
+#if ENABLE(DFG_OSR_EXIT)
+// Called by OSR exits compiled while the osr_exit probe or JIT diagnostics were on.
+void operationTraceOSRExit(ExecState*, int32_t bytecodeIndex, const char* nodeName);
+#endif
+
 #if ENABLE(DFG_VERBOSE_SPECULATION_FAILURE)
 void debugOperationPrintSpeculationFailure(ExecState*, void*);
 #endif
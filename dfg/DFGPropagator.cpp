@@ -216,6 +216,10 @@ private:
         }
             
         case LogicalNot:
+        case IsUndefined:
+        case IsBoolean:
+        case IsNumber:
+        case IsString:
         case CompareLess:
         case CompareLessEq:
         case CompareGreater:
@@ -273,6 +277,16 @@ private:
             break;
         }
 
+        case NewObject: {
+            changed |= setPrediction(makePrediction(PredictFinalObject, StrongPrediction));
+            break;
+        }
+
+        case NewArray: {
+            changed |= setPrediction(makePrediction(PredictArray, StrongPrediction));
+            break;
+        }
+
 #ifndef NDEBUG
         // These get ignored because they don't return anything.
         case DFG::Jump:
@@ -280,12 +294,14 @@ private:
         case Return:
         case CheckHasInstance:
         case Phi:
+        case PutScopedVar:
             break;
             
         // These get ignored because we don't have profiling for them, yet.
         case Resolve:
         case ResolveBase:
         case ResolveBaseStrictPut:
+        case GetScopedVar:
             break;
             
         default:
@@ -379,6 +395,37 @@ private:
             break;
         }
             
+        case GetById: {
+            PredictedType base = m_predictions[node.child1()];
+            if (!isStrongPrediction(base) || m_codeBlock->identifier(node.identifierNumber()) != m_globalData.propertyNames->length)
+                break;
+            if (isArrayPrediction(base)) {
+#if ENABLE(DFG_DEBUG_VERBOSE)
+                printf("  -> GetArrayLength");
+#endif
+                node.op = GetArrayLength;
+            } else if (isStringPrediction(base)) {
+#if ENABLE(DFG_DEBUG_VERBOSE)
+                printf("  -> GetStringLength");
+#endif
+                node.op = GetStringLength;
+            }
+            break;
+        }
+            
+        case PutByValAlias: {
+            // A GetByVal on a base predicted to be a string speculates that the base is a
+            // string rather than an array, so it does not prove that a subsequent put may
+            // skip its checks.
+            if (isStringPrediction(m_graph.getPrediction(m_graph[node.child1()]))) {
+#if ENABLE(DFG_DEBUG_VERBOSE)
+                printf("  -> PutByVal");
+#endif
+                node.op = PutByVal;
+            }
+            break;
+        }
+            
         default:
             break;
         }
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DFGRangeAnalysis.h"
+
+#if ENABLE(DFG_JIT)
+
+#include "CodeBlock.h"
+#include "DFGGraph.h"
+#include <algorithm>
+#include <wtf/StdLibExtras.h>
+
+namespace JSC { namespace DFG {
+
+// === RangeAnalysis ===
+//
+// This class records, for each node that the speculative JIT produces as an
+// int32, the bounds of the values it can produce. Bounds are held in 64 bits,
+// so that the exact range of a sum, difference or product of two int32 ranges
+// can be computed, and compared against the int32 range to decide whether the
+// operation can overflow. Children always precede their parents, so a single
+// pass in node order suffices. As in constant folding, values that reach a
+// block through locals are not tracked, so ranges (including loop induction
+// variables) are not propagated across blocks.
+class RangeAnalysis {
+public:
+    RangeAnalysis(Graph& graph, CodeBlock* codeBlock)
+        : m_graph(graph)
+        , m_codeBlock(codeBlock)
+        , m_ranges(graph.size())
+    {
+    }
+
+    void run()
+    {
+        for (m_compileIndex = 0; m_compileIndex < m_graph.size(); ++m_compileIndex)
+            m_ranges[m_compileIndex] = rangeOf(m_graph[m_compileIndex]);
+    }
+
+private:
+    struct Range {
+        Range()
+            : isKnown(false)
+            , min(0)
+            , max(0)
+        {
+        }
+
+        Range(int64_t min, int64_t max)
+            : isKnown(true)
+            , min(min)
+            , max(max)
+        {
+        }
+
+        static Range int32() { return Range(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()); }
+
+        bool isInt32() const { return isKnown && min >= std::numeric_limits<int32_t>::min() && max <= std::numeric_limits<int32_t>::max(); }
+        bool isNonNegative() const { return isKnown && min >= 0; }
+        bool containsZero() const { return min <= 0 && max >= 0; }
+
+        bool isKnown;
+        int64_t min;
+        int64_t max;
+    };
+
+    Range rangeOfChild(NodeIndex nodeIndex)
+    {
+        ASSERT(nodeIndex < m_compileIndex);
+        return m_ranges[nodeIndex];
+    }
+
+    // The operands of bitwise nodes have been through ToInt32, so lack of knowledge is the int32 range.
+    Range int32RangeOfChild(NodeIndex nodeIndex)
+    {
+        Range range = rangeOfChild(nodeIndex);
+        return range.isInt32() ? range : Range::int32();
+    }
+
+    bool isInt32Constant(NodeIndex nodeIndex)
+    {
+        return m_graph.isInt32Constant(m_codeBlock, nodeIndex);
+    }
+
+    // The smallest all-ones value (2^n - 1) at least as large as a non-negative value.
+    static int64_t allOnesCovering(int64_t value)
+    {
+        int64_t result = 0;
+        while (result < value)
+            result = result * 2 + 1;
+        return result;
+    }
+
+    // Keeps the result of an arithmetic node only if it fits in an int32; otherwise the node
+    // may produce a double, whose range we do not track.
+    Range arithResult(Node& node, Range result, bool canBeNegativeZero = false)
+    {
+        if (!result.isInt32())
+            return Range();
+
+        unsigned flags = NodeArithCannotOverflow;
+        if (!canBeNegativeZero)
+            flags |= NodeArithCannotBeNegativeZero;
+        node.setArithNodeFlags(flags);
+#if ENABLE(DFG_DEBUG_VERBOSE)
+        printf("  @%u in [%lld, %lld] cannot overflow\n", m_compileIndex, static_cast<long long>(result.min), static_cast<long long>(result.max));
+#endif
+        return result;
+    }
+
+    Range rangeOf(Node& node)
+    {
+        switch (node.op) {
+        case JSConstant: {
+            if (!node.isInt32Constant(m_codeBlock))
+                return Range();
+            int32_t value = node.valueOfInt32Constant(m_codeBlock);
+            return Range(value, value);
+        }
+
+        case GetArrayLength:
+        case GetStringLength:
+            // The speculative JIT exits if an array's length does not fit in an int32,
+            // and strings are never that long.
+            return Range(0, std::numeric_limits<int32_t>::max());
+
+        case ValueToInt32:
+            return int32RangeOfChild(node.child1());
+
+        case ValueToNumber:
+            return rangeOfChild(node.child1());
+
+        case BitAnd: {
+            Range left = int32RangeOfChild(node.child1());
+            Range right = int32RangeOfChild(node.child2());
+            // And'ing with a non-negative value clears the sign bit and can only clear others.
+            if (left.isNonNegative() && right.isNonNegative())
+                return Range(0, std::min(left.max, right.max));
+            if (left.isNonNegative())
+                return Range(0, left.max);
+            if (right.isNonNegative())
+                return Range(0, right.max);
+            return Range::int32();
+        }
+
+        case BitOr:
+        case BitXor: {
+            Range left = int32RangeOfChild(node.child1());
+            Range right = int32RangeOfChild(node.child2());
+            if (left.isNonNegative() && right.isNonNegative())
+                return Range(0, allOnesCovering(std::max(left.max, right.max)));
+            return Range::int32();
+        }
+
+        case BitRShift: {
+            Range left = int32RangeOfChild(node.child1());
+            if (isInt32Constant(node.child2())) {
+                unsigned shift = m_graph.valueOfInt32Constant(m_codeBlock, node.child2()) & 0x1f;
+                return Range(left.min >> shift, left.max >> shift);
+            }
+            if (left.isNonNegative())
+                return Range(0, left.max);
+            return Range::int32();
+        }
+
+        case BitURShift: {
+            // The result is the shifted bits as an int32; UInt32ToNumber reinterprets them.
+            Range left = int32RangeOfChild(node.child1());
+            if (isInt32Constant(node.child2())) {
+                unsigned shift = m_graph.valueOfInt32Constant(m_codeBlock, node.child2()) & 0x1f;
+                if (left.isNonNegative())
+                    return Range(left.min >> shift, left.max >> shift);
+                if (shift)
+                    return Range(0, static_cast<int64_t>(std::numeric_limits<uint32_t>::max() >> shift));
+                return Range::int32();
+            }
+            if (left.isNonNegative())
+                return Range(0, left.max);
+            return Range::int32();
+        }
+
+        case UInt32ToNumber: {
+            Range operand = int32RangeOfChild(node.child1());
+            if (!operand.isNonNegative())
+                return Range();
+            return arithResult(node, operand);
+        }
+
+        case ValueAdd:
+        case ArithAdd: {
+            Range left = rangeOfChild(node.child1());
+            Range right = rangeOfChild(node.child2());
+            if (!left.isKnown || !right.isKnown)
+                return Range();
+            return arithResult(node, Range(left.min + right.min, left.max + right.max));
+        }
+
+        case ArithSub: {
+            Range left = rangeOfChild(node.child1());
+            Range right = rangeOfChild(node.child2());
+            if (!left.isKnown || !right.isKnown)
+                return Range();
+            return arithResult(node, Range(left.min - right.max, left.max - right.min));
+        }
+
+        case ArithMul: {
+            Range left = rangeOfChild(node.child1());
+            Range right = rangeOfChild(node.child2());
+            if (!left.isKnown || !right.isKnown)
+                return Range();
+            // The extremes of a product of intervals are products of their ends; int32 ends
+            // cannot overflow 64 bits.
+            int64_t products[] = { left.min * right.min, left.min * right.max, left.max * right.min, left.max * right.max };
+            int64_t min = *std::min_element(products, products + WTF_ARRAY_LENGTH(products));
+            int64_t max = *std::max_element(products, products + WTF_ARRAY_LENGTH(products));
+            // A zero times a negative number is -0, which an int32 cannot represent.
+            bool canBeNegativeZero = (left.containsZero() && right.min < 0) || (right.containsZero() && left.min < 0);
+            return arithResult(node, Range(min, max), canBeNegativeZero);
+        }
+
+        default:
+            return Range();
+        }
+    }
+
+    Graph& m_graph;
+    CodeBlock* m_codeBlock;
+
+    NodeIndex m_compileIndex;
+    Vector<Range, 16> m_ranges;
+};
+
+void performRangeAnalysis(Graph& graph, CodeBlock* codeBlock)
+{
+    RangeAnalysis rangeAnalysis(graph, codeBlock);
+    rangeAnalysis.run();
+}
+
+} } // namespace JSC::DFG
+
+#endif // ENABLE(DFG_JIT)
@@ -28,6 +28,7 @@
 
 #if ENABLE(DFG_JIT)
 
+#include "Arguments.h"
 #include "DFGJITCodeGenerator.h"
 #include "LinkBuffer.h"
 #include "Operations.h"
@@ -41,6 +42,14 @@ static void dfgRepatchCall(CodeBlock* codeblock, CodeLocationCall call, Function
     repatchBuffer.relink(call, newCalleeFunction);
 }
 
+// Points a property access site at a slow path that no longer tries to cache, and records that in
+// the site's StructureStubInfo for the inline cache statistics.
+static void dfgRepatchToGeneric(CodeBlock* codeBlock, StructureStubInfo& stubInfo, FunctionPtr slowPathFunction)
+{
+    stubInfo.setGeneric();
+    dfgRepatchCall(codeBlock, stubInfo.callReturnLocation, slowPathFunction);
+}
+
 static void dfgRepatchByIdSelfAccess(CodeBlock* codeBlock, StructureStubInfo& stubInfo, Structure* structure, size_t offset, const FunctionPtr &slowPathFunction, bool compact)
 {
     RepatchBuffer repatchBuffer(codeBlock);
@@ -148,7 +157,9 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
     CodeBlock* codeBlock = exec->codeBlock();
     JSGlobalData* globalData = &exec->globalData();
     
-    if (isJSArray(globalData, baseValue) && propertyName == exec->propertyNames().length) {
+    bool isArrayLength = isJSArray(globalData, baseValue);
+    bool isArgumentsLength = baseValue.isCell() && baseValue.asCell()->structure() == codeBlock->globalObject()->argumentsStructure();
+    if ((isArrayLength || isArgumentsLength) && propertyName == exec->propertyNames().length) {
         GPRReg baseGPR = static_cast<GPRReg>(stubInfo.baseGPR);
         GPRReg resultGPR = static_cast<GPRReg>(stubInfo.valueGPR);
         GPRReg scratchGPR = static_cast<GPRReg>(stubInfo.scratchGPR);
@@ -164,11 +175,20 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
         
         MacroAssembler::JumpList failureCases;
         
-        failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR), MacroAssembler::TrustedImmPtr(globalData->jsArrayVPtr)));
+        if (isArrayLength) {
+            failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR), MacroAssembler::TrustedImmPtr(globalData->jsArrayVPtr)));
         
-        stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSArray::storageOffset()), scratchGPR);
-        stubJit.load32(MacroAssembler::Address(scratchGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)), scratchGPR);
-        failureCases.append(stubJit.branch32(MacroAssembler::LessThan, scratchGPR, MacroAssembler::TrustedImm32(0)));
+            stubJit.loadPtr(MacroAssembler::Address(baseGPR, JSArray::storageOffset()), scratchGPR);
+            stubJit.load32(MacroAssembler::Address(scratchGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)), scratchGPR);
+            failureCases.append(stubJit.branch32(MacroAssembler::LessThan, scratchGPR, MacroAssembler::TrustedImm32(0)));
+        } else {
+            failureCases.append(stubJit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR, JSCell::structureOffset()), MacroAssembler::TrustedImmPtr(baseValue.asCell()->structure())));
+
+            // Deleting an Arguments object's length doesn't change its Structure.
+            stubJit.loadPtr(MacroAssembler::Address(baseGPR, Arguments::offsetOfData()), scratchGPR);
+            failureCases.append(stubJit.branchTest8(MacroAssembler::NonZero, MacroAssembler::Address(scratchGPR, OBJECT_OFFSETOF(ArgumentsData, overrodeLength))));
+            stubJit.load32(MacroAssembler::Address(scratchGPR, OBJECT_OFFSETOF(ArgumentsData, numArguments)), scratchGPR);
+        }
         
         stubJit.orPtr(GPRInfo::tagTypeNumberRegister, scratchGPR, resultGPR);
 
@@ -239,9 +259,10 @@ static bool tryCacheGetByID(ExecState* exec, JSValue baseValue, const Identifier
 
 void dfgRepatchGetByID(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
 {
+    ExecutableMemoryBatchScope batch;
     bool cached = tryCacheGetByID(exec, baseValue, propertyName, slot, stubInfo);
     if (!cached)
-        dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
+        dfgRepatchToGeneric(exec->codeBlock(), stubInfo, operationGetById);
 }
 
 static void dfgRepatchGetMethodFast(JSGlobalData* globalData, CodeBlock* codeBlock, MethodCallLinkInfo& methodInfo, JSObject* callee, Structure* structure, JSObject* slotBaseObject)
@@ -332,6 +353,7 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
     
     if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
         stubInfo.u.getByIdSelfList.listSize++;
+        stubInfo.didGrowList();
         
         GPRReg baseGPR = static_cast<GPRReg>(stubInfo.baseGPR);
         GPRReg resultGPR = static_cast<GPRReg>(stubInfo.valueGPR);
@@ -374,9 +396,10 @@ static bool tryBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identi
 
 void dfgBuildGetByIDList(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
 {
+    ExecutableMemoryBatchScope batch;
     bool dontChangeCall = tryBuildGetByIDList(exec, baseValue, propertyName, slot, stubInfo);
     if (!dontChangeCall)
-        dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
+        dfgRepatchToGeneric(exec->codeBlock(), stubInfo, operationGetById);
 }
 
 static bool tryBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
@@ -417,6 +440,7 @@ static bool tryBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const I
     
     if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
         stubInfo.u.getByIdProtoList.listSize++;
+        stubInfo.didGrowList();
         
         CodeLocationLabel lastProtoBegin = CodeLocationLabel(polymorphicStructureList->list[listIndex - 1].stubRoutine.code());
         ASSERT(!!lastProtoBegin);
@@ -440,9 +464,10 @@ static bool tryBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const I
 
 void dfgBuildGetByIDProtoList(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo& stubInfo)
 {
+    ExecutableMemoryBatchScope batch;
     bool dontChangeCall = tryBuildGetByIDProtoList(exec, baseValue, propertyName, slot, stubInfo);
     if (!dontChangeCall)
-        dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, operationGetById);
+        dfgRepatchToGeneric(exec->codeBlock(), stubInfo, operationGetById);
 }
 
 static V_DFGOperation_EJJI appropriatePutByIdFunction(const PutPropertySlot &slot, PutKind putKind)
@@ -576,15 +601,17 @@ static bool tryCachePutByID(ExecState* exec, JSValue baseValue, const Identifier
 
 void dfgRepatchPutByID(ExecState* exec, JSValue baseValue, const Identifier& propertyName, const PutPropertySlot& slot, StructureStubInfo& stubInfo, PutKind putKind)
 {
+    ExecutableMemoryBatchScope batch;
     bool cached = tryCachePutByID(exec, baseValue, propertyName, slot, stubInfo, putKind);
     if (!cached)
-        dfgRepatchCall(exec->codeBlock(), stubInfo.callReturnLocation, appropriatePutByIdFunction(slot, putKind));
+        dfgRepatchToGeneric(exec->codeBlock(), stubInfo, appropriatePutByIdFunction(slot, putKind));
 }
 
 void dfgLinkFor(ExecState* exec, CallLinkInfo& callLinkInfo, CodeBlock* calleeCodeBlock, JSFunction* callee, MacroAssemblerCodePtr codePtr, CodeSpecializationKind kind)
 {
     CodeBlock* callerCodeBlock = exec->callerFrame()->codeBlock();
     
+    ExecutableMemoryBatchScope batch;
     RepatchBuffer repatchBuffer(callerCodeBlock);
     
     if (!calleeCodeBlock || static_cast<int>(exec->argumentCountIncludingThis()) == calleeCodeBlock->m_numParameters) {
@@ -594,7 +621,10 @@ void dfgLinkFor(ExecState* exec, CallLinkInfo& callLinkInfo, CodeBlock* calleeCo
         
         if (calleeCodeBlock)
             calleeCodeBlock->linkIncomingCall(&callLinkInfo);
-    }
+        ++callLinkInfo.linkCount;
+        callLinkInfo.isVirtual = false;
+    } else
+        callLinkInfo.isVirtual = true;
     
     if (kind == CodeForCall) {
         repatchBuffer.relink(CodeLocationCall(callLinkInfo.callReturnLocation), operationVirtualCall);
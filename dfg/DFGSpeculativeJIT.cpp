@@ -676,6 +676,104 @@ bool SpeculativeJIT::compare(Node& node, MacroAssembler::RelationalCondition con
     return false;
 }
 
+// Leaves the result of value instanceof prototype, for a cell value, in scratchReg.
+void SpeculativeJIT::compileInstanceOfForCell(GPRReg valueReg, GPRReg prototypeReg, GPRReg scratchReg)
+{
+    // Check that prototype is an object.
+    m_jit.loadPtr(MacroAssembler::Address(prototypeReg, JSCell::structureOffset()), scratchReg);
+    speculationCheck(m_jit.branchIfNotObject(scratchReg));
+
+    // Initialize scratchReg with the value being checked.
+    m_jit.move(valueReg, scratchReg);
+
+    // Walk up the prototype chain of the value (in scratchReg), comparing to prototypeReg.
+    MacroAssembler::Label loop(&m_jit);
+    m_jit.loadPtr(MacroAssembler::Address(scratchReg, JSCell::structureOffset()), scratchReg);
+    m_jit.loadPtr(MacroAssembler::Address(scratchReg, Structure::prototypeOffset()), scratchReg);
+    MacroAssembler::Jump isInstance = m_jit.branchPtr(MacroAssembler::Equal, scratchReg, prototypeReg);
+    m_jit.branchTestPtr(MacroAssembler::Zero, scratchReg, GPRInfo::tagMaskRegister).linkTo(loop, &m_jit);
+
+    // No match - result is false.
+    m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(false))), scratchReg);
+    MacroAssembler::Jump putResult = m_jit.jump();
+
+    isInstance.link(&m_jit);
+    m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(true))), scratchReg);
+
+    putResult.link(&m_jit);
+}
+
+void SpeculativeJIT::compileInstanceOf(Node& node)
+{
+    // Base unused since we speculate default InstanceOf behaviour in CheckHasInstance.
+    if (isCellPrediction(m_jit.graph().getPrediction(m_jit.graph()[node.child1()]))) {
+        SpeculateCellOperand value(this, node.child1());
+        SpeculateCellOperand prototype(this, node.child3());
+        GPRTemporary scratch(this);
+
+        compileInstanceOfForCell(value.gpr(), prototype.gpr(), scratch.gpr());
+        jsValueResult(scratch.gpr(), m_compileIndex, DataFormatJSBoolean);
+        return;
+    }
+
+    // Type dispatch code tests values of every type, so rather than speculating that the value
+    // is a cell, answer false for the others inline.
+    JSValueOperand value(this, node.child1());
+    SpeculateCellOperand prototype(this, node.child3());
+    GPRTemporary scratch(this);
+
+    GPRReg valueReg = value.gpr();
+    GPRReg scratchReg = scratch.gpr();
+
+    MacroAssembler::Jump isCell = m_jit.branchTestPtr(MacroAssembler::Zero, valueReg, GPRInfo::tagMaskRegister);
+    m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(false))), scratchReg);
+    MacroAssembler::Jump done = m_jit.jump();
+
+    isCell.link(&m_jit);
+    compileInstanceOfForCell(valueReg, prototype.gpr(), scratchReg);
+
+    done.link(&m_jit);
+    jsValueResult(scratchReg, m_compileIndex, DataFormatJSBoolean);
+}
+
+// Character access on a flat string, mirroring the baseline JIT's string get_by_val thunk:
+// the result is one of the SmallStrings single-character strings, so we bail out on ropes,
+// on characters above 0xFF and on single-character strings that have not been created yet.
+void SpeculativeJIT::compileGetByValOnString(Node& node)
+{
+    SpeculateCellOperand base(this, node.child1());
+    SpeculateStrictInt32Operand property(this, node.child2());
+    GPRTemporary storage(this);
+    GPRTemporary scratch(this);
+
+    GPRReg baseReg = base.gpr();
+    GPRReg propertyReg = property.gpr();
+    GPRReg storageReg = storage.gpr();
+    GPRReg scratchReg = scratch.gpr();
+
+    if (!m_compileOkay)
+        return;
+
+    speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseReg), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsStringVPtr)));
+
+    // A rope has no flat value to index into.
+    m_jit.loadPtr(MacroAssembler::Address(baseReg, JSString::offsetOfValue()), storageReg);
+    speculationCheck(m_jit.branchTestPtr(MacroAssembler::Zero, storageReg));
+
+    // Do an unsigned compare to simultaneously filter negative indices as well as indices that are too large.
+    speculationCheck(m_jit.branch32(MacroAssembler::AboveOrEqual, propertyReg, MacroAssembler::Address(baseReg, JSString::offsetOfLength())));
+
+    m_jit.loadPtr(MacroAssembler::Address(storageReg, StringImpl::dataOffset()), storageReg);
+    m_jit.load16(MacroAssembler::BaseIndex(storageReg, propertyReg, MacroAssembler::TimesTwo, 0), storageReg);
+
+    speculationCheck(m_jit.branch32(MacroAssembler::Above, storageReg, TrustedImm32(maxSingleCharacterString)));
+    m_jit.move(MacroAssembler::TrustedImmPtr(m_jit.globalData()->smallStrings.singleCharacterStrings()), scratchReg);
+    m_jit.loadPtr(MacroAssembler::BaseIndex(scratchReg, storageReg, MacroAssembler::ScalePtr, 0), storageReg);
+    speculationCheck(m_jit.branchTestPtr(MacroAssembler::Zero, storageReg));
+
+    cellResult(storageReg, m_compileIndex);
+}
+
 void SpeculativeJIT::compile(Node& node)
 {
     NodeType op = node.op;
@@ -704,8 +802,10 @@ void SpeculativeJIT::compile(Node& node)
             VirtualRegister virtualRegister = node.virtualRegister();
             m_gprs.retain(result.gpr(), virtualRegister, SpillOrderJS);
             
+            // Cell predictions are enforced by SetLocal and on entry, so the
+            // value is known to be a cell here and uses need not check again.
             DataFormat format;
-            if (isArrayPrediction(prediction))
+            if (isCellPrediction(prediction))
                 format = DataFormatJSCell;
             else if (isBooleanPrediction(prediction))
                 format = DataFormatJSBoolean;
@@ -765,6 +865,13 @@ void SpeculativeJIT::compile(Node& node)
             speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(cellGPR), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
             m_jit.storePtr(cellGPR, JITCompiler::addressFor(node.local()));
             noResult(m_compileIndex);
+        } else if (isCellPrediction(predictedType)) {
+            // Checking once here, where the value is defined, rather than at each
+            // use means that a loop-invariant object is not re-checked on every
+            // iteration of the loop that uses it.
+            SpeculateCellOperand cell(this, node.child1());
+            m_jit.storePtr(cell.gpr(), JITCompiler::addressFor(node.local()));
+            noResult(m_compileIndex);
         } else if (isBooleanPrediction(predictedType)) {
             SpeculateBooleanOperand boolean(this, node.child1());
             m_jit.storePtr(boolean.gpr(), JITCompiler::addressFor(node.local()));
@@ -839,8 +946,9 @@ void SpeculativeJIT::compile(Node& node)
         IntegerOperand op1(this, node.child1());
         GPRTemporary result(this, op1);
 
-        // Test the operand is positive.
-        speculationCheck(m_jit.branch32(MacroAssembler::LessThan, op1.gpr(), TrustedImm32(0)));
+        // Test the operand is positive, unless range analysis has shown it must be.
+        if (!(node.arithNodeFlags() & NodeArithCannotOverflow))
+            speculationCheck(m_jit.branch32(MacroAssembler::LessThan, op1.gpr(), TrustedImm32(0)));
 
         m_jit.move(op1.gpr(), result.gpr());
         integerResult(result.gpr(), m_compileIndex, op1.format());
@@ -881,23 +989,20 @@ void SpeculativeJIT::compile(Node& node)
     case ValueAdd:
     case ArithAdd: {
         if (shouldSpeculateInteger(node.child1(), node.child2())) {
-            if (isInt32Constant(node.child1())) {
-                int32_t imm1 = valueOfInt32Constant(node.child1());
-                SpeculateIntegerOperand op2(this, node.child2());
-                GPRTemporary result(this);
+            bool canOverflow = !(node.arithNodeFlags() & NodeArithCannotOverflow);
 
-                speculationCheck(m_jit.branchAdd32(MacroAssembler::Overflow, op2.gpr(), Imm32(imm1), result.gpr()));
-
-                integerResult(result.gpr(), m_compileIndex);
-                break;
-            }
-                
-            if (isInt32Constant(node.child2())) {
-                SpeculateIntegerOperand op1(this, node.child1());
-                int32_t imm2 = valueOfInt32Constant(node.child2());
+            if (isInt32Constant(node.child1()) || isInt32Constant(node.child2())) {
+                bool immediateIsFirst = isInt32Constant(node.child1());
+                int32_t imm = valueOfInt32Constant(immediateIsFirst ? node.child1() : node.child2());
+                SpeculateIntegerOperand op(this, immediateIsFirst ? node.child2() : node.child1());
                 GPRTemporary result(this);
-                
-                speculationCheck(m_jit.branchAdd32(MacroAssembler::Overflow, op1.gpr(), Imm32(imm2), result.gpr()));
+
+                if (canOverflow)
+                    speculationCheck(m_jit.branchAdd32(MacroAssembler::Overflow, op.gpr(), Imm32(imm), result.gpr()));
+                else {
+                    m_jit.move(op.gpr(), result.gpr());
+                    m_jit.add32(Imm32(imm), result.gpr());
+                }
 
                 integerResult(result.gpr(), m_compileIndex);
                 break;
@@ -910,6 +1015,18 @@ void SpeculativeJIT::compile(Node& node)
             GPRReg gpr1 = op1.gpr();
             GPRReg gpr2 = op2.gpr();
             GPRReg gprResult = result.gpr();
+
+            if (!canOverflow) {
+                if (gpr1 == gprResult)
+                    m_jit.add32(gpr2, gprResult);
+                else {
+                    m_jit.move(gpr2, gprResult);
+                    m_jit.add32(gpr1, gprResult);
+                }
+                integerResult(gprResult, m_compileIndex);
+                break;
+            }
+
             MacroAssembler::Jump check = m_jit.branchAdd32(MacroAssembler::Overflow, gpr1, gpr2, gprResult);
 
             if (gpr1 == gprResult)
@@ -958,12 +1075,19 @@ void SpeculativeJIT::compile(Node& node)
 
     case ArithSub: {
         if (shouldSpeculateInteger(node.child1(), node.child2())) {
+            bool canOverflow = !(node.arithNodeFlags() & NodeArithCannotOverflow);
+
             if (isInt32Constant(node.child2())) {
                 SpeculateIntegerOperand op1(this, node.child1());
                 int32_t imm2 = valueOfInt32Constant(node.child2());
                 GPRTemporary result(this);
 
-                speculationCheck(m_jit.branchSub32(MacroAssembler::Overflow, op1.gpr(), Imm32(imm2), result.gpr()));
+                if (canOverflow)
+                    speculationCheck(m_jit.branchSub32(MacroAssembler::Overflow, op1.gpr(), Imm32(imm2), result.gpr()));
+                else {
+                    m_jit.move(op1.gpr(), result.gpr());
+                    m_jit.sub32(Imm32(imm2), result.gpr());
+                }
 
                 integerResult(result.gpr(), m_compileIndex);
                 break;
@@ -973,7 +1097,12 @@ void SpeculativeJIT::compile(Node& node)
             SpeculateIntegerOperand op2(this, node.child2());
             GPRTemporary result(this);
 
-            speculationCheck(m_jit.branchSub32(MacroAssembler::Overflow, op1.gpr(), op2.gpr(), result.gpr()));
+            if (canOverflow)
+                speculationCheck(m_jit.branchSub32(MacroAssembler::Overflow, op1.gpr(), op2.gpr(), result.gpr()));
+            else {
+                m_jit.move(op1.gpr(), result.gpr());
+                m_jit.sub32(op2.gpr(), result.gpr());
+            }
 
             integerResult(result.gpr(), m_compileIndex);
             break;
@@ -999,12 +1128,20 @@ void SpeculativeJIT::compile(Node& node)
 
             GPRReg reg1 = op1.gpr();
             GPRReg reg2 = op2.gpr();
-            speculationCheck(m_jit.branchMul32(MacroAssembler::Overflow, reg1, reg2, result.gpr()));
+            unsigned flags = node.arithNodeFlags();
+            if (!(flags & NodeArithCannotOverflow))
+                speculationCheck(m_jit.branchMul32(MacroAssembler::Overflow, reg1, reg2, result.gpr()));
+            else {
+                m_jit.move(reg2, result.gpr());
+                m_jit.mul32(reg1, result.gpr());
+            }
 
-            MacroAssembler::Jump resultNonZero = m_jit.branchTest32(MacroAssembler::NonZero, result.gpr());
-            speculationCheck(m_jit.branch32(MacroAssembler::LessThan, reg1, TrustedImm32(0)));
-            speculationCheck(m_jit.branch32(MacroAssembler::LessThan, reg2, TrustedImm32(0)));
-            resultNonZero.link(&m_jit);
+            if (!(flags & NodeArithCannotBeNegativeZero)) {
+                MacroAssembler::Jump resultNonZero = m_jit.branchTest32(MacroAssembler::NonZero, result.gpr());
+                speculationCheck(m_jit.branch32(MacroAssembler::LessThan, reg1, TrustedImm32(0)));
+                speculationCheck(m_jit.branch32(MacroAssembler::LessThan, reg2, TrustedImm32(0)));
+                resultNonZero.link(&m_jit);
+            }
 
             integerResult(result.gpr(), m_compileIndex);
             break;
@@ -1096,6 +1233,13 @@ void SpeculativeJIT::compile(Node& node)
         break;
     }
 
+    case IsUndefined:
+    case IsBoolean:
+    case IsNumber:
+    case IsString:
+        nonSpeculativeIsType(node);
+        break;
+
     case CompareLess:
         if (compare(node, JITCompiler::LessThan, JITCompiler::DoubleLessThan, operationCompareLess))
             return;
@@ -1147,6 +1291,12 @@ void SpeculativeJIT::compile(Node& node)
             break;
         }
 
+        Node& baseNode = m_jit.graph()[node.child1()];
+        if (isStringPrediction(m_jit.graph().getPrediction(baseNode))) {
+            compileGetByValOnString(node);
+            break;
+        }
+
         SpeculateCellOperand base(this, node.child1());
         SpeculateStrictInt32Operand property(this, node.child2());
         GPRTemporary storage(this);
@@ -1164,9 +1314,14 @@ void SpeculativeJIT::compile(Node& node)
 
         // Check that base is an array, and that property is contained within m_vector (< m_vectorLength).
         // If we have predicted the base to be type array, we can skip the check.
-        Node& baseNode = m_jit.graph()[node.child1()];
         if (baseNode.op != GetLocal || !isArrayPrediction(m_jit.graph().getPrediction(baseNode.local())))
             speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseReg), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
+        // The bounds check is only omitted for a GetByVal that aliases a prior one (above). GetArrayLength
+        // and the range analysis don't make it removable: this check is against m_vectorLength, and the
+        // m_length that GetArrayLength loads may exceed it (e.g. for new Array(n) or sparse arrays), so
+        // index < length proves nothing here. The range analysis also keeps only constant bounds within a
+        // block, not bounds relative to another node such as a length, and does not follow an induction
+        // variable through the GetLocal/SetLocal at a loop header. The hole check below is needed regardless.
         speculationCheck(m_jit.branch32(MacroAssembler::AboveOrEqual, propertyReg, MacroAssembler::Address(baseReg, JSArray::vectorLengthOffset())));
 
         // FIXME: In cases where there are subsequent by_val accesses to the same base it might help to cache
@@ -1213,7 +1368,7 @@ void SpeculativeJIT::compile(Node& node)
         silentSpillAllRegisters(scratchReg);
         setupStubArguments(baseReg, propertyReg, valueReg);
         m_jit.move(GPRInfo::callFrameRegister, GPRInfo::argumentGPR0);
-        JITCompiler::Call functionCall = appendCallWithExceptionCheck(operationPutByValBeyondArrayBounds);
+        appendCallWithExceptionCheck(operationPutByValBeyondArrayBounds);
         silentFillAllRegisters(scratchReg);
         JITCompiler::Jump wasBeyondArrayBounds = m_jit.jump();
 
@@ -1358,6 +1513,48 @@ void SpeculativeJIT::compile(Node& node)
         break;
     }
 
+    case GetArrayLength: {
+        SpeculateCellOperand base(this, node.child1());
+        GPRTemporary result(this, base);
+
+        GPRReg baseGPR = base.gpr();
+        GPRReg resultGPR = result.gpr();
+
+        if (!m_compileOkay)
+            return;
+
+        Node& baseNode = m_jit.graph()[node.child1()];
+        if (baseNode.op != GetLocal || !isArrayPrediction(m_jit.graph().getPrediction(baseNode.local())))
+            speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
+
+        m_jit.loadPtr(MacroAssembler::Address(baseGPR, JSArray::storageOffset()), resultGPR);
+        m_jit.load32(MacroAssembler::Address(resultGPR, OBJECT_OFFSETOF(ArrayStorage, m_length)), resultGPR);
+
+        // The length is a uint32; bail out if it does not fit in an int32.
+        speculationCheck(m_jit.branch32(MacroAssembler::LessThan, resultGPR, MacroAssembler::TrustedImm32(0)));
+
+        integerResult(resultGPR, m_compileIndex);
+        break;
+    }
+
+    case GetStringLength: {
+        SpeculateCellOperand base(this, node.child1());
+        GPRTemporary result(this, base);
+
+        GPRReg baseGPR = base.gpr();
+        GPRReg resultGPR = result.gpr();
+
+        if (!m_compileOkay)
+            return;
+
+        speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(baseGPR), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsStringVPtr)));
+
+        m_jit.load32(MacroAssembler::Address(baseGPR, JSString::offsetOfLength()), resultGPR);
+
+        integerResult(resultGPR, m_compileIndex);
+        break;
+    }
+
     case PutById: {
         SpeculateCellOperand base(this, node.child1());
         JSValueOperand value(this, node.child2());
@@ -1424,55 +1621,59 @@ void SpeculativeJIT::compile(Node& node)
         break;
     }
 
-    case CheckHasInstance: {
-        SpeculateCellOperand base(this, node.child1());
-        GPRTemporary structure(this);
+    case GetScopedVar: {
+        GPRTemporary result(this);
+        GPRReg resultGPR = result.gpr();
 
-        // Speculate that base 'ImplementsDefaultHasInstance'.
-        m_jit.loadPtr(MacroAssembler::Address(base.gpr(), JSCell::structureOffset()), structure.gpr());
-        speculationCheck(m_jit.branchTest8(MacroAssembler::Zero, MacroAssembler::Address(structure.gpr(), Structure::typeInfoFlagsOffset()), MacroAssembler::TrustedImm32(ImplementsDefaultHasInstance)));
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, resultGPR);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(JITCompiler::Address(resultGPR, OBJECT_OFFSETOF(ScopeChainNode, next)), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, OBJECT_OFFSETOF(ScopeChainNode, object)), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, JSVariableObject::offsetOfRegisters()), resultGPR);
+        m_jit.loadPtr(JITCompiler::Address(resultGPR, node.scopedVarIndex() * sizeof(Register)), resultGPR);
 
-        noResult(m_compileIndex);
+        jsValueResult(resultGPR, m_compileIndex);
         break;
     }
 
-    case InstanceOf: {
-        SpeculateCellOperand value(this, node.child1());
-        // Base unused since we speculate default InstanceOf behaviour in CheckHasInstance.
-        SpeculateCellOperand prototype(this, node.child3());
-
+    case PutScopedVar: {
+        JSValueOperand value(this, node.child1());
+        GPRTemporary scope(this);
         GPRTemporary scratch(this);
 
-        GPRReg valueReg = value.gpr();
-        GPRReg prototypeReg = prototype.gpr();
+        GPRReg scopeReg = scope.gpr();
         GPRReg scratchReg = scratch.gpr();
 
-        // Check that prototype is an object.
-        m_jit.loadPtr(MacroAssembler::Address(prototypeReg, JSCell::structureOffset()), scratchReg);
-        speculationCheck(m_jit.branchIfNotObject(scratchReg));
+        m_jit.emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, scopeReg);
+        for (unsigned skip = node.scopeChainDepth(); skip; --skip)
+            m_jit.loadPtr(JITCompiler::Address(scopeReg, OBJECT_OFFSETOF(ScopeChainNode, next)), scopeReg);
+        m_jit.loadPtr(JITCompiler::Address(scopeReg, OBJECT_OFFSETOF(ScopeChainNode, object)), scopeReg);
 
-        // Initialize scratchReg with the value being checked.
-        m_jit.move(valueReg, scratchReg);
+        writeBarrier(m_jit, scopeReg, scratchReg, WriteBarrierForVariableAccess);
 
-        // Walk up the prototype chain of the value (in scratchReg), comparing to prototypeReg.
-        MacroAssembler::Label loop(&m_jit);
-        m_jit.loadPtr(MacroAssembler::Address(scratchReg, JSCell::structureOffset()), scratchReg);
-        m_jit.loadPtr(MacroAssembler::Address(scratchReg, Structure::prototypeOffset()), scratchReg);
-        MacroAssembler::Jump isInstance = m_jit.branchPtr(MacroAssembler::Equal, scratchReg, prototypeReg);
-        m_jit.branchTestPtr(MacroAssembler::Zero, scratchReg, GPRInfo::tagMaskRegister).linkTo(loop, &m_jit);
+        m_jit.loadPtr(JITCompiler::Address(scopeReg, JSVariableObject::offsetOfRegisters()), scratchReg);
+        m_jit.storePtr(value.gpr(), JITCompiler::Address(scratchReg, node.scopedVarIndex() * sizeof(Register)));
+
+        noResult(m_compileIndex);
+        break;
+    }
 
-        // No match - result is false.
-        m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(false))), scratchReg);
-        MacroAssembler::Jump putResult = m_jit.jump();
+    case CheckHasInstance: {
+        SpeculateCellOperand base(this, node.child1());
+        GPRTemporary structure(this);
 
-        isInstance.link(&m_jit);
-        m_jit.move(MacroAssembler::TrustedImmPtr(JSValue::encode(jsBoolean(true))), scratchReg);
+        // Speculate that base 'ImplementsDefaultHasInstance'.
+        m_jit.loadPtr(MacroAssembler::Address(base.gpr(), JSCell::structureOffset()), structure.gpr());
+        speculationCheck(m_jit.branchTest8(MacroAssembler::Zero, MacroAssembler::Address(structure.gpr(), Structure::typeInfoFlagsOffset()), MacroAssembler::TrustedImm32(ImplementsDefaultHasInstance)));
 
-        putResult.link(&m_jit);
-        jsValueResult(scratchReg, m_compileIndex, DataFormatJSBoolean);
+        noResult(m_compileIndex);
         break;
     }
 
+    case InstanceOf:
+        compileInstanceOf(node);
+        break;
+
     case Phi:
         ASSERT_NOT_REACHED();
 
@@ -1512,6 +1713,14 @@ void SpeculativeJIT::compile(Node& node)
         jsValueResult(result.gpr(), m_compileIndex);
         break;
     }
+
+    case NewObject:
+        emitNewObject(node);
+        break;
+
+    case NewArray:
+        emitNewArray(node);
+        break;
     }
     
     if (node.hasResult() && node.mustGenerate())
@@ -1625,6 +1834,10 @@ void SpeculativeJIT::checkArgumentTypes()
             m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), temp.gpr());
             speculationCheck(m_jit.branchTestPtr(MacroAssembler::NonZero, temp.gpr(), GPRInfo::tagMaskRegister));
             speculationCheck(m_jit.branchPtr(MacroAssembler::NotEqual, MacroAssembler::Address(temp.gpr()), MacroAssembler::TrustedImmPtr(m_jit.globalData()->jsArrayVPtr)));
+        } else if (isCellPrediction(predictedType)) {
+            GPRTemporary temp(this);
+            m_jit.loadPtr(JITCompiler::addressFor(virtualRegister), temp.gpr());
+            speculationCheck(m_jit.branchTestPtr(MacroAssembler::NonZero, temp.gpr(), GPRInfo::tagMaskRegister));
         }
     }
 }
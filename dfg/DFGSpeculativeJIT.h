@@ -440,6 +440,9 @@ private:
     bool compare(Node&, MacroAssembler::RelationalCondition, MacroAssembler::DoubleCondition, Z_DFGOperation_EJJ);
     void compilePeepHoleIntegerBranch(Node&, NodeIndex branchNodeIndex, JITCompiler::RelationalCondition);
     void compilePeepHoleDoubleBranch(Node&, NodeIndex branchNodeIndex, JITCompiler::DoubleCondition, Z_DFGOperation_EJJ);
+    void compileGetByValOnString(Node&);
+    void compileInstanceOfForCell(GPRReg valueReg, GPRReg prototypeReg, GPRReg scratchReg);
+    void compileInstanceOf(Node&);
     
     JITCompiler::Jump convertToDouble(GPRReg value, FPRReg result, GPRReg tmp);
 
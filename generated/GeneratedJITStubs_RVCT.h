@@ -141,6 +141,17 @@ __asm void cti_op_put_by_id_fail(STUB_ARGS_DECLARATION)
     bx lr
 }
 
+extern "C" void JITStubThunked_op_put_by_id_setter(STUB_ARGS_DECLARATION);
+__asm void cti_op_put_by_id_setter(STUB_ARGS_DECLARATION)
+{
+    PRESERVE8
+    IMPORT JITStubThunked_op_put_by_id_setter
+    str lr, [sp, # THUNK_RETURN_ADDRESS_OFFSET]
+    bl JITStubThunked_op_put_by_id_setter
+    ldr lr, [sp, # THUNK_RETURN_ADDRESS_OFFSET]
+    bx lr
+}
+
 extern "C" void JITStubThunked_op_put_by_id_direct_fail(STUB_ARGS_DECLARATION);
 __asm void cti_op_put_by_id_direct_fail(STUB_ARGS_DECLARATION)
 {
@@ -15,7 +15,7 @@ static const struct HashTableValue stringTableValues[36] = {
    { "charAt", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncCharAt), (intptr_t)1 THUNK_GENERATOR(charAtThunkGenerator) },
    { "charCodeAt", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncCharCodeAt), (intptr_t)1 THUNK_GENERATOR(charCodeAtThunkGenerator) },
    { "concat", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncConcat), (intptr_t)1 THUNK_GENERATOR(0) },
-   { "indexOf", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncIndexOf), (intptr_t)1 THUNK_GENERATOR(0) },
+   { "indexOf", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncIndexOf), (intptr_t)1 THUNK_GENERATOR(stringIndexOfThunkGenerator) },
    { "lastIndexOf", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncLastIndexOf), (intptr_t)1 THUNK_GENERATOR(0) },
    { "match", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncMatch), (intptr_t)1 THUNK_GENERATOR(0) },
    { "replace", DontEnum|Function, (intptr_t)static_cast<NativeFunction>(stringProtoFuncReplace), (intptr_t)2 THUNK_GENERATOR(0) },
@@ -26,6 +26,9 @@
 #include "config.h"
 #include "ConservativeRoots.h"
 
+#include "Heap.h"
+#include "JSValue.h"
+
 namespace JSC {
 
 inline bool isPointerAligned(void* p)
@@ -58,6 +61,23 @@ inline void ConservativeRoots::add(void* p, TinyBloomFilter filter)
     if (!m_blocks->set().contains(candidate))
         return;
 
+#if ENABLE(INCREMENTAL_MARKING)
+    // While an incremental cycle is finishing, marked cells have been traced
+    // already, and a pointer is only valid if its cell was allocated when the
+    // cycle began. The snapshot of the mark bits filters duplicates the same
+    // way the mark bits do below.
+    if (candidate->heap()->isIncrementallyMarking()) {
+        if (candidate->isMarked(p) || !candidate->testAndClearMarkedInSnapshot(p))
+            return;
+
+        if (m_size == m_capacity)
+            grow();
+
+        m_roots[m_size++] = static_cast<JSCell*>(p);
+        return;
+    }
+#endif
+
     // The conservative set inverts the typical meaning of mark bits: We only
     // visit marked pointers, and our visit clears the mark bit. This efficiently
     // sifts out pointers to dead objects and duplicate pointers.
@@ -82,4 +102,27 @@ void ConservativeRoots::add(void* begin, void* end)
         add(*it, filter);
 }
 
+void ConservativeRoots::addEncodedValues(void* begin, void* end)
+{
+#if USE(JSVALUE64)
+    ASSERT(begin <= end);
+    ASSERT((static_cast<char*>(end) - static_cast<char*>(begin)) < 0x1000000);
+    ASSERT(isPointerAligned(begin));
+    ASSERT(isPointerAligned(end));
+
+    // Call frame headers hold raw pointers and ints rather than JSValues, but
+    // a pointer never has tag bits set, so it still gets a conservative look.
+    TinyBloomFilter filter = m_blocks->filter();
+    for (EncodedJSValue* it = static_cast<EncodedJSValue*>(begin); it != static_cast<EncodedJSValue*>(end); ++it) {
+        if (reinterpret_cast<intptr_t>(*it) & TagMask)
+            continue;
+        add(reinterpret_cast<void*>(*it), filter);
+    }
+#else
+    // With split tags and payloads, header slots only set their payload, so
+    // their tag says nothing about what they hold.
+    add(begin, end);
+#endif
+}
+
 } // namespace JSC
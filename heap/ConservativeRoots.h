@@ -41,6 +41,14 @@ public:
     ~ConservativeRoots();
 
     void add(void* begin, void* end);
+
+    // Like add(), but for a range of encoded JSValues and raw pointers, such
+    // as the RegisterFile. Slots that hold immediates can't point to cells,
+    // so they are skipped without looking up their block. This is only a
+    // prefilter: every other slot, live or dead, is still treated as a
+    // possible root, since there is no liveness information for the
+    // RegisterFile.
+    void addEncodedValues(void* begin, void* end);
     
     size_t size();
     JSCell** roots();
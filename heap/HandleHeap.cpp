@@ -88,9 +88,7 @@ void HandleHeap::visitWeakHandles(HeapRootVisitor& heapRootVisitor)
             continue;
 
         WeakHandleOwner* weakOwner = node->weakOwner();
-        if (!weakOwner)
-            continue;
-
+        ASSERT(weakOwner);
         if (!weakOwner->isReachableFromOpaqueRoots(Handle<Unknown>::wrapSlot(node->slot()), node->weakOwnerContext(), visitor))
             continue;
 
@@ -98,25 +96,74 @@ void HandleHeap::visitWeakHandles(HeapRootVisitor& heapRootVisitor)
     }
 }
 
-void HandleHeap::finalizeWeakHandles()
+#if ENABLE(GGC)
+void HandleHeap::visitOwnedWeakHandles(HeapRootVisitor& heapRootVisitor)
 {
+    // A nursery collection does not revisit old objects, so the set of opaque
+    // roots is incomplete and cannot be used to prove a weak handle dead.
+    // Keep every owned weak handle alive and leave the decision to the next
+    // full collection.
     Node* end = m_weakList.end();
-    for (Node* node = m_weakList.begin(); node != end; node = m_nextToFinalize) {
-        m_nextToFinalize = node->next();
+    for (Node* node = m_weakList.begin(); node != end; node = node->next()) {
 #if ENABLE(GC_VALIDATION)
         if (!isValidWeakNode(node))
             CRASH();
 #endif
-
         JSCell* cell = node->slot()->asCell();
         if (Heap::isMarked(cell))
             continue;
 
-        if (WeakHandleOwner* weakOwner = node->weakOwner()) {
-            weakOwner->finalize(Handle<Unknown>::wrapSlot(node->slot()), node->weakOwnerContext());
-            if (m_nextToFinalize != node->next()) // Owner deallocated node.
-                continue;
+        ASSERT(node->weakOwner());
+        heapRootVisitor.visit(node->slot());
+    }
+}
+#endif
+
+void HandleHeap::finalizeWeakHandles()
+{
+    // Clearing a handle that has no owner can't call out, so dead unowned
+    // handles are retired in a single pass that only reads mark bits.
+    Node* end = m_unownedWeakList.end();
+    for (Node* node = m_unownedWeakList.begin(); node != end;) {
+        Node* next = node->next();
+#if ENABLE(GC_VALIDATION)
+        if (!isValidWeakNode(node))
+            CRASH();
+#endif
+        if (!Heap::isMarked(node->slot()->asCell())) {
+            *node->slot() = JSValue();
+            SentinelLinkedList<Node>::remove(node);
+            m_immediateList.push(node);
+        }
+        node = next;
+    }
+
+    // Gather the dead owned handles before calling any finalizer, so that the
+    // scan of live handles isn't interleaved with owner callbacks, and so that
+    // a finalizer deallocating other handles can't disturb the scan.
+    end = m_weakList.end();
+    for (Node* node = m_weakList.begin(); node != end;) {
+        Node* next = node->next();
+#if ENABLE(GC_VALIDATION)
+        if (!isValidWeakNode(node))
+            CRASH();
+#endif
+        if (!Heap::isMarked(node->slot()->asCell())) {
+            SentinelLinkedList<Node>::remove(node);
+            m_finalizeList.push(node);
         }
+        node = next;
+    }
+
+    end = m_finalizeList.end();
+    for (Node* node = m_finalizeList.begin(); node != end; node = m_nextToFinalize) {
+        m_nextToFinalize = node->next();
+
+        WeakHandleOwner* weakOwner = node->weakOwner();
+        ASSERT(weakOwner);
+        weakOwner->finalize(Handle<Unknown>::wrapSlot(node->slot()), node->weakOwnerContext());
+        if (m_nextToFinalize != node->next()) // Owner deallocated node.
+            continue;
 #if ENABLE(GC_VALIDATION)
         if (!isLiveNode(node))
             CRASH();
@@ -151,7 +198,7 @@ void HandleHeap::writeBarrier(HandleSlot slot, const JSValue& value)
     }
 
     if (node->isWeak()) {
-        m_weakList.push(node);
+        weakListFor(node).push(node);
 #if ENABLE(GC_VALIDATION)
         if (!isLiveNode(node))
             CRASH();
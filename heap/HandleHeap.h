@@ -63,6 +63,9 @@ public:
 
     void visitStrongHandles(HeapRootVisitor&);
     void visitWeakHandles(HeapRootVisitor&);
+#if ENABLE(GGC)
+    void visitOwnedWeakHandles(HeapRootVisitor&);
+#endif
     void finalizeWeakHandles();
 
     void writeBarrier(HandleSlot, const JSValue&);
@@ -112,6 +115,7 @@ private:
     static Node* toNode(HandleSlot);
 
     void grow();
+    SentinelLinkedList<Node>& weakListFor(Node*);
     
 #if ENABLE(GC_VALIDATION) || !ASSERT_DISABLED
     bool isValidWeakNode(Node*);
@@ -122,7 +126,9 @@ private:
     BlockStack<Node> m_blockStack;
 
     SentinelLinkedList<Node> m_strongList;
-    SentinelLinkedList<Node> m_weakList;
+    SentinelLinkedList<Node> m_weakList; // Weak handles whose owners get callbacks.
+    SentinelLinkedList<Node> m_unownedWeakList; // Weak handles with no owner, which only need clearing.
+    SentinelLinkedList<Node> m_finalizeList;
     SentinelLinkedList<Node> m_immediateList;
     SinglyLinkedList<Node> m_freeList;
     Node* m_nextToFinalize;
@@ -199,7 +205,13 @@ inline void HandleHeap::makeWeak(HandleSlot handle, WeakHandleOwner* weakOwner,
         return;
     }
 
-    m_weakList.push(node);
+    weakListFor(node).push(node);
+}
+
+inline SentinelLinkedList<HandleHeap::Node>& HandleHeap::weakListFor(Node* node)
+{
+    ASSERT(node->isWeak());
+    return node->weakOwner() ? m_weakList : m_unownedWeakList;
 }
 
 #if !ASSERT_DISABLED
@@ -22,17 +22,23 @@
 #include "config.h"
 #include "Heap.h"
 
+#include "AllocationProfiler.h"
 #include "CodeBlock.h"
 #include "ConservativeRoots.h"
+#include "Executable.h"
 #include "GCActivityCallback.h"
 #include "HeapRootVisitor.h"
+#include "HeapSnapshot.h"
 #include "Interpreter.h"
 #include "JSGlobalData.h"
 #include "JSGlobalObject.h"
 #include "JSLock.h"
 #include "JSONObject.h"
+#include "PauseTelemetry.h"
+#include "ScriptSourceCache.h"
 #include "Tracing.h"
 #include <algorithm>
+#include <wtf/CurrentTime.h>
 
 //+EAWebKitChange
 //10/24/2011
@@ -139,15 +145,148 @@ inline void ClearMarks::operator()(MarkedBlock* block)
     block->notifyMayHaveFreshFreeCells();
 }
 
-struct Sweep : MarkedBlock::VoidFunctor {
+#if ENABLE(GGC)
+struct ClearNurseryMarks : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock*);
+};
+
+inline void ClearNurseryMarks::operator()(MarkedBlock* block)
+{
+    // Old blocks keep their mark bits; a marked cell in an old block is
+    // considered live until the next full collection.
+    if (!block->inNewSpace())
+        return;
+    block->clearMarks();
+    block->notifyMayHaveFreshFreeCells();
+}
+
+class VisitRememberedCell {
+public:
+    VisitRememberedCell(SlotVisitor&);
+    void operator()(JSCell*);
+
+private:
+    SlotVisitor& m_visitor;
+};
+
+inline VisitRememberedCell::VisitRememberedCell(SlotVisitor& visitor)
+    : m_visitor(visitor)
+{
+}
+
+inline void VisitRememberedCell::operator()(JSCell* cell)
+{
+    m_visitor.appendRememberedCell(cell);
+}
+
+class VisitRememberedBlock : public MarkedBlock::VoidFunctor {
+public:
+    VisitRememberedBlock(SlotVisitor&);
+    void operator()(MarkedBlock*);
+
+private:
+    VisitRememberedCell m_visitRememberedCell;
+};
+
+inline VisitRememberedBlock::VisitRememberedBlock(SlotVisitor& visitor)
+    : m_visitRememberedCell(visitor)
+{
+}
+
+inline void VisitRememberedBlock::operator()(MarkedBlock* block)
+{
+    if (!block->isRemembered() || block->inNewSpace())
+        return;
+    block->forEachCell(m_visitRememberedCell);
+}
+
+struct Promote : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock*);
+};
+
+inline void Promote::operator()(MarkedBlock* block)
+{
+    block->setInNewSpace(false);
+    block->clearRemembered();
+}
+
+struct NurserySize : CountFunctor {
+    void operator()(MarkedBlock*);
+};
+
+inline void NurserySize::operator()(MarkedBlock* block)
+{
+    if (!block->inNewSpace())
+        return;
+    count(block->markCount() * block->cellSize());
+}
+#endif
+
+#if ENABLE(CONCURRENT_SWEEPING)
+class QueueForConcurrentSweeping : public MarkedBlock::VoidFunctor {
+public:
+    QueueForConcurrentSweeping(Vector<MarkedBlock*>&);
+    void operator()(MarkedBlock*);
+
+private:
+    Vector<MarkedBlock*>& m_blocksToSweep;
+};
+
+inline QueueForConcurrentSweeping::QueueForConcurrentSweeping(Vector<MarkedBlock*>& blocksToSweep)
+    : m_blocksToSweep(blocksToSweep)
+{
+}
+
+inline void QueueForConcurrentSweeping::operator()(MarkedBlock* block)
+{
+    block->notifyMayBeSweptConcurrently();
+    m_blocksToSweep.append(block);
+}
+#endif
+
+#if ENABLE(INCREMENTAL_MARKING)
+struct SnapshotMarks : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock*);
+};
+
+inline void SnapshotMarks::operator()(MarkedBlock* block)
+{
+    block->snapshotMarks();
+}
+
+struct RestoreMarks : MarkedBlock::VoidFunctor {
+    void operator()(MarkedBlock*);
+};
+
+inline void RestoreMarks::operator()(MarkedBlock* block)
+{
+    block->restoreMarksFromSnapshot();
+}
+
+// Blocks that the write barrier remembered, and blocks allocated during the
+// cycle, may hold traced objects that now point to untraced ones.
+class VisitDirtiedBlock : public MarkedBlock::VoidFunctor {
+public:
+    VisitDirtiedBlock(SlotVisitor&);
     void operator()(MarkedBlock*);
+
+private:
+    VisitRememberedCell m_visitRememberedCell;
 };
 
-inline void Sweep::operator()(MarkedBlock* block)
+inline VisitDirtiedBlock::VisitDirtiedBlock(SlotVisitor& visitor)
+    : m_visitRememberedCell(visitor)
 {
-    block->sweep();
 }
 
+inline void VisitDirtiedBlock::operator()(MarkedBlock* block)
+{
+    if (!block->isRemembered() && !block->inNewSpace())
+        return;
+    block->forEachCell(m_visitRememberedCell);
+}
+#endif
+
 struct MarkCount : CountFunctor {
     void operator()(MarkedBlock*);
 };
@@ -265,24 +404,97 @@ inline PassOwnPtr<TypeCountSet> RecordType::returnValue()
     return m_typeCountSet.release();
 }
 
+class GCPhaseTimer {
+public:
+    GCPhaseTimer(GCPhaseStatistics*, GCPhase, NewSpace&);
+    ~GCPhaseTimer();
+
+private:
+    GCPhaseStatistics& m_statistics;
+    GCPhase m_phase;
+    NewSpace& m_newSpace;
+    double m_startTime;
+    PauseScope m_pause;
+};
+
+inline GCPhaseTimer::GCPhaseTimer(GCPhaseStatistics* statistics, GCPhase phase, NewSpace& newSpace)
+    : m_statistics(statistics[phase])
+    , m_phase(phase)
+    , m_newSpace(newSpace)
+    , m_startTime(currentTime())
+    , m_pause(GCPhasePause, phase, newSpace.waterMark())
+{
+    JAVASCRIPTCORE_GC_PHASE_BEGIN(phase, m_newSpace.waterMark());
+}
+
+inline GCPhaseTimer::~GCPhaseTimer()
+{
+    m_statistics.record(currentTime() - m_startTime);
+    m_pause.setBytes(m_newSpace.waterMark());
+    JAVASCRIPTCORE_GC_PHASE_END(m_phase, m_newSpace.waterMark());
+}
+
 } // anonymous namespace
 
+GCPhaseStatistics::GCPhaseStatistics()
+    : count(0)
+    , totalTime(0)
+    , maxTime(0)
+{
+    for (size_t i = 0; i < histogramSize; ++i)
+        histogram[i] = 0;
+}
+
+void GCPhaseStatistics::record(double seconds)
+{
+    ++count;
+    totalTime += seconds;
+    maxTime = max(maxTime, seconds);
+
+    size_t bucket = 0;
+    for (double limit = 0.0005; bucket < histogramSize - 1 && seconds >= limit; limit *= 2)
+        ++bucket;
+    ++histogram[bucket];
+}
+
 Heap::Heap(JSGlobalData* globalData, HeapSize heapSize)
     : m_heapSize(heapSize)
     , m_minBytesPerCycle(heapSizeForHint(heapSize))
     , m_operationInProgress(NoOperation)
+    , m_markEpoch(1)
     , m_newSpace(this)
     , m_extraCost(0)
+    , m_externalMemorySize(0)
+    , m_collectionCount(0)
+    , m_liveBytesAfterLastCollection(0)
+    , m_bytesFreed(0)
+    , m_bytesPromoted(0)
+    , m_collectionCountAtLastRelief(notFound)
+    , m_allocationsUntilProfilerSample(0)
+#if ENABLE(GGC)
+    , m_nurseryCollectionCount(0)
+    , m_sizeAfterLastFullCollection(0)
+    , m_sizeAfterLastCollection(0)
+    , m_pretenuresNextAllocation(false)
+#endif
+#if ENABLE(INCREMENTAL_MARKING)
+    , m_isIncrementallyMarking(false)
+#endif
     , m_markListSet(0)
     , m_activityCallback(DefaultGCActivityCallback::create(this))
     , m_machineThreads(this)
-    , m_slotVisitor(globalData->jsArrayVPtr)
+    , m_sharedData(globalData->jsArrayVPtr)
+    , m_slotVisitor(m_sharedData)
     , m_handleHeap(globalData)
     , m_isSafeToCollect(false)
     , m_globalData(globalData)
 {
     m_newSpace.setHighWaterMark(m_minBytesPerCycle);
     (*m_activityCallback)();
+#if ENABLE(CONCURRENT_SWEEPING)
+    m_isSweepingBlock = false;
+    m_mayHaveConcurrentlySweptBlocks = false;
+#endif
 #if ENABLE(LAZY_BLOCK_FREEING)
     m_numberOfFreeBlocks = 0;
     m_blockFreeingThread = createThread(blockFreeingThreadStartFunc, this, "JavaScriptCore::BlockFree");
@@ -315,6 +527,11 @@ void Heap::destroy()
 
     ASSERT(!m_globalData->dynamicGlobalObject);
     ASSERT(m_operationInProgress == NoOperation);
+
+#if ENABLE(INCREMENTAL_MARKING)
+    if (m_isIncrementallyMarking)
+        abortIncrementalMarking();
+#endif
     
     // The global object is not GC protected at this point, so sweeping may delete it
     // (and thus the global data) before other objects that may use the global data.
@@ -375,9 +592,22 @@ void Heap::blockFreeingThreadMain()
     while (!m_blockFreeingThreadShouldQuit) {
         // Generally wait for one second before scavenging free blocks. This
         // may return early, particularly when we're being asked to quit.
+#if ENABLE(CONCURRENT_SWEEPING)
+        // Don't sleep through a collection that has left us blocks to sweep.
+        {
+            MutexLocker locker(m_freeBlockLock);
+            if (m_blocksToSweep.isEmpty())
+                waitForRelativeTimeWhileHoldingLock(1.0);
+        }
+#else
         waitForRelativeTime(1.0);
+#endif
         if (m_blockFreeingThreadShouldQuit)
             break;
+
+#if ENABLE(CONCURRENT_SWEEPING)
+        sweepBlocksConcurrently();
+#endif
         
         // Now process the list of free blocks. Keep freeing until half of the
         // blocks that are currently on the list are gone. Assume that a size_t
@@ -410,6 +640,71 @@ void Heap::blockFreeingThreadMain()
 }
 #endif // ENABLE(LAZY_BLOCK_FREEING)
 
+#if ENABLE(CONCURRENT_SWEEPING)
+void Heap::startConcurrentSweeping()
+{
+    // The sweeper takes blocks from the back, so queueing them in allocation
+    // order starts it off as far from the allocator as possible.
+    MutexLocker locker(m_freeBlockLock);
+    ASSERT(m_blocksToSweep.isEmpty());
+    ASSERT(!m_isSweepingBlock);
+    QueueForConcurrentSweeping queueForConcurrentSweeping(m_blocksToSweep);
+    m_newSpace.forEachBlock(queueForConcurrentSweeping);
+    m_mayHaveConcurrentlySweptBlocks = true;
+    m_freeBlockCondition.broadcast();
+}
+
+void Heap::stopConcurrentSweeping()
+{
+    if (!m_mayHaveConcurrentlySweptBlocks)
+        return;
+
+    {
+        MutexLocker locker(m_freeBlockLock);
+        m_blocksToSweep.clear();
+        while (m_isSweepingBlock)
+            m_blockSweptCondition.wait(m_freeBlockLock);
+    }
+
+    BlockIterator end = m_blocks.set().end();
+    for (BlockIterator it = m_blocks.set().begin(); it != end; ++it)
+        (*it)->cancelConcurrentSweeping();
+    m_mayHaveConcurrentlySweptBlocks = false;
+}
+
+void Heap::sweepBlocksConcurrently()
+{
+    while (true) {
+        MarkedBlock* block = 0;
+        {
+            MutexLocker locker(m_freeBlockLock);
+            if (m_blockFreeingThreadShouldQuit)
+                return;
+            while (!m_blocksToSweep.isEmpty()) {
+                MarkedBlock* candidate = m_blocksToSweep.last();
+                m_blocksToSweep.removeLast();
+                // The allocator may have gotten here first.
+                if (candidate->tryClaimForConcurrentSweeping()) {
+                    block = candidate;
+                    break;
+                }
+            }
+            if (!block)
+                return;
+            m_isSweepingBlock = true;
+        }
+
+        block->sweepConcurrently();
+
+        {
+            MutexLocker locker(m_freeBlockLock);
+            m_isSweepingBlock = false;
+            m_blockSweptCondition.signal();
+        }
+    }
+}
+#endif
+
 void Heap::reportExtraMemoryCostSlowCase(size_t cost)
 {
     // Our frequency of garbage collection tries to balance memory use against speed
@@ -428,6 +723,168 @@ void Heap::reportExtraMemoryCostSlowCase(size_t cost)
     m_extraCost += cost;
 }
 
+inline void Heap::didGrowLargeObjectSpace(size_t sizeBefore)
+{
+    // Large storage counts towards the next collection just like new blocks
+    // do. The collection itself happens on the next allocation slow case,
+    // since the owner may not be in a state that can be visited yet.
+    size_t sizeAfter = m_largeObjectSpace.size();
+    if (sizeAfter > sizeBefore)
+        m_newSpace.addToWaterMark(sizeAfter - sizeBefore);
+}
+
+void* Heap::tryAllocateStorage(size_t bytes)
+{
+    if (bytes >= LargeObjectSpace::cutoff && UNLIKELY(wouldExceedHardLimit(bytes)) && !handleMemoryPressure(bytes))
+        return 0;
+    return allocateStorageWithoutCollecting(bytes);
+}
+
+void* Heap::allocateStorageWithoutCollecting(size_t bytes)
+{
+    if (bytes < LargeObjectSpace::cutoff) {
+        void* result;
+        if (!tryFastMalloc(bytes).getValue(result))
+            return 0;
+        return result;
+    }
+
+    size_t sizeBefore = m_largeObjectSpace.size();
+    void* result = m_largeObjectSpace.tryAllocate(bytes);
+    didGrowLargeObjectSpace(sizeBefore);
+    return result;
+}
+
+void* Heap::tryReallocateStorage(void* storage, size_t oldBytes, size_t newBytes)
+{
+    bool isLarge = m_largeObjectSpace.contains(storage);
+    if (!isLarge && newBytes < LargeObjectSpace::cutoff) {
+        void* result;
+        if (!tryFastRealloc(storage, newBytes).getValue(result))
+            return 0;
+        return result;
+    }
+
+    if (newBytes >= LargeObjectSpace::cutoff && newBytes > oldBytes && UNLIKELY(wouldExceedHardLimit(newBytes - oldBytes)) && !handleMemoryPressure(newBytes - oldBytes))
+        return 0;
+
+    if (isLarge && newBytes >= LargeObjectSpace::cutoff) {
+        size_t sizeBefore = m_largeObjectSpace.size();
+        void* result = m_largeObjectSpace.tryReallocate(storage, newBytes);
+        didGrowLargeObjectSpace(sizeBefore);
+        return result;
+    }
+
+    // The storage is moving into or out of the large object space.
+    void* result = allocateStorageWithoutCollecting(newBytes);
+    if (!result)
+        return 0;
+    memcpy(result, storage, min(oldBytes, newBytes));
+    freeStorage(storage);
+    return result;
+}
+
+void Heap::freeStorage(void* storage)
+{
+    if (m_largeObjectSpace.contains(storage)) {
+        m_largeObjectSpace.deallocate(storage);
+        return;
+    }
+    fastFree(storage);
+}
+
+static inline size_t hardLimit()
+{
+#if PLATFORM(EA)
+    return JSGetHeapHardLimit();
+#else
+    return 0;
+#endif
+}
+
+size_t Heap::committedBytes()
+{
+    size_t bytes = m_blocks.set().size() * MarkedBlock::blockSize + m_largeObjectSpace.capacity() + m_externalMemorySize + m_extraCost;
+#if ENABLE(LAZY_BLOCK_FREEING)
+    {
+        MutexLocker locker(m_freeBlockLock);
+        bytes += m_numberOfFreeBlocks * MarkedBlock::blockSize;
+    }
+#endif
+#if ENABLE(EXECUTABLE_ALLOCATOR_FIXED)
+    bytes += ExecutableAllocator::committedByteCount();
+#endif
+    return bytes;
+}
+
+inline bool Heap::wouldExceedHardLimit(size_t bytes)
+{
+    size_t limit = hardLimit();
+    return limit && committedBytes() + bytes > limit;
+}
+
+bool Heap::handleMemoryPressure(size_t bytes)
+{
+    // Shed what can be rebuilt at most once between collections, so that
+    // running past the limit doesn't turn every slow case into a full
+    // collection.
+    if (m_isSafeToCollect && m_operationInProgress == NoOperation && m_collectionCount != m_collectionCountAtLastRelief) {
+        relieveMemoryPressure();
+        m_collectionCountAtLastRelief = m_collectionCount;
+        if (!wouldExceedHardLimit(bytes))
+            return true;
+    }
+
+#if PLATFORM(EA)
+    if (JSMemoryPressureCallback callback = JSGetMemoryPressureCallback())
+        return callback(committedBytes(), bytes, hardLimit());
+#endif
+    return false;
+}
+
+struct ClearSourceProviderCache : MarkedBlock::VoidFunctor {
+    void operator()(JSCell*);
+};
+
+inline void ClearSourceProviderCache::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&ScriptExecutable::s_info))
+        return;
+    static_cast<ScriptExecutable*>(cell)->source().provider()->clearCache();
+}
+
+class RecordSnapshotCell : public MarkedBlock::VoidFunctor {
+public:
+    RecordSnapshotCell(HeapSnapshot&);
+    void operator()(JSCell*);
+
+private:
+    HeapSnapshot& m_snapshot;
+};
+
+inline RecordSnapshotCell::RecordSnapshotCell(HeapSnapshot& snapshot)
+    : m_snapshot(snapshot)
+{
+}
+
+inline void RecordSnapshotCell::operator()(JSCell* cell)
+{
+    m_snapshot.appendCell(cell, MarkedBlock::blockFor(cell)->cellSize());
+}
+
+void Heap::relieveMemoryPressure()
+{
+    forEachCell<ClearSourceProviderCache>();
+    m_globalData->scriptSourceCache->clear();
+
+    // This discards the JIT code of functions that aren't on the stack and
+    // the compiled regular expressions, then collects all garbage.
+    m_globalData->releaseExecutableMemory();
+#if ENABLE(LAZY_BLOCK_FREEING)
+    releaseFreeBlocks();
+#endif
+}
+
 inline void* Heap::tryAllocate(NewSpace::SizeClass& sizeClass)
 {
     m_operationInProgress = Allocation;
@@ -443,11 +900,24 @@ void* Heap::allocateSlowCase(NewSpace::SizeClass& sizeClass)
     ASSERT(m_operationInProgress == NoOperation);
 #endif
 
-    void* result = tryAllocate(sizeClass);
+    void* result;
+    {
+        GCPhaseTimer timer(m_phaseStatistics, SweepPhase, m_newSpace);
+        result = tryAllocate(sizeClass);
+    }
 
     if (LIKELY(result != 0))
         return result;
 
+    if (UNLIKELY(wouldExceedHardLimit(MarkedBlock::blockSize))) {
+        // Cells can't fail to allocate, so this goes ahead whatever the
+        // embedder says, but whatever was shed may have made room.
+        handleMemoryPressure(MarkedBlock::blockSize);
+        result = tryAllocate(sizeClass);
+        if (result)
+            return result;
+    }
+
     AllocationEffort allocationEffort;
     
     if (m_newSpace.waterMark() < m_newSpace.highWaterMark() || !m_isSafeToCollect)
@@ -455,7 +925,7 @@ void* Heap::allocateSlowCase(NewSpace::SizeClass& sizeClass)
     else
         allocationEffort = AllocationCanFail;
     
-    MarkedBlock* block = allocateBlock(sizeClass.cellSize, allocationEffort);
+    MarkedBlock* block = allocateBlock(sizeClass, allocationEffort);
     if (block) {
         m_newSpace.addBlock(sizeClass, block);
         void* result = tryAllocate(sizeClass);
@@ -472,7 +942,7 @@ void* Heap::allocateSlowCase(NewSpace::SizeClass& sizeClass)
     
     ASSERT(m_newSpace.waterMark() < m_newSpace.highWaterMark());
     
-    m_newSpace.addBlock(sizeClass, allocateBlock(sizeClass.cellSize, AllocationMustSucceed));
+    m_newSpace.addBlock(sizeClass, allocateBlock(sizeClass, AllocationMustSucceed));
     
     result = tryAllocate(sizeClass);
     ASSERT(result);
@@ -550,6 +1020,10 @@ void Heap::getConservativeRegisterRoots(HashSet<JSCell*>& roots)
     ASSERT(isValidThreadState(m_globalData));
     if (m_operationInProgress != NoOperation)
         CRASH();
+#if ENABLE(INCREMENTAL_MARKING)
+    if (m_isIncrementallyMarking)
+        abortIncrementalMarking();
+#endif
     m_operationInProgress = Collection;
     ConservativeRoots registerFileRoots(&m_blocks);
     registerFile().gatherConservativeRoots(registerFileRoots);
@@ -562,7 +1036,7 @@ void Heap::getConservativeRegisterRoots(HashSet<JSCell*>& roots)
     m_operationInProgress = NoOperation;
 }
 
-void Heap::markRoots()
+void Heap::markRoots(CollectionType collectionType)
 {
     ASSERT(isValidThreadState(m_globalData));
     if (m_operationInProgress != NoOperation)
@@ -579,11 +1053,44 @@ void Heap::markRoots()
     ConservativeRoots registerFileRoots(&m_blocks);
     registerFile().gatherConservativeRoots(registerFileRoots);
 
+#if ENABLE(INCREMENTAL_MARKING)
+    // The slices of an incremental cycle have already marked everything that
+    // was reachable when it began, so their marks stand.
+    bool isFinishingIncrementalMarking = m_isIncrementallyMarking;
+    m_isIncrementallyMarking = false;
+    if (isFinishingIncrementalMarking)
+        ASSERT(collectionType == FullCollection);
+    else if (collectionType == NurseryCollection)
+        clearNurseryMarks();
+    else
+        clearMarks();
+#elif ENABLE(GGC)
+    if (collectionType == NurseryCollection)
+        clearNurseryMarks();
+    else
+        clearMarks();
+#else
+    ASSERT_UNUSED(collectionType, collectionType == FullCollection);
     clearMarks();
+#endif
 
     SlotVisitor& visitor = m_slotVisitor;
     HeapRootVisitor heapRootVisitor(visitor);
 
+#if ENABLE(GGC)
+    if (collectionType == NurseryCollection) {
+        visitRememberedBlocks(visitor);
+        visitor.drain();
+    }
+#endif
+
+#if ENABLE(INCREMENTAL_MARKING)
+    if (isFinishingIncrementalMarking) {
+        visitDirtiedBlocks(visitor);
+        visitor.drain();
+    }
+#endif
+
     visitor.append(machineThreadRoots);
     visitor.drain();
 
@@ -606,17 +1113,30 @@ void Heap::markRoots()
     visitor.drain();
 
     m_handleStack.visit(heapRootVisitor);
-    visitor.drain();
+    visitor.parallelDrain();
 
-    harvestWeakReferences();
+    {
+        GCPhaseTimer timer(m_phaseStatistics, HarvestWeakReferencesPhase, m_newSpace);
+        harvestWeakReferences();
+    }
 
     // Weak handles must be marked last, because their owners use the set of
     // opaque roots to determine reachability.
+#if ENABLE(GGC)
+    if (collectionType == NurseryCollection) {
+        m_handleHeap.visitOwnedWeakHandles(heapRootVisitor);
+        visitor.parallelDrain();
+        visitor.reset();
+        m_operationInProgress = NoOperation;
+        return;
+    }
+#endif
+
     int lastOpaqueRootCount;
     do {
         lastOpaqueRootCount = visitor.opaqueRootCount();
         m_handleHeap.visitWeakHandles(heapRootVisitor);
-        visitor.drain();
+        visitor.parallelDrain();
     // If the set of opaque roots has grown, more weak handles may have become reachable.
     } while (lastOpaqueRootCount != visitor.opaqueRootCount());
 
@@ -627,12 +1147,219 @@ void Heap::markRoots()
 
 void Heap::clearMarks()
 {
+    // Each block notices that its marks are stale the next time they are
+    // marked or swept, so this doesn't have to visit every block.
+    if (++m_markEpoch != MarkedBlock::markEpochBeingCleared)
+        return;
+
+    // The epoch has wrapped around. Bring every block up to date, so that
+    // none is left with an old epoch that could come round again.
+    ++m_markEpoch;
     forEachBlock<ClearMarks>();
 }
 
-void Heap::sweep()
+void Heap::startAllocationProfiling(unsigned sampleInterval)
+{
+    m_allocationProfiler = adoptPtr(new AllocationProfiler(sampleInterval));
+    m_allocationsUntilProfilerSample = m_allocationProfiler->sampleInterval();
+}
+
+PassOwnPtr<AllocationProfiler> Heap::stopAllocationProfiling()
+{
+    return m_allocationProfiler.release();
+}
+
+void Heap::sampleCellAllocation(void* cell, size_t bytes)
+{
+    m_allocationsUntilProfilerSample = m_allocationProfiler->sampleInterval();
+    bool checksSurvival = true;
+#if ENABLE(INCREMENTAL_MARKING)
+    checksSurvival = !m_isIncrementallyMarking;
+#endif
+    m_allocationProfiler->sample(m_globalData->topCallFrame, cell, bytes, AllocationProfiler::CellAllocation, checksSurvival);
+}
+
+void Heap::samplePropertyStorageAllocation(void* storage, size_t bytes)
+{
+    m_allocationsUntilProfilerSample = m_allocationProfiler->sampleInterval();
+    m_allocationProfiler->sample(m_globalData->topCallFrame, storage, bytes, AllocationProfiler::PropertyStorageAllocation, false);
+}
+
+#if ENABLE(GGC)
+void Heap::sampleAllocation(JSCell* cell, CodeBlock* codeBlock, AllocationSiteProfile* profile)
+{
+#if ENABLE(INCREMENTAL_MARKING)
+    // Cells allocated during an incremental cycle start out marked, so they
+    // would all look like survivors.
+    if (m_isIncrementallyMarking)
+        return;
+#endif
+    if (m_allocationSamples.size() >= maxAllocationSamplesPerCycle)
+        return;
+    AllocationSample sample = { cell, codeBlock, profile };
+    m_allocationSamples.append(sample);
+}
+
+void Heap::forgetAllocationSamples(CodeBlock* codeBlock)
 {
-    forEachBlock<Sweep>();
+    size_t j = 0;
+    for (size_t i = 0; i < m_allocationSamples.size(); ++i) {
+        if (m_allocationSamples[i].codeBlock != codeBlock)
+            m_allocationSamples[j++] = m_allocationSamples[i];
+    }
+    m_allocationSamples.shrink(j);
+}
+
+void Heap::updateAllocationSiteProfiles()
+{
+    // Every sampled cell was allocated since the last collection, so its mark
+    // bit says whether it survived this one.
+    for (size_t i = 0; i < m_allocationSamples.size(); ++i)
+        m_allocationSamples[i].profile->didSample(isMarked(m_allocationSamples[i].cell));
+    m_allocationSamples.shrink(0);
+}
+
+void Heap::clearNurseryMarks()
+{
+    forEachBlock<ClearNurseryMarks>();
+}
+
+void Heap::visitRememberedBlocks(SlotVisitor& visitor)
+{
+    VisitRememberedBlock visitRememberedBlock(visitor);
+    forEachBlock(visitRememberedBlock);
+}
+
+void Heap::promoteNursery()
+{
+    // Everything that survived this collection is old now, and since every
+    // old object has been traced there are no old-to-young pointers left.
+    forEachBlock<Promote>();
+}
+
+CollectionType Heap::collectionTypeFor(SweepToggle sweepToggle)
+{
+#if ENABLE(INCREMENTAL_MARKING)
+    // An incremental cycle always ends in a full collection.
+    if (m_isIncrementallyMarking)
+        return FullCollection;
+#endif
+
+    // Explicit requests for garbage collection always collect the whole heap.
+    if (sweepToggle == DoSweep)
+        return FullCollection;
+
+    // Dead old objects are only reclaimed by full collections, so we fall back
+    // to one periodically, and whenever the old generation has doubled.
+    if (m_nurseryCollectionCount >= maxNurseryCollectionsPerFullCollection)
+        return FullCollection;
+    if (m_sizeAfterLastCollection > 2 * max(m_sizeAfterLastFullCollection, m_minBytesPerCycle))
+        return FullCollection;
+
+    return NurseryCollection;
+}
+#endif
+
+#if ENABLE(INCREMENTAL_MARKING)
+void Heap::startIncrementalMarking()
+{
+    ASSERT(isValidThreadState(m_globalData));
+    ASSERT(!m_isIncrementallyMarking);
+    m_operationInProgress = Collection;
+
+    // From here on the mark bits only say what has been traced, so keep a copy
+    // of the allocated map for filtering conservative roots when the cycle
+    // ends. Sweeping the existing blocks would free cells we haven't reached
+    // yet, so until then we only allocate out of fresh blocks, whose cells
+    // all start out marked.
+    forEachBlock<SnapshotMarks>();
+    m_newSpace.stopLazySweeping();
+
+    void* dummy;
+
+    ConservativeRoots machineThreadRoots(&m_blocks);
+    m_machineThreads.gatherConservativeRoots(machineThreadRoots, &dummy);
+
+    ConservativeRoots registerFileRoots(&m_blocks);
+    registerFile().gatherConservativeRoots(registerFileRoots);
+
+    clearMarks();
+
+    // Making every block old for the rest of the cycle means that the write
+    // barrier remembers every store into an object that existed when it began.
+    promoteNursery();
+
+    // Seed the slices with the roots as they are now. They are all visited
+    // again when the cycle finishes.
+    SlotVisitor& visitor = m_slotVisitor;
+    HeapRootVisitor heapRootVisitor(visitor);
+
+    visitor.append(machineThreadRoots);
+    visitor.append(registerFileRoots);
+    markProtectedObjects(heapRootVisitor);
+    markTempSortVectors(heapRootVisitor);
+    if (m_markListSet && m_markListSet->size())
+        MarkedArgumentBuffer::markLists(heapRootVisitor, *m_markListSet);
+    if (m_globalData->exception)
+        heapRootVisitor.visit(&m_globalData->exception);
+    m_handleHeap.visitStrongHandles(heapRootVisitor);
+    m_handleStack.visit(heapRootVisitor);
+
+    m_isIncrementallyMarking = true;
+    m_operationInProgress = NoOperation;
+}
+
+void Heap::abortIncrementalMarking()
+{
+    ASSERT(m_isIncrementallyMarking);
+
+    // Give back the marks of the cells that were allocated when the cycle
+    // began; everything allocated since is marked already. With every cell
+    // marked, the work that is left can't find anything new.
+    forEachBlock<RestoreMarks>();
+    m_slotVisitor.drain();
+    m_slotVisitor.harvestWeakReferences();
+    m_slotVisitor.reset();
+
+    m_isIncrementallyMarking = false;
+}
+
+void Heap::visitDirtiedBlocks(SlotVisitor& visitor)
+{
+    VisitDirtiedBlock visitDirtiedBlock(visitor);
+    forEachBlock(visitDirtiedBlock);
+}
+#endif
+
+bool Heap::collectIncrementally(double timeBudget)
+{
+#if ENABLE(INCREMENTAL_MARKING)
+    ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
+    if (!m_isSafeToCollect || isBusy())
+        return false;
+
+    double deadline = currentTime() + timeBudget;
+
+    if (!m_isIncrementallyMarking) {
+        // Calling this every frame shouldn't turn into a collection every frame.
+        if (m_newSpace.waterMark() < m_newSpace.highWaterMark() / 2)
+            return false;
+        startIncrementalMarking();
+    }
+
+    m_operationInProgress = Collection;
+    bool isDoneMarking = m_slotVisitor.drainUntil(deadline);
+    m_operationInProgress = NoOperation;
+
+    if (!isDoneMarking)
+        return false;
+
+    collect(DoNotSweep);
+    return true;
+#else
+    UNUSED_PARAM(timeBudget);
+    return false;
+#endif
 }
 
 size_t Heap::objectCount()
@@ -642,12 +1369,12 @@ size_t Heap::objectCount()
 
 size_t Heap::size()
 {
-    return forEachBlock<Size>();
+    return forEachBlock<Size>() + m_largeObjectSpace.size() + m_externalMemorySize;
 }
 
 size_t Heap::capacity()
 {
-    return forEachBlock<Capacity>();
+    return forEachBlock<Capacity>() + m_largeObjectSpace.capacity();
 }
 
 size_t Heap::protectedGlobalObjectCount()
@@ -685,24 +1412,77 @@ void Heap::collectAllGarbage()
     collect(DoSweep);
 }
 
+void Heap::collectSpeculatively()
+{
+    if (!m_isSafeToCollect || isBusy())
+        return;
+
+    collect(DoNotSweep);
+}
+
+void Heap::takeHeapSnapshot(HeapSnapshot& snapshot)
+{
+    if (!m_isSafeToCollect)
+        return;
+
+#if ENABLE(INCREMENTAL_MARKING)
+    // Only the marking done by this collection is recorded, so start over.
+    if (m_isIncrementallyMarking)
+        abortIncrementalMarking();
+#endif
+
+    m_slotVisitor.setSnapshot(&snapshot);
+    collectAllGarbage();
+    m_slotVisitor.setSnapshot(0);
+
+    RecordSnapshotCell recordSnapshotCell(snapshot);
+    forEachCell(recordSnapshotCell);
+}
+
 void Heap::collect(SweepToggle sweepToggle)
 {
+    FastMallocTagScope tagScope("JSC/GC");
+
     ASSERT(globalData()->identifierTable == wtfThreadData().currentIdentifierTable());
     ASSERT(m_isSafeToCollect);
     JAVASCRIPTCORE_GC_BEGIN();
     
     canonicalizeBlocks();
+
+#if ENABLE(GGC)
+    CollectionType collectionType = collectionTypeFor(sweepToggle);
+#else
+    CollectionType collectionType = FullCollection;
+#endif
     
-    markRoots();
-    m_handleHeap.finalizeWeakHandles();
-    m_globalData->smallStrings.finalizeSmallStrings();
+    size_t sizeBeforeCollection = size();
+    PauseScope pause(GarbageCollectionPause, collectionType, sizeBeforeCollection);
+
+    {
+        GCPhaseTimer timer(m_phaseStatistics, MarkRootsPhase, m_newSpace);
+        markRoots(collectionType);
+    }
+#if ENABLE(GGC)
+    updateAllocationSiteProfiles();
+#endif
+    if (m_allocationProfiler)
+        m_allocationProfiler->didCollect();
+    {
+        GCPhaseTimer timer(m_phaseStatistics, FinalizePhase, m_newSpace);
+        m_handleHeap.finalizeWeakHandles();
+        m_globalData->smallStrings.finalizeSmallStrings();
+    }
 
     JAVASCRIPTCORE_GC_MARKED();
     
+    m_newSpace.orderBlocksByDensity();
     resetAllocator();
 
+    // Dead cells in blocks that still hold live objects are swept lazily, when
+    // the allocator next reaches their block, so the pause doesn't include
+    // their destructors. Empty blocks are finalized as they are released.
     if (sweepToggle == DoSweep) {
-        sweep();
+        GCPhaseTimer timer(m_phaseStatistics, ShrinkPhase, m_newSpace);
         shrink();
     }
 
@@ -710,9 +1490,31 @@ void Heap::collect(SweepToggle sweepToggle)
     // water mark to be proportional to the current size of the heap. The exact
     // proportion is a bit arbitrary. A 2X multiplier gives a 1:1 (heap size :
     // new bytes allocated) proportion, and seems to work well in benchmarks.
-    size_t proportionalBytes = 2 * size();
+    size_t currentHeapSize = size();
+    size_t proportionalBytes = 2 * currentHeapSize;
     m_newSpace.setHighWaterMark(max(proportionalBytes, m_minBytesPerCycle));
+
+    m_collectionCount++;
+    m_liveBytesAfterLastCollection = currentHeapSize;
+    if (sizeBeforeCollection > currentHeapSize)
+        m_bytesFreed += sizeBeforeCollection - currentHeapSize;
+
+#if ENABLE(GGC)
+    m_bytesPromoted += forEachBlock<NurserySize>();
+    promoteNursery();
+    m_sizeAfterLastCollection = currentHeapSize;
+    if (collectionType == FullCollection) {
+        m_nurseryCollectionCount = 0;
+        m_sizeAfterLastFullCollection = currentHeapSize;
+    } else
+        m_nurseryCollectionCount++;
+#endif
     m_newSpace.resetPropertyStorageNursery();
+#if ENABLE(CONCURRENT_SWEEPING)
+    startConcurrentSweeping();
+#endif
+    pause.setBytes(currentHeapSize);
+    JAVASCRIPTCORE_GC_HEAP_SIZE(sizeBeforeCollection, currentHeapSize);
     JAVASCRIPTCORE_GC_END();
 
     (*m_activityCallback)();
@@ -720,6 +1522,11 @@ void Heap::collect(SweepToggle sweepToggle)
 
 void Heap::canonicalizeBlocks()
 {
+#if ENABLE(CONCURRENT_SWEEPING)
+    // Blocks the sweeper has prepared hold free lists, which would look like
+    // live cells to anyone walking the heap.
+    stopConcurrentSweeping();
+#endif
     m_newSpace.canonicalizeBlocks();
 }
 
@@ -753,7 +1560,7 @@ bool Heap::isValidAllocation(size_t bytes)
     return true;
 }
 
-MarkedBlock* Heap::allocateBlock(size_t cellSize, Heap::AllocationEffort allocationEffort)
+MarkedBlock* Heap::allocateBlock(const NewSpace::SizeClass& sizeClass, Heap::AllocationEffort allocationEffort)
 {
     MarkedBlock* block;
     
@@ -761,7 +1568,7 @@ MarkedBlock* Heap::allocateBlock(size_t cellSize, Heap::AllocationEffort allocat
     if (allocationEffort == AllocationCanFail)
         return 0;
     
-    block = MarkedBlock::create(this, cellSize);
+    block = MarkedBlock::create(this, sizeClass.cellSize, sizeClass.cellsNeedDestruction);
 #else
     {
         MutexLocker locker(m_freeBlockLock);
@@ -773,11 +1580,11 @@ MarkedBlock* Heap::allocateBlock(size_t cellSize, Heap::AllocationEffort allocat
             block = 0;
     }
     if (block)
-        block->initForCellSize(cellSize);
+        block->initForCellSize(sizeClass.cellSize, sizeClass.cellsNeedDestruction);
     else if (allocationEffort == AllocationCanFail)
         return 0;
     else
-        block = MarkedBlock::create(this, cellSize);
+        block = MarkedBlock::create(this, sizeClass.cellSize, sizeClass.cellsNeedDestruction);
 #endif
     
     m_blocks.add(block);
@@ -808,6 +1615,7 @@ void Heap::shrink()
     // We record a temporary list of empties to avoid modifying m_blocks while iterating it.
     TakeIfEmpty takeIfEmpty(&m_newSpace);
     freeBlocks(forEachBlock(takeIfEmpty));
+    m_largeObjectSpace.shrink();
 }
 
 #if ENABLE(LAZY_BLOCK_FREEING)
@@ -837,6 +1645,22 @@ void Heap::releaseFreeBlocks()
 #if ENABLE(GGC)
 void Heap::writeBarrierSlowCase(const JSCell* owner, JSCell* cell)
 {
+#if ENABLE(INCREMENTAL_MARKING)
+    // While a cycle is in progress, the owner may have been traced already and
+    // the target not, so the owner has to be traced again when the cycle ends.
+    MarkedBlock* ownerBlock = MarkedBlock::blockFor(owner);
+    if (ownerBlock->heap()->isIncrementallyMarking()) {
+        ownerBlock->setRemembered();
+        return;
+    }
+#endif
+
+    // Pointers into old blocks never need to be remembered: either the target
+    // is old and therefore stays marked, or it was allocated into an old block
+    // since the last collection, in which case that block is remembered too.
+    if (!MarkedBlock::blockFor(cell)->inNewSpace())
+        return;
+    MarkedBlock::blockFor(owner)->setRemembered();
 }
 
 #else
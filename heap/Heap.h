@@ -24,6 +24,7 @@
 
 #include "HandleHeap.h"
 #include "HandleStack.h"
+#include "LargeObjectSpace.h"
 #include "MarkedBlock.h"
 #include "MarkedBlockSet.h"
 #include "NewSpace.h"
@@ -35,27 +36,55 @@
 
 namespace JSC {
 
+    class CodeBlock;
     class GCActivityCallback;
     class GlobalCodeBlock;
     class HeapRootVisitor;
+    class HeapSnapshot;
     class JSCell;
     class JSGlobalData;
     class JSValue;
     class LiveObjectIterator;
     class MarkedArgumentBuffer;
     class RegisterFile;
+    class AllocationProfiler;
     class UString;
     class WeakGCHandlePool;
     class SlotVisitor;
+    struct AllocationSiteProfile;
 
     typedef std::pair<JSValue, UString> ValueStringPair;
     typedef HashCountedSet<JSCell*> ProtectCountSet;
     typedef HashCountedSet<const char*> TypeCountSet;
 
     enum OperationInProgress { NoOperation, Allocation, Collection };
+
+    // A nursery collection only clears the mark bits of blocks allocated since
+    // the last collection, and only traces from the roots and the remembered
+    // blocks. Without GGC, every collection is a full collection.
+    enum CollectionType { FullCollection, NurseryCollection };
     
     // Heap size hint.
     enum HeapSize { SmallHeap, LargeHeap };
+
+    // The phases of garbage collection that the heap times. Marking the roots
+    // includes harvesting weak references, and a sweep is the lazy sweeping
+    // done by a single trip through the allocation slow case.
+    enum GCPhase { MarkRootsPhase, HarvestWeakReferencesPhase, FinalizePhase, SweepPhase, ShrinkPhase, NumberOfGCPhases };
+
+    struct GCPhaseStatistics {
+        // Bucket i counts times below 2^i half-milliseconds; the last bucket
+        // counts everything longer.
+        static const size_t histogramSize = 8;
+
+        GCPhaseStatistics();
+        void record(double seconds);
+
+        size_t count;
+        double totalTime;
+        double maxTime;
+        size_t histogram[histogramSize];
+    };
     
     class Heap {
         WTF_MAKE_NONCOPYABLE(Heap);
@@ -70,6 +99,7 @@ namespace JSC {
 
         static void writeBarrier(const JSCell*, JSValue);
         static void writeBarrier(const JSCell*, JSCell*);
+        static void writeBarrierForNurseryStorage(const JSCell* owner);
 
         Heap(JSGlobalData*, HeapSize);
         ~Heap();
@@ -77,6 +107,7 @@ namespace JSC {
 
         JSGlobalData* globalData() const { return m_globalData; }
         NewSpace& markedSpace() { return m_newSpace; }
+        LargeObjectSpace& largeObjectSpace() { return m_largeObjectSpace; }
         MachineThreads& machineThreads() { return m_machineThreads; }
 
         GCActivityCallback* activityCallback();
@@ -86,21 +117,88 @@ namespace JSC {
         inline bool isBusy();
 
         void* allocate(size_t);
+        // For cells whose destructor does nothing; see NeedsDestructor in JSCell.h.
+        void* allocateWithoutDestructor(size_t);
         NewSpace::SizeClass& sizeClassFor(size_t);
         void* allocate(NewSpace::SizeClass&);
+
+#if ENABLE(GGC)
+        // Allocation site profiling; see AllocationSiteScope.
+        void pretenureNextAllocation() { m_pretenuresNextAllocation = true; }
+        void cancelPretenuring() { m_pretenuresNextAllocation = false; }
+        void sampleAllocation(JSCell*, CodeBlock*, AllocationSiteProfile*);
+        void forgetAllocationSamples(CodeBlock*);
+#endif
+
+        // Allocation profiling; see AllocationProfiler.h. Starting a profile
+        // while one is running discards the running one.
+        void startAllocationProfiling(unsigned sampleInterval);
+        PassOwnPtr<AllocationProfiler> stopAllocationProfiling();
+        AllocationProfiler* allocationProfiler() const { return m_allocationProfiler.get(); }
+
         void notifyIsSafeToCollect() { m_isSafeToCollect = true; }
         void collectAllGarbage();
+        // Collects now rather than at the next allocation that reaches the
+        // watermark. This is a nursery collection when one would be, and
+        // empty blocks are kept for reuse.
+        void collectSpeculatively();
+#if ENABLE(LAZY_BLOCK_FREEING)
+        // Gives the blocks cached for reuse back to the system.
+        void releaseFreeBlocks();
+#endif
+        // Collects all garbage, recording in the snapshot every reference that
+        // marking follows, and then every cell that survived.
+        void takeHeapSnapshot(HeapSnapshot&);
+
+        // Spends up to timeBudget seconds marking incrementally, first starting
+        // a marking cycle if the heap is at least halfway to its next
+        // collection. Once marking runs out of work, one more stop-the-world
+        // pause rescans the roots and whatever the mutator wrote to, and
+        // finishes the collection; this returns true if that happened. Without
+        // ENABLE(INCREMENTAL_MARKING) this does nothing and returns false.
+        bool collectIncrementally(double timeBudget);
+#if ENABLE(INCREMENTAL_MARKING)
+        bool isIncrementallyMarking() const { return m_isIncrementallyMarking; }
+#endif
 
         inline void* allocatePropertyStorage(size_t);
         inline bool inPropertyStorageNursery(void*);
 
         void reportExtraMemoryCost(size_t cost);
 
+        // Malloc'd memory that a cell keeps alive, like a string's characters.
+        // Reported bytes count towards the next collection just like new
+        // blocks do, and remain part of the heap's size until the owner
+        // releases them from its destructor.
+        void reportExternalMemory(size_t);
+        void releaseExternalMemory(size_t);
+        size_t externalMemorySize() const { return m_externalMemorySize; }
+
+        // Out-of-line storage owned by cells. Storage of at least
+        // LargeObjectSpace::cutoff bytes comes from the large object space,
+        // which counts it towards the next collection, so owners shouldn't
+        // also report it as extra memory cost. When large storage would take
+        // the heap past its hard limit, the try variants may collect garbage
+        // before failing, so their owner must be in a state that can be
+        // visited; allocateStorage never collects.
+        void* allocateStorage(size_t);
+        void* tryAllocateStorage(size_t);
+        void* tryReallocateStorage(void*, size_t oldBytes, size_t newBytes);
+        void freeStorage(void*);
+        bool isLargeStorage(void* storage) { return m_largeObjectSpace.contains(storage); }
+
         void protect(JSValue);
         bool unprotect(JSValue); // True when the protect count drops to 0.
 
         size_t size();
         size_t capacity();
+
+        const GCPhaseStatistics& phaseStatistics(GCPhase phase) const { return m_phaseStatistics[phase]; }
+        size_t collectionCount() const { return m_collectionCount; }
+        size_t liveBytesAfterLastCollection() const { return m_liveBytesAfterLastCollection; }
+        size_t bytesFreed() const { return m_bytesFreed; } // Since the heap was created.
+        size_t bytesPromoted() const { return m_bytesPromoted; } // Since the heap was created; always 0 without GGC.
+
         size_t objectCount();
         size_t globalObjectCount();
         size_t protectedObjectCount();
@@ -142,14 +240,21 @@ namespace JSC {
 
         bool isValidAllocation(size_t);
         void reportExtraMemoryCostSlowCase(size_t);
+        void didGrowLargeObjectSpace(size_t sizeBefore);
+        void* allocateStorageWithoutCollecting(size_t);
+
+        size_t committedBytes();
+        bool wouldExceedHardLimit(size_t bytes);
+        bool handleMemoryPressure(size_t bytes);
+        void relieveMemoryPressure();
         void canonicalizeBlocks();
         void resetAllocator();
 
-        MarkedBlock* allocateBlock(size_t cellSize, AllocationEffort);
+        MarkedBlock* allocateBlock(const NewSpace::SizeClass&, AllocationEffort);
         void freeBlocks(MarkedBlock*);
 
         void clearMarks();
-        void markRoots();
+        void markRoots(CollectionType);
         void markProtectedObjects(HeapRootVisitor&);
         void markTempSortVectors(HeapRootVisitor&);
         void harvestWeakReferences();
@@ -159,9 +264,21 @@ namespace JSC {
         
         enum SweepToggle { DoNotSweep, DoSweep };
         void collect(SweepToggle);
+        void sampleCellAllocation(void*, size_t);
+        void samplePropertyStorageAllocation(void*, size_t);
+#if ENABLE(GGC)
+        CollectionType collectionTypeFor(SweepToggle);
+        void updateAllocationSiteProfiles();
+        void clearNurseryMarks();
+        void visitRememberedBlocks(SlotVisitor&);
+        void promoteNursery();
+#endif
+#if ENABLE(INCREMENTAL_MARKING)
+        void startIncrementalMarking();
+        void abortIncrementalMarking();
+        void visitDirtiedBlocks(SlotVisitor&);
+#endif
         void shrink();
-        void releaseFreeBlocks();
-        void sweep();
 
         RegisterFile& registerFile();
 
@@ -174,12 +291,20 @@ namespace JSC {
         static void* blockFreeingThreadStartFunc(void* heap);
 #endif
 
+#if ENABLE(CONCURRENT_SWEEPING)
+        void startConcurrentSweeping();
+        void stopConcurrentSweeping();
+        void sweepBlocksConcurrently();
+#endif
+
         const HeapSize m_heapSize;
         const size_t m_minBytesPerCycle;
         
         OperationInProgress m_operationInProgress;
+        unsigned m_markEpoch; // See MarkedBlock::clearMarks().
         NewSpace m_newSpace;
         MarkedBlockSet m_blocks;
+        LargeObjectSpace m_largeObjectSpace;
 
 #if ENABLE(LAZY_BLOCK_FREEING)
         DoublyLinkedList<MarkedBlock> m_freeBlocks;
@@ -191,11 +316,49 @@ namespace JSC {
         bool m_blockFreeingThreadShouldQuit;
 #endif
 
+#if ENABLE(CONCURRENT_SWEEPING)
+        Vector<MarkedBlock*> m_blocksToSweep; // Guarded by m_freeBlockLock.
+        bool m_isSweepingBlock; // Guarded by m_freeBlockLock.
+        ThreadCondition m_blockSweptCondition;
+        bool m_mayHaveConcurrentlySweptBlocks;
+#endif
+
 #if ENABLE(SIMPLE_HEAP_PROFILING)
         VTableSpectrum m_destroyedTypeCounts;
 #endif
 
         size_t m_extraCost;
+        size_t m_externalMemorySize;
+
+        GCPhaseStatistics m_phaseStatistics[NumberOfGCPhases];
+        size_t m_collectionCount;
+        size_t m_liveBytesAfterLastCollection;
+        size_t m_bytesFreed;
+        size_t m_bytesPromoted;
+        size_t m_collectionCountAtLastRelief;
+
+        OwnPtr<AllocationProfiler> m_allocationProfiler;
+        unsigned m_allocationsUntilProfilerSample;
+
+#if ENABLE(GGC)
+        static const size_t maxNurseryCollectionsPerFullCollection = 8;
+        size_t m_nurseryCollectionCount;
+        size_t m_sizeAfterLastFullCollection;
+        size_t m_sizeAfterLastCollection;
+
+        struct AllocationSample {
+            JSCell* cell;
+            CodeBlock* codeBlock;
+            AllocationSiteProfile* profile;
+        };
+        static const size_t maxAllocationSamplesPerCycle = 1024;
+        Vector<AllocationSample> m_allocationSamples;
+        bool m_pretenuresNextAllocation;
+#endif
+
+#if ENABLE(INCREMENTAL_MARKING)
+        bool m_isIncrementallyMarking;
+#endif
 
         ProtectCountSet m_protectedValues;
         Vector<Vector<ValueStringPair>* > m_tempSortingVectors;
@@ -204,6 +367,7 @@ namespace JSC {
         OwnPtr<GCActivityCallback> m_activityCallback;
         
         MachineThreads m_machineThreads;
+        MarkStackThreadSharedData m_sharedData;
         SlotVisitor m_slotVisitor;
         HandleHeap m_handleHeap;
         HandleStack m_handleStack;
@@ -255,6 +419,8 @@ namespace JSC {
     {
         if (MarkedBlock::blockFor(owner)->inNewSpace())
             return;
+        if (!cell)
+            return;
         writeBarrierSlowCase(owner, cell);
     }
 
@@ -273,6 +439,18 @@ namespace JSC {
             return;
         writeBarrierFastCase(owner, value.asCell());
     }
+
+    inline void Heap::writeBarrierForNurseryStorage(const JSCell* owner)
+    {
+        // Nursery property storage is only evacuated when its owner is traced,
+        // so an old owner has to be traced by the next collection, just as if
+        // it pointed to a young cell.
+        WriteBarrierCounters::countWriteBarrier();
+        MarkedBlock* block = MarkedBlock::blockFor(owner);
+        if (block->inNewSpace())
+            return;
+        block->setRemembered();
+    }
 #else
 
     inline void Heap::writeBarrier(const JSCell*, JSCell*)
@@ -284,6 +462,11 @@ namespace JSC {
     {
         WriteBarrierCounters::countWriteBarrier();
     }
+
+    inline void Heap::writeBarrierForNurseryStorage(const JSCell*)
+    {
+        WriteBarrierCounters::countWriteBarrier();
+    }
 #endif
 
     inline void Heap::reportExtraMemoryCost(size_t cost)
@@ -292,6 +475,18 @@ namespace JSC {
             reportExtraMemoryCostSlowCase(cost);
     }
 
+    inline void Heap::reportExternalMemory(size_t bytes)
+    {
+        m_externalMemorySize += bytes;
+        m_newSpace.addToWaterMark(bytes);
+    }
+
+    inline void Heap::releaseExternalMemory(size_t bytes)
+    {
+        ASSERT(bytes <= m_externalMemorySize);
+        m_externalMemorySize -= bytes;
+    }
+
     template<typename Functor> inline typename Functor::ReturnType Heap::forEachProtectedCell(Functor& functor)
     {
         canonicalizeBlocks();
@@ -311,6 +506,11 @@ namespace JSC {
 
     template<typename Functor> inline typename Functor::ReturnType Heap::forEachCell(Functor& functor)
     {
+#if ENABLE(INCREMENTAL_MARKING)
+        // Mark bits double as the allocated map, which they aren't mid-cycle.
+        if (m_isIncrementallyMarking)
+            abortIncrementalMarking();
+#endif
         canonicalizeBlocks();
         BlockIterator end = m_blocks.set().end();
         for (BlockIterator it = m_blocks.set().begin(); it != end; ++it)
@@ -348,8 +548,14 @@ namespace JSC {
     {
         // This is a light-weight fast path to cover the most common case.
         MarkedBlock::FreeCell* firstFreeCell = sizeClass.firstFreeCell;
-        if (UNLIKELY(!firstFreeCell))
+        if (UNLIKELY(!firstFreeCell)) {
+            char* bumpPointer = sizeClass.bumpPointer;
+            if (LIKELY(bumpPointer != sizeClass.bumpEnd)) {
+                sizeClass.bumpPointer = bumpPointer + sizeClass.cellSize;
+                return bumpPointer;
+            }
             return allocateSlowCase(sizeClass);
+        }
         
         sizeClass.firstFreeCell = firstFreeCell->next;
         return firstFreeCell;
@@ -358,8 +564,26 @@ namespace JSC {
     inline void* Heap::allocate(size_t bytes)
     {
         ASSERT(isValidAllocation(bytes));
-        NewSpace::SizeClass& sizeClass = sizeClassFor(bytes);
-        return allocate(sizeClass);
+        void* result;
+#if ENABLE(GGC)
+        if (UNLIKELY(m_pretenuresNextAllocation)) {
+            m_pretenuresNextAllocation = false;
+            result = allocate(m_newSpace.pretenuredSizeClassFor(bytes));
+        } else
+#endif
+            result = allocate(sizeClassFor(bytes));
+        if (UNLIKELY(!!m_allocationProfiler) && !--m_allocationsUntilProfilerSample)
+            sampleCellAllocation(result, bytes);
+        return result;
+    }
+
+    inline void* Heap::allocateWithoutDestructor(size_t bytes)
+    {
+        ASSERT(isValidAllocation(bytes));
+        void* result = allocate(m_newSpace.destructorFreeSizeClassFor(bytes));
+        if (UNLIKELY(!!m_allocationProfiler) && !--m_allocationsUntilProfilerSample)
+            sampleCellAllocation(result, bytes);
+        return result;
     }
 
     inline void* Heap::allocatePropertyStorage(size_t bytes)
@@ -367,12 +591,23 @@ namespace JSC {
         ASSERT(!(bytes % sizeof(JSValue)));
         if (bytes >= NewSpace::PropertyStorageNurserySize)
             return 0;
-        if (void* result = m_newSpace.allocatePropertyStorage(bytes))
-            return result;
-        collect(DoNotSweep);
-        return m_newSpace.allocatePropertyStorage(bytes);
+        // Don't collect when the nursery fills up: the caller may be in the
+        // middle of a structure transition, and falling back to old space is
+        // cheap. The nursery is reset by the next collection anyway.
+        void* result = m_newSpace.allocatePropertyStorage(bytes);
+        if (UNLIKELY(!!m_allocationProfiler) && result && !--m_allocationsUntilProfilerSample)
+            samplePropertyStorageAllocation(result, bytes);
+        return result;
     }
     
+    inline void* Heap::allocateStorage(size_t bytes)
+    {
+        void* result = allocateStorageWithoutCollecting(bytes);
+        if (!result)
+            CRASH();
+        return result;
+    }
+
     inline bool Heap::inPropertyStorageNursery(void* ptr)
     {
         return m_newSpace.inPropertyStorageNursery(ptr);
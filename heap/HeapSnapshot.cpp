@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HeapSnapshot.h"
+
+#include "ClassInfo.h"
+#include "JSCell.h"
+#include "Structure.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace JSC {
+
+HeapSnapshot::HeapSnapshot()
+{
+}
+
+void HeapSnapshot::appendCell(JSCell* cell, size_t cellSize)
+{
+    Structure* structure = cell->structure();
+    const ClassInfo* classInfo = cell->classInfo();
+
+    std::pair<HashMap<const ClassInfo*, unsigned>::iterator, bool> type = m_typeIndices.add(classInfo, m_types.size());
+    if (type.second) {
+        Summary summary = { classInfo, 0, 0, 0 };
+        m_types.append(summary);
+    }
+    Summary& typeSummary = m_types[type.first->second];
+    typeSummary.count++;
+    typeSummary.bytes += cellSize;
+
+    std::pair<HashMap<Structure*, unsigned>::iterator, bool> structureEntry = m_structureIndices.add(structure, m_structures.size());
+    if (structureEntry.second) {
+        Summary summary = { classInfo, type.first->second, 0, 0 };
+        m_structures.append(summary);
+    }
+    Summary& structureSummary = m_structures[structureEntry.first->second];
+    structureSummary.count++;
+    structureSummary.bytes += cellSize;
+
+    Node node = { type.first->second, structureEntry.first->second, cellSize };
+    m_nodes.append(node);
+    m_nodeNumbers.add(cell, m_nodes.size());
+}
+
+static void appendLiteral(Vector<char>& output, const char* literal)
+{
+    output.append(literal, strlen(literal));
+}
+
+static void appendNumber(Vector<char>& output, size_t number)
+{
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%lu", static_cast<unsigned long>(number));
+    output.append(buffer, length);
+}
+
+static void appendQuotedString(Vector<char>& output, const char* string)
+{
+    output.append('"');
+    for (const char* p = string; *p; ++p) {
+        if (*p == '"' || *p == '\\')
+            output.append('\\');
+        if (static_cast<unsigned char>(*p) >= ' ')
+            output.append(*p);
+    }
+    output.append('"');
+}
+
+void HeapSnapshot::writeJSON(Vector<char>& output) const
+{
+    appendLiteral(output, "{\"version\":1,\n\"types\":[");
+    for (size_t i = 0; i < m_types.size(); ++i) {
+        if (i)
+            output.append(',');
+        appendLiteral(output, "\n{\"name\":");
+        const ClassInfo* classInfo = m_types[i].classInfo;
+        appendQuotedString(output, classInfo && classInfo->className ? classInfo->className : "[unknown]");
+        appendLiteral(output, ",\"count\":");
+        appendNumber(output, m_types[i].count);
+        appendLiteral(output, ",\"bytes\":");
+        appendNumber(output, m_types[i].bytes);
+        output.append('}');
+    }
+
+    appendLiteral(output, "],\n\"structures\":[");
+    for (size_t i = 0; i < m_structures.size(); ++i) {
+        if (i)
+            output.append(',');
+        appendLiteral(output, "\n{\"type\":");
+        appendNumber(output, m_structures[i].type);
+        appendLiteral(output, ",\"count\":");
+        appendNumber(output, m_structures[i].count);
+        appendLiteral(output, ",\"bytes\":");
+        appendNumber(output, m_structures[i].bytes);
+        output.append('}');
+    }
+
+    appendLiteral(output, "],\n\"nodes\":[");
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (i)
+            output.append(',');
+        appendNumber(output, m_nodes[i].type);
+        output.append(',');
+        appendNumber(output, m_nodes[i].structure);
+        output.append(',');
+        appendNumber(output, m_nodes[i].size);
+    }
+
+    appendLiteral(output, "],\n\"edges\":[");
+    bool isFirstEdge = true;
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        // Both ends were marked, so they are normally live cells. Anything
+        // else is left out rather than pointing at a node that isn't there.
+        unsigned from = 0;
+        if (m_edges[i].owner) {
+            from = m_nodeNumbers.get(m_edges[i].owner);
+            if (!from)
+                continue;
+        }
+        unsigned to = m_nodeNumbers.get(m_edges[i].cell);
+        if (!to)
+            continue;
+
+        if (!isFirstEdge)
+            output.append(',');
+        isFirstEdge = false;
+        appendNumber(output, from);
+        output.append(',');
+        appendNumber(output, to);
+    }
+    appendLiteral(output, "]}\n");
+}
+
+} // namespace JSC
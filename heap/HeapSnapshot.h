@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HeapSnapshot_h
+#define HeapSnapshot_h
+
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSCell;
+class Structure;
+struct ClassInfo;
+
+// A record of every live cell after a full collection, broken down by
+// ClassInfo and Structure, along with every reference that the collection's
+// marking followed. Filled in by Heap::takeHeapSnapshot().
+class HeapSnapshot {
+    WTF_MAKE_NONCOPYABLE(HeapSnapshot);
+public:
+    HeapSnapshot();
+
+    // A null owner means that the reference is a root.
+    void appendEdge(JSCell* owner, JSCell* cell) { m_edges.append(Edge(owner, cell)); }
+    void appendCell(JSCell*, size_t cellSize);
+
+    size_t cellCount() const { return m_nodes.size(); }
+    size_t edgeCount() const { return m_edges.size(); }
+
+    // The format is:
+    // {"version":1,
+    //  "types":[{"name":<class name>,"count":<cells>,"bytes":<bytes>},...],
+    //  "structures":[{"type":<type index>,"count":<cells>,"bytes":<bytes>},...],
+    //  "nodes":[<type index>,<structure index>,<bytes>,...],
+    //  "edges":[<from node>,<to node>,...]}
+    // Node n is described by entries 3 * (n - 1) to 3 * n - 1 of "nodes", and
+    // node 0 stands for the roots.
+    void writeJSON(Vector<char>&) const;
+
+private:
+    struct Edge {
+        Edge(JSCell* owner, JSCell* cell)
+            : owner(owner)
+            , cell(cell)
+        {
+        }
+
+        JSCell* owner;
+        JSCell* cell;
+    };
+
+    struct Node {
+        unsigned type;
+        unsigned structure;
+        size_t size;
+    };
+
+    struct Summary {
+        const ClassInfo* classInfo;
+        unsigned type; // For structures, the index of their type.
+        size_t count;
+        size_t bytes;
+    };
+
+    Vector<Edge> m_edges;
+    Vector<Node> m_nodes;
+    HashMap<JSCell*, unsigned> m_nodeNumbers;
+    Vector<Summary> m_types;
+    HashMap<const ClassInfo*, unsigned> m_typeIndices;
+    Vector<Summary> m_structures;
+    HashMap<Structure*, unsigned> m_structureIndices;
+};
+
+} // namespace JSC
+
+#endif // HeapSnapshot_h
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "LargeObjectSpace.h"
+
+namespace JSC {
+
+LargeObjectSpace::LargeObjectSpace()
+    : m_size(0)
+    , m_cachedBytes(0)
+{
+}
+
+LargeObjectSpace::~LargeObjectSpace()
+{
+    HashSet<Chunk*>::iterator end = m_chunks.end();
+    for (HashSet<Chunk*>::iterator it = m_chunks.begin(); it != end; ++it) {
+        PageAllocation allocation = (*it)->allocation;
+        allocation.deallocate();
+    }
+    shrink();
+}
+
+size_t LargeObjectSpace::chunkSizeFor(size_t bytes)
+{
+    size_t pageMask = pageSize() - 1;
+    return (headerSize + bytes + pageMask) & ~pageMask;
+}
+
+void* LargeObjectSpace::tryAllocate(size_t bytes)
+{
+    ASSERT(bytes >= cutoff);
+    size_t chunkSize = chunkSizeFor(bytes);
+    if (chunkSize < bytes)
+        return 0;
+
+    size_t pages = chunkSize / pageSize();
+    PageAllocation allocation;
+    if (pages <= maxCachedPages && !m_cachedChunks[pages - 1].isEmpty()) {
+        allocation = m_cachedChunks[pages - 1].last();
+        m_cachedChunks[pages - 1].removeLast();
+        m_cachedBytes -= chunkSize;
+    } else {
+        allocation = PageAllocation::allocate(chunkSize, OSAllocator::JSGCHeapPages);
+        if (!allocation)
+            return 0;
+    }
+
+    Chunk* chunk = static_cast<Chunk*>(allocation.base());
+    chunk->allocation = allocation;
+    m_chunks.add(chunk);
+    m_size += chunkSize;
+    return storageFor(chunk);
+}
+
+void* LargeObjectSpace::tryReallocate(void* storage, size_t bytes)
+{
+    Chunk* chunk = chunkFor(storage);
+    ASSERT(m_chunks.contains(chunk));
+
+    // Growing within the chunk's last page, or shrinking, needs no copy.
+    size_t oldChunkSize = chunk->allocation.size();
+    if (chunkSizeFor(bytes) <= oldChunkSize)
+        return storage;
+
+    void* result = tryAllocate(bytes);
+    if (!result)
+        return 0;
+    memcpy(result, storage, oldChunkSize - headerSize);
+    deallocate(storage);
+    return result;
+}
+
+void LargeObjectSpace::deallocate(void* storage)
+{
+    Chunk* chunk = chunkFor(storage);
+    ASSERT(m_chunks.contains(chunk));
+    m_chunks.remove(chunk);
+
+    PageAllocation allocation = chunk->allocation;
+    m_size -= allocation.size();
+
+    size_t pages = allocation.size() / pageSize();
+    if (pages > maxCachedPages || m_cachedBytes + allocation.size() > maxCachedBytes) {
+        allocation.deallocate();
+        return;
+    }
+    m_cachedChunks[pages - 1].append(allocation);
+    m_cachedBytes += allocation.size();
+}
+
+bool LargeObjectSpace::contains(void* storage)
+{
+    if (m_chunks.isEmpty())
+        return false;
+    return m_chunks.contains(chunkFor(storage));
+}
+
+void LargeObjectSpace::shrink()
+{
+    for (size_t i = 0; i < maxCachedPages; ++i) {
+        Vector<PageAllocation>& chunks = m_cachedChunks[i];
+        for (size_t j = 0; j < chunks.size(); ++j)
+            chunks[j].deallocate();
+        chunks.clear();
+    }
+    m_cachedBytes = 0;
+}
+
+} // namespace JSC
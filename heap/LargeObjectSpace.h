@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LargeObjectSpace_h
+#define LargeObjectSpace_h
+
+#include "MarkedBlock.h"
+#include <wtf/HashSet.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/PageAllocation.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+// Backs the out-of-line storage of cells, like large ArrayStorage vectors,
+// with whole pages that the heap accounts for precisely. Freed chunks of up
+// to maxCachedPages are kept around for reuse rather than returned to the
+// OS, until the heap shrinks.
+class LargeObjectSpace {
+    WTF_MAKE_NONCOPYABLE(LargeObjectSpace);
+public:
+    // Storage smaller than this stays in fastMalloc, since rounding it up to
+    // whole pages would waste more memory than it would save.
+    static const size_t cutoff = 4 * KB;
+
+    LargeObjectSpace();
+    ~LargeObjectSpace();
+
+    void* tryAllocate(size_t);
+    void* tryReallocate(void*, size_t);
+    void deallocate(void*);
+    bool contains(void*);
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_size + m_cachedBytes; }
+
+    void shrink();
+
+private:
+    struct Chunk {
+        PageAllocation allocation;
+    };
+
+    static const size_t maxCachedPages = 16;
+    static const size_t maxCachedBytes = 256 * KB;
+    static const size_t headerSize = (sizeof(Chunk) + 15) & ~static_cast<size_t>(15);
+
+    static Chunk* chunkFor(void* storage) { return reinterpret_cast<Chunk*>(static_cast<char*>(storage) - headerSize); }
+    static void* storageFor(Chunk* chunk) { return reinterpret_cast<char*>(chunk) + headerSize; }
+    static size_t chunkSizeFor(size_t bytes);
+
+    HashSet<Chunk*> m_chunks;
+    Vector<PageAllocation> m_cachedChunks[maxCachedPages];
+    size_t m_size;
+    size_t m_cachedBytes;
+};
+
+} // namespace JSC
+
+#endif // LargeObjectSpace_h
@@ -29,19 +29,124 @@
 
 #include "ConservativeRoots.h"
 #include "Heap.h"
+#include "HeapSnapshot.h"
 #include "JSArray.h"
 #include "JSCell.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "Structure.h"
+#include <wtf/CurrentTime.h>
+
+#if ENABLE(PARALLEL_GC) && PLATFORM(EA)
+#include <JSSettingsEA.h>
+#endif
 
 namespace JSC {
 
+#if ENABLE(PARALLEL_GC)
+// Number of cells a visitor scans between offers to donate work.
+static const unsigned minimumNumberOfScansBetweenDonations = 100;
+
+static unsigned numberOfGCMarkers()
+{
+#if PLATFORM(EA)
+    return std::max<unsigned>(JSGetNumberOfGCMarkers(), 1);
+#else
+    static const unsigned defaultNumberOfGCMarkers = 2;
+    return defaultNumberOfGCMarkers;
+#endif
+}
+
+void* MarkStackThreadSharedData::markingThreadStartFunc(void* shared)
+{
+    static_cast<MarkStackThreadSharedData*>(shared)->markingThreadMain();
+    return 0;
+}
+
+void MarkStackThreadSharedData::markingThreadMain()
+{
+    SlotVisitor slotVisitor(*this);
+    slotVisitor.drainFromShared(SlotVisitor::SlaveDrain);
+}
+#endif
+
+MarkStackThreadSharedData::MarkStackThreadSharedData(void* jsArrayVPtr)
+    : m_jsArrayVPtr(jsArrayVPtr)
+    , m_firstWeakReferenceHarvester(0)
+#if ENABLE(PARALLEL_GC)
+    , m_numberOfActiveParallelMarkers(0)
+    , m_parallelMarkersShouldExit(false)
+#endif
+{
+#if ENABLE(PARALLEL_GC)
+    // The collecting thread is always one of the markers.
+    for (unsigned i = 1; i < numberOfGCMarkers(); ++i) {
+        ThreadIdentifier markingThread = createThread(markingThreadStartFunc, this, "JavaScriptCore::Marking");
+        ASSERT(markingThread);
+        m_markingThreads.append(markingThread);
+    }
+#endif
+}
+
+MarkStackThreadSharedData::~MarkStackThreadSharedData()
+{
+#if ENABLE(PARALLEL_GC)
+    {
+        MutexLocker locker(m_markingLock);
+        m_parallelMarkersShouldExit = true;
+        m_markingCondition.broadcast();
+    }
+    for (unsigned i = 0; i < m_markingThreads.size(); ++i)
+        waitForThreadCompletion(m_markingThreads[i], 0);
+#endif
+}
+
 void MarkStack::reset()
 {
     m_values.shrinkAllocation(pageSize());
     m_markSets.shrinkAllocation(pageSize());
     m_opaqueRoots.clear();
+#if ENABLE(PARALLEL_GC)
+    ASSERT(m_shared.m_sharedMarkStack.isEmpty());
+    m_shared.m_sharedMarkStack.shrinkAllocation(pageSize());
+    m_shared.m_opaqueRoots.clear();
+#endif
+}
+
+#if ENABLE(PARALLEL_GC)
+void MarkStack::donate()
+{
+    if (!m_shared.hasMarkingThreads() || m_snapshot)
+        return;
+
+    // Refuse to donate if the shared stack already holds more work than we do.
+    // Reading its size without the lock is fine; this is only a heuristic.
+    if (m_shared.m_sharedMarkStack.size() > m_values.size())
+        return;
+
+    MutexLocker locker(m_shared.m_markingLock);
+    if (m_values.donateSomeCellsTo(m_shared.m_sharedMarkStack))
+        m_shared.m_markingCondition.broadcast();
+}
+
+void MarkStack::mergeOpaqueRoots()
+{
+    if (m_opaqueRoots.isEmpty())
+        return;
+
+    {
+        MutexLocker locker(m_shared.m_opaqueRootsLock);
+        HashSet<void*>::iterator end = m_opaqueRoots.end();
+        for (HashSet<void*>::iterator it = m_opaqueRoots.begin(); it != end; ++it)
+            m_shared.m_opaqueRoots.add(*it);
+    }
+    m_opaqueRoots.clear();
+}
+#endif
+
+void MarkStack::recordSnapshotEdge(JSCell* cell)
+{
+    m_snapshot->appendEdge(m_snapshotOwner, cell);
 }
 
 void MarkStack::append(ConservativeRoots& conservativeRoots)
@@ -95,6 +200,11 @@ void SlotVisitor::drain()
     m_isDraining = true;
 #endif
     while (!m_markSets.isEmpty() || !m_values.isEmpty()) {
+        if (UNLIKELY(m_snapshot != 0)) {
+            drainForSnapshot();
+            continue;
+        }
+
         while (!m_markSets.isEmpty() && m_values.size() < 50) {
             ASSERT(!m_markSets.isEmpty());
             MarkSet& current = m_markSets.last();
@@ -133,21 +243,143 @@ void SlotVisitor::drain()
 
             visitChildren(cell);
         }
+#if ENABLE(PARALLEL_GC)
+        unsigned countdown = minimumNumberOfScansBetweenDonations;
+        while (!m_values.isEmpty()) {
+            visitChildren(m_values.removeLast());
+            if (!--countdown) {
+                donate();
+                countdown = minimumNumberOfScansBetweenDonations;
+            }
+        }
+#else
         while (!m_values.isEmpty())
             visitChildren(m_values.removeLast());
+#endif
     }
+#if ENABLE(PARALLEL_GC)
+    mergeOpaqueRoots();
+#endif
 #if !ASSERT_DISABLED
     m_isDraining = false;
 #endif
 }
 
+void SlotVisitor::flushMarkSets()
+{
+    while (!m_markSets.isEmpty()) {
+        MarkSet current = m_markSets.removeLast();
+        for (JSValue* value = current.m_values; value != current.m_end; ++value) {
+            if (*value)
+                internalAppend(*value);
+        }
+    }
+}
+
+void SlotVisitor::drainForSnapshot()
+{
+    // Mark sets are flushed as soon as they are appended, while we still
+    // know whose references they hold. The ones left over from before the
+    // first cell is visited are roots.
+    flushMarkSets();
+    while (!m_values.isEmpty()) {
+        JSCell* cell = m_values.removeLast();
+        m_snapshotOwner = cell;
+        visitChildren(cell);
+        flushMarkSets();
+    }
+    m_snapshotOwner = 0;
+}
+
+#if ENABLE(INCREMENTAL_MARKING)
+// Number of cells scanned between looks at the clock in drainUntil().
+static const unsigned numberOfScansBetweenDeadlineChecks = 100;
+
+bool SlotVisitor::drainUntil(double deadline)
+{
+#if !ASSERT_DISABLED
+    ASSERT(!m_isDraining);
+    m_isDraining = true;
+#endif
+    bool isEmpty;
+    while (true) {
+        // Mark sets point straight into object storage, which the mutator may
+        // reallocate once we return, so they are always flushed to the cell
+        // stack. Only whole cells are left over for the next slice.
+        flushMarkSets();
+
+        isEmpty = m_values.isEmpty();
+        if (isEmpty || currentTime() >= deadline)
+            break;
+
+        for (unsigned i = 0; i < numberOfScansBetweenDeadlineChecks && !m_values.isEmpty(); ++i)
+            visitChildren(m_values.removeLast());
+    }
+#if ENABLE(PARALLEL_GC)
+    mergeOpaqueRoots();
+#endif
+#if !ASSERT_DISABLED
+    m_isDraining = false;
+#endif
+    return isEmpty;
+}
+#endif
+
+#if ENABLE(PARALLEL_GC)
+void SlotVisitor::drainFromShared(SharedDrainMode sharedDrainMode)
+{
+    {
+        MutexLocker locker(m_shared.m_markingLock);
+        m_shared.m_numberOfActiveParallelMarkers++;
+    }
+    while (true) {
+        {
+            MutexLocker locker(m_shared.m_markingLock);
+            m_shared.m_numberOfActiveParallelMarkers--;
+
+            if (sharedDrainMode == MasterDrain) {
+                // Wait until either marking has terminated, or there is work
+                // for us to do.
+                while (true) {
+                    if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                        return;
+                    if (!m_shared.m_sharedMarkStack.isEmpty())
+                        break;
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+                }
+            } else {
+                ASSERT(sharedDrainMode == SlaveDrain);
+
+                // If we were the last active marker, let the master know that
+                // marking has terminated.
+                if (!m_shared.m_numberOfActiveParallelMarkers && m_shared.m_sharedMarkStack.isEmpty())
+                    m_shared.m_markingCondition.broadcast();
+
+                while (m_shared.m_sharedMarkStack.isEmpty() && !m_shared.m_parallelMarkersShouldExit)
+                    m_shared.m_markingCondition.wait(m_shared.m_markingLock);
+
+                if (m_shared.m_parallelMarkersShouldExit)
+                    return;
+            }
+
+            m_values.stealSomeCellsFrom(m_shared.m_sharedMarkStack);
+            m_shared.m_numberOfActiveParallelMarkers++;
+        }
+
+        drain();
+    }
+}
+#endif
+
 void SlotVisitor::harvestWeakReferences()
 {
-    while (m_firstWeakReferenceHarvester) {
-        WeakReferenceHarvester* current = m_firstWeakReferenceHarvester;
+    // This runs on the collecting thread once marking has terminated, so the
+    // harvester list needs no locking here.
+    while (m_shared.m_firstWeakReferenceHarvester) {
+        WeakReferenceHarvester* current = m_shared.m_firstWeakReferenceHarvester;
         WeakReferenceHarvester* next = reinterpret_cast<WeakReferenceHarvester*>(current->m_nextAndFlag & ~1);
         current->m_nextAndFlag = 0;
-        m_firstWeakReferenceHarvester = next;
+        m_shared.m_firstWeakReferenceHarvester = next;
         current->visitWeakReferences(*this);
     }
 }
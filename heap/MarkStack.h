@@ -38,10 +38,12 @@
 #include <wtf/Noncopyable.h>
 #include <wtf/OSAllocator.h>
 #include <wtf/PageBlock.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
     class ConservativeRoots;
+    class HeapSnapshot;
     class JSGlobalData;
     class MarkStack;
     class Register;
@@ -71,6 +73,11 @@ namespace JSC {
 
         void shrinkAllocation(size_t);
 
+#if ENABLE(PARALLEL_GC)
+        bool donateSomeCellsTo(MarkStackArray& other);
+        void stealSomeCellsFrom(MarkStackArray& other);
+#endif
+
     private:
         size_t m_top;
         size_t m_allocated;
@@ -78,6 +85,47 @@ namespace JSC {
         T* m_data;
     };
 
+    // State shared by all of the heap's SlotVisitors. With ENABLE(PARALLEL_GC)
+    // this also owns the marking threads and the shared pool of cells that
+    // visitors donate to and steal from.
+    class MarkStackThreadSharedData {
+        WTF_MAKE_NONCOPYABLE(MarkStackThreadSharedData);
+    public:
+        MarkStackThreadSharedData(void* jsArrayVPtr);
+        ~MarkStackThreadSharedData();
+
+#if ENABLE(PARALLEL_GC)
+        bool hasMarkingThreads() const { return !m_markingThreads.isEmpty(); }
+#endif
+
+    private:
+        friend class MarkStack;
+        friend class SlotVisitor;
+
+#if ENABLE(PARALLEL_GC)
+        void markingThreadMain();
+        static void* markingThreadStartFunc(void* sharedData);
+#endif
+
+        void* m_jsArrayVPtr;
+        WeakReferenceHarvester* m_firstWeakReferenceHarvester;
+
+#if ENABLE(PARALLEL_GC)
+        Mutex m_weakReferenceHarvesterLock;
+
+        Vector<ThreadIdentifier> m_markingThreads;
+
+        Mutex m_markingLock;
+        ThreadCondition m_markingCondition;
+        MarkStackArray<JSCell*> m_sharedMarkStack;
+        unsigned m_numberOfActiveParallelMarkers;
+        bool m_parallelMarkersShouldExit;
+
+        Mutex m_opaqueRootsLock;
+        HashSet<void*> m_opaqueRoots;
+#endif
+    };
+
     class MarkStack {
         WTF_MAKE_NONCOPYABLE(MarkStack);
         friend class HeapRootVisitor; // Allowed to mark a JSValue* or JSCell** directly.
@@ -86,7 +134,7 @@ namespace JSC {
         static void* allocateStack(size_t);
         static void releaseStack(void*, size_t);
 
-        MarkStack(void* jsArrayVPtr);
+        MarkStack(MarkStackThreadSharedData&);
         ~MarkStack();
 
         void append(ConservativeRoots&);
@@ -97,6 +145,13 @@ namespace JSC {
         
         template<typename T>
         inline void appendUnbarrieredPointer(T**);
+
+#if ENABLE(GGC)
+        // Queues an already marked cell so that its children are visited again.
+        // Used to trace old objects in remembered blocks during a nursery
+        // collection.
+        void appendRememberedCell(JSCell* cell) { m_values.append(cell); }
+#endif
         
         bool addOpaqueRoot(void*);
         bool containsOpaqueRoot(void*);
@@ -104,16 +159,24 @@ namespace JSC {
 
         void reset();
 
+        // While a snapshot is set, every reference that is appended is recorded
+        // in it, and draining is serial so that each one can be attributed to
+        // the cell that holds it.
+        void setSnapshot(HeapSnapshot* snapshot) { m_snapshot = snapshot; }
+
 #if ENABLE(SIMPLE_HEAP_PROFILING)
         VTableSpectrum m_visitedTypeCounts;
 #endif
 
         void addWeakReferenceHarvester(WeakReferenceHarvester* weakReferenceHarvester)
         {
+#if ENABLE(PARALLEL_GC)
+            MutexLocker locker(m_shared.m_weakReferenceHarvesterLock);
+#endif
             if (weakReferenceHarvester->m_nextAndFlag & 1)
                 return;
-            weakReferenceHarvester->m_nextAndFlag = reinterpret_cast<uintptr_t>(m_firstWeakReferenceHarvester) | 1;
-            m_firstWeakReferenceHarvester = weakReferenceHarvester;
+            weakReferenceHarvester->m_nextAndFlag = reinterpret_cast<uintptr_t>(m_shared.m_firstWeakReferenceHarvester) | 1;
+            m_shared.m_firstWeakReferenceHarvester = weakReferenceHarvester;
         }
 
     protected:
@@ -129,11 +192,20 @@ namespace JSC {
         void internalAppend(JSCell*);
         void internalAppend(JSValue);
 
+        void recordSnapshotEdge(JSCell*);
+
+#if ENABLE(PARALLEL_GC)
+        void donate();
+        void mergeOpaqueRoots();
+#endif
+
+        MarkStackThreadSharedData& m_shared;
         void* m_jsArrayVPtr;
         MarkStackArray<MarkSet> m_markSets;
         MarkStackArray<JSCell*> m_values;
         HashSet<void*> m_opaqueRoots; // Handle-owning data structures not visible to the garbage collector.
-        WeakReferenceHarvester* m_firstWeakReferenceHarvester;
+        HeapSnapshot* m_snapshot;
+        JSCell* m_snapshotOwner; // The cell being visited, or null for roots.
         
 #if !ASSERT_DISABLED
     public:
@@ -142,9 +214,11 @@ namespace JSC {
 #endif
     };
 
-    inline MarkStack::MarkStack(void* jsArrayVPtr)
-        : m_jsArrayVPtr(jsArrayVPtr)
-        , m_firstWeakReferenceHarvester(0)
+    inline MarkStack::MarkStack(MarkStackThreadSharedData& shared)
+        : m_shared(shared)
+        , m_jsArrayVPtr(shared.m_jsArrayVPtr)
+        , m_snapshot(0)
+        , m_snapshotOwner(0)
 #if !ASSERT_DISABLED
         , m_isCheckingForDefaultMarkViolation(false)
         , m_isDraining(false)
@@ -165,12 +239,22 @@ namespace JSC {
 
     inline bool MarkStack::containsOpaqueRoot(void* root)
     {
+#if ENABLE(PARALLEL_GC)
+        // Marking threads merge their opaque roots into the shared set when they
+        // finish draining, so this is only exact between parallel drains.
+        return m_opaqueRoots.contains(root) || m_shared.m_opaqueRoots.contains(root);
+#else
         return m_opaqueRoots.contains(root);
+#endif
     }
 
     inline int MarkStack::opaqueRootCount()
     {
+#if ENABLE(PARALLEL_GC)
+        return m_opaqueRoots.size() + m_shared.m_opaqueRoots.size();
+#else
         return m_opaqueRoots.size();
+#endif
     }
 
     inline MarkSet::MarkSet(JSValue* values, JSValue* end)
@@ -264,6 +348,30 @@ namespace JSC {
         m_capacity = m_allocated / sizeof(T);
     }
 
+#if ENABLE(PARALLEL_GC)
+    template <typename T> inline bool MarkStackArray<T>::donateSomeCellsTo(MarkStackArray<T>& other)
+    {
+        // Keep a few cells for ourselves so that we do not immediately have to
+        // come back for more. Donate half of the rest.
+        static const size_t minimumNumberOfCellsToKeep = 10;
+        if (m_top <= minimumNumberOfCellsToKeep)
+            return false;
+
+        size_t numberOfCellsToDonate = (m_top - minimumNumberOfCellsToKeep) / 2;
+        for (size_t i = 0; i < numberOfCellsToDonate; ++i)
+            other.append(removeLast());
+        return true;
+    }
+
+    template <typename T> inline void MarkStackArray<T>::stealSomeCellsFrom(MarkStackArray<T>& other)
+    {
+        static const size_t maximumNumberOfCellsToSteal = 100;
+        size_t numberOfCellsToSteal = std::min(maximumNumberOfCellsToSteal, (other.size() + 1) / 2);
+        for (size_t i = 0; i < numberOfCellsToSteal; ++i)
+            append(other.removeLast());
+    }
+#endif
+
     inline void MarkStack::append(JSValue* slot, size_t count)
     {
         if (!count)
@@ -30,14 +30,19 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 
+#if ENABLE(CONCURRENT_SWEEPING) || ENABLE(PARALLEL_GC)
+#include <wtf/Atomics.h>
+#include <wtf/Threading.h>
+#endif
+
 namespace JSC {
 
-MarkedBlock* MarkedBlock::create(Heap* heap, size_t cellSize)
+MarkedBlock* MarkedBlock::create(Heap* heap, size_t cellSize, bool cellsNeedDestruction)
 {
     PageAllocationAligned allocation = PageAllocationAligned::allocate(blockSize, blockSize, OSAllocator::JSGCHeapPages);
     if (!static_cast<bool>(allocation))
         CRASH();
-    return new (allocation.base()) MarkedBlock(allocation, heap, cellSize);
+    return new (allocation.base()) MarkedBlock(allocation, heap, cellSize, cellsNeedDestruction);
 }
 
 void MarkedBlock::destroy(MarkedBlock* block)
@@ -45,18 +50,61 @@ void MarkedBlock::destroy(MarkedBlock* block)
     block->m_allocation.deallocate();
 }
 
-MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, Heap* heap, size_t cellSize)
-    : m_inNewSpace(false)
+MarkedBlock::MarkedBlock(const PageAllocationAligned& allocation, Heap* heap, size_t cellSize, bool cellsNeedDestruction)
+    : m_markEpoch(heap->m_markEpoch)
+    , m_heapMarkEpoch(&heap->m_markEpoch)
+    , m_inNewSpace(false)
+#if ENABLE(GGC)
+    , m_isPretenured(false)
+#endif
     , m_allocation(allocation)
     , m_heap(heap)
 {
-    initForCellSize(cellSize);
+    initForCellSize(cellSize, cellsNeedDestruction);
+}
+
+void MarkedBlock::refreshMarksSlowCase()
+{
+    unsigned markEpoch = *m_heapMarkEpoch;
+#if ENABLE(PARALLEL_GC)
+    // Markers may reach a stale block at the same time. One of them clears
+    // it while the rest wait, since a mark set before the clear would be lost.
+    while (true) {
+        unsigned blockMarkEpoch = m_markEpoch;
+        if (blockMarkEpoch == markEpoch)
+            return;
+        if (blockMarkEpoch != markEpochBeingCleared && weakCompareAndSwap(&m_markEpoch, blockMarkEpoch, markEpochBeingCleared))
+            break;
+        yield();
+    }
+#endif
+
+    m_marks.clearAll();
+    // See ClearMarks in Heap.cpp. Clearing the marks is what lets a
+    // collection produce free cells, however late it happens.
+    notifyMayHaveFreshFreeCells();
+
+#if ENABLE(PARALLEL_GC)
+    // The compare-and-swap publishes the cleared bitmap along with the epoch.
+    while (!weakCompareAndSwap(&m_markEpoch, markEpochBeingCleared, markEpoch)) { }
+#else
+    m_markEpoch = markEpoch;
+#endif
 }
 
-void MarkedBlock::initForCellSize(size_t cellSize)
+void MarkedBlock::initForCellSize(size_t cellSize, bool cellsNeedDestruction)
 {
     m_atomsPerCell = (cellSize + atomSize - 1) / atomSize;
     m_endAtom = atomsPerBlock - m_atomsPerCell + 1;
+    m_cellsNeedDestruction = cellsNeedDestruction;
+    clearRemembered();
+#if ENABLE(INCREMENTAL_MARKING)
+    m_marksSnapshot.clearAll();
+#endif
+#if ENABLE(CONCURRENT_SWEEPING)
+    m_concurrentSweepState = ClaimedByAllocator;
+    m_concurrentlySweptFreeList = 0;
+#endif
     setDestructorState(SomeFreeCellsStillHaveObjects);
 }
 
@@ -89,6 +137,9 @@ void MarkedBlock::specializedReset()
 
 void MarkedBlock::reset()
 {
+    if (!m_cellsNeedDestruction)
+        return;
+
     switch (destructorState()) {
     case FreeCellsDontHaveObjects:
     case SomeFreeCellsStillHaveObjects:
@@ -124,6 +175,7 @@ void MarkedBlock::sweep()
 {
     HEAP_DEBUG_BLOCK(this);
     
+    refreshMarks();
     switch (destructorState()) {
     case FreeCellsDontHaveObjects:
         break;
@@ -168,14 +220,9 @@ ALWAYS_INLINE MarkedBlock::FreeCell* MarkedBlock::produceFreeList()
     return result;
 }
 
-MarkedBlock::FreeCell* MarkedBlock::lazySweep()
+MarkedBlock::FreeCell* MarkedBlock::sweepToFreeList()
 {
-    // This returns a free list that is ordered in reverse through the block.
-    // This is fine, since the allocation code makes no assumptions about the
-    // order of the free list.
-    
-    HEAP_DEBUG_BLOCK(this);
-    
+    refreshMarks();
     switch (destructorState()) {
     case FreeCellsDontHaveObjects:
         return produceFreeList<FreeCellsDontHaveObjects>();
@@ -187,34 +234,157 @@ MarkedBlock::FreeCell* MarkedBlock::lazySweep()
     }
 }
 
-MarkedBlock::FreeCell* MarkedBlock::blessNewBlockForFastPath()
+MarkedBlock::FreeCell* MarkedBlock::lazySweep()
 {
-    // This returns a free list that is ordered in reverse through the block,
-    // as in lazySweep() above.
+    // This returns a free list that is ordered in reverse through the block.
+    // This is fine, since the allocation code makes no assumptions about the
+    // order of the free list.
     
     HEAP_DEBUG_BLOCK(this);
+    
+    FreeCell* result;
+#if ENABLE(CONCURRENT_SWEEPING)
+    if (!takeConcurrentlySweptFreeList(result))
+#endif
+        result = sweepToFreeList();
 
-    FreeCell* result = 0;
+#if ENABLE(GGC)
+    // Cells handed out from an old block keep their mark bits until the next
+    // full collection, so a nursery collection has to rescan this block to
+    // find the young objects they point to.
+    if (result && !m_inNewSpace)
+        setRemembered();
+#endif
+
+    return result;
+}
+
+#if ENABLE(CONCURRENT_SWEEPING)
+bool MarkedBlock::takeConcurrentlySweptFreeList(FreeCell*& result)
+{
+    while (true) {
+        switch (m_concurrentSweepState) {
+        case ClaimedByAllocator:
+            return false;
+        case Unclaimed:
+            if (weakCompareAndSwap(&m_concurrentSweepState, Unclaimed, ClaimedByAllocator))
+                return false;
+            break;
+        case SweptBySweeper:
+            if (weakCompareAndSwap(&m_concurrentSweepState, SweptBySweeper, ClaimedByAllocator)) {
+                result = m_concurrentlySweptFreeList;
+                m_concurrentlySweptFreeList = 0;
+                return true;
+            }
+            break;
+        default:
+            // Sweeping a block is quick, so wait for the sweeper to finish
+            // rather than giving up on the block's free cells.
+            ASSERT(m_concurrentSweepState == ClaimedBySweeper);
+            yield();
+            break;
+        }
+    }
+}
+
+void MarkedBlock::notifyMayBeSweptConcurrently()
+{
+    ASSERT(m_concurrentSweepState == ClaimedByAllocator);
+    m_concurrentSweepState = Unclaimed;
+}
+
+bool MarkedBlock::tryClaimForConcurrentSweeping()
+{
+    return weakCompareAndSwap(&m_concurrentSweepState, Unclaimed, ClaimedBySweeper);
+}
+
+bool MarkedBlock::canSweepConcurrently()
+{
+#if ENABLE(SIMPLE_HEAP_PROFILING)
+    // Counting destroyed types isn't thread safe.
+    return false;
+#else
+    if (destructorState() == FreeCellsDontHaveObjects)
+        return true;
+
+    // Most destructors touch state that belongs to the main thread, like
+    // reference counts. A final object's only frees its property storage,
+    // which fastFree() can do from any thread.
+    void* jsFinalObjectVPtr = m_heap->globalData()->jsFinalObjectVPtr;
     for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
-        m_marks.set(i);
-        FreeCell* freeCell = reinterpret_cast<FreeCell*>(&atoms()[i]);
-        freeCell->next = result;
-        result = freeCell;
+        if (m_marks.get(i))
+            continue;
+        void* vptr = reinterpret_cast<JSCell*>(&atoms()[i])->vptr();
+        if (vptr && vptr != jsFinalObjectVPtr)
+            return false;
+    }
+    return true;
+#endif
+}
+
+void MarkedBlock::sweepConcurrently()
+{
+    ASSERT(m_concurrentSweepState == ClaimedBySweeper);
+
+    // The sweeper owns the block, so it may bring its marks up to date.
+    refreshMarks();
+
+    unsigned newState;
+    if (canSweepConcurrently()) {
+        m_concurrentlySweptFreeList = sweepToFreeList();
+        newState = SweptBySweeper;
+    } else
+        newState = Unclaimed;
+
+    // Nobody else changes the state of a block that the sweeper has claimed.
+    // The compare-and-swap publishes the free list along with the state.
+    bool didSwap = weakCompareAndSwap(&m_concurrentSweepState, ClaimedBySweeper, newState);
+    ASSERT_UNUSED(didSwap, didSwap);
+}
+
+void MarkedBlock::cancelConcurrentSweeping()
+{
+    ASSERT(m_concurrentSweepState != ClaimedBySweeper);
+
+    // A free list that the allocator never picked up has to be put back the
+    // way canonicalizeBlock() leaves a partly used one.
+    if (m_concurrentSweepState == SweptBySweeper) {
+        canonicalizeBlock(m_concurrentlySweptFreeList);
+        m_concurrentlySweptFreeList = 0;
     }
+    m_concurrentSweepState = ClaimedByAllocator;
+}
+#endif
+
+void* MarkedBlock::blessNewBlockForBumpAllocation()
+{
+    HEAP_DEBUG_BLOCK(this);
+
+    // Unlike building a free list, this doesn't touch the cells themselves,
+    // so a fresh block is only brought into the cache as it is used.
+    refreshMarks();
+    for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell)
+        m_marks.set(i);
     
     // See produceFreeList(). If we're here then we intend to fill the
     // block with objects, so once a GC happens, all free cells will be
     // occupied by objects.
     setDestructorState(AllFreeCellsHaveObjects);
 
-    return result;
+    return &atoms()[firstAtom()];
+}
+
+void* MarkedBlock::bumpAllocationEnd()
+{
+    size_t cellCount = (m_endAtom - firstAtom() + m_atomsPerCell - 1) / m_atomsPerCell;
+    return &atoms()[firstAtom() + cellCount * m_atomsPerCell];
 }
 
 void MarkedBlock::blessNewBlockForSlowPath()
 {
     HEAP_DEBUG_BLOCK(this);
 
-    m_marks.clearAll();
+    clearMarks();
     for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell)
         reinterpret_cast<FreeCell*>(&atoms()[i])->setNoObject();
     
@@ -225,7 +395,8 @@ void MarkedBlock::canonicalizeBlock(FreeCell* firstFreeCell)
 {
     HEAP_DEBUG_BLOCK(this);
     
-    ASSERT(destructorState() == AllFreeCellsHaveObjects);
+    ASSERT(destructorState() == AllFreeCellsHaveObjects || !m_cellsNeedDestruction);
+    ASSERT(!marksAreStale());
     
     if (firstFreeCell) {
         for (FreeCell* current = firstFreeCell; current;) {
@@ -243,4 +414,19 @@ void MarkedBlock::canonicalizeBlock(FreeCell* firstFreeCell)
     }
 }
 
+void MarkedBlock::canonicalizeBumpRegion(void* bumpPointer)
+{
+    HEAP_DEBUG_BLOCK(this);
+    
+    ASSERT(destructorState() == AllFreeCellsHaveObjects || !m_cellsNeedDestruction);
+    ASSERT(!marksAreStale());
+    
+    for (size_t i = atomNumber(bumpPointer); i < m_endAtom; i += m_atomsPerCell) {
+        m_marks.clear(i);
+        reinterpret_cast<FreeCell*>(&atoms()[i])->setNoObject();
+    }
+    
+    setDestructorState(SomeFreeCellsStillHaveObjects);
+}
+
 } // namespace JSC
@@ -66,6 +66,8 @@ namespace JSC {
         static const size_t atomSize = 4 * sizeof(void*);
         static const size_t blockSize = 16 * KB;
 
+        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
+
         static const size_t atomsPerBlock = blockSize / atomSize; // ~1.5% overhead
         static const size_t ownerSetsPerBlock = 8; // ~2% overhead.
 
@@ -85,7 +87,7 @@ namespace JSC {
             void returnValue() { }
         };
 
-        static MarkedBlock* create(Heap*, size_t cellSize);
+        static MarkedBlock* create(Heap*, size_t cellSize, bool cellsNeedDestruction);
         static void destroy(MarkedBlock*);
 
         static bool isAtomAligned(const void*);
@@ -96,6 +98,29 @@ namespace JSC {
         
         bool inNewSpace();
         void setInNewSpace(bool);
+#if ENABLE(GGC)
+        // Whether the block belongs to a pretenured size class.
+        bool isPretenured();
+        void setPretenured(bool);
+#endif
+
+        // A remembered block may contain old objects that point into the
+        // nursery. A nursery collection rescans every marked cell in each
+        // remembered block, so this flag is a card table with one card per
+        // block.
+        bool isRemembered();
+        void setRemembered();
+        void clearRemembered();
+        static ptrdiff_t offsetOfIsRemembered() { return OBJECT_OFFSETOF(MarkedBlock, m_isRemembered); }
+
+#if ENABLE(INCREMENTAL_MARKING)
+        // During an incremental marking cycle the mark bits only record what
+        // has been traced so far. These keep a copy of the mark bits from when
+        // the cycle began, which tells which cells were allocated at the time.
+        void snapshotMarks();
+        void restoreMarksFromSnapshot();
+        bool testAndClearMarkedInSnapshot(const void*);
+#endif
 
         void* allocate();
         void sweep();
@@ -103,16 +128,33 @@ namespace JSC {
         // This invokes destructors on all cells that are not marked, marks
         // them, and returns a linked list of those cells.
         FreeCell* lazySweep();
+
+#if ENABLE(CONCURRENT_SWEEPING)
+        // Blocks are handed to the sweeper thread after a collection, and then
+        // belong to whichever of it and the allocator claims them first. If
+        // the sweeper wins, lazySweep() returns the free list it left behind.
+        void notifyMayBeSweptConcurrently();
+        bool tryClaimForConcurrentSweeping();
+        void sweepConcurrently(); // Called on the sweeper thread.
+        // Takes the block back from the sweeper, which must be idle.
+        void cancelConcurrentSweeping();
+#endif
         
         // Notify the block that destructors may have to be called again.
         void notifyMayHaveFreshFreeCells();
         
-        void initForCellSize(size_t cellSize);
+        void initForCellSize(size_t cellSize, bool cellsNeedDestruction);
+
+        // A block whose cells need no destruction is swept just by rebuilding
+        // its free list, on whichever thread gets to it first.
+        bool cellsNeedDestruction();
         
         // These should be called immediately after a block is created.
-        // Blessing for fast path creates a linked list, while blessing for
-        // slow path creates dummy cells.
-        FreeCell* blessNewBlockForFastPath();
+        // Blessing for bump allocation marks every cell and returns the first
+        // one; cells are then handed out in order up to bumpAllocationEnd().
+        // Blessing for slow path creates dummy cells.
+        void* blessNewBlockForBumpAllocation();
+        void* bumpAllocationEnd();
         void blessNewBlockForSlowPath();
         
         void reset();
@@ -120,16 +162,27 @@ namespace JSC {
         // This unmarks all cells on the free list, and allocates dummy JSCells
         // in their place.
         void canonicalizeBlock(FreeCell* firstFreeCell);
+
+        // The same for the cells from bumpPointer to the end of a block that
+        // is being bump allocated.
+        void canonicalizeBumpRegion(void* bumpPointer);
         
         bool isEmpty();
 
+        // Mark bits are versioned by the heap's mark epoch. Advancing the
+        // epoch clears every block's marks at once: a block whose epoch is
+        // behind reads as unmarked, and clears its bitmap for real the first
+        // time its marks are written. This eagerly clears one block.
         void clearMarks();
         size_t markCount();
 
+        static const unsigned markEpochBeingCleared = 0; // The heap's epoch is never this.
+
         size_t cellSize();
 
         size_t size();
         size_t capacity();
+        size_t cellCount();
 
         bool isMarked(const void*);
         bool testAndSetMarked(const void*);
@@ -139,14 +192,13 @@ namespace JSC {
         template <typename Functor> void forEachCell(Functor&);
 
     private:
-        static const size_t blockMask = ~(blockSize - 1); // blockSize must be a power of two.
         static const size_t atomMask = ~(atomSize - 1); // atomSize must be a power of two.
         
         enum DestructorState { FreeCellsDontHaveObjects, SomeFreeCellsStillHaveObjects, AllFreeCellsHaveObjects };
 
         typedef char Atom[atomSize];
 
-        MarkedBlock(const PageAllocationAligned&, Heap*, size_t cellSize);
+        MarkedBlock(const PageAllocationAligned&, Heap*, size_t cellSize, bool cellsNeedDestruction);
         Atom* atoms();
 
         size_t atomNumber(const void*);
@@ -163,9 +215,25 @@ namespace JSC {
         
         template<DestructorState destructorState>
         MarkedBlock::FreeCell* produceFreeList();
+        FreeCell* sweepToFreeList();
+
+        bool marksAreStale();
+        void refreshMarks();
+        void refreshMarksSlowCase();
+
+#if ENABLE(CONCURRENT_SWEEPING)
+        enum ConcurrentSweepState { ClaimedByAllocator, Unclaimed, ClaimedBySweeper, SweptBySweeper };
+
+        bool canSweepConcurrently();
+        bool takeConcurrentlySweptFreeList(FreeCell*&);
+#endif
         
         void setDestructorState(DestructorState destructorState)
         {
+            // The free cells of a block without destructors never hold
+            // anything that has to be destroyed.
+            if (!m_cellsNeedDestruction)
+                destructorState = FreeCellsDontHaveObjects;
             m_destructorState = static_cast<int8_t>(destructorState);
         }
         
@@ -177,8 +245,22 @@ namespace JSC {
         size_t m_endAtom; // This is a fuzzy end. Always test for < m_endAtom.
         size_t m_atomsPerCell;
         WTF::Bitmap<blockSize / atomSize> m_marks;
+        unsigned m_markEpoch; // m_marks are only valid while this matches *m_heapMarkEpoch.
+        const unsigned* m_heapMarkEpoch;
+#if ENABLE(INCREMENTAL_MARKING)
+        WTF::Bitmap<blockSize / atomSize> m_marksSnapshot;
+#endif
         bool m_inNewSpace;
+#if ENABLE(GGC)
+        bool m_isPretenured;
+#endif
+        int32_t m_isRemembered; // 32 bits wide so that the JIT can set it with a store32.
+        bool m_cellsNeedDestruction;
         int8_t m_destructorState; // use getters/setters for this, particularly since we may want to compact this (effectively log(3)/log(2)-bit) field into other fields
+#if ENABLE(CONCURRENT_SWEEPING)
+        unsigned m_concurrentSweepState; // Only changed with compare-and-swap while the sweeper may own the block.
+        FreeCell* m_concurrentlySweptFreeList;
+#endif
         PageAllocationAligned m_allocation;
         Heap* m_heap;
         MarkedBlock* m_prev;
@@ -219,7 +301,58 @@ namespace JSC {
     {
         m_inNewSpace = inNewSpace;
     }
+
+#if ENABLE(GGC)
+    inline bool MarkedBlock::isPretenured()
+    {
+        return m_isPretenured;
+    }
+
+    inline void MarkedBlock::setPretenured(bool isPretenured)
+    {
+        m_isPretenured = isPretenured;
+    }
+#endif
     
+    inline bool MarkedBlock::cellsNeedDestruction()
+    {
+        return m_cellsNeedDestruction;
+    }
+
+    inline bool MarkedBlock::isRemembered()
+    {
+        return m_isRemembered;
+    }
+
+    inline void MarkedBlock::setRemembered()
+    {
+        m_isRemembered = 1;
+    }
+
+    inline void MarkedBlock::clearRemembered()
+    {
+        m_isRemembered = 0;
+    }
+
+#if ENABLE(INCREMENTAL_MARKING)
+    inline void MarkedBlock::snapshotMarks()
+    {
+        refreshMarks();
+        m_marksSnapshot = m_marks;
+    }
+
+    inline void MarkedBlock::restoreMarksFromSnapshot()
+    {
+        refreshMarks();
+        m_marks.merge(m_marksSnapshot);
+    }
+
+    inline bool MarkedBlock::testAndClearMarkedInSnapshot(const void* p)
+    {
+        return m_marksSnapshot.testAndClear(atomNumber(p));
+    }
+#endif
+
     inline void MarkedBlock::notifyMayHaveFreshFreeCells()
     {
         HEAP_DEBUG_BLOCK(this);
@@ -241,19 +374,31 @@ namespace JSC {
             setDestructorState(SomeFreeCellsStillHaveObjects);
     }
 
+    inline bool MarkedBlock::marksAreStale()
+    {
+        return m_markEpoch != *m_heapMarkEpoch;
+    }
+
+    inline void MarkedBlock::refreshMarks()
+    {
+        if (UNLIKELY(marksAreStale()))
+            refreshMarksSlowCase();
+    }
+
     inline bool MarkedBlock::isEmpty()
     {
-        return m_marks.isEmpty();
+        return marksAreStale() || m_marks.isEmpty();
     }
 
     inline void MarkedBlock::clearMarks()
     {
         m_marks.clearAll();
+        m_markEpoch = *m_heapMarkEpoch;
     }
     
     inline size_t MarkedBlock::markCount()
     {
-        return m_marks.count();
+        return marksAreStale() ? 0 : m_marks.count();
     }
 
     inline size_t MarkedBlock::cellSize()
@@ -271,6 +416,11 @@ namespace JSC {
         return m_allocation.size();
     }
 
+    inline size_t MarkedBlock::cellCount()
+    {
+        return (m_endAtom - firstAtom() + m_atomsPerCell - 1) / m_atomsPerCell;
+    }
+
     inline size_t MarkedBlock::atomNumber(const void* p)
     {
         return (reinterpret_cast<Bits>(p) - reinterpret_cast<Bits>(this)) / atomSize;
@@ -278,26 +428,35 @@ namespace JSC {
 
     inline bool MarkedBlock::isMarked(const void* p)
     {
-        return m_marks.get(atomNumber(p));
+        return !marksAreStale() && m_marks.get(atomNumber(p));
     }
 
     inline bool MarkedBlock::testAndSetMarked(const void* p)
     {
+        refreshMarks();
+#if ENABLE(PARALLEL_GC)
+        return m_marks.concurrentTestAndSet(atomNumber(p));
+#else
         return m_marks.testAndSet(atomNumber(p));
+#endif
     }
 
     inline bool MarkedBlock::testAndClearMarked(const void* p)
     {
+        refreshMarks();
         return m_marks.testAndClear(atomNumber(p));
     }
 
     inline void MarkedBlock::setMarked(const void* p)
     {
+        refreshMarks();
         m_marks.set(atomNumber(p));
     }
 
     template <typename Functor> inline void MarkedBlock::forEachCell(Functor& functor)
     {
+        if (marksAreStale())
+            return;
         for (size_t i = firstAtom(); i < m_endAtom; i += m_atomsPerCell) {
             if (!m_marks.get(i))
                 continue;
@@ -26,6 +26,7 @@
 #include "JSLock.h"
 #include "JSObject.h"
 #include "ScopeChain.h"
+#include <algorithm>
 
 namespace JSC {
 
@@ -38,28 +39,57 @@ NewSpace::NewSpace(Heap* heap)
     , m_highWaterMark(0)
     , m_heap(heap)
 {
-    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep) {
         sizeClassFor(cellSize).cellSize = cellSize;
+        destructorFreeSizeClassFor(cellSize).cellSize = cellSize;
+        destructorFreeSizeClassFor(cellSize).cellsNeedDestruction = false;
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).cellSize = cellSize;
+        pretenuredSizeClassFor(cellSize).isPretenured = true;
+#endif
+    }
 
-    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep) {
         sizeClassFor(cellSize).cellSize = cellSize;
+        destructorFreeSizeClassFor(cellSize).cellSize = cellSize;
+        destructorFreeSizeClassFor(cellSize).cellsNeedDestruction = false;
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).cellSize = cellSize;
+        pretenuredSizeClassFor(cellSize).isPretenured = true;
+#endif
+    }
+}
+
+NewSpace::~NewSpace()
+{
+    fastFree(m_propertyStorageNursery);
 }
 
 void NewSpace::addBlock(SizeClass& sizeClass, MarkedBlock* block)
 {
+#if ENABLE(GGC)
+    // A pretenured block is old already, so a nursery collection has to
+    // rescan it for pointers to young objects.
+    block->setPretenured(sizeClass.isPretenured);
+    block->setInNewSpace(!sizeClass.isPretenured);
+    if (sizeClass.isPretenured)
+        block->setRemembered();
+#else
     block->setInNewSpace(true);
+#endif
     sizeClass.nextBlock = block;
     sizeClass.blockList.append(block);
     ASSERT(!sizeClass.currentBlock);
     ASSERT(!sizeClass.firstFreeCell);
     sizeClass.currentBlock = block;
-    sizeClass.firstFreeCell = block->blessNewBlockForFastPath();
+    sizeClass.bumpPointer = static_cast<char*>(block->blessNewBlockForBumpAllocation());
+    sizeClass.bumpEnd = static_cast<char*>(block->bumpAllocationEnd());
 }
 
 void NewSpace::removeBlock(MarkedBlock* block)
 {
     block->setInNewSpace(false);
-    SizeClass& sizeClass = sizeClassFor(block->cellSize());
+    SizeClass& sizeClass = sizeClassFor(block);
     if (sizeClass.nextBlock == block)
         sizeClass.nextBlock = block->next();
     sizeClass.blockList.remove(block);
@@ -69,20 +99,110 @@ void NewSpace::resetAllocator()
 {
     m_waterMark = 0;
 
-    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep) {
         sizeClassFor(cellSize).resetAllocator();
+        destructorFreeSizeClassFor(cellSize).resetAllocator();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).resetAllocator();
+#endif
+    }
 
-    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep) {
         sizeClassFor(cellSize).resetAllocator();
+        destructorFreeSizeClassFor(cellSize).resetAllocator();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).resetAllocator();
+#endif
+    }
+}
+
+// Reordering is only worth its time when a size class is mostly empty.
+static const size_t minimumFragmentationToReorder = 2;
+
+static bool isDenser(const std::pair<size_t, MarkedBlock*>& a, const std::pair<size_t, MarkedBlock*>& b)
+{
+    return a.first > b.first;
+}
+
+void NewSpace::SizeClass::orderBlocksByDensity()
+{
+    ASSERT(!currentBlock);
+
+    Vector<std::pair<size_t, MarkedBlock*>, 64> blocks;
+    size_t markedCells = 0;
+    size_t cellCapacity = 0;
+    for (MarkedBlock* block = blockList.head(); block; block = block->next()) {
+        size_t markCount = block->markCount();
+        blocks.append(std::make_pair(markCount, block));
+        markedCells += markCount;
+        cellCapacity += block->capacity() / cellSize;
+    }
+    if (blocks.size() < 2 || markedCells * minimumFragmentationToReorder > cellCapacity)
+        return;
+
+    std::stable_sort(blocks.begin(), blocks.end(), isDenser);
+    while (blockList.removeHead()) { }
+    for (size_t i = 0; i < blocks.size(); ++i)
+        blockList.append(blocks[i].second);
+}
+
+void NewSpace::orderBlocksByDensity()
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep) {
+        sizeClassFor(cellSize).orderBlocksByDensity();
+        destructorFreeSizeClassFor(cellSize).orderBlocksByDensity();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).orderBlocksByDensity();
+#endif
+    }
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep) {
+        sizeClassFor(cellSize).orderBlocksByDensity();
+        destructorFreeSizeClassFor(cellSize).orderBlocksByDensity();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).orderBlocksByDensity();
+#endif
+    }
 }
 
 void NewSpace::canonicalizeBlocks()
 {
-    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep)
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep) {
         sizeClassFor(cellSize).canonicalizeBlock();
+        destructorFreeSizeClassFor(cellSize).canonicalizeBlock();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).canonicalizeBlock();
+#endif
+    }
 
-    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep)
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep) {
         sizeClassFor(cellSize).canonicalizeBlock();
+        destructorFreeSizeClassFor(cellSize).canonicalizeBlock();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).canonicalizeBlock();
+#endif
+    }
+}
+
+#if ENABLE(INCREMENTAL_MARKING)
+void NewSpace::stopLazySweeping()
+{
+    for (size_t cellSize = preciseStep; cellSize < preciseCutoff; cellSize += preciseStep) {
+        sizeClassFor(cellSize).stopLazySweeping();
+        destructorFreeSizeClassFor(cellSize).stopLazySweeping();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).stopLazySweeping();
+#endif
+    }
+
+    for (size_t cellSize = impreciseStep; cellSize < impreciseCutoff; cellSize += impreciseStep) {
+        sizeClassFor(cellSize).stopLazySweeping();
+        destructorFreeSizeClassFor(cellSize).stopLazySweeping();
+#if ENABLE(GGC)
+        pretenuredSizeClassFor(cellSize).stopLazySweeping();
+#endif
+    }
 }
+#endif
 
 } // namespace JSC
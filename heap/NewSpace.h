@@ -47,36 +47,57 @@ namespace JSC {
         WTF_MAKE_NONCOPYABLE(NewSpace);
     public:
         static const size_t maxCellSize = 1024;
-			
-		//+EAWebKitChange
-		//10/24/2011
-		// abaldeva: This looks like some unfinished code. This causes a 4 MB allocation and the NewSpace::allocatePropertyStorage
-		// code is not even called. This is because the code pasted below from the JSObject.cpp first tries to detect if the allocation
-		// came from the nursery and is the only source of allocation.
-		// Disabled this code for now.
-		//static const size_t PropertyStorageNurserySize = 4 * MB;
-		static const size_t PropertyStorageNurserySize = 0 * MB;
-		/* From JSObject.cpp
-		if (globalData.heap.inPropertyStorageNursery(m_propertyStorage.get())) {
-		newPropertyStorage = static_cast<PropertyStorage>(globalData.heap.allocatePropertyStorage(newSize * sizeof(WriteBarrierBase<Unknown>)));
-		*/
-		//-EAWebKitChange
 
+        // Out-of-line property storage is bump allocated here while it is
+        // young. Storage whose owner survives a collection is copied out to
+        // fastMalloc by JSObject::visitChildrenDirect, and the whole nursery is
+        // reset once the collection is over.
+        static const size_t PropertyStorageNurserySize = 1 * MB;
+
+        // There is one set of size classes per heap, even when several threads
+        // share the heap. They don't need their own: every thread allocates
+        // under the JSLock, which is held for as long as the thread runs
+        // JavaScript, and a collection can happen at any allocation. Caches
+        // that a thread kept while it wasn't holding the lock would be
+        // neither safe from the collector nor any less contended.
         struct SizeClass {
             SizeClass();
             void resetAllocator();
             void canonicalizeBlock();
+            void orderBlocksByDensity();
+#if ENABLE(INCREMENTAL_MARKING)
+            void stopLazySweeping();
+#endif
 
             MarkedBlock::FreeCell* firstFreeCell;
+            // A fresh currentBlock is bump allocated instead; firstFreeCell is
+            // null while bumpPointer != bumpEnd.
+            char* bumpPointer;
+            char* bumpEnd;
             MarkedBlock* currentBlock;
             MarkedBlock* nextBlock;
             DoublyLinkedList<MarkedBlock> blockList;
             size_t cellSize;
+            bool cellsNeedDestruction;
+#if ENABLE(GGC)
+            bool isPretenured;
+#endif
         };
 
         NewSpace(Heap*);
+        ~NewSpace();
 
         SizeClass& sizeClassFor(size_t);
+        // Cells that need no destruction are kept apart in size classes of
+        // their own. See MarkedBlock::cellsNeedDestruction().
+        SizeClass& destructorFreeSizeClassFor(size_t);
+#if ENABLE(GGC)
+        // Blocks in these size classes are old from the start, for objects
+        // that allocation site profiling expects to survive. See
+        // AllocationSiteProfile.
+        SizeClass& pretenuredSizeClassFor(size_t);
+#endif
+        SizeClass& sizeClassFor(MarkedBlock*);
         void* allocate(SizeClass&);
         inline void* allocatePropertyStorage(size_t);
         inline bool inPropertyStorageNursery(void* ptr);
@@ -84,12 +105,26 @@ namespace JSC {
         
         void resetAllocator();
 
+        // Cells can't move, so instead of compacting sparse blocks we stop
+        // allocating into them until the denser blocks are full. Their
+        // survivors then die off without being replaced, and the emptied
+        // blocks are freed by the next sweep. Must be called after marking,
+        // with the blocks canonicalized.
+        void orderBlocksByDensity();
+
         void addBlock(SizeClass&, MarkedBlock*);
         void removeBlock(MarkedBlock*);
         
         void canonicalizeBlocks();
 
+#if ENABLE(INCREMENTAL_MARKING)
+        // Until the next resetAllocator(), only allocate out of blocks added
+        // from now on. Must be called right after canonicalizeBlocks().
+        void stopLazySweeping();
+#endif
+
         size_t waterMark();
+        void addToWaterMark(size_t);
         size_t highWaterMark();
         void setHighWaterMark(size_t);
 
@@ -110,6 +145,12 @@ namespace JSC {
 
         SizeClass m_preciseSizeClasses[preciseCount];
         SizeClass m_impreciseSizeClasses[impreciseCount];
+        SizeClass m_destructorFreePreciseSizeClasses[preciseCount];
+        SizeClass m_destructorFreeImpreciseSizeClasses[impreciseCount];
+#if ENABLE(GGC)
+        SizeClass m_pretenuredPreciseSizeClasses[preciseCount];
+        SizeClass m_pretenuredImpreciseSizeClasses[impreciseCount];
+#endif
         char* m_propertyStorageNursery;
         char* m_propertyStorageAllocationPoint;
         size_t m_waterMark;
@@ -122,6 +163,11 @@ namespace JSC {
         return m_waterMark;
     }
 
+    inline void NewSpace::addToWaterMark(size_t bytes)
+    {
+        m_waterMark += bytes;
+    }
+
     inline size_t NewSpace::highWaterMark()
     {
         return m_highWaterMark;
@@ -140,10 +186,45 @@ namespace JSC {
         return m_impreciseSizeClasses[(bytes - 1) / impreciseStep];
     }
 
+    inline NewSpace::SizeClass& NewSpace::destructorFreeSizeClassFor(size_t bytes)
+    {
+        ASSERT(bytes && bytes < maxCellSize);
+        if (bytes <= maximumPreciseAllocationSize)
+            return m_destructorFreePreciseSizeClasses[(bytes - 1) / preciseStep];
+        return m_destructorFreeImpreciseSizeClasses[(bytes - 1) / impreciseStep];
+    }
+
+#if ENABLE(GGC)
+    inline NewSpace::SizeClass& NewSpace::pretenuredSizeClassFor(size_t bytes)
+    {
+        ASSERT(bytes && bytes < maxCellSize);
+        if (bytes <= maximumPreciseAllocationSize)
+            return m_pretenuredPreciseSizeClasses[(bytes - 1) / preciseStep];
+        return m_pretenuredImpreciseSizeClasses[(bytes - 1) / impreciseStep];
+    }
+#endif
+
+    inline NewSpace::SizeClass& NewSpace::sizeClassFor(MarkedBlock* block)
+    {
+#if ENABLE(GGC)
+        if (block->isPretenured())
+            return pretenuredSizeClassFor(block->cellSize());
+#endif
+        if (block->cellsNeedDestruction())
+            return sizeClassFor(block->cellSize());
+        return destructorFreeSizeClassFor(block->cellSize());
+    }
+
     inline void* NewSpace::allocate(SizeClass& sizeClass)
     {
         MarkedBlock::FreeCell* firstFreeCell = sizeClass.firstFreeCell;
         if (!firstFreeCell) {
+            char* bumpPointer = sizeClass.bumpPointer;
+            if (bumpPointer != sizeClass.bumpEnd) {
+                sizeClass.bumpPointer = bumpPointer + sizeClass.cellSize;
+                return bumpPointer;
+            }
+
             // There are two possibilities for why we got here:
             // 1) We've exhausted the allocation cache for currentBlock, in which case
             //    currentBlock == nextBlock, and we know that there is no reason to
@@ -188,13 +269,7 @@ namespace JSC {
     
     inline void* NewSpace::allocatePropertyStorage(size_t size)
     {
-		//+EAWebKitChange
-		//10/24/2011 - Added following to NewSpace::allocatePropertyStorage(size_t size) function as not expecting
-		// this code to be called.
-		ASSERT_NOT_REACHED();
-		//-EAWebKitChange
-
-		char* result = m_propertyStorageAllocationPoint;
+        char* result = m_propertyStorageAllocationPoint;
         if (size > PropertyStorageNurserySize)
             CRASH();
         m_propertyStorageAllocationPoint += size;
@@ -231,6 +306,44 @@ namespace JSC {
             }
         }
 
+        for (size_t i = 0; i < preciseCount; ++i) {
+            SizeClass& sizeClass = m_destructorFreePreciseSizeClasses[i];
+            MarkedBlock* next;
+            for (MarkedBlock* block = sizeClass.blockList.head(); block; block = next) {
+                next = block->next();
+                functor(block);
+            }
+        }
+
+        for (size_t i = 0; i < impreciseCount; ++i) {
+            SizeClass& sizeClass = m_destructorFreeImpreciseSizeClasses[i];
+            MarkedBlock* next;
+            for (MarkedBlock* block = sizeClass.blockList.head(); block; block = next) {
+                next = block->next();
+                functor(block);
+            }
+        }
+
+#if ENABLE(GGC)
+        for (size_t i = 0; i < preciseCount; ++i) {
+            SizeClass& sizeClass = m_pretenuredPreciseSizeClasses[i];
+            MarkedBlock* next;
+            for (MarkedBlock* block = sizeClass.blockList.head(); block; block = next) {
+                next = block->next();
+                functor(block);
+            }
+        }
+
+        for (size_t i = 0; i < impreciseCount; ++i) {
+            SizeClass& sizeClass = m_pretenuredImpreciseSizeClasses[i];
+            MarkedBlock* next;
+            for (MarkedBlock* block = sizeClass.blockList.head(); block; block = next) {
+                next = block->next();
+                functor(block);
+            }
+        }
+#endif
+
         return functor.returnValue();
     }
 
@@ -242,9 +355,15 @@ namespace JSC {
 
     inline NewSpace::SizeClass::SizeClass()
         : firstFreeCell(0)
+        , bumpPointer(0)
+        , bumpEnd(0)
         , currentBlock(0)
         , nextBlock(0)
         , cellSize(0)
+        , cellsNeedDestruction(true)
+#if ENABLE(GGC)
+        , isPretenured(false)
+#endif
     {
     }
 
@@ -256,7 +375,10 @@ namespace JSC {
     inline void NewSpace::SizeClass::canonicalizeBlock()
     {
         if (currentBlock) {
-            currentBlock->canonicalizeBlock(firstFreeCell);
+            if (bumpPointer != bumpEnd)
+                currentBlock->canonicalizeBumpRegion(bumpPointer);
+            else
+                currentBlock->canonicalizeBlock(firstFreeCell);
             firstFreeCell = 0;
         }
         
@@ -264,7 +386,17 @@ namespace JSC {
         
         currentBlock = 0;
         firstFreeCell = 0;
+        bumpPointer = 0;
+        bumpEnd = 0;
+    }
+
+#if ENABLE(INCREMENTAL_MARKING)
+    inline void NewSpace::SizeClass::stopLazySweeping()
+    {
+        ASSERT(!currentBlock);
+        nextBlock = 0;
     }
+#endif
 
 } // namespace JSC
 
@@ -32,18 +32,46 @@ namespace JSC {
 
 class SlotVisitor : public MarkStack {
 public:
-    SlotVisitor(void* jsArrayVPtr);
+    SlotVisitor(MarkStackThreadSharedData&);
 
     void drain();
     void harvestWeakReferences();
+
+    // Drains this visitor, then helps the marking threads until no marking
+    // work is left anywhere. Without ENABLE(PARALLEL_GC) this is just drain().
+    void parallelDrain();
+
+#if ENABLE(INCREMENTAL_MARKING)
+    // Drains until either there is no work left, in which case this returns
+    // true, or currentTime() passes the deadline. Used by the slices of an
+    // incremental marking cycle, which run serially.
+    bool drainUntil(double deadline);
+#endif
+
+#if ENABLE(PARALLEL_GC)
+    enum SharedDrainMode { SlaveDrain, MasterDrain };
+    void drainFromShared(SharedDrainMode);
+#endif
     
 private:
     void visitChildren(JSCell*);
+    // Appends the cells in every pending mark set one by one.
+    void flushMarkSets();
+    void drainForSnapshot();
 };
 
-inline SlotVisitor::SlotVisitor(void* jsArrayVPtr)
-    : MarkStack(jsArrayVPtr)
+inline SlotVisitor::SlotVisitor(MarkStackThreadSharedData& shared)
+    : MarkStack(shared)
+{
+}
+
+inline void SlotVisitor::parallelDrain()
 {
+    drain();
+#if ENABLE(PARALLEL_GC)
+    if (m_shared.hasMarkingThreads())
+        drainFromShared(MasterDrain);
+#endif
 }
 
 } // namespace JSC
@@ -46,6 +46,7 @@
 #include "JSActivation.h"
 #include "JSArray.h"
 #include "JSByteArray.h"
+#include "JSTypedArray.h"
 #include "JSFunction.h"
 #include "JSNotAnObject.h"
 #include "JSPropertyNameIterator.h"
@@ -706,6 +707,20 @@ static void appendSourceToError(CallFrame* callFrame, ErrorInstance* exception,
 #if PLATFORM(EA)
 namespace
 {
+	// The offset of the call a caller frame is waiting on, just past the call instruction.
+	inline unsigned CallerBytecodeOffset(CallFrame *callFrame, CodeBlock *callerCodeBlock)
+	{
+#if ENABLE(JIT) && ENABLE(INTERPRETER)
+		if (callFrame->globalData().canUseJIT())
+			return callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+		return callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
+#elif ENABLE(JIT)
+		return callerCodeBlock->bytecodeOffset(callFrame->returnPC());
+#else
+		return callerCodeBlock->bytecodeOffset(callFrame->returnVPC());
+#endif
+	}
+
 	// +8/24/11 dsiems - Adding a callback for unhandled exceptions.
 	// The guts of this are taken from Interpreter::unwindCallFrame.
 	NEVER_INLINE bool WillHandleException(CallFrame *callFrame, unsigned bytecodeOffset, CodeBlock *codeBlock)
@@ -722,16 +737,7 @@ namespace
 			}
 
 			codeBlock = callerFrame->codeBlock();
-#if ENABLE(JIT) && ENABLE(INTERPRETER)
-			if (callerFrame->globalData().canUseJIT())
-				bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
-			else
-				bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnVPC());
-#elif ENABLE(JIT)
-			bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnPC());
-#else
-			bytecodeOffset = codeBlock->bytecodeOffset(callFrame->returnVPC());
-#endif
+			bytecodeOffset = CallerBytecodeOffset(callFrame, codeBlock);
 
 			callFrame = callerFrame;
 		}
@@ -739,6 +745,34 @@ namespace
 		return handled;
 	}
 
+	// Records only (CodeBlock*, bytecodeOffset) pairs; the embedder symbolizes the frames it
+	// cares about through JSSymbolizeCallstackFrame.
+	NEVER_INLINE void ReportCompactCallstack(JSCompactCallstackCallback callback, CallFrame *callFrame, unsigned bytecodeOffset, CodeBlock *codeBlock)
+	{
+		JSCallstackFrame frames[JSCompactCallstackMaxFrames];
+		size_t frameCount = 0;
+		while (frameCount < JSCompactCallstackMaxFrames)
+		{
+			frames[frameCount].codeBlock = codeBlock;
+			frames[frameCount].bytecodeOffset = bytecodeOffset;
+			++frameCount;
+
+			CallFrame* callerFrame = callFrame->callerFrame();
+			if (callerFrame->hasHostCallFrameFlag())
+			{
+				break;
+			}
+
+			// Step back from the return offset into the call instruction itself.
+			codeBlock = callerFrame->codeBlock();
+			bytecodeOffset = CallerBytecodeOffset(callFrame, codeBlock) - 1;
+
+			callFrame = callerFrame;
+		}
+
+		callback(frames, frameCount);
+	}
+
 	// Based off of createScriptCallStack.
 	NEVER_INLINE bool GenerateCallstackInfo(CallFrame *callFrame, int lineNumber, const UString &sourceURL, eastl::vector<eastl::string8> *namesOut, eastl::vector<eastl::string8> *argsOut, eastl::vector<int> *linesOut, eastl::vector<eastl::string8> *urlsOut)
 	{
@@ -863,7 +897,14 @@ NEVER_INLINE HandlerInfo* Interpreter::throwException(CallFrame*& callFrame, JSV
 	//Disabled on 64 bit platforms as it crashes at the moment
 #if PLATFORM(EA) && (EA_PLATFORM_PTR_SIZE != 8)
 
-	if (JSCallstackCallback callback = JSGetCallstackCallback())
+	if (JSCompactCallstackCallback callback = JSGetCompactCallstackCallback())
+	{
+		if (!WillHandleException(callFrame, bytecodeOffset, codeBlock))
+		{
+			ReportCompactCallstack(callback, callFrame, bytecodeOffset, codeBlock);
+		}
+	}
+	else if (JSCallstackCallback callback = JSGetCallstackCallback())
 	{
 		// Only report uncaught exceptions. Have to do this preemptively because
 		// the stack gets unwound further down.
@@ -901,9 +942,15 @@ NEVER_INLINE HandlerInfo* Interpreter::throwException(CallFrame*& callFrame, JSV
     if (Profiler* profiler = *Profiler::enabledProfilerReference())
         profiler->exceptionUnwind(callFrame);
 
-    // Shrink the JS stack, in case stack overflow made it huge.
+    // Shrink the JS stack, in case stack overflow made it huge. Only the frames
+    // belonging to the current entry into the VM need to be considered: the
+    // handler frame is one of them, and everything below the entry point was
+    // already covered by the register file before this entry started. Walking
+    // further would make every throw cost time proportional to the whole stack.
     Register* highWaterMark = 0;
-    for (CallFrame* callerFrame = callFrame; callerFrame; callerFrame = callerFrame->callerFrame()->removeHostCallFrameFlag()) {
+    for (CallFrame* callerFrame = callFrame; callerFrame; callerFrame = callerFrame->callerFrame()) {
+        if (callerFrame->hasHostCallFrameFlag())
+            break;
         CodeBlock* codeBlock = callerFrame->codeBlock();
         if (!codeBlock)
             continue;
@@ -1673,9 +1720,13 @@ NEVER_INLINE void Interpreter::tryCacheGetByID(CallFrame* callFrame, CodeBlock*
         return;
     }
 
+    // See JITThunks::tryCacheGetByID.
     if (structure->isDictionary()) {
-        vPC[0] = getOpcode(op_get_by_id_generic);
-        return;
+        if (structure->hasBeenFlattenedBefore()) {
+            vPC[0] = getOpcode(op_get_by_id_generic);
+            return;
+        }
+        asObject(baseValue)->flattenDictionaryObject(callFrame->globalData());
     }
 
     if (slot.slotBase() == structure->prototypeForLookup(callFrame)) {
@@ -1746,6 +1797,24 @@ NEVER_INLINE void Interpreter::uncacheGetByID(CodeBlock*, Instruction* vPC)
 
 #endif // ENABLE(INTERPRETER)
 
+void Interpreter::tryCacheIn(CallFrame* callFrame, Instruction* vPC, JSObject* baseObj, const Identifier& propertyName)
+{
+    // The cache stands for a single answer, so the property name must be a constant.
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    if (!codeBlock->isConstantRegisterIndex(vPC[2].u.operand))
+        return;
+
+    // Only an own property recorded in a shared Structure is guaranteed to stay present for as long as
+    // the object keeps that Structure: removing it transitions the object to a new (dictionary) Structure.
+    Structure* structure = baseObj->structure();
+    if (structure->isDictionary() || structure->typeInfo().overridesGetOwnPropertySlot())
+        return;
+    if (structure->get(callFrame->globalData(), propertyName) == notFound)
+        return;
+
+    vPC[4].u.structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), structure);
+}
+
 JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFile, CallFrame* callFrame)
 {
     // One-time initialization of our address tables. We have to put this code
@@ -1802,7 +1871,7 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 
 #define CHECK_FOR_TIMEOUT() \
     if (!--tickCount) { \
-        if (globalData->terminator.shouldTerminate() || globalData->timeoutChecker.didTimeOut(callFrame)) { \
+        if (globalData->terminator.shouldTerminate() || globalData->timeoutChecker.didTimeOut(callFrame, TimeoutCheckSite(vPC - codeBlock->instructions().begin(), true))) { \
             exceptionValue = jsNull(); \
             goto vm_throw; \
         } \
@@ -1824,6 +1893,16 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 #endif
     NEXT_INSTRUCTION();
 #else
+    // Without computed goto, every instruction dispatches through this one switch.
+    // Telling the compiler that no other opcode values occur lets it drop the range
+    // check in front of the jump table.
+#if COMPILER(MSVC)
+    #define UNREACHABLE_OPCODE() __assume(0)
+#elif COMPILER(GCC) && GCC_VERSION_AT_LEAST(4, 5, 0)
+    #define UNREACHABLE_OPCODE() __builtin_unreachable()
+#else
+    #define UNREACHABLE_OPCODE()
+#endif
     #define NEXT_INSTRUCTION() SAMPLE(codeBlock, vPC); goto interpreterLoopStart
 #if ENABLE(OPCODE_STATS)
     #define DEFINE_OPCODE(opcode) case opcode: OpcodeStats::recordInstruction(opcode);
@@ -1836,19 +1915,20 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 #endif
     {
     DEFINE_OPCODE(op_new_object) {
-        /* new_object dst(r)
+        /* new_object dst(r) profile(n)
 
            Constructs a new empty Object instance using the original
            constructor, and puts the result in register dst.
         */
         int dst = vPC[1].u.operand;
-        callFrame->uncheckedR(dst) = JSValue(constructEmptyObject(callFrame));
+        AllocationSiteScope allocationSite(globalData->heap, codeBlock, codeBlock->allocationSiteProfile(vPC[2].u.operand), AllocationSiteScope::DecrementCountdown);
+        callFrame->uncheckedR(dst) = JSValue(allocationSite.didAllocate(constructEmptyObject(callFrame)));
 
         vPC += OPCODE_LENGTH(op_new_object);
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_new_array) {
-        /* new_array dst(r) firstArg(r) argCount(n)
+        /* new_array dst(r) firstArg(r) argCount(n) profile(n)
 
            Constructs a new Array instance using the original
            constructor, and puts the result in register dst.
@@ -1859,13 +1939,14 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         int firstArg = vPC[2].u.operand;
         int argCount = vPC[3].u.operand;
         ArgList args(callFrame->registers() + firstArg, argCount);
-        callFrame->uncheckedR(dst) = JSValue(constructArray(callFrame, args));
+        AllocationSiteScope allocationSite(globalData->heap, codeBlock, codeBlock->allocationSiteProfile(vPC[4].u.operand), AllocationSiteScope::DecrementCountdown);
+        callFrame->uncheckedR(dst) = JSValue(allocationSite.didAllocate(constructArray(callFrame, args)));
 
         vPC += OPCODE_LENGTH(op_new_array);
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_new_array_buffer) {
-        /* new_array_buffer dst(r) index(n) argCount(n)
+        /* new_array_buffer dst(r) index(n) argCount(n) profile(n)
          
          Constructs a new Array instance using the original
          constructor, and puts the result in register dst.
@@ -1875,9 +1956,10 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         int firstArg = vPC[2].u.operand;
         int argCount = vPC[3].u.operand;
         ArgList args(codeBlock->constantBuffer(firstArg), argCount);
-        callFrame->uncheckedR(dst) = JSValue(constructArray(callFrame, args));
+        AllocationSiteScope allocationSite(globalData->heap, codeBlock, codeBlock->allocationSiteProfile(vPC[4].u.operand), AllocationSiteScope::DecrementCountdown);
+        callFrame->uncheckedR(dst) = JSValue(allocationSite.didAllocate(constructArray(callFrame, args)));
         
-        vPC += OPCODE_LENGTH(op_new_array);
+        vPC += OPCODE_LENGTH(op_new_array_buffer);
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_new_regexp) {
@@ -2631,11 +2713,15 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_in) {
-        /* in dst(r) property(r) base(r)
+        /* in dst(r) property(r) base(r) structure(sID)
 
            Tests whether register base has a property named register
            property, and puts the boolean result in register dst.
 
+           If base has the Structure cached in the instruction, the
+           (constant) property was found there as an own property,
+           so the result is true without a lookup.
+
            Raises an exception if register constructor is not an
            object.
         */
@@ -2649,6 +2735,12 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
 
         JSObject* baseObj = asObject(baseVal);
 
+        if (baseObj->structure() == vPC[4].u.structure.get()) {
+            callFrame->uncheckedR(dst) = jsBoolean(true);
+            vPC += OPCODE_LENGTH(op_in);
+            NEXT_INSTRUCTION();
+        }
+
         JSValue propName = callFrame->r(property).jsValue();
 
         uint32_t i;
@@ -2657,7 +2749,10 @@ JSValue Interpreter::privateExecute(ExecutionFlag flag, RegisterFile* registerFi
         else {
             Identifier property(callFrame, propName.toString(callFrame));
             CHECK_FOR_EXCEPTION();
-            callFrame->uncheckedR(dst) = jsBoolean(baseObj->hasProperty(callFrame, property));
+            bool result = baseObj->hasProperty(callFrame, property);
+            if (result)
+                tryCacheIn(callFrame, vPC, baseObj, property);
+            callFrame->uncheckedR(dst) = jsBoolean(result);
         }
 
         vPC += OPCODE_LENGTH(op_in);
@@ -3637,6 +3732,8 @@ skip_id_custom_self:
                 result = asString(baseValue)->getIndex(callFrame, i);
             else if (isJSByteArray(globalData, baseValue) && asByteArray(baseValue)->canAccessIndex(i))
                 result = asByteArray(baseValue)->getIndex(callFrame, i);
+            else if (isJSTypedArray(globalData, baseValue) && asTypedArray(baseValue)->canAccessIndex(i))
+                result = asTypedArray(baseValue)->getIndex(i);
             else
                 result = baseValue.get(callFrame, i);
         } else {
@@ -3685,6 +3782,16 @@ skip_id_custom_self:
                     jsByteArray->setIndex(i, dValue);
                 else
                     baseValue.put(callFrame, i, jsValue);
+            } else if (isJSTypedArray(globalData, baseValue) && asTypedArray(baseValue)->canAccessIndex(i)) {
+                JSTypedArray* jsTypedArray = asTypedArray(baseValue);
+                double dValue = 0;
+                JSValue jsValue = callFrame->r(value).jsValue();
+                if (jsValue.isInt32())
+                    jsTypedArray->setIndex(i, jsValue.asInt32());
+                else if (jsValue.getNumber(dValue))
+                    jsTypedArray->setIndex(i, dValue);
+                else
+                    baseValue.put(callFrame, i, jsValue);
             } else
                 baseValue.put(callFrame, i, callFrame->r(value).jsValue());
         } else {
@@ -4272,7 +4379,7 @@ skip_id_custom_self:
         NEXT_INSTRUCTION();
     }
     DEFINE_OPCODE(op_new_func) {
-        /* new_func dst(r) func(f)
+        /* new_func dst(r) func(f) shouldCheck(b) profile(n)
 
            Constructs a new Function instance from function func and
            the current scope chain using the original Function
@@ -4283,8 +4390,10 @@ skip_id_custom_self:
         int func = vPC[2].u.operand;
         int shouldCheck = vPC[3].u.operand;
         ASSERT(codeBlock->codeType() != FunctionCode || !codeBlock->needsFullScopeChain() || callFrame->r(codeBlock->activationRegister()).jsValue());
-        if (!shouldCheck || !callFrame->r(dst).jsValue())
-            callFrame->uncheckedR(dst) = JSValue(codeBlock->functionDecl(func)->make(callFrame, callFrame->scopeChain()));
+        if (!shouldCheck || !callFrame->r(dst).jsValue()) {
+            AllocationSiteScope allocationSite(globalData->heap, codeBlock, codeBlock->allocationSiteProfile(vPC[4].u.operand), AllocationSiteScope::DecrementCountdown);
+            callFrame->uncheckedR(dst) = JSValue(allocationSite.didAllocate(codeBlock->functionDecl(func)->make(callFrame, callFrame->scopeChain())));
+        }
 
         vPC += OPCODE_LENGTH(op_new_func);
         NEXT_INSTRUCTION();
@@ -4730,15 +4839,16 @@ skip_id_custom_self:
     DEFINE_OPCODE(op_enter) {
         /* enter
 
-           Initializes local variables to undefined. If the code block requires
+           Initializes local variables to undefined, except those the code
+           block writes before it can read them. If the code block requires
            an activation, enter_with_activation is used instead.
 
            This opcode appears only at the beginning of a code block.
         */
 
-        size_t i = 0;
-        for (size_t count = codeBlock->m_numVars; i < count; ++i)
-            callFrame->uncheckedR(i) = jsUndefined();
+        const Vector<int>& varsToInitialize = codeBlock->varsToInitialize();
+        for (size_t i = 0; i < varsToInitialize.size(); ++i)
+            callFrame->uncheckedR(varsToInitialize[i]) = jsUndefined();
 
         vPC += OPCODE_LENGTH(op_enter);
         NEXT_INSTRUCTION();
@@ -5265,6 +5375,11 @@ skip_id_custom_self:
         vPC += OPCODE_LENGTH(op_profile_did_call);
         NEXT_INSTRUCTION();
     }
+#if !ENABLE(COMPUTED_GOTO_INTERPRETER)
+    default:
+        ASSERT_NOT_REACHED();
+        UNREACHABLE_OPCODE();
+#endif
     vm_throw: {
         globalData->exception = JSValue();
         if (!tickCount) {
@@ -5290,6 +5405,9 @@ skip_id_custom_self:
 #endif
     #undef NEXT_INSTRUCTION
     #undef DEFINE_OPCODE
+#if !ENABLE(COMPUTED_GOTO_INTERPRETER)
+    #undef UNREACHABLE_OPCODE
+#endif
     #undef CHECK_FOR_EXCEPTION
     #undef CHECK_FOR_TIMEOUT
 #endif // ENABLE(INTERPRETER)
@@ -138,6 +138,9 @@ namespace JSC {
         NEVER_INLINE HandlerInfo* throwException(CallFrame*&, JSValue&, unsigned bytecodeOffset);
         NEVER_INLINE void debug(CallFrame*, DebugHookID, int firstLine, int lastLine);
 
+        // Shared by the interpreter and cti_op_in to fill the Structure cache in an op_in instruction.
+        static void tryCacheIn(CallFrame*, Instruction* vPC, JSObject* baseObj, const Identifier& propertyName);
+
         void dumpSampleData(ExecState* exec);
         void startSampling();
         void stopSampling();
@@ -52,7 +52,7 @@ RegisterFile::~RegisterFile()
 
 void RegisterFile::gatherConservativeRoots(ConservativeRoots& conservativeRoots)
 {
-    conservativeRoots.add(begin(), end());
+    conservativeRoots.addEncodedValues(begin(), end());
 }
 
 void RegisterFile::releaseExcessCapacity()
@@ -63,6 +63,20 @@ void RegisterFile::releaseExcessCapacity()
     m_commitEnd = static_cast<Register*>(m_reservation.base());
 }
 
+void RegisterFile::releaseExcessCapacityAbove(Register* keepEnd)
+{
+    // Pages are committed in commitSize chunks from the base, so keep the committed
+    // region a whole number of chunks.
+    char* base = static_cast<char*>(m_reservation.base());
+    char* newCommitEnd = base + roundUpAllocationSize(reinterpret_cast<char*>(keepEnd) - base, commitSize);
+    ptrdiff_t delta = reinterpret_cast<char*>(m_commitEnd) - newCommitEnd;
+    if (delta <= 0)
+        return;
+    m_reservation.decommit(newCommitEnd, delta);
+    addToCommittedByteCount(-delta);
+    m_commitEnd = reinterpret_cast_ptr<Register*>(newCommitEnd);
+}
+
 void RegisterFile::initializeThreading()
 {
     registerFileStatisticsMutex();
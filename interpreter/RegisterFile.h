@@ -30,6 +30,7 @@
 #define RegisterFile_h
 
 #include "ExecutableAllocator.h"
+#include "PauseTelemetry.h"
 #include "Register.h"
 #include <wtf/Noncopyable.h>
 #include <wtf/PageReservation.h>
@@ -59,6 +60,10 @@ namespace JSC {
         static const size_t commitSize = 16 * 1024;
         // Allow 8k of excess registers before we start trying to reap the registerfile
         static const ptrdiff_t maxExcessCapacity = 8 * 1024;
+        // When a nested entry unwinds without emptying the registerfile, keep this many
+        // registers committed above the new end so that a workload bouncing around the
+        // same depth does not repeatedly commit and decommit the same pages.
+        static const ptrdiff_t partialReleaseHysteresis = 2 * maxExcessCapacity;
 
         RegisterFile(size_t capacity = defaultCapacity);
         ~RegisterFile();
@@ -82,6 +87,7 @@ namespace JSC {
 
     private:
         void releaseExcessCapacity();
+        void releaseExcessCapacityAbove(Register*);
         void addToCommittedByteCount(long);
         Register* m_end;
         Register* m_commitEnd;
@@ -103,8 +109,13 @@ namespace JSC {
         if (newEnd >= m_end)
             return;
         m_end = newEnd;
-        if (m_end == m_reservation.base() && (m_commitEnd - begin()) >= maxExcessCapacity)
-            releaseExcessCapacity();
+        if (m_end == m_reservation.base()) {
+            if ((m_commitEnd - begin()) >= maxExcessCapacity)
+                releaseExcessCapacity();
+            return;
+        }
+        if ((m_commitEnd - m_end) >= maxExcessCapacity + partialReleaseHysteresis)
+            releaseExcessCapacityAbove(m_end + partialReleaseHysteresis);
     }
 
     inline bool RegisterFile::grow(Register* newEnd)
@@ -121,6 +132,7 @@ namespace JSC {
         if (reinterpret_cast<char*>(m_commitEnd) + delta > static_cast<char*>(m_reservation.base()) + m_reservation.size())
             return false;
 
+        PauseScope pause(RegisterFileGrowthPause, 0, delta);
         m_reservation.commit(m_commitEnd, delta);
         addToCommittedByteCount(delta);
         m_commitEnd = reinterpret_cast_ptr<Register*>(reinterpret_cast<char*>(m_commitEnd) + delta);
@@ -27,6 +27,14 @@
 
 #include "ExecutableAllocator.h"
 
+#include "Tracing.h"
+
+#if ENABLE(EXECUTABLE_MEMORY_BATCHING)
+#include <algorithm>
+#include <wtf/TCSpinLock.h>
+#include <wtf/Threading.h>
+#endif
+
 #if ENABLE(EXECUTABLE_ALLOCATOR_DEMAND)
 #include <wtf/MetaAllocator.h>
 #include <wtf/PageReservation.h>
@@ -69,6 +77,7 @@ protected:
             CRASH();
         
         reservations.append(reservation);
+        JAVASCRIPTCORE_EXECUTABLE_POOL_GROW(numPages * pageSize());
         
         return reservation.base();
     }
@@ -123,6 +132,17 @@ size_t ExecutableAllocator::committedByteCount()
     return allocator->bytesCommitted();
 }
 
+size_t ExecutableAllocator::freeByteCount()
+{
+    MetaAllocator::Statistics statistics = allocator->currentStatistics();
+    return statistics.bytesReserved - statistics.bytesAllocated;
+}
+
+size_t ExecutableAllocator::largestFreeBlockSize()
+{
+    return allocator->currentStatistics().largestFreeBlock;
+}
+
 #if ENABLE(META_ALLOCATOR_PROFILE)
 void ExecutableAllocator::dumpProfile()
 {
@@ -133,10 +153,125 @@ void ExecutableAllocator::dumpProfile()
 #endif // ENABLE(EXECUTABLE_ALLOCATOR_DEMAND)
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
-
 #if OS(WINDOWS) || OS(SYMBIAN)
 #error "ASSEMBLER_WX_EXCLUSIVE not yet suported on this platform."
 #endif
+#endif
+
+#if ENABLE(EXECUTABLE_MEMORY_BATCHING)
+
+typedef Vector<std::pair<intptr_t, intptr_t> > AddressRanges;
+
+static bool rangesCover(const AddressRanges& ranges, intptr_t start, intptr_t end)
+{
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (ranges[i].first <= start && end <= ranges[i].second)
+            return true;
+    }
+    return false;
+}
+
+// Sorts the ranges and merges those that overlap or touch. Code blocks and
+// stubs are allocated near each other, so many neighbours share a call.
+static void coalesceRanges(AddressRanges& ranges)
+{
+    std::sort(ranges.begin(), ranges.end());
+    size_t merged = 0;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (merged && ranges[i].first <= ranges[merged - 1].second)
+            ranges[merged - 1].second = std::max(ranges[merged - 1].second, ranges[i].second);
+        else
+            ranges[merged++] = ranges[i];
+    }
+    ranges.shrink(merged);
+}
+
+// Address ranges, as [start, end), whose reprotection and instruction cache
+// flushes the thread that holds the batch has deferred. Only one thread
+// batches at a time; the others reprotect and flush as they go.
+struct ExecutableMemoryBatch {
+    ExecutableMemoryBatch()
+        : depth(0)
+    {
+    }
+
+    ThreadIdentifier thread;
+    unsigned depth;
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+    AddressRanges writableRanges;
+#endif
+    AddressRanges unflushedRanges;
+};
+
+static SpinLock executableMemoryBatchLock = SPINLOCK_INITIALIZER;
+static ExecutableMemoryBatch* executableMemoryBatch;
+
+static ExecutableMemoryBatch* executableMemoryBatchForCurrentThread()
+{
+    SpinLockHolder locker(&executableMemoryBatchLock);
+    if (!executableMemoryBatch || !executableMemoryBatch->depth || executableMemoryBatch->thread != currentThread())
+        return 0;
+    return executableMemoryBatch;
+}
+
+void ExecutableAllocator::beginBatch()
+{
+    SpinLockHolder locker(&executableMemoryBatchLock);
+    if (!executableMemoryBatch)
+        executableMemoryBatch = new ExecutableMemoryBatch;
+    if (!executableMemoryBatch->depth)
+        executableMemoryBatch->thread = currentThread();
+    else if (executableMemoryBatch->thread != currentThread())
+        return;
+    ++executableMemoryBatch->depth;
+}
+
+void ExecutableAllocator::endBatch()
+{
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+    AddressRanges writableRanges;
+#endif
+    AddressRanges unflushedRanges;
+    {
+        SpinLockHolder locker(&executableMemoryBatchLock);
+        if (!executableMemoryBatch || !executableMemoryBatch->depth || executableMemoryBatch->thread != currentThread())
+            return;
+        if (--executableMemoryBatch->depth)
+            return;
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+        writableRanges.swap(executableMemoryBatch->writableRanges);
+#endif
+        unflushedRanges.swap(executableMemoryBatch->unflushedRanges);
+    }
+
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+    coalesceRanges(writableRanges);
+    for (size_t i = 0; i < writableRanges.size(); ++i)
+        mprotect(reinterpret_cast<void*>(writableRanges[i].first), writableRanges[i].second - writableRanges[i].first, PROTECTION_FLAGS_RX);
+#endif
+
+    coalesceRanges(unflushedRanges);
+    for (size_t i = 0; i < unflushedRanges.size(); ++i)
+        platformCacheFlush(reinterpret_cast<void*>(unflushedRanges[i].first), unflushedRanges[i].second - unflushedRanges[i].first);
+}
+
+bool ExecutableAllocator::deferCacheFlush(void* code, size_t size)
+{
+    ExecutableMemoryBatch* batch = executableMemoryBatchForCurrentThread();
+    if (!batch)
+        return false;
+
+    // Whole cache lines, so that flushes of neighbouring instructions merge.
+    intptr_t start = reinterpret_cast<intptr_t>(code) & ~(cacheFlushGranularity - 1);
+    intptr_t end = (reinterpret_cast<intptr_t>(code) + size + cacheFlushGranularity - 1) & ~(cacheFlushGranularity - 1);
+    if (!rangesCover(batch->unflushedRanges, start, end))
+        batch->unflushedRanges.append(std::make_pair(start, end));
+    return true;
+}
+
+#endif // ENABLE(EXECUTABLE_MEMORY_BATCHING)
+
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
 
 void ExecutableAllocator::reprotectRegion(void* start, size_t size, ProtectionSetting setting)
 {
@@ -153,6 +288,17 @@ void ExecutableAllocator::reprotectRegion(void* start, size_t size, ProtectionSe
     size += (pageSize - 1);
     size &= ~(pageSize - 1);
 
+    if (ExecutableMemoryBatch* batch = executableMemoryBatchForCurrentThread()) {
+        // Pages the batch already holds are still writable. Pages made
+        // executable are left writable too, and reprotected when it ends.
+        intptr_t pageEndPtr = pageStartPtr + size;
+        if (rangesCover(batch->writableRanges, pageStartPtr, pageEndPtr))
+            return;
+        batch->writableRanges.append(std::make_pair(pageStartPtr, pageEndPtr));
+        if (setting == Executable)
+            return;
+    }
+
     mprotect(pageStart, size, (setting == Writable) ? PROTECTION_FLAGS_RW : PROTECTION_FLAGS_RX);
 }
 
@@ -160,7 +306,7 @@ void ExecutableAllocator::reprotectRegion(void* start, size_t size, ProtectionSe
 
 #if CPU(ARM_TRADITIONAL) && OS(LINUX) && COMPILER(RVCT)
 
-__asm void ExecutableAllocator::cacheFlush(void* code, size_t size)
+__asm void ExecutableAllocator::platformCacheFlush(void* code, size_t size)
 {
     ARM
     push {r7}
@@ -29,6 +29,7 @@
 #include <limits>
 #include <wtf/Assertions.h>
 #include <wtf/MetaAllocatorHandle.h>
+#include <wtf/Noncopyable.h>
 #include <wtf/PageAllocation.h>
 #include <wtf/PassRefPtr.h>
 #include <wtf/RefCounted.h>
@@ -142,11 +143,11 @@ public:
 
 
 #if CPU(X86) || CPU(X86_64)
-    static void cacheFlush(void*, size_t)
+    static void platformCacheFlush(void*, size_t)
     {
     }
 #elif CPU(MIPS)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
 #if GCC_VERSION_AT_LEAST(4, 3, 0)
 #if WTF_MIPS_ISA_REV(2) && !GCC_VERSION_AT_LEAST(4, 4, 3)
@@ -172,12 +173,12 @@ public:
 #endif
     }
 #elif CPU(ARM_THUMB2) && OS(IOS)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         sys_cache_control(kCacheFunctionPrepareForExecution, code, size);
     }
 #elif CPU(ARM_THUMB2) && OS(LINUX)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         asm volatile (
             "push    {r7}\n"
@@ -193,14 +194,14 @@ public:
             : "r0", "r1", "r2");
     }
 #elif OS(SYMBIAN)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         User::IMB_Range(code, static_cast<char*>(code) + size);
     }
 #elif CPU(ARM_TRADITIONAL) && OS(LINUX) && COMPILER(RVCT)
-    static __asm void cacheFlush(void* code, size_t size);
+    static __asm void platformCacheFlush(void* code, size_t size);
 #elif CPU(ARM_TRADITIONAL) && OS(LINUX) && COMPILER(GCC)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         asm volatile (
             "push    {r7}\n"
@@ -216,19 +217,19 @@ public:
             : "r0", "r1", "r2");
     }
 #elif OS(WINCE)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         CacheRangeFlush(code, size, CACHE_SYNC_ALL);
     }
 #elif PLATFORM(BREWMP)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
         RefPtr<IMemCache1> memCache = createRefPtrInstance<IMemCache1>(AEECLSID_MemCache1);
         IMemCache1_ClearCache(memCache.get(), reinterpret_cast<uint32>(code), size, MEMSPACE_CACHE_FLUSH, MEMSPACE_DATACACHE);
         IMemCache1_ClearCache(memCache.get(), reinterpret_cast<uint32>(code), size, MEMSPACE_CACHE_INVALIDATE, MEMSPACE_INSTCACHE);
     }
 #elif CPU(SH4) && OS(LINUX)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
 #ifdef CACHEFLUSH_D_L2
         syscall(__NR_cacheflush, reinterpret_cast<unsigned>(code), size, CACHEFLUSH_D_WB | CACHEFLUSH_I | CACHEFLUSH_D_L2);
@@ -237,7 +238,7 @@ public:
 #endif
     }
 #elif OS(QNX)
-    static void cacheFlush(void* code, size_t size)
+    static void platformCacheFlush(void* code, size_t size)
     {
 #if !ENABLE(ASSEMBLER_WX_EXCLUSIVE)
         msync(code, size, MS_INVALIDATE_ICACHE);
@@ -249,17 +250,71 @@ public:
 #else
     #error "The cacheFlush support is missing on this platform."
 #endif
+
+    // Makes the processor see instructions written to code. Inside an
+    // ExecutableMemoryBatchScope this is deferred to the end of the batch.
+#if ENABLE(EXECUTABLE_MEMORY_BATCHING)
+    static void cacheFlush(void* code, size_t size)
+    {
+        if (!deferCacheFlush(code, size))
+            platformCacheFlush(code, size);
+    }
+
+    // Use ExecutableMemoryBatchScope rather than calling these directly.
+    static void beginBatch();
+    static void endBatch();
+#else
+    static void cacheFlush(void* code, size_t size)
+    {
+        platformCacheFlush(code, size);
+    }
+#endif
+
     static size_t committedByteCount();
+    // Unallocated space in the pool, and the largest single block of it. A
+    // largest free block much smaller than the free space means fragmentation.
+    static size_t freeByteCount();
+    static size_t largestFreeBlockSize();
 
 private:
 
 #if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
     static void reprotectRegion(void*, size_t, ProtectionSetting);
 #endif
+#if ENABLE(EXECUTABLE_MEMORY_BATCHING)
+    // The smallest instruction cache line of the processors we flush for.
+    static const intptr_t cacheFlushGranularity = 32;
+
+    static bool deferCacheFlush(void*, size_t);
+#endif
 };
 
 } // namespace JSC
 
 #endif // ENABLE(JIT) && ENABLE(ASSEMBLER)
 
+namespace JSC {
+
+// While one of these is in scope, the reprotection and instruction cache
+// flushes of code this thread patches are deferred to the end of the outermost
+// scope, and then done once for each run of neighbouring pages or cache lines.
+// With ASSEMBLER_WX_EXCLUSIVE, that saves a pair of mprotect calls per
+// RepatchBuffer and LinkBuffer after the first that touches a page; on
+// processors that need flushes, it turns the small flushes of each relinked
+// instruction into a few large ones. Wrap code that repatches in bulk, or links
+// a stub and then repatches its caller. No JIT code may run while a scope is
+// open, since the pages it would run from may not be executable or flushed.
+class ExecutableMemoryBatchScope {
+    WTF_MAKE_NONCOPYABLE(ExecutableMemoryBatchScope);
+public:
+#if ENABLE(JIT) && ENABLE(ASSEMBLER) && ENABLE(EXECUTABLE_MEMORY_BATCHING)
+    ExecutableMemoryBatchScope() { ExecutableAllocator::beginBatch(); }
+    ~ExecutableMemoryBatchScope() { ExecutableAllocator::endBatch(); }
+#else
+    ExecutableMemoryBatchScope() { }
+#endif
+};
+
+} // namespace JSC
+
 #endif // !defined(ExecutableAllocator)
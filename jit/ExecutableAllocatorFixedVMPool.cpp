@@ -29,6 +29,8 @@
 
 #if ENABLE(EXECUTABLE_ALLOCATOR_FIXED)
 
+#include "PauseTelemetry.h"
+#include "Tracing.h"
 #include <errno.h>
 
 #include <sys/mman.h>
@@ -79,6 +81,7 @@ protected:
     virtual void notifyNeedPage(void* page)
     {
         m_reservation.commit(page, pageSize());
+        JAVASCRIPTCORE_EXECUTABLE_POOL_GROW(pageSize());
     }
     
     virtual void notifyPageIsFree(void* page)
@@ -118,6 +121,7 @@ PassRefPtr<ExecutableMemoryHandle> ExecutableAllocator::allocate(JSGlobalData& g
 {
     RefPtr<ExecutableMemoryHandle> result = allocator->allocate(sizeInBytes);
     if (!result) {
+        PauseScope pause(ExecutableMemoryExhaustionPause, 0, sizeInBytes);
         releaseExecutableMemory(globalData);
         result = allocator->allocate(sizeInBytes);
         if (!result)
@@ -131,6 +135,17 @@ size_t ExecutableAllocator::committedByteCount()
     return allocator->bytesCommitted();
 }
 
+size_t ExecutableAllocator::freeByteCount()
+{
+    MetaAllocator::Statistics statistics = allocator->currentStatistics();
+    return statistics.bytesReserved - statistics.bytesAllocated;
+}
+
+size_t ExecutableAllocator::largestFreeBlockSize()
+{
+    return allocator->currentStatistics().largestFreeBlock;
+}
+
 #if ENABLE(META_ALLOCATOR_PROFILE)
 void ExecutableAllocator::dumpProfile()
 {
@@ -38,14 +38,18 @@ JSC::MacroAssemblerX86Common::SSE2CheckState JSC::MacroAssemblerX86Common::s_sse
 #include "CryptographicallyRandomNumber.h"
 #include "DFGNode.h" // for DFG_SUCCESS_STATS
 #include "Interpreter.h"
+#include "JITCodeLog.h"
 #include "JITInlineMethods.h"
 #include "JITStubCall.h"
 #include "JSArray.h"
 #include "JSFunction.h"
 #include "LinkBuffer.h"
+#include "PauseTelemetry.h"
 #include "RepatchBuffer.h"
 #include "ResultType.h"
 #include "SamplingTool.h"
+#include "Tracing.h"
+#include <wtf/CurrentTime.h>
 
 using namespace std;
 
@@ -90,6 +94,7 @@ JIT::JIT(JSGlobalData* globalData, CodeBlock* codeBlock)
 #else
     , m_randomGenerator(static_cast<unsigned>(randomNumber() * 0xFFFFFFF))
 #endif
+    , m_shouldEmitCompactSlowCases(ExecutableAllocator::underMemoryPressure())
 {
 }
 
@@ -214,17 +219,12 @@ void JIT::privateCompileMainPass()
 
         switch (m_interpreter->getOpcodeID(currentInstruction->u.opcode)) {
         DEFINE_BINARY_OP(op_del_by_val)
-        DEFINE_BINARY_OP(op_in)
         DEFINE_BINARY_OP(op_less)
         DEFINE_BINARY_OP(op_lesseq)
         DEFINE_BINARY_OP(op_greater)
         DEFINE_BINARY_OP(op_greatereq)
-        DEFINE_UNARY_OP(op_is_boolean)
         DEFINE_UNARY_OP(op_is_function)
-        DEFINE_UNARY_OP(op_is_number)
         DEFINE_UNARY_OP(op_is_object)
-        DEFINE_UNARY_OP(op_is_string)
-        DEFINE_UNARY_OP(op_is_undefined)
 #if USE(JSVALUE64)
         DEFINE_UNARY_OP(op_negate)
 #endif
@@ -262,7 +262,12 @@ void JIT::privateCompileMainPass()
         DEFINE_OP(op_get_pnames)
         DEFINE_OP(op_get_scoped_var)
         DEFINE_OP(op_check_has_instance)
+        DEFINE_OP(op_in)
         DEFINE_OP(op_instanceof)
+        DEFINE_OP(op_is_boolean)
+        DEFINE_OP(op_is_number)
+        DEFINE_OP(op_is_string)
+        DEFINE_OP(op_is_undefined)
         DEFINE_OP(op_jeq_null)
         DEFINE_OP(op_jfalse)
         DEFINE_OP(op_jmp)
@@ -391,6 +396,7 @@ void JIT::privateCompileSlowCases()
 
     m_propertyAccessInstructionIndex = 0;
     m_globalResolveInfoIndex = 0;
+    m_byValStringCacheInfoIndex = 0;
     m_callLinkInfoIndex = 0;
     
 #if !ASSERT_DISABLED && ENABLE(VALUE_PROFILER)
@@ -434,6 +440,7 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_get_argument_by_val)
         DEFINE_SLOWCASE_OP(op_get_by_pname)
         DEFINE_SLOWCASE_OP(op_check_has_instance)
+        DEFINE_SLOWCASE_OP(op_in)
         DEFINE_SLOWCASE_OP(op_instanceof)
         DEFINE_SLOWCASE_OP(op_jfalse)
         DEFINE_SLOWCASE_OP(op_jless)
@@ -475,6 +482,7 @@ void JIT::privateCompileSlowCases()
         DEFINE_SLOWCASE_OP(op_resolve_global_dynamic)
         DEFINE_SLOWCASE_OP(op_rshift)
         DEFINE_SLOWCASE_OP(op_urshift)
+        DEFINE_SLOWCASE_OP(op_strcat)
         DEFINE_SLOWCASE_OP(op_stricteq)
         DEFINE_SLOWCASE_OP(op_sub)
         DEFINE_SLOWCASE_OP(op_to_jsnumber)
@@ -503,6 +511,12 @@ void JIT::privateCompileSlowCases()
 
 JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
 {
+    FastMallocTagScope tagScope("JSC/JIT");
+    double startTime = currentTime();
+    PauseScope pause(CompilationPause, CompilationStatistics::BaselineJITTier, 0);
+
+    JAVASCRIPTCORE_JIT_COMPILE_BEGIN(m_codeBlock, 0);
+
 #if ENABLE(TIERED_COMPILATION)
     m_canBeOptimized = m_codeBlock->canCompileWithDFG();
     if (m_canBeOptimized)
@@ -602,6 +616,12 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
                 unsigned offset = it->second.branchOffset;
                 it->second.ctiOffset = offset ? patchBuffer.locationOf(m_labels[bytecodeOffset + offset]) : record.jumpTable.stringJumpTable->ctiDefault;
             }
+
+            Vector<StringImpl*>& hashKeys = record.jumpTable.stringJumpTable->ctiHashKeys;
+            for (unsigned j = 0; j < hashKeys.size(); ++j) {
+                if (hashKeys[j])
+                    record.jumpTable.stringJumpTable->ctiHashTargets[j] = record.jumpTable.stringJumpTable->ctiForValue(hashKeys[j]).executableAddress();
+            }
         }
     }
 
@@ -655,11 +675,19 @@ JITCode JIT::privateCompile(CodePtr* functionEntryArityCheck)
     if (m_codeBlock->codeType() == FunctionCode && functionEntryArityCheck)
         *functionEntryArityCheck = patchBuffer.locationOf(arityCheck);
     
-    return JITCode(patchBuffer.finalizeCode(), JITCode::BaselineJIT);
+    JITCode result(patchBuffer.finalizeCode(JITCodeLog::isEnabled() ? JITCodeLog::describe(m_codeBlock, "baseline").data() : 0), JITCode::BaselineJIT);
+    JAVASCRIPTCORE_JIT_COMPILE_END(m_codeBlock, 0, result.size());
+
+    double compileTime = currentTime() - startTime;
+    m_codeBlock->didGenerateMachineCode(compileTime);
+    m_globalData->compilationStatistics.record(CompilationStatistics::BaselineJITTier, compileTime, result.size());
+    pause.setBytes(result.size());
+    return result;
 }
 
 void JIT::linkFor(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBlock* calleeCodeBlock, JIT::CodePtr code, CallLinkInfo* callLinkInfo, int callerArgCount, JSGlobalData* globalData, CodeSpecializationKind kind)
 {
+    ExecutableMemoryBatchScope batch;
     RepatchBuffer repatchBuffer(callerCodeBlock);
 
     // Currently we only link calls with the exact number of arguments.
@@ -671,9 +699,15 @@ void JIT::linkFor(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBlock* cal
         
         if (calleeCodeBlock)
             calleeCodeBlock->linkIncomingCall(callLinkInfo);
-    }
-
-    // patch the call so we do not continue to try to link.
+        ++callLinkInfo->linkCount;
+        callLinkInfo->isVirtual = false;
+    } else
+        callLinkInfo->isVirtual = true;
+
+    // patch the call so we do not continue to try to link. Callees that miss
+    // the linked check go to the virtual trampoline, which dispatches on the
+    // callee's executable, so every closure of one function takes the same
+    // path without a stub per callee.
     if (kind == CodeForCall) {
         repatchBuffer.relink(CodeLocationNearCall(callLinkInfo->callReturnLocation), globalData->jitStubs->ctiVirtualCall());
         return;
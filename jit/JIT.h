@@ -62,6 +62,7 @@ namespace JSC {
     class ScopeChainNode;
     class StructureChain;
 
+    struct ByValStringCacheInfo;
     struct CallLinkInfo;
     struct Instruction;
     struct OperandTypes;
@@ -225,6 +226,12 @@ namespace JSC {
             jit.privateCompilePutByIdTransition(stubInfo, oldStructure, newStructure, cachedOffset, chain, returnAddress, direct);
         }
 
+        static void compilePutByIdSetter(JSGlobalData* globalData, CallFrame* callFrame, CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* structure, StructureChain* chain, size_t count, ReturnAddressPtr returnAddress)
+        {
+            JIT jit(globalData, codeBlock);
+            jit.privateCompilePutByIdSetter(stubInfo, structure, chain, count, returnAddress, callFrame);
+        }
+
         static PassRefPtr<ExecutableMemoryHandle> compileCTIMachineTrampolines(JSGlobalData* globalData, TrampolineStructure *trampolines)
         {
             if (!globalData->canUseJIT())
@@ -251,6 +258,12 @@ namespace JSC {
             return jit.privateCompilePatchGetArrayLength(returnAddress);
         }
 
+        static void compilePatchGetArgumentsLength(JSGlobalData* globalData, CodeBlock* codeBlock, ReturnAddressPtr returnAddress)
+        {
+            JIT jit(globalData, codeBlock);
+            return jit.privateCompilePatchGetArgumentsLength(returnAddress);
+        }
+
         static void linkFor(JSFunction* callee, CodeBlock* callerCodeBlock, CodeBlock* calleeCodeBlock, CodePtr, CallLinkInfo*, int callerArgCount, JSGlobalData*, CodeSpecializationKind);
 
     private:
@@ -277,11 +290,13 @@ namespace JSC {
         void privateCompileGetByIdChainList(StructureStubInfo*, PolymorphicAccessStructureList*, int, Structure*, StructureChain* chain, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, CallFrame* callFrame);
         void privateCompileGetByIdChain(StructureStubInfo*, Structure*, StructureChain*, size_t count, const Identifier&, const PropertySlot&, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame);
         void privateCompilePutByIdTransition(StructureStubInfo*, Structure*, Structure*, size_t cachedOffset, StructureChain*, ReturnAddressPtr returnAddress, bool direct);
+        void privateCompilePutByIdSetter(StructureStubInfo*, Structure*, StructureChain*, size_t count, ReturnAddressPtr returnAddress, CallFrame*);
 
         PassRefPtr<ExecutableMemoryHandle> privateCompileCTIMachineTrampolines(JSGlobalData*, TrampolineStructure*);
         Label privateCompileCTINativeCall(JSGlobalData*, bool isConstruct = false);
         CodeRef privateCompileCTINativeCall(JSGlobalData*, NativeFunction);
         void privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress);
+        void privateCompilePatchGetArgumentsLength(ReturnAddressPtr returnAddress);
 
         void addSlowCase(Jump);
         void addSlowCase(JumpList);
@@ -306,9 +321,17 @@ namespace JSC {
 
         void emitWriteBarrier(RegisterID owner, RegisterID scratch, WriteBarrierUseKind);
 
+        JumpList emitByValStringCacheCheck(ByValStringCacheInfo*);
+        JumpList emitArgumentsGetByVal();
+
+        template<typename ClassType, typename StructureType> void emitAllocateBasicJSCell(StructureType, void* vtable, RegisterID result, RegisterID scratch, JumpList& failures);
         template<typename ClassType, typename StructureType> void emitAllocateBasicJSObject(StructureType, void* vtable, RegisterID result, RegisterID storagePtr);
         template<typename T> void emitAllocateJSFinalObject(T structure, RegisterID result, RegisterID storagePtr);
         void emitAllocateJSFunction(FunctionExecutable*, RegisterID scopeChain, RegisterID result, RegisterID storagePtr);
+#if ENABLE(GGC)
+        void emitAllocationSiteCountdown(unsigned profileIndex, RegisterID scratch);
+#endif
+        void emitInlineStringConcatenation(unsigned dst, const unsigned* sources, unsigned count);
         
         enum ValueProfilingSiteKind { FirstProfilingSite, SubsequentProfilingSite };
 #if ENABLE(VALUE_PROFILER)
@@ -576,6 +599,7 @@ namespace JSC {
         void emitJumpSlowCaseIfNotImmediateInteger(RegisterID);
         void emitJumpSlowCaseIfNotImmediateNumber(RegisterID);
         void emitJumpSlowCaseIfNotImmediateIntegers(RegisterID, RegisterID, RegisterID);
+        void emitCellEqualityFastPath(JumpList& undecided);
 
 #if USE(JSVALUE32_64)
         void emitFastArithDeTagImmediate(RegisterID);
@@ -777,7 +801,12 @@ namespace JSC {
         void emit_op_get_scoped_var(Instruction*);
         void emit_op_init_lazy_reg(Instruction*);
         void emit_op_check_has_instance(Instruction*);
+        void emit_op_in(Instruction*);
         void emit_op_instanceof(Instruction*);
+        void emit_op_is_boolean(Instruction*);
+        void emit_op_is_number(Instruction*);
+        void emit_op_is_string(Instruction*);
+        void emit_op_is_undefined(Instruction*);
         void emit_op_jeq_null(Instruction*);
         void emit_op_jfalse(Instruction*);
         void emit_op_jmp(Instruction*);
@@ -886,6 +915,7 @@ namespace JSC {
         void emitSlow_op_get_argument_by_val(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_get_by_pname(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_check_has_instance(Instruction*, Vector<SlowCaseEntry>::iterator&);
+        void emitSlow_op_in(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_instanceof(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_jfalse(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_jless(Instruction*, Vector<SlowCaseEntry>::iterator&);
@@ -922,6 +952,7 @@ namespace JSC {
         void emitSlow_op_resolve_global(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_resolve_global_dynamic(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_rshift(Instruction*, Vector<SlowCaseEntry>::iterator&);
+        void emitSlow_op_strcat(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_stricteq(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_sub(Instruction*, Vector<SlowCaseEntry>::iterator&);
         void emitSlow_op_to_jsnumber(Instruction*, Vector<SlowCaseEntry>::iterator&);
@@ -961,6 +992,12 @@ namespace JSC {
             iter->from.link(this);
             ++iter;
         }
+        // For fast paths whose number of slow cases depends on their operands.
+        void linkAllSlowCasesForBytecodeOffset(Vector<SlowCaseEntry>::iterator& iter)
+        {
+            while (iter != m_slowCases.end() && iter->to == m_bytecodeOffset)
+                linkSlowCase(iter);
+        }
         void linkSlowCaseIfNotJSCell(Vector<SlowCaseEntry>::iterator&, int vReg);
 
         Jump checkStructure(RegisterID reg, Structure* structure);
@@ -1035,6 +1072,7 @@ namespace JSC {
 
         unsigned m_propertyAccessInstructionIndex;
         unsigned m_globalResolveInfoIndex;
+        unsigned m_byValStringCacheInfoIndex;
         unsigned m_callLinkInfoIndex;
 
 #if USE(JSVALUE32_64)
@@ -1055,6 +1093,10 @@ namespace JSC {
 #endif
 #endif
         WeakRandom m_randomGenerator;
+        // When executable memory is short, slow cases call their stub
+        // directly instead of emitting inline paths for the stub's common
+        // cases.
+        bool m_shouldEmitCompactSlowCases;
         static CodeRef stringGetByValStubGenerator(JSGlobalData*);
         
 #if ENABLE(TIERED_COMPILATION)
@@ -809,6 +809,13 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     linkSlowCase(iter); // Integer overflow case - we could handle this in JIT code, but this is likely rare.
     if (opcodeID == op_mul && !op1HasImmediateIntFastCase && !op2HasImmediateIntFastCase) // op_mul has an extra slow case to handle 0 * negative number.
         linkSlowCase(iter);
+    if (m_shouldEmitCompactSlowCases) {
+        // The stub handles doubles as well, so skip the inline double path.
+        if (!op1HasImmediateIntFastCase)
+            notImm1.link(this);
+        if (!op2HasImmediateIntFastCase)
+            notImm2.link(this);
+    }
     emitGetVirtualRegister(op1, regT0);
 
     Label stubFunctionCall(this);
@@ -820,6 +827,8 @@ void JIT::compileBinaryArithOpSlowCase(OpcodeID opcodeID, Vector<SlowCaseEntry>:
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
     stubCall.call(result);
+    if (m_shouldEmitCompactSlowCases)
+        return;
     Jump end = jump();
 
     if (op1HasImmediateIntFastCase) {
@@ -887,6 +896,11 @@ void JIT::emit_op_add(Instruction* currentInstruction)
     OperandTypes types = OperandTypes::fromInt(currentInstruction[4].u.operand);
 
     if (!types.first().mightBeNumber() || !types.second().mightBeNumber()) {
+        if (types.first().definitelyIsString() || types.second().definitelyIsString()) {
+            unsigned sources[] = { op1, op2 };
+            emitInlineStringConcatenation(result, sources, 2);
+            return;
+        }
         JITStubCall stubCall(this, cti_op_add);
         stubCall.addArgument(op1, regT2);
         stubCall.addArgument(op2, regT2);
@@ -917,8 +931,16 @@ void JIT::emitSlow_op_add(Instruction* currentInstruction, Vector<SlowCaseEntry>
     unsigned op2 = currentInstruction[3].u.operand;
     OperandTypes types = OperandTypes::fromInt(currentInstruction[4].u.operand);
 
-    if (!types.first().mightBeNumber() || !types.second().mightBeNumber())
+    if (!types.first().mightBeNumber() || !types.second().mightBeNumber()) {
+        if (types.first().definitelyIsString() || types.second().definitelyIsString()) {
+            linkAllSlowCasesForBytecodeOffset(iter);
+            JITStubCall stubCall(this, cti_op_add);
+            stubCall.addArgument(op1, regT2);
+            stubCall.addArgument(op2, regT2);
+            stubCall.call(result);
+        }
         return;
+    }
 
     bool op1HasImmediateIntFastCase = isOperandConstantImmediateInt(op1);
     bool op2HasImmediateIntFastCase = !op1HasImmediateIntFastCase && isOperandConstantImmediateInt(op2);
@@ -604,6 +604,11 @@ void JIT::emit_op_add(Instruction* currentInstruction)
     OperandTypes types = OperandTypes::fromInt(currentInstruction[4].u.operand);
 
     if (!types.first().mightBeNumber() || !types.second().mightBeNumber()) {
+        if (types.first().definitelyIsString() || types.second().definitelyIsString()) {
+            unsigned sources[] = { op1, op2 };
+            emitInlineStringConcatenation(dst, sources, 2);
+            return;
+        }
         JITStubCall stubCall(this, cti_op_add);
         stubCall.addArgument(op1);
         stubCall.addArgument(op2);
@@ -675,8 +680,16 @@ void JIT::emitSlow_op_add(Instruction* currentInstruction, Vector<SlowCaseEntry>
     unsigned op2 = currentInstruction[3].u.operand;
     OperandTypes types = OperandTypes::fromInt(currentInstruction[4].u.operand);
 
-    if (!types.first().mightBeNumber() || !types.second().mightBeNumber())
+    if (!types.first().mightBeNumber() || !types.second().mightBeNumber()) {
+        if (types.first().definitelyIsString() || types.second().definitelyIsString()) {
+            linkAllSlowCasesForBytecodeOffset(iter);
+            JITStubCall stubCall(this, cti_op_add);
+            stubCall.addArgument(op1);
+            stubCall.addArgument(op2);
+            stubCall.call(dst);
+        }
         return;
+    }
 
     unsigned op;
     int32_t constant;
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JITCodeLog.h"
+
+#include "CodeBlock.h"
+#include "Executable.h"
+#include <stdio.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/StringExtras.h>
+#include <wtf/Threading.h>
+
+#if OS(LINUX)
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+namespace JSC {
+
+bool JITCodeLog::s_isEnabled = false;
+
+static JITCodeLog::Callback s_callback = 0;
+static FILE* s_perfMapFile = 0;
+
+static Mutex& logMutex()
+{
+    DEFINE_STATIC_LOCAL(Mutex, mutex, ());
+    return mutex;
+}
+
+void JITCodeLog::initialize()
+{
+    logMutex();
+
+#if OS(LINUX)
+    if (getenv("JavaScriptCorePerfMap")) {
+        char fileName[64];
+        snprintf(fileName, sizeof(fileName), "/tmp/perf-%d.map", static_cast<int>(getpid()));
+        s_perfMapFile = fopen(fileName, "a");
+    }
+#endif
+
+    s_isEnabled = s_perfMapFile || s_callback;
+}
+
+void JITCodeLog::setCallback(Callback callback)
+{
+    MutexLocker locker(logMutex());
+    s_callback = callback;
+    s_isEnabled = s_perfMapFile || s_callback;
+}
+
+void JITCodeLog::log(const void* start, size_t size, const char* name)
+{
+    if (!size)
+        return;
+
+    MutexLocker locker(logMutex());
+    if (s_perfMapFile) {
+        fprintf(s_perfMapFile, "%lx %lx %s\n", static_cast<unsigned long>(reinterpret_cast<uintptr_t>(start)), static_cast<unsigned long>(size), name);
+        fflush(s_perfMapFile);
+    }
+    if (s_callback)
+        s_callback(start, size, name);
+}
+
+CString JITCodeLog::describe(CodeBlock* codeBlock, const char* tier)
+{
+    ScriptExecutable* executable = codeBlock->ownerExecutable();
+
+    CString name;
+    switch (codeBlock->codeType()) {
+    case FunctionCode: {
+        const Identifier& identifier = static_cast<FunctionExecutable*>(executable)->name();
+        name = identifier.isEmpty() ? CString("<anonymous>") : identifier.ustring().utf8();
+        break;
+    }
+    case EvalCode:
+        name = "<eval>";
+        break;
+    case GlobalCode:
+        name = "<global>";
+        break;
+    }
+
+    CString url = executable->sourceURL().utf8();
+    char description[512];
+    snprintf(description, sizeof(description), "%s %s %s:%d", tier, name.data(), url.data(), executable->lineNo());
+    return CString(description);
+}
+
+} // namespace JSC
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JITCodeLog_h
+#define JITCodeLog_h
+
+#include <wtf/AlwaysInline.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class CodeBlock;
+
+// Tells native profilers where JIT code lives, so that samples landing in it can be attributed.
+// Each block of code a LinkBuffer finalizes is logged as its start address, size and a name.
+// The records go to /tmp/perf-<pid>.map, the file Linux perf reads symbols for JIT code from,
+// when the JavaScriptCorePerfMap environment variable is set, and to the embedder's callback if
+// there is one (see JSSetJITCodeCallback() in JSSettingsEA.h). Code is never unlogged: perf
+// trusts the latest record for an address, and a callback can do the same.
+class JITCodeLog {
+public:
+    typedef void (*Callback)(const void* start, size_t size, const char* name);
+
+    static void initialize();
+    static void setCallback(Callback);
+
+    static bool isEnabled() { return UNLIKELY(s_isEnabled); }
+    static void log(const void* start, size_t size, const char* name);
+
+    // "<tier> <function name> <url>:<line>", the name given to a code block's machine code.
+    static CString describe(CodeBlock*, const char* tier);
+
+private:
+    static bool s_isEnabled;
+};
+
+} // namespace JSC
+
+#endif // JITCodeLog_h
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JITDiagnostics.h"
+
+#include "JITCodeLog.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <wtf/StringExtras.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+JITDiagnostics::Callback JITDiagnostics::s_callback = 0;
+
+void JITDiagnostics::log(CodeBlock* codeBlock, const char* format, ...)
+{
+    Callback callback = s_callback;
+    if (!callback)
+        return;
+
+    char details[512];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(details, sizeof(details), format, arguments);
+    va_end(arguments);
+
+    char message[1024];
+    snprintf(message, sizeof(message), "%s: %s", JITCodeLog::describe(codeBlock, "DFG").data(), details);
+    callback(message);
+}
+
+} // namespace JSC
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JITDiagnostics_h
+#define JITDiagnostics_h
+
+#include <wtf/AlwaysInline.h>
+#include <wtf/Assertions.h>
+
+namespace JSC {
+
+class CodeBlock;
+
+// Explains the optimizing JIT's decisions, for finding out why hot code doesn't tier up or keeps
+// leaving optimized code: which opcode kept a code block from being optimized, the predictions
+// the DFG compiled with, the speculation checks it emitted, and each OSR entry and exit. Messages
+// go to the embedder's callback (see JSSetOptimizationDiagnosticsCallback() in JSSettingsEA.h),
+// one line each, starting with the code block they are about. Nothing is logged or generated
+// without a callback; exits are only reported from code compiled while one was set.
+class JITDiagnostics {
+public:
+    typedef void (*Callback)(const char* message);
+
+    static void setCallback(Callback callback) { s_callback = callback; }
+    static Callback callback() { return s_callback; }
+
+    static bool isEnabled() { return UNLIKELY(!!s_callback); }
+    static void log(CodeBlock*, const char* format, ...) WTF_ATTRIBUTE_PRINTF(2, 3);
+
+private:
+    static Callback s_callback;
+};
+
+} // namespace JSC
+
+#endif // JITDiagnostics_h
@@ -384,21 +384,39 @@ ALWAYS_INLINE bool JIT::isOperandConstantImmediateChar(unsigned src)
     return m_codeBlock->isConstantRegisterIndex(src) && getConstantOperand(src).isString() && asString(getConstantOperand(src).asCell())->length() == 1;
 }
 
-template <typename ClassType, typename StructureType> inline void JIT::emitAllocateBasicJSObject(StructureType structure, void* vtable, RegisterID result, RegisterID storagePtr)
+template <typename ClassType, typename StructureType> inline void JIT::emitAllocateBasicJSCell(StructureType structure, void* vtable, RegisterID result, RegisterID scratch, JumpList& failures)
 {
     NewSpace::SizeClass* sizeClass = &m_globalData->heap.sizeClassFor(sizeof(ClassType));
     loadPtr(&sizeClass->firstFreeCell, result);
-    addSlowCase(branchTestPtr(Zero, result));
+    Jump popFreeList = branchTestPtr(NonZero, result);
+
+    // there is no free list, so bump allocate out of a fresh block
+    loadPtr(&sizeClass->bumpPointer, result);
+    loadPtr(&sizeClass->bumpEnd, scratch);
+    failures.append(branchPtr(AboveOrEqual, result, scratch));
+    addPtr(TrustedImm32(static_cast<int32_t>(sizeClass->cellSize)), result, scratch);
+    storePtr(scratch, &sizeClass->bumpPointer);
+    Jump initialize = jump();
+
+    // remove the cell from the free list
+    popFreeList.link(this);
+    loadPtr(Address(result), scratch);
+    storePtr(scratch, &sizeClass->firstFreeCell);
 
-    // remove the object from the free list
-    loadPtr(Address(result), storagePtr);
-    storePtr(storagePtr, &sizeClass->firstFreeCell);
+    initialize.link(this);
 
-    // initialize the object's vtable
+    // initialize the cell's vtable
     storePtr(TrustedImmPtr(vtable), Address(result));
 
-    // initialize the object's structure
+    // initialize the cell's structure
     storePtr(structure, Address(result, JSCell::structureOffset()));
+}
+
+template <typename ClassType, typename StructureType> inline void JIT::emitAllocateBasicJSObject(StructureType structure, void* vtable, RegisterID result, RegisterID storagePtr)
+{
+    JumpList failures;
+    emitAllocateBasicJSCell<ClassType>(structure, vtable, result, storagePtr, failures);
+    addSlowCase(failures);
 
     // initialize the inheritor ID
     storePtr(TrustedImmPtr(0), Address(result, JSObject::offsetOfInheritorID()));
@@ -432,6 +450,18 @@ inline void JIT::emitAllocateJSFunction(FunctionExecutable* executable, Register
 #endif
 }
 
+#if ENABLE(GGC)
+// Takes the slow case once the allocation site's countdown runs out, so that
+// the stub can sample the allocation, or pretenure it. See AllocationSiteScope.
+inline void JIT::emitAllocationSiteCountdown(unsigned profileIndex, RegisterID scratch)
+{
+    AllocationSiteProfile* profile = &m_codeBlock->allocationSiteProfile(profileIndex);
+    move(TrustedImmPtr(&profile->countdown), scratch);
+    sub32(TrustedImm32(1), Address(scratch));
+    addSlowCase(branch32(LessThanOrEqual, Address(scratch), TrustedImm32(0)));
+}
+#endif
+
 #if ENABLE(VALUE_PROFILER)
 inline void JIT::emitValueProfilingSite(ValueProfilingSiteKind siteKind)
 {
@@ -163,7 +163,7 @@ PassRefPtr<ExecutableMemoryHandle> JIT::privateCompileCTIMachineTrampolines(JSGl
     patchBuffer.link(callCompileCall, FunctionPtr(cti_op_call_jitCompile));
     patchBuffer.link(callCompileConstruct, FunctionPtr(cti_op_construct_jitCompile));
 
-    CodeRef finalCode = patchBuffer.finalizeCode();
+    CodeRef finalCode = patchBuffer.finalizeCode("JIT trampolines");
     RefPtr<ExecutableMemoryHandle> executableMemory = finalCode.executableMemory();
 
     trampolines->ctiVirtualCallLink = patchBuffer.trampolineAt(virtualCallLinkBegin);
@@ -335,6 +335,9 @@ void JIT::emit_op_jmp(Instruction* currentInstruction)
 
 void JIT::emit_op_new_object(Instruction* currentInstruction)
 {
+#if ENABLE(GGC)
+    emitAllocationSiteCountdown(currentInstruction[2].u.operand, regT0);
+#endif
     emitAllocateJSFinalObject(ImmPtr(m_codeBlock->globalObject()->emptyObjectStructure()), regT0, regT1);
     
     emitPutVirtualRegister(currentInstruction[1].u.operand);
@@ -342,8 +345,13 @@ void JIT::emit_op_new_object(Instruction* currentInstruction)
 
 void JIT::emitSlow_op_new_object(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
+#if ENABLE(GGC)
+    linkSlowCase(iter);
+#endif
     linkSlowCase(iter);
-    JITStubCall(this, cti_op_new_object).call(currentInstruction[1].u.operand);
+    JITStubCall stubCall(this, cti_op_new_object);
+    stubCall.addArgument(TrustedImmPtr(&m_codeBlock->allocationSiteProfile(currentInstruction[2].u.operand)));
+    stubCall.call(currentInstruction[1].u.operand);
 }
 
 void JIT::emit_op_check_has_instance(Instruction* currentInstruction)
@@ -360,6 +368,20 @@ void JIT::emit_op_check_has_instance(Instruction* currentInstruction)
     addSlowCase(branchTest8(Zero, Address(regT0, Structure::typeInfoFlagsOffset()), TrustedImm32(ImplementsHasInstance)));
 }
 
+void JIT::emit_op_in(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned base = currentInstruction[3].u.operand;
+
+    // Fast case: base still has the Structure under which the (constant) property was last found as an own property.
+    emitGetVirtualRegister(base, regT0);
+    emitJumpSlowCaseIfNotJSCell(regT0, base);
+    loadPtr(&currentInstruction[4].u.structure, regT1);
+    addSlowCase(branchPtr(NotEqual, regT1, Address(regT0, JSCell::structureOffset())));
+    move(TrustedImmPtr(JSValue::encode(jsBoolean(true))), regT0);
+    emitPutVirtualRegister(dst);
+}
+
 void JIT::emit_op_instanceof(Instruction* currentInstruction)
 {
     unsigned dst = currentInstruction[1].u.operand;
@@ -373,8 +395,7 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     emitGetVirtualRegister(baseVal, regT0);
     emitGetVirtualRegister(proto, regT1);
 
-    // Check that proto are cells.  baseVal must be a cell - this is checked by op_check_has_instance.
-    emitJumpSlowCaseIfNotJSCell(regT2, value);
+    // Check that proto is a cell.  baseVal must be a cell - this is checked by op_check_has_instance.
     emitJumpSlowCaseIfNotJSCell(regT1, proto);
 
     // Check that prototype is an object
@@ -389,7 +410,9 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     // Optimistically load the result true, and start looping.
     // Initially, regT1 still contains proto and regT2 still contains value.
     // As we loop regT2 will be updated with its prototype, recursively walking the prototype chain.
+    // A value that is not a cell has no prototype chain, so it is not an instance.
     move(TrustedImmPtr(JSValue::encode(jsBoolean(true))), regT0);
+    Jump valueNotCell = emitJumpIfNotJSCell(regT2);
     Label loop(this);
 
     // Load the prototype of the object in regT2.  If this is equal to regT1 - WIN!
@@ -400,6 +423,7 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     emitJumpIfJSCell(regT2).linkTo(loop, this);
 
     // We get here either by dropping out of the loop, or if value was not an Object.  Result is false.
+    valueNotCell.link(this);
     move(TrustedImmPtr(JSValue::encode(jsBoolean(false))), regT0);
 
     // isInstance jumps right down to here, to skip setting the result to false (it has already set true).
@@ -537,14 +561,6 @@ void JIT::emit_op_to_primitive(Instruction* currentInstruction)
 
 }
 
-void JIT::emit_op_strcat(Instruction* currentInstruction)
-{
-    JITStubCall stubCall(this, cti_op_strcat);
-    stubCall.addArgument(Imm32(currentInstruction[2].u.operand));
-    stubCall.addArgument(Imm32(currentInstruction[3].u.operand));
-    stubCall.call(currentInstruction[1].u.operand);
-}
-
 void JIT::emit_op_resolve_base(Instruction* currentInstruction)
 {
     JITStubCall stubCall(this, currentInstruction[3].u.operand ? cti_op_resolve_base_strict_put : cti_op_resolve_base);
@@ -806,12 +822,37 @@ void JIT::emit_op_get_pnames(Instruction* currentInstruction)
         isNotObject.append(emitJumpIfNotObject(regT2));
     }
 
-    // We could inline the case where you have a valid cache, but
-    // this call doesn't seem to be hot.
+    // Reuse the Structure's enumeration cache when its prototype chain still matches; this is
+    // the common case for nested for-in loops over objects of the same shape.
     Label isObject(this);
+    JumpList noCachedIterator;
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+    loadPtr(Address(regT2, Structure::enumerationCacheOffset()), regT1);
+    noCachedIterator.append(branchTestPtr(Zero, regT1));
+    loadPtr(Address(regT1, OBJECT_OFFSETOF(JSPropertyNameIterator, m_cachedPrototypeChain)), regT3);
+    noCachedIterator.append(branchPtr(NotEqual, regT3, Address(regT2, Structure::cachedPrototypeChainOffset())));
+    loadPtr(Address(regT3, OBJECT_OFFSETOF(StructureChain, m_vector)), regT3);
+    Jump prototypeChainIsValid = branchTestPtr(Zero, Address(regT3));
+
+    Label checkPrototype(this);
+    loadPtr(Address(regT2, Structure::prototypeOffset()), regT2);
+    noCachedIterator.append(emitJumpIfNotJSCell(regT2));
+    loadPtr(Address(regT2, JSCell::structureOffset()), regT2);
+    noCachedIterator.append(branchPtr(NotEqual, regT2, Address(regT3)));
+    addPtr(TrustedImm32(sizeof(Structure*)), regT3);
+    branchTestPtr(NonZero, Address(regT3)).linkTo(checkPrototype, this);
+
+    prototypeChainIsValid.link(this);
+    move(regT1, regT0);
+    emitPutVirtualRegister(dst);
+    Jump haveIterator = jump();
+
+    noCachedIterator.link(this);
     JITStubCall getPnamesStubCall(this, cti_op_get_pnames);
     getPnamesStubCall.addArgument(regT0);
     getPnamesStubCall.call(dst);
+
+    haveIterator.link(this);
     load32(Address(regT0, OBJECT_OFFSETOF(JSPropertyNameIterator, m_jsStringsSize)), regT3);
     storePtr(tagTypeNumberRegister, payloadFor(i));
     store32(TrustedImm32(Int32Tag), intTagFor(size));
@@ -1020,23 +1061,6 @@ void JIT::emit_op_switch_char(Instruction* currentInstruction)
     jump(regT0);
 }
 
-void JIT::emit_op_switch_string(Instruction* currentInstruction)
-{
-    unsigned tableIndex = currentInstruction[1].u.operand;
-    unsigned defaultOffset = currentInstruction[2].u.operand;
-    unsigned scrutinee = currentInstruction[3].u.operand;
-
-    // create jump table for switch destinations, track this switch statement.
-    StringJumpTable* jumpTable = &m_codeBlock->stringSwitchJumpTable(tableIndex);
-    m_switches.append(SwitchRecord(jumpTable, m_bytecodeOffset, defaultOffset));
-
-    JITStubCall stubCall(this, cti_op_switch_string);
-    stubCall.addArgument(scrutinee, regT2);
-    stubCall.addArgument(Imm32(tableIndex));
-    stubCall.call();
-    jump(regT0);
-}
-
 void JIT::emit_op_throw_reference_error(Instruction* currentInstruction)
 {
     JITStubCall stubCall(this, cti_op_throw_reference_error);
@@ -1107,14 +1131,80 @@ void JIT::emit_op_neq_null(Instruction* currentInstruction)
     emitPutVirtualRegister(dst);
 }
 
+void JIT::emit_op_is_undefined(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitGetVirtualRegister(value, regT0);
+    Jump isCell = emitJumpIfJSCell(regT0);
+
+    comparePtr(Equal, regT0, TrustedImm32(ValueUndefined), regT0);
+    Jump done = jump();
+
+    isCell.link(this);
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT1);
+    test8(NonZero, Address(regT1, Structure::typeInfoFlagsOffset()), TrustedImm32(MasqueradesAsUndefined), regT0);
+
+    done.link(this);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(dst);
+}
+
+void JIT::emit_op_is_boolean(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    // As in op_not, a boolean xor'ed with JSValue(false) leaves only the low bit.
+    emitGetVirtualRegister(value, regT0);
+    xorPtr(TrustedImm32(static_cast<int32_t>(ValueFalse)), regT0);
+    comparePtr(BelowOrEqual, regT0, TrustedImm32(1), regT0);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(dst);
+}
+
+void JIT::emit_op_is_number(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitGetVirtualRegister(value, regT0);
+    andPtr(tagTypeNumberRegister, regT0);
+    comparePtr(NotEqual, regT0, TrustedImm32(0), regT0);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(dst);
+}
+
+void JIT::emit_op_is_string(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitGetVirtualRegister(value, regT0);
+    Jump isNotCell = emitJumpIfNotJSCell(regT0);
+    Jump isNotString = branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr));
+
+    move(TrustedImm32(1), regT0);
+    Jump done = jump();
+
+    isNotCell.link(this);
+    isNotString.link(this);
+    move(TrustedImm32(0), regT0);
+
+    done.link(this);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(dst);
+}
+
 void JIT::emit_op_enter(Instruction*)
 {
     // Even though CTI doesn't use them, we initialize our constant
     // registers to zap stale pointers, to avoid unnecessarily prolonging
     // object lifetime and increasing GC pressure.
-    size_t count = m_codeBlock->m_numVars;
-    for (size_t j = 0; j < count; ++j)
-        emitInitRegister(j);
+    const Vector<int>& varsToInitialize = m_codeBlock->varsToInitialize();
+    for (size_t j = 0; j < varsToInitialize.size(); ++j)
+        emitInitRegister(varsToInitialize[j]);
 
 }
 
@@ -1301,13 +1391,42 @@ void JIT::emitSlow_op_bitor(Instruction* currentInstruction, Vector<SlowCaseEntr
     stubCall.call(currentInstruction[1].u.operand);
 }
 
+// Decides the equality of regT0 and regT1 without a stub call when they are the same cell,
+// or two strings of different lengths; either way equality and strict equality agree.
+// Falls through with the result in regT0, or jumps to undecided with both operands intact.
+void JIT::emitCellEqualityFastPath(JumpList& undecided)
+{
+    undecided.append(emitJumpIfNotJSCell(regT0));
+    undecided.append(emitJumpIfNotJSCell(regT1));
+    Jump notSameCell = branchPtr(NotEqual, regT0, regT1);
+    move(TrustedImm32(1), regT0);
+    Jump done = jump();
+
+    // A rope knows its length too, so only strings of equal length need the stub's character compare.
+    notSameCell.link(this);
+    undecided.append(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr)));
+    undecided.append(branchPtr(NotEqual, Address(regT1), TrustedImmPtr(m_globalData->jsStringVPtr)));
+    load32(Address(regT1, OBJECT_OFFSETOF(JSString, m_length)), regT2);
+    undecided.append(branch32(Equal, Address(regT0, OBJECT_OFFSETOF(JSString, m_length)), regT2));
+    move(TrustedImm32(0), regT0);
+
+    done.link(this);
+}
+
 void JIT::emitSlow_op_eq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     linkSlowCase(iter);
+    JumpList undecided;
+    emitCellEqualityFastPath(undecided);
+    Jump decided = jump();
+
+    undecided.link(this);
     JITStubCall stubCall(this, cti_op_eq);
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
     stubCall.call();
+
+    decided.link(this);
     emitTagAsBoolImmediate(regT0);
     emitPutVirtualRegister(currentInstruction[1].u.operand);
 }
@@ -1315,10 +1434,17 @@ void JIT::emitSlow_op_eq(Instruction* currentInstruction, Vector<SlowCaseEntry>:
 void JIT::emitSlow_op_neq(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     linkSlowCase(iter);
+    JumpList undecided;
+    emitCellEqualityFastPath(undecided);
+    Jump decided = jump();
+
+    undecided.link(this);
     JITStubCall stubCall(this, cti_op_eq);
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
     stubCall.call();
+
+    decided.link(this);
     xor32(TrustedImm32(0x1), regT0);
     emitTagAsBoolImmediate(regT0);
     emitPutVirtualRegister(currentInstruction[1].u.operand);
@@ -1328,6 +1454,13 @@ void JIT::emitSlow_op_stricteq(Instruction* currentInstruction, Vector<SlowCaseE
 {
     linkSlowCase(iter);
     linkSlowCase(iter);
+    JumpList undecided;
+    emitCellEqualityFastPath(undecided);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(currentInstruction[1].u.operand);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_stricteq));
+
+    undecided.link(this);
     JITStubCall stubCall(this, cti_op_stricteq);
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
@@ -1338,6 +1471,14 @@ void JIT::emitSlow_op_nstricteq(Instruction* currentInstruction, Vector<SlowCase
 {
     linkSlowCase(iter);
     linkSlowCase(iter);
+    JumpList undecided;
+    emitCellEqualityFastPath(undecided);
+    xor32(TrustedImm32(0x1), regT0);
+    emitTagAsBoolImmediate(regT0);
+    emitPutVirtualRegister(currentInstruction[1].u.operand);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_nstricteq));
+
+    undecided.link(this);
     JITStubCall stubCall(this, cti_op_nstricteq);
     stubCall.addArgument(regT0);
     stubCall.addArgument(regT1);
@@ -1355,6 +1496,21 @@ void JIT::emitSlow_op_check_has_instance(Instruction* currentInstruction, Vector
     stubCall.call();
 }
 
+void JIT::emitSlow_op_in(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned property = currentInstruction[2].u.operand;
+    unsigned base = currentInstruction[3].u.operand;
+
+    linkSlowCaseIfNotJSCell(iter, base);
+    linkSlowCase(iter);
+    JITStubCall stubCall(this, cti_op_in);
+    stubCall.addArgument(property, regT2);
+    stubCall.addArgument(base, regT2);
+    stubCall.addArgument(TrustedImmPtr(currentInstruction));
+    stubCall.call(dst);
+}
+
 void JIT::emitSlow_op_instanceof(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned dst = currentInstruction[1].u.operand;
@@ -1362,7 +1518,6 @@ void JIT::emitSlow_op_instanceof(Instruction* currentInstruction, Vector<SlowCas
     unsigned baseVal = currentInstruction[3].u.operand;
     unsigned proto = currentInstruction[4].u.operand;
 
-    linkSlowCaseIfNotJSCell(iter, value);
     linkSlowCaseIfNotJSCell(iter, proto);
     linkSlowCase(iter);
     linkSlowCase(iter);
@@ -1482,11 +1637,234 @@ void JIT::emitSlow_op_get_argument_by_val(Instruction* currentInstruction, Vecto
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(arguments, regT2);
     stubCall.addArgument(property, regT2);
+    stubCall.addArgument(TrustedImmPtr(0));
     stubCall.call(dst);
 }
 
 #endif // USE(JSVALUE64)
 
+// Concatenates the strings in the sources into a new rope whose fibers are their StringImpls, for
+// the common case where each source is a flat, non-empty string whose memory the heap has
+// already been told about. Everything else, and a full size class, goes to the slow cases,
+// which should call into jsString(); their number depends on count.
+void JIT::emitInlineStringConcatenation(unsigned dst, const unsigned* sources, unsigned count)
+{
+    ASSERT(count >= 2 && count <= JSString::s_maxInternalRopeLength);
+#if USE(JSVALUE32_64)
+    unmap();
+#else
+    killLastResultRegister();
+#endif
+
+    for (unsigned i = 0; i < count; ++i) {
+#if USE(JSVALUE32_64)
+        emitLoad(sources[i], regT1, regT0);
+        addSlowCase(branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag)));
+#else
+        emitGetVirtualRegister(sources[i], regT0);
+        addSlowCase(emitJumpIfNotJSCell(regT0));
+#endif
+        addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr)));
+        addSlowCase(branchTest32(NonZero, Address(regT0, OBJECT_OFFSETOF(JSString, m_fiberCount))));
+
+        // An empty operand makes the result the other operand, not a rope.
+        load32(Address(regT0, OBJECT_OFFSETOF(JSString, m_length)), regT1);
+        addSlowCase(branchTest32(Zero, regT1));
+        if (!i)
+            move(regT1, regT2);
+        else
+            addSlowCase(branchAdd32(Overflow, regT1, regT2));
+
+        // The rope reports no memory of its own, so cost() must have nothing left to report:
+        // the string must not be a substring, whose cost is its base string's, nor have its
+        // cost unreported.
+        loadPtr(Address(regT0, OBJECT_OFFSETOF(JSString, m_value)), regT1);
+        load32(Address(regT1, OBJECT_OFFSETOF(StringImplBase, m_refCountAndFlags)), regT1);
+        and32(TrustedImm32(StringImplBase::s_refCountFlagShouldReportedCost | StringImplBase::s_refCountMaskBufferOwnership), regT1);
+        addSlowCase(branch32(AboveOrEqual, regT1, TrustedImm32(StringImplBase::s_refCountFlagShouldReportedCost)));
+        addSlowCase(branch32(Equal, regT1, TrustedImm32(StringImplBase::BufferSubstring)));
+    }
+
+    JumpList allocationFailures;
+    emitAllocateBasicJSCell<JSString>(TrustedImmPtr(m_globalData->stringStructure.get()), m_globalData->jsStringVPtr, regT0, regT1, allocationFailures);
+    addSlowCase(allocationFailures);
+
+    store32(regT2, Address(regT0, OBJECT_OFFSETOF(JSString, m_length)));
+    store32(TrustedImm32(0), Address(regT0, OBJECT_OFFSETOF(JSString, m_externalMemory)));
+    storePtr(TrustedImmPtr(0), Address(regT0, OBJECT_OFFSETOF(JSString, m_value)));
+    store32(TrustedImm32(count), Address(regT0, OBJECT_OFFSETOF(JSString, m_fiberCount)));
+    for (unsigned i = 0; i < count; ++i) {
+#if USE(JSVALUE32_64)
+        emitLoadPayload(sources[i], regT1);
+#else
+        emitGetVirtualRegister(sources[i], regT1);
+#endif
+        loadPtr(Address(regT1, OBJECT_OFFSETOF(JSString, m_value)), regT1);
+        add32(TrustedImm32(StringImplBase::s_refCountIncrement), Address(regT1, OBJECT_OFFSETOF(StringImplBase, m_refCountAndFlags)));
+        storePtr(regT1, Address(regT0, OBJECT_OFFSETOF(JSString, m_fibers) + i * sizeof(RopeImpl::Fiber)));
+    }
+
+    emitStoreCell(dst, regT0);
+}
+
+void JIT::emit_op_strcat(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned firstSource = currentInstruction[2].u.operand;
+    unsigned count = currentInstruction[3].u.operand;
+
+    if (count <= JSString::s_maxInternalRopeLength) {
+        unsigned sources[JSString::s_maxInternalRopeLength];
+        for (unsigned i = 0; i < count; ++i)
+            sources[i] = firstSource + i;
+        emitInlineStringConcatenation(dst, sources, count);
+        return;
+    }
+
+    JITStubCall stubCall(this, cti_op_strcat);
+    stubCall.addArgument(Imm32(firstSource));
+    stubCall.addArgument(Imm32(count));
+    stubCall.call(dst);
+}
+
+void JIT::emitSlow_op_strcat(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    linkAllSlowCasesForBytecodeOffset(iter);
+
+    JITStubCall stubCall(this, cti_op_strcat);
+    stubCall.addArgument(Imm32(currentInstruction[2].u.operand));
+    stubCall.addArgument(Imm32(currentInstruction[3].u.operand));
+    stubCall.call(currentInstruction[1].u.operand);
+}
+
+// Switches with at most this many cases compare the scrutinee against each case inline.
+static const unsigned maximumInlineStringSwitchCases = 8;
+
+// Picks the smallest power of two table, and the shift of the case strings' hashes, for which no
+// two cases share a slot. Returns false if there is no such table under eight slots per case.
+static bool buildStringSwitchHashTable(StringJumpTable& jumpTable)
+{
+    size_t caseCount = jumpTable.offsetTable.size();
+    size_t size = 1;
+    unsigned sizeBits = 0;
+    while (size < caseCount * 2) {
+        size *= 2;
+        ++sizeBits;
+    }
+
+    Vector<StringImpl*> keys;
+    StringJumpTable::StringOffsetTable::const_iterator end = jumpTable.offsetTable.end();
+    for (; size <= caseCount * 8; size *= 2, ++sizeBits) {
+        for (unsigned shift = 0; shift + sizeBits <= 32; ++shift) {
+            keys.fill(0, size);
+            bool collided = false;
+            for (StringJumpTable::StringOffsetTable::const_iterator it = jumpTable.offsetTable.begin(); it != end; ++it) {
+                StringImpl* key = it->first.get();
+                StringImpl*& slot = keys[(key->hash() >> shift) & (size - 1)];
+                if (slot) {
+                    collided = true;
+                    break;
+                }
+                slot = key;
+            }
+            if (!collided) {
+                jumpTable.ctiHashKeys.swap(keys);
+                jumpTable.ctiHashTargets.fill(0, size);
+                jumpTable.ctiHashShift = shift;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void JIT::emit_op_switch_string(Instruction* currentInstruction)
+{
+    unsigned tableIndex = currentInstruction[1].u.operand;
+    unsigned defaultOffset = currentInstruction[2].u.operand;
+    unsigned scrutinee = currentInstruction[3].u.operand;
+
+    // create jump table for switch destinations, track this switch statement.
+    StringJumpTable* jumpTable = &m_codeBlock->stringSwitchJumpTable(tableIndex);
+    m_switches.append(SwitchRecord(jumpTable, m_bytecodeOffset, defaultOffset));
+
+    // Values other than strings take the default case, and ropes are resolved by the stub.
+    JumpList callStub;
+#if USE(JSVALUE32_64)
+    emitLoad(scrutinee, regT1, regT0);
+    addJump(branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag)), defaultOffset);
+#else
+    emitGetVirtualRegister(scrutinee, regT0);
+    addJump(emitJumpIfNotJSCell(regT0), defaultOffset);
+#endif
+    addJump(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr)), defaultOffset);
+    callStub.append(branchTest32(NonZero, Address(regT0, OBJECT_OFFSETOF(JSString, m_fiberCount))));
+    load32(Address(regT0, OBJECT_OFFSETOF(JSString, m_length)), regT1);
+    loadPtr(Address(regT0, OBJECT_OFFSETOF(JSString, m_value)), regT0);
+
+    // The case labels are identifiers, and so are unique: an identifier that isn't the same
+    // StringImpl as a case doesn't match it.
+    Jump notIdentifier = branchTest32(Zero, Address(regT0, OBJECT_OFFSETOF(StringImplBase, m_refCountAndFlags)), TrustedImm32(StringImplBase::s_refCountFlagIsIdentifier));
+    StringJumpTable::StringOffsetTable::const_iterator end = jumpTable->offsetTable.end();
+    bool searchInline = jumpTable->offsetTable.size() <= maximumInlineStringSwitchCases;
+    if (searchInline) {
+        for (StringJumpTable::StringOffsetTable::const_iterator it = jumpTable->offsetTable.begin(); it != end; ++it)
+            addJump(branchPtr(Equal, regT0, TrustedImmPtr(it->first.get())), it->second.branchOffset);
+        addJump(jump(), defaultOffset);
+    } else if (buildStringSwitchHashTable(*jumpTable)) {
+        load32(Address(regT0, StringImpl::hashOffset()), regT1);
+        if (jumpTable->ctiHashShift)
+            urshift32(TrustedImm32(jumpTable->ctiHashShift), regT1);
+        and32(TrustedImm32(jumpTable->ctiHashKeys.size() - 1), regT1);
+        move(TrustedImmPtr(jumpTable->ctiHashKeys.data()), regT2);
+        loadPtr(BaseIndex(regT2, regT1, ScalePtr), regT2);
+        addJump(branchPtr(NotEqual, regT2, regT0), defaultOffset);
+        move(TrustedImmPtr(jumpTable->ctiHashTargets.data()), regT2);
+        loadPtr(BaseIndex(regT2, regT1, ScalePtr), regT2);
+        jump(regT2);
+    } else
+        callStub.append(jump());
+
+    // Other strings need comparing characters, which the stub does, only when some case has
+    // their length and first character.
+    notIdentifier.link(this);
+    if (searchInline) {
+        Vector<unsigned> lengths;
+        for (StringJumpTable::StringOffsetTable::const_iterator it = jumpTable->offsetTable.begin(); it != end; ++it) {
+            if (lengths.find(it->first->length()) == notFound)
+                lengths.append(it->first->length());
+        }
+        loadPtr(Address(regT0, StringImpl::dataOffset()), regT2);
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            if (!lengths[i]) {
+                callStub.append(branchTest32(Zero, regT1));
+                continue;
+            }
+            Jump otherLength = branch32(NotEqual, regT1, TrustedImm32(lengths[i]));
+            load16(Address(regT2), regT3);
+            for (StringJumpTable::StringOffsetTable::const_iterator it = jumpTable->offsetTable.begin(); it != end; ++it) {
+                if (it->first->length() == lengths[i])
+                    callStub.append(branch32(Equal, regT3, TrustedImm32(it->first->characters()[0])));
+            }
+            addJump(jump(), defaultOffset);
+            otherLength.link(this);
+        }
+        addJump(jump(), defaultOffset);
+    } else
+        callStub.append(jump());
+
+    callStub.link(this);
+    JITStubCall stubCall(this, cti_op_switch_string);
+#if USE(JSVALUE32_64)
+    stubCall.addArgument(scrutinee);
+#else
+    stubCall.addArgument(scrutinee, regT2);
+#endif
+    stubCall.addArgument(TrustedImm32(tableIndex));
+    stubCall.call();
+    jump(regT0);
+}
+
 void JIT::emit_op_resolve_global_dynamic(Instruction* currentInstruction)
 {
     int skip = currentInstruction[5].u.operand;
@@ -1549,16 +1927,6 @@ void JIT::emit_op_load_varargs(Instruction* currentInstruction)
     ASSERT(argsOffset <= registerOffset);
     
     int expectedParams = m_codeBlock->m_numParameters - 1;
-    // Don't do inline copying if we aren't guaranteed to have a single stream
-    // of arguments
-    if (expectedParams) {
-        JITStubCall stubCall(this, cti_op_load_varargs);
-        stubCall.addArgument(Imm32(argsOffset));
-        stubCall.call();
-        // Stores a naked int32 in the register file.
-        store32(returnValueRegister, Address(callFrameRegister, argCountDst * sizeof(Register)));
-        return;
-    }
 
 #if USE(JSVALUE32_64)
     addSlowCase(branch32(NotEqual, tagFor(argsOffset), TrustedImm32(JSValue::EmptyValueTag)));
@@ -1567,13 +1935,23 @@ void JIT::emit_op_load_varargs(Instruction* currentInstruction)
 #endif
     // Load arg count into regT0
     emitGetFromCallFrameHeader32(RegisterFile::ArgumentCount, regT0);
+    // With declared parameters the arguments are only a single stream when the
+    // caller passed no more than we expect; otherwise the extras are still in the
+    // caller's original slots and the stub stitches the two together.
+    if (expectedParams)
+        addSlowCase(branch32(Above, regT0, TrustedImm32(m_codeBlock->m_numParameters)));
     store32(TrustedImm32(Int32Tag), intTagFor(argCountDst));
     store32(regT0, intPayloadFor(argCountDst));
     Jump endBranch = branch32(Equal, regT0, TrustedImm32(1));
 
     mul32(TrustedImm32(sizeof(Register)), regT0, regT3);
-    addPtr(TrustedImm32(static_cast<unsigned>(sizeof(Register) - RegisterFile::CallFrameHeaderSize * sizeof(Register))), callFrameRegister, regT1);
-    subPtr(regT3, regT1); // regT1 is now the start of the out of line arguments
+    if (expectedParams) {
+        // The arguments are the leading parameters, which sit just below the call frame header.
+        addPtr(TrustedImm32((2 - RegisterFile::CallFrameHeaderSize - m_codeBlock->m_numParameters) * static_cast<int>(sizeof(Register))), callFrameRegister, regT1);
+    } else {
+        addPtr(TrustedImm32(static_cast<unsigned>(sizeof(Register) - RegisterFile::CallFrameHeaderSize * sizeof(Register))), callFrameRegister, regT1);
+        subPtr(regT3, regT1); // regT1 is now the start of the out of line arguments
+    }
     addPtr(Imm32(argsOffset * sizeof(Register)), callFrameRegister, regT2); // regT2 is the target buffer
     
     // Bounds check the registerfile
@@ -1598,10 +1976,10 @@ void JIT::emitSlow_op_load_varargs(Instruction* currentInstruction, Vector<SlowC
     int argCountDst = currentInstruction[1].u.operand;
     int argsOffset = currentInstruction[2].u.operand;
     int expectedParams = m_codeBlock->m_numParameters - 1;
-    if (expectedParams)
-        return;
     
     linkSlowCase(iter);
+    if (expectedParams)
+        linkSlowCase(iter);
     linkSlowCase(iter);
     JITStubCall stubCall(this, cti_op_load_varargs);
     stubCall.addArgument(Imm32(argsOffset));
@@ -1624,6 +2002,9 @@ void JIT::emit_op_new_func(Instruction* currentInstruction)
     }
 
     FunctionExecutable* executable = m_codeBlock->functionDecl(currentInstruction[2].u.operand);
+#if ENABLE(GGC)
+    emitAllocationSiteCountdown(currentInstruction[4].u.operand, regT0);
+#endif
     emitGetFromCallFrameHeaderPtr(RegisterFile::ScopeChain, regT2);
     emitAllocateJSFunction(executable, regT2, regT0, regT1);
 
@@ -1641,9 +2022,13 @@ void JIT::emit_op_new_func(Instruction* currentInstruction)
 
 void JIT::emitSlow_op_new_func(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
+#if ENABLE(GGC)
+    linkSlowCase(iter);
+#endif
     linkSlowCase(iter);
     JITStubCall stubCall(this, cti_op_new_func);
     stubCall.addArgument(TrustedImmPtr(m_codeBlock->functionDecl(currentInstruction[2].u.operand)));
+    stubCall.addArgument(TrustedImmPtr(&m_codeBlock->allocationSiteProfile(currentInstruction[4].u.operand)));
     stubCall.call(currentInstruction[1].u.operand);
 }
 
@@ -1682,6 +2067,7 @@ void JIT::emit_op_new_array(Instruction* currentInstruction)
     JITStubCall stubCall(this, cti_op_new_array);
     stubCall.addArgument(Imm32(currentInstruction[2].u.operand));
     stubCall.addArgument(Imm32(currentInstruction[3].u.operand));
+    stubCall.addArgument(TrustedImmPtr(&m_codeBlock->allocationSiteProfile(currentInstruction[4].u.operand)));
     stubCall.call(currentInstruction[1].u.operand);
 }
 
@@ -1690,6 +2076,7 @@ void JIT::emit_op_new_array_buffer(Instruction* currentInstruction)
     JITStubCall stubCall(this, cti_op_new_array_buffer);
     stubCall.addArgument(Imm32(currentInstruction[2].u.operand));
     stubCall.addArgument(Imm32(currentInstruction[3].u.operand));
+    stubCall.addArgument(TrustedImmPtr(&m_codeBlock->allocationSiteProfile(currentInstruction[4].u.operand)));
     stubCall.call(currentInstruction[1].u.operand);
 }
 
@@ -162,7 +162,7 @@ PassRefPtr<ExecutableMemoryHandle> JIT::privateCompileCTIMachineTrampolines(JSGl
     patchBuffer.link(callCompileCall, FunctionPtr(cti_op_call_jitCompile));
     patchBuffer.link(callCompileCconstruct, FunctionPtr(cti_op_construct_jitCompile));
 
-    CodeRef finalCode = patchBuffer.finalizeCode();
+    CodeRef finalCode = patchBuffer.finalizeCode("JIT trampolines");
     RefPtr<ExecutableMemoryHandle> executableMemory = finalCode.executableMemory();
 
     trampolines->ctiVirtualCall = patchBuffer.trampolineAt(virtualCallBegin);
@@ -484,6 +484,9 @@ void JIT::emit_op_jmp(Instruction* currentInstruction)
 
 void JIT::emit_op_new_object(Instruction* currentInstruction)
 {
+#if ENABLE(GGC)
+    emitAllocationSiteCountdown(currentInstruction[2].u.operand, regT0);
+#endif
     emitAllocateJSFinalObject(ImmPtr(m_codeBlock->globalObject()->emptyObjectStructure()), regT0, regT1);
     
     emitStoreCell(currentInstruction[1].u.operand, regT0);
@@ -491,8 +494,13 @@ void JIT::emit_op_new_object(Instruction* currentInstruction)
 
 void JIT::emitSlow_op_new_object(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
+#if ENABLE(GGC)
+    linkSlowCase(iter);
+#endif
     linkSlowCase(iter);
-    JITStubCall(this, cti_op_new_object).call(currentInstruction[1].u.operand);
+    JITStubCall stubCall(this, cti_op_new_object);
+    stubCall.addArgument(TrustedImmPtr(&m_codeBlock->allocationSiteProfile(currentInstruction[2].u.operand)));
+    stubCall.call(currentInstruction[1].u.operand);
 }
 
 void JIT::emit_op_check_has_instance(Instruction* currentInstruction)
@@ -509,6 +517,20 @@ void JIT::emit_op_check_has_instance(Instruction* currentInstruction)
     addSlowCase(branchTest8(Zero, Address(regT0, Structure::typeInfoFlagsOffset()), TrustedImm32(ImplementsHasInstance)));
 }
 
+void JIT::emit_op_in(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned base = currentInstruction[3].u.operand;
+
+    // Fast case: base still has the Structure under which the (constant) property was last found as an own property.
+    emitLoad(base, regT1, regT0);
+    emitJumpSlowCaseIfNotJSCell(base, regT1);
+    loadPtr(&currentInstruction[4].u.structure, regT2);
+    addSlowCase(branchPtr(NotEqual, regT2, Address(regT0, JSCell::structureOffset())));
+    move(TrustedImm32(1), regT0);
+    emitStoreBool(dst, regT0);
+}
+
 void JIT::emit_op_instanceof(Instruction* currentInstruction)
 {
     unsigned dst = currentInstruction[1].u.operand;
@@ -522,8 +544,7 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     emitLoadPayload(baseVal, regT0);
     emitLoadPayload(proto, regT1);
 
-    // Check that proto are cells.  baseVal must be a cell - this is checked by op_check_has_instance.
-    emitJumpSlowCaseIfNotJSCell(value);
+    // Check that proto is a cell.  baseVal must be a cell - this is checked by op_check_has_instance.
     emitJumpSlowCaseIfNotJSCell(proto);
     
     // Check that prototype is an object
@@ -538,7 +559,10 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     // Optimistically load the result true, and start looping.
     // Initially, regT1 still contains proto and regT2 still contains value.
     // As we loop regT2 will be updated with its prototype, recursively walking the prototype chain.
+    // A value that is not a cell has no prototype chain, so it is not an instance.
+    emitLoadTag(value, regT3);
     move(TrustedImm32(1), regT0);
+    Jump valueNotCell = branch32(NotEqual, regT3, TrustedImm32(JSValue::CellTag));
     Label loop(this);
 
     // Load the prototype of the cell in regT2.  If this is equal to regT1 - WIN!
@@ -549,6 +573,7 @@ void JIT::emit_op_instanceof(Instruction* currentInstruction)
     branchTest32(NonZero, regT2).linkTo(loop, this);
 
     // We get here either by dropping out of the loop, or if value was not an Object.  Result is false.
+    valueNotCell.link(this);
     move(TrustedImm32(0), regT0);
 
     // isInstance jumps right down to here, to skip setting the result to false (it has already set true).
@@ -568,6 +593,21 @@ void JIT::emitSlow_op_check_has_instance(Instruction* currentInstruction, Vector
     stubCall.call();
 }
 
+void JIT::emitSlow_op_in(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned property = currentInstruction[2].u.operand;
+    unsigned base = currentInstruction[3].u.operand;
+
+    linkSlowCaseIfNotJSCell(iter, base);
+    linkSlowCase(iter);
+    JITStubCall stubCall(this, cti_op_in);
+    stubCall.addArgument(property);
+    stubCall.addArgument(base);
+    stubCall.addArgument(TrustedImmPtr(currentInstruction));
+    stubCall.call(dst);
+}
+
 void JIT::emitSlow_op_instanceof(Instruction* currentInstruction, Vector<SlowCaseEntry>::iterator& iter)
 {
     unsigned dst = currentInstruction[1].u.operand;
@@ -575,7 +615,6 @@ void JIT::emitSlow_op_instanceof(Instruction* currentInstruction, Vector<SlowCas
     unsigned baseVal = currentInstruction[3].u.operand;
     unsigned proto = currentInstruction[4].u.operand;
 
-    linkSlowCaseIfNotJSCell(iter, value);
     linkSlowCaseIfNotJSCell(iter, proto);
     linkSlowCase(iter);
     linkSlowCase(iter);
@@ -646,14 +685,6 @@ void JIT::emitSlow_op_to_primitive(Instruction* currentInstruction, Vector<SlowC
     stubCall.call(dst);
 }
 
-void JIT::emit_op_strcat(Instruction* currentInstruction)
-{
-    JITStubCall stubCall(this, cti_op_strcat);
-    stubCall.addArgument(Imm32(currentInstruction[2].u.operand));
-    stubCall.addArgument(Imm32(currentInstruction[3].u.operand));
-    stubCall.call(currentInstruction[1].u.operand);
-}
-
 void JIT::emit_op_resolve_base(Instruction* currentInstruction)
 {
     JITStubCall stubCall(this, currentInstruction[3].u.operand ? cti_op_resolve_base_strict_put : cti_op_resolve_base);
@@ -1101,6 +1132,68 @@ void JIT::emit_op_neq_null(Instruction* currentInstruction)
     emitStoreBool(dst, regT1);
 }
 
+void JIT::emit_op_is_undefined(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitLoad(value, regT1, regT0);
+    Jump isCell = branch32(Equal, regT1, TrustedImm32(JSValue::CellTag));
+
+    compare32(Equal, regT1, TrustedImm32(JSValue::UndefinedTag), regT0);
+    Jump done = jump();
+
+    isCell.link(this);
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT1);
+    test8(NonZero, Address(regT1, Structure::typeInfoFlagsOffset()), TrustedImm32(MasqueradesAsUndefined), regT0);
+
+    done.link(this);
+    emitStoreBool(dst, regT0);
+}
+
+void JIT::emit_op_is_boolean(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitLoadTag(value, regT0);
+    compare32(Equal, regT0, TrustedImm32(JSValue::BooleanTag), regT0);
+    emitStoreBool(dst, regT0);
+}
+
+void JIT::emit_op_is_number(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    // Doubles have tags below LowestTag, and Int32Tag is the largest tag, so adding one to the
+    // tag leaves every number below LowestTag + 1 and every other value at or above it.
+    emitLoadTag(value, regT0);
+    add32(TrustedImm32(1), regT0);
+    compare32(Below, regT0, TrustedImm32(JSValue::LowestTag + 1), regT0);
+    emitStoreBool(dst, regT0);
+}
+
+void JIT::emit_op_is_string(Instruction* currentInstruction)
+{
+    unsigned dst = currentInstruction[1].u.operand;
+    unsigned value = currentInstruction[2].u.operand;
+
+    emitLoad(value, regT1, regT0);
+    Jump isNotCell = branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag));
+    Jump isNotString = branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr));
+
+    move(TrustedImm32(1), regT0);
+    Jump done = jump();
+
+    isNotCell.link(this);
+    isNotString.link(this);
+    move(TrustedImm32(0), regT0);
+
+    done.link(this);
+    emitStoreBool(dst, regT0);
+}
+
 void JIT::emit_op_resolve_with_base(Instruction* currentInstruction)
 {
     JITStubCall stubCall(this, cti_op_resolve_with_base);
@@ -1149,12 +1242,37 @@ void JIT::emit_op_get_pnames(Instruction* currentInstruction)
         isNotObject.append(emitJumpIfNotObject(regT2));
     }
 
-    // We could inline the case where you have a valid cache, but
-    // this call doesn't seem to be hot.
+    // Reuse the Structure's enumeration cache when its prototype chain still matches; this is
+    // the common case for nested for-in loops over objects of the same shape.
     Label isObject(this);
+    JumpList noCachedIterator;
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+    loadPtr(Address(regT2, Structure::enumerationCacheOffset()), regT1);
+    noCachedIterator.append(branchTestPtr(Zero, regT1));
+    loadPtr(Address(regT1, OBJECT_OFFSETOF(JSPropertyNameIterator, m_cachedPrototypeChain)), regT3);
+    noCachedIterator.append(branchPtr(NotEqual, regT3, Address(regT2, Structure::cachedPrototypeChainOffset())));
+    loadPtr(Address(regT3, OBJECT_OFFSETOF(StructureChain, m_vector)), regT3);
+    Jump prototypeChainIsValid = branchTestPtr(Zero, Address(regT3));
+
+    Label checkPrototype(this);
+    noCachedIterator.append(branch32(Equal, Address(regT2, Structure::prototypeOffset() + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), TrustedImm32(JSValue::NullTag)));
+    loadPtr(Address(regT2, Structure::prototypeOffset() + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT2);
+    loadPtr(Address(regT2, JSCell::structureOffset()), regT2);
+    noCachedIterator.append(branchPtr(NotEqual, regT2, Address(regT3)));
+    addPtr(TrustedImm32(sizeof(Structure*)), regT3);
+    branchTestPtr(NonZero, Address(regT3)).linkTo(checkPrototype, this);
+
+    prototypeChainIsValid.link(this);
+    move(regT1, regT0);
+    emitStoreCell(dst, regT0);
+    Jump haveIterator = jump();
+
+    noCachedIterator.link(this);
     JITStubCall getPnamesStubCall(this, cti_op_get_pnames);
     getPnamesStubCall.addArgument(regT0);
     getPnamesStubCall.call(dst);
+
+    haveIterator.link(this);
     load32(Address(regT0, OBJECT_OFFSETOF(JSPropertyNameIterator, m_jsStringsSize)), regT3);
     store32(TrustedImm32(Int32Tag), intTagFor(i));
     store32(TrustedImm32(0), intPayloadFor(i));
@@ -1346,23 +1464,6 @@ void JIT::emit_op_switch_char(Instruction* currentInstruction)
     jump(regT0);
 }
 
-void JIT::emit_op_switch_string(Instruction* currentInstruction)
-{
-    unsigned tableIndex = currentInstruction[1].u.operand;
-    unsigned defaultOffset = currentInstruction[2].u.operand;
-    unsigned scrutinee = currentInstruction[3].u.operand;
-
-    // create jump table for switch destinations, track this switch statement.
-    StringJumpTable* jumpTable = &m_codeBlock->stringSwitchJumpTable(tableIndex);
-    m_switches.append(SwitchRecord(jumpTable, m_bytecodeOffset, defaultOffset));
-
-    JITStubCall stubCall(this, cti_op_switch_string);
-    stubCall.addArgument(scrutinee);
-    stubCall.addArgument(Imm32(tableIndex));
-    stubCall.call();
-    jump(regT0);
-}
-
 void JIT::emit_op_throw_reference_error(Instruction* currentInstruction)
 {
     unsigned message = currentInstruction[1].u.operand;
@@ -1392,8 +1493,9 @@ void JIT::emit_op_enter(Instruction*)
     // Even though JIT code doesn't use them, we initialize our constant
     // registers to zap stale pointers, to avoid unnecessarily prolonging
     // object lifetime and increasing GC pressure.
-    for (int i = 0; i < m_codeBlock->m_numVars; ++i)
-        emitStore(i, jsUndefined());
+    const Vector<int>& varsToInitialize = m_codeBlock->varsToInitialize();
+    for (size_t i = 0; i < varsToInitialize.size(); ++i)
+        emitStore(varsToInitialize[i], jsUndefined());
 }
 
 void JIT::emit_op_create_activation(Instruction* currentInstruction)
@@ -1603,6 +1705,7 @@ void JIT::emitSlow_op_get_argument_by_val(Instruction* currentInstruction, Vecto
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(arguments);
     stubCall.addArgument(property);
+    stubCall.addArgument(TrustedImmPtr(0));
     stubCall.call(dst);
 }
 
@@ -28,6 +28,7 @@
 #if ENABLE(JIT)
 #include "JIT.h"
 
+#include "Arguments.h"
 #include "CodeBlock.h"
 #include "GetterSetter.h"
 #include "JITInlineMethods.h"
@@ -116,11 +117,23 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     unsigned dst = currentInstruction[1].u.operand;
     unsigned base = currentInstruction[2].u.operand;
     unsigned property = currentInstruction[3].u.operand;
+    ByValStringCacheInfo* cacheInfo = &m_codeBlock->byValStringCacheInfo(m_byValStringCacheInfoIndex++);
     
     linkSlowCase(iter); // property int32 check
+    JumpList notCached = emitByValStringCacheCheck(cacheInfo);
+    compileGetDirectOffset(regT0, regT0, regT1, regT2);
+    emitValueProfilingSite(SubsequentProfilingSite);
+    emitPutVirtualRegister(dst);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
+
     linkSlowCaseIfNotJSCell(iter, base); // base cell check
     Jump nonCell = jump();
     linkSlowCase(iter); // base array check
+    JumpList notArgument = emitArgumentsGetByVal();
+    emitValueProfilingSite(SubsequentProfilingSite);
+    emitPutVirtualRegister(dst);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
+    notArgument.link(this);
     Jump notString = branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr));
     emitNakedCall(CodeLocationLabel(m_globalData->getCTIStub(stringGetByValStubGenerator).code()));
     Jump failed = branchTestPtr(Zero, regT0);
@@ -129,6 +142,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     failed.link(this);
     notString.link(this);
     nonCell.link(this);
+    notCached.link(this);
     
     linkSlowCase(iter); // vector length check
     linkSlowCase(iter); // empty value
@@ -136,6 +150,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(base, regT2);
     stubCall.addArgument(property, regT2);
+    stubCall.addArgument(TrustedImmPtr(cacheInfo));
     stubCall.call(dst);
 
     emitValueProfilingSite(SubsequentProfilingSite);
@@ -186,6 +201,7 @@ void JIT::emitSlow_op_get_by_pname(Instruction* currentInstruction, Vector<SlowC
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(base, regT2);
     stubCall.addArgument(property, regT2);
+    stubCall.addArgument(TrustedImmPtr(0));
     stubCall.call(dst);
 }
 
@@ -200,6 +216,7 @@ void JIT::emit_op_put_by_val(Instruction* currentInstruction)
     // See comment in op_get_by_val.
     zeroExtend32ToPtr(regT1, regT1);
     emitJumpSlowCaseIfNotJSCell(regT0, base);
+    emitWriteBarrier(regT0, regT3, WriteBarrierForPropertyAccess);
     addSlowCase(branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsArrayVPtr)));
     addSlowCase(branch32(AboveOrEqual, regT1, Address(regT0, JSArray::vectorLengthOffset())));
 
@@ -228,19 +245,74 @@ void JIT::emitSlow_op_put_by_val(Instruction* currentInstruction, Vector<SlowCas
     unsigned base = currentInstruction[1].u.operand;
     unsigned property = currentInstruction[2].u.operand;
     unsigned value = currentInstruction[3].u.operand;
+    ByValStringCacheInfo* cacheInfo = &m_codeBlock->byValStringCacheInfo(m_byValStringCacheInfoIndex++);
 
     linkSlowCase(iter); // property int32 check
+    JumpList notCached = emitByValStringCacheCheck(cacheInfo);
+    emitWriteBarrier(regT0, regT2, WriteBarrierForPropertyAccess);
+    loadPtr(Address(regT0, JSObject::offsetOfPropertyStorage()), regT2);
+    emitGetVirtualRegister(value, regT3);
+    storePtr(regT3, BaseIndex(regT2, regT1, ScalePtr));
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_put_by_val));
+
     linkSlowCaseIfNotJSCell(iter, base); // base cell check
     linkSlowCase(iter); // base not array check
     linkSlowCase(iter); // in vector check
+    notCached.link(this);
 
     JITStubCall stubPutByValCall(this, cti_op_put_by_val);
     stubPutByValCall.addArgument(regT0);
     stubPutByValCall.addArgument(property, regT2);
     stubPutByValCall.addArgument(value, regT2);
+    stubPutByValCall.addArgument(TrustedImmPtr(cacheInfo));
     stubPutByValCall.call();
 }
 
+// Reads an argument of the Arguments object in regT0, at the zero extended int32 index in regT1,
+// into regT0. Falls back, with regT0 and regT1 intact, for other cells, deleted arguments and
+// indices past the arguments passed. Clobbers regT2.
+MacroAssembler::JumpList JIT::emitArgumentsGetByVal()
+{
+    JumpList notArgument;
+    notArgument.append(branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(m_codeBlock->globalObject()->argumentsStructure())));
+    loadPtr(Address(regT0, Arguments::offsetOfData()), regT2);
+    notArgument.append(branchTestPtr(NonZero, Address(regT2, OBJECT_OFFSETOF(ArgumentsData, deletedArguments))));
+    notArgument.append(branch32(AboveOrEqual, regT1, Address(regT2, OBJECT_OFFSETOF(ArgumentsData, numArguments))));
+
+    Jump isExtraArgument = branch32(AboveOrEqual, regT1, Address(regT2, OBJECT_OFFSETOF(ArgumentsData, numParameters)));
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(ArgumentsData, firstParameterIndex)), regT0);
+    addPtr(regT1, regT0);
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(ArgumentsData, registers)), regT2);
+    loadPtr(BaseIndex(regT2, regT0, TimesEight), regT0);
+    Jump done = jump();
+
+    isExtraArgument.link(this);
+    sub32(Address(regT2, OBJECT_OFFSETOF(ArgumentsData, numParameters)), regT1);
+    loadPtr(Address(regT2, OBJECT_OFFSETOF(ArgumentsData, extraArguments)), regT2);
+    loadPtr(BaseIndex(regT2, regT1, TimesEight), regT0);
+    done.link(this);
+    return notArgument;
+}
+
+// Checks a by-val access, with the base in regT0 and the subscript in regT1, against the site's
+// string key cache. Falls through with the cached property offset in regT1 when the subscript is
+// the cached StringImpl and the base has the cached Structure. Clobbers regT2.
+MacroAssembler::JumpList JIT::emitByValStringCacheCheck(ByValStringCacheInfo* cacheInfo)
+{
+    JumpList notCached;
+    notCached.append(emitJumpIfNotJSCell(regT1));
+    notCached.append(emitJumpIfNotJSCell(regT0));
+    notCached.append(branchPtr(NotEqual, Address(regT1), TrustedImmPtr(m_globalData->jsStringVPtr)));
+
+    move(TrustedImmPtr(cacheInfo), regT2);
+    loadPtr(Address(regT1, ThunkHelpers::jsStringValueOffset()), regT1);
+    notCached.append(branchPtr(NotEqual, regT1, Address(regT2, OBJECT_OFFSETOF(ByValStringCacheInfo, key))));
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT1);
+    notCached.append(branchPtr(NotEqual, regT1, Address(regT2, OBJECT_OFFSETOF(ByValStringCacheInfo, structure))));
+    load32(Address(regT2, OBJECT_OFFSETOF(ByValStringCacheInfo, offset)), regT1);
+    return notCached;
+}
+
 void JIT::emit_op_put_by_index(Instruction* currentInstruction)
 {
     JITStubCall stubCall(this, cti_op_put_by_index);
@@ -569,6 +641,40 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     repatchBuffer.relinkCallerToTrampoline(returnAddress, CodeLocationLabel(stubInfo->stubRoutine.code()));
 }
 
+void JIT::privateCompilePutByIdSetter(StructureStubInfo* stubInfo, Structure* structure, StructureChain* chain, size_t count, ReturnAddressPtr returnAddress, CallFrame* callFrame)
+{
+    JumpList failureCases;
+    // Check eax is an object of the right Structure.
+    failureCases.append(emitJumpIfNotJSCell(regT0));
+    failureCases.append(branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(structure)));
+
+    // Check that the prototypes up to and including the one holding the accessor are unchanged.
+    Structure* currStructure = structure;
+    WriteBarrier<Structure>* it = chain->head();
+    for (unsigned i = 0; i < count; ++i, ++it) {
+        JSObject* protoObject = asObject(currStructure->prototypeForLookup(callFrame));
+        currStructure = it->get();
+        testPrototype(protoObject, failureCases);
+    }
+
+    // Checks out okay! cti_op_put_by_id_setter finds the accessor through the StructureStubInfo and calls the setter.
+    restoreArgumentReferenceForTrampoline();
+    Call setterCall = tailRecursiveCall();
+
+    failureCases.link(this);
+    restoreArgumentReferenceForTrampoline();
+    Call failureCall = tailRecursiveCall();
+
+    LinkBuffer patchBuffer(*m_globalData, this);
+
+    patchBuffer.link(setterCall, FunctionPtr(cti_op_put_by_id_setter));
+    patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_fail));
+
+    stubInfo->stubRoutine = patchBuffer.finalizeCode();
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, CodeLocationLabel(stubInfo->stubRoutine.code()));
+}
+
 void JIT::patchGetByIdSelf(CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
 {
     RepatchBuffer repatchBuffer(codeBlock);
@@ -636,6 +742,41 @@ void JIT::privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress)
     repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_array_fail));
 }
 
+void JIT::privateCompilePatchGetArgumentsLength(ReturnAddressPtr returnAddress)
+{
+    StructureStubInfo* stubInfo = &m_codeBlock->getStubInfo(returnAddress);
+
+    // Check eax is an Arguments object whose length has not been overwritten or deleted
+    Jump failureCases1 = branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(m_codeBlock->globalObject()->argumentsStructure()));
+    loadPtr(Address(regT0, Arguments::offsetOfData()), regT3);
+    Jump failureCases2 = branchTest8(NonZero, Address(regT3, OBJECT_OFFSETOF(ArgumentsData, overrodeLength)));
+
+    load32(Address(regT3, OBJECT_OFFSETOF(ArgumentsData, numArguments)), regT2);
+    emitFastArithIntToImmNoCheck(regT2, regT0);
+    Jump success = jump();
+
+    LinkBuffer patchBuffer(*m_globalData, this);
+
+    // Use the patch information to link the failure cases back to the original slow case routine.
+    CodeLocationLabel slowCaseBegin = stubInfo->callReturnLocation.labelAtOffset(-patchOffsetGetByIdSlowCaseCall);
+    patchBuffer.link(failureCases1, slowCaseBegin);
+    patchBuffer.link(failureCases2, slowCaseBegin);
+
+    // On success return back to the hot patch code, at a point it will perform the store to dest for us.
+    patchBuffer.link(success, stubInfo->hotPathBegin.labelAtOffset(patchOffsetGetByIdPutResult));
+
+    // Track the stub we have created so that it will be deleted later.
+    stubInfo->stubRoutine = patchBuffer.finalizeCode();
+
+    // Finally patch the jump to slow case back in the hot path to jump here instead.
+    CodeLocationJump jumpLocation = stubInfo->hotPathBegin.jumpAtOffset(patchOffsetGetByIdBranchToSlowCase);
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relink(jumpLocation, CodeLocationLabel(stubInfo->stubRoutine.code()));
+
+    // Like the array length stub, this is only patched in once.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_array_fail));
+}
+
 void JIT::privateCompileGetByIdProto(StructureStubInfo* stubInfo, Structure* structure, Structure* prototypeStructure, const Identifier& ident, const PropertySlot& slot, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame)
 {
     // The prototype object definitely exists (if this stub exists the CodeBlock is referencing a Structure that is
@@ -1030,6 +1171,15 @@ void JIT::emitWriteBarrier(RegisterID owner, RegisterID scratch, WriteBarrierUse
 #if ENABLE(WRITE_BARRIER_PROFILING)
     emitCount(WriteBarrierCounters::jitCounterFor(useKind));
 #endif
+
+#if ENABLE(GGC)
+    // Unconditionally remember the owner's block. This is cheaper than testing
+    // for an old-to-young store inline, and remembering a nursery block is
+    // harmless since nursery blocks are always rescanned.
+    move(owner, scratch);
+    andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+    store32(TrustedImm32(1), Address(scratch, MarkedBlock::offsetOfIsRemembered()));
+#endif
 }
 
 #endif // USE(JSVALUE64)
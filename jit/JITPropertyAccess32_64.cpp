@@ -29,6 +29,7 @@
 #if USE(JSVALUE32_64)
 #include "JIT.h"
 
+#include "Arguments.h"
 #include "CodeBlock.h"
 #include "JITInlineMethods.h"
 #include "JITStubCall.h"
@@ -225,12 +226,22 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     unsigned dst = currentInstruction[1].u.operand;
     unsigned base = currentInstruction[2].u.operand;
     unsigned property = currentInstruction[3].u.operand;
+    ByValStringCacheInfo* cacheInfo = &m_codeBlock->byValStringCacheInfo(m_byValStringCacheInfoIndex++);
     
     linkSlowCase(iter); // property int32 check
+    JumpList notCached = emitByValStringCacheCheck(cacheInfo);
+    compileGetDirectOffset(regT0, regT1, regT3, regT2);
+    emitStore(dst, regT1, regT3);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
+
     linkSlowCaseIfNotJSCell(iter, base); // base cell check
 
     Jump nonCell = jump();
     linkSlowCase(iter); // base array check
+    JumpList notArgument = emitArgumentsGetByVal();
+    emitStore(dst, regT1, regT0);
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_get_by_val));
+    notArgument.link(this);
     Jump notString = branchPtr(NotEqual, Address(regT0), TrustedImmPtr(m_globalData->jsStringVPtr));
     emitNakedCall(m_globalData->getCTIStub(stringGetByValStubGenerator).code());
     Jump failed = branchTestPtr(Zero, regT0);
@@ -239,6 +250,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     failed.link(this);
     notString.link(this);
     nonCell.link(this);
+    notCached.link(this);
 
     linkSlowCase(iter); // vector length check
     linkSlowCase(iter); // empty value
@@ -246,6 +258,7 @@ void JIT::emitSlow_op_get_by_val(Instruction* currentInstruction, Vector<SlowCas
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(base);
     stubCall.addArgument(property);
+    stubCall.addArgument(TrustedImmPtr(cacheInfo));
     stubCall.call(dst);
 }
 
@@ -289,19 +302,77 @@ void JIT::emitSlow_op_put_by_val(Instruction* currentInstruction, Vector<SlowCas
     unsigned base = currentInstruction[1].u.operand;
     unsigned property = currentInstruction[2].u.operand;
     unsigned value = currentInstruction[3].u.operand;
+    ByValStringCacheInfo* cacheInfo = &m_codeBlock->byValStringCacheInfo(m_byValStringCacheInfoIndex++);
     
     linkSlowCase(iter); // property int32 check
+    JumpList notCached = emitByValStringCacheCheck(cacheInfo);
+    emitWriteBarrier(regT0, regT1, WriteBarrierForPropertyAccess);
+    loadPtr(Address(regT0, JSObject::offsetOfPropertyStorage()), regT3);
+    emitLoad(value, regT1, regT0);
+    store32(regT0, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.payload))); // payload
+    store32(regT1, BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.tag))); // tag
+    emitJumpSlowToHot(jump(), OPCODE_LENGTH(op_put_by_val));
+
     linkSlowCaseIfNotJSCell(iter, base); // base cell check
     linkSlowCase(iter); // base not array check
     linkSlowCase(iter); // in vector check
+    notCached.link(this);
     
     JITStubCall stubPutByValCall(this, cti_op_put_by_val);
     stubPutByValCall.addArgument(base);
     stubPutByValCall.addArgument(property);
     stubPutByValCall.addArgument(value);
+    stubPutByValCall.addArgument(TrustedImmPtr(cacheInfo));
     stubPutByValCall.call();
 }
 
+// Reads an argument of the Arguments object in regT0, at the int32 index in regT2, into
+// regT1:regT0. Falls back, with regT0 and regT2 intact, for other cells, deleted arguments and
+// indices past the arguments passed. Clobbers regT3.
+MacroAssembler::JumpList JIT::emitArgumentsGetByVal()
+{
+    JumpList notArgument;
+    notArgument.append(branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(m_codeBlock->globalObject()->argumentsStructure())));
+    loadPtr(Address(regT0, Arguments::offsetOfData()), regT3);
+    notArgument.append(branchTestPtr(NonZero, Address(regT3, OBJECT_OFFSETOF(ArgumentsData, deletedArguments))));
+    notArgument.append(branch32(AboveOrEqual, regT2, Address(regT3, OBJECT_OFFSETOF(ArgumentsData, numArguments))));
+
+    Jump isExtraArgument = branch32(AboveOrEqual, regT2, Address(regT3, OBJECT_OFFSETOF(ArgumentsData, numParameters)));
+    load32(Address(regT3, OBJECT_OFFSETOF(ArgumentsData, firstParameterIndex)), regT0);
+    add32(regT2, regT0);
+    loadPtr(Address(regT3, OBJECT_OFFSETOF(ArgumentsData, registers)), regT3);
+    load32(BaseIndex(regT3, regT0, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT1);
+    load32(BaseIndex(regT3, regT0, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT0);
+    Jump done = jump();
+
+    isExtraArgument.link(this);
+    sub32(Address(regT3, OBJECT_OFFSETOF(ArgumentsData, numParameters)), regT2);
+    loadPtr(Address(regT3, OBJECT_OFFSETOF(ArgumentsData, extraArguments)), regT3);
+    load32(BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT1);
+    load32(BaseIndex(regT3, regT2, TimesEight, OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT0);
+    done.link(this);
+    return notArgument;
+}
+
+// Checks a by-val access, with the base in regT1:regT0 and the subscript in regT3:regT2, against
+// the site's string key cache. Falls through with the cached property offset in regT2 when the
+// subscript is the cached StringImpl and the base has the cached Structure. Clobbers regT3.
+MacroAssembler::JumpList JIT::emitByValStringCacheCheck(ByValStringCacheInfo* cacheInfo)
+{
+    JumpList notCached;
+    notCached.append(branch32(NotEqual, regT3, TrustedImm32(JSValue::CellTag)));
+    notCached.append(branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag)));
+    notCached.append(branchPtr(NotEqual, Address(regT2), TrustedImmPtr(m_globalData->jsStringVPtr)));
+
+    move(TrustedImmPtr(cacheInfo), regT3);
+    loadPtr(Address(regT2, ThunkHelpers::jsStringValueOffset()), regT2);
+    notCached.append(branchPtr(NotEqual, regT2, Address(regT3, OBJECT_OFFSETOF(ByValStringCacheInfo, key))));
+    loadPtr(Address(regT0, JSCell::structureOffset()), regT2);
+    notCached.append(branchPtr(NotEqual, regT2, Address(regT3, OBJECT_OFFSETOF(ByValStringCacheInfo, structure))));
+    load32(Address(regT3, OBJECT_OFFSETOF(ByValStringCacheInfo, offset)), regT2);
+    return notCached;
+}
+
 void JIT::emit_op_get_by_id(Instruction* currentInstruction)
 {
     int dst = currentInstruction[1].u.operand;
@@ -428,7 +499,12 @@ void JIT::emitSlow_op_put_by_id(Instruction* currentInstruction, Vector<SlowCase
     linkSlowCase(iter);
     
     JITStubCall stubCall(this, direct ? cti_op_put_by_id_direct : cti_op_put_by_id);
+#if ENABLE(GGC)
+    // The write barrier in the hot path uses regT1 as scratch.
+    stubCall.addArgument(base);
+#else
     stubCall.addArgument(regT1, regT0);
+#endif
     stubCall.addArgument(TrustedImmPtr(&(m_codeBlock->identifier(ident))));
     stubCall.addArgument(regT3, regT2); 
     Call call = stubCall.call();
@@ -555,6 +631,50 @@ void JIT::privateCompilePutByIdTransition(StructureStubInfo* stubInfo, Structure
     repatchBuffer.relinkCallerToTrampoline(returnAddress, CodeLocationLabel(stubInfo->stubRoutine.code()));
 }
 
+void JIT::privateCompilePutByIdSetter(StructureStubInfo* stubInfo, Structure* structure, StructureChain* chain, size_t count, ReturnAddressPtr returnAddress, CallFrame* callFrame)
+{
+    // The code below assumes that regT0 contains the basePayload and regT1 contains the baseTag. Restore them from the stack.
+#if CPU(MIPS) || CPU(SH4) || CPU(ARM)
+    // For MIPS, we don't add sizeof(void*) to the stack offset.
+    load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT0);
+    // For MIPS, we don't add sizeof(void*) to the stack offset.
+    load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[0]) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT1);
+#else
+    load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[0]) + sizeof(void*) + OBJECT_OFFSETOF(JSValue, u.asBits.payload)), regT0);
+    load32(Address(stackPointerRegister, OBJECT_OFFSETOF(JITStackFrame, args[0]) + sizeof(void*) + OBJECT_OFFSETOF(JSValue, u.asBits.tag)), regT1);
+#endif
+
+    JumpList failureCases;
+    failureCases.append(branch32(NotEqual, regT1, TrustedImm32(JSValue::CellTag)));
+    failureCases.append(branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(structure)));
+
+    // Check that the prototypes up to and including the one holding the accessor are unchanged.
+    Structure* currStructure = structure;
+    WriteBarrier<Structure>* it = chain->head();
+    for (unsigned i = 0; i < count; ++i, ++it) {
+        JSObject* protoObject = asObject(currStructure->prototypeForLookup(callFrame));
+        currStructure = it->get();
+        testPrototype(protoObject, failureCases);
+    }
+
+    // Checks out okay! cti_op_put_by_id_setter finds the accessor through the StructureStubInfo and calls the setter.
+    restoreArgumentReferenceForTrampoline();
+    Call setterCall = tailRecursiveCall();
+
+    failureCases.link(this);
+    restoreArgumentReferenceForTrampoline();
+    Call failureCall = tailRecursiveCall();
+
+    LinkBuffer patchBuffer(*m_globalData, this);
+
+    patchBuffer.link(setterCall, FunctionPtr(cti_op_put_by_id_setter));
+    patchBuffer.link(failureCall, FunctionPtr(cti_op_put_by_id_fail));
+
+    stubInfo->stubRoutine = patchBuffer.finalizeCode();
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relinkCallerToTrampoline(returnAddress, CodeLocationLabel(stubInfo->stubRoutine.code()));
+}
+
 void JIT::patchGetByIdSelf(CodeBlock* codeBlock, StructureStubInfo* stubInfo, Structure* structure, size_t cachedOffset, ReturnAddressPtr returnAddress)
 {
     RepatchBuffer repatchBuffer(codeBlock);
@@ -627,6 +747,43 @@ void JIT::privateCompilePatchGetArrayLength(ReturnAddressPtr returnAddress)
     repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_array_fail));
 }
 
+void JIT::privateCompilePatchGetArgumentsLength(ReturnAddressPtr returnAddress)
+{
+    StructureStubInfo* stubInfo = &m_codeBlock->getStubInfo(returnAddress);
+    
+    // regT0 holds a JSCell*
+    
+    // Check for an Arguments object whose length has not been overwritten or deleted
+    Jump failureCases1 = branchPtr(NotEqual, Address(regT0, JSCell::structureOffset()), TrustedImmPtr(m_codeBlock->globalObject()->argumentsStructure()));
+    loadPtr(Address(regT0, Arguments::offsetOfData()), regT2);
+    Jump failureCases2 = branchTest8(NonZero, Address(regT2, OBJECT_OFFSETOF(ArgumentsData, overrodeLength)));
+    
+    load32(Address(regT2, OBJECT_OFFSETOF(ArgumentsData, numArguments)), regT0);
+    move(TrustedImm32(JSValue::Int32Tag), regT1);
+    Jump success = jump();
+    
+    LinkBuffer patchBuffer(*m_globalData, this);
+    
+    // Use the patch information to link the failure cases back to the original slow case routine.
+    CodeLocationLabel slowCaseBegin = stubInfo->callReturnLocation.labelAtOffset(-patchOffsetGetByIdSlowCaseCall);
+    patchBuffer.link(failureCases1, slowCaseBegin);
+    patchBuffer.link(failureCases2, slowCaseBegin);
+    
+    // On success return back to the hot patch code, at a point it will perform the store to dest for us.
+    patchBuffer.link(success, stubInfo->hotPathBegin.labelAtOffset(patchOffsetGetByIdPutResult));
+    
+    // Track the stub we have created so that it will be deleted later.
+    stubInfo->stubRoutine = patchBuffer.finalizeCode();
+    
+    // Finally patch the jump to slow case back in the hot path to jump here instead.
+    CodeLocationJump jumpLocation = stubInfo->hotPathBegin.jumpAtOffset(patchOffsetGetByIdBranchToSlowCase);
+    RepatchBuffer repatchBuffer(m_codeBlock);
+    repatchBuffer.relink(jumpLocation, CodeLocationLabel(stubInfo->stubRoutine.code()));
+    
+    // Like the array length stub, this is only patched in once.
+    repatchBuffer.relinkCallerToFunction(returnAddress, FunctionPtr(cti_op_get_by_id_array_fail));
+}
+
 void JIT::privateCompileGetByIdProto(StructureStubInfo* stubInfo, Structure* structure, Structure* prototypeStructure, const Identifier& ident, const PropertySlot& slot, size_t cachedOffset, ReturnAddressPtr returnAddress, CallFrame* callFrame)
 {
     // regT0 holds a JSCell*
@@ -996,6 +1153,7 @@ void JIT::emitSlow_op_get_by_pname(Instruction* currentInstruction, Vector<SlowC
     JITStubCall stubCall(this, cti_op_get_by_val);
     stubCall.addArgument(base);
     stubCall.addArgument(property);
+    stubCall.addArgument(TrustedImmPtr(0));
     stubCall.call(dst);
 }
 
@@ -1096,6 +1254,15 @@ void JIT::emitWriteBarrier(RegisterID owner, RegisterID scratch, WriteBarrierUse
 #if ENABLE(WRITE_BARRIER_PROFILING)
     emitCount(WriteBarrierCounters::jitCounterFor(useKind));
 #endif
+
+#if ENABLE(GGC)
+    // Unconditionally remember the owner's block. This is cheaper than testing
+    // for an old-to-young store inline, and remembering a nursery block is
+    // harmless since nursery blocks are always rescanned.
+    move(owner, scratch);
+    andPtr(TrustedImm32(static_cast<int32_t>(MarkedBlock::blockMask)), scratch);
+    store32(TrustedImm32(1), Address(scratch, MarkedBlock::offsetOfIsRemembered()));
+#endif
 }
 
 } // namespace JSC
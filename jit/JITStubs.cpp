@@ -42,9 +42,11 @@
 #include "GetterSetter.h"
 #include "Heap.h"
 #include "JIT.h"
+#include "JITDiagnostics.h"
 #include "JSActivation.h"
 #include "JSArray.h"
 #include "JSByteArray.h"
+#include "JSTypedArray.h"
 #include "JSFunction.h"
 #include "JSGlobalObjectFunctions.h"
 #include "JSNotAnObject.h"
@@ -63,6 +65,7 @@
 #include <wtf/StdLibExtras.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <JSSettingsEA.h>
 
 using namespace std;
 
@@ -802,16 +805,33 @@ JITThunks::~JITThunks()
 {
 }
 
-NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const PutPropertySlot& slot, StructureStubInfo* stubInfo, bool direct)
+// Points a property access site's slow case at a stub that no longer tries to cache, and
+// records that in the site's StructureStubInfo for the inline cache statistics.
+static void ctiPatchCallToGeneric(CodeBlock* codeBlock, StructureStubInfo* stubInfo, ReturnAddressPtr returnAddress, FunctionPtr newCalleeFunction)
 {
+    stubInfo->setGeneric();
+    ctiPatchCallByReturnAddress(codeBlock, returnAddress, newCalleeFunction);
+}
+
+NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const Identifier& propertyName, const PutPropertySlot& slot, StructureStubInfo* stubInfo, bool direct)
+{
+    // Caching may link a stub and then repatch the site to reach it.
+    ExecutableMemoryBatchScope batch;
+
     // The interpreter checks for recursion here; I do not believe this can occur in CTI.
 
     if (!baseValue.isCell())
         return;
 
+    if (slot.isCacheableSetter()) {
+        ASSERT(!direct);
+        tryCachePutByIDSetter(callFrame, codeBlock, returnAddress, baseValue, propertyName, slot, stubInfo);
+        return;
+    }
+
     // Uncacheable: give up.
     if (!slot.isCacheable()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
         return;
     }
     
@@ -819,13 +839,13 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     Structure* structure = baseCell->structure();
 
     if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
         return;
     }
 
     // If baseCell != base, then baseCell must be a proxy for another object.
     if (baseCell != slot.base()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
         return;
     }
 
@@ -834,7 +854,7 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     // Structure transition, cache transition info
     if (slot.type() == PutPropertySlot::NewProperty) {
         if (structure->isDictionary()) {
-            ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
+            ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(direct ? cti_op_put_by_id_direct_generic : cti_op_put_by_id_generic));
             return;
         }
 
@@ -852,14 +872,42 @@ NEVER_INLINE void JITThunks::tryCachePutByID(CallFrame* callFrame, CodeBlock* co
     JIT::patchPutByIdReplace(codeBlock, stubInfo, structure, slot.cachedOffset(), returnAddress, direct);
 }
 
+NEVER_INLINE void JITThunks::tryCachePutByIDSetter(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const Identifier& propertyName, const PutPropertySlot& slot, StructureStubInfo* stubInfo)
+{
+    JSCell* baseCell = baseValue.asCell();
+    Structure* structure = baseCell->structure();
+
+    // A dictionary can gain a property that shadows the accessor without changing Structure.
+    if (structure->isDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_put_by_id_generic));
+        return;
+    }
+
+    size_t offset = slot.cachedOffset();
+    size_t count = 0;
+    if (slot.base() != baseCell) {
+        count = normalizePrototypeChain(callFrame, baseValue, slot.base(), propertyName, offset);
+        if (!count) {
+            ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_put_by_id_generic));
+            return;
+        }
+    }
+
+    StructureChain* prototypeChain = structure->prototypeChain(callFrame);
+    stubInfo->initPutByIdSetter(callFrame->globalData(), codeBlock->ownerExecutable(), structure, prototypeChain, count, offset);
+    JIT::compilePutByIdSetter(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, structure, prototypeChain, count, returnAddress);
+}
+
 NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* codeBlock, ReturnAddressPtr returnAddress, JSValue baseValue, const Identifier& propertyName, const PropertySlot& slot, StructureStubInfo* stubInfo)
 {
+    ExecutableMemoryBatchScope batch;
+
     // FIXME: Write a test that proves we need to check for recursion here just
     // like the interpreter does, then add a check for recursion.
 
     // FIXME: Cache property access for immediates.
     if (!baseValue.isCell()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
         return;
     }
     
@@ -877,9 +925,14 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
         return;
     }
 
+    if (baseValue.asCell()->structure() == codeBlock->globalObject()->argumentsStructure() && propertyName == callFrame->propertyNames().length) {
+        JIT::compilePatchGetArgumentsLength(callFrame->scopeChain()->globalData, codeBlock, returnAddress);
+        return;
+    }
+
     // Uncacheable: give up.
     if (!slot.isCacheable()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
         return;
     }
 
@@ -887,7 +940,7 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
     Structure* structure = baseCell->structure();
 
     if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
         return;
     }
 
@@ -903,9 +956,16 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
         return;
     }
 
+    // A dictionary can gain a shadowing property without changing Structure, so flatten the base
+    // before caching a prototype access through it. Objects that fall back into dictionary mode
+    // after a flattening are used as hash tables; flattening them again on every miss would copy
+    // their property table on each new property, so give up on those.
     if (structure->isDictionary()) {
-        ctiPatchCallByReturnAddress(codeBlock, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
-        return;
+        if (structure->hasBeenFlattenedBefore()) {
+            ctiPatchCallToGeneric(codeBlock, stubInfo, returnAddress, FunctionPtr(cti_op_get_by_id_generic));
+            return;
+        }
+        asObject(baseCell)->flattenDictionaryObject(callFrame->globalData());
     }
 
     if (slot.slotBase() == structure->prototypeForLookup(callFrame)) {
@@ -933,6 +993,7 @@ NEVER_INLINE void JITThunks::tryCacheGetByID(CallFrame* callFrame, CodeBlock* co
     size_t count = normalizePrototypeChain(callFrame, baseValue, slot.slotBase(), propertyName, offset);
     if (!count) {
         stubInfo->accessType = access_get_by_id_generic;
+        stubInfo->setGeneric();
         return;
     }
 
@@ -1343,10 +1404,15 @@ DEFINE_STUB_FUNCTION(int, timeout_check)
     JSGlobalData* globalData = stackFrame.globalData;
     TimeoutChecker& timeoutChecker = globalData->timeoutChecker;
 
+    // Only a sampling profile needs to know where the check was; finding the bytecode is a search.
+    TimeoutCheckSite site;
+    if (globalData->samplingProfiler)
+        site = TimeoutCheckSite(stackFrame.callFrame->codeBlock()->bytecodeOffset(STUB_RETURN_ADDRESS), false);
+
     if (globalData->terminator.shouldTerminate()) {
         globalData->exception = createTerminatedExecutionException(globalData);
         VM_THROW_EXCEPTION_AT_END();
-    } else if (timeoutChecker.didTimeOut(stackFrame.callFrame)) {
+    } else if (timeoutChecker.didTimeOut(stackFrame.callFrame, site)) {
         globalData->exception = createInterruptedExecutionException(globalData);
         VM_THROW_EXCEPTION_AT_END();
     }
@@ -1372,7 +1438,9 @@ DEFINE_STUB_FUNCTION(JSObject*, op_new_object)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
 
-    return constructEmptyObject(stackFrame.callFrame);
+    CallFrame* callFrame = stackFrame.callFrame;
+    AllocationSiteScope allocationSite(stackFrame.globalData->heap, callFrame->codeBlock(), stackFrame.args[0].allocationSiteProfile(), AllocationSiteScope::CountdownWasDecremented);
+    return allocationSite.didAllocate(constructEmptyObject(callFrame));
 }
 
 DEFINE_STUB_FUNCTION(void, op_put_by_id_generic)
@@ -1422,7 +1490,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id)
     if (!stubInfo->seenOnce())
         stubInfo->setSeen();
     else
-        JITThunks::tryCachePutByID(callFrame, codeBlock, STUB_RETURN_ADDRESS, stackFrame.args[0].jsValue(), slot, stubInfo, false);
+        JITThunks::tryCachePutByID(callFrame, codeBlock, STUB_RETURN_ADDRESS, stackFrame.args[0].jsValue(), ident, slot, stubInfo, false);
     
     CHECK_FOR_EXCEPTION_AT_END();
 }
@@ -1441,7 +1509,7 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_direct)
     if (!stubInfo->seenOnce())
         stubInfo->setSeen();
     else
-        JITThunks::tryCachePutByID(callFrame, codeBlock, STUB_RETURN_ADDRESS, stackFrame.args[0].jsValue(), slot, stubInfo, true);
+        JITThunks::tryCachePutByID(callFrame, codeBlock, STUB_RETURN_ADDRESS, stackFrame.args[0].jsValue(), ident, slot, stubInfo, true);
     
     CHECK_FOR_EXCEPTION_AT_END();
 }
@@ -1459,6 +1527,39 @@ DEFINE_STUB_FUNCTION(void, op_put_by_id_fail)
     CHECK_FOR_EXCEPTION_AT_END();
 }
 
+DEFINE_STUB_FUNCTION(void, op_put_by_id_setter)
+{
+    STUB_INIT_STACK_FRAME(stackFrame);
+
+    CallFrame* callFrame = stackFrame.callFrame;
+    StructureStubInfo* stubInfo = &callFrame->codeBlock()->getStubInfo(STUB_RETURN_ADDRESS);
+    ASSERT(stubInfo->accessType == access_put_by_id_setter);
+
+    // The stub routine has checked the Structures of the base and of every prototype up to the one holding the accessor.
+    JSObject* baseObject = asObject(stackFrame.args[0].jsValue());
+    JSObject* holder = baseObject;
+    for (unsigned i = 0; i < stubInfo->u.putByIdSetter.count; ++i)
+        holder = asObject(holder->prototype());
+
+    JSValue value = stackFrame.args[2].jsValue();
+    JSValue accessor = holder->getDirectOffset(stubInfo->u.putByIdSetter.cachedOffset);
+    JSObject* setter = accessor.isGetterSetter() ? asGetterSetter(accessor)->setter() : 0;
+    if (!setter) {
+        // The accessor lost its setter in place; let put() take the slow path and report the error.
+        PutPropertySlot slot(callFrame->codeBlock()->isStrictMode());
+        baseObject->put(callFrame, stackFrame.args[1].identifier(), value, slot);
+        CHECK_FOR_EXCEPTION_AT_END();
+        return;
+    }
+
+    CallData callData;
+    CallType callType = setter->getCallData(callData);
+    MarkedArgumentBuffer argList;
+    argList.append(value);
+    call(callFrame, setter, callType, callData, baseObject->toThisObject(callFrame), argList);
+    CHECK_FOR_EXCEPTION_AT_END();
+}
+
 DEFINE_STUB_FUNCTION(void, op_put_by_id_direct_fail)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1594,6 +1695,8 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
 
     CHECK_FOR_EXCEPTION();
 
+    // Growing the list links a stub and then repatches the site.
+    ExecutableMemoryBatchScope batch;
     if (baseValue.isCell()
         && slot.isCacheable()
         && !baseValue.asCell()->structure()->isUncacheableDictionary()
@@ -1617,13 +1720,16 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_self_fail)
         }
         if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
             stubInfo->u.getByIdSelfList.listSize++;
+            stubInfo->didGrowList();
             JIT::compileGetByIdSelfList(callFrame->scopeChain()->globalData, codeBlock, stubInfo, polymorphicStructureList, listIndex, baseValue.asCell()->structure(), ident, slot, slot.cachedOffset());
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+                ctiPatchCallToGeneric(codeBlock, stubInfo, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
         }
-    } else
-        ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+    } else {
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        ctiPatchCallToGeneric(codeBlock, &codeBlock->getStubInfo(STUB_RETURN_ADDRESS), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_generic));
+    }
     return JSValue::encode(result);
 }
 
@@ -1646,8 +1752,10 @@ static PolymorphicAccessStructureList* getPolymorphicAccessStructureListSlot(JSG
     case access_get_by_id_proto_list:
         prototypeStructureList = stubInfo->u.getByIdProtoList.structureList;
         listIndex = stubInfo->u.getByIdProtoList.listSize;
-        if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE)
+        if (listIndex < POLYMORPHIC_LIST_CACHE_SIZE) {
             stubInfo->u.getByIdProtoList.listSize++;
+            stubInfo->didGrowList();
+        }
         break;
     default:
         ASSERT_NOT_REACHED();
@@ -1701,8 +1809,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
 
     CHECK_FOR_EXCEPTION();
 
+    ExecutableMemoryBatchScope batch;
     if (!baseValue.isCell() || !slot.isCacheable() || baseValue.asCell()->structure()->isDictionary() || baseValue.asCell()->structure()->typeInfo().prohibitsPropertyCaching()) {
-        ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        ctiPatchCallToGeneric(codeBlock, &codeBlock->getStubInfo(STUB_RETURN_ADDRESS), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
         return JSValue::encode(result);
     }
 
@@ -1716,7 +1826,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
     size_t offset = slot.cachedOffset();
 
     if (slot.slotBase() == baseValue)
-        ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
     else if (slot.slotBase() == baseValue.asCell()->structure()->prototypeForLookup(callFrame)) {
         ASSERT(!baseValue.asCell()->structure()->isDictionary());
         // Since we're accessing a prototype in a loop, it's a good bet that it
@@ -1732,7 +1842,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             JIT::compileGetByIdProtoList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, slotBaseObject->structure(), propertyName, slot, offset);
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+                ctiPatchCallToGeneric(codeBlock, stubInfo, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
         }
     } else if (size_t count = normalizePrototypeChain(callFrame, baseValue, slot.slotBase(), propertyName, offset)) {
         ASSERT(!baseValue.asCell()->structure()->isDictionary());
@@ -1744,10 +1854,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_id_proto_list)
             JIT::compileGetByIdChainList(callFrame->scopeChain()->globalData, callFrame, codeBlock, stubInfo, prototypeStructureList, listIndex, structure, protoChain, count, propertyName, slot, offset);
 
             if (listIndex == (POLYMORPHIC_LIST_CACHE_SIZE - 1))
-                ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
+                ctiPatchCallToGeneric(codeBlock, stubInfo, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_list_full));
         }
     } else
-        ctiPatchCallByReturnAddress(codeBlock, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
+        ctiPatchCallToGeneric(codeBlock, stubInfo, STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_id_proto_fail));
 
     return JSValue::encode(result);
 }
@@ -1817,6 +1927,18 @@ DEFINE_STUB_FUNCTION(void, op_check_has_instance)
     VM_THROW_EXCEPTION_AT_END();
 }
 
+// Gives the embedder a chance to put off an optimizing compile, e.g. until it has time to spare
+// in the current frame. A deferred CodeBlock runs baseline code through another warm-up.
+static bool embedderAllowsOptimization(CodeBlock* codeBlock)
+{
+    JSOptimizeCallback callback = JSGetOptimizeCallback();
+    if (!callback || callback(codeBlock->instructions().size()))
+        return true;
+    
+    codeBlock->optimizeAfterWarmUp();
+    return false;
+}
+
 DEFINE_STUB_FUNCTION(void, optimize_from_loop)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -1825,6 +1947,13 @@ DEFINE_STUB_FUNCTION(void, optimize_from_loop)
     CodeBlock* codeBlock = callFrame->codeBlock();
     unsigned bytecodeIndex = stackFrame.args[0].int32();
 
+    if (codeBlock->hasOptimizedReplacement() && codeBlock->replacement()->shouldReoptimizeNow()) {
+        // The optimized code keeps exiting back to us. Throw it away, and let the
+        // value profiles catch up before optimizing again.
+        codeBlock->reoptimize();
+        return;
+    }
+    
     if (!codeBlock->hasOptimizedReplacement()) {
         if (!codeBlock->shouldOptimizeNow()) {
 #if ENABLE(JIT_VERBOSE_OSR)
@@ -1833,6 +1962,9 @@ DEFINE_STUB_FUNCTION(void, optimize_from_loop)
             return;
         }
         
+        if (!embedderAllowsOptimization(codeBlock))
+            return;
+        
         ScopeChainNode* scopeChain = callFrame->scopeChain();
         
         JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
@@ -1847,6 +1979,8 @@ DEFINE_STUB_FUNCTION(void, optimize_from_loop)
 #if ENABLE(JIT_VERBOSE_OSR)
             printf("Optimizing %p from loop failed.\n", codeBlock);
 #endif
+            if (JITDiagnostics::isEnabled())
+                JITDiagnostics::log(codeBlock, "optimizing from the loop at bc#%u failed", bytecodeIndex);
             
             ASSERT(codeBlock->getJITType() == JITCode::BaselineJIT);
             codeBlock->dontOptimizeAnytimeSoon();
@@ -1883,8 +2017,11 @@ DEFINE_STUB_FUNCTION(void, optimize_from_ret)
     CallFrame* callFrame = stackFrame.callFrame;
     CodeBlock* codeBlock = callFrame->codeBlock();
     
-    if (codeBlock->hasOptimizedReplacement())
+    if (codeBlock->hasOptimizedReplacement()) {
+        if (codeBlock->replacement()->shouldReoptimizeNow())
+            codeBlock->reoptimize();
         return;
+    }
     
     if (!codeBlock->shouldOptimizeNow()) {
 #if ENABLE(JIT_VERBOSE_OSR)
@@ -1893,6 +2030,9 @@ DEFINE_STUB_FUNCTION(void, optimize_from_ret)
         return;
     }
     
+    if (!embedderAllowsOptimization(codeBlock))
+        return;
+    
     ScopeChainNode* scopeChain = callFrame->scopeChain();
 
     JSObject* error = codeBlock->compileOptimized(callFrame, scopeChain);
@@ -1903,6 +2043,8 @@ DEFINE_STUB_FUNCTION(void, optimize_from_ret)
 #if ENABLE(JIT_VERBOSE_OSR)
         printf("Optimizing %p from return failed.\n", codeBlock);
 #endif
+        if (JITDiagnostics::isEnabled())
+            JITDiagnostics::log(codeBlock, "optimizing from return failed");
 
         ASSERT(codeBlock->getJITType() == JITCode::BaselineJIT);
         codeBlock->dontOptimizeAnytimeSoon();
@@ -1998,7 +2140,8 @@ DEFINE_STUB_FUNCTION(JSObject*, op_new_func)
     STUB_INIT_STACK_FRAME(stackFrame);
     
     ASSERT(stackFrame.callFrame->codeBlock()->codeType() != FunctionCode || !stackFrame.callFrame->codeBlock()->needsFullScopeChain() || stackFrame.callFrame->uncheckedR(stackFrame.callFrame->codeBlock()->activationRegister()).jsValue());
-    return stackFrame.args[0].function()->make(stackFrame.callFrame, stackFrame.callFrame->scopeChain());
+    AllocationSiteScope allocationSite(stackFrame.globalData->heap, stackFrame.callFrame->codeBlock(), stackFrame.args[1].allocationSiteProfile(), AllocationSiteScope::CountdownWasDecremented);
+    return allocationSite.didAllocate(stackFrame.args[0].function()->make(stackFrame.callFrame, stackFrame.callFrame->scopeChain()));
 }
 
 inline void* jitCompileFor(JITStackFrame& stackFrame, CodeSpecializationKind kind)
@@ -2267,7 +2410,8 @@ DEFINE_STUB_FUNCTION(JSObject*, op_new_array)
     STUB_INIT_STACK_FRAME(stackFrame);
 
     ArgList argList(&stackFrame.callFrame->registers()[stackFrame.args[0].int32()], stackFrame.args[1].int32());
-    return constructArray(stackFrame.callFrame, argList);
+    AllocationSiteScope allocationSite(stackFrame.globalData->heap, stackFrame.callFrame->codeBlock(), stackFrame.args[2].allocationSiteProfile(), AllocationSiteScope::DecrementCountdown);
+    return allocationSite.didAllocate(constructArray(stackFrame.callFrame, argList));
 }
 
 DEFINE_STUB_FUNCTION(JSObject*, op_new_array_buffer)
@@ -2275,7 +2419,8 @@ DEFINE_STUB_FUNCTION(JSObject*, op_new_array_buffer)
     STUB_INIT_STACK_FRAME(stackFrame);
     
     ArgList argList(stackFrame.callFrame->codeBlock()->constantBuffer(stackFrame.args[0].int32()), stackFrame.args[1].int32());
-    return constructArray(stackFrame.callFrame, argList);
+    AllocationSiteScope allocationSite(stackFrame.globalData->heap, stackFrame.callFrame->codeBlock(), stackFrame.args[2].allocationSiteProfile(), AllocationSiteScope::DecrementCountdown);
+    return allocationSite.didAllocate(constructArray(stackFrame.callFrame, argList));
 }
 
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_resolve)
@@ -2343,6 +2488,29 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_construct_NotJSConstruct)
     VM_THROW_EXCEPTION();
 }
 
+// Points a get_by_val or put_by_val site's string key cache at an own property of base, which the
+// baseline JIT can then read or overwrite without a lookup while the key and Structure recur.
+static void tryCacheByValString(CallFrame* callFrame, ByValStringCacheInfo* cacheInfo, JSCell* base, JSString* key, size_t offset)
+{
+    if (!cacheInfo || cacheInfo->isGeneric())
+        return;
+
+    // An uncacheable dictionary can lose the property without changing Structure.
+    Structure* structure = base->structure();
+    if (structure->isUncacheableDictionary() || structure->typeInfo().prohibitsPropertyCaching())
+        return;
+
+    StringImpl* keyImpl = key->value(callFrame).impl();
+    if (cacheInfo->structure.get() == structure && cacheInfo->key == keyImpl)
+        return;
+
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    cacheInfo->structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), structure);
+    cacheInfo->key = keyImpl;
+    cacheInfo->offset = offset;
+    ++cacheInfo->repatchCount;
+}
+
 DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_val)
 {
     STUB_INIT_STACK_FRAME(stackFrame);
@@ -2354,9 +2522,14 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_val)
     JSValue subscript = stackFrame.args[1].jsValue();
 
     if (LIKELY(baseValue.isCell() && subscript.isString())) {
-        if (JSValue result = baseValue.asCell()->fastGetOwnProperty(callFrame, asString(subscript)->value(callFrame))) {
-            CHECK_FOR_EXCEPTION();
-            return JSValue::encode(result);
+        JSCell* baseCell = baseValue.asCell();
+        size_t offset = baseCell->fastGetOwnPropertyOffset(callFrame, asString(subscript)->value(callFrame));
+        if (offset != WTF::notFound) {
+            if (JSValue result = asObject(baseCell)->getDirectOffset(offset)) {
+                CHECK_FOR_EXCEPTION();
+                tryCacheByValString(callFrame, stackFrame.args[2].byValStringCacheInfo(), baseCell, asString(subscript), offset);
+                return JSValue::encode(result);
+            }
         }
     }
 
@@ -2373,6 +2546,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_get_by_val)
             ctiPatchCallByReturnAddress(callFrame->codeBlock(), STUB_RETURN_ADDRESS, FunctionPtr(cti_op_get_by_val_byte_array));
             return JSValue::encode(asByteArray(baseValue)->getIndex(callFrame, i));
         }
+        if (isJSTypedArray(globalData, baseValue) && asTypedArray(baseValue)->canAccessIndex(i)) {
+            // Typed array element loads cannot throw either.
+            return JSValue::encode(asTypedArray(baseValue)->getIndex(i));
+        }
         JSValue result = baseValue.get(callFrame, i);
         CHECK_FOR_EXCEPTION();
         return JSValue::encode(result);
@@ -2497,6 +2674,20 @@ DEFINE_STUB_FUNCTION(void, op_put_by_val)
                 }
             }
 
+            baseValue.put(callFrame, i, value);
+        } else if (isJSTypedArray(globalData, baseValue) && asTypedArray(baseValue)->canAccessIndex(i)) {
+            JSTypedArray* jsTypedArray = asTypedArray(baseValue);
+            // Numeric typed array element stores cannot throw, so return immediately.
+            if (value.isInt32()) {
+                jsTypedArray->setIndex(i, value.asInt32());
+                return;
+            }
+            double dValue = 0;
+            if (value.getNumber(dValue)) {
+                jsTypedArray->setIndex(i, dValue);
+                return;
+            }
+
             baseValue.put(callFrame, i, value);
         } else
             baseValue.put(callFrame, i, value);
@@ -2505,6 +2696,8 @@ DEFINE_STUB_FUNCTION(void, op_put_by_val)
         if (!stackFrame.globalData->exception) { // Don't put to an object if toString threw an exception.
             PutPropertySlot slot(callFrame->codeBlock()->isStrictMode());
             baseValue.put(callFrame, property, value, slot);
+            if (subscript.isString() && baseValue.isCell() && slot.type() == PutPropertySlot::ExistingProperty && slot.base() == baseValue.asCell())
+                tryCacheByValString(callFrame, stackFrame.args[3].byValStringCacheInfo(), baseValue.asCell(), asString(subscript), slot.cachedOffset());
         }
     }
 
@@ -2797,6 +2990,7 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_resolve_global)
             GlobalResolveInfo& globalResolveInfo = codeBlock->globalResolveInfo(globalResolveInfoIndex);
             globalResolveInfo.structure.set(callFrame->globalData(), codeBlock->ownerExecutable(), globalObject->structure());
             globalResolveInfo.offset = slot.cachedOffset();
+            ++globalResolveInfo.repatchCount;
             return JSValue::encode(result);
         }
 
@@ -3483,7 +3677,10 @@ DEFINE_STUB_FUNCTION(EncodedJSValue, op_in)
 
     Identifier property(callFrame, propName.toString(callFrame));
     CHECK_FOR_EXCEPTION();
-    return JSValue::encode(jsBoolean(baseObj->hasProperty(callFrame, property)));
+    bool result = baseObj->hasProperty(callFrame, property);
+    if (result)
+        Interpreter::tryCacheIn(callFrame, static_cast<Instruction*>(stackFrame.args[2].asPointer), baseObj, property);
+    return JSValue::encode(jsBoolean(result));
 }
 
 DEFINE_STUB_FUNCTION(JSObject*, op_push_new_scope)
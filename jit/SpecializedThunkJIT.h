@@ -139,7 +139,7 @@ namespace JSC {
             patchBuffer.link(m_failures, CodeLocationLabel(fallback));
             for (unsigned i = 0; i < m_calls.size(); i++)
                 patchBuffer.link(m_calls[i].first, m_calls[i].second);
-            return patchBuffer.finalizeCode();
+            return patchBuffer.finalizeCode("JIT thunk");
         }
 
         // Assumes that the target function uses fpRegister0 as the first argument
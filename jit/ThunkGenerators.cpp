@@ -90,6 +90,38 @@ MacroAssemblerCodeRef fromCharCodeThunkGenerator(JSGlobalData* globalData)
     return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
 }
 
+MacroAssemblerCodeRef stringIndexOfThunkGenerator(JSGlobalData* globalData)
+{
+    // Only indexOf(needle) with a one character needle is handled here. The
+    // two argument form fails the argument count check.
+    SpecializedThunkJIT jit(1, globalData);
+    jit.loadJSStringArgument(0, SpecializedThunkJIT::regT1);
+    jit.appendFailure(jit.branch32(MacroAssembler::NotEqual, MacroAssembler::Address(SpecializedThunkJIT::regT1, ThunkHelpers::jsStringLengthOffset()), MacroAssembler::TrustedImm32(1)));
+    jit.loadPtr(MacroAssembler::Address(SpecializedThunkJIT::regT1, ThunkHelpers::jsStringValueOffset()), SpecializedThunkJIT::regT1);
+    jit.loadPtr(MacroAssembler::Address(SpecializedThunkJIT::regT1, ThunkHelpers::stringImplDataOffset()), SpecializedThunkJIT::regT1);
+    jit.load16(MacroAssembler::Address(SpecializedThunkJIT::regT1), SpecializedThunkJIT::regT1);
+    // regT1 now contains the character to look for
+
+    jit.loadJSStringArgument(SpecializedThunkJIT::ThisArgument, SpecializedThunkJIT::regT0);
+    jit.load32(MacroAssembler::Address(SpecializedThunkJIT::regT0, ThunkHelpers::jsStringLengthOffset()), SpecializedThunkJIT::regT2);
+    jit.loadPtr(MacroAssembler::Address(SpecializedThunkJIT::regT0, ThunkHelpers::jsStringValueOffset()), SpecializedThunkJIT::regT0);
+    jit.loadPtr(MacroAssembler::Address(SpecializedThunkJIT::regT0, ThunkHelpers::stringImplDataOffset()), SpecializedThunkJIT::regT0);
+
+    jit.move(MacroAssembler::TrustedImm32(0), SpecializedThunkJIT::regT3);
+    MacroAssembler::Label loop(jit.label());
+    MacroAssembler::Jump notFound = jit.branch32(MacroAssembler::Equal, SpecializedThunkJIT::regT3, SpecializedThunkJIT::regT2);
+    MacroAssembler::Jump found = jit.branch16(MacroAssembler::Equal, MacroAssembler::BaseIndex(SpecializedThunkJIT::regT0, SpecializedThunkJIT::regT3, MacroAssembler::TimesTwo, 0), SpecializedThunkJIT::regT1);
+    jit.add32(MacroAssembler::TrustedImm32(1), SpecializedThunkJIT::regT3);
+    jit.jump().linkTo(loop, &jit);
+
+    found.link(&jit);
+    jit.returnInt32(SpecializedThunkJIT::regT3);
+    notFound.link(&jit);
+    jit.move(MacroAssembler::TrustedImm32(-1), SpecializedThunkJIT::regT0);
+    jit.returnInt32(SpecializedThunkJIT::regT0);
+    return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
+}
+
 MacroAssemblerCodeRef sqrtThunkGenerator(JSGlobalData* globalData)
 {
     SpecializedThunkJIT jit(1, globalData);
@@ -177,6 +209,11 @@ defineUnaryDoubleOpWrapper(exp);
 defineUnaryDoubleOpWrapper(log);
 defineUnaryDoubleOpWrapper(floor);
 defineUnaryDoubleOpWrapper(ceil);
+defineUnaryDoubleOpWrapper(cos);
+#if !PLATFORM(EA)
+// EA builds compute Math.sin with fmodSin, which the thunk must not bypass.
+defineUnaryDoubleOpWrapper(sin);
+#endif
 
 MacroAssemblerCodeRef floorThunkGenerator(JSGlobalData* globalData)
 {
@@ -219,6 +256,8 @@ MacroAssemblerCodeRef ceilThunkGenerator(JSGlobalData* globalData)
 static const double negativeZeroConstant = -0.0;
 static const double oneConstant = 1.0;
 static const double negativeHalfConstant = -0.5;
+static const double twoToThe32Constant = 4294967296.0;
+static const double twoToTheMinus32Constant = 1.0 / 4294967296.0;
     
 MacroAssemblerCodeRef roundThunkGenerator(JSGlobalData* globalData)
 {
@@ -265,6 +304,81 @@ MacroAssemblerCodeRef logThunkGenerator(JSGlobalData* globalData)
     return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
 }
 
+MacroAssemblerCodeRef sinThunkGenerator(JSGlobalData* globalData)
+{
+#if PLATFORM(EA)
+    return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+#else
+    if (!UnaryDoubleOpWrapper(sin))
+        return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+    SpecializedThunkJIT jit(1, globalData);
+    if (!jit.supportsFloatingPoint())
+        return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+    jit.loadDoubleArgument(0, SpecializedThunkJIT::fpRegT0, SpecializedThunkJIT::regT0);
+    jit.callDoubleToDouble(UnaryDoubleOpWrapper(sin));
+    jit.returnDouble(SpecializedThunkJIT::fpRegT0);
+    return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
+#endif
+}
+
+MacroAssemblerCodeRef cosThunkGenerator(JSGlobalData* globalData)
+{
+    if (!UnaryDoubleOpWrapper(cos))
+        return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+    SpecializedThunkJIT jit(1, globalData);
+    if (!jit.supportsFloatingPoint())
+        return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+    jit.loadDoubleArgument(0, SpecializedThunkJIT::fpRegT0, SpecializedThunkJIT::regT0);
+    jit.callDoubleToDouble(UnaryDoubleOpWrapper(cos));
+    jit.returnDouble(SpecializedThunkJIT::fpRegT0);
+    return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
+}
+
+enum MinOrMax { Min, Max };
+
+static MacroAssemblerCodeRef minMaxThunk(JSGlobalData* globalData, MinOrMax kind)
+{
+    // Only the two argument form is handled here; other argument counts
+    // fail the argument count check.
+    SpecializedThunkJIT jit(2, globalData);
+    MacroAssembler::Jump nonIntArgument0;
+    MacroAssembler::Jump nonIntArgument1;
+    jit.loadInt32Argument(0, SpecializedThunkJIT::regT0, nonIntArgument0);
+    jit.loadInt32Argument(1, SpecializedThunkJIT::regT1, nonIntArgument1);
+    MacroAssembler::Jump useArgument1 = jit.branch32(kind == Min ? MacroAssembler::GreaterThan : MacroAssembler::LessThan, SpecializedThunkJIT::regT0, SpecializedThunkJIT::regT1);
+    jit.returnInt32(SpecializedThunkJIT::regT0);
+    useArgument1.link(&jit);
+    jit.returnInt32(SpecializedThunkJIT::regT1);
+
+    if (jit.supportsFloatingPoint()) {
+        nonIntArgument0.link(&jit);
+        nonIntArgument1.link(&jit);
+        jit.loadDoubleArgument(0, SpecializedThunkJIT::fpRegT0, SpecializedThunkJIT::regT0);
+        jit.loadDoubleArgument(1, SpecializedThunkJIT::fpRegT1, SpecializedThunkJIT::regT0);
+        // Equal arguments may be zeros of different signs, and unordered ones
+        // are NaNs. The native function gets both right.
+        jit.appendFailure(jit.branchDouble(MacroAssembler::DoubleEqualOrUnordered, SpecializedThunkJIT::fpRegT0, SpecializedThunkJIT::fpRegT1));
+        MacroAssembler::Jump useDoubleArgument1 = jit.branchDouble(kind == Min ? MacroAssembler::DoubleGreaterThan : MacroAssembler::DoubleLessThan, SpecializedThunkJIT::fpRegT0, SpecializedThunkJIT::fpRegT1);
+        jit.returnDouble(SpecializedThunkJIT::fpRegT0);
+        useDoubleArgument1.link(&jit);
+        jit.returnDouble(SpecializedThunkJIT::fpRegT1);
+    } else {
+        jit.appendFailure(nonIntArgument0);
+        jit.appendFailure(nonIntArgument1);
+    }
+    return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
+}
+
+MacroAssemblerCodeRef minThunkGenerator(JSGlobalData* globalData)
+{
+    return minMaxThunk(globalData, Min);
+}
+
+MacroAssemblerCodeRef maxThunkGenerator(JSGlobalData* globalData)
+{
+    return minMaxThunk(globalData, Max);
+}
+
 MacroAssemblerCodeRef absThunkGenerator(JSGlobalData* globalData)
 {
     SpecializedThunkJIT jit(1, globalData);
@@ -338,6 +452,42 @@ MacroAssemblerCodeRef powThunkGenerator(JSGlobalData* globalData)
     return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
 }
 
+MacroAssemblerCodeRef randomThunkGenerator(JSGlobalData* globalData)
+{
+    SpecializedThunkJIT jit(0, globalData);
+    if (!jit.supportsFloatingPoint())
+        return MacroAssemblerCodeRef::createSelfManagedCodeRef(globalData->jitStubs->ctiNativeCall());
+
+    // The generator belongs to the lexical global object, which is the one
+    // hanging off the callee's scope chain in the frame header.
+    jit.loadPtr(jit.payloadFor(RegisterFile::ScopeChain), SpecializedThunkJIT::regT2);
+    jit.loadPtr(MacroAssembler::Address(SpecializedThunkJIT::regT2, OBJECT_OFFSETOF(ScopeChainNode, globalObject)), SpecializedThunkJIT::regT2);
+    jit.addPtr(MacroAssembler::TrustedImm32(JSGlobalObject::offsetOfWeakRandom()), SpecializedThunkJIT::regT2);
+
+    // Same step as WeakRandom::advance(), so JIT and native calls share one sequence.
+    jit.load32(MacroAssembler::Address(SpecializedThunkJIT::regT2, WeakRandom::offsetOfHigh()), SpecializedThunkJIT::regT0);
+    jit.load32(MacroAssembler::Address(SpecializedThunkJIT::regT2, WeakRandom::offsetOfLow()), SpecializedThunkJIT::regT1);
+    jit.move(SpecializedThunkJIT::regT0, SpecializedThunkJIT::regT3);
+    jit.lshift32(MacroAssembler::TrustedImm32(16), SpecializedThunkJIT::regT0);
+    jit.urshift32(MacroAssembler::TrustedImm32(16), SpecializedThunkJIT::regT3);
+    jit.add32(SpecializedThunkJIT::regT3, SpecializedThunkJIT::regT0);
+    jit.add32(SpecializedThunkJIT::regT1, SpecializedThunkJIT::regT0);
+    jit.add32(SpecializedThunkJIT::regT0, SpecializedThunkJIT::regT1);
+    jit.store32(SpecializedThunkJIT::regT0, MacroAssembler::Address(SpecializedThunkJIT::regT2, WeakRandom::offsetOfHigh()));
+    jit.store32(SpecializedThunkJIT::regT1, MacroAssembler::Address(SpecializedThunkJIT::regT2, WeakRandom::offsetOfLow()));
+
+    // Scale the unsigned result into [0, 1); every step is exact in double precision.
+    jit.convertInt32ToDouble(SpecializedThunkJIT::regT0, SpecializedThunkJIT::fpRegT0);
+    MacroAssembler::Jump isPositive = jit.branch32(MacroAssembler::GreaterThanOrEqual, SpecializedThunkJIT::regT0, MacroAssembler::TrustedImm32(0));
+    jit.loadDouble(&twoToThe32Constant, SpecializedThunkJIT::fpRegT1);
+    jit.addDouble(SpecializedThunkJIT::fpRegT1, SpecializedThunkJIT::fpRegT0);
+    isPositive.link(&jit);
+    jit.loadDouble(&twoToTheMinus32Constant, SpecializedThunkJIT::fpRegT1);
+    jit.mulDouble(SpecializedThunkJIT::fpRegT1, SpecializedThunkJIT::fpRegT0);
+    jit.returnDouble(SpecializedThunkJIT::fpRegT0);
+    return jit.finalize(*globalData, globalData->jitStubs->ctiNativeCall());
+}
+
 }
 
 #endif // ENABLE(JIT)
@@ -37,14 +37,20 @@ namespace JSC {
     MacroAssemblerCodeRef charCodeAtThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef charAtThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef fromCharCodeThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef stringIndexOfThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef absThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef ceilThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef cosThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef expThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef floorThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef logThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef maxThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef minThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef roundThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef sinThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef sqrtThunkGenerator(JSGlobalData*);
     MacroAssemblerCodeRef powThunkGenerator(JSGlobalData*);
+    MacroAssemblerCodeRef randomThunkGenerator(JSGlobalData*);
 }
 #endif
 
@@ -23,15 +23,20 @@
 #include "config.h"
 
 #include "BytecodeGenerator.h"
+#include "CodeBlock.h"
 #include "Completion.h"
 #include "CurrentTime.h"
 #include "ExceptionHelpers.h"
+#include "HeapSnapshot.h"
 #include "InitializeThreading.h"
+#include "JITDiagnostics.h"
 #include "JSArray.h"
 #include "JSFunction.h"
 #include "JSLock.h"
+#include "JSSettingsEA.h"
 #include "JSString.h"
 #include "SamplingTool.h"
+#include <algorithm>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -74,6 +79,7 @@ static bool fillBufferWithContentsOfFile(const UString& fileName, Vector<char>&
 static EncodedJSValue JSC_HOST_CALL functionPrint(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionDebug(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionGC(ExecState*);
+static EncodedJSValue JSC_HOST_CALL functionHeapSnapshot(ExecState*);
 #ifndef NDEBUG
 static EncodedJSValue JSC_HOST_CALL functionReleaseExecutableMemory(ExecState*);
 #endif
@@ -83,6 +89,9 @@ static EncodedJSValue JSC_HOST_CALL functionLoad(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionCheckSyntax(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionReadline(ExecState*);
 static EncodedJSValue JSC_HOST_CALL functionPreciseTime(ExecState*);
+#if ENABLE(JIT)
+static EncodedJSValue JSC_HOST_CALL functionInlineCacheStatistics(ExecState*);
+#endif
 static NO_RETURN_WITH_VALUE EncodedJSValue JSC_HOST_CALL functionQuit(ExecState*);
 
 #if ENABLE(SAMPLING_FLAGS)
@@ -105,11 +114,15 @@ struct Options {
     Options()
         : interactive(false)
         , dump(false)
+        , benchmarkIterations(0)
+        , warmUpIterations(3)
     {
     }
 
     bool interactive;
     bool dump;
+    unsigned benchmarkIterations; // 0 unless running each script as a benchmark.
+    unsigned warmUpIterations;
     Vector<Script> scripts;
     Vector<UString> arguments;
 };
@@ -166,6 +179,7 @@ protected:
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "print"), functionPrint));
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "quit"), functionQuit));
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "gc"), functionGC));
+        putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "heapSnapshot"), functionHeapSnapshot));
 #ifndef NDEBUG
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "releaseExecutableMemory"), functionReleaseExecutableMemory));
 #endif
@@ -175,6 +189,9 @@ protected:
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "checkSyntax"), functionCheckSyntax));
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "readline"), functionReadline));
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "preciseTime"), functionPreciseTime));
+#if ENABLE(JIT)
+        putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 0, Identifier(globalExec(), "inlineCacheStatistics"), functionInlineCacheStatistics));
+#endif
 
 #if ENABLE(SAMPLING_FLAGS)
         putDirectFunction(globalExec(), JSFunction::create(globalExec(), this, functionStructure(), 1, Identifier(globalExec(), "setSamplingFlags"), functionSetSamplingFlags));
@@ -222,6 +239,28 @@ EncodedJSValue JSC_HOST_CALL functionGC(ExecState* exec)
     return JSValue::encode(jsUndefined());
 }
 
+EncodedJSValue JSC_HOST_CALL functionHeapSnapshot(ExecState* exec)
+{
+    UString fileName = exec->argument(0).toString(exec);
+
+    Vector<char> json;
+    {
+        JSLock lock(SilenceAssertionsOnly);
+        HeapSnapshot snapshot;
+        exec->heap()->takeHeapSnapshot(snapshot);
+        snapshot.writeJSON(json);
+    }
+
+    FILE* file = fopen(fileName.utf8().data(), "wb");
+    if (!file)
+        return JSValue::encode(throwError(exec, createError(exec, "Could not open file.")));
+    size_t bytesWritten = fwrite(json.data(), 1, json.size(), file);
+    fclose(file);
+    if (bytesWritten != json.size())
+        return JSValue::encode(throwError(exec, createError(exec, "Could not write file.")));
+    return JSValue::encode(jsUndefined());
+}
+
 #ifndef NDEBUG
 EncodedJSValue JSC_HOST_CALL functionReleaseExecutableMemory(ExecState* exec)
 {
@@ -333,6 +372,32 @@ EncodedJSValue JSC_HOST_CALL functionPreciseTime(ExecState*)
     return JSValue::encode(jsNumber(currentTime()));
 }
 
+#if ENABLE(JIT)
+EncodedJSValue JSC_HOST_CALL functionInlineCacheStatistics(ExecState* exec)
+{
+    static const char* const kindNames[] = { "property", "method", "call", "global" };
+
+    Vector<JSGlobalData::InlineCacheSite> sites;
+    exec->globalData().collectInlineCacheStatistics(sites);
+
+    unsigned genericSiteCount = 0;
+    for (size_t i = 0; i < sites.size(); ++i) {
+        FunctionExecutable* executable = sites[i].first;
+        const InlineCacheSiteStatistics& statistics = sites[i].second;
+        if (!statistics.repatchCount && !statistics.isGeneric)
+            continue;
+        if (statistics.isGeneric)
+            ++genericSiteCount;
+        int lineNumber = statistics.lineNumber >= 0 ? statistics.lineNumber : executable->lineNo();
+        printf("%s:%d %s %s: %u repatches, %u structures%s\n", executable->sourceURL().utf8().data(), lineNumber,
+            executable->name().ustring().utf8().data(), kindNames[statistics.kind], statistics.repatchCount, statistics.structureCount,
+            statistics.isGeneric ? ", generic" : "");
+    }
+    fflush(stdout);
+    return JSValue::encode(jsNumber(genericSiteCount));
+}
+#endif
+
 EncodedJSValue JSC_HOST_CALL functionQuit(ExecState* exec)
 {
     // Technically, destroying the heap in the middle of JS execution is a no-no,
@@ -393,6 +458,12 @@ int main(int argc, char** argv)
     // Initialize JSC before getting JSGlobalData.
     JSC::initializeThreading();
 
+    // The heap reads its watermark when it is created, so this can't wait for parseArguments().
+    for (int i = 1; i + 1 < argc && strcmp(argv[i], "--"); ++i) {
+        if (!strcmp(argv[i], "--heap-watermark"))
+            JSSetHeapWatermark(static_cast<size_t>(atoi(argv[i + 1])) * 1024);
+    }
+
     // We can't use destructors in the following code because it uses Windows
     // Structured Exception Handling
     int res = 0;
@@ -413,8 +484,82 @@ static void cleanupGlobalData(JSGlobalData* globalData)
     globalData->deref();
 }
 
-static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, bool dump)
+static void printJSONString(const char* string)
+{
+    putchar('"');
+    for (; *string; ++string) {
+        if (static_cast<unsigned char>(*string) < 0x20) {
+            printf("\\u%04x", *string);
+            continue;
+        }
+        if (*string == '"' || *string == '\\')
+            putchar('\\');
+        putchar(*string);
+    }
+    putchar('"');
+}
+
+// Evaluates the script warmUpIterations times untimed, then times benchmarkIterations more runs
+// and prints one line of JSON with the statistics, so that a harness can collect the results.
+static bool runBenchmark(GlobalObject* globalObject, const SourceCode& source, const char* name, const Options& options)
+{
+    ExecState* exec = globalObject->globalExec();
+    Heap& heap = globalObject->globalData().heap;
+
+    for (unsigned i = 0; i < options.warmUpIterations; ++i) {
+        JSValue evaluationException;
+        evaluate(exec, globalObject->globalScopeChain(), source, JSValue(), &evaluationException);
+        if (evaluationException) {
+            printf("Exception: %s\n", evaluationException.toString(exec).utf8().data());
+            return false;
+        }
+    }
+
+    size_t collectionCountBefore = heap.collectionCount();
+    double markTimeBefore = heap.phaseStatistics(MarkRootsPhase).totalTime;
+
+    Vector<double> times;
+    times.reserveCapacity(options.benchmarkIterations);
+    for (unsigned i = 0; i < options.benchmarkIterations; ++i) {
+        JSValue evaluationException;
+        double startTime = currentTime();
+        evaluate(exec, globalObject->globalScopeChain(), source, JSValue(), &evaluationException);
+        times.append((currentTime() - startTime) * 1000);
+        if (evaluationException) {
+            printf("Exception: %s\n", evaluationException.toString(exec).utf8().data());
+            return false;
+        }
+    }
+
+    double total = 0;
+    for (size_t i = 0; i < times.size(); ++i)
+        total += times[i];
+    double mean = total / times.size();
+    double squaredDeviations = 0;
+    for (size_t i = 0; i < times.size(); ++i)
+        squaredDeviations += (times[i] - mean) * (times[i] - mean);
+    double variance = times.size() > 1 ? squaredDeviations / (times.size() - 1) : 0;
+
+    std::sort(times.begin(), times.end());
+    size_t middle = times.size() / 2;
+    double median = times.size() % 2 ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+
+    printf("{\"benchmark\": ");
+    printJSONString(name);
+    printf(", \"iterations\": %u, \"medianMS\": %.3f, \"meanMS\": %.3f, \"varianceMS2\": %.3f, \"minMS\": %.3f, \"maxMS\": %.3f",
+        options.benchmarkIterations, median, mean, variance, times.first(), times.last());
+    printf(", \"collections\": %u, \"gcMarkMS\": %.3f, \"gcLongestMarkMS\": %.3f}\n",
+        static_cast<unsigned>(heap.collectionCount() - collectionCountBefore),
+        (heap.phaseStatistics(MarkRootsPhase).totalTime - markTimeBefore) * 1000,
+        heap.phaseStatistics(MarkRootsPhase).maxTime * 1000);
+    fflush(stdout);
+    return true;
+}
+
+static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scripts, const Options& options)
 {
+    bool dump = options.dump;
+
     UString script;
     UString fileName;
     Vector<char> scriptBuffer;
@@ -440,6 +585,12 @@ static bool runWithScripts(GlobalObject* globalObject, const Vector<Script>& scr
             fileName = "[Command Line]";
         }
 
+        if (options.benchmarkIterations) {
+            success = runBenchmark(globalObject, makeSource(script, fileName), scripts[i].argument, options) && success;
+            globalObject->globalExec()->clearException();
+            continue;
+        }
+
         globalData.startSampling();
 
         JSValue evaluationException;
@@ -514,10 +665,14 @@ static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help =
 {
     fprintf(stderr, "Usage: jsc [options] [files] [-- arguments]\n");
     fprintf(stderr, "  -d         Dumps bytecode (debug builds only)\n");
+    fprintf(stderr, "  --bench N  Runs each script N timed times after warming up, and prints the timings as JSON\n");
+    fprintf(stderr, "  --warmup N Sets the number of untimed runs before timing a benchmark (default 3)\n");
     fprintf(stderr, "  -e         Evaluate argument as script code\n");
     fprintf(stderr, "  -f         Specifies a source file (deprecated)\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
+    fprintf(stderr, "  --heap-watermark KB Sets the heap size that triggers a collection (JSSetHeapWatermark)\n");
     fprintf(stderr, "  -i         Enables interactive mode (default if no files are specified)\n");
+    fprintf(stderr, "  -o         Prints why code is or isn't optimized, and each OSR entry and exit\n");
 #if HAVE(SIGNAL_H)
     fprintf(stderr, "  -s         Installs signal handlers that exit on a crash (Unix platforms only)\n");
 #endif
@@ -526,6 +681,11 @@ static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help =
     exit(help ? EXIT_SUCCESS : EXIT_FAILURE);
 }
 
+static void printOptimizationDiagnostic(const char* message)
+{
+    fprintf(stderr, "%s\n", message);
+}
+
 static void parseArguments(int argc, char** argv, Options& options, JSGlobalData* globalData)
 {
     int i = 1;
@@ -551,6 +711,28 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             options.dump = true;
             continue;
         }
+        if (!strcmp(arg, "-o")) {
+            JITDiagnostics::setCallback(printOptimizationDiagnostic);
+            continue;
+        }
+        if (!strcmp(arg, "--bench") || !strcmp(arg, "--warmup")) {
+            if (++i == argc)
+                printUsageStatement(globalData);
+            int count = atoi(argv[i]);
+            if (count < 0 || (!count && !strcmp(arg, "--bench")))
+                printUsageStatement(globalData);
+            if (!strcmp(arg, "--bench"))
+                options.benchmarkIterations = count;
+            else
+                options.warmUpIterations = count;
+            continue;
+        }
+        if (!strcmp(arg, "--heap-watermark")) {
+            // Applied in main(), before the heap was created.
+            if (++i == argc || atoi(argv[i]) <= 0)
+                printUsageStatement(globalData);
+            continue;
+        }
         if (!strcmp(arg, "-s")) {
 #if HAVE(SIGNAL_H)
             signal(SIGILL, _exit);
@@ -584,7 +766,7 @@ int jscmain(int argc, char** argv, JSGlobalData* globalData)
     parseArguments(argc, argv, options, globalData);
 
     GlobalObject* globalObject = GlobalObject::create(*globalData, GlobalObject::createStructure(*globalData, jsNull()), options.arguments);
-    bool success = runWithScripts(globalObject, options.scripts, options.dump);
+    bool success = runWithScripts(globalObject, options.scripts, options);
     if (options.interactive && success)
         runInteractive(globalObject);
 
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "CompressedSourceProvider.h"
+
+#include <limits.h>
+#include <wtf/HashSet.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/Threading.h>
+
+namespace JSC {
+
+// Each chunk is a sequence of (literal run, match) pairs: a varint count of literal
+// characters followed by the characters themselves as varints, then a varint match
+// length, and if that is non-zero a varint distance back into the chunk. A match
+// length of zero ends the chunk. ASCII literals take one byte, and matches are found
+// with a single-probe hash of the next three characters.
+static const unsigned minimumMatchLength = 3;
+static const unsigned matchHashTableSize = 4096;
+
+static inline void appendVarint(Vector<uint8_t>& output, unsigned value)
+{
+    while (value >= 0x80) {
+        output.append(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    output.append(static_cast<uint8_t>(value));
+}
+
+static inline unsigned readVarint(const uint8_t*& input)
+{
+    unsigned value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do {
+        byte = *input++;
+        value |= static_cast<unsigned>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+static inline unsigned matchHash(const UChar* characters)
+{
+    return ((characters[0] * 33 + characters[1]) * 33 + characters[2]) & (matchHashTableSize - 1);
+}
+
+static void compressChunk(const UChar* characters, unsigned length, Vector<uint8_t>& output)
+{
+    unsigned table[matchHashTableSize];
+    for (unsigned i = 0; i < matchHashTableSize; ++i)
+        table[i] = UINT_MAX;
+
+    unsigned literalStart = 0;
+    unsigned position = 0;
+    while (position + minimumMatchLength <= length) {
+        unsigned hash = matchHash(characters + position);
+        unsigned candidate = table[hash];
+        table[hash] = position;
+
+        unsigned matchLength = 0;
+        if (candidate != UINT_MAX) {
+            while (position + matchLength < length && characters[candidate + matchLength] == characters[position + matchLength])
+                ++matchLength;
+        }
+        if (matchLength < minimumMatchLength) {
+            ++position;
+            continue;
+        }
+
+        appendVarint(output, position - literalStart);
+        for (unsigned i = literalStart; i < position; ++i)
+            appendVarint(output, characters[i]);
+        appendVarint(output, matchLength);
+        appendVarint(output, position - candidate);
+        position += matchLength;
+        literalStart = position;
+    }
+
+    appendVarint(output, length - literalStart);
+    for (unsigned i = literalStart; i < length; ++i)
+        appendVarint(output, characters[i]);
+    appendVarint(output, 0);
+}
+
+static void decompressChunk(const uint8_t* input, UChar* output)
+{
+    UChar* start = output;
+    UNUSED_PARAM(start);
+    while (true) {
+        unsigned literalCount = readVarint(input);
+        for (unsigned i = 0; i < literalCount; ++i)
+            *output++ = static_cast<UChar>(readVarint(input));
+        unsigned matchLength = readVarint(input);
+        if (!matchLength)
+            return;
+        unsigned distance = readVarint(input);
+        ASSERT(distance && distance <= static_cast<unsigned>(output - start));
+        // The match may overlap the characters it produces, so copy forwards one at a time.
+        const UChar* match = output - distance;
+        for (unsigned i = 0; i < matchLength; ++i)
+            *output++ = match[i];
+    }
+}
+
+static HashSet<CompressedSourceProvider*>& liveProviders()
+{
+    DEFINE_STATIC_LOCAL(HashSet<CompressedSourceProvider*>, providers, ());
+    return providers;
+}
+
+static Mutex& liveProvidersMutex()
+{
+    DEFINE_STATIC_LOCAL(Mutex, mutex, ());
+    return mutex;
+}
+
+void CompressedSourceProvider::initializeThreading()
+{
+    liveProvidersMutex();
+}
+
+CompressedSourceProvider::CompressedSourceProvider(const UString& source, const UString& url)
+    : SourceProvider(url)
+    , m_length(source.length())
+{
+    const UChar* characters = source.characters();
+    unsigned chunkCount = (m_length + chunkLength - 1) / chunkLength;
+    m_chunkOffsets.reserveInitialCapacity(chunkCount);
+    for (unsigned chunk = 0; chunk < chunkCount; ++chunk) {
+        m_chunkOffsets.uncheckedAppend(m_compressed.size());
+        unsigned start = chunk * chunkLength;
+        compressChunk(characters + start, std::min(chunkLength, m_length - start), m_compressed);
+    }
+    m_compressed.shrinkToFit();
+    m_chunkIsDecompressed.fill(false, chunkCount);
+
+    MutexLocker locker(liveProvidersMutex());
+    liveProviders().add(this);
+}
+
+CompressedSourceProvider::~CompressedSourceProvider()
+{
+    MutexLocker locker(liveProvidersMutex());
+    liveProviders().remove(this);
+}
+
+void CompressedSourceProvider::ensureChunksDecompressed(unsigned firstChunk, unsigned lastChunk) const
+{
+    if (!m_decompressed)
+        m_decompressed = adoptArrayPtr(new UChar[std::max(m_length, 1u)]);
+    for (unsigned chunk = firstChunk; chunk <= lastChunk && chunk < m_chunkOffsets.size(); ++chunk) {
+        if (m_chunkIsDecompressed[chunk])
+            continue;
+        decompressChunk(m_compressed.data() + m_chunkOffsets[chunk], m_decompressed.get() + chunk * chunkLength);
+        m_chunkIsDecompressed[chunk] = true;
+    }
+}
+
+const UChar* CompressedSourceProvider::dataForRange(int start, int end) const
+{
+    ASSERT(start >= 0 && start <= end && static_cast<unsigned>(end) <= m_length);
+    // The lexer may look at the character at the end offset, so include its chunk.
+    ensureChunksDecompressed(start / chunkLength, end / chunkLength);
+    return m_decompressed.get();
+}
+
+const UChar* CompressedSourceProvider::data() const
+{
+    return dataForRange(0, m_length);
+}
+
+UString CompressedSourceProvider::getRange(int start, int end) const
+{
+    return UString(dataForRange(start, end) + start, end - start);
+}
+
+size_t CompressedSourceProvider::sizeInMemory() const
+{
+    size_t size = m_compressed.capacity() + m_chunkOffsets.capacity() * sizeof(unsigned) + m_chunkIsDecompressed.capacity() * sizeof(bool);
+    if (m_decompressed)
+        size += std::max(m_length, 1u) * sizeof(UChar);
+    return size;
+}
+
+void CompressedSourceProvider::discardDecompressedSource()
+{
+    m_decompressed.clear();
+    for (size_t i = 0; i < m_chunkIsDecompressed.size(); ++i)
+        m_chunkIsDecompressed[i] = false;
+}
+
+void CompressedSourceProvider::discardDecompressedSources()
+{
+    MutexLocker locker(liveProvidersMutex());
+    HashSet<CompressedSourceProvider*>::iterator end = liveProviders().end();
+    for (HashSet<CompressedSourceProvider*>::iterator it = liveProviders().begin(); it != end; ++it)
+        (*it)->discardDecompressedSource();
+}
+
+} // namespace JSC
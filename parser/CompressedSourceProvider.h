@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CompressedSourceProvider_h
+#define CompressedSourceProvider_h
+
+#include "SourceProvider.h"
+#include <wtf/OwnArrayPtr.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    // Keeps the text of a script compressed, in independently decodable chunks, and
+    // decompresses only the chunks that a parse or toString() actually reads. What has
+    // been decompressed stays resident, so functions that keep being compiled stay cheap,
+    // until discardDecompressedSources() drops it again.
+    class CompressedSourceProvider : public SourceProvider {
+    public:
+        static PassRefPtr<CompressedSourceProvider> create(const UString& source, const UString& url)
+        {
+            return adoptRef(new CompressedSourceProvider(source, url));
+        }
+        virtual ~CompressedSourceProvider();
+
+        UString getRange(int start, int end) const;
+        const UChar* data() const;
+        const UChar* dataForRange(int start, int end) const;
+        int length() const { return m_length; }
+        size_t sizeInMemory() const;
+
+        // Must only be called while no script is being parsed, since the lexer holds on
+        // to the decompressed characters for the duration of a parse.
+        static void discardDecompressedSources();
+
+        static void initializeThreading();
+
+    private:
+        CompressedSourceProvider(const UString& source, const UString& url);
+
+        static const unsigned chunkLength = 8 * 1024;
+
+        void ensureChunksDecompressed(unsigned firstChunk, unsigned lastChunk) const;
+        void discardDecompressedSource();
+
+        unsigned m_length;
+        Vector<unsigned> m_chunkOffsets;
+        Vector<uint8_t> m_compressed;
+        mutable OwnArrayPtr<UChar> m_decompressed;
+        mutable Vector<bool> m_chunkIsDecompressed;
+    };
+
+} // namespace JSC
+
+#endif // CompressedSourceProvider_h
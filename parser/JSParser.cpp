@@ -84,6 +84,7 @@ class JSParser {
 public:
     JSParser(Lexer*, JSGlobalData*, FunctionParameters*, bool isStrictContext, bool isFunction, const SourceCode*);
     UString parseProgram();
+    UString checkProgramSyntax();
 private:
     struct AllowInOverride {
         AllowInOverride(JSParser* parser)
@@ -516,6 +517,9 @@ private:
     template <class TreeBuilder> ALWAYS_INLINE TreeConstDeclList parseConstDeclarationList(TreeBuilder& context);
     enum FunctionRequirements { FunctionNoRequirements, FunctionNeedsName };
     template <FunctionRequirements, bool nameIsInContainingScope, class TreeBuilder> bool parseFunctionInfo(TreeBuilder&, const Identifier*&, TreeFormalParameterList&, TreeFunctionBody&, int& openBrace, int& closeBrace, int& bodyStartLine);
+    bool parseFunctionBodyEagerly(ASTBuilder&, FunctionBodyNode*&, int bodyStartLine);
+    bool parseFunctionBodyEagerly(SyntaxChecker&, int&, int) { ASSERT_NOT_REACHED(); return false; }
+    PassRefPtr<FunctionBodyNode> parseEagerFunctionBody(int bodyStartLine);
     ALWAYS_INLINE int isBinaryOperator(JSTokenType token);
     bool allowAutomaticSemicolon();
 
@@ -554,6 +558,8 @@ private:
     int m_statementDepth;
     int m_nonTrivialExpressionCount;
     const Identifier* m_lastIdentifier;
+    int m_parenthesizedFunctionStart;
+    bool m_parseNextFunctionBodyEagerly;
 
     struct DepthManager {
         DepthManager(int* depth)
@@ -720,6 +726,15 @@ private:
             }
         }
 
+        // Like getCapturedVariables, but leaves the scope intact for popScope.
+        void copyCapturedVariables(IdentifierSet& capturedVariables) const
+        {
+            bool capturesAll = m_needsFullActivation || m_usesEval;
+            for (IdentifierSet::const_iterator ptr = m_declaredVariables.begin(); ptr != m_declaredVariables.end(); ++ptr) {
+                if (capturesAll || m_closedVariables.contains(*ptr))
+                    capturedVariables.add(*ptr);
+            }
+        }
         void getCapturedVariables(IdentifierSet& capturedVariables)
         {
             if (m_needsFullActivation || m_usesEval) {
@@ -906,6 +921,8 @@ private:
 UString jsParse(JSGlobalData* globalData, FunctionParameters* parameters, JSParserStrictness strictness, JSParserMode parserMode, const SourceCode* source)
 {
     JSParser parser(globalData->lexer, globalData, parameters, strictness == JSParseStrict, parserMode == JSParseFunctionCode, source);
+    if (parserMode == JSCheckProgramSyntax)
+        return parser.checkProgramSyntax();
     return parser.parseProgram();
 }
 
@@ -924,9 +941,15 @@ JSParser::JSParser(Lexer* lexer, JSGlobalData* globalData, FunctionParameters* p
     , m_statementDepth(0)
     , m_nonTrivialExpressionCount(0)
     , m_lastIdentifier(0)
+    , m_parenthesizedFunctionStart(-1)
+    , m_parseNextFunctionBodyEagerly(false)
     , m_functionCache(m_lexer->sourceProvider()->cache())
     , m_source(source)
 {
+    // Only a whole-program parse pins down the line numbers of every function in the
+    // source, so that is the point at which the provider joins the shared cache.
+    if (m_functionCache && !isFunction && !inStrictContext && !source->startOffset())
+        m_functionCache->attachToSharedCache(globalData, source->provider()->data(), source->provider()->length(), source->firstLine());
     ScopeRef scope = pushScope();
     if (isFunction)
         scope->setIsFunction();
@@ -967,6 +990,22 @@ UString JSParser::parseProgram()
     return UString();
 }
 
+// Validates the program without building it: the whole parse runs against SyntaxChecker,
+// so no AST nodes are created. Function boundaries still go into the source provider's
+// cache, so a later evaluation of the same provider can skip the function bodies.
+UString JSParser::checkProgramSyntax()
+{
+    unsigned oldFunctionCacheSize = m_functionCache ? m_functionCache->byteSize() : 0;
+    SyntaxChecker context(m_globalData, m_lexer);
+    if (!parseSourceElements<CheckForStrictMode>(context) || !consume(EOFTOK))
+        return m_errorMessage;
+
+    unsigned functionCacheSize = m_functionCache ? m_functionCache->byteSize() : 0;
+    if (functionCacheSize != oldFunctionCacheSize)
+        m_lexer->sourceProvider()->notifyCacheSizeChanged(functionCacheSize - oldFunctionCacheSize);
+    return UString();
+}
+
 bool JSParser::allowAutomaticSemicolon()
 {
     return match(CLOSEBRACE) || match(EOFTOK) || m_lexer->prevTerminator();
@@ -1587,6 +1626,8 @@ template <class TreeBuilder> TreeFunctionBody JSParser::parseFunctionBody(TreeBu
 
 template <JSParser::FunctionRequirements requirements, bool nameIsInContainingScope, class TreeBuilder> bool JSParser::parseFunctionInfo(TreeBuilder& context, const Identifier*& name, TreeFormalParameterList& parameters, TreeFunctionBody& body, int& openBracePos, int& closeBracePos, int& bodyStartLine)
 {
+    bool parseBodyEagerly = TreeBuilder::CreatesAST && m_parseNextFunctionBodyEagerly;
+    m_parseNextFunctionBodyEagerly = false;
     AutoPopScopeRef functionScope(this, pushScope());
     functionScope->setIsFunction();
     if (match(IDENT)) {
@@ -1624,10 +1665,13 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
         return true;
     }
 
-    next();
-
-    body = parseFunctionBody(context);
-    failIfFalse(body);
+    if (parseBodyEagerly)
+        failIfFalse(parseFunctionBodyEagerly(context, body, bodyStartLine));
+    else {
+        next();
+        body = parseFunctionBody(context);
+        failIfFalse(body);
+    }
     if (functionScope->strictMode() && name) {
         failIfTrueWithNameAndMessage(m_globalData->propertyNames->arguments == *name, "Function name", name->impl(), "is not valid in strict mode");
         failIfTrueWithNameAndMessage(m_globalData->propertyNames->eval == *name, "Function name", name->impl(), "is not valid in strict mode");
@@ -1656,6 +1700,64 @@ template <JSParser::FunctionRequirements requirements, bool nameIsInContainingSc
     return true;
 }
 
+// Called at the open brace of a parenthesized anonymous function expression, the module pattern
+// "(function() { ... })()", which is almost always called straight away. Rather than only
+// checking the body's syntax, this builds its tree in an arena of its own, which outlives that
+// of the enclosing code, so the function's first compile doesn't parse it again.
+bool JSParser::parseFunctionBodyEagerly(ASTBuilder& context, FunctionBodyNode*& body, int bodyStartLine)
+{
+    ParserArena& arena = m_globalData->parser->arena();
+    ParserArena enclosingArena;
+    arena.swap(enclosingArena);
+    m_lexer->setArena(arena);
+    RefPtr<FunctionBodyNode> eagerlyParsedBody = parseEagerFunctionBody(bodyStartLine);
+    arena.swap(enclosingArena);
+    m_lexer->setArena(arena);
+    if (!eagerlyParsedBody)
+        return false;
+
+    body = context.createFunctionBody(strictMode());
+    body->setEagerlyParsedBody(eagerlyParsedBody.release());
+    return true;
+}
+
+// Builds the same tree as parsing the function's source on its own would, in which the body's
+// statements form a single block.
+PassRefPtr<FunctionBodyNode> JSParser::parseEagerFunctionBody(int bodyStartLine)
+{
+    ASSERT(match(OPENBRACE));
+    int openBracePos = m_token.m_data.intValue;
+    next();
+
+    ASTBuilder bodyBuilder(m_globalData, m_lexer);
+    SourceElements* statements = 0;
+    if (!match(CLOSEBRACE)) {
+        DepthManager statementDepth(&m_statementDepth);
+        m_statementDepth = 0;
+        statements = parseSourceElements<CheckForStrictMode>(bodyBuilder);
+        failIfFalse(statements);
+    }
+    matchOrFail(CLOSEBRACE);
+    SourceElements* sourceElements = bodyBuilder.createSourceElements();
+    bodyBuilder.appendStatement(sourceElements, bodyBuilder.createBlockStatement(statements, bodyStartLine, tokenLine()));
+
+    ScopeRef scope = currentScope();
+    IdentifierSet capturedVariables;
+    scope->copyCapturedVariables(capturedVariables);
+    CodeFeatures features = bodyBuilder.features();
+    if (scope->strictMode())
+        features |= StrictModeFeature;
+    if (scope->shadowsArguments())
+        features |= ShadowsArgumentsFeature;
+
+    RefPtr<FunctionBodyNode> body = FunctionBodyNode::create(m_globalData, sourceElements,
+        bodyBuilder.varDeclarations() ? &bodyBuilder.varDeclarations()->data : 0,
+        bodyBuilder.funcDeclarations() ? &bodyBuilder.funcDeclarations()->data : 0,
+        capturedVariables, m_lexer->sourceCode(openBracePos, m_token.m_data.intValue, bodyStartLine), features, bodyBuilder.numConstants());
+    body->setLoc(bodyStartLine, tokenLine());
+    return body.release();
+}
+
 template <class TreeBuilder> TreeStatement JSParser::parseFunctionDeclaration(TreeBuilder& context)
 {
     ASSERT(match(FUNCTION));
@@ -2179,6 +2281,8 @@ template <class TreeBuilder> TreeExpression JSParser::parsePrimaryExpression(Tre
         return parseArrayLiteral(context);
     case OPENPAREN: {
         next();
+        if (match(FUNCTION))
+            m_parenthesizedFunctionStart = tokenStart();
         int oldNonLHSCount = m_nonLHSCount;
         TreeExpression result = parseExpression(context);
         m_nonLHSCount = oldNonLHSCount;
@@ -2285,7 +2389,9 @@ template <class TreeBuilder> TreeExpression JSParser::parseMemberExpression(Tree
         int openBracePos = 0;
         int closeBracePos = 0;
         int bodyStartLine = 0;
+        bool isParenthesized = !newCount && tokenStart() == m_parenthesizedFunctionStart;
         next();
+        m_parseNextFunctionBodyEagerly = isParenthesized && !match(IDENT);
         failIfFalse((parseFunctionInfo<FunctionNoRequirements, false>(context, name, parameters, body, openBracePos, closeBracePos, bodyStartLine)));
         base = context.createFunctionExpr(name, body, parameters, openBracePos, closeBracePos, bodyStartLine, m_lastLine);
     } else
@@ -160,7 +160,7 @@ struct JSToken {
 };
 
 enum JSParserStrictness { JSParseNormal, JSParseStrict };
-enum JSParserMode { JSParseProgramCode, JSParseFunctionCode };
+enum JSParserMode { JSParseProgramCode, JSParseFunctionCode, JSCheckProgramSyntax };
 
 UString jsParse(JSGlobalData*, FunctionParameters*, JSParserStrictness, JSParserMode, const SourceCode*);
 }
@@ -275,7 +275,7 @@ void Lexer::setCode(const SourceCode& source, ParserArena& arena)
     m_delimited = false;
     m_lastToken = -1;
 
-    const UChar* data = source.provider()->data();
+    const UChar* data = source.provider()->dataForRange(source.startOffset(), source.endOffset());
 
     m_source = &source;
     m_codeStart = data;
@@ -295,6 +295,11 @@ void Lexer::setCode(const SourceCode& source, ParserArena& arena)
     ASSERT(currentOffset() == source.startOffset());
 }
 
+void Lexer::setArena(ParserArena& arena)
+{
+    m_arena = &arena.identifierArena();
+}
+
 template <int shiftAmount, Lexer::ShiftType shouldBoundsCheck> ALWAYS_INLINE void Lexer::internalShift()
 {
     if (shouldBoundsCheck == DoBoundsCheck) {
@@ -440,9 +445,13 @@ template <bool shouldCreateIdentifier> ALWAYS_INLINE JSTokenType Lexer::parseIde
     }
     const UChar* identifierStart = currentCharacter();
     bool bufferRequired = false;
+    // Hash as we scan so the identifier table lookup does not rehash the name.
+    StringHasher hasher;
 
     while (true) {
         if (LIKELY(isIdentPart(m_current))) {
+            if (shouldCreateIdentifier)
+                hasher.addCharacter(m_current);
             shift();
             continue;
         }
@@ -479,7 +488,7 @@ template <bool shouldCreateIdentifier> ALWAYS_INLINE JSTokenType Lexer::parseIde
             identifierLength = m_buffer16.size();
         }
 
-        ident = makeIdentifier(identifierStart, identifierLength);
+        ident = bufferRequired ? makeIdentifier(identifierStart, identifierLength) : makeIdentifier(identifierStart, identifierLength, hasher.hash());
         tokenData->ident = ident;
     } else
         tokenData->ident = 0;
@@ -761,9 +770,69 @@ ALWAYS_INLINE bool Lexer::parseNumberAfterExponentIndicator()
     return true;
 }
 
+// Comment bodies are skipped a 64-bit word (four UChars) at a time. A word is only
+// examined character by character when one of its lanes might be a character the
+// caller has to stop on; the lane tests below may report false positives but never
+// miss a match.
+static const uint64_t commentScanLanes = 0x0001000100010001ULL;
+
+static ALWAYS_INLINE bool wordMayContainLessThan(uint64_t word, uint64_t limit)
+{
+    return (word - commentScanLanes * limit) & ~word & (commentScanLanes * 0x8000);
+}
+
+template <bool stopAtAsterisk> static ALWAYS_INLINE bool isCommentScanStop(UChar character)
+{
+    return Lexer::isLineTerminator(character) || (stopAtAsterisk && character == '*');
+}
+
+template <bool stopAtAsterisk> static ALWAYS_INLINE bool wordMayContainCommentScanStop(uint64_t word)
+{
+    // Line terminators are '\n', '\r' (both below 0x0E), U+2028 and U+2029.
+    if (wordMayContainLessThan(word, 0x0E) || wordMayContainLessThan(word ^ (commentScanLanes * 0x2028), 2))
+        return true;
+    return stopAtAsterisk && wordMayContainLessThan(word ^ (commentScanLanes * '*'), 1);
+}
+
+template <bool stopAtAsterisk> static inline const UChar* scanCommentCharacters(const UChar* code, const UChar* end)
+{
+    while (code < end && (reinterpret_cast<uintptr_t>(code) & (sizeof(uint64_t) - 1))) {
+        if (isCommentScanStop<stopAtAsterisk>(*code))
+            return code;
+        ++code;
+    }
+    const size_t charactersPerWord = sizeof(uint64_t) / sizeof(UChar);
+    while (static_cast<size_t>(end - code) >= charactersPerWord) {
+        uint64_t word;
+        memcpy(&word, code, sizeof(word));
+        if (wordMayContainCommentScanStop<stopAtAsterisk>(word)) {
+            for (size_t i = 0; i < charactersPerWord; ++i) {
+                if (isCommentScanStop<stopAtAsterisk>(code[i]))
+                    return code + i;
+            }
+        }
+        code += charactersPerWord;
+    }
+    while (code < end && !isCommentScanStop<stopAtAsterisk>(*code))
+        ++code;
+    return code;
+}
+
+ALWAYS_INLINE void Lexer::skipCommentCharacters(bool stopAtAsterisk)
+{
+    if (UNLIKELY(m_current == -1))
+        return;
+    m_code = stopAtAsterisk ? scanCommentCharacters<true>(m_code, m_codeEnd) : scanCommentCharacters<false>(m_code, m_codeEnd);
+    m_current = -1;
+    if (LIKELY(m_code < m_codeEnd))
+        m_current = *m_code;
+}
+
 ALWAYS_INLINE bool Lexer::parseMultilineComment()
 {
     while (true) {
+        skipCommentCharacters(true);
+
         while (UNLIKELY(m_current == '*')) {
             shift();
             if (m_current == '/') {
@@ -1096,9 +1165,12 @@ inNumberAfterDecimalPoint:
                         m_lexErrorMessage = "Non-number found after exponent indicator";
                         goto returnError;
                     }
-                // Null-terminate string for strtod.
-                m_buffer8.append('\0');
-                tokenData->doubleValue = WTF::strtod(m_buffer8.data(), 0);
+                size_t parsedLength;
+                if (!WTF::strtodFastPath(m_buffer8.data(), m_buffer8.data() + m_buffer8.size(), tokenData->doubleValue, parsedLength) || parsedLength != m_buffer8.size()) {
+                    // Null-terminate string for strtod.
+                    m_buffer8.append('\0');
+                    tokenData->doubleValue = WTF::strtod(m_buffer8.data(), 0);
+                }
             }
             token = NUMBER;
         }
@@ -1151,6 +1223,7 @@ inNumberAfterDecimalPoint:
     goto returnToken;
 
 inSingleLineComment:
+    skipCommentCharacters(false);
     while (!isLineTerminator(m_current)) {
         if (UNLIKELY(m_current == -1))
             return EOFTOK;
@@ -1297,8 +1370,8 @@ void Lexer::clear()
 
 SourceCode Lexer::sourceCode(int openBrace, int closeBrace, int firstLine)
 {
-    ASSERT(m_source->provider()->data()[openBrace] == '{');
-    ASSERT(m_source->provider()->data()[closeBrace] == '}');
+    ASSERT(m_codeStart[openBrace] == '{');
+    ASSERT(m_codeStart[closeBrace] == '}');
     return SourceCode(m_source->provider(), openBrace, closeBrace + 1, firstLine);
 }
 
@@ -46,8 +46,12 @@ namespace JSC {
         static unsigned char convertHex(int c1, int c2);
         static UChar convertUnicode(int c1, int c2, int c3, int c4);
 
-        // Functions to set up parsing.
+        // Functions to set up parsing. The whole source must be available up front: the
+        // parser is recursive descent and cannot suspend mid-production, and lookahead
+        // such as nextTokenIsColon() and setOffset() re-reads already lexed characters.
         void setCode(const SourceCode&, ParserArena&);
+        // Moves identifier allocation to another arena mid-parse.
+        void setArena(ParserArena&);
         void setIsReparsing() { m_isReparsing = true; }
         bool isReparsing() const { return m_isReparsing; }
 
@@ -117,6 +121,7 @@ namespace JSC {
         ALWAYS_INLINE int currentOffset() const;
 
         ALWAYS_INLINE const Identifier* makeIdentifier(const UChar* characters, size_t length);
+        ALWAYS_INLINE const Identifier* makeIdentifier(const UChar* characters, size_t length, unsigned hash);
 
         ALWAYS_INLINE bool lastTokenWasRestrKeyword() const;
 
@@ -130,6 +135,7 @@ namespace JSC {
         ALWAYS_INLINE bool parseDecimal(double& returnValue);
         ALWAYS_INLINE void parseNumberAfterDecimalPoint();
         ALWAYS_INLINE bool parseNumberAfterExponentIndicator();
+        ALWAYS_INLINE void skipCommentCharacters(bool stopAtAsterisk);
         ALWAYS_INLINE bool parseMultilineComment();
 
         static const size_t initialReadBufferCapacity = 32;
@@ -187,22 +193,30 @@ namespace JSC {
         return &m_arena->makeIdentifier(m_globalData, characters, length);
     }
 
+    ALWAYS_INLINE const Identifier* Lexer::makeIdentifier(const UChar* characters, size_t length, unsigned hash)
+    {
+        return &m_arena->makeIdentifier(m_globalData, characters, length, hash);
+    }
+
     ALWAYS_INLINE JSTokenType Lexer::lexExpectIdentifier(JSTokenData* tokenData, JSTokenInfo* tokenInfo, unsigned lexType, bool strictMode)
     {
         ASSERT((lexType & IgnoreReservedWords));
         const UChar* start = m_code;
         const UChar* ptr = start;
         const UChar* end = m_codeEnd;
+        StringHasher hasher;
         if (ptr >= end) {
             ASSERT(ptr == end);
             goto slowCase;
         }
         if (!WTF::isASCIIAlpha(*ptr))
             goto slowCase;
+        hasher.addCharacter(*ptr);
         ++ptr;
         while (ptr < end) {
             if (!WTF::isASCIIAlphanumeric(*ptr))
                 break;
+            hasher.addCharacter(*ptr);
             ++ptr;
         }
 
@@ -220,7 +234,7 @@ namespace JSC {
         if (lexType & DontBuildKeywords)
             tokenData->ident = 0;
         else
-            tokenData->ident = makeIdentifier(start, ptr - start);
+            tokenData->ident = makeIdentifier(start, ptr - start, hasher.hash());
         tokenInfo->line = m_lineNumber;
         tokenInfo->startOffset = start - m_codeStart;
         tokenInfo->endOffset = currentOffset();
@@ -1490,6 +1490,12 @@ namespace JSC {
         
         const Identifier& ident() { return m_ident; }
 
+        // The complete tree of this function's body, when the parse of the enclosing code built
+        // it rather than only checking its syntax. It owns the arena its nodes were allocated in,
+        // and is handed to the FunctionExecutable, whose first compile then needn't parse again.
+        void setEagerlyParsedBody(PassRefPtr<FunctionBodyNode> body) { m_eagerlyParsedBody = body; }
+        PassRefPtr<FunctionBodyNode> releaseEagerlyParsedBody() { return m_eagerlyParsedBody.release(); }
+
         static const bool scopeIsFunction = true;
 
     private:
@@ -1498,6 +1504,7 @@ namespace JSC {
 
         Identifier m_ident;
         RefPtr<FunctionParameters> m_parameters;
+        RefPtr<FunctionBodyNode> m_eagerlyParsedBody;
     };
 
     class FuncExprNode : public ExpressionNode {
@@ -49,6 +49,7 @@ void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSP
     lexer.setCode(*m_source, m_arena);
 
     UString parseError = jsParse(globalData, parameters, strictness, mode, m_source);
+    m_peakArenaSize = std::max(m_peakArenaSize, m_arena.sizeInMemory());
     int lineNumber = lexer.lineNumber();
     bool lexError = lexer.sawError();
     UString lexErrorMessage = lexError ? lexer.getErrorMessage() : UString();
@@ -62,6 +63,29 @@ void Parser::parse(JSGlobalData* globalData, FunctionParameters* parameters, JSP
     }
 }
 
+bool Parser::checkSyntax(JSGlobalObject* lexicalGlobalObject, Debugger* debugger, ExecState* debuggerExecState, const SourceCode& source, JSObject** exception)
+{
+    ASSERT(lexicalGlobalObject);
+    ASSERT(exception && !*exception);
+    int errLine;
+    UString errMsg;
+
+    m_source = &source;
+    parse(&lexicalGlobalObject->globalData(), 0, JSParseNormal, JSCheckProgramSyntax, &errLine, &errMsg);
+    ASSERT(!m_sourceElements);
+
+    bool isValid = errMsg.isNull();
+    if (!isValid)
+        *exception = addErrorInfo(&lexicalGlobalObject->globalData(), createSyntaxError(lexicalGlobalObject, errMsg), errLine, source);
+
+    m_arena.reset();
+    m_source = 0;
+
+    if (debugger)
+        debugger->sourceParsed(debuggerExecState, source.provider(), errLine, errMsg);
+    return isValid;
+}
+
 void Parser::didFinishParsing(SourceElements* sourceElements, ParserArenaData<DeclarationStacks::VarStack>* varStack, 
                               ParserArenaData<DeclarationStacks::FunctionStack>* funcStack, CodeFeatures features, int lastLine, int numConstants, IdentifierSet& capturedVars)
 {
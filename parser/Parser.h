@@ -50,15 +50,24 @@ namespace JSC {
     class Parser {
         WTF_MAKE_NONCOPYABLE(Parser); WTF_MAKE_FAST_ALLOCATED;
     public:
-        Parser() { }
+        Parser()
+            : m_arena(&m_arenaPoolCache)
+            , m_peakArenaSize(0)
+        {
+        }
         template <class ParsedNode>
         PassRefPtr<ParsedNode> parse(JSGlobalObject* lexicalGlobalObject, Debugger*, ExecState*, const SourceCode& source, FunctionParameters*, JSParserStrictness strictness, JSObject** exception);
 
+        // Reports whether the program parses, without building an AST for it.
+        bool checkSyntax(JSGlobalObject* lexicalGlobalObject, Debugger*, ExecState*, const SourceCode& source, JSObject** exception);
+
         void didFinishParsing(SourceElements*, ParserArenaData<DeclarationStacks::VarStack>*, 
                               ParserArenaData<DeclarationStacks::FunctionStack>*, CodeFeatures features,
                               int lastLine, int numConstants, IdentifierSet&);
 
         ParserArena& arena() { return m_arena; }
+        // The most memory one parse has held in its arena, in bytes.
+        size_t peakArenaSize() const { return m_peakArenaSize; }
 
     private:
         void parse(JSGlobalData*, FunctionParameters*, JSParserStrictness strictness, JSParserMode mode, int* errLine, UString* errMsg);
@@ -67,7 +76,9 @@ namespace JSC {
         bool isFunctionBodyNode(ScopeNode*) { return false; }
         bool isFunctionBodyNode(FunctionBodyNode*) { return true; }
 
+        ParserArenaPoolCache m_arenaPoolCache;
         ParserArena m_arena;
+        size_t m_peakArenaSize;
         const SourceCode* m_source;
         SourceElements* m_sourceElements;
         ParserArenaData<DeclarationStacks::VarStack>* m_varDeclarations;
@@ -83,6 +94,7 @@ namespace JSC {
     {
         ASSERT(lexicalGlobalObject);
         ASSERT(exception && !*exception);
+        FastMallocTagScope tagScope("JSC/Parser");
         int errLine;
         UString errMsg;
 
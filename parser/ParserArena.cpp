@@ -31,13 +31,65 @@
 
 namespace JSC {
 
-ParserArena::ParserArena()
-    : m_freeableMemory(0)
+ParserArenaPoolCache::~ParserArenaPoolCache()
+{
+    ASSERT(!m_poolsInUse);
+    for (size_t i = 0; i < m_pools.size(); ++i)
+        fastFree(m_pools[i]);
+}
+
+void* ParserArenaPoolCache::takePool(size_t size)
+{
+    ++m_poolsInUse;
+    m_poolsInUseHighWaterMark = std::max(m_poolsInUseHighWaterMark, m_poolsInUse);
+    if (m_pools.isEmpty())
+        return fastMalloc(size);
+    void* pool = m_pools.last();
+    m_pools.removeLast();
+    return pool;
+}
+
+void ParserArenaPoolCache::returnPool(void* pool)
+{
+    ASSERT(m_poolsInUse);
+    --m_poolsInUse;
+    size_t retainedPoolLimit = m_poolsInUseHighWaterMark < maximumRetainedPools ? m_poolsInUseHighWaterMark : maximumRetainedPools;
+    if (m_pools.size() >= retainedPoolLimit) {
+        fastFree(pool);
+        return;
+    }
+    m_pools.append(pool);
+}
+
+PassOwnPtr<IdentifierArena> ParserArenaPoolCache::takeIdentifierArena()
+{
+    if (m_identifierArena)
+        return m_identifierArena.release();
+    return adoptPtr(new IdentifierArena);
+}
+
+void ParserArenaPoolCache::returnIdentifierArena(PassOwnPtr<IdentifierArena> identifierArena)
+{
+    if (m_identifierArena)
+        return;
+    m_identifierArena = identifierArena;
+    m_identifierArena->clear();
+}
+
+ParserArena::ParserArena(ParserArenaPoolCache* poolCache)
+    : m_poolCache(poolCache)
+    , m_freeableMemory(0)
     , m_freeablePoolEnd(0)
-    , m_identifierArena(adoptPtr(new IdentifierArena))
+    , m_deletableBytes(0)
 {
 }
 
+void ParserArena::allocateIdentifierArena()
+{
+    ASSERT(!m_identifierArena);
+    m_identifierArena = m_poolCache ? m_poolCache->takeIdentifierArena() : adoptPtr(new IdentifierArena);
+}
+
 inline void* ParserArena::freeablePool()
 {
     ASSERT(m_freeablePoolEnd);
@@ -47,11 +99,15 @@ inline void* ParserArena::freeablePool()
 inline void ParserArena::deallocateObjects()
 {
     if (m_freeablePoolEnd)
-        fastFree(freeablePool());
+        m_freeablePools.append(freeablePool());
 
     size_t size = m_freeablePools.size();
-    for (size_t i = 0; i < size; ++i)
-        fastFree(m_freeablePools[i]);
+    for (size_t i = 0; i < size; ++i) {
+        if (m_poolCache)
+            m_poolCache->returnPool(m_freeablePools[i]);
+        else
+            fastFree(m_freeablePools[i]);
+    }
 
     size = m_deletableObjects.size();
     for (size_t i = 0; i < size; ++i) {
@@ -64,6 +120,8 @@ inline void ParserArena::deallocateObjects()
 ParserArena::~ParserArena()
 {
     deallocateObjects();
+    if (m_poolCache && m_identifierArena)
+        m_poolCache->returnIdentifierArena(m_identifierArena.release());
 }
 
 bool ParserArena::contains(ParserArenaRefCounted* object) const
@@ -83,15 +141,14 @@ void ParserArena::removeLast()
 
 void ParserArena::reset()
 {
-    // Since this code path is used only when parsing fails, it's not bothering to reuse
-    // any of the memory the arena allocated. We could improve that later if we want to
-    // efficiently reuse the same arena.
-
+    // Pools go back to the pool cache, if there is one, for the next parse.
     deallocateObjects();
 
     m_freeableMemory = 0;
     m_freeablePoolEnd = 0;
-    m_identifierArena->clear();
+    m_deletableBytes = 0;
+    if (m_identifierArena)
+        m_identifierArena->clear();
     m_freeablePools.clear();
     m_deletableObjects.clear();
     m_refCountedObjects.clear();
@@ -102,7 +159,7 @@ void ParserArena::allocateFreeablePool()
     if (m_freeablePoolEnd)
         m_freeablePools.append(freeablePool());
 
-    char* pool = static_cast<char*>(fastMalloc(freeablePoolSize));
+    char* pool = static_cast<char*>(m_poolCache ? m_poolCache->takePool(freeablePoolSize) : fastMalloc(freeablePoolSize));
     m_freeableMemory = pool;
     m_freeablePoolEnd = pool + freeablePoolSize;
     ASSERT(freeablePool() == pool);
@@ -111,12 +168,18 @@ void ParserArena::allocateFreeablePool()
 bool ParserArena::isEmpty() const
 {
     return !m_freeablePoolEnd
-        && m_identifierArena->isEmpty()
+        && (!m_identifierArena || m_identifierArena->isEmpty())
         && m_freeablePools.isEmpty()
         && m_deletableObjects.isEmpty()
         && m_refCountedObjects.isEmpty();
 }
 
+size_t ParserArena::sizeInMemory() const
+{
+    size_t poolCount = m_freeablePools.size() + (m_freeablePoolEnd ? 1 : 0);
+    return poolCount * freeablePoolSize + m_deletableBytes + m_deletableObjects.capacity() * sizeof(ParserArenaDeletable*) + m_refCountedObjects.capacity() * sizeof(RefPtr<ParserArenaRefCounted>);
+}
+
 void ParserArena::derefWithArena(PassRefPtr<ParserArenaRefCounted> object)
 {
     m_refCountedObjects.append(object);
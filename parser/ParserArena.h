@@ -43,46 +43,57 @@ namespace JSC {
         }
 
         ALWAYS_INLINE const Identifier& makeIdentifier(JSGlobalData*, const UChar* characters, size_t length);
+        // For callers that hashed the characters with StringHasher while scanning them.
+        ALWAYS_INLINE const Identifier& makeIdentifier(JSGlobalData*, const UChar* characters, size_t length, unsigned hash);
         const Identifier& makeNumericIdentifier(JSGlobalData*, double number);
 
         bool isEmpty() const { return m_identifiers.isEmpty(); }
 
     public:
         static const int MaximumCachableCharacter = 128;
+        // Direct-mapped by hash, so that the names a script keeps repeating are
+        // found without going to the identifier table.
+        static const unsigned RecentIdentifierCacheSize = 256;
         typedef SegmentedVector<Identifier, 64> IdentifierVector;
         void clear()
         {
             m_identifiers.clear();
             for (int i = 0; i < MaximumCachableCharacter; i++)
                 m_shortIdentifiers[i] = 0;
-            for (int i = 0; i < MaximumCachableCharacter; i++)
+            for (unsigned i = 0; i < RecentIdentifierCacheSize; i++)
                 m_recentIdentifiers[i] = 0;
         }
 
     private:
         IdentifierVector m_identifiers;
         FixedArray<Identifier*, MaximumCachableCharacter> m_shortIdentifiers;
-        FixedArray<Identifier*, MaximumCachableCharacter> m_recentIdentifiers;
+        FixedArray<Identifier*, RecentIdentifierCacheSize> m_recentIdentifiers;
     };
 
     ALWAYS_INLINE const Identifier& IdentifierArena::makeIdentifier(JSGlobalData* globalData, const UChar* characters, size_t length)
     {
-        if (characters[0] >= MaximumCachableCharacter) {
+        if (!length) {
             m_identifiers.append(Identifier(globalData, characters, length));
             return m_identifiers.last();
         }
-        if (length == 1) {
+        return makeIdentifier(globalData, characters, length, StringHasher::computeHash<UChar>(characters, length));
+    }
+
+    ALWAYS_INLINE const Identifier& IdentifierArena::makeIdentifier(JSGlobalData* globalData, const UChar* characters, size_t length, unsigned hash)
+    {
+        ASSERT(length);
+        if (length == 1 && characters[0] < MaximumCachableCharacter) {
             if (Identifier* ident = m_shortIdentifiers[characters[0]])
                 return *ident;
             m_identifiers.append(Identifier(globalData, characters, length));
             m_shortIdentifiers[characters[0]] = &m_identifiers.last();
             return m_identifiers.last();
         }
-        Identifier* ident = m_recentIdentifiers[characters[0]];
-        if (ident && Identifier::equal(ident->impl(), characters, length))
-            return *ident;
-        m_identifiers.append(Identifier(globalData, characters, length));
-        m_recentIdentifiers[characters[0]] = &m_identifiers.last();
+        Identifier*& recent = m_recentIdentifiers[hash & (RecentIdentifierCacheSize - 1)];
+        if (recent && recent->impl()->hash() == hash && Identifier::equal(recent->impl(), characters, length))
+            return *recent;
+        m_identifiers.append(Identifier(globalData, characters, length, hash));
+        recent = &m_identifiers.last();
         return m_identifiers.last();
     }
 
@@ -92,16 +103,51 @@ namespace JSC {
         return m_identifiers.last();
     }
 
+    // Keeps the memory of finished parses for the next one, so that repeated eval,
+    // new Function and lazy function compiles do not go to fastMalloc for every pool.
+    // Owned by the Parser of a JSGlobalData, which outlives every arena using it.
+    class ParserArenaPoolCache {
+        WTF_MAKE_NONCOPYABLE(ParserArenaPoolCache);
+    public:
+        ParserArenaPoolCache()
+            : m_poolsInUse(0)
+            , m_poolsInUseHighWaterMark(0)
+        {
+        }
+        ~ParserArenaPoolCache();
+
+        void* takePool(size_t);
+        void returnPool(void*);
+        PassOwnPtr<IdentifierArena> takeIdentifierArena();
+        void returnIdentifierArena(PassOwnPtr<IdentifierArena>);
+
+    private:
+        // Pools are retained up to the most that have been in use at once, but no more
+        // than this, so one huge parse does not pin its memory forever.
+        static const size_t maximumRetainedPools = 16;
+
+        Vector<void*> m_pools;
+        OwnPtr<IdentifierArena> m_identifierArena;
+        size_t m_poolsInUse;
+        size_t m_poolsInUseHighWaterMark;
+    };
+
     class ParserArena {
         WTF_MAKE_NONCOPYABLE(ParserArena);
     public:
-        ParserArena();
+        explicit ParserArena(ParserArenaPoolCache* = 0);
         ~ParserArena();
 
         void swap(ParserArena& otherArena)
         {
+            // The pool cache stays with both arenas, whichever of them had one.
+            if (!m_poolCache)
+                m_poolCache = otherArena.m_poolCache;
+            else if (!otherArena.m_poolCache)
+                otherArena.m_poolCache = m_poolCache;
             std::swap(m_freeableMemory, otherArena.m_freeableMemory);
             std::swap(m_freeablePoolEnd, otherArena.m_freeablePoolEnd);
+            std::swap(m_deletableBytes, otherArena.m_deletableBytes);
             m_identifierArena.swap(otherArena.m_identifierArena);
             m_freeablePools.swap(otherArena.m_freeablePools);
             m_deletableObjects.swap(otherArena.m_deletableObjects);
@@ -125,6 +171,7 @@ namespace JSC {
         {
             ParserArenaDeletable* deletable = static_cast<ParserArenaDeletable*>(fastMalloc(size));
             m_deletableObjects.append(deletable);
+            m_deletableBytes += size;
             return deletable;
         }
 
@@ -136,7 +183,15 @@ namespace JSC {
         bool isEmpty() const;
         void reset();
 
-        IdentifierArena& identifierArena() { return *m_identifierArena; }
+        // The memory held by the nodes allocated so far, in bytes.
+        size_t sizeInMemory() const;
+
+        IdentifierArena& identifierArena()
+        {
+            if (UNLIKELY(!m_identifierArena))
+                allocateIdentifierArena();
+            return *m_identifierArena;
+        }
 
     private:
         static const size_t freeablePoolSize = 8000;
@@ -148,10 +203,13 @@ namespace JSC {
 
         void* freeablePool();
         void allocateFreeablePool();
+        void allocateIdentifierArena();
         void deallocateObjects();
 
+        ParserArenaPoolCache* m_poolCache;
         char* m_freeableMemory;
         char* m_freeablePoolEnd;
+        size_t m_deletableBytes;
 
         OwnPtr<IdentifierArena> m_identifierArena;
         Vector<void*> m_freeablePools;
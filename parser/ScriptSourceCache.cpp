@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ScriptSourceCache.h"
+
+#include "CompressedSourceProvider.h"
+#include <wtf/StringHasher.h>
+
+namespace JSC {
+
+static PassRefPtr<SourceProvider> createProvider(const UString& source, const UString& url, bool compressed)
+{
+    if (compressed)
+        return CompressedSourceProvider::create(source, url);
+    return UStringSourceProvider::create(source, url);
+}
+
+SourceCode ScriptSourceCache::sourceFor(const UString& source, const UString& url, int firstLine, unsigned compressedSourceThreshold)
+{
+    unsigned length = source.length();
+    bool compressed = compressedSourceThreshold && length >= compressedSourceThreshold;
+    if (!m_capacity || length < minimumCacheableLength)
+        return SourceCode(createProvider(source, url, compressed), firstLine);
+
+    // Same identification as the process-wide SourceProviderCache: two unrelated hashes and the
+    // length, so that a collision cannot hand one context another script's code.
+    const UChar* characters = source.characters();
+    unsigned hash = StringHasher::computeHash<UChar>(characters, length);
+    unsigned secondaryHash = 2166136261u;
+    for (unsigned i = 0; i < length; ++i)
+        secondaryHash = (secondaryHash ^ characters[i]) * 16777619u;
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        Entry& entry = m_entries[i];
+        if (entry.hash != hash || entry.secondaryHash != secondaryHash || entry.length != length || entry.firstLine != firstLine
+            || entry.isCompressed != compressed || entry.provider->url() != url)
+            continue;
+        RefPtr<SourceProvider> provider = entry.provider;
+        if (i != m_entries.size() - 1) {
+            Entry moved = entry;
+            m_entries.remove(i);
+            m_entries.append(moved);
+        }
+        return SourceCode(provider.release(), firstLine);
+    }
+
+    if (m_entries.size() >= m_capacity)
+        m_entries.remove(0);
+    Entry entry;
+    entry.hash = hash;
+    entry.secondaryHash = secondaryHash;
+    entry.length = length;
+    entry.firstLine = firstLine;
+    entry.isCompressed = compressed;
+    entry.provider = createProvider(source, url, compressed);
+    m_entries.append(entry);
+    return SourceCode(entry.provider, firstLine);
+}
+
+} // namespace JSC
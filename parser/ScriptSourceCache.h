@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ScriptSourceCache_h
+#define ScriptSourceCache_h
+
+#include "SourceCode.h"
+#include "SourceProvider.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+// The providers of the scripts most recently evaluated through the API in one context group,
+// so that every context loading the same script gets the same provider. The text is then held
+// once, and the function boundaries one context finds while parsing are found directly in the
+// provider's cache by the next, without going through the process-wide shared cache.
+class ScriptSourceCache {
+    WTF_MAKE_NONCOPYABLE(ScriptSourceCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit ScriptSourceCache(unsigned capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    // Returns a source over a cached provider of the same text, URL and first line if there is
+    // one, otherwise over a new provider, which is remembered, evicting the least recently used.
+    // Scripts of at least compressedSourceThreshold characters get a CompressedSourceProvider.
+    SourceCode sourceFor(const UString& source, const UString& url, int firstLine, unsigned compressedSourceThreshold);
+
+    void clear() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        unsigned hash;
+        unsigned secondaryHash;
+        unsigned length;
+        int firstLine;
+        bool isCompressed;
+        RefPtr<SourceProvider> provider;
+    };
+
+    // Short snippets are cheap to parse and are the scripts most likely to be unique.
+    static const unsigned minimumCacheableLength = 1024;
+
+    unsigned m_capacity;
+    Vector<Entry> m_entries; // Least recently used first.
+};
+
+} // namespace JSC
+
+#endif // ScriptSourceCache_h
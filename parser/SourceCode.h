@@ -72,7 +72,7 @@ namespace JSC {
         int firstLine() const { return m_firstLine; }
         int startOffset() const { return m_startChar; }
         int endOffset() const { return m_endChar; }
-        const UChar* data() const { return m_provider->data() + m_startChar; }
+        const UChar* data() const { return m_provider->dataForRange(m_startChar, m_endChar) + m_startChar; }
         int length() const { return m_endChar - m_startChar; }
 
     private:
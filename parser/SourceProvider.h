@@ -55,8 +55,17 @@ namespace JSC {
         }
 
         virtual UString getRange(int start, int end) const = 0;
+        // Source is always exposed as UTF-16. The Lexer and LiteralParser are written against
+        // UChar, and UString has no 8-bit representation to hand a narrower buffer back through
+        // getRange(), so an 8-bit provider would have to widen its whole buffer for every parse,
+        // including each lazy function compile, costing more than it saves.
         virtual const UChar* data() const = 0;
+        // Same buffer as data(), but only the characters in [start, end] need to be valid.
+        // Providers that keep their text compressed use this to avoid unpacking all of it.
+        virtual const UChar* dataForRange(int start, int end) const { UNUSED_PARAM(start); UNUSED_PARAM(end); return data(); }
         virtual int length() const = 0;
+        // The memory the provider holds for its text, in bytes.
+        virtual size_t sizeInMemory() const { return length() * sizeof(UChar); }
         
         const UString& url() { return m_url; }
         virtual TextPosition1 startPosition() const { return TextPosition1::minimumPosition(); }
@@ -67,6 +76,12 @@ namespace JSC {
 
         SourceProviderCache* cache() const { return m_cache; }
         void notifyCacheSizeChanged(int delta) { if (!m_cacheOwned) cacheSizeChanged(delta); }
+        void clearCache()
+        {
+            int oldSize = m_cache->byteSize();
+            m_cache->clear();
+            notifyCacheSizeChanged(m_cache->byteSize() - oldSize);
+        }
         
     private:
         virtual void cacheSizeChanged(int delta) { UNUSED_PARAM(delta); }
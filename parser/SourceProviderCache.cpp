@@ -26,10 +26,101 @@
 #include "config.h"
 #include "SourceProviderCache.h"
 
+#include "Identifier.h"
 #include "SourceProviderCacheItem.h"
+#include <JSSettingsEA.h>
+#include <wtf/StdLibExtras.h>
+#include <wtf/StringHasher.h>
+#include <wtf/Threading.h>
 
 namespace JSC {
 
+// Function boundaries recorded by one provider, kept with plain (non-identifier) strings
+// so that they do not belong to any thread's identifier table.
+struct SharedFunctionInfo {
+    int closeBraceLine;
+    int closeBracePos;
+    bool usesEval;
+    Vector<String> usedVariables;
+    Vector<String> writtenVariables;
+};
+
+struct SharedSourceEntry {
+    unsigned hash;
+    unsigned secondaryHash;
+    unsigned length;
+    int firstLine;
+    unsigned byteSize;
+    HashMap<int, SharedFunctionInfo*> functions;
+};
+
+static Vector<SharedSourceEntry*>& sharedSourceEntries()
+{
+    DEFINE_STATIC_LOCAL(Vector<SharedSourceEntry*>, entries, ());
+    return entries;
+}
+
+static size_t sharedSourceCacheByteSize = 0;
+
+static Mutex& sharedSourceCacheMutex()
+{
+    DEFINE_STATIC_LOCAL(Mutex, mutex, ());
+    return mutex;
+}
+
+static SharedSourceEntry* findSharedSourceEntry(unsigned hash, unsigned secondaryHash, unsigned length, int firstLine)
+{
+    Vector<SharedSourceEntry*>& entries = sharedSourceEntries();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        SharedSourceEntry* entry = entries[i];
+        if (entry->hash == hash && entry->secondaryHash == secondaryHash && entry->length == length && entry->firstLine == firstLine)
+            return entry;
+    }
+    return 0;
+}
+
+static void deleteSharedSourceEntry(SharedSourceEntry* entry)
+{
+    ASSERT(sharedSourceCacheByteSize >= entry->byteSize);
+    sharedSourceCacheByteSize -= entry->byteSize;
+    deleteAllValues(entry->functions);
+    delete entry;
+}
+
+// Entries are evicted oldest source first; an entry is never evicted to make room for itself.
+static void evictSharedSourceEntries(size_t budget, SharedSourceEntry* keep)
+{
+    Vector<SharedSourceEntry*>& entries = sharedSourceEntries();
+    size_t i = 0;
+    while (sharedSourceCacheByteSize > budget && i < entries.size()) {
+        if (entries[i] == keep) {
+            ++i;
+            continue;
+        }
+        deleteSharedSourceEntry(entries[i]);
+        entries.remove(i);
+    }
+}
+
+static void copyToPlainStrings(const Vector<RefPtr<StringImpl> >& identifiers, Vector<String>& strings)
+{
+    strings.reserveInitialCapacity(identifiers.size());
+    for (size_t i = 0; i < identifiers.size(); ++i)
+        strings.uncheckedAppend(String(identifiers[i]->characters(), identifiers[i]->length()));
+}
+
+static void copyToIdentifiers(JSGlobalData* globalData, const Vector<String>& strings, Vector<RefPtr<StringImpl> >& identifiers)
+{
+    identifiers.reserveInitialCapacity(strings.size());
+    for (size_t i = 0; i < strings.size(); ++i)
+        identifiers.uncheckedAppend(Identifier(globalData, strings[i].characters(), strings[i].length()).impl());
+}
+
+void SourceProviderCache::initializeThreading()
+{
+    sharedSourceCacheMutex();
+}
+
 SourceProviderCache::~SourceProviderCache()
 {
     clear();
@@ -49,8 +140,79 @@ unsigned SourceProviderCache::byteSize() const
 
 void SourceProviderCache::add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem> item, unsigned size)
 {
+    if (m_isShared)
+        addToSharedCache(sourcePosition, *item, size);
     m_map.add(sourcePosition, item.leakPtr());
     m_contentByteSize += size;
 }
 
+void SourceProviderCache::attachToSharedCache(JSGlobalData* globalData, const UChar* source, unsigned length, int firstLine)
+{
+    if (m_isShared || !JSGetSharedSourceCacheSize())
+        return;
+
+    // The text is identified by two unrelated hashes and its length, so that a collision
+    // cannot hand the parser wrong function boundaries in any realistic workload.
+    m_sharedHash = StringHasher::computeHash<UChar>(source, length);
+    unsigned secondaryHash = 2166136261u;
+    for (unsigned i = 0; i < length; ++i)
+        secondaryHash = (secondaryHash ^ source[i]) * 16777619u;
+    m_sharedSecondaryHash = secondaryHash;
+    m_sharedLength = length;
+    m_sharedFirstLine = firstLine;
+    m_isShared = true;
+
+    MutexLocker locker(sharedSourceCacheMutex());
+    SharedSourceEntry* entry = findSharedSourceEntry(m_sharedHash, m_sharedSecondaryHash, m_sharedLength, m_sharedFirstLine);
+    if (!entry)
+        return;
+
+    HashMap<int, SharedFunctionInfo*>::const_iterator end = entry->functions.end();
+    for (HashMap<int, SharedFunctionInfo*>::const_iterator it = entry->functions.begin(); it != end; ++it) {
+        if (m_map.contains(it->first))
+            continue;
+        const SharedFunctionInfo* info = it->second;
+        OwnPtr<SourceProviderCacheItem> item = adoptPtr(new SourceProviderCacheItem(info->closeBraceLine, info->closeBracePos));
+        item->usesEval = info->usesEval;
+        copyToIdentifiers(globalData, info->usedVariables, item->usedVariables);
+        copyToIdentifiers(globalData, info->writtenVariables, item->writtenVariables);
+        m_contentByteSize += item->approximateByteSize();
+        m_map.add(it->first, item.leakPtr());
+    }
+}
+
+void SourceProviderCache::addToSharedCache(int sourcePosition, const SourceProviderCacheItem& item, unsigned size)
+{
+    size_t budget = JSGetSharedSourceCacheSize();
+    if (size > budget)
+        return;
+
+    MutexLocker locker(sharedSourceCacheMutex());
+    SharedSourceEntry* entry = findSharedSourceEntry(m_sharedHash, m_sharedSecondaryHash, m_sharedLength, m_sharedFirstLine);
+    if (!entry) {
+        entry = new SharedSourceEntry;
+        entry->hash = m_sharedHash;
+        entry->secondaryHash = m_sharedSecondaryHash;
+        entry->length = m_sharedLength;
+        entry->firstLine = m_sharedFirstLine;
+        entry->byteSize = 0;
+        sharedSourceEntries().append(entry);
+    } else if (entry->functions.contains(sourcePosition))
+        return;
+    if (entry->byteSize + size > budget)
+        return;
+
+    SharedFunctionInfo* info = new SharedFunctionInfo;
+    info->closeBraceLine = item.closeBraceLine;
+    info->closeBracePos = item.closeBracePos;
+    info->usesEval = item.usesEval;
+    copyToPlainStrings(item.usedVariables, info->usedVariables);
+    copyToPlainStrings(item.writtenVariables, info->writtenVariables);
+    entry->functions.add(sourcePosition, info);
+    entry->byteSize += size;
+    sharedSourceCacheByteSize += size;
+
+    evictSharedSourceEntries(budget, entry);
+}
+
 }
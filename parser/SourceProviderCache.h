@@ -23,16 +23,25 @@
  * THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifndef SourceProviderCache_h
+#define SourceProviderCache_h
+
 #include <wtf/HashMap.h>
 #include <wtf/PassOwnPtr.h>
+#include <wtf/unicode/Unicode.h>
 
 namespace JSC {
 
+class JSGlobalData;
 class SourceProviderCacheItem;
 
 class SourceProviderCache {
 public:
-    SourceProviderCache() : m_contentByteSize(0) {}
+    SourceProviderCache()
+        : m_contentByteSize(0)
+        , m_isShared(false)
+    {
+    }
     JS_EXPORT_PRIVATE ~SourceProviderCache();
 
     JS_EXPORT_PRIVATE void clear();
@@ -40,9 +49,25 @@ public:
     void add(int sourcePosition, PassOwnPtr<SourceProviderCacheItem>, unsigned size);
     const SourceProviderCacheItem* get(int sourcePosition) const { return m_map.get(sourcePosition); }
 
+    // Links this cache to the process-wide cache of function boundaries for sources with
+    // identical text and first line, which is bounded by JSSetSharedSourceCacheSize().
+    // Entries other providers have recorded are copied in, and entries added here from
+    // now on are recorded for the next provider of the same source.
+    void attachToSharedCache(JSGlobalData*, const UChar* source, unsigned length, int firstLine);
+    static void initializeThreading();
+
 private:
+    void addToSharedCache(int sourcePosition, const SourceProviderCacheItem&, unsigned size);
+
     HashMap<int, SourceProviderCacheItem*> m_map;
     unsigned m_contentByteSize;
+    bool m_isShared;
+    unsigned m_sharedHash;
+    unsigned m_sharedSecondaryHash;
+    unsigned m_sharedLength;
+    int m_sharedFirstLine;
 };
 
 }
+
+#endif // SourceProviderCache_h
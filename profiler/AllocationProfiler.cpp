@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AllocationProfiler.h"
+
+#include "CallFrame.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Heap.h"
+#include "JSGlobalData.h"
+#include "Profiler.h"
+#include "UStringBuilder.h"
+
+namespace JSC {
+
+AllocationProfiler::AllocationProfiler(unsigned sampleInterval)
+    : m_sampleInterval(sampleInterval ? sampleInterval : 1)
+    , m_sampleCount(0)
+{
+}
+
+// The line of the call in callFrame that made calleeFrame, or -1.
+static int callSiteLineNumber(CallFrame* callFrame, CallFrame* calleeFrame)
+{
+    CodeBlock* codeBlock = callFrame->codeBlock();
+    if (!codeBlock)
+        return -1;
+#if ENABLE(JIT)
+    if (callFrame->globalData().canUseJIT())
+        return codeBlock->lineNumberForCallReturnLocation(calleeFrame->returnPC().value());
+#endif
+#if ENABLE(INTERPRETER)
+    Instruction* returnVPC = calleeFrame->returnVPC();
+    Vector<Instruction>& instructions = codeBlock->instructions();
+    if (returnVPC > instructions.begin() && returnVPC <= instructions.end())
+        return codeBlock->lineNumberForBytecodeOffset(returnVPC - instructions.begin() - 1);
+#endif
+    return -1;
+}
+
+void AllocationProfiler::sample(ExecState* topCallFrame, void* allocation, size_t bytes, Kind kind, bool checksSurvival)
+{
+    m_stack.shrink(0);
+    CallFrame* calleeFrame = 0;
+    for (CallFrame* callFrame = topCallFrame->removeHostCallFrameFlag(); callFrame && m_stack.size() < maxStackDepth; callFrame = callFrame->callerFrame()->removeHostCallFrameFlag()) {
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        if (!codeBlock) {
+            m_stack.append(Profiler::createCallIdentifier(callFrame, callFrame->callee(), UString(), 0));
+            calleeFrame = callFrame;
+            continue;
+        }
+        int lineNumber = calleeFrame ? callSiteLineNumber(callFrame, calleeFrame) : -1;
+        if (lineNumber < 0)
+            lineNumber = codeBlock->ownerExecutable()->lineNo();
+        CallIdentifier identifier = Profiler::createCallIdentifier(callFrame, callFrame->callee(), codeBlock->ownerExecutable()->sourceURL(), lineNumber);
+        identifier.m_lineNumber = lineNumber;
+        m_stack.append(identifier);
+        calleeFrame = callFrame;
+    }
+
+    size_t siteIndex = siteFor(kind);
+    Site& site = m_sites[siteIndex];
+    ++site.sampleCount;
+    site.sampledBytes += bytes;
+    ++m_sampleCount;
+
+    if (kind == CellAllocation && checksSurvival) {
+        PendingSample pendingSample = { static_cast<JSCell*>(allocation), siteIndex };
+        m_pendingSamples.append(pendingSample);
+    }
+}
+
+size_t AllocationProfiler::siteFor(Kind kind)
+{
+    UStringBuilder key;
+    key.append(kind == CellAllocation ? 'c' : 's');
+    for (size_t i = 0; i < m_stack.size(); ++i) {
+        key.append('\n');
+        key.append(m_stack[i].m_name);
+        key.append('\t');
+        key.append(m_stack[i].m_url);
+        key.append('\t');
+        key.append(UString::number(m_stack[i].m_lineNumber));
+    }
+
+    pair<HashMap<String, size_t>::iterator, bool> result = m_siteIndices.add(key.toString(), m_sites.size());
+    if (result.second) {
+        Site site;
+        site.kind = kind;
+        site.stack.append(m_stack.data(), m_stack.size());
+        site.sampleCount = 0;
+        site.sampledBytes = 0;
+        site.checkedCount = 0;
+        site.survivorCount = 0;
+        m_sites.append(site);
+    }
+    return result.first->second;
+}
+
+void AllocationProfiler::didCollect()
+{
+    // Every pending cell was allocated since the previous collection, so its
+    // mark bit says whether it survived this one.
+    for (size_t i = 0; i < m_pendingSamples.size(); ++i) {
+        Site& site = m_sites[m_pendingSamples[i].site];
+        ++site.checkedCount;
+        if (Heap::isMarked(m_pendingSamples[i].cell))
+            ++site.survivorCount;
+    }
+    m_pendingSamples.shrink(0);
+}
+
+} // namespace JSC
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef AllocationProfiler_h
+#define AllocationProfiler_h
+
+#include "CallIdentifier.h"
+#include <wtf/HashMap.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringHash.h>
+
+namespace JSC {
+
+    class ExecState;
+    class JSCell;
+
+    // Attributes heap allocations to the JavaScript that made them. The heap
+    // hands every sampleInterval-th allocation of a cell or of nursery property
+    // storage to sample(), which records the innermost frames of the stack at
+    // JSGlobalData::topCallFrame. The innermost frame's line is where its
+    // function starts, since the allocating bytecode isn't known to the heap;
+    // each outer frame's line is that of its call to the frame inside it, when
+    // the call return table says so. Samples are merged by kind and stack.
+    //
+    // After every collection, the cell samples taken since the previous one are
+    // checked for survival. Cells allocated while incremental marking runs start
+    // out marked, so they aren't checked. Property storage is copied out of the
+    // nursery rather than marked, so it has no survival count. Cells the JIT
+    // allocates inline don't reach the heap's allocate() and aren't sampled.
+    class AllocationProfiler {
+        WTF_MAKE_NONCOPYABLE(AllocationProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        enum Kind { CellAllocation, PropertyStorageAllocation };
+        static const size_t maxStackDepth = 4;
+
+        struct Site {
+            Kind kind;
+            Vector<CallIdentifier> stack; // Innermost frame first; empty for allocations made outside JavaScript.
+            size_t sampleCount;
+            size_t sampledBytes;
+            size_t checkedCount; // Samples whose survival of the next collection is known.
+            size_t survivorCount;
+        };
+
+        explicit AllocationProfiler(unsigned sampleInterval);
+
+        unsigned sampleInterval() const { return m_sampleInterval; }
+        size_t sampleCount() const { return m_sampleCount; }
+        const Vector<Site>& sites() const { return m_sites; }
+
+        // Must not allocate from the heap, since the heap calls it part way
+        // through an allocation.
+        void sample(ExecState* topCallFrame, void* allocation, size_t bytes, Kind, bool checksSurvival);
+        void didCollect();
+
+    private:
+        size_t siteFor(Kind);
+
+        struct PendingSample {
+            JSCell* cell;
+            size_t site;
+        };
+
+        unsigned m_sampleInterval;
+        size_t m_sampleCount;
+        Vector<Site> m_sites;
+        HashMap<String, size_t> m_siteIndices;
+        Vector<PendingSample> m_pendingSamples;
+        Vector<CallIdentifier, maxStackDepth> m_stack;
+    };
+
+} // namespace JSC
+
+#endif // AllocationProfiler_h
@@ -31,29 +31,18 @@
 
 #include "Profiler.h"
 #include <stdio.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/DateMath.h>
 #include <wtf/text/StringHash.h>
 
-#if OS(WINDOWS)
-#include <windows.h>
-#endif
-
 using namespace WTF;
 
 namespace JSC {
 
+// Milliseconds from a clock that wall-clock adjustments cannot move backwards.
 static double getCount()
 {
-#if OS(WINDOWS)
-    static LARGE_INTEGER frequency;
-    if (!frequency.QuadPart)
-        QueryPerformanceFrequency(&frequency);
-    LARGE_INTEGER counter;
-    QueryPerformanceCounter(&counter);
-    return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
-#else
-    return currentTimeMS();
-#endif
+    return monotonicallyIncreasingTime() * 1000.0;
 }
 
 ProfileNode::ProfileNode(ExecState* callerCallFrame, const CallIdentifier& callIdentifier, ProfileNode* headNode, ProfileNode* parentNode)
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SamplingProfiler.h"
+
+#include "CallFrame.h"
+#include "CodeBlock.h"
+#include "Executable.h"
+#include "Interpreter.h"
+#include "JSGlobalData.h"
+#include "ProfileNode.h"
+#include "Profiler.h"
+
+namespace JSC {
+
+static unsigned SampledProfilesUID = 0;
+
+SamplingProfiler::SamplingProfiler(const UString& title, unsigned samplingInterval)
+    : m_profile(Profile::create(title, ++SampledProfilesUID))
+    , m_samplingInterval(samplingInterval ? samplingInterval : 1)
+    , m_sampleCount(0)
+    , m_samplesWithDFGCodeOnStack(0)
+{
+    memset(m_opcodeSamples, 0, sizeof(m_opcodeSamples));
+}
+
+static ProfileNode* childForCallIdentifier(ProfileNode* head, ProfileNode* parent, const CallIdentifier& callIdentifier)
+{
+    const Vector<RefPtr<ProfileNode> >& children = parent->children();
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i]->callIdentifier() == callIdentifier)
+            return children[i].get();
+    }
+
+    RefPtr<ProfileNode> child = ProfileNode::create(0, callIdentifier, head, parent);
+    parent->addChild(child);
+    return child.get();
+}
+
+void SamplingProfiler::sampleOpcode(ExecState* exec, const TimeoutCheckSite& site)
+{
+    CodeBlock* codeBlock = exec->codeBlock();
+    if (!site.isKnown || !codeBlock || site.bytecodeOffset >= codeBlock->instructions().size())
+        return;
+
+    Tier tier = InterpreterTier;
+    if (!site.inInterpreter)
+        tier = codeBlock->getJITType() == JITCode::DFGJIT ? DFGJITTier : BaselineJITTier;
+    OpcodeID opcodeID = exec->globalData().interpreter->getOpcodeID(codeBlock->instructions()[site.bytecodeOffset].u.opcode);
+    ++m_opcodeSamples[opcodeID][tier];
+}
+
+void SamplingProfiler::takeSample(ExecState* exec, unsigned elapsedTime, const TimeoutCheckSite& site)
+{
+    sampleOpcode(exec, site);
+
+    // Record the stack innermost first, the way the frames are linked, then
+    // replay it outermost first so the tree is rooted at the entry point.
+    m_callStack.shrink(0);
+    bool sawDFGCode = false;
+    for (CallFrame* callFrame = exec; callFrame; callFrame = callFrame->callerFrame()->removeHostCallFrameFlag()) {
+        CodeBlock* codeBlock = callFrame->codeBlock();
+        if (codeBlock && codeBlock->getJITType() == JITCode::DFGJIT)
+            sawDFGCode = true;
+        if (codeBlock)
+            m_callStack.append(Profiler::createCallIdentifier(callFrame, callFrame->callee(), codeBlock->ownerExecutable()->sourceURL(), codeBlock->ownerExecutable()->lineNo()));
+        else
+            m_callStack.append(Profiler::createCallIdentifier(callFrame, callFrame->callee(), UString(), 0));
+    }
+
+    if (m_callStack.isEmpty())
+        return;
+    if (sawDFGCode)
+        ++m_samplesWithDFGCodeOnStack;
+
+    ProfileNode* head = m_profile->head();
+    head->setTotalTime(head->actualTotalTime() + elapsedTime);
+
+    ProfileNode* node = head;
+    for (size_t i = m_callStack.size(); i--; ) {
+        node = childForCallIdentifier(head, node, m_callStack[i]);
+        node->setTotalTime(node->actualTotalTime() + elapsedTime);
+    }
+    node->setSelfTime(node->actualSelfTime() + elapsedTime);
+    node->setNumberOfCalls(node->numberOfCalls() + 1);
+
+    ++m_sampleCount;
+}
+
+} // namespace JSC
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SamplingProfiler_h
+#define SamplingProfiler_h
+
+#include "CallIdentifier.h"
+#include "Opcode.h"
+#include "Profile.h"
+#include "TimeoutChecker.h"
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+    class ExecState;
+
+    // Builds a Profile by periodically recording the call frame chain, instead
+    // of instrumenting every call the way ProfileGenerator does. Samples are
+    // taken from the TimeoutChecker, so they land on the same safe points the
+    // watchdog uses (loop back edges and the interpreter's timeout checks) and
+    // cost nothing while no sampling profile is running. Each sample charges
+    // the CPU time elapsed since the previous one to every function on the
+    // stack, and to the innermost function's self time; numberOfCalls() on a
+    // node counts the samples in which it was the innermost function.
+    //
+    // When the check says where it was made, the sample is also counted against
+    // the opcode being run and the tier running it. Optimized (DFG) code makes no
+    // checks of its own, so its time shows in samplesWithDFGCodeOnStack() and in
+    // the opcodes of the baseline code it calls.
+    class SamplingProfiler {
+        WTF_MAKE_NONCOPYABLE(SamplingProfiler); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        enum Tier { InterpreterTier, BaselineJITTier, DFGJITTier, NumberOfTiers };
+
+        SamplingProfiler(const UString& title, unsigned samplingInterval);
+
+        // Milliseconds of CPU time the TimeoutChecker aims for between samples.
+        unsigned samplingInterval() const { return m_samplingInterval; }
+        unsigned sampleCount() const { return m_sampleCount; }
+        Profile* profile() const { return m_profile.get(); }
+        unsigned opcodeSampleCount(OpcodeID opcodeID, Tier tier) const { return m_opcodeSamples[opcodeID][tier]; }
+        unsigned samplesWithDFGCodeOnStack() const { return m_samplesWithDFGCodeOnStack; }
+
+        void takeSample(ExecState*, unsigned elapsedTime, const TimeoutCheckSite&);
+
+    private:
+        void sampleOpcode(ExecState*, const TimeoutCheckSite&);
+
+        RefPtr<Profile> m_profile;
+        unsigned m_samplingInterval;
+        unsigned m_sampleCount;
+        unsigned m_samplesWithDFGCodeOnStack;
+        unsigned m_opcodeSamples[numOpcodeIDs][NumberOfTiers];
+        Vector<CallIdentifier, 32> m_callStack;
+    };
+
+} // namespace JSC
+
+#endif // SamplingProfiler_h
@@ -50,7 +50,7 @@ namespace JSC {
         WriteBarrier<Unknown> extraArgumentsFixedBuffer[4];
 
         WriteBarrier<JSFunction> callee;
-        bool overrodeLength : 1;
+        bool overrodeLength; // Not a bit field, so that the JIT can test it.
         bool overrodeCallee : 1;
         bool overrodeCaller : 1;
         bool isStrictMode : 1;
@@ -116,6 +116,9 @@ namespace JSC {
             return Structure::create(globalData, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), &s_info); 
         }
 
+        // The JIT reads indexed arguments and the length straight out of the ArgumentsData.
+        static ptrdiff_t offsetOfData() { return OBJECT_OFFSETOF(Arguments, d); }
+
     protected:
         static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesVisitChildren | OverridesGetPropertyNames | JSObject::StructureFlags;
 
@@ -269,6 +269,72 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncToLocaleString(ExecState* exec)
     return JSValue::encode(strBuffer.build(exec));
 }
 
+// Joins a dense array whose elements are all strings, numbers, undefined or null, none of which
+// can run script when converted. The result is measured first, so it is allocated exactly once,
+// and string elements are copied straight out of their ropes. Returns an empty value when the
+// array doesn't qualify, leaving the caller to join it generically.
+static JSValue joinDenseArray(ExecState* exec, JSArray* array, unsigned length, const UString& separator)
+{
+    static const unsigned maximumJoinLength = static_cast<unsigned>(std::numeric_limits<int32_t>::max());
+
+    UChar comma = ',';
+    const UChar* separatorCharacters = separator.isNull() ? &comma : separator.characters();
+    unsigned separatorLength = separator.isNull() ? 1 : separator.length();
+
+    Vector<UString, 16> numberStrings;
+    unsigned joinedLength = 0;
+    for (unsigned k = 0; k < length; ++k) {
+        if (!array->canGetIndex(k))
+            return JSValue();
+        JSValue element = array->getIndex(k);
+        unsigned elementLength;
+        if (element.isString())
+            elementLength = asString(element)->length();
+        else if (element.isNumber()) {
+            numberStrings.append(element.toString(exec));
+            elementLength = numberStrings.last().length();
+        } else if (element.isUndefinedOrNull())
+            elementLength = 0;
+        else
+            return JSValue();
+        if (k)
+            elementLength += separatorLength;
+        if (elementLength > maximumJoinLength - joinedLength)
+            return JSValue();
+        joinedLength += elementLength;
+    }
+
+    if (!joinedLength)
+        return jsEmptyString(exec);
+
+    UChar* buffer;
+    RefPtr<StringImpl> joined = StringImpl::tryCreateUninitialized(joinedLength, buffer);
+    if (!joined)
+        return throwOutOfMemoryError(exec);
+
+    UChar* position = buffer;
+    size_t numberIndex = 0;
+    for (unsigned k = 0; k < length; ++k) {
+        if (k) {
+            StringImpl::copyChars(position, separatorCharacters, separatorLength);
+            position += separatorLength;
+        }
+        JSValue element = array->getIndex(k);
+        if (element.isString()) {
+            JSString* string = asString(element);
+            string->copyCharacters(position);
+            position += string->length();
+        } else if (element.isNumber()) {
+            const UString& number = numberStrings[numberIndex++];
+            StringImpl::copyChars(position, number.characters(), number.length());
+            position += number.length();
+        }
+    }
+    ASSERT(position == buffer + joinedLength);
+
+    return jsString(exec, UString(joined.release()));
+}
+
 EncodedJSValue JSC_HOST_CALL arrayProtoFuncJoin(ExecState* exec)
 {
     JSObject* thisObj = exec->hostThisValue().toThisObject(exec);
@@ -290,6 +356,9 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncJoin(ExecState* exec)
     if (isJSArray(&exec->globalData(), thisObj)) {
         JSArray* array = asArray(thisObj);
 
+        if (JSValue joined = joinDenseArray(exec, array, length, separator))
+            return JSValue::encode(joined);
+
         if (length) {
             if (!array->canGetIndex(k)) 
                 goto skipFirstLoop;
@@ -690,8 +759,10 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncFilter(ExecState* exec)
             cachedCall.setArgument(2, thisObj);
             
             JSValue result = cachedCall.call();
-            if (result.toBoolean(exec))
-                resultArray->put(exec, filterIndex++, v);
+            if (result.toBoolean(exec)) {
+                resultArray->push(exec, v);
+                ++filterIndex;
+            }
         }
         if (k == length)
             return JSValue::encode(resultArray);
@@ -1093,6 +1164,46 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncReduceRight(ExecState* exec)
     return JSValue::encode(rv);        
 }
 
+// Compares array elements against the search value of indexOf/lastIndexOf with the type
+// dispatch of JSValue::strictEqual done once up front.
+class StrictEqualMatcher {
+public:
+    StrictEqualMatcher(ExecState* exec, JSValue searchElement)
+        : m_exec(exec)
+        , m_searchElement(searchElement)
+        , m_searchNumber(0)
+    {
+        if (searchElement.isNumber()) {
+            m_kind = MatchNumber;
+            m_searchNumber = searchElement.uncheckedGetNumber();
+        } else if (searchElement.isString())
+            m_kind = MatchString;
+        else
+            m_kind = MatchIdentity;
+    }
+
+    bool matches(JSValue element) const
+    {
+        switch (m_kind) {
+        case MatchNumber:
+            return element.isNumber() && element.uncheckedGetNumber() == m_searchNumber;
+        case MatchString:
+            return element.isString() && JSValue::strictEqual(m_exec, m_searchElement, element);
+        case MatchIdentity:
+            break;
+        }
+        return element == m_searchElement;
+    }
+
+private:
+    enum Kind { MatchNumber, MatchString, MatchIdentity };
+
+    ExecState* m_exec;
+    JSValue m_searchElement;
+    double m_searchNumber;
+    Kind m_kind;
+};
+
 EncodedJSValue JSC_HOST_CALL arrayProtoFuncIndexOf(ExecState* exec)
 {
     // 15.4.4.14
@@ -1103,6 +1214,18 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncIndexOf(ExecState* exec)
 
     unsigned index = argumentClampedIndexFromStartOrEnd(exec, 1, length);
     JSValue searchElement = exec->argument(0);
+
+    // Read the vector directly up to the first hole; a hole may be filled from the prototype
+    // chain, so the generic loop takes over from there.
+    if (isJSArray(&exec->globalData(), thisObj)) {
+        JSArray* array = asArray(thisObj);
+        StrictEqualMatcher matcher(exec, searchElement);
+        for (; index < length && array->canGetIndex(index); ++index) {
+            if (matcher.matches(array->getIndex(index)))
+                return JSValue::encode(jsNumber(index));
+        }
+    }
+
     for (; index < length; ++index) {
         JSValue e = getProperty(exec, thisObj, index);
         if (!e)
@@ -1136,6 +1259,19 @@ EncodedJSValue JSC_HOST_CALL arrayProtoFuncLastIndexOf(ExecState* exec)
     }
 
     JSValue searchElement = exec->argument(0);
+
+    if (isJSArray(&exec->globalData(), thisObj)) {
+        JSArray* array = asArray(thisObj);
+        StrictEqualMatcher matcher(exec, searchElement);
+        while (array->canGetIndex(index)) {
+            if (matcher.matches(array->getIndex(index)))
+                return JSValue::encode(jsNumber(index));
+            if (!index)
+                return JSValue::encode(jsNumber(-1));
+            --index;
+        }
+    }
+
     do {
         ASSERT(index < length);
         JSValue e = getProperty(exec, thisObj, index);
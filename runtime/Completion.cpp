@@ -64,6 +64,14 @@ JSValue evaluate(ExecState* exec, ScopeChainNode* scopeChain, const SourceCode&
         return jsUndefined();
     }
 
+    return evaluate(exec, scopeChain, program, thisValue, returnedException);
+}
+
+JSValue evaluate(ExecState* exec, ScopeChainNode* scopeChain, ProgramExecutable* program, JSValue thisValue, JSValue* returnedException)
+{
+    JSLock lock(exec);
+    ASSERT(exec->globalData().identifierTable == wtfThreadData().currentIdentifierTable());
+
     if (!thisValue || thisValue.isUndefinedOrNull())
         thisValue = exec->dynamicGlobalObject();
     JSObject* thisObj = thisValue.toThisObject(exec);
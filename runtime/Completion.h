@@ -28,11 +28,14 @@
 namespace JSC {
 
     class ExecState;
+    class ProgramExecutable;
     class ScopeChainNode;
     class SourceCode;
 
     bool checkSyntax(ExecState*, const SourceCode&, JSValue* exception = 0);
     JSValue evaluate(ExecState*, ScopeChainNode*, const SourceCode&, JSValue thisValue = JSValue(), JSValue* exception = 0);
+    // Runs a program that may already have been compiled for scopeChain's global object.
+    JSValue evaluate(ExecState*, ScopeChainNode*, ProgramExecutable*, JSValue thisValue = JSValue(), JSValue* exception = 0);
 
 } // namespace JSC
 
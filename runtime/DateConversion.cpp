@@ -47,19 +47,115 @@
 #include "JSObject.h"
 #include "ScopeChain.h"
 #include "UString.h"
+#include <wtf/ASCIICType.h>
 #include <wtf/DateMath.h>
 #include <wtf/StringExtras.h>
 #include <wtf/text/CString.h>
+#include <limits>
 
 using namespace WTF;
 
 namespace JSC {
 
+static inline bool parseDigits(const UChar* characters, unsigned count, int& result)
+{
+    int value = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        if (!isASCIIDigit(characters[i]))
+            return false;
+        value = value * 10 + (characters[i] - '0');
+    }
+    result = value;
+    return true;
+}
+
+// Days from 1970-01-01 to the given proleptic Gregorian date, in integer
+// arithmetic, counting years from March so that leap days fall at the end.
+static inline int daysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Parses the common YYYY-MM-DDTHH:mm:ss[.s[s[s]]](Z|+hh:mm|-hh:mm) form of
+// ECMA-262-5 15.9.1.15, as produced by toISOString and JSON.stringify,
+// straight from the string's characters. Anything else, including the
+// extended years and longer fractions parseES5DateFromNullTerminatedCharacters
+// accepts, returns NaN so that the general parsers see it; for the forms
+// parsed here the result is the same.
+static double parseISODateTime(const UChar* characters, unsigned length)
+{
+    static const int daysPerMonth[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+    if (length < 20 || characters[4] != '-' || characters[7] != '-' || characters[10] != 'T' || characters[13] != ':' || characters[16] != ':')
+        return std::numeric_limits<double>::quiet_NaN();
+
+    int year, month, day, hours, minutes, seconds;
+    if (!parseDigits(characters, 4, year) || !parseDigits(characters + 5, 2, month) || !parseDigits(characters + 8, 2, day)
+        || !parseDigits(characters + 11, 2, hours) || !parseDigits(characters + 14, 2, minutes) || !parseDigits(characters + 17, 2, seconds))
+        return std::numeric_limits<double>::quiet_NaN();
+
+    unsigned position = 19;
+    int milliseconds = 0;
+    if (characters[position] == '.') {
+        ++position;
+        unsigned fractionDigits = 0;
+        while (position < length && isASCIIDigit(characters[position]) && fractionDigits < 4) {
+            milliseconds = milliseconds * 10 + (characters[position] - '0');
+            ++position;
+            ++fractionDigits;
+        }
+        if (!fractionDigits || fractionDigits > 3)
+            return std::numeric_limits<double>::quiet_NaN();
+        for (; fractionDigits < 3; ++fractionDigits)
+            milliseconds *= 10;
+    }
+
+    int timeZoneMinutes = 0;
+    if (position < length && characters[position] == 'Z')
+        ++position;
+    else if (position + 6 <= length && (characters[position] == '+' || characters[position] == '-') && characters[position + 3] == ':') {
+        int timeZoneHours;
+        if (!parseDigits(characters + position + 1, 2, timeZoneHours) || !parseDigits(characters + position + 4, 2, timeZoneMinutes))
+            return std::numeric_limits<double>::quiet_NaN();
+        if (timeZoneHours > 24 || timeZoneMinutes > 59)
+            return std::numeric_limits<double>::quiet_NaN();
+        timeZoneMinutes += timeZoneHours * 60;
+        if (characters[position] == '-')
+            timeZoneMinutes = -timeZoneMinutes;
+        position += 6;
+    } else
+        return std::numeric_limits<double>::quiet_NaN();
+    if (position != length)
+        return std::numeric_limits<double>::quiet_NaN();
+
+    if (month < 1 || month > 12 || day < 1 || day > daysPerMonth[month - 1])
+        return std::numeric_limits<double>::quiet_NaN();
+    if (month == 2 && day > 28 && !(!(year % 4) && ((year % 100) || !(year % 400))))
+        return std::numeric_limits<double>::quiet_NaN();
+    if (hours > 24 || (hours == 24 && (minutes || seconds || milliseconds)) || minutes > 59 || seconds > 60)
+        return std::numeric_limits<double>::quiet_NaN();
+    if (seconds == 60) {
+        // Discard leap seconds by clamping to the end of a minute, as the general parser does.
+        milliseconds = 0;
+    }
+
+    long long totalSeconds = static_cast<long long>(daysFromCivil(year, month, day)) * 86400
+        + hours * 3600 + (minutes - timeZoneMinutes) * 60 + seconds;
+    return static_cast<double>(totalSeconds * 1000 + milliseconds);
+}
+
 double parseDate(ExecState* exec, const UString &date)
 {
     if (date == exec->globalData().cachedDateString)
         return exec->globalData().cachedDateStringValue;
-    double value = parseES5DateFromNullTerminatedCharacters(date.utf8().data());
+    double value = parseISODateTime(date.characters(), date.length());
+    if (isnan(value))
+        value = parseES5DateFromNullTerminatedCharacters(date.utf8().data());
     if (isnan(value))
         value = parseDateFromNullTerminatedCharacters(exec, date.utf8().data());
     exec->globalData().cachedDateString = date;
@@ -26,6 +26,7 @@
 
 #include "ConstructData.h"
 #include "ErrorConstructor.h"
+#include "ErrorInstance.h"
 #include "JSFunction.h"
 #include "JSGlobalObject.h"
 #include "JSObject.h"
@@ -116,10 +117,10 @@ JSObject* createURIError(ExecState* exec, const UString& message)
     return createURIError(exec->lexicalGlobalObject(), message);
 }
 
-JSObject* addErrorInfo(JSGlobalData* globalData, JSObject* error, int line, const SourceCode& source)
+void putErrorInfo(JSGlobalData* globalData, JSObject* error, int line, SourceProvider* provider)
 {
-    intptr_t sourceID = source.provider()->asID();
-    const UString& sourceURL = source.provider()->url();
+    intptr_t sourceID = provider->asID();
+    const UString& sourceURL = provider->url();
 
     if (line != -1)
         error->putWithAttributes(globalData, Identifier(globalData, linePropertyName), jsNumber(line), ReadOnly | DontDelete);
@@ -127,7 +128,14 @@ JSObject* addErrorInfo(JSGlobalData* globalData, JSObject* error, int line, cons
         error->putWithAttributes(globalData, Identifier(globalData, sourceIdPropertyName), jsNumber((double)sourceID), ReadOnly | DontDelete);
     if (!sourceURL.isNull())
         error->putWithAttributes(globalData, Identifier(globalData, sourceURLPropertyName), jsString(globalData, sourceURL), ReadOnly | DontDelete);
+}
 
+JSObject* addErrorInfo(JSGlobalData* globalData, JSObject* error, int line, const SourceCode& source)
+{
+    if (error->isErrorInstance())
+        static_cast<ErrorInstance*>(error)->setPendingErrorInfo(line, source.provider());
+    else
+        putErrorInfo(globalData, error, line, source.provider());
     return error;
 }
 
@@ -138,6 +146,8 @@ JSObject* addErrorInfo(ExecState* exec, JSObject* error, int line, const SourceC
 
 bool hasErrorInfo(ExecState* exec, JSObject* error)
 {
+    if (error->isErrorInstance() && static_cast<ErrorInstance*>(error)->hasPendingErrorInfo())
+        return true;
     return error->hasProperty(exec, Identifier(exec, linePropertyName))
         || error->hasProperty(exec, Identifier(exec, sourceIdPropertyName))
         || error->hasProperty(exec, Identifier(exec, sourceURLPropertyName));
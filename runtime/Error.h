@@ -33,6 +33,7 @@ namespace JSC {
     class JSGlobalObject;
     class JSObject;
     class SourceCode;
+    class SourceProvider;
     class Structure;
     class UString;
 
@@ -58,6 +59,8 @@ namespace JSC {
     JSObject* addErrorInfo(JSGlobalData*, JSObject* error, int line, const SourceCode&);
     // ExecState wrappers.
     JSObject* addErrorInfo(ExecState*, JSObject* error, int line, const SourceCode&);
+    // Puts the properties addErrorInfo() describes right away, even on an ErrorInstance.
+    void putErrorInfo(JSGlobalData*, JSObject* error, int line, SourceProvider*);
 
     // Methods to throw Errors.
     JSValue throwError(ExecState*, JSValue);
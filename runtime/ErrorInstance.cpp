@@ -21,6 +21,9 @@
 #include "config.h"
 #include "ErrorInstance.h"
 
+#include "Error.h"
+#include "PropertyNameArray.h"
+
 namespace JSC {
 
 const ClassInfo ErrorInstance::s_info = { "Error", &JSNonFinalObject::s_info, 0, 0 };
@@ -28,7 +31,57 @@ const ClassInfo ErrorInstance::s_info = { "Error", &JSNonFinalObject::s_info, 0,
 ErrorInstance::ErrorInstance(JSGlobalData& globalData, Structure* structure)
     : JSNonFinalObject(globalData, structure)
     , m_appendSourceToMessage(false)
+    , m_pendingErrorInfoLine(-1)
+{
+}
+
+bool ErrorInstance::isErrorInfoPropertyName(const Identifier& propertyName)
+{
+    return propertyName == "line" || propertyName == "sourceId" || propertyName == "sourceURL";
+}
+
+void ErrorInstance::materializeErrorInfo(JSGlobalData& globalData)
+{
+    // Cleared first, since putting the properties comes back through here.
+    RefPtr<SourceProvider> provider = m_pendingErrorInfoProvider.release();
+    putErrorInfo(&globalData, this, m_pendingErrorInfoLine, provider.get());
+}
+
+bool ErrorInstance::getOwnPropertySlot(ExecState* exec, const Identifier& propertyName, PropertySlot& slot)
+{
+    materializeErrorInfo(exec, propertyName);
+    return Base::getOwnPropertySlot(exec, propertyName, slot);
+}
+
+bool ErrorInstance::getOwnPropertyDescriptor(ExecState* exec, const Identifier& propertyName, PropertyDescriptor& descriptor)
+{
+    materializeErrorInfo(exec, propertyName);
+    return Base::getOwnPropertyDescriptor(exec, propertyName, descriptor);
+}
+
+void ErrorInstance::put(ExecState* exec, const Identifier& propertyName, JSValue value, PutPropertySlot& slot)
+{
+    materializeErrorInfo(exec, propertyName);
+    Base::put(exec, propertyName, value, slot);
+}
+
+bool ErrorInstance::deleteProperty(ExecState* exec, const Identifier& propertyName)
+{
+    materializeErrorInfo(exec, propertyName);
+    return Base::deleteProperty(exec, propertyName);
+}
+
+bool ErrorInstance::defineOwnProperty(ExecState* exec, const Identifier& propertyName, PropertyDescriptor& descriptor, bool shouldThrow)
+{
+    materializeErrorInfo(exec, propertyName);
+    return Base::defineOwnProperty(exec, propertyName, descriptor, shouldThrow);
+}
+
+void ErrorInstance::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNames, EnumerationMode mode)
 {
+    if (hasPendingErrorInfo())
+        materializeErrorInfo(exec->globalData());
+    Base::getOwnPropertyNames(exec, propertyNames, mode);
 }
 
 } // namespace JSC
@@ -22,6 +22,7 @@
 #define ErrorInstance_h
 
 #include "JSObject.h"
+#include "SourceProvider.h"
 
 namespace JSC {
 
@@ -58,9 +59,29 @@ namespace JSC {
 
         virtual bool isErrorInstance() const { return true; }
 
+        // Records where the error was thrown. The line, sourceId and sourceURL
+        // properties that addErrorInfo() would add are only put once one of
+        // them, or the object's property names, is first looked at, so errors
+        // that are caught and dropped never pay for them.
+        void setPendingErrorInfo(int line, SourceProvider* provider)
+        {
+            m_pendingErrorInfoLine = line;
+            m_pendingErrorInfoProvider = provider;
+        }
+        bool hasPendingErrorInfo() const { return !!m_pendingErrorInfoProvider; }
+
+        virtual bool getOwnPropertySlot(ExecState*, const Identifier&, PropertySlot&);
+        virtual bool getOwnPropertyDescriptor(ExecState*, const Identifier&, PropertyDescriptor&);
+        virtual void put(ExecState*, const Identifier& propertyName, JSValue, PutPropertySlot&);
+        virtual bool deleteProperty(ExecState*, const Identifier& propertyName);
+        virtual bool defineOwnProperty(ExecState*, const Identifier& propertyName, PropertyDescriptor&, bool shouldThrow);
+        virtual void getOwnPropertyNames(ExecState*, PropertyNameArray&, EnumerationMode mode = ExcludeDontEnumProperties);
+
     protected:
         explicit ErrorInstance(JSGlobalData&, Structure*);
 
+        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesGetPropertyNames | JSNonFinalObject::StructureFlags;
+
         void finishCreation(JSGlobalData& globalData, const UString& message)
         {
             Base::finishCreation(globalData);
@@ -69,6 +90,18 @@ namespace JSC {
         }
 
         bool m_appendSourceToMessage;
+
+    private:
+        void materializeErrorInfo(JSGlobalData&);
+        void materializeErrorInfo(ExecState* exec, const Identifier& propertyName)
+        {
+            if (UNLIKELY(hasPendingErrorInfo()) && isErrorInfoPropertyName(propertyName))
+                materializeErrorInfo(exec->globalData());
+        }
+        static bool isErrorInfoPropertyName(const Identifier&);
+
+        int m_pendingErrorInfoLine;
+        RefPtr<SourceProvider> m_pendingErrorInfoProvider;
     };
 
 } // namespace JSC
@@ -72,6 +72,24 @@ NativeExecutable::~NativeExecutable()
 
 const ClassInfo ScriptExecutable::s_info = { "ScriptExecutable", &ExecutableBase::s_info, 0, 0 };
 
+#if ENABLE(JIT)
+template<typename CodeBlockType>
+static PassOwnPtr<CodeBlock> jettisonOptimizedCodeBlock(OwnPtr<CodeBlockType>& codeBlock, JITCode& jitCode, MacroAssemblerCodePtr& jitCodeWithArityCheck)
+{
+    ASSERT(codeBlock->getJITType() == JITCode::DFGJIT);
+    ASSERT(codeBlock->alternative());
+    
+    OwnPtr<CodeBlock> optimizedCodeBlock = codeBlock.release();
+    codeBlock = static_pointer_cast<CodeBlockType>(optimizedCodeBlock->releaseAlternative());
+    jitCode = codeBlock->getJITCode();
+    jitCodeWithArityCheck = codeBlock->getJITCodeWithArityCheck();
+    
+    // Calls linked to the optimized code get relinked to the baseline code.
+    optimizedCodeBlock->unlinkIncomingCalls();
+    return optimizedCodeBlock.release();
+}
+#endif
+
 const ClassInfo EvalExecutable::s_info = { "EvalExecutable", &ScriptExecutable::s_info, 0, 0 };
 
 EvalExecutable::EvalExecutable(ExecState* exec, const SourceCode& source, bool inStrictContext)
@@ -87,6 +105,7 @@ const ClassInfo ProgramExecutable::s_info = { "ProgramExecutable", &ScriptExecut
 
 ProgramExecutable::ProgramExecutable(ExecState* exec, const SourceCode& source)
     : ScriptExecutable(exec->globalData().programExecutableStructure.get(), exec, source, false)
+    , m_declaresFunctions(false)
 {
 }
 
@@ -100,6 +119,7 @@ FunctionExecutable::FunctionExecutable(JSGlobalData& globalData, const Identifie
     : ScriptExecutable(globalData.functionExecutableStructure.get(), globalData, source, inStrictContext)
     , m_numCapturedVariables(0)
     , m_forceUsesArguments(forceUsesArguments)
+    , m_codeAge(0)
     , m_parameters(parameters)
     , m_name(name)
     , m_symbolTable(0)
@@ -110,6 +130,7 @@ FunctionExecutable::FunctionExecutable(ExecState* exec, const Identifier& name,
     : ScriptExecutable(exec->globalData().functionExecutableStructure.get(), exec, source, inStrictContext)
     , m_numCapturedVariables(0)
     , m_forceUsesArguments(forceUsesArguments)
+    , m_codeAge(0)
     , m_parameters(parameters)
     , m_name(name)
     , m_symbolTable(0)
@@ -127,6 +148,13 @@ JSObject* EvalExecutable::compileOptimized(ExecState* exec, ScopeChainNode* scop
     return error;
 }
 
+#if ENABLE(JIT)
+PassOwnPtr<CodeBlock> EvalExecutable::jettisonOptimizedCode()
+{
+    return jettisonOptimizedCodeBlock(m_evalCodeBlock, m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+}
+#endif
+
 JSObject* EvalExecutable::compileInternal(ExecState* exec, ScopeChainNode* scopeChainNode, JITCode::JITType jitType)
 {
 #if !ENABLE(JIT)
@@ -231,8 +259,7 @@ JSObject* ProgramExecutable::checkSyntax(ExecState* exec)
     JSObject* exception = 0;
     JSGlobalData* globalData = &exec->globalData();
     JSGlobalObject* lexicalGlobalObject = exec->lexicalGlobalObject();
-    RefPtr<ProgramNode> programNode = globalData->parser->parse<ProgramNode>(lexicalGlobalObject, lexicalGlobalObject->debugger(), exec, m_source, 0, JSParseNormal, &exception);
-    if (programNode)
+    if (globalData->parser->checkSyntax(lexicalGlobalObject, lexicalGlobalObject->debugger(), exec, m_source, &exception))
         return 0;
     ASSERT(exception);
     return exception;
@@ -249,6 +276,13 @@ JSObject* ProgramExecutable::compileOptimized(ExecState* exec, ScopeChainNode* s
     return error;
 }
 
+#if ENABLE(JIT)
+PassOwnPtr<CodeBlock> ProgramExecutable::jettisonOptimizedCode()
+{
+    return jettisonOptimizedCodeBlock(m_programCodeBlock, m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+}
+#endif
+
 JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* scopeChainNode, JITCode::JITType jitType)
 {
 #if !ENABLE(JIT)
@@ -263,9 +297,15 @@ JSObject* ProgramExecutable::compileInternal(ExecState* exec, ScopeChainNode* sc
         return exception;
     }
     recordParse(programNode->features(), programNode->hasCapturedVariables(), programNode->lineNo(), programNode->lastLine());
+    if (!programNode->functionStack().isEmpty())
+        m_declaresFunctions = true;
 
     JSGlobalObject* globalObject = scopeChainNode->globalObject.get();
     
+    // The bytecode generated below can't be saved and reloaded on a later run: it is
+    // specialized to this global object, with global variables resolved to register
+    // indices in its symbol table and cells such as its call/apply functions and the
+    // constant pool's strings embedded in the instruction stream.
     OwnPtr<CodeBlock> previousCodeBlock = m_programCodeBlock.release();
     ASSERT((jitType == JITCode::bottomTierJIT()) == !previousCodeBlock);
     m_programCodeBlock = adoptPtr(new ProgramCodeBlock(this, GlobalCode, globalObject, source().provider(), previousCodeBlock.release()));
@@ -367,6 +407,28 @@ JSObject* FunctionExecutable::compileOptimizedForConstruct(ExecState* exec, Scop
     return error;
 }
 
+#if ENABLE(JIT)
+PassOwnPtr<CodeBlock> FunctionExecutable::jettisonOptimizedCodeFor(CodeSpecializationKind kind)
+{
+    if (kind == CodeForCall) {
+        OwnPtr<CodeBlock> optimizedCodeBlock = jettisonOptimizedCodeBlock(m_codeBlockForCall, m_jitCodeForCall, m_jitCodeForCallWithArityCheck);
+        m_symbolTable = m_codeBlockForCall->sharedSymbolTable();
+        return optimizedCodeBlock.release();
+    }
+    ASSERT(kind == CodeForConstruct);
+    OwnPtr<CodeBlock> optimizedCodeBlock = jettisonOptimizedCodeBlock(m_codeBlockForConstruct, m_jitCodeForConstruct, m_jitCodeForConstructWithArityCheck);
+    m_symbolTable = m_codeBlockForConstruct->sharedSymbolTable();
+    return optimizedCodeBlock.release();
+}
+#endif
+
+PassRefPtr<FunctionBodyNode> FunctionExecutable::parseBody(ExecState* exec, JSGlobalData* globalData, JSObject** exception)
+{
+    if (m_eagerlyParsedBody)
+        return m_eagerlyParsedBody.release();
+    return globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, exception);
+}
+
 JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChainNode* scopeChainNode, ExecState* calleeArgsExec, JITCode::JITType jitType)
 {
 #if !ENABLE(JIT)
@@ -374,7 +436,7 @@ JSObject* FunctionExecutable::compileForCallInternal(ExecState* exec, ScopeChain
 #endif
     JSObject* exception = 0;
     JSGlobalData* globalData = scopeChainNode->globalData;
-    RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
+    RefPtr<FunctionBodyNode> body = parseBody(exec, globalData, &exception);
     if (!body) {
         ASSERT(exception);
         return exception;
@@ -451,7 +513,7 @@ JSObject* FunctionExecutable::compileForConstructInternal(ExecState* exec, Scope
     
     JSObject* exception = 0;
     JSGlobalData* globalData = scopeChainNode->globalData;
-    RefPtr<FunctionBodyNode> body = globalData->parser->parse<FunctionBodyNode>(exec->lexicalGlobalObject(), 0, 0, m_source, m_parameters.get(), isStrictMode() ? JSParseStrict : JSParseNormal, &exception);
+    RefPtr<FunctionBodyNode> body = parseBody(exec, globalData, &exception);
     if (!body) {
         ASSERT(exception);
         return exception;
@@ -547,6 +609,33 @@ void FunctionExecutable::discardCode()
     clearCode();
 }
 
+bool FunctionExecutable::hasDebugHooks() const
+{
+    return (m_codeBlockForCall && m_codeBlockForCall->hasDebugHooks())
+        || (m_codeBlockForConstruct && m_codeBlockForConstruct->hasDebugHooks());
+}
+
+void FunctionExecutable::ageOrDiscardCode(unsigned maximumAge)
+{
+    if (!m_codeBlockForCall && !m_codeBlockForConstruct)
+        return;
+
+    if (m_codeAge < maximumAge) {
+        ++m_codeAge;
+        unlinkCalls();
+        return;
+    }
+
+#if ENABLE(JIT)
+    // Callers that stay alive must not keep jumping into the code we free.
+    for (CodeBlock* codeBlock = m_codeBlockForCall.get(); codeBlock; codeBlock = codeBlock->alternative())
+        codeBlock->unlinkIncomingCalls();
+    for (CodeBlock* codeBlock = m_codeBlockForConstruct.get(); codeBlock; codeBlock = codeBlock->alternative())
+        codeBlock->unlinkIncomingCalls();
+#endif
+    discardCode();
+}
+
 void FunctionExecutable::clearCode()
 {
     if (m_codeBlockForCall) {
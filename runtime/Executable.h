@@ -312,6 +312,14 @@ namespace JSC {
         }
         
         JSObject* compileOptimized(ExecState*, ScopeChainNode*);
+#if ENABLE(JIT)
+        PassOwnPtr<CodeBlock> jettisonOptimizedCode();
+#endif
+
+        bool isGenerated() const
+        {
+            return m_evalCodeBlock;
+        }
 
         EvalCodeBlock& generatedBytecode()
         {
@@ -377,6 +385,14 @@ namespace JSC {
         }
 
         JSObject* compileOptimized(ExecState*, ScopeChainNode*);
+#if ENABLE(JIT)
+        PassOwnPtr<CodeBlock> jettisonOptimizedCode();
+#endif
+
+        bool isGenerated() const
+        {
+            return m_programCodeBlock;
+        }
 
         ProgramCodeBlock& generatedBytecode()
         {
@@ -386,6 +402,10 @@ namespace JSC {
 
         JSObject* checkSyntax(ExecState*);
 
+        // Whether compiling the program created top-level functions, which happens as part of
+        // compiling rather than running it.
+        bool declaresFunctions() const { return m_declaresFunctions; }
+
 #if ENABLE(JIT)
         JITCode& generatedJITCode()
         {
@@ -412,6 +432,7 @@ namespace JSC {
         void unlinkCalls();
 
         OwnPtr<ProgramCodeBlock> m_programCodeBlock;
+        bool m_declaresFunctions;
     };
 
     class FunctionExecutable : public ScriptExecutable {
@@ -452,6 +473,7 @@ namespace JSC {
         JSObject* compileForCall(ExecState* exec, ScopeChainNode* scopeChainNode, ExecState* calleeArgsExec = 0)
         {
             ASSERT(exec->globalData().dynamicGlobalObject);
+            m_codeAge = 0;
             JSObject* error = 0;
             if (!m_codeBlockForCall)
                 error = compileForCallInternal(exec, scopeChainNode, calleeArgsExec, JITCode::bottomTierJIT());
@@ -475,6 +497,7 @@ namespace JSC {
         JSObject* compileForConstruct(ExecState* exec, ScopeChainNode* scopeChainNode)
         {
             ASSERT(exec->globalData().dynamicGlobalObject);
+            m_codeAge = 0;
             JSObject* error = 0;
             if (!m_codeBlockForConstruct)
                 error = compileForConstructInternal(exec, scopeChainNode, JITCode::bottomTierJIT());
@@ -509,6 +532,12 @@ namespace JSC {
             return compileForConstruct(exec, scopeChainNode);
         }
         
+#if ENABLE(JIT)
+        // Goes back to the baseline code that the optimized code was compiled
+        // from, returning the optimized CodeBlock.
+        PassOwnPtr<CodeBlock> jettisonOptimizedCodeFor(CodeSpecializationKind);
+#endif
+
         JSObject* compileOptimizedFor(ExecState* exec, ScopeChainNode* scopeChainNode, CodeSpecializationKind kind)
         {
             // compileOptimizedFor should only be called with a callframe set up to call this function,
@@ -547,6 +576,24 @@ namespace JSC {
         SharedSymbolTable* symbolTable() const { return m_symbolTable; }
 
         void discardCode();
+
+        // A body the enclosing code's parse already built, used by the first compile instead of
+        // parsing the source again.
+        void setEagerlyParsedBody(PassRefPtr<FunctionBodyNode> body) { m_eagerlyParsedBody = body; }
+
+        // Whether the code for either kind of call was generated with op_debug, which
+        // is decided by whether a debugger was attached at the time.
+        bool hasDebugHooks() const;
+
+        // Called when executable memory runs low, with maximumCodeAge, and after
+        // garbage collections, with the embedder's configured age. Code that
+        // hasn't been entered through compileForCall() or compileForConstruct()
+        // during the last maximumAge calls is discarded. Other code gets older,
+        // and has its outgoing calls unlinked, so callees that are still in use
+        // get relinked, and so rejuvenated, on their next call.
+        static const unsigned maximumCodeAge = 2;
+        void ageOrDiscardCode(unsigned maximumAge = maximumCodeAge);
+
         void visitChildren(SlotVisitor&);
         static FunctionExecutable* fromGlobalCode(const Identifier&, ExecState*, Debugger*, const SourceCode&, JSObject** exception);
         static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue proto)
@@ -573,13 +620,16 @@ namespace JSC {
 
         JSObject* compileForCallInternal(ExecState*, ScopeChainNode*, ExecState* calleeArgsExec, JITCode::JITType);
         JSObject* compileForConstructInternal(ExecState*, ScopeChainNode*, JITCode::JITType);
+        PassRefPtr<FunctionBodyNode> parseBody(ExecState*, JSGlobalData*, JSObject** exception);
         
         static const unsigned StructureFlags = OverridesVisitChildren | ScriptExecutable::StructureFlags;
         unsigned m_numCapturedVariables : 31;
         bool m_forceUsesArguments : 1;
+        unsigned m_codeAge;
         void unlinkCalls();
 
         RefPtr<FunctionParameters> m_parameters;
+        RefPtr<FunctionBodyNode> m_eagerlyParsedBody;
         OwnPtr<FunctionCodeBlock> m_codeBlockForCall;
         OwnPtr<FunctionCodeBlock> m_codeBlockForConstruct;
         Identifier m_name;
@@ -29,12 +29,53 @@
 #include "config.h"
 #include "GCActivityCallback.h"
 
+#include "Heap.h"
+#include <wtf/CurrentTime.h>
+
 namespace JSC {
 
+// Without a run loop to put a timer on, collections are scheduled into the
+// idle time the embedder reports through didBecomeIdle(). Idle time is spent,
+// in order, on:
+// 1) an incremental marking slice, or, without ENABLE(INCREMENTAL_MARKING), a
+//    collection once the heap is halfway to its watermark, so that the
+//    allocation that trips the watermark doesn't pay for one mid-frame;
+// 2) once nothing has been collected for quietPeriod seconds, a full
+//    collection that gives back empty blocks, like the CF timer does;
+// 3) after that, the blocks cached for reuse.
+// Nothing is started that isn't expected to fit in the time budget.
 struct DefaultGCActivityCallbackPlatformData {
+    DefaultGCActivityCallbackPlatformData(Heap*);
+
+    Heap* heap;
+    double lastCollectionTime;
+    bool hasCollectedSinceQuiet;
 };
 
-DefaultGCActivityCallback::DefaultGCActivityCallback(Heap*)
+const double quietPeriod = 2; // seconds
+
+DefaultGCActivityCallbackPlatformData::DefaultGCActivityCallbackPlatformData(Heap* heap)
+    : heap(heap)
+    , lastCollectionTime(currentTime())
+    , hasCollectedSinceQuiet(true)
+{
+}
+
+static double averagePauseTime(Heap* heap, bool isFullCollection)
+{
+    double result = 0;
+    GCPhase phases[] = { MarkRootsPhase, FinalizePhase, ShrinkPhase };
+    size_t phaseCount = isFullCollection ? WTF_ARRAY_LENGTH(phases) : WTF_ARRAY_LENGTH(phases) - 1;
+    for (size_t i = 0; i < phaseCount; ++i) {
+        const GCPhaseStatistics& statistics = heap->phaseStatistics(phases[i]);
+        if (statistics.count)
+            result += statistics.totalTime / statistics.count;
+    }
+    return result;
+}
+
+DefaultGCActivityCallback::DefaultGCActivityCallback(Heap* heap)
+    : d(adoptPtr(new DefaultGCActivityCallbackPlatformData(heap)))
 {
 }
 
@@ -44,11 +85,55 @@ DefaultGCActivityCallback::~DefaultGCActivityCallback()
 
 void DefaultGCActivityCallback::operator()()
 {
+    d->lastCollectionTime = currentTime();
+    d->hasCollectedSinceQuiet = true;
 }
 
 void DefaultGCActivityCallback::synchronize()
 {
 }
 
+bool DefaultGCActivityCallback::didBecomeIdle(double timeBudget)
+{
+    Heap* heap = d->heap;
+    if (heap->isBusy())
+        return false;
+
+    double now = currentTime();
+    double deadline = now + timeBudget;
+
+#if ENABLE(INCREMENTAL_MARKING)
+    if (heap->collectIncrementally(timeBudget))
+        return true;
+    if (heap->isIncrementallyMarking())
+        return false;
+#else
+    NewSpace& markedSpace = heap->markedSpace();
+    if (markedSpace.waterMark() >= markedSpace.highWaterMark() / 2 && averagePauseTime(heap, false) <= timeBudget) {
+        heap->collectSpeculatively();
+        return true;
+    }
+#endif
+
+    if (now - d->lastCollectionTime < quietPeriod)
+        return false;
+
+    if (d->hasCollectedSinceQuiet) {
+        if (averagePauseTime(heap, true) > timeBudget)
+            return false;
+        heap->collectAllGarbage();
+        d->hasCollectedSinceQuiet = false;
+        return true;
+    }
+
+#if ENABLE(LAZY_BLOCK_FREEING)
+    if (currentTime() < deadline)
+        heap->releaseFreeBlocks();
+#else
+    UNUSED_PARAM(deadline);
+#endif
+    return false;
+}
+
 }
 
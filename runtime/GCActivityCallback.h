@@ -46,6 +46,11 @@ public:
     virtual void operator()() {}
     virtual void synchronize() {}
 
+    // The embedder has timeBudget seconds with nothing else to do, such as
+    // the time left until the next frame. Returns true if the heap was
+    // collected.
+    virtual bool didBecomeIdle(double /* timeBudget */) { return false; }
+
 protected:
     GCActivityCallback() {}
 };
@@ -61,6 +66,9 @@ public:
 
     void operator()();
     void synchronize();
+#if !USE(CF)
+    bool didBecomeIdle(double timeBudget);
+#endif
 
 #if USE(CF)
 protected:
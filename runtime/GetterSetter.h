@@ -30,8 +30,13 @@
 
 namespace JSC {
 
+    class GetterSetter;
     class JSObject;
 
+    template <> struct NeedsDestructor<GetterSetter> {
+        static const bool value = false;
+    };
+
     // This is an internal value object which stores getter and setter functions
     // for a property.
     class GetterSetter : public JSCell {
@@ -149,6 +149,31 @@ struct IdentifierUCharBufferTranslator {
     }
 };
 
+struct HashedUCharBuffer {
+    const UChar* s;
+    unsigned int length;
+    unsigned hash;
+};
+
+struct IdentifierHashedUCharBufferTranslator {
+    static unsigned hash(const HashedUCharBuffer& buf)
+    {
+        ASSERT(buf.hash == StringHasher::computeHash<UChar>(buf.s, buf.length));
+        return buf.hash;
+    }
+
+    static bool equal(StringImpl* str, const HashedUCharBuffer& buf)
+    {
+        return Identifier::equal(str, buf.s, buf.length);
+    }
+
+    static void translate(StringImpl*& location, const HashedUCharBuffer& buf, unsigned hash)
+    {
+        UCharBuffer unhashed = { buf.s, buf.length };
+        IdentifierUCharBufferTranslator::translate(location, unhashed, hash);
+    }
+};
+
 uint32_t Identifier::toUInt32(const UString& string, bool& ok)
 {
     ok = false;
@@ -209,6 +234,20 @@ PassRefPtr<StringImpl> Identifier::add(JSGlobalData* globalData, const UChar* s,
     return addResult.second ? adoptRef(*addResult.first) : *addResult.first;
 }
 
+PassRefPtr<StringImpl> Identifier::add(JSGlobalData* globalData, const UChar* s, int length, unsigned hash)
+{
+    if (length == 1) {
+        UChar c = s[0];
+        if (c <= maxSingleCharacterString)
+            return add(globalData, globalData->smallStrings.singleCharacterStringRep(c));
+    }
+    if (!length)
+        return StringImpl::empty();
+    HashedUCharBuffer buf = {s, length, hash};
+    pair<HashSet<StringImpl*>::iterator, bool> addResult = globalData->identifierTable->add<HashedUCharBuffer, IdentifierHashedUCharBufferTranslator>(buf);
+    return addResult.second ? adoptRef(*addResult.first) : *addResult.first;
+}
+
 PassRefPtr<StringImpl> Identifier::add(ExecState* exec, const UChar* s, int length)
 {
     return add(&exec->globalData(), s, length);
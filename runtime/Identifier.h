@@ -42,11 +42,14 @@ namespace JSC {
 
         Identifier(JSGlobalData* globalData, const char* s) : m_string(add(globalData, s)) { } // Only to be used with string literals.
         Identifier(JSGlobalData* globalData, const UChar* s, int length) : m_string(add(globalData, s, length)) { }
+        Identifier(JSGlobalData* globalData, const UChar* s, int length, unsigned hash) : m_string(add(globalData, s, length, hash)) { }
         Identifier(JSGlobalData* globalData, StringImpl* rep) : m_string(add(globalData, rep)) { } 
         Identifier(JSGlobalData* globalData, const UString& s) : m_string(add(globalData, s.impl())) { }
 
         const UString& ustring() const { return m_string; }
         StringImpl* impl() const { return m_string.impl(); }
+
+        void swap(Identifier& other) { m_string.swap(other.m_string); }
         
         const UChar* characters() const { return m_string.characters(); }
         int length() const { return m_string.length(); }
@@ -88,6 +91,8 @@ namespace JSC {
 
         static PassRefPtr<StringImpl> add(ExecState*, const UChar*, int length);
         static PassRefPtr<StringImpl> add(JSGlobalData*, const UChar*, int length);
+        // As above, for callers that have already computed the StringHasher hash of the characters.
+        static PassRefPtr<StringImpl> add(JSGlobalData*, const UChar*, int length, unsigned hash);
 
         static PassRefPtr<StringImpl> add(ExecState* exec, StringImpl* r)
         {
@@ -153,6 +158,16 @@ namespace JSC {
         static unsigned hash(StringImpl* key) { return key->existingHash(); }
     };
 
+    inline void swap(Identifier& a, Identifier& b) { a.swap(b); }
+
 } // namespace JSC
 
+namespace WTF {
+
+    // An Identifier is a single UString, so Vector can move it with memcpy when it grows
+    // rather than copying and destroying each element.
+    template <> struct VectorTraits<JSC::Identifier> : SimpleClassVectorTraits { };
+
+} // namespace WTF
+
 #endif // Identifier_h
@@ -30,9 +30,12 @@
 #include "InitializeThreading.h"
 
 #include "ExecutableAllocator.h"
+#include "CompressedSourceProvider.h"
 #include "Heap.h"
 #include "Identifier.h"
+#include "JITCodeLog.h"
 #include "JSGlobalObject.h"
+#include "SourceProviderCache.h"
 #include "UString.h"
 #include "WriteBarrier.h"
 #include "dtoa.h"
@@ -59,8 +62,11 @@ static void initializeThreadingOnce()
 #if ENABLE(JIT) && ENABLE(ASSEMBLER)
     ExecutableAllocator::initializeAllocator();
 #endif
+    JITCodeLog::initialize();
 #if ENABLE(JSC_MULTIPLE_THREADS)
     RegisterFile::initializeThreading();
+    SourceProviderCache::initializeThreading();
+    CompressedSourceProvider::initializeThreading();
 #endif
 }
 
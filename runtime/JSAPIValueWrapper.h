@@ -30,6 +30,12 @@
 
 namespace JSC {
 
+    class JSAPIValueWrapper;
+
+    template <> struct NeedsDestructor<JSAPIValueWrapper> {
+        static const bool value = false;
+    };
+
     class JSAPIValueWrapper : public JSCell {
         friend JSValue jsAPIValueWrapper(ExecState*, JSValue);
     public:
@@ -28,10 +28,10 @@
 #include "Error.h"
 #include "Executable.h"
 #include "PropertyNameArray.h"
-#include <wtf/AVLTree.h>
 #include <wtf/Assertions.h>
 #include <wtf/OwnPtr.h>
 #include <Operations.h>
+#include <algorithm>
 
 using namespace std;
 using namespace WTF;
@@ -126,6 +126,14 @@ inline void JSArray::checkConsistency(ConsistencyCheckType)
 
 #endif
 
+inline void JSArray::reportStorageCost(size_t cost)
+{
+    // Storage in the large object space already counts towards the next collection.
+    Heap* heap = Heap::heap(this);
+    if (!heap->isLargeStorage(m_storage->m_allocBase))
+        heap->reportExtraMemoryCost(cost);
+}
+
 JSArray::JSArray(VPtrStealingHackType)
     : JSNonFinalObject(VPtrStealingHack)
 {
@@ -164,7 +172,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, unsigned initialLength, A
     else
         initialCapacity = min(BASE_VECTOR_LEN, MIN_SPARSE_ARRAY_INDEX);
     
-    m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialCapacity)));
+    m_storage = static_cast<ArrayStorage*>(Heap::heap(this)->allocateStorage(storageSize(initialCapacity)));
     m_storage->m_allocBase = m_storage;
     m_storage->m_length = initialLength;
     m_indexBias = 0;
@@ -192,7 +200,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, unsigned initialLength, A
 
     checkConsistency();
     
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(initialCapacity));
+    reportStorageCost(storageSize(initialCapacity));
 }
 
 void JSArray::finishCreation(JSGlobalData& globalData, const ArgList& list)
@@ -210,7 +218,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, const ArgList& list)
     else
         initialStorage = initialCapacity;
     
-    m_storage = static_cast<ArrayStorage*>(fastMalloc(storageSize(initialStorage)));
+    m_storage = static_cast<ArrayStorage*>(Heap::heap(this)->allocateStorage(storageSize(initialStorage)));
     m_storage->m_allocBase = m_storage;
     m_indexBias = 0;
     m_storage->m_length = initialCapacity;
@@ -233,7 +241,7 @@ void JSArray::finishCreation(JSGlobalData& globalData, const ArgList& list)
 
     checkConsistency();
 
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(initialStorage));
+    reportStorageCost(storageSize(initialStorage));
 }
 
 JSArray::~JSArray()
@@ -242,7 +250,7 @@ JSArray::~JSArray()
     checkConsistency(DestructorConsistencyCheck);
 
     delete m_storage->m_sparseValueMap;
-    fastFree(m_storage->m_allocBase);
+    Heap::heap(this)->freeStorage(m_storage->m_allocBase);
 }
 
 bool JSArray::getOwnPropertySlot(ExecState* exec, unsigned i, PropertySlot& slot)
@@ -444,9 +452,8 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
         }
     }
 
-    void* baseStorage = storage->m_allocBase;
-    
-    if (!tryFastRealloc(baseStorage, storageSize(newVectorLength + m_indexBias)).getValue(baseStorage)) {
+    void* baseStorage = Heap::heap(this)->tryReallocateStorage(storage->m_allocBase, storageSize(m_vectorLength + m_indexBias), storageSize(newVectorLength + m_indexBias));
+    if (!baseStorage) {
         throwOutOfMemoryError(exec);
         return;
     }
@@ -480,7 +487,7 @@ NEVER_INLINE void JSArray::putSlowCase(ExecState* exec, unsigned i, JSValue valu
 
     checkConsistency();
 
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
+    reportStorageCost(storageSize(newVectorLength) - storageSize(vectorLength));
 }
 
 bool JSArray::deleteProperty(ExecState* exec, const Identifier& propertyName)
@@ -533,6 +540,17 @@ bool JSArray::deleteProperty(ExecState* exec, unsigned i)
     return false;
 }
 
+// The sparse map is hashed, so callers that observe index order (enumeration, stable sorting)
+// take a sorted snapshot of its keys instead of walking the table.
+static void copySortedSparseIndices(const SparseArrayValueMap& map, Vector<unsigned>& indices)
+{
+    indices.reserveCapacity(map.size());
+    SparseArrayValueMap::const_iterator end = map.end();
+    for (SparseArrayValueMap::const_iterator it = map.begin(); it != end; ++it)
+        indices.uncheckedAppend(it->first);
+    std::sort(indices.begin(), indices.end());
+}
+
 void JSArray::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNames, EnumerationMode mode)
 {
     // FIXME: Filling PropertyNameArray with an identifier for every integer
@@ -548,9 +566,10 @@ void JSArray::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNa
     }
 
     if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
-        SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it)
-            propertyNames.add(Identifier::from(exec, it->first));
+        Vector<unsigned> indices;
+        copySortedSparseIndices(*map, indices);
+        for (size_t i = 0; i < indices.size(); ++i)
+            propertyNames.add(Identifier::from(exec, indices[i]));
     }
 
     if (mode == IncludeDontEnumProperties)
@@ -597,9 +616,8 @@ bool JSArray::increaseVectorLength(unsigned newLength)
     ASSERT(newLength > vectorLength);
     ASSERT(newLength <= MAX_STORAGE_VECTOR_INDEX);
     unsigned newVectorLength = getNewVectorLength(newLength);
-    void* baseStorage = storage->m_allocBase;
-
-    if (!tryFastRealloc(baseStorage, storageSize(newVectorLength + m_indexBias)).getValue(baseStorage))
+    void* baseStorage = Heap::heap(this)->tryReallocateStorage(storage->m_allocBase, storageSize(vectorLength + m_indexBias), storageSize(newVectorLength + m_indexBias));
+    if (!baseStorage)
         return false;
 
     storage = m_storage = reinterpret_cast_ptr<ArrayStorage*>(static_cast<char*>(baseStorage) + m_indexBias * sizeof(JSValue));
@@ -611,7 +629,7 @@ bool JSArray::increaseVectorLength(unsigned newLength)
 
     m_vectorLength = newVectorLength;
     
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
+    reportStorageCost(storageSize(newVectorLength) - storageSize(vectorLength));
 
     return true;
 }
@@ -628,7 +646,7 @@ bool JSArray::increaseVectorPrefixLength(unsigned newLength)
     ASSERT(newLength <= MAX_STORAGE_VECTOR_INDEX);
     unsigned newVectorLength = getNewVectorLength(newLength);
 
-    void* newBaseStorage = fastMalloc(storageSize(newVectorLength + m_indexBias));
+    void* newBaseStorage = Heap::heap(this)->tryAllocateStorage(storageSize(newVectorLength + m_indexBias));
     if (!newBaseStorage)
         return false;
     
@@ -642,12 +660,12 @@ bool JSArray::increaseVectorPrefixLength(unsigned newLength)
     m_storage->m_allocBase = newBaseStorage;
     m_vectorLength = newLength;
     
-    fastFree(storage->m_allocBase);
+    Heap::heap(this)->freeStorage(storage->m_allocBase);
     ASSERT(newLength > vectorLength);
     unsigned delta = newLength - vectorLength;
     for (unsigned i = 0; i < delta; i++)
         m_storage->m_vector[i].clear();
-    Heap::heap(this)->reportExtraMemoryCost(storageSize(newVectorLength) - storageSize(vectorLength));
+    reportStorageCost(storageSize(newVectorLength) - storageSize(vectorLength));
     
     return true;
 }
@@ -676,11 +694,18 @@ void JSArray::setLength(unsigned newLength)
         }
 
         if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
-            SparseArrayValueMap copy = *map;
-            SparseArrayValueMap::iterator end = copy.end();
-            for (SparseArrayValueMap::iterator it = copy.begin(); it != end; ++it) {
+            // Collect only the doomed keys; copying the whole map to iterate it rehashed every entry.
+            Vector<unsigned> removedIndices;
+            SparseArrayValueMap::iterator end = map->end();
+            for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
                 if (it->first >= newLength)
-                    map->remove(it->first);
+                    removedIndices.append(it->first);
+            }
+            if (removedIndices.size() == map->size())
+                map->clear();
+            else {
+                for (size_t i = 0; i < removedIndices.size(); ++i)
+                    map->remove(removedIndices[i]);
             }
             if (map->isEmpty()) {
                 delete map;
@@ -778,6 +803,11 @@ void JSArray::push(ExecState* exec, JSValue value)
     putSlowCase(exec, storage->m_length++, value);
 }
 
+size_t JSArray::storageBytes() const
+{
+    return storageSize(m_vectorLength + m_indexBias);
+}
+
 void JSArray::shiftCount(ExecState* exec, int count)
 {
     ASSERT(count > 0);
@@ -996,83 +1026,307 @@ void JSArray::sort(ExecState* exec)
     checkConsistency(SortConsistencyCheck);
 }
 
-struct AVLTreeNodeForArrayCompare {
-    JSValue value;
+// A stable natural merge sort (after TimSort) for sorting with a script comparator.
+// Comparator calls dominate the cost of these sorts, so presorted runs are detected
+// and kept, short runs are extended by binary insertion, and merges gallop once one
+// side keeps winning, which brings mostly sorted input close to n comparisons.
+class ArrayCompareSorter {
+    WTF_MAKE_NONCOPYABLE(ArrayCompareSorter);
+public:
+    ArrayCompareSorter(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
+        : m_exec(exec)
+        , m_compareFunction(compareFunction)
+        , m_compareCallType(callType)
+        , m_compareCallData(callData)
+        , m_globalThisValue(exec->globalThisValue())
+    {
+        if (callType == CallTypeJS)
+            m_cachedCall = adoptPtr(new CachedCall(exec, asFunction(compareFunction), 2));
+    }
 
-    // Child pointers.  The high bit of gt is robbed and used as the
-    // balance factor sign.  The high bit of lt is robbed and used as
-    // the magnitude of the balance factor.
-    int32_t gt;
-    int32_t lt;
-};
+    void sort(JSValue* values, size_t count);
+
+private:
+    static const size_t minimumMerge = 32;
+    static const unsigned minimumGallop = 7;
 
-struct AVLTreeAbstractorForArrayCompare {
-    typedef int32_t handle; // Handle is an index into m_nodes vector.
-    typedef JSValue key;
-    typedef int32_t size;
+    struct Run {
+        Run(size_t base, size_t length)
+            : base(base)
+            , length(length)
+        {
+        }
+
+        size_t base;
+        size_t length;
+    };
+
+    bool lessThan(JSValue, JSValue);
+
+    static size_t minimumRunLength(size_t count);
+    size_t countRunAndMakeAscending(JSValue* values, size_t count);
+    void binaryInsertionSort(JSValue* values, size_t count, size_t sortedCount);
+    size_t gallopRight(JSValue key, const JSValue* values, size_t count);
+    size_t gallopLeft(JSValue key, const JSValue* values, size_t count);
+    void mergeCollapse();
+    void mergeForceCollapse();
+    void mergeAt(size_t);
+    void merge(JSValue* left, size_t leftCount, size_t rightCount);
 
-    Vector<AVLTreeNodeForArrayCompare> m_nodes;
     ExecState* m_exec;
     JSValue m_compareFunction;
     CallType m_compareCallType;
-    const CallData* m_compareCallData;
+    const CallData& m_compareCallData;
     JSValue m_globalThisValue;
     OwnPtr<CachedCall> m_cachedCall;
 
-    handle get_less(handle h) { return m_nodes[h].lt & 0x7FFFFFFF; }
-    void set_less(handle h, handle lh) { m_nodes[h].lt &= 0x80000000; m_nodes[h].lt |= lh; }
-    handle get_greater(handle h) { return m_nodes[h].gt & 0x7FFFFFFF; }
-    void set_greater(handle h, handle gh) { m_nodes[h].gt &= 0x80000000; m_nodes[h].gt |= gh; }
+    JSValue* m_values;
+    Vector<Run, 40> m_runs;
+    Vector<JSValue> m_mergeBuffer;
+};
 
-    int get_balance_factor(handle h)
-    {
-        if (m_nodes[h].gt & 0x80000000)
-            return -1;
-        return static_cast<unsigned>(m_nodes[h].lt) >> 31;
+// Once the compare function has thrown, every comparison answers "not less", which
+// finishes the sort quickly without further calls and leaves a permutation behind.
+bool ArrayCompareSorter::lessThan(JSValue va, JSValue vb)
+{
+    ASSERT(!va.isUndefined());
+    ASSERT(!vb.isUndefined());
+
+    if (m_exec->hadException())
+        return false;
+
+    double compareResult;
+    if (m_cachedCall) {
+        m_cachedCall->setThis(m_globalThisValue);
+        m_cachedCall->setArgument(0, va);
+        m_cachedCall->setArgument(1, vb);
+        compareResult = m_cachedCall->call().toNumber(m_cachedCall->newCallFrame(m_exec));
+    } else {
+        MarkedArgumentBuffer arguments;
+        arguments.append(va);
+        arguments.append(vb);
+        compareResult = call(m_exec, m_compareFunction, m_compareCallType, m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
     }
+    return compareResult < 0;
+}
 
-    void set_balance_factor(handle h, int bf)
-    {
-        if (bf == 0) {
-            m_nodes[h].lt &= 0x7FFFFFFF;
-            m_nodes[h].gt &= 0x7FFFFFFF;
-        } else {
-            m_nodes[h].lt |= 0x80000000;
-            if (bf < 0)
-                m_nodes[h].gt |= 0x80000000;
+size_t ArrayCompareSorter::minimumRunLength(size_t count)
+{
+    size_t lowBits = 0;
+    while (count >= minimumMerge) {
+        lowBits |= count & 1;
+        count >>= 1;
+    }
+    return count + lowBits;
+}
+
+// Returns the length of the run starting at values, reversing it in place if it is
+// strictly descending. Strictness keeps the reversal stable.
+size_t ArrayCompareSorter::countRunAndMakeAscending(JSValue* values, size_t count)
+{
+    ASSERT(count);
+    if (count == 1)
+        return 1;
+
+    size_t runEnd = 2;
+    if (lessThan(values[1], values[0])) {
+        while (runEnd < count && lessThan(values[runEnd], values[runEnd - 1]))
+            ++runEnd;
+        std::reverse(values, values + runEnd);
+    } else {
+        while (runEnd < count && !lessThan(values[runEnd], values[runEnd - 1]))
+            ++runEnd;
+    }
+    return runEnd;
+}
+
+void ArrayCompareSorter::binaryInsertionSort(JSValue* values, size_t count, size_t sortedCount)
+{
+    for (size_t i = sortedCount; i < count; ++i) {
+        JSValue pivot = values[i];
+        size_t low = 0;
+        size_t high = i;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (lessThan(pivot, values[middle]))
+                high = middle;
             else
-                m_nodes[h].gt &= 0x7FFFFFFF;
+                low = middle + 1;
         }
+        for (size_t j = i; j > low; --j)
+            values[j] = values[j - 1];
+        values[low] = pivot;
     }
+}
 
-    int compare_key_key(key va, key vb)
-    {
-        ASSERT(!va.isUndefined());
-        ASSERT(!vb.isUndefined());
-
-        if (m_exec->hadException())
-            return 1;
-
-        double compareResult;
-        if (m_cachedCall) {
-            m_cachedCall->setThis(m_globalThisValue);
-            m_cachedCall->setArgument(0, va);
-            m_cachedCall->setArgument(1, vb);
-            compareResult = m_cachedCall->call().toNumber(m_cachedCall->newCallFrame(m_exec));
+// Returns the number of leading elements of values that are not greater than key.
+size_t ArrayCompareSorter::gallopRight(JSValue key, const JSValue* values, size_t count)
+{
+    size_t low = 0;
+    size_t high = 1;
+    while (high <= count && !lessThan(key, values[high - 1])) {
+        low = high;
+        high = high * 2 + 1;
+    }
+    if (high > count)
+        high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (lessThan(key, values[middle]))
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+// Returns the number of leading elements of values that are less than key.
+size_t ArrayCompareSorter::gallopLeft(JSValue key, const JSValue* values, size_t count)
+{
+    size_t low = 0;
+    size_t high = 1;
+    while (high <= count && lessThan(values[high - 1], key)) {
+        low = high;
+        high = high * 2 + 1;
+    }
+    if (high > count)
+        high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (lessThan(values[middle], key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+// Keeps the run lengths on the stack growing faster than the Fibonacci numbers, so
+// merges stay balanced and the stack stays logarithmic in the array length.
+void ArrayCompareSorter::mergeCollapse()
+{
+    while (m_runs.size() > 1) {
+        size_t n = m_runs.size() - 2;
+        if ((n > 0 && m_runs[n - 1].length <= m_runs[n].length + m_runs[n + 1].length)
+            || (n > 1 && m_runs[n - 2].length <= m_runs[n - 1].length + m_runs[n].length)) {
+            if (m_runs[n - 1].length < m_runs[n + 1].length)
+                --n;
+        } else if (m_runs[n].length > m_runs[n + 1].length)
+            break;
+        mergeAt(n);
+    }
+}
+
+void ArrayCompareSorter::mergeForceCollapse()
+{
+    while (m_runs.size() > 1) {
+        size_t n = m_runs.size() - 2;
+        if (n > 0 && m_runs[n - 1].length < m_runs[n + 1].length)
+            --n;
+        mergeAt(n);
+    }
+}
+
+void ArrayCompareSorter::mergeAt(size_t index)
+{
+    Run& left = m_runs[index];
+    const Run& right = m_runs[index + 1];
+    ASSERT(left.base + left.length == right.base);
+
+    size_t leftCount = left.length;
+    size_t rightCount = right.length;
+    left.length += rightCount;
+    m_runs.remove(index + 1);
+
+    // Elements of the left run that are not greater than the first element of the
+    // right run are already in place, as are elements of the right run that are not
+    // less than the last element of the left run.
+    JSValue* leftValues = m_values + left.base;
+    size_t skip = gallopRight(leftValues[leftCount], leftValues, leftCount);
+    leftValues += skip;
+    leftCount -= skip;
+    if (!leftCount)
+        return;
+    rightCount = gallopLeft(leftValues[leftCount - 1], leftValues + leftCount, rightCount);
+    if (!rightCount)
+        return;
+
+    merge(leftValues, leftCount, rightCount);
+}
+
+void ArrayCompareSorter::merge(JSValue* left, size_t leftCount, size_t rightCount)
+{
+    if (m_mergeBuffer.size() < leftCount)
+        m_mergeBuffer.grow(leftCount);
+    std::copy(left, left + leftCount, m_mergeBuffer.begin());
+
+    const JSValue* a = m_mergeBuffer.begin();
+    const JSValue* aEnd = a + leftCount;
+    JSValue* b = left + leftCount;
+    JSValue* bEnd = b + rightCount;
+    JSValue* destination = left;
+
+    unsigned aWins = 0;
+    unsigned bWins = 0;
+    while (a < aEnd && b < bEnd) {
+        if (lessThan(*b, *a)) {
+            *destination++ = *b++;
+            ++bWins;
+            aWins = 0;
         } else {
-            MarkedArgumentBuffer arguments;
-            arguments.append(va);
-            arguments.append(vb);
-            compareResult = call(m_exec, m_compareFunction, m_compareCallType, *m_compareCallData, m_globalThisValue, arguments).toNumber(m_exec);
+            *destination++ = *a++;
+            ++aWins;
+            bWins = 0;
+        }
+
+        if (aWins >= minimumGallop && a < aEnd && b < bEnd) {
+            size_t count = gallopRight(*b, a, aEnd - a);
+            destination = std::copy(a, a + count, destination);
+            a += count;
+            aWins = 0;
+        } else if (bWins >= minimumGallop && a < aEnd && b < bEnd) {
+            // The destination never overtakes b, so copying forwards is safe.
+            size_t count = gallopLeft(*a, b, bEnd - b);
+            destination = std::copy(b, b + count, destination);
+            b += count;
+            bWins = 0;
         }
-        return (compareResult < 0) ? -1 : 1; // Not passing equality through, because we need to store all values, even if equivalent.
     }
 
-    int compare_key_node(key k, handle h) { return compare_key_key(k, m_nodes[h].value); }
-    int compare_node_node(handle h1, handle h2) { return compare_key_key(m_nodes[h1].value, m_nodes[h2].value); }
+    // Whatever remains of the right run is already in place.
+    std::copy(a, aEnd, destination);
+}
 
-    static handle null() { return 0x7FFFFFFF; }
-};
+void ArrayCompareSorter::sort(JSValue* values, size_t count)
+{
+    if (count < 2)
+        return;
+
+    m_values = values;
+    if (count < minimumMerge) {
+        binaryInsertionSort(values, count, countRunAndMakeAscending(values, count));
+        return;
+    }
+
+    size_t minimumRun = minimumRunLength(count);
+    size_t base = 0;
+    size_t remaining = count;
+    do {
+        size_t runLength = countRunAndMakeAscending(values + base, remaining);
+        if (runLength < minimumRun) {
+            size_t forcedLength = std::min(minimumRun, remaining);
+            binaryInsertionSort(values + base, forcedLength, runLength);
+            runLength = forcedLength;
+        }
+        m_runs.append(Run(base, runLength));
+        mergeCollapse();
+        base += runLength;
+        remaining -= runLength;
+    } while (remaining);
+
+    mergeForceCollapse();
+    ASSERT(m_runs.size() == 1 && m_runs[0].length == count);
+}
 
 void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType, const CallData& callData)
 {
@@ -1082,64 +1336,42 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
 
     // FIXME: This ignores exceptions raised in the compare function or in toNumber.
 
-    // The maximum tree depth is compiled in - but the caller is clearly up to no good
-    // if a larger array is passed.
-    ASSERT(storage->m_length <= static_cast<unsigned>(std::numeric_limits<int>::max()));
-    if (storage->m_length > static_cast<unsigned>(std::numeric_limits<int>::max()))
-        return;
-
     unsigned usedVectorLength = min(storage->m_length, m_vectorLength);
     unsigned nodeCount = usedVectorLength + (storage->m_sparseValueMap ? storage->m_sparseValueMap->size() : 0);
 
     if (!nodeCount)
         return;
 
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44> tree; // Depth 44 is enough for 2^31 items
-    tree.abstractor().m_exec = exec;
-    tree.abstractor().m_compareFunction = compareFunction;
-    tree.abstractor().m_compareCallType = callType;
-    tree.abstractor().m_compareCallData = &callData;
-    tree.abstractor().m_globalThisValue = exec->globalThisValue();
-    tree.abstractor().m_nodes.grow(nodeCount);
-
-    if (callType == CallTypeJS)
-        tree.abstractor().m_cachedCall = adoptPtr(new CachedCall(exec, asFunction(compareFunction), 2));
-
-    if (!tree.abstractor().m_nodes.begin()) {
+    Vector<JSValue> values(nodeCount);
+    if (!values.begin()) {
         throwOutOfMemoryError(exec);
         return;
     }
 
-    // FIXME: If the compare function modifies the array, the vector, map, etc. could be modified
-    // right out from under us while we're building the tree here.
-
     unsigned numDefined = 0;
     unsigned numUndefined = 0;
 
-    // Iterate over the array, ignoring missing values, counting undefined ones, and inserting all other ones into the tree.
+    // Iterate over the array, ignoring missing values, counting undefined ones, and collecting all other ones.
     for (; numDefined < usedVectorLength; ++numDefined) {
         JSValue v = storage->m_vector[numDefined].get();
         if (!v || v.isUndefined())
             break;
-        tree.abstractor().m_nodes[numDefined].value = v;
-        tree.insert(numDefined);
+        values[numDefined] = v;
     }
     for (unsigned i = numDefined; i < usedVectorLength; ++i) {
         JSValue v = storage->m_vector[i].get();
         if (v) {
             if (v.isUndefined())
                 ++numUndefined;
-            else {
-                tree.abstractor().m_nodes[numDefined].value = v;
-                tree.insert(numDefined);
-                ++numDefined;
-            }
+            else
+                values[numDefined++] = v;
         }
     }
 
     unsigned newUsedVectorLength = numDefined + numUndefined;
 
-    if (SparseArrayValueMap* map = storage->m_sparseValueMap) {
+    SparseArrayValueMap* map = storage->m_sparseValueMap;
+    if (map) {
         newUsedVectorLength += map->size();
         if (newUsedVectorLength > m_vectorLength) {
             // Check that it is possible to allocate an array large enough to hold all the entries.
@@ -1151,30 +1383,33 @@ void JSArray::sort(ExecState* exec, JSValue compareFunction, CallType callType,
         
         storage = m_storage;
 
-        SparseArrayValueMap::iterator end = map->end();
-        for (SparseArrayValueMap::iterator it = map->begin(); it != end; ++it) {
-            tree.abstractor().m_nodes[numDefined].value = it->second.get();
-            tree.insert(numDefined);
-            ++numDefined;
-        }
+        // Feed the sparse values in index order so equal elements keep their relative order.
+        Vector<unsigned> indices;
+        copySortedSparseIndices(*map, indices);
+        for (size_t i = 0; i < indices.size(); ++i)
+            values[numDefined++] = map->find(indices[i])->second.get();
+    }
+
+    ASSERT(values.size() >= numDefined);
+
+    // The values being sorted stay reachable from the vector and the sparse map, which
+    // are only rewritten once sorting is done.
+    // FIXME: If the compare function modifies the array, the vector, map, etc. could be modified
+    // right out from under us while we're sorting here.
+    ArrayCompareSorter(exec, compareFunction, callType, callData).sort(values.begin(), numDefined);
 
+    if (map) {
         delete map;
         storage->m_sparseValueMap = 0;
     }
 
-    ASSERT(tree.abstractor().m_nodes.size() >= numDefined);
-
     // FIXME: If the compare function changed the length of the array, the following might be
     // modifying the vector incorrectly.
 
     // Copy the values back into m_storage.
-    AVLTree<AVLTreeAbstractorForArrayCompare, 44>::Iterator iter;
-    iter.start_iter_least(tree);
     JSGlobalData& globalData = exec->globalData();
-    for (unsigned i = 0; i < numDefined; ++i) {
-        storage->m_vector[i].set(globalData, this, tree.abstractor().m_nodes[*iter].value);
-        ++iter;
-    }
+    for (unsigned i = 0; i < numDefined; ++i)
+        storage->m_vector[i].set(globalData, this, values[i]);
 
     // Put undefined values back in.
     for (unsigned i = numDefined; i < newUsedVectorLength; ++i)
@@ -34,6 +34,16 @@ namespace JSC {
     // setStorage() methods.  It is important to note that there may be space before the ArrayStorage that 
     // is used to quick unshift / shift operation.  The actual allocated pointer is available by using:
     //     getStorage() - m_indexBias * sizeof(JSValue)
+    //
+    // m_vector does not track an element kind. Doubles already sit unboxed in each 8-byte
+    // JSValue in both value representations, and the marker rejects a non-cell element with
+    // one tag test. A kind bit would have to be cleared by every store of a cell into
+    // m_vector: the inline put_by_val in both baseline JITs, the DFG's PutByVal and
+    // PutByValAlias, and the writes in JSArray.cpp. Each inline store would gain a tag test
+    // on the value and a conditional write to ArrayStorage, so the bit would cost more per
+    // store than it saves per mark, and one missed clear would let the collector skip live
+    // cells. Numeric workloads that need 4-byte elements or no scanning at all should use
+    // typed arrays.
     struct ArrayStorage {
         unsigned m_length; // The "length" property on the array
         unsigned m_numValuesInVector;
@@ -114,6 +124,9 @@ namespace JSC {
         void shiftCount(ExecState*, int count);
         void unshiftCount(ExecState*, int count);
 
+        // The bytes allocated for the vector, including any room shift() left in front of it.
+        size_t storageBytes() const;
+
         bool canGetIndex(unsigned i) { return i < m_vectorLength && m_storage->m_vector[i]; }
         JSValue getIndex(unsigned i)
         {
@@ -184,6 +197,7 @@ namespace JSC {
         unsigned getNewVectorLength(unsigned desiredLength);
         bool increaseVectorLength(unsigned newLength);
         bool increaseVectorPrefixLength(unsigned newLength);
+        void reportStorageCost(size_t);
         
         unsigned compactForSorting();
 
@@ -41,12 +41,11 @@ JSByteArray::JSByteArray(ExecState* exec, Structure* structure, ByteArray* stora
 {
 }
         
-#if !ASSERT_DISABLED
 JSByteArray::~JSByteArray()
 {
     ASSERT(vptr() == JSGlobalData::jsByteArrayVPtr);
+    Heap::heap(this)->releaseExternalMemory(m_storage->length());
 }
-#endif
 
 
 Structure* JSByteArray::createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype, const JSC::ClassInfo* classInfo)
@@ -102,9 +102,7 @@ namespace JSC {
 
         WTF::ByteArray* storage() const { return m_storage.get(); }
 
-#if !ASSERT_DISABLED
         virtual ~JSByteArray();
-#endif
 
     protected:
         static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesGetPropertyNames | JSObject::StructureFlags;
@@ -113,6 +111,7 @@ namespace JSC {
         {
             Base::finishCreation(exec->globalData());
             putDirect(exec->globalData(), exec->globalData().propertyNames->length, jsNumber(m_storage->length()), ReadOnly | DontDelete);
+            Heap::heap(this)->reportExternalMemory(m_storage->length());
         }
 
     private:
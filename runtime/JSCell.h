@@ -133,6 +133,8 @@ namespace JSC {
         // property names, we want a similar interface with appropriate optimizations.)
         bool fastGetOwnPropertySlot(ExecState*, const Identifier& propertyName, PropertySlot&);
         JSValue fastGetOwnProperty(ExecState*, const UString&);
+        // The property storage offset fastGetOwnProperty reads from, or notFound.
+        size_t fastGetOwnPropertyOffset(ExecState*, const UString&);
 
         static ptrdiff_t structureOffset()
         {
@@ -360,12 +362,21 @@ namespace JSC {
         return isCell() ? asCell()->toThisObject(exec) : toThisObjectSlowCase(exec);
     }
 
+    // Specialize this to false for a type whose destructor does nothing, so
+    // that its cells go in blocks that are swept without running destructors.
+    // Objects don't qualify, because they may own out-of-line property storage.
+    template <typename T> struct NeedsDestructor {
+        static const bool value = true;
+    };
+
     template <typename T> void* allocateCell(Heap& heap)
     {
 #if ENABLE(GC_VALIDATION)
         ASSERT(!heap.globalData()->isInitializingObject());
         heap.globalData()->setInitializingObject(true);
 #endif
+        if (!NeedsDestructor<T>::value)
+            return heap.allocateWithoutDestructor(sizeof(T));
         return heap.allocate(sizeof(T));
     }
         
@@ -31,6 +31,7 @@
 #include "JSGlobalData.h"
 
 #include "ArgList.h"
+#include "CodeBlock.h"
 #include "Heap.h"
 #include "CommonIdentifiers.h"
 #include "DebuggerActivation.h"
@@ -41,6 +42,7 @@
 #include "JSAPIValueWrapper.h"
 #include "JSArray.h"
 #include "JSByteArray.h"
+#include "JSTypedArray.h"
 #include "JSClassRef.h"
 #include "JSFunction.h"
 #include "JSLock.h"
@@ -53,8 +55,13 @@
 #include "Parser.h"
 #include "RegExpCache.h"
 #include "RegExpObject.h"
+#include "SamplingProfiler.h"
+#include "ScriptSourceCache.h"
 #include "StrictEvalActivation.h"
+#include "Watchdog.h"
 #include <wtf/WTFThreadData.h>
+#include <wtf/unicode/Collator.h>
+#include <JSSettingsEA.h>
 #if ENABLE(REGEXP_TRACING)
 #include "RegExp.h"
 #endif
@@ -90,6 +97,63 @@ inline void Recompiler::operator()(JSCell* cell)
     function->jsExecutable()->discardCode();
 }
 
+class ColdCodeDiscarder : public MarkedBlock::VoidFunctor {
+public:
+    ColdCodeDiscarder(unsigned maximumAge)
+        : m_maximumAge(maximumAge)
+    {
+    }
+
+    void operator()(JSCell*);
+
+private:
+    unsigned m_maximumAge;
+};
+
+inline void ColdCodeDiscarder::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&FunctionExecutable::s_info))
+        return;
+    static_cast<FunctionExecutable*>(cell)->ageOrDiscardCode(m_maximumAge);
+}
+
+#if ENABLE(JIT)
+class InlineCacheStatisticsCollector : public MarkedBlock::VoidFunctor {
+public:
+    InlineCacheStatisticsCollector(Vector<JSGlobalData::InlineCacheSite>& sites)
+        : m_sites(sites)
+    {
+    }
+
+    void operator()(JSCell*);
+
+private:
+    void collect(FunctionExecutable*, CodeBlock&);
+
+    Vector<JSGlobalData::InlineCacheSite>& m_sites;
+    Vector<InlineCacheSiteStatistics> m_codeBlockSites;
+};
+
+inline void InlineCacheStatisticsCollector::operator()(JSCell* cell)
+{
+    if (!cell->inherits(&FunctionExecutable::s_info))
+        return;
+    FunctionExecutable* executable = static_cast<FunctionExecutable*>(cell);
+    if (executable->isGeneratedForCall())
+        collect(executable, executable->generatedBytecodeForCall());
+    if (executable->isGeneratedForConstruct())
+        collect(executable, executable->generatedBytecodeForConstruct());
+}
+
+void InlineCacheStatisticsCollector::collect(FunctionExecutable* executable, CodeBlock& codeBlock)
+{
+    m_codeBlockSites.shrink(0);
+    codeBlock.inlineCacheStatistics(m_codeBlockSites);
+    for (size_t i = 0; i < m_codeBlockSites.size(); ++i)
+        m_sites.append(std::make_pair(executable, m_codeBlockSites[i]));
+}
+#endif
+
 } // namespace
 
 namespace JSC {
@@ -116,6 +180,7 @@ extern JSC_CONST_HASHTABLE HashTable stringConstructorTable;
 void* JSGlobalData::jsFinalObjectVPtr;
 void* JSGlobalData::jsArrayVPtr;
 void* JSGlobalData::jsByteArrayVPtr;
+void* JSGlobalData::jsTypedArrayVPtr;
 void* JSGlobalData::jsStringVPtr;
 void* JSGlobalData::jsFunctionVPtr;
 
@@ -131,11 +196,59 @@ void* JSGlobalData::jsFunctionVPtr;
 #endif
 //-EAWebKitChange
 
+// The identifier table, the common identifiers and the built-in property tables hold no heap
+// cells and are not tied to a heap, so thread-confined context groups on the same thread can
+// share one set. It is freed along with the last JSGlobalData using it.
+class SharedBuiltinData : public RefCounted<SharedBuiltinData> {
+public:
+    SharedBuiltinData(JSGlobalData* globalData)
+        : m_ownsIdentifierTable(globalData->globalDataType != JSGlobalData::Default)
+        , m_identifierTable(globalData->identifierTable)
+        , m_propertyNames(globalData->propertyNames)
+    {
+        m_tables.append(globalData->arrayConstructorTable);
+        m_tables.append(globalData->arrayPrototypeTable);
+        m_tables.append(globalData->booleanPrototypeTable);
+        m_tables.append(globalData->dateTable);
+        m_tables.append(globalData->dateConstructorTable);
+        m_tables.append(globalData->errorPrototypeTable);
+        m_tables.append(globalData->globalObjectTable);
+        m_tables.append(globalData->jsonTable);
+        m_tables.append(globalData->mathTable);
+        m_tables.append(globalData->numberConstructorTable);
+        m_tables.append(globalData->numberPrototypeTable);
+        m_tables.append(globalData->objectConstructorTable);
+        m_tables.append(globalData->objectPrototypeTable);
+        m_tables.append(globalData->regExpTable);
+        m_tables.append(globalData->regExpConstructorTable);
+        m_tables.append(globalData->regExpPrototypeTable);
+        m_tables.append(globalData->stringTable);
+        m_tables.append(globalData->stringConstructorTable);
+    }
+
+    ~SharedBuiltinData()
+    {
+        for (size_t i = 0; i < m_tables.size(); ++i) {
+            m_tables[i]->deleteTable();
+            fastDelete(const_cast<HashTable*>(m_tables[i]));
+        }
+        delete m_propertyNames;
+        if (m_ownsIdentifierTable)
+            deleteIdentifierTable(m_identifierTable);
+    }
+
+private:
+    bool m_ownsIdentifierTable;
+    IdentifierTable* m_identifierTable;
+    CommonIdentifiers* m_propertyNames;
+    Vector<const HashTable*, 18> m_tables;
+};
+
 void JSGlobalData::storeVPtrs()
 {
-    // Enough storage to fit a JSArray, JSByteArray, JSString, or JSFunction.
+    // Enough storage to fit a JSArray, JSByteArray, JSTypedArray, JSString, or JSFunction.
     // COMPILE_ASSERTS below check that this is true.
-    char storage[64];
+    char storage[128];
 
     COMPILE_ASSERT(sizeof(JSFinalObject) <= sizeof(storage), sizeof_JSFinalObject_must_be_less_than_storage);
     JSCell* jsFinalObject = new (storage) JSFinalObject(JSFinalObject::VPtrStealingHack);
@@ -152,6 +265,11 @@ void JSGlobalData::storeVPtrs()
     CLOBBER_MEMORY();
     JSGlobalData::jsByteArrayVPtr = jsByteArray->vptr();
 
+    COMPILE_ASSERT(sizeof(JSTypedArray) <= sizeof(storage), sizeof_JSTypedArray_must_be_less_than_storage);
+    JSCell* jsTypedArray = new (storage) JSTypedArray(JSTypedArray::VPtrStealingHack);
+    CLOBBER_MEMORY();
+    JSGlobalData::jsTypedArrayVPtr = jsTypedArray->vptr();
+
     COMPILE_ASSERT(sizeof(JSString) <= sizeof(storage), sizeof_JSString_must_be_less_than_storage);
     JSCell* jsString = new (storage) JSString(JSString::VPtrStealingHack);
     CLOBBER_MEMORY();
@@ -163,37 +281,40 @@ void JSGlobalData::storeVPtrs()
     JSGlobalData::jsFunctionVPtr = jsFunction->vptr();
 }
 
-JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType threadStackType, HeapSize heapSize)
+JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType threadStackType, HeapSize heapSize, JSGlobalData* builtinsSource)
     : globalDataType(globalDataType)
     , clientData(0)
     , topCallFrame(CallFrame::noCaller())
-    , arrayConstructorTable(fastNew<HashTable>(JSC::arrayConstructorTable))
-    , arrayPrototypeTable(fastNew<HashTable>(JSC::arrayPrototypeTable))
-    , booleanPrototypeTable(fastNew<HashTable>(JSC::booleanPrototypeTable))
-    , dateTable(fastNew<HashTable>(JSC::dateTable))
-    , dateConstructorTable(fastNew<HashTable>(JSC::dateConstructorTable))
-    , errorPrototypeTable(fastNew<HashTable>(JSC::errorPrototypeTable))
-    , globalObjectTable(fastNew<HashTable>(JSC::globalObjectTable))
-    , jsonTable(fastNew<HashTable>(JSC::jsonTable))
-    , mathTable(fastNew<HashTable>(JSC::mathTable))
-    , numberConstructorTable(fastNew<HashTable>(JSC::numberConstructorTable))
-    , numberPrototypeTable(fastNew<HashTable>(JSC::numberPrototypeTable))
-    , objectConstructorTable(fastNew<HashTable>(JSC::objectConstructorTable))
-    , objectPrototypeTable(fastNew<HashTable>(JSC::objectPrototypeTable))
-    , regExpTable(fastNew<HashTable>(JSC::regExpTable))
-    , regExpConstructorTable(fastNew<HashTable>(JSC::regExpConstructorTable))
-    , regExpPrototypeTable(fastNew<HashTable>(JSC::regExpPrototypeTable))
-    , stringTable(fastNew<HashTable>(JSC::stringTable))
-    , stringConstructorTable(fastNew<HashTable>(JSC::stringConstructorTable))
-    , identifierTable(globalDataType == Default ? wtfThreadData().currentIdentifierTable() : createIdentifierTable())
-    , propertyNames(new CommonIdentifiers(this))
+    , arrayConstructorTable(builtinsSource ? builtinsSource->arrayConstructorTable : fastNew<HashTable>(JSC::arrayConstructorTable))
+    , arrayPrototypeTable(builtinsSource ? builtinsSource->arrayPrototypeTable : fastNew<HashTable>(JSC::arrayPrototypeTable))
+    , booleanPrototypeTable(builtinsSource ? builtinsSource->booleanPrototypeTable : fastNew<HashTable>(JSC::booleanPrototypeTable))
+    , dateTable(builtinsSource ? builtinsSource->dateTable : fastNew<HashTable>(JSC::dateTable))
+    , dateConstructorTable(builtinsSource ? builtinsSource->dateConstructorTable : fastNew<HashTable>(JSC::dateConstructorTable))
+    , errorPrototypeTable(builtinsSource ? builtinsSource->errorPrototypeTable : fastNew<HashTable>(JSC::errorPrototypeTable))
+    , globalObjectTable(builtinsSource ? builtinsSource->globalObjectTable : fastNew<HashTable>(JSC::globalObjectTable))
+    , jsonTable(builtinsSource ? builtinsSource->jsonTable : fastNew<HashTable>(JSC::jsonTable))
+    , mathTable(builtinsSource ? builtinsSource->mathTable : fastNew<HashTable>(JSC::mathTable))
+    , numberConstructorTable(builtinsSource ? builtinsSource->numberConstructorTable : fastNew<HashTable>(JSC::numberConstructorTable))
+    , numberPrototypeTable(builtinsSource ? builtinsSource->numberPrototypeTable : fastNew<HashTable>(JSC::numberPrototypeTable))
+    , objectConstructorTable(builtinsSource ? builtinsSource->objectConstructorTable : fastNew<HashTable>(JSC::objectConstructorTable))
+    , objectPrototypeTable(builtinsSource ? builtinsSource->objectPrototypeTable : fastNew<HashTable>(JSC::objectPrototypeTable))
+    , regExpTable(builtinsSource ? builtinsSource->regExpTable : fastNew<HashTable>(JSC::regExpTable))
+    , regExpConstructorTable(builtinsSource ? builtinsSource->regExpConstructorTable : fastNew<HashTable>(JSC::regExpConstructorTable))
+    , regExpPrototypeTable(builtinsSource ? builtinsSource->regExpPrototypeTable : fastNew<HashTable>(JSC::regExpPrototypeTable))
+    , stringTable(builtinsSource ? builtinsSource->stringTable : fastNew<HashTable>(JSC::stringTable))
+    , stringConstructorTable(builtinsSource ? builtinsSource->stringConstructorTable : fastNew<HashTable>(JSC::stringConstructorTable))
+    , identifierTable(builtinsSource ? builtinsSource->identifierTable : globalDataType == Default ? wtfThreadData().currentIdentifierTable() : createIdentifierTable())
+    , propertyNames(builtinsSource ? builtinsSource->propertyNames : new CommonIdentifiers(this))
     , emptyList(new MarkedArgumentBuffer)
 #if ENABLE(ASSEMBLER)
     , executableAllocator(*this)
 #endif
     , lexer(new Lexer(this))
     , parser(new Parser)
+    , scriptSourceCache(new ScriptSourceCache(JSGetScriptSourceCacheSize()))
+    , samplingProfiler(0)
     , interpreter(0)
+    , watchdog(0)
     , heap(this, heapSize)
 #if ENABLE(TIERED_COMPILATION)
     , sizeOfLastOSRScratchBuffer(0)
@@ -202,6 +323,9 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
     , cachedUTCOffset(std::numeric_limits<double>::quiet_NaN())
     , maxReentryDepth(threadStackType == ThreadStackTypeSmall ? MaxSmallThreadReentryDepth : MaxLargeThreadReentryDepth)
     , m_regExpCache(new RegExpCache(this))
+    , m_collectionCountAtLastCodeAging(0)
+    , m_isThreadConfined(false)
+    , m_confinedThread(0)
 #if ENABLE(REGEXP_TRACING)
     , m_rtTraceList(new RTTraceList())
 #endif
@@ -212,7 +336,13 @@ JSGlobalData::JSGlobalData(GlobalDataType globalDataType, ThreadStackType thread
     , m_isInitializingObject(false)
 #endif
 {
+    if (builtinsSource)
+        m_sharedBuiltinData = builtinsSource->m_sharedBuiltinData;
+    else
+        m_sharedBuiltinData = adoptRef(new SharedBuiltinData(this));
+
     interpreter = new Interpreter;
+    numericStrings.setCacheSize(JSGetNumericStringCacheSize());
     if (globalDataType == Default)
         m_stack = wtfThreadData().stack();
 
@@ -303,50 +433,15 @@ JSGlobalData::~JSGlobalData()
 {
     // By the time this is destroyed, heap.destroy() must already have been called.
 
+    delete watchdog;
     delete interpreter;
 #ifndef NDEBUG
     // Zeroing out to make the behavior more predictable when someone attempts to use a deleted instance.
     interpreter = 0;
 #endif
 
-    arrayPrototypeTable->deleteTable();
-    arrayConstructorTable->deleteTable();
-    booleanPrototypeTable->deleteTable();
-    dateTable->deleteTable();
-    dateConstructorTable->deleteTable();
-    errorPrototypeTable->deleteTable();
-    globalObjectTable->deleteTable();
-    jsonTable->deleteTable();
-    mathTable->deleteTable();
-    numberConstructorTable->deleteTable();
-    numberPrototypeTable->deleteTable();
-    objectConstructorTable->deleteTable();
-    objectPrototypeTable->deleteTable();
-    regExpTable->deleteTable();
-    regExpConstructorTable->deleteTable();
-    regExpPrototypeTable->deleteTable();
-    stringTable->deleteTable();
-    stringConstructorTable->deleteTable();
-
-    fastDelete(const_cast<HashTable*>(arrayConstructorTable));
-    fastDelete(const_cast<HashTable*>(arrayPrototypeTable));
-    fastDelete(const_cast<HashTable*>(booleanPrototypeTable));
-    fastDelete(const_cast<HashTable*>(dateTable));
-    fastDelete(const_cast<HashTable*>(dateConstructorTable));
-    fastDelete(const_cast<HashTable*>(errorPrototypeTable));
-    fastDelete(const_cast<HashTable*>(globalObjectTable));
-    fastDelete(const_cast<HashTable*>(jsonTable));
-    fastDelete(const_cast<HashTable*>(mathTable));
-    fastDelete(const_cast<HashTable*>(numberConstructorTable));
-    fastDelete(const_cast<HashTable*>(numberPrototypeTable));
-    fastDelete(const_cast<HashTable*>(objectConstructorTable));
-    fastDelete(const_cast<HashTable*>(objectPrototypeTable));
-    fastDelete(const_cast<HashTable*>(regExpTable));
-    fastDelete(const_cast<HashTable*>(regExpConstructorTable));
-    fastDelete(const_cast<HashTable*>(regExpPrototypeTable));
-    fastDelete(const_cast<HashTable*>(stringTable));
-    fastDelete(const_cast<HashTable*>(stringConstructorTable));
-
+    delete samplingProfiler;
+    delete scriptSourceCache;
     delete parser;
     delete lexer;
 
@@ -354,9 +449,8 @@ JSGlobalData::~JSGlobalData()
 
     delete emptyList;
 
-    delete propertyNames;
-    if (globalDataType != Default)
-        deleteIdentifierTable(identifierTable);
+    // The last group using the identifier table and the tables keyed by it frees them.
+    m_sharedBuiltinData = 0;
 
     delete clientData;
     delete m_regExpCache;
@@ -375,6 +469,15 @@ PassRefPtr<JSGlobalData> JSGlobalData::createContextGroup(ThreadStackType type,
     return adoptRef(new JSGlobalData(APIContextGroup, type, heapSize));
 }
 
+PassRefPtr<JSGlobalData> JSGlobalData::createContextGroupSharingBuiltins(JSGlobalData* builtinsSource, ThreadStackType type, HeapSize heapSize)
+{
+    ASSERT(builtinsSource->globalDataType == APIContextGroup);
+    ASSERT(builtinsSource->isThreadConfined() && builtinsSource->isOnConfinedThread());
+    RefPtr<JSGlobalData> globalData = adoptRef(new JSGlobalData(APIContextGroup, type, heapSize, builtinsSource));
+    globalData->setThreadConfined();
+    return globalData.release();
+}
+
 PassRefPtr<JSGlobalData> JSGlobalData::create(ThreadStackType type, HeapSize heapSize)
 {
     return adoptRef(new JSGlobalData(Default, type, heapSize));
@@ -438,6 +541,13 @@ void JSGlobalData::resetDateCache()
     dateInstanceCache.reset();
 }
 
+Collator& JSGlobalData::defaultCollator()
+{
+    if (!m_defaultCollator)
+        m_defaultCollator = Collator::userDefault();
+    return *m_defaultCollator;
+}
+
 void JSGlobalData::startSampling()
 {
     interpreter->startSampling();
@@ -462,9 +572,46 @@ void JSGlobalData::recompileAllJSFunctions()
     // up throwing away code that is live on the stack.
     ASSERT(!dynamicGlobalObject);
     
+    ExecutableMemoryBatchScope batch;
     heap.forEachCell<Recompiler>();
 }
 
+#if ENABLE(JIT)
+void JSGlobalData::collectInlineCacheStatistics(Vector<InlineCacheSite>& sites)
+{
+    InlineCacheStatisticsCollector collector(sites);
+    heap.forEachCell<InlineCacheStatisticsCollector>(collector);
+}
+#endif
+
+void JSGlobalData::discardColdJSFunctions()
+{
+    // Like recompileAllJSFunctions(), this may only run when no code is live
+    // on the stack.
+    ASSERT(!dynamicGlobalObject);
+
+    ExecutableMemoryBatchScope batch;
+    ColdCodeDiscarder discarder(FunctionExecutable::maximumCodeAge);
+    heap.forEachCell<ColdCodeDiscarder>(discarder);
+}
+
+void JSGlobalData::discardColdJSFunctionsAfterCollection()
+{
+    unsigned maximumAge = JSGetCodeAgingCollections();
+    if (!maximumAge || heap.collectionCount() == m_collectionCountAtLastCodeAging)
+        return;
+
+    // Each round ages code by one, so code is discarded once it has gone without a
+    // call for maximumAge rounds, and there is at most one round per collection.
+    // As with discardColdJSFunctions(), no code may be live on the stack.
+    ASSERT(!dynamicGlobalObject);
+    m_collectionCountAtLastCodeAging = heap.collectionCount();
+
+    ExecutableMemoryBatchScope batch;
+    ColdCodeDiscarder discarder(maximumAge);
+    heap.forEachCell<ColdCodeDiscarder>(discarder);
+}
+
 struct StackPreservingRecompiler : public MarkedBlock::VoidFunctor {
     HashSet<FunctionExecutable*> currentlyExecutingFunctions;
     void operator()(JSCell* cell)
@@ -481,6 +628,7 @@ struct StackPreservingRecompiler : public MarkedBlock::VoidFunctor {
 void JSGlobalData::releaseExecutableMemory()
 {
     if (dynamicGlobalObject) {
+        ExecutableMemoryBatchScope batch;
         StackPreservingRecompiler recompiler;
         HashSet<JSCell*> roots;
         heap.getConservativeRegisterRoots(roots);
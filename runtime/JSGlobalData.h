@@ -45,6 +45,7 @@
 #include <wtf/BumpPointerAllocator.h>
 #include <wtf/Forward.h>
 #include <wtf/HashMap.h>
+#include <wtf/InlineHashSet.h>
 #include <wtf/RefCounted.h>
 #include <wtf/ThreadSpecific.h>
 #include <wtf/WTFThreadData.h>
@@ -55,6 +56,10 @@
 struct OpaqueJSClass;
 struct OpaqueJSClassContextData;
 
+namespace WTF {
+    class Collator;
+}
+
 //+EAWebKitChange
 //03/04/2013
 #if PLATFORM(EA)
@@ -70,6 +75,7 @@ namespace JSC {
 
     class CodeBlock;
     class CommonIdentifiers;
+    class FunctionExecutable;
     class HandleStack;
     class IdentifierTable;
     class Interpreter;
@@ -79,7 +85,11 @@ namespace JSC {
     class NativeExecutable;
     class Parser;
     class RegExpCache;
+    class SamplingProfiler;
+    class ScriptSourceCache;
+    class SharedBuiltinData;
     class Stringifier;
+    class Watchdog;
     class Structure;
     class UString;
 #if ENABLE(REGEXP_TRACING)
@@ -87,6 +97,7 @@ namespace JSC {
 #endif
 
     struct HashTable;
+    struct InlineCacheSiteStatistics;
     struct Instruction;
 
     struct DSTOffsetCache {
@@ -109,6 +120,45 @@ namespace JSC {
         double increment;
     };
 
+    // What compiling has cost a JSGlobalData, by tier. Times are in seconds. Sizes are in bytes,
+    // of instructions for bytecode and of machine code for the JITs and YarrJIT.
+    struct CompilationStatistics {
+        enum Tier { BytecodeTier, BaselineJITTier, DFGJITTier, RegExpTier, NumberOfTiers };
+
+        struct TierStatistics {
+            TierStatistics()
+                : count(0)
+                , totalTime(0)
+                , maxTime(0)
+                , totalSize(0)
+            {
+            }
+
+            size_t count;
+            double totalTime;
+            double maxTime;
+            size_t totalSize;
+        };
+
+        CompilationStatistics()
+            : reoptimizationCount(0)
+        {
+        }
+
+        void record(Tier tier, double seconds, size_t size)
+        {
+            TierStatistics& statistics = tiers[tier];
+            ++statistics.count;
+            statistics.totalTime += seconds;
+            if (seconds > statistics.maxTime)
+                statistics.maxTime = seconds;
+            statistics.totalSize += size;
+        }
+
+        TierStatistics tiers[NumberOfTiers];
+        size_t reoptimizationCount; // Optimized code thrown away to be compiled again.
+    };
+
     enum ThreadStackType {
         ThreadStackTypeLarge,
         ThreadStackTypeSmall
@@ -138,6 +188,9 @@ namespace JSC {
         static PassRefPtr<JSGlobalData> create(ThreadStackType, HeapSize = SmallHeap);
         static PassRefPtr<JSGlobalData> createLeaked(ThreadStackType, HeapSize = SmallHeap);
         static PassRefPtr<JSGlobalData> createContextGroup(ThreadStackType, HeapSize = SmallHeap);
+        // Creates a context group that shares the identifier table, common identifiers and built-in
+        // property tables of an existing thread-confined group, so both must stay on its thread.
+        static PassRefPtr<JSGlobalData> createContextGroupSharingBuiltins(JSGlobalData*, ThreadStackType, HeapSize = SmallHeap);
         ~JSGlobalData();
 
 #if ENABLE(JSC_MULTIPLE_THREADS)
@@ -145,6 +198,16 @@ namespace JSC {
         void makeUsableFromMultipleThreads() { heap.machineThreads().makeUsableFromMultipleThreads(); }
 #endif
 
+        // A thread-confined group is only ever used from the thread that created it, so API
+        // entry and exit skip locking and thread registration, and only assert the thread.
+        bool isThreadConfined() const { return m_isThreadConfined; }
+        void setThreadConfined()
+        {
+            m_isThreadConfined = true;
+            m_confinedThread = currentThread();
+        }
+        bool isOnConfinedThread() const { return !m_isThreadConfined || m_confinedThread == currentThread(); }
+
         GlobalDataType globalDataType;
         ClientData* clientData;
         CallFrame* topCallFrame;
@@ -193,6 +256,7 @@ namespace JSC {
         static JS_EXPORTDATA void* jsFinalObjectVPtr;
         static JS_EXPORTDATA void* jsArrayVPtr;
         static JS_EXPORTDATA void* jsByteArrayVPtr;
+        static JS_EXPORTDATA void* jsTypedArrayVPtr;
         static JS_EXPORTDATA void* jsStringVPtr;
         static JS_EXPORTDATA void* jsFunctionVPtr;
 
@@ -207,6 +271,10 @@ namespace JSC {
         ExecutableAllocator executableAllocator;
 #endif
 
+        // The choice is made once per JSGlobalData, not per function. The
+        // interpreter runs bytecode whose instructions hold opcode addresses,
+        // and its call frames can't be entered from or return into JIT code,
+        // so the two can't be mixed within one global data.
 #if !ENABLE(JIT)
         bool canUseJIT() { return false; } // interpreter only
 #elif !ENABLE(INTERPRETER)
@@ -224,6 +292,9 @@ namespace JSC {
 
         Lexer* lexer;
         Parser* parser;
+        ScriptSourceCache* scriptSourceCache;
+        SamplingProfiler* samplingProfiler;
+        CompilationStatistics compilationStatistics;
         Interpreter* interpreter;
 #if ENABLE(JIT)
         OwnPtr<JITThunks> jitStubs;
@@ -237,6 +308,7 @@ namespace JSC {
 
         TimeoutChecker timeoutChecker;
         Terminator terminator;
+        Watchdog* watchdog;
         Heap heap;
 
         JSValue exception;
@@ -274,7 +346,7 @@ namespace JSC {
 
         JSGlobalObject* dynamicGlobalObject;
 
-        HashSet<JSObject*> stringRecursionCheckVisitedObjects;
+        InlineHashSet<JSObject*> stringRecursionCheckVisitedObjects;
 
         double cachedUTCOffset;
         DSTOffsetCache dstOffsetCache;
@@ -285,7 +357,11 @@ namespace JSC {
         int maxReentryDepth;
 
         RegExpCache* m_regExpCache;
+        size_t m_collectionCountAtLastCodeAging;
+        bool m_isThreadConfined;
+        ThreadIdentifier m_confinedThread;
         BumpPointerAllocator m_regExpAllocator;
+        OwnPtr<WTF::Collator> m_defaultCollator;
 
 #if ENABLE(REGEXP_TRACING)
         typedef ListHashSet<RefPtr<RegExp> > RTTraceList;
@@ -310,7 +386,17 @@ namespace JSC {
         void stopSampling();
         void dumpSampleData(ExecState* exec);
         void recompileAllJSFunctions();
+#if ENABLE(JIT)
+        // The inline caches of every compiled function, for finding the sites that went
+        // polymorphic or generic.
+        typedef std::pair<FunctionExecutable*, InlineCacheSiteStatistics> InlineCacheSite;
+        void collectInlineCacheStatistics(Vector<InlineCacheSite>&);
+#endif
+        void discardColdJSFunctions();
+        void discardColdJSFunctionsAfterCollection();
         RegExpCache* regExpCache() { return m_regExpCache; }
+        // The user default collator, created on first use, for localeCompare.
+        WTF::Collator& defaultCollator();
 #if ENABLE(REGEXP_TRACING)
         void addRegExpToTrace(PassRefPtr<RegExp> regExp);
 #endif
@@ -328,12 +414,13 @@ namespace JSC {
 #endif
 
     private:
-        JSGlobalData(GlobalDataType, ThreadStackType, HeapSize);
+        JSGlobalData(GlobalDataType, ThreadStackType, HeapSize, JSGlobalData* builtinsSource = 0);
         static JSGlobalData*& sharedInstanceInternal();
         void createNativeThunk();
 #if ENABLE(JIT) && ENABLE(INTERPRETER)
         bool m_canUseJIT;
 #endif
+        RefPtr<SharedBuiltinData> m_sharedBuiltinData;
         StackBounds m_stack;
 #if ENABLE(GC_VALIDATION)
         bool m_isInitializingObject;
@@ -181,6 +181,13 @@ static inline JSObject* lastInPrototypeChain(JSObject* object)
     return o;
 }
 
+// Builds the built-ins from scratch. There is no heap snapshot to copy them from instead: cells
+// hold raw pointers to their Structures, global object and JIT code, identifiers belong to the
+// thread's identifier table, and CodeBlocks are linked to their global object as they are
+// generated, so a serialized heap would need every word relocated and every identifier and code
+// block re-resolved, which is most of what this function and the embedder's scripts do anyway.
+// What is built here is a few hundred small cells; the prototype functions themselves are only
+// created when first looked up, through the static hash tables.
 void JSGlobalObject::reset(JSValue prototype)
 {
     ExecState* exec = JSGlobalObject::globalExec();
@@ -280,6 +287,22 @@ void JSGlobalObject::reset(JSValue prototype)
     putDirectFunctionWithoutTransition(exec->globalData(), Identifier(exec, "TypeError"), m_typeErrorConstructor.get(), DontEnum);
     putDirectFunctionWithoutTransition(exec->globalData(), Identifier(exec, "URIError"), m_URIErrorConstructor.get(), DontEnum);
 
+    JSObject* arrayBufferPrototype = createArrayBufferPrototype(exec, this);
+    m_arrayBufferStructure.set(exec->globalData(), this, JSArrayBuffer::createStructure(exec->globalData(), this, arrayBufferPrototype));
+    JSCell* arrayBufferConstructor = ArrayBufferConstructor::create(exec, this, ArrayBufferConstructor::createStructure(exec->globalData(), this, m_functionPrototype.get()), arrayBufferPrototype);
+    arrayBufferPrototype->putDirectFunctionWithoutTransition(exec->globalData(), exec->propertyNames().constructor, arrayBufferConstructor, DontEnum);
+    putDirectFunctionWithoutTransition(exec->globalData(), Identifier(exec, "ArrayBuffer"), arrayBufferConstructor, DontEnum);
+
+    Structure* typedArrayConstructorStructure = TypedArrayConstructor::createStructure(exec->globalData(), this, m_functionPrototype.get());
+    for (unsigned i = 0; i < numberOfTypedArrayTypes; ++i) {
+        TypedArrayType type = static_cast<TypedArrayType>(i);
+        JSObject* typedArrayPrototype = createTypedArrayPrototype(exec, this, type);
+        m_typedArrayStructures[i].set(exec->globalData(), this, JSTypedArray::createStructure(exec->globalData(), this, typedArrayPrototype));
+        JSCell* typedArrayConstructor = TypedArrayConstructor::create(exec, this, typedArrayConstructorStructure, type, typedArrayPrototype);
+        typedArrayPrototype->putDirectFunctionWithoutTransition(exec->globalData(), exec->propertyNames().constructor, typedArrayConstructor, DontEnum);
+        putDirectFunctionWithoutTransition(exec->globalData(), Identifier(exec, nameForTypedArray(type)), typedArrayConstructor, DontEnum);
+    }
+
     m_evalFunction.set(exec->globalData(), this, JSFunction::create(exec, this, m_functionStructure.get(), 1, exec->propertyNames().eval, globalFuncEval));
     putDirectFunctionWithoutTransition(exec, m_evalFunction.get(), DontEnum);
 
@@ -355,6 +378,9 @@ void JSGlobalObject::visitChildren(SlotVisitor& visitor)
     visitIfNeeded(visitor, &m_regExpStructure);
     visitIfNeeded(visitor, &m_stringObjectStructure);
     visitIfNeeded(visitor, &m_internalFunctionStructure);
+    visitIfNeeded(visitor, &m_arrayBufferStructure);
+    for (unsigned i = 0; i < numberOfTypedArrayTypes; ++i)
+        visitIfNeeded(visitor, &m_typedArrayStructures[i]);
 
     if (m_registerArray) {
         // Outside the execution of global code, when our variables are torn off,
@@ -443,8 +469,10 @@ DynamicGlobalObjectScope::DynamicGlobalObjectScope(JSGlobalData& globalData, JSG
     if (!m_dynamicGlobalObjectSlot) {
 #if ENABLE(ASSEMBLER)
         if (ExecutableAllocator::underMemoryPressure())
-            globalData.recompileAllJSFunctions();
+            globalData.discardColdJSFunctions();
+        else
 #endif
+            globalData.discardColdJSFunctionsAfterCollection();
 
         m_dynamicGlobalObjectSlot = dynamicGlobalObject;
 
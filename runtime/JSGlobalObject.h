@@ -26,6 +26,7 @@
 #include "JSGlobalData.h"
 #include "JSVariableObject.h"
 #include "JSWeakObjectMapRefInternal.h"
+#include "JSTypedArray.h"
 #include "NumberPrototype.h"
 #include "StringPrototype.h"
 #include "StructureChain.h"
@@ -123,6 +124,8 @@ namespace JSC {
         WriteBarrier<Structure> m_regExpStructure;
         WriteBarrier<Structure> m_stringObjectStructure;
         WriteBarrier<Structure> m_internalFunctionStructure;
+        WriteBarrier<Structure> m_arrayBufferStructure;
+        WriteBarrier<Structure> m_typedArrayStructures[numberOfTypedArrayTypes];
 
         Debugger* m_debugger;
 
@@ -235,6 +238,8 @@ namespace JSC {
         Structure* regExpMatchesArrayStructure() const { return m_regExpMatchesArrayStructure.get(); }
         Structure* regExpStructure() const { return m_regExpStructure.get(); }
         Structure* stringObjectStructure() const { return m_stringObjectStructure.get(); }
+        Structure* arrayBufferStructure() const { return m_arrayBufferStructure.get(); }
+        Structure* typedArrayStructure(TypedArrayType type) const { return m_typedArrayStructures[type].get(); }
 
         void setProfileGroup(unsigned value) { createRareDataIfNeeded(); m_rareData->profileGroup = value; }
         unsigned profileGroup() const
@@ -291,6 +296,8 @@ namespace JSC {
         }
 
         double weakRandomNumber() { return m_weakRandom.get(); }
+        unsigned weakRandomUint32() { return m_weakRandom.getUint32(); }
+        static size_t offsetOfWeakRandom() { return OBJECT_OFFSETOF(JSGlobalObject, m_weakRandom); }
     protected:
 
         static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesVisitChildren | OverridesGetPropertyNames | JSVariableObject::StructureFlags;
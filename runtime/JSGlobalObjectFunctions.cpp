@@ -316,6 +316,13 @@ static double jsStrDecimalLiteral(const UChar*& data, const UChar* end)
 {
     ASSERT(data < end);
 
+    double fastNumber;
+    size_t parsedLength;
+    if (WTF::strtodFastPath(data, end, fastNumber, parsedLength)) {
+        data += parsedLength;
+        return fastNumber;
+    }
+
     // Copy the sting into a null-terminated byte buffer, and call strtod.
     Vector<char, 32> byteBuffer;
     for (const UChar* characters = data; characters < end; ++characters) {
@@ -173,7 +173,23 @@ bool JSLock::currentThreadIsHoldingLock()
 static unsigned lockDropDepth = 0;
 
 JSLock::DropAllLocks::DropAllLocks(ExecState* exec)
-    : m_lockBehavior(exec->globalData().isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
+    : m_lockCount(0)
+    , m_lockBehavior(exec->globalData().isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
+    , m_dropsLocks(true)
+{
+    dropAll();
+}
+
+JSLock::DropAllLocks::DropAllLocks(DropMode mode, ExecState* exec)
+    : m_lockCount(0)
+    , m_lockBehavior(exec->globalData().isSharedInstance() ? LockForReal : SilenceAssertionsOnly)
+    , m_dropsLocks(mode == DropAll)
+{
+    if (m_dropsLocks)
+        dropAll();
+}
+
+void JSLock::DropAllLocks::dropAll()
 {
     pthread_once(&createJSLockCountOnce, createJSLockCount);
 
@@ -188,7 +204,9 @@ JSLock::DropAllLocks::DropAllLocks(ExecState* exec)
 }
 
 JSLock::DropAllLocks::DropAllLocks(JSLockBehavior JSLockBehavior)
-    : m_lockBehavior(JSLockBehavior)
+    : m_lockCount(0)
+    , m_lockBehavior(JSLockBehavior)
+    , m_dropsLocks(true)
 {
     pthread_once(&createJSLockCountOnce, createJSLockCount);
 
@@ -207,6 +225,9 @@ JSLock::DropAllLocks::DropAllLocks(JSLockBehavior JSLockBehavior)
 
 JSLock::DropAllLocks::~DropAllLocks()
 {
+    if (!m_dropsLocks)
+        return;
+
     for (intptr_t i = 0; i < m_lockCount; i++)
         JSLock::lock(m_lockBehavior);
 
@@ -252,6 +273,10 @@ JSLock::DropAllLocks::DropAllLocks(ExecState*)
 {
 }
 
+JSLock::DropAllLocks::DropAllLocks(DropMode, ExecState*)
+{
+}
+
 JSLock::DropAllLocks::DropAllLocks(JSLockBehavior)
 {
 }
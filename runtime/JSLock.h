@@ -93,13 +93,21 @@ namespace JSC {
         class DropAllLocks {
             WTF_MAKE_NONCOPYABLE(DropAllLocks);
         public:
+            // DropNone is for thread-confined context groups, which no other thread can
+            // enter while this one is out in a callback, so there is nothing to release.
+            enum DropMode { DropAll, DropNone };
+
             DropAllLocks(ExecState* exec);
+            DropAllLocks(DropMode, ExecState*);
             DropAllLocks(JSLockBehavior);
             ~DropAllLocks();
             
         private:
+            void dropAll();
+
             intptr_t m_lockCount;
             JSLockBehavior m_lockBehavior;
+            bool m_dropsLocks;
         };
     };
 
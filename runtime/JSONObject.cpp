@@ -36,8 +36,10 @@
 #include "LocalScope.h"
 #include "Lookup.h"
 #include "PropertyNameArray.h"
+#include "Strong.h"
 #include "UStringBuilder.h"
 #include "UStringConcatenate.h"
+#include <wtf/HashMap.h>
 #include <wtf/MathExtras.h>
 
 namespace JSC {
@@ -82,11 +84,30 @@ class Stringifier {
     WTF_MAKE_NONCOPYABLE(Stringifier);
 public:
     Stringifier(ExecState*, const Local<Unknown>& replacer, const Local<Unknown>& space);
+    ~Stringifier();
     Local<Unknown> stringify(Handle<Unknown>);
+    bool stringify(Handle<Unknown>, JSONChunkCallback, void* userData);
 
     void visitAggregate(SlotVisitor&);
 
 private:
+    // The enumeration order, storage offsets and quoted names of the own properties
+    // of plain objects sharing a Structure, so records of the same shape are written
+    // without a property enumeration or lookup per object.
+    struct ObjectShape {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        ObjectShape(JSGlobalData& globalData, Structure* structure)
+            : structure(globalData, structure)
+        {
+        }
+
+        Strong<Structure> structure;
+        RefPtr<PropertyNameArrayData> propertyNames;
+        Vector<size_t> offsets;
+        Vector<UString> quotedNames;
+    };
+
     class Holder {
     public:
         Holder(JSGlobalData&, JSObject*);
@@ -102,11 +123,17 @@ private:
         unsigned m_index;
         unsigned m_size;
         RefPtr<PropertyNameArrayData> m_propertyNames;
+        ObjectShape* m_shape;
     };
 
     friend class Holder;
 
     static void appendQuotedString(UStringBuilder&, const UString&);
+    static void appendInt32(UStringBuilder&, int32_t);
+
+    bool flushChunk(UStringBuilder&);
+
+    ObjectShape* shapeFor(JSObject*);
 
     JSValue toJSON(JSValue, const PropertyNameForFunctionCall&);
 
@@ -129,6 +156,12 @@ private:
     Vector<Holder, 16> m_holderStack;
     UString m_repeatedGap;
     UString m_indent;
+
+    typedef HashMap<Structure*, ObjectShape*> ObjectShapeMap;
+    ObjectShapeMap m_objectShapes;
+
+    JSONChunkCallback m_chunkCallback;
+    void* m_chunkUserData;
 };
 
 // ------------------------------ helper functions --------------------------------
@@ -209,6 +242,8 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     , m_arrayReplacerPropertyNames(exec)
     , m_replacerCallType(CallTypeNone)
     , m_gap(gap(exec, space.get()))
+    , m_chunkCallback(0)
+    , m_chunkUserData(0)
 {
     if (!m_replacer.isObject())
         return;
@@ -249,6 +284,11 @@ Stringifier::Stringifier(ExecState* exec, const Local<Unknown>& replacer, const
     m_replacerCallType = m_replacer.asObject()->getCallData(m_replacerCallData);
 }
 
+Stringifier::~Stringifier()
+{
+    deleteAllValues(m_objectShapes);
+}
+
 Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
 {
     JSObject* object = constructEmptyObject(m_exec);
@@ -267,6 +307,42 @@ Local<Unknown> Stringifier::stringify(Handle<Unknown> value)
     return Local<Unknown>(m_exec->globalData(), jsString(m_exec, result.toUString()));
 }
 
+bool Stringifier::stringify(Handle<Unknown> value, JSONChunkCallback callback, void* userData)
+{
+    JSObject* object = constructEmptyObject(m_exec);
+    if (m_exec->hadException())
+        return false;
+
+    PropertyNameForFunctionCall emptyPropertyName(m_exec->globalData().propertyNames->emptyIdentifier);
+    object->putDirect(m_exec->globalData(), m_exec->globalData().propertyNames->emptyIdentifier, value.get());
+
+    m_chunkCallback = callback;
+    m_chunkUserData = userData;
+
+    UStringBuilder result;
+    if (appendStringifiedValue(result, value.get(), object, emptyPropertyName) != StringifySucceeded)
+        return false;
+    if (m_exec->hadException())
+        return false;
+
+    return result.isEmpty() || callback(result.characters(), result.length(), userData);
+}
+
+// Hands everything but the last character to the chunk callback. Holders only look
+// back at the last character, and only roll back within a single property, so text
+// before it is final once appendNextProperty has returned.
+bool Stringifier::flushChunk(UStringBuilder& builder)
+{
+    ASSERT(m_chunkCallback && !builder.isEmpty());
+    unsigned length = builder.length() - 1;
+    UChar last = builder[length];
+    if (!m_chunkCallback(builder.characters(), length, m_chunkUserData))
+        return false;
+    builder.resize(0);
+    builder.append(last);
+    return true;
+}
+
 void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& value)
 {
     int length = value.length();
@@ -322,6 +398,61 @@ void Stringifier::appendQuotedString(UStringBuilder& builder, const UString& val
     builder.append('"');
 }
 
+void Stringifier::appendInt32(UStringBuilder& builder, int32_t value)
+{
+    UChar buffer[12];
+    UChar* end = buffer + WTF_ARRAY_LENGTH(buffer);
+    UChar* p = end;
+    uint32_t magnitude = value < 0 ? -static_cast<uint32_t>(value) : static_cast<uint32_t>(value);
+    do {
+        *--p = static_cast<UChar>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (value < 0)
+        *--p = '-';
+    builder.append(p, end - p);
+}
+
+// Only plain objects whose properties are all data properties held in the
+// Structure's property table qualify; anything else, including dictionaries whose
+// Structure changes in place, goes through the generic enumeration.
+Stringifier::ObjectShape* Stringifier::shapeFor(JSObject* object)
+{
+    static const unsigned maximumObjectShapes = 64;
+
+    Structure* structure = object->structure();
+    if (object->classInfo() != &JSObject::s_info || structure->isDictionary() || structure->hasGetterSetterProperties())
+        return 0;
+    if (structure->typeInfo().overridesGetOwnPropertySlot() || structure->typeInfo().overridesGetPropertyNames())
+        return 0;
+
+    ObjectShapeMap::iterator it = m_objectShapes.find(structure);
+    if (it != m_objectShapes.end())
+        return it->second;
+    if (m_objectShapes.size() >= maximumObjectShapes)
+        return 0;
+
+    JSGlobalData& globalData = m_exec->globalData();
+    PropertyNameArray objectPropertyNames(m_exec);
+    object->getOwnPropertyNames(m_exec, objectPropertyNames);
+
+    ObjectShape* shape = new ObjectShape(globalData, structure);
+    shape->propertyNames = objectPropertyNames.releaseData();
+    const PropertyNameArrayData::PropertyNameVector& names = shape->propertyNames->propertyNameVector();
+    shape->offsets.reserveInitialCapacity(names.size());
+    shape->quotedNames.reserveInitialCapacity(names.size());
+    for (size_t i = 0; i < names.size(); ++i) {
+        size_t offset = structure->get(globalData, names[i]);
+        ASSERT(offset != WTF::notFound);
+        shape->offsets.uncheckedAppend(offset);
+        UStringBuilder quotedName;
+        appendQuotedString(quotedName, names[i].ustring());
+        shape->quotedNames.uncheckedAppend(quotedName.toUString());
+    }
+    m_objectShapes.set(structure, shape);
+    return shape;
+}
+
 inline JSValue Stringifier::toJSON(JSValue value, const PropertyNameForFunctionCall& propertyName)
 {
     ASSERT(!m_exec->hadException());
@@ -380,6 +511,11 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         return StringifySucceeded;
     }
 
+    if (value.isInt32()) {
+        appendInt32(builder, value.asInt32());
+        return StringifySucceeded;
+    }
+
     UString stringValue;
     if (value.getString(m_exec, stringValue)) {
         appendQuotedString(builder, stringValue);
@@ -422,6 +558,7 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         return StringifySucceeded;
 
     // If this is the outermost call, then loop to handle everything on the holder stack.
+    static const unsigned chunkFlushThreshold = 16 * 1024;
     TimeoutChecker localTimeoutChecker(m_exec->globalData().timeoutChecker);
     localTimeoutChecker.reset();
     unsigned tickCount = localTimeoutChecker.ticksUntilNextCheck();
@@ -429,6 +566,8 @@ Stringifier::StringifyResult Stringifier::appendStringifiedValue(UStringBuilder&
         while (m_holderStack.last().appendNextProperty(*this, builder)) {
             if (m_exec->hadException())
                 return StringifyFailed;
+            if (m_chunkCallback && builder.length() >= chunkFlushThreshold && !flushChunk(builder))
+                return StringifyFailed;
             if (!--tickCount) {
                 if (localTimeoutChecker.didTimeOut(m_exec)) {
                     throwError(m_exec, createInterruptedExecutionException(&m_exec->globalData()));
@@ -475,6 +614,7 @@ inline Stringifier::Holder::Holder(JSGlobalData& globalData, JSObject* object)
     : m_object(globalData, object)
     , m_isArray(object->inherits(&JSArray::s_info))
     , m_index(0)
+    , m_shape(0)
 {
 }
 
@@ -493,6 +633,8 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         } else {
             if (stringifier.m_usingArrayReplacer)
                 m_propertyNames = stringifier.m_arrayReplacerPropertyNames.data();
+            else if ((m_shape = stringifier.shapeFor(m_object.get())))
+                m_propertyNames = m_shape->propertyNames;
             else {
                 PropertyNameArray objectPropertyNames(exec);
                 m_object->getOwnPropertyNames(exec, objectPropertyNames);
@@ -539,14 +681,21 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         // Append the stringified value.
         stringifyResult = stringifier.appendStringifiedValue(builder, value, m_object.get(), index);
     } else {
-        // Get the value.
-        PropertySlot slot(m_object.get());
+        // Get the value. A toJSON or replacer call may have reshaped the object since
+        // the shape was taken, in which case the generic lookup is used.
         Identifier& propertyName = m_propertyNames->propertyNameVector()[index];
-        if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
-            return true;
-        JSValue value = slot.getValue(exec, propertyName);
-        if (exec->hadException())
-            return false;
+        bool shapeMatches = m_shape && m_object->structure() == m_shape->structure.get();
+        JSValue value;
+        if (shapeMatches)
+            value = m_object->getDirectOffset(m_shape->offsets[index]);
+        else {
+            PropertySlot slot(m_object.get());
+            if (!m_object->getOwnPropertySlot(exec, propertyName, slot))
+                return true;
+            value = slot.getValue(exec, propertyName);
+            if (exec->hadException())
+                return false;
+        }
 
         rollBackPoint = builder.length();
 
@@ -556,7 +705,10 @@ bool Stringifier::Holder::appendNextProperty(Stringifier& stringifier, UStringBu
         stringifier.startNewLine(builder);
 
         // Append the property name.
-        appendQuotedString(builder, propertyName.ustring());
+        if (m_shape)
+            builder.append(m_shape->quotedNames[index]);
+        else
+            appendQuotedString(builder, propertyName.ustring());
         builder.append(':');
         if (stringifier.willIndent())
             builder.append(' ');
@@ -858,4 +1010,10 @@ UString JSONStringify(ExecState* exec, JSValue value, unsigned indent)
     return result.getString(exec);
 }
 
+bool JSONStringify(ExecState* exec, JSValue value, unsigned indent, JSONChunkCallback callback, void* userData)
+{
+    LocalScope scope(exec->globalData());
+    return Stringifier(exec, Local<Unknown>(exec->globalData(), jsNull()), Local<Unknown>(exec->globalData(), jsNumber(indent))).stringify(Local<Unknown>(exec->globalData(), value), callback, userData);
+}
+
 } // namespace JSC
@@ -63,6 +63,15 @@ namespace JSC {
 
     UString JSONStringify(ExecState* exec, JSValue value, unsigned indent);
 
+    // Receives the serialized text in consecutive pieces; returning false stops the
+    // serialization.
+    typedef bool (*JSONChunkCallback)(const UChar* characters, size_t length, void* userData);
+
+    // Serializes without ever holding the whole text. Returns false if the value has
+    // no JSON representation, an exception was thrown or the callback stopped; any
+    // chunks delivered before that point are then incomplete.
+    bool JSONStringify(ExecState*, JSValue, unsigned indent, JSONChunkCallback, void* userData);
+
 } // namespace JSC
 
 #endif // JSONObject_h
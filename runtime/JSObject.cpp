@@ -158,6 +158,8 @@ void JSObject::put(ExecState* exec, const Identifier& propertyName, JSValue valu
                 MarkedArgumentBuffer args;
                 args.append(value);
 
+                slot.setSetterProperty(obj, obj->structure()->get(exec->globalData(), propertyName));
+
                 // If this is WebCore's global object then we need to substitute the shell.
                 call(exec, setterFunc, callType, callData, this->toThisObject(exec), args);
                 return;
@@ -607,31 +609,41 @@ Structure* JSObject::createInheritorID(JSGlobalData& globalData)
     return m_inheritorID.get();
 }
 
+void JSObject::refreshInheritorID(JSGlobalData& globalData, Structure* staleInheritorID)
+{
+    if (m_inheritorID.get() != staleInheritorID)
+        return;
+
+    // Objects already built keep their transition chain; new ones start on a chain that
+    // inherits the learned out-of-line capacity.
+    Structure* inheritorID = createEmptyObjectStructure(globalData, m_structure->globalObject(), this);
+    inheritorID->setOutOfLineCapacityHint(staleInheritorID->outOfLineCapacityHint());
+    m_inheritorID.set(globalData, this, inheritorID);
+}
+
 void JSObject::allocatePropertyStorage(JSGlobalData& globalData, size_t oldSize, size_t newSize)
 {
     ASSERT(newSize > oldSize);
 
     // It's important that this function not rely on m_structure, since
     // we might be in the middle of a transition.
+    PropertyStorage oldPropertyStorage = m_propertyStorage.get();
+    bool wasInNursery = globalData.heap.inPropertyStorageNursery(oldPropertyStorage);
+
+    // Storage that is still young grows in the nursery. Storage that survived
+    // a collection has already been copied to old space, and stays there.
     PropertyStorage newPropertyStorage = 0;
-    if (globalData.heap.inPropertyStorageNursery(m_propertyStorage.get())) {
+    if (wasInNursery || isUsingInlineStorage())
         newPropertyStorage = static_cast<PropertyStorage>(globalData.heap.allocatePropertyStorage(newSize * sizeof(WriteBarrierBase<Unknown>)));
-        if (!newPropertyStorage || !globalData.heap.inPropertyStorageNursery(m_propertyStorage.get())) {
-            // If allocation failed because it's too big, or it triggered a GC
-            // that promoted us to old space, we need to allocate our property
-            // storage in old space.
-            newPropertyStorage = new WriteBarrierBase<Unknown>[newSize];
-        }
-    } else
+    if (!newPropertyStorage) {
+        // The allocation was too big, or the nursery is full.
         newPropertyStorage = new WriteBarrierBase<Unknown>[newSize];
-
-    PropertyStorage oldPropertyStorage = m_propertyStorage.get();
-    ASSERT(newPropertyStorage);
+    }
 
     for (unsigned i = 0; i < oldSize; ++i)
        newPropertyStorage[i] = oldPropertyStorage[i];
 
-    if (!isUsingInlineStorage() && !globalData.heap.inPropertyStorageNursery(m_propertyStorage.get()))
+    if (!isUsingInlineStorage() && !wasInNursery)
         delete [] oldPropertyStorage;
 
     m_propertyStorage.set(globalData, this, newPropertyStorage);
@@ -92,6 +92,7 @@ namespace JSC {
         
         void setStructure(JSGlobalData&, Structure*);
         Structure* inheritorID(JSGlobalData&);
+        void refreshInheritorID(JSGlobalData&, Structure* staleInheritorID);
 
         virtual UString className() const;
 
@@ -546,15 +547,20 @@ ALWAYS_INLINE bool JSCell::fastGetOwnPropertySlot(ExecState* exec, const Identif
 // identifier. The first time we perform a property access with a given string, try
 // performing the property map lookup without forming an identifier. We detect this
 // case by checking whether the hash has yet been set for this string.
+ALWAYS_INLINE size_t JSCell::fastGetOwnPropertyOffset(ExecState* exec, const UString& name)
+{
+    if (m_structure->typeInfo().overridesGetOwnPropertySlot() || m_structure->hasGetterSetterProperties())
+        return WTF::notFound;
+    return name.impl()->hasHash()
+        ? m_structure->get(exec->globalData(), Identifier(exec, name))
+        : m_structure->get(exec->globalData(), name);
+}
+
 ALWAYS_INLINE JSValue JSCell::fastGetOwnProperty(ExecState* exec, const UString& name)
 {
-    if (!m_structure->typeInfo().overridesGetOwnPropertySlot() && !m_structure->hasGetterSetterProperties()) {
-        size_t offset = name.impl()->hasHash()
-            ? m_structure->get(exec->globalData(), Identifier(exec, name))
-            : m_structure->get(exec->globalData(), name);
-        if (offset != WTF::notFound)
-            return asObject(this)->locationForOffset(offset)->get();
-    }
+    size_t offset = fastGetOwnPropertyOffset(exec, name);
+    if (offset != WTF::notFound)
+        return asObject(this)->locationForOffset(offset)->get();
     return JSValue();
 }
 
@@ -873,8 +879,6 @@ ALWAYS_INLINE void JSObject::visitChildrenDirect(SlotVisitor& visitor)
     PropertyStorage storage = propertyStorage();
     if (Heap::heap(this)->inPropertyStorageNursery(storage)) {
         m_propertyStorage.set(new WriteBarrierBase<Unknown>[structure()->propertyStorageCapacity()], StorageBarrier::Unchecked);
-        if (structure()->propertyStorageCapacity() > m_structure->propertyStorageSize())
-            ASSERT(!storage[m_structure->propertyStorageSize()]);
         memcpy(m_propertyStorage.get(), storage, m_structure->propertyStorageSize() * sizeof(WriteBarrierBase<Unknown>));
     }
     size_t storageSize = m_structure->propertyStorageSize();
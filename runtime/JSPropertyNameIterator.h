@@ -69,6 +69,7 @@ namespace JSC {
         }
 
         JSValue get(ExecState*, JSObject*, size_t i);
+        JSValue name(size_t i) { return m_jsStrings[i].get(); }
         size_t size() { return m_jsStringsSize; }
 
         void setCachedStructure(JSGlobalData& globalData, Structure* structure)
@@ -114,6 +115,17 @@ namespace JSC {
         return m_enumerationCache.get();
     }
 
+    inline void Structure::setOwnKeysCache(JSGlobalData& globalData, JSPropertyNameIterator* ownKeysCache)
+    {
+        ASSERT(!isDictionary());
+        m_ownKeysCache.set(globalData, this, ownKeysCache);
+    }
+
+    inline JSPropertyNameIterator* Structure::ownKeysCache()
+    {
+        return m_ownKeysCache.get();
+    }
+
     ALWAYS_INLINE JSPropertyNameIterator* Register::propertyNameIterator() const
     {
         return static_cast<JSPropertyNameIterator*>(jsValue().asCell());
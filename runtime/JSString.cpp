@@ -33,6 +33,7 @@
 namespace JSC {
     
 static const unsigned substringFromRopeCutoff = 4;
+static const unsigned ropeFiberSearchLimit = 256;
 
 const ClassInfo JSString::s_info = { "string", 0, 0, 0 };
 
@@ -48,6 +49,11 @@ void JSString::resolveRope(ExecState* exec) const
         return;
     }
 
+    // From here on the string owns the flattened characters rather than its
+    // fibers, so its accounting moves over to the new buffer.
+    releaseExternalMemory();
+    reportExternalMemory(m_value.impl()->cost());
+
     RopeImpl::Fiber currentFiber = m_fibers[0];
 
     if ((m_fiberCount > 2) || (RopeImpl::isRope(currentFiber)) 
@@ -151,6 +157,42 @@ void JSString::outOfMemory(ExecState* exec) const
         throwOutOfMemoryError(exec);
 }
 
+// Walks down the rope to the single non-rope fiber that holds all of [offset, offset + length),
+// so that reads of a small part of a large rope don't have to flatten it. Returns 0 if the range
+// straddles fibers, or if the rope is too deep to be worth walking.
+StringImpl* JSString::ropeFiberContaining(unsigned offset, unsigned length, unsigned& offsetInFiber) const
+{
+    ASSERT(isRope());
+    ASSERT(offset + length <= m_length);
+
+    const RopeImpl::Fiber* fibers = m_fibers.data();
+    unsigned fiberCount = m_fiberCount;
+    unsigned steps = 0;
+    while (true) {
+        RopeImpl::Fiber fiber = 0;
+        for (unsigned i = 0; i < fiberCount; ++i) {
+            if (++steps > ropeFiberSearchLimit)
+                return 0;
+            unsigned fiberLength = fibers[i]->length();
+            if (offset < fiberLength) {
+                fiber = fibers[i];
+                break;
+            }
+            offset -= fiberLength;
+        }
+        ASSERT(fiber);
+        if (offset + length > fiber->length())
+            return 0;
+        if (!RopeImpl::isRope(fiber)) {
+            offsetInFiber = offset;
+            return static_cast<StringImpl*>(fiber);
+        }
+        RopeImpl* rope = static_cast<RopeImpl*>(fiber);
+        fibers = rope->fibers();
+        fiberCount = rope->fiberCount();
+    }
+}
+
 // This function construsts a substring out of a rope without flattening by reusing the existing fibers.
 // This can reduce memory usage substantially. Since traversing ropes is slow the function will revert 
 // back to flattening if the rope turns out to be long.
@@ -161,6 +203,10 @@ JSString* JSString::substringFromRope(ExecState* exec, unsigned substringStart,
     
     JSGlobalData* globalData = &exec->globalData();
 
+    unsigned offsetInFiber;
+    if (StringImpl* fiber = ropeFiberContaining(substringStart, substringLength, offsetInFiber))
+        return jsSubstring(globalData, UString(fiber), offsetInFiber, substringLength);
+
     UString substringFibers[3];
     
     unsigned fiberCount = 0;
@@ -260,6 +306,9 @@ JSValue JSString::replaceCharacter(ExecState* exec, UChar character, const UStri
 JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
 {
     ASSERT(isRope());
+    unsigned offsetInFiber;
+    if (StringImpl* fiber = ropeFiberContaining(i, 1, offsetInFiber))
+        return jsSingleCharacterSubstring(exec, UString(fiber), offsetInFiber);
     resolveRope(exec);
     // Return a safe no-value result, this should never be used, since the excetion will be thrown.
     if (exec->exception())
@@ -269,6 +318,35 @@ JSString* JSString::getIndexSlowCase(ExecState* exec, unsigned i)
     return jsSingleCharacterSubstring(exec, m_value, i);
 }
 
+UChar JSString::characterAt(ExecState* exec, unsigned i)
+{
+    ASSERT(i < m_length);
+    if (isRope()) {
+        unsigned offsetInFiber;
+        if (StringImpl* fiber = ropeFiberContaining(i, 1, offsetInFiber))
+            return fiber->characters()[offsetInFiber];
+        resolveRope(exec);
+        if (exec->exception())
+            return 0;
+    }
+    return m_value.characters()[i];
+}
+
+// Copies all length() characters into buffer. A rope is read fiber by fiber and is left as it is.
+void JSString::copyCharacters(UChar* buffer) const
+{
+    if (!isRope()) {
+        StringImpl::copyChars(buffer, m_value.characters(), m_value.length());
+        return;
+    }
+    RopeIterator end;
+    for (RopeIterator it(m_fibers.data(), m_fiberCount); it != end; ++it) {
+        StringImpl* fiber = *it;
+        StringImpl::copyChars(buffer, fiber->characters(), fiber->length());
+        buffer += fiber->length();
+    }
+}
+
 JSValue JSString::toPrimitive(ExecState*, PreferredPrimitiveType) const
 {
     return const_cast<JSString*>(this);
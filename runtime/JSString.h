@@ -187,6 +187,7 @@ namespace JSC {
         ALWAYS_INLINE JSString(JSGlobalData& globalData, const UString& value)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(value.length())
+            , m_externalMemory(0)
             , m_value(value)
             , m_fiberCount(0)
         {
@@ -196,6 +197,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, const UString& value, HasOtherOwnerType)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(value.length())
+            , m_externalMemory(0)
             , m_value(value)
             , m_fiberCount(0)
         {
@@ -203,6 +205,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, PassRefPtr<StringImpl> value, HasOtherOwnerType)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(value->length())
+            , m_externalMemory(0)
             , m_value(value)
             , m_fiberCount(0)
         {
@@ -210,6 +213,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, PassRefPtr<RopeImpl> rope)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(rope->length())
+            , m_externalMemory(0)
             , m_fiberCount(1)
         {
         }
@@ -218,6 +222,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, unsigned fiberCount, JSString* s1, JSString* s2)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(s1->length() + s2->length())
+            , m_externalMemory(0)
             , m_fiberCount(fiberCount)
         {
         }
@@ -226,6 +231,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, unsigned fiberCount, JSString* s1, const UString& u2)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(s1->length() + u2.length())
+            , m_externalMemory(0)
             , m_fiberCount(fiberCount)
         {
         }
@@ -234,12 +240,14 @@ namespace JSC {
         JSString(JSGlobalData& globalData, unsigned fiberCount, const UString& u1, JSString* s2)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(u1.length() + s2->length())
+            , m_externalMemory(0)
             , m_fiberCount(fiberCount)
         {
         }
         JSString(ExecState* exec)
             : JSCell(exec->globalData(), exec->globalData().stringStructure.get())
             , m_length(0)
+            , m_externalMemory(0)
             , m_fiberCount(s_maxInternalRopeLength)
         {
         }
@@ -248,6 +256,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, const UString& u1, const UString& u2)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(u1.length() + u2.length())
+            , m_externalMemory(0)
             , m_fiberCount(2)
         {
         }
@@ -256,6 +265,7 @@ namespace JSC {
         JSString(JSGlobalData& globalData, const UString& u1, const UString& u2, const UString& u3)
             : JSCell(globalData, globalData.stringStructure.get())
             , m_length(u1.length() + u2.length() + u3.length())
+            , m_externalMemory(0)
             , m_fiberCount(s_maxInternalRopeLength)
         {
         }
@@ -264,7 +274,7 @@ namespace JSC {
         {
             Base::finishCreation(globalData);
             ASSERT(!m_value.isNull());
-            Heap::heap(this)->reportExtraMemoryCost(value.impl()->cost());
+            reportExternalMemory(value.impl()->cost());
         }
 
         void finishCreation(JSGlobalData& globalData)
@@ -276,7 +286,18 @@ namespace JSC {
         void finishCreation(JSGlobalData& globalData, PassRefPtr<RopeImpl> rope)
         {
             Base::finishCreation(globalData);
-            m_fibers[0] = rope.leakRef();
+            RopeImpl* ropeImpl = rope.leakRef();
+            m_fibers[0] = ropeImpl;
+
+            // Fibers that are themselves ropes belong to the strings they
+            // were taken from, which have already reported them.
+            size_t cost = RopeImpl::allocationSize(ropeImpl->fiberCount());
+            for (unsigned i = 0; i < ropeImpl->fiberCount(); ++i) {
+                RopeImpl::Fiber fiber = ropeImpl->fibers()[i];
+                if (!RopeImpl::isRope(fiber))
+                    cost += static_cast<StringImpl*>(fiber)->cost();
+            }
+            reportExternalMemory(cost);
         }
 
         void finishCreation(JSGlobalData& globalData, unsigned fiberCount, JSString* s1, JSString* s2)
@@ -410,6 +431,8 @@ namespace JSC {
             ASSERT(vptr() == JSGlobalData::jsStringVPtr);
             for (unsigned i = 0; i < m_fiberCount; ++i)
                 RopeImpl::deref(m_fibers[i]);
+            if (m_externalMemory)
+                releaseExternalMemory();
         }
 
         const UString& value(ExecState* exec) const
@@ -425,6 +448,7 @@ namespace JSC {
             return m_value;
         }
         unsigned length() { return m_length; }
+        bool isRope() const { return m_fiberCount; }
 
         bool getStringPropertySlot(ExecState*, const Identifier& propertyName, PropertySlot&);
         bool getStringPropertySlot(ExecState*, unsigned propertyName, PropertySlot&);
@@ -433,6 +457,8 @@ namespace JSC {
         bool canGetIndex(unsigned i) { return i < m_length; }
         JSString* getIndex(ExecState*, unsigned);
         JSString* getIndexSlowCase(ExecState*, unsigned);
+        UChar characterAt(ExecState*, unsigned);
+        void copyCharacters(UChar* buffer) const;
 
         JSValue replaceCharacter(ExecState*, UChar, const UString& replacement);
 
@@ -443,9 +469,13 @@ namespace JSC {
         
         static const ClassInfo s_info;
 
+        static size_t offsetOfLength() { return OBJECT_OFFSETOF(JSString, m_length); }
+        static size_t offsetOfValue() { return OBJECT_OFFSETOF(JSString, m_value); }
+
     private:
         JSString(VPtrStealingHackType) 
             : JSCell(VPtrStealingHack)
+            , m_externalMemory(0)
             , m_fiberCount(0)
         {
         }
@@ -454,13 +484,31 @@ namespace JSC {
         void resolveRopeSlowCase(ExecState*, UChar*) const;
         void outOfMemory(ExecState*) const;
         JSString* substringFromRope(ExecState*, unsigned offset, unsigned length);
+        StringImpl* ropeFiberContaining(unsigned offset, unsigned length, unsigned& offsetInFiber) const;
+
+        // Every byte reported here is released when the string dies, so the
+        // total is clamped to what m_externalMemory can record.
+        void reportExternalMemory(size_t bytes) const
+        {
+            bytes = std::min<size_t>(bytes, std::numeric_limits<unsigned>::max() - m_externalMemory);
+            if (!bytes)
+                return;
+            m_externalMemory += bytes;
+            MarkedBlock::blockFor(this)->heap()->reportExternalMemory(bytes);
+        }
+
+        void releaseExternalMemory() const
+        {
+            MarkedBlock::blockFor(this)->heap()->releaseExternalMemory(m_externalMemory);
+            m_externalMemory = 0;
+        }
 
         void appendStringInCreate(unsigned& index, const UString& string)
         {
             StringImpl* impl = string.impl();
             impl->ref();
             m_fibers[index++] = impl;
-            Heap::heap(this)->reportExtraMemoryCost(string.impl()->cost());
+            reportExternalMemory(impl->cost());
         }
 
         void appendStringInCreate(unsigned& index, JSString* jsString)
@@ -489,6 +537,7 @@ namespace JSC {
                 impl->ref();
                 m_fibers[index++] = impl;
                 m_length += u.length();
+                reportExternalMemory(impl->cost());
             }
         }
 
@@ -510,11 +559,11 @@ namespace JSC {
 
         // A string is represented either by a UString or a RopeImpl.
         unsigned m_length;
+        mutable unsigned m_externalMemory; // Bytes reported to the heap, released when the string dies.
         mutable UString m_value;
         mutable unsigned m_fiberCount;
         mutable FixedArray<RopeImpl::Fiber, s_maxInternalRopeLength> m_fibers;
 
-        bool isRope() const { return m_fiberCount; }
         UString& string() { ASSERT(!isRope()); return m_value; }
         unsigned fiberCount() { return m_fiberCount ? m_fiberCount : 1; }
 
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "JSTypedArray.h"
+
+#include "Error.h"
+#include "ExceptionHelpers.h"
+#include "JSFunction.h"
+#include "JSGlobalObject.h"
+#include "PropertyNameArray.h"
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+ASSERT_CLASS_FITS_IN_CELL(JSArrayBuffer);
+ASSERT_CLASS_FITS_IN_CELL(JSTypedArray);
+ASSERT_CLASS_FITS_IN_CELL(ArrayBufferConstructor);
+ASSERT_CLASS_FITS_IN_CELL(TypedArrayConstructor);
+
+// Keeps offset + length * elementSize representable in an unsigned.
+static const unsigned maximumByteLength = 0x7fffffff;
+
+const char* nameForTypedArray(TypedArrayType type)
+{
+    static const char* const names[numberOfTypedArrayTypes] = {
+        "Int8Array", "Uint8Array", "Int16Array", "Uint16Array", "Int32Array", "Uint32Array", "Float32Array", "Float64Array"
+    };
+    return names[type];
+}
+
+// ------------------------------ ArrayBufferStorage --------------------------------
+
+PassRefPtr<ArrayBufferStorage> ArrayBufferStorage::tryCreate(unsigned byteLength)
+{
+    void* data;
+    // Always allocate at least one byte so an empty buffer still has a valid base address.
+    if (!tryFastCalloc(byteLength ? byteLength : 1, 1).getValue(data))
+        return 0;
+    return adoptRef(new ArrayBufferStorage(static_cast<char*>(data), byteLength));
+}
+
+ArrayBufferStorage::~ArrayBufferStorage()
+{
+    if (m_release)
+        m_release(m_data, m_releaseContext);
+    else
+        fastFree(m_data);
+}
+
+// ------------------------------ JSArrayBuffer --------------------------------
+
+const ClassInfo JSArrayBuffer::s_info = { "ArrayBuffer", &Base::s_info, 0, 0 };
+
+JSArrayBuffer::JSArrayBuffer(JSGlobalData& globalData, Structure* structure, PassRefPtr<ArrayBufferStorage> storage)
+    : JSNonFinalObject(globalData, structure)
+    , m_storage(storage)
+{
+}
+
+void JSArrayBuffer::finishCreation(ExecState* exec)
+{
+    Base::finishCreation(exec->globalData());
+    ASSERT(inherits(&s_info));
+    putDirect(exec->globalData(), Identifier(exec, "byteLength"), jsNumber(m_storage->byteLength()), ReadOnly | DontDelete);
+    Heap::heap(this)->reportExternalMemory(m_storage->byteLength());
+}
+
+JSArrayBuffer::~JSArrayBuffer()
+{
+    Heap::heap(this)->releaseExternalMemory(m_storage->byteLength());
+}
+
+static JSArrayBuffer* createArrayBuffer(ExecState* exec, JSGlobalObject* globalObject, unsigned byteLength)
+{
+    RefPtr<ArrayBufferStorage> storage = ArrayBufferStorage::tryCreate(byteLength);
+    if (!storage) {
+        throwOutOfMemoryError(exec);
+        return 0;
+    }
+    return JSArrayBuffer::create(exec, globalObject->arrayBufferStructure(), storage.release());
+}
+
+// Resolves a begin or end argument of slice and subarray, counting negative values
+// from the end and clamping to [0, length].
+static unsigned relativeIndex(ExecState* exec, JSValue value, unsigned length, unsigned defaultValue)
+{
+    if (value.isUndefined())
+        return defaultValue;
+    double index = value.toInteger(exec);
+    if (index < 0)
+        index = std::max(length + index, 0.0);
+    return static_cast<unsigned>(std::min(index, static_cast<double>(length)));
+}
+
+static EncodedJSValue JSC_HOST_CALL arrayBufferProtoFuncSlice(ExecState* exec)
+{
+    JSValue thisValue = exec->hostThisValue();
+    if (!thisValue.isObject() || !asObject(thisValue)->inherits(&JSArrayBuffer::s_info))
+        return throwVMTypeError(exec);
+    JSArrayBuffer* buffer = asArrayBuffer(thisValue);
+
+    unsigned byteLength = buffer->storage()->byteLength();
+    unsigned begin = relativeIndex(exec, exec->argument(0), byteLength, 0);
+    unsigned end = relativeIndex(exec, exec->argument(1), byteLength, byteLength);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (end < begin)
+        end = begin;
+
+    JSArrayBuffer* result = createArrayBuffer(exec, buffer->globalObject(), end - begin);
+    if (!result)
+        return JSValue::encode(jsUndefined());
+    memcpy(result->storage()->data(), buffer->storage()->data() + begin, end - begin);
+    return JSValue::encode(result);
+}
+
+JSObject* createArrayBufferPrototype(ExecState* exec, JSGlobalObject* globalObject)
+{
+    JSObject* prototype = constructEmptyObject(exec, globalObject);
+    prototype->putDirectFunction(exec, JSFunction::create(exec, globalObject, globalObject->functionStructure(), 2, Identifier(exec, "slice"), arrayBufferProtoFuncSlice), DontEnum);
+    return prototype;
+}
+
+// ------------------------------ ArrayBufferConstructor --------------------------------
+
+const ClassInfo ArrayBufferConstructor::s_info = { "Function", &InternalFunction::s_info, 0, 0 };
+
+ArrayBufferConstructor::ArrayBufferConstructor(JSGlobalObject* globalObject, Structure* structure)
+    : InternalFunction(globalObject, structure)
+{
+}
+
+void ArrayBufferConstructor::finishCreation(ExecState* exec, JSObject* prototype)
+{
+    Base::finishCreation(exec->globalData(), Identifier(exec, "ArrayBuffer"));
+    ASSERT(inherits(&s_info));
+    putDirect(exec->globalData(), exec->propertyNames().prototype, prototype, DontEnum | DontDelete | ReadOnly);
+    putDirect(exec->globalData(), exec->propertyNames().length, jsNumber(1), ReadOnly | DontEnum | DontDelete);
+}
+
+static EncodedJSValue JSC_HOST_CALL constructArrayBuffer(ExecState* exec)
+{
+    double byteLength = exec->argument(0).toInteger(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (byteLength < 0 || byteLength > maximumByteLength)
+        return throwVMError(exec, createRangeError(exec, "Invalid array buffer length"));
+    JSArrayBuffer* buffer = createArrayBuffer(exec, exec->callee()->globalObject(), static_cast<unsigned>(byteLength));
+    if (!buffer)
+        return JSValue::encode(jsUndefined());
+    return JSValue::encode(buffer);
+}
+
+ConstructType ArrayBufferConstructor::getConstructData(ConstructData& constructData)
+{
+    constructData.native.function = constructArrayBuffer;
+    return ConstructTypeHost;
+}
+
+// Calling the constructor as a function does the same as constructing with it.
+CallType ArrayBufferConstructor::getCallData(CallData& callData)
+{
+    callData.native.function = constructArrayBuffer;
+    return CallTypeHost;
+}
+
+// ------------------------------ JSTypedArray --------------------------------
+
+const ClassInfo JSTypedArray::s_info = { "TypedArray", &Base::s_info, 0, 0 };
+
+JSTypedArray::JSTypedArray(JSGlobalData& globalData, Structure* structure, TypedArrayType type, PassRefPtr<ArrayBufferStorage> storage, unsigned byteOffset, unsigned length)
+    : JSNonFinalObject(globalData, structure)
+    , m_type(type)
+    , m_length(length)
+    , m_storage(storage)
+{
+    m_baseAddress = m_storage->data() + byteOffset;
+}
+
+void JSTypedArray::finishCreation(ExecState* exec, JSArrayBuffer* buffer)
+{
+    Base::finishCreation(exec->globalData());
+    ASSERT(inherits(&s_info));
+    JSGlobalData& globalData = exec->globalData();
+    putDirect(globalData, globalData.propertyNames->length, jsNumber(m_length), ReadOnly | DontDelete);
+    putDirect(globalData, Identifier(exec, "byteLength"), jsNumber(byteLength()), ReadOnly | DontDelete);
+    putDirect(globalData, Identifier(exec, "byteOffset"), jsNumber(byteOffset()), ReadOnly | DontDelete);
+    putDirect(globalData, Identifier(exec, "buffer"), buffer, ReadOnly | DontDelete);
+}
+
+bool JSTypedArray::getOwnPropertySlot(ExecState* exec, const Identifier& propertyName, PropertySlot& slot)
+{
+    bool ok;
+    unsigned index = propertyName.toUInt32(ok);
+    if (ok && canAccessIndex(index)) {
+        slot.setValue(getIndex(index));
+        return true;
+    }
+    return JSObject::getOwnPropertySlot(exec, propertyName, slot);
+}
+
+bool JSTypedArray::getOwnPropertyDescriptor(ExecState* exec, const Identifier& propertyName, PropertyDescriptor& descriptor)
+{
+    bool ok;
+    unsigned index = propertyName.toUInt32(ok);
+    if (ok && canAccessIndex(index)) {
+        descriptor.setDescriptor(getIndex(index), DontDelete);
+        return true;
+    }
+    return JSObject::getOwnPropertyDescriptor(exec, propertyName, descriptor);
+}
+
+bool JSTypedArray::getOwnPropertySlot(ExecState* exec, unsigned propertyName, PropertySlot& slot)
+{
+    if (canAccessIndex(propertyName)) {
+        slot.setValue(getIndex(propertyName));
+        return true;
+    }
+    return JSObject::getOwnPropertySlot(exec, Identifier::from(exec, propertyName), slot);
+}
+
+void JSTypedArray::put(ExecState* exec, const Identifier& propertyName, JSValue value, PutPropertySlot& slot)
+{
+    bool ok;
+    unsigned index = propertyName.toUInt32(ok);
+    if (ok) {
+        setIndex(exec, index, value);
+        return;
+    }
+    JSObject::put(exec, propertyName, value, slot);
+}
+
+void JSTypedArray::put(ExecState* exec, unsigned propertyName, JSValue value)
+{
+    setIndex(exec, propertyName, value);
+}
+
+void JSTypedArray::getOwnPropertyNames(ExecState* exec, PropertyNameArray& propertyNames, EnumerationMode mode)
+{
+    for (unsigned i = 0; i < m_length; ++i)
+        propertyNames.add(Identifier::from(exec, i));
+    JSObject::getOwnPropertyNames(exec, propertyNames, mode);
+}
+
+static EncodedJSValue JSC_HOST_CALL typedArrayProtoFuncSet(ExecState* exec)
+{
+    JSValue thisValue = exec->hostThisValue();
+    if (!isJSTypedArray(&exec->globalData(), thisValue) || !exec->argument(0).isObject())
+        return throwVMTypeError(exec);
+    JSTypedArray* target = asTypedArray(thisValue);
+    JSObject* source = asObject(exec->argument(0));
+
+    double offset = exec->argument(1).toInteger(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+
+    if (isJSTypedArray(&exec->globalData(), source)) {
+        JSTypedArray* sourceArray = asTypedArray(source);
+        unsigned length = sourceArray->length();
+        if (offset < 0 || offset + length > target->length())
+            return throwVMError(exec, createRangeError(exec, "Index is out of range"));
+        unsigned start = static_cast<unsigned>(offset);
+
+        if (sourceArray->type() == target->type()) {
+            memmove(target->baseAddress() + start * elementSizeForTypedArray(target->type()), sourceArray->baseAddress(), sourceArray->byteLength());
+            return JSValue::encode(jsUndefined());
+        }
+
+        // Views of different element types may overlap in one buffer, so read the whole
+        // source before writing any of it.
+        Vector<double> values(length);
+        for (unsigned i = 0; i < length; ++i)
+            values[i] = sourceArray->getIndex(i).uncheckedGetNumber();
+        for (unsigned i = 0; i < length; ++i)
+            target->setIndex(start + i, values[i]);
+        return JSValue::encode(jsUndefined());
+    }
+
+    unsigned length = source->get(exec, exec->propertyNames().length).toUInt32(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (offset < 0 || offset + length > target->length())
+        return throwVMError(exec, createRangeError(exec, "Index is out of range"));
+    unsigned start = static_cast<unsigned>(offset);
+    for (unsigned i = 0; i < length; ++i) {
+        JSValue value = source->get(exec, i);
+        if (exec->hadException())
+            break;
+        target->setIndex(exec, start + i, value);
+        if (exec->hadException())
+            break;
+    }
+    return JSValue::encode(jsUndefined());
+}
+
+static EncodedJSValue JSC_HOST_CALL typedArrayProtoFuncSubarray(ExecState* exec)
+{
+    JSValue thisValue = exec->hostThisValue();
+    if (!isJSTypedArray(&exec->globalData(), thisValue))
+        return throwVMTypeError(exec);
+    JSTypedArray* array = asTypedArray(thisValue);
+
+    unsigned length = array->length();
+    unsigned begin = relativeIndex(exec, exec->argument(0), length, 0);
+    unsigned end = relativeIndex(exec, exec->argument(1), length, length);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (end < begin)
+        end = begin;
+
+    JSValue buffer = array->getDirect(exec->globalData(), Identifier(exec, "buffer"));
+    ASSERT(buffer.isObject() && asObject(buffer)->inherits(&JSArrayBuffer::s_info));
+    JSGlobalObject* globalObject = array->globalObject();
+    unsigned byteOffset = array->byteOffset() + begin * elementSizeForTypedArray(array->type());
+    return JSValue::encode(JSTypedArray::create(exec, globalObject->typedArrayStructure(array->type()), array->type(), asArrayBuffer(buffer), byteOffset, end - begin));
+}
+
+JSObject* createTypedArrayPrototype(ExecState* exec, JSGlobalObject* globalObject, TypedArrayType type)
+{
+    JSObject* prototype = constructEmptyObject(exec, globalObject);
+    prototype->putDirect(exec->globalData(), Identifier(exec, "BYTES_PER_ELEMENT"), jsNumber(elementSizeForTypedArray(type)), ReadOnly | DontEnum | DontDelete);
+    prototype->putDirectFunction(exec, JSFunction::create(exec, globalObject, globalObject->functionStructure(), 2, Identifier(exec, "set"), typedArrayProtoFuncSet), DontEnum);
+    prototype->putDirectFunction(exec, JSFunction::create(exec, globalObject, globalObject->functionStructure(), 2, Identifier(exec, "subarray"), typedArrayProtoFuncSubarray), DontEnum);
+    return prototype;
+}
+
+// ------------------------------ TypedArrayConstructor --------------------------------
+
+const ClassInfo TypedArrayConstructor::s_info = { "Function", &InternalFunction::s_info, 0, 0 };
+
+TypedArrayConstructor::TypedArrayConstructor(JSGlobalObject* globalObject, Structure* structure, TypedArrayType type)
+    : InternalFunction(globalObject, structure)
+    , m_type(type)
+{
+}
+
+void TypedArrayConstructor::finishCreation(ExecState* exec, JSObject* prototype)
+{
+    Base::finishCreation(exec->globalData(), Identifier(exec, nameForTypedArray(m_type)));
+    ASSERT(inherits(&s_info));
+    putDirect(exec->globalData(), exec->propertyNames().prototype, prototype, DontEnum | DontDelete | ReadOnly);
+    putDirect(exec->globalData(), exec->propertyNames().length, jsNumber(3), ReadOnly | DontEnum | DontDelete);
+    putDirect(exec->globalData(), Identifier(exec, "BYTES_PER_ELEMENT"), jsNumber(elementSizeForTypedArray(m_type)), ReadOnly | DontEnum | DontDelete);
+}
+
+// new XArray(length), new XArray(arrayLike) and new XArray(buffer[, byteOffset[, length]]).
+static EncodedJSValue JSC_HOST_CALL constructTypedArray(ExecState* exec)
+{
+    TypedArrayConstructor* constructor = static_cast<TypedArrayConstructor*>(exec->callee());
+    JSGlobalObject* globalObject = constructor->globalObject();
+    TypedArrayType type = constructor->type();
+    unsigned elementSize = elementSizeForTypedArray(type);
+    JSValue argument = exec->argument(0);
+
+    if (argument.isObject() && asObject(argument)->inherits(&JSArrayBuffer::s_info)) {
+        JSArrayBuffer* buffer = asArrayBuffer(argument);
+        unsigned byteLength = buffer->storage()->byteLength();
+        double byteOffset = exec->argument(1).toInteger(exec);
+        if (exec->hadException())
+            return JSValue::encode(jsUndefined());
+        if (byteOffset < 0 || byteOffset > byteLength || static_cast<unsigned>(byteOffset) % elementSize)
+            return throwVMError(exec, createRangeError(exec, "Invalid byte offset"));
+        unsigned start = static_cast<unsigned>(byteOffset);
+
+        unsigned length;
+        if (exec->argumentCount() > 2 && !exec->argument(2).isUndefined()) {
+            double requestedLength = exec->argument(2).toInteger(exec);
+            if (exec->hadException())
+                return JSValue::encode(jsUndefined());
+            if (requestedLength < 0 || start + requestedLength * elementSize > byteLength)
+                return throwVMError(exec, createRangeError(exec, "Invalid typed array length"));
+            length = static_cast<unsigned>(requestedLength);
+        } else {
+            if ((byteLength - start) % elementSize)
+                return throwVMError(exec, createRangeError(exec, "Buffer length is not a multiple of the element size"));
+            length = (byteLength - start) / elementSize;
+        }
+        return JSValue::encode(JSTypedArray::create(exec, globalObject->typedArrayStructure(type), type, buffer, start, length));
+    }
+
+    JSObject* source = 0;
+    double length;
+    if (argument.isObject()) {
+        source = asObject(argument);
+        length = source->get(exec, exec->propertyNames().length).toUInt32(exec);
+    } else
+        length = argument.toInteger(exec);
+    if (exec->hadException())
+        return JSValue::encode(jsUndefined());
+    if (length < 0 || length * elementSize > maximumByteLength)
+        return throwVMError(exec, createRangeError(exec, "Invalid typed array length"));
+
+    unsigned elementCount = static_cast<unsigned>(length);
+    JSArrayBuffer* buffer = createArrayBuffer(exec, globalObject, elementCount * elementSize);
+    if (!buffer)
+        return JSValue::encode(jsUndefined());
+    JSTypedArray* array = JSTypedArray::create(exec, globalObject->typedArrayStructure(type), type, buffer, 0, elementCount);
+
+    if (source) {
+        for (unsigned i = 0; i < elementCount; ++i) {
+            JSValue value = source->get(exec, i);
+            if (exec->hadException())
+                return JSValue::encode(jsUndefined());
+            array->setIndex(exec, i, value);
+            if (exec->hadException())
+                return JSValue::encode(jsUndefined());
+        }
+    }
+    return JSValue::encode(array);
+}
+
+ConstructType TypedArrayConstructor::getConstructData(ConstructData& constructData)
+{
+    constructData.native.function = constructTypedArray;
+    return ConstructTypeHost;
+}
+
+CallType TypedArrayConstructor::getCallData(CallData& callData)
+{
+    callData.native.function = constructTypedArray;
+    return CallTypeHost;
+}
+
+} // namespace JSC
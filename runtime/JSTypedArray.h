@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JSTypedArray_h
+#define JSTypedArray_h
+
+#include "InternalFunction.h"
+#include "JSObject.h"
+#include <wtf/MathExtras.h>
+#include <wtf/ThreadSafeRefCounted.h>
+
+namespace JSC {
+
+    enum TypedArrayType {
+        TypedArrayInt8,
+        TypedArrayUint8,
+        TypedArrayInt16,
+        TypedArrayUint16,
+        TypedArrayInt32,
+        TypedArrayUint32,
+        TypedArrayFloat32,
+        TypedArrayFloat64
+    };
+
+    static const unsigned numberOfTypedArrayTypes = TypedArrayFloat64 + 1;
+
+    inline unsigned elementSizeForTypedArray(TypedArrayType type)
+    {
+        static const unsigned elementSizes[numberOfTypedArrayTypes] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+        return elementSizes[type];
+    }
+
+    const char* nameForTypedArray(TypedArrayType);
+
+    typedef void (*ArrayBufferReleaseCallback)(void* data, void* context);
+
+    // The bytes of an ArrayBuffer. Shared by the buffer object and every view onto it,
+    // so a view's elements stay valid whatever order the collector finalizes them in.
+    // Buffers posted through a JSMessageQueue share it between heaps on different threads.
+    class ArrayBufferStorage : public ThreadSafeRefCounted<ArrayBufferStorage> {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        static PassRefPtr<ArrayBufferStorage> tryCreate(unsigned byteLength);
+
+        // Wraps bytes the embedder owns; release is called with them instead of fastFree,
+        // on whichever thread drops the last reference.
+        static PassRefPtr<ArrayBufferStorage> createExternal(char* data, unsigned byteLength, ArrayBufferReleaseCallback release, void* releaseContext)
+        {
+            ASSERT(release);
+            return adoptRef(new ArrayBufferStorage(data, byteLength, release, releaseContext));
+        }
+
+        ~ArrayBufferStorage();
+
+        char* data() const { return m_data; }
+        unsigned byteLength() const { return m_byteLength; }
+
+    private:
+        ArrayBufferStorage(char* data, unsigned byteLength, ArrayBufferReleaseCallback release = 0, void* releaseContext = 0)
+            : m_data(data)
+            , m_byteLength(byteLength)
+            , m_release(release)
+            , m_releaseContext(releaseContext)
+        {
+        }
+
+        char* m_data;
+        unsigned m_byteLength;
+        ArrayBufferReleaseCallback m_release;
+        void* m_releaseContext;
+    };
+
+    class JSArrayBuffer : public JSNonFinalObject {
+    public:
+        typedef JSNonFinalObject Base;
+
+        static JSArrayBuffer* create(ExecState* exec, Structure* structure, PassRefPtr<ArrayBufferStorage> storage)
+        {
+            JSArrayBuffer* buffer = new (allocateCell<JSArrayBuffer>(*exec->heap())) JSArrayBuffer(exec->globalData(), structure, storage);
+            buffer->finishCreation(exec);
+            return buffer;
+        }
+
+        static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype)
+        {
+            return Structure::create(globalData, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), &s_info);
+        }
+
+        static const ClassInfo s_info;
+
+        ArrayBufferStorage* storage() const { return m_storage.get(); }
+
+        virtual ~JSArrayBuffer();
+
+    private:
+        JSArrayBuffer(JSGlobalData&, Structure*, PassRefPtr<ArrayBufferStorage>);
+        void finishCreation(ExecState*);
+
+        RefPtr<ArrayBufferStorage> m_storage;
+    };
+
+    inline JSArrayBuffer* asArrayBuffer(JSValue value)
+    {
+        ASSERT(asObject(value)->inherits(&JSArrayBuffer::s_info));
+        return static_cast<JSArrayBuffer*>(value.asCell());
+    }
+
+    // One view class covers every element type, so the JIT stubs and the interpreter
+    // recognise all typed arrays with a single vptr compare, like JSByteArray.
+    class JSTypedArray : public JSNonFinalObject {
+        friend class JSGlobalData;
+    public:
+        typedef JSNonFinalObject Base;
+
+        static JSTypedArray* create(ExecState* exec, Structure* structure, TypedArrayType type, JSArrayBuffer* buffer, unsigned byteOffset, unsigned length)
+        {
+            ASSERT(byteOffset + static_cast<uint64_t>(length) * elementSizeForTypedArray(type) <= buffer->storage()->byteLength());
+            JSTypedArray* array = new (allocateCell<JSTypedArray>(*exec->heap())) JSTypedArray(exec->globalData(), structure, type, buffer->storage(), byteOffset, length);
+            array->finishCreation(exec, buffer);
+            return array;
+        }
+
+        static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype)
+        {
+            return Structure::create(globalData, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), &s_info);
+        }
+
+        static const ClassInfo s_info;
+
+        TypedArrayType type() const { return m_type; }
+        unsigned length() const { return m_length; }
+        unsigned byteOffset() const { return static_cast<unsigned>(m_baseAddress - m_storage->data()); }
+        unsigned byteLength() const { return m_length * elementSizeForTypedArray(m_type); }
+        char* baseAddress() const { return m_baseAddress; }
+        ArrayBufferStorage* storage() const { return m_storage.get(); }
+
+        bool canAccessIndex(unsigned i) const { return i < m_length; }
+
+        JSValue getIndex(unsigned i) const
+        {
+            ASSERT(canAccessIndex(i));
+            switch (m_type) {
+            case TypedArrayInt8:
+                return jsNumber(static_cast<int>(reinterpret_cast<int8_t*>(m_baseAddress)[i]));
+            case TypedArrayUint8:
+                return jsNumber(static_cast<int>(reinterpret_cast<uint8_t*>(m_baseAddress)[i]));
+            case TypedArrayInt16:
+                return jsNumber(static_cast<int>(reinterpret_cast<int16_t*>(m_baseAddress)[i]));
+            case TypedArrayUint16:
+                return jsNumber(static_cast<int>(reinterpret_cast<uint16_t*>(m_baseAddress)[i]));
+            case TypedArrayInt32:
+                return jsNumber(reinterpret_cast<int32_t*>(m_baseAddress)[i]);
+            case TypedArrayUint32:
+                return jsNumber(reinterpret_cast<uint32_t*>(m_baseAddress)[i]);
+            case TypedArrayFloat32:
+                return jsNumberForStoredDouble(reinterpret_cast<float*>(m_baseAddress)[i]);
+            case TypedArrayFloat64:
+                return jsNumberForStoredDouble(reinterpret_cast<double*>(m_baseAddress)[i]);
+            }
+            ASSERT_NOT_REACHED();
+            return jsUndefined();
+        }
+
+        void setIndex(unsigned i, int32_t value)
+        {
+            ASSERT(canAccessIndex(i));
+            switch (m_type) {
+            case TypedArrayInt8:
+            case TypedArrayUint8:
+                reinterpret_cast<uint8_t*>(m_baseAddress)[i] = static_cast<uint8_t>(value);
+                return;
+            case TypedArrayInt16:
+            case TypedArrayUint16:
+                reinterpret_cast<uint16_t*>(m_baseAddress)[i] = static_cast<uint16_t>(value);
+                return;
+            case TypedArrayInt32:
+            case TypedArrayUint32:
+                reinterpret_cast<int32_t*>(m_baseAddress)[i] = value;
+                return;
+            case TypedArrayFloat32:
+                reinterpret_cast<float*>(m_baseAddress)[i] = static_cast<float>(value);
+                return;
+            case TypedArrayFloat64:
+                reinterpret_cast<double*>(m_baseAddress)[i] = value;
+                return;
+            }
+            ASSERT_NOT_REACHED();
+        }
+
+        void setIndex(unsigned i, double value)
+        {
+            ASSERT(canAccessIndex(i));
+            switch (m_type) {
+            case TypedArrayFloat32:
+                reinterpret_cast<float*>(m_baseAddress)[i] = static_cast<float>(value);
+                return;
+            case TypedArrayFloat64:
+                reinterpret_cast<double*>(m_baseAddress)[i] = value;
+                return;
+            default:
+                // Integer elements wrap modulo their width, like ToInt32.
+                setIndex(i, toInt32(value));
+                return;
+            }
+        }
+
+        void setIndex(ExecState* exec, unsigned i, JSValue value)
+        {
+            if (value.isInt32()) {
+                if (canAccessIndex(i))
+                    setIndex(i, value.asInt32());
+                return;
+            }
+            double number = value.toNumber(exec);
+            if (exec->hadException())
+                return;
+            if (canAccessIndex(i))
+                setIndex(i, number);
+        }
+
+        virtual bool getOwnPropertySlot(ExecState*, const Identifier& propertyName, PropertySlot&);
+        virtual bool getOwnPropertySlot(ExecState*, unsigned propertyName, PropertySlot&);
+        virtual bool getOwnPropertyDescriptor(ExecState*, const Identifier&, PropertyDescriptor&);
+        virtual void put(ExecState*, const Identifier& propertyName, JSValue, PutPropertySlot&);
+        virtual void put(ExecState*, unsigned propertyName, JSValue);
+
+        virtual void getOwnPropertyNames(ExecState*, PropertyNameArray&, EnumerationMode mode = ExcludeDontEnumProperties);
+
+    protected:
+        static const unsigned StructureFlags = OverridesGetOwnPropertySlot | OverridesGetPropertyNames | JSObject::StructureFlags;
+
+    private:
+        JSTypedArray(JSGlobalData&, Structure*, TypedArrayType, PassRefPtr<ArrayBufferStorage>, unsigned byteOffset, unsigned length);
+        void finishCreation(ExecState*, JSArrayBuffer*);
+
+        JSTypedArray(VPtrStealingHackType)
+            : JSNonFinalObject(VPtrStealingHack)
+        {
+        }
+
+        // Element memory may hold any NaN bit pattern, which must not reach a JSValue.
+        static JSValue jsNumberForStoredDouble(double value)
+        {
+            return isnan(value) ? jsNaN() : jsNumber(value);
+        }
+
+        TypedArrayType m_type;
+        unsigned m_length;
+        char* m_baseAddress;
+        RefPtr<ArrayBufferStorage> m_storage;
+    };
+
+    inline JSTypedArray* asTypedArray(JSValue value)
+    {
+        return static_cast<JSTypedArray*>(value.asCell());
+    }
+
+    inline bool isJSTypedArray(JSGlobalData* globalData, JSValue v) { return v.isCell() && v.asCell()->vptr() == globalData->jsTypedArrayVPtr; }
+
+    JSObject* createArrayBufferPrototype(ExecState*, JSGlobalObject*);
+    JSObject* createTypedArrayPrototype(ExecState*, JSGlobalObject*, TypedArrayType);
+
+    class ArrayBufferConstructor : public InternalFunction {
+    public:
+        typedef InternalFunction Base;
+
+        static ArrayBufferConstructor* create(ExecState* exec, JSGlobalObject* globalObject, Structure* structure, JSObject* prototype)
+        {
+            ArrayBufferConstructor* constructor = new (allocateCell<ArrayBufferConstructor>(*exec->heap())) ArrayBufferConstructor(globalObject, structure);
+            constructor->finishCreation(exec, prototype);
+            return constructor;
+        }
+
+        static const ClassInfo s_info;
+
+        static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype)
+        {
+            return Structure::create(globalData, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), &s_info);
+        }
+
+    private:
+        ArrayBufferConstructor(JSGlobalObject*, Structure*);
+        void finishCreation(ExecState*, JSObject* prototype);
+
+        virtual ConstructType getConstructData(ConstructData&);
+        virtual CallType getCallData(CallData&);
+    };
+
+    class TypedArrayConstructor : public InternalFunction {
+    public:
+        typedef InternalFunction Base;
+
+        static TypedArrayConstructor* create(ExecState* exec, JSGlobalObject* globalObject, Structure* structure, TypedArrayType type, JSObject* prototype)
+        {
+            TypedArrayConstructor* constructor = new (allocateCell<TypedArrayConstructor>(*exec->heap())) TypedArrayConstructor(globalObject, structure, type);
+            constructor->finishCreation(exec, prototype);
+            return constructor;
+        }
+
+        static const ClassInfo s_info;
+
+        static Structure* createStructure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype)
+        {
+            return Structure::create(globalData, globalObject, prototype, TypeInfo(ObjectType, StructureFlags), &s_info);
+        }
+
+        TypedArrayType type() const { return m_type; }
+
+    private:
+        TypedArrayConstructor(JSGlobalObject*, Structure*, TypedArrayType);
+        void finishCreation(ExecState*, JSObject* prototype);
+
+        virtual ConstructType getConstructData(ConstructData&);
+        virtual CallType getCallData(CallData&);
+
+        TypedArrayType m_type;
+    };
+
+} // namespace JSC
+
+#endif // JSTypedArray_h
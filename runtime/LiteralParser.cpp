@@ -26,6 +26,7 @@
 #include "config.h"
 #include "LiteralParser.h"
 
+#include "CharacterComparisons.h"
 #include "JSArray.h"
 #include "JSString.h"
 #include "Lexer.h"
@@ -187,7 +188,7 @@ template <LiteralParser::ParserMode mode> LiteralParser::TokenType LiteralParser
         case '"':
             return lexString<mode, '"'>(token);
         case 't':
-            if (m_end - m_ptr >= 4 && m_ptr[1] == 'r' && m_ptr[2] == 'u' && m_ptr[3] == 'e') {
+            if (m_end - m_ptr >= 4 && COMPARE_CHARACTERS4(m_ptr, 't', 'r', 'u', 'e')) {
                 m_ptr += 4;
                 token.type = TokTrue;
                 token.end = m_ptr;
@@ -195,7 +196,7 @@ template <LiteralParser::ParserMode mode> LiteralParser::TokenType LiteralParser
             }
             break;
         case 'f':
-            if (m_end - m_ptr >= 5 && m_ptr[1] == 'a' && m_ptr[2] == 'l' && m_ptr[3] == 's' && m_ptr[4] == 'e') {
+            if (m_end - m_ptr >= 5 && COMPARE_CHARACTERS4(m_ptr + 1, 'a', 'l', 's', 'e')) {
                 m_ptr += 5;
                 token.type = TokFalse;
                 token.end = m_ptr;
@@ -203,7 +204,7 @@ template <LiteralParser::ParserMode mode> LiteralParser::TokenType LiteralParser
             }
             break;
         case 'n':
-            if (m_end - m_ptr >= 4 && m_ptr[1] == 'u' && m_ptr[2] == 'l' && m_ptr[3] == 'l') {
+            if (m_end - m_ptr >= 4 && COMPARE_CHARACTERS4(m_ptr, 'n', 'u', 'l', 'l')) {
                 m_ptr += 4;
                 token.type = TokNull;
                 token.end = m_ptr;
@@ -457,6 +458,11 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     
     token.type = TokNumber;
     token.end = m_ptr;
+    size_t parsedLength;
+    if (WTF::strtodFastPath(token.start, token.end, token.numberToken, parsedLength)) {
+        ASSERT(token.start + parsedLength == token.end);
+        return TokNumber;
+    }
     Vector<char, 64> buffer(token.end - token.start + 1);
     int i;
     for (i = 0; i < token.end - token.start; i++) {
@@ -470,6 +476,22 @@ LiteralParser::TokenType LiteralParser::Lexer::lexNumber(LiteralParserToken& tok
     return TokNumber;
 }
 
+// keysAtDepth holds the keys of the latest object at the current nesting depth, up to the
+// property being parsed. When records share a shape each key is found there by comparing
+// characters, so it is interned only once per parse.
+ALWAYS_INLINE const Identifier LiteralParser::makeObjectKey(Vector<Identifier, 8>& keysAtDepth, unsigned index, const UChar* characters, size_t length)
+{
+    ASSERT(index <= keysAtDepth.size());
+    if (index < keysAtDepth.size()) {
+        if (Identifier::equal(keysAtDepth[index].impl(), characters, length))
+            return keysAtDepth[index];
+        keysAtDepth.shrink(index);
+    }
+    Identifier key = makeIdentifier(characters, length);
+    keysAtDepth.append(key);
+    return key;
+}
+
 JSValue LiteralParser::parse(ParserState initialState)
 {
     ParserState state = initialState;
@@ -477,6 +499,8 @@ JSValue LiteralParser::parse(ParserState initialState)
     JSValue lastValue;
     Vector<ParserState, 16> stateStack;
     Vector<Identifier, 16> identifierStack;
+    Vector<unsigned, 16> keyIndexStack;
+    Vector<Vector<Identifier, 8>, 8> keysByDepth;
     while (1) {
         switch(state) {
             startParseArray:
@@ -522,6 +546,9 @@ JSValue LiteralParser::parse(ParserState initialState)
             case StartParseObject: {
                 JSObject* object = constructEmptyObject(m_exec);
                 objectStack.append(object);
+                keyIndexStack.append(0);
+                if (keysByDepth.size() < keyIndexStack.size())
+                    keysByDepth.grow(keyIndexStack.size());
 
                 TokenType type = m_lexer.next();
                 if (type == TokString || (m_mode != StrictJSON && type == TokIdentifier)) {
@@ -534,7 +561,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                     }
                     
                     m_lexer.next();
-                    identifierStack.append(makeIdentifier(identifierToken.stringToken, identifierToken.stringLength));
+                    identifierStack.append(makeObjectKey(keysByDepth[keyIndexStack.size() - 1], keyIndexStack.last()++, identifierToken.stringToken, identifierToken.stringLength));
                     stateStack.append(DoParseObjectEndExpression);
                     goto startParseExpression;
                 }
@@ -545,6 +572,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                 m_lexer.next();
                 lastValue = objectStack.last();
                 objectStack.removeLast();
+                keyIndexStack.removeLast();
                 break;
             }
             doParseObjectStartExpression:
@@ -563,7 +591,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                 }
 
                 m_lexer.next();
-                identifierStack.append(makeIdentifier(identifierToken.stringToken, identifierToken.stringLength));
+                identifierStack.append(makeObjectKey(keysByDepth[keyIndexStack.size() - 1], keyIndexStack.last()++, identifierToken.stringToken, identifierToken.stringLength));
                 stateStack.append(DoParseObjectEndExpression);
                 goto startParseExpression;
             }
@@ -580,6 +608,7 @@ JSValue LiteralParser::parse(ParserState initialState)
                 m_lexer.next();
                 lastValue = objectStack.last();
                 objectStack.removeLast();
+                keyIndexStack.removeLast();
                 break;
             }
             startParseExpression:
@@ -147,6 +147,7 @@ namespace JSC {
         FixedArray<Identifier, MaximumCachableCharacter> m_shortIdentifiers;
         FixedArray<Identifier, MaximumCachableCharacter> m_recentIdentifiers;
         ALWAYS_INLINE const Identifier makeIdentifier(const UChar* characters, size_t length);
+        ALWAYS_INLINE const Identifier makeObjectKey(Vector<Identifier, 8>& keysAtDepth, unsigned index, const UChar* characters, size_t length);
     };
 
 }
@@ -119,6 +119,12 @@ namespace JSC {
         HashEntry* m_next;
     };
 
+    // The generated values are shared, but each JSGlobalData builds its own entry table, because
+    // lookups compare the identifier's StringImpl pointer and identifiers belong to a per-thread
+    // identifier table. Keys are bucketed by the StringImpl's cached hash, so a lookup is one
+    // masked index plus a pointer compare, and rarely a one-link chain. A collision-free mask
+    // would need tables 16 to 64 times larger (2048 slots for String.prototype). A salted
+    // perfect hash would give up both the cached hash and the pointer compare.
     struct HashTable {
 
         int compactSize;
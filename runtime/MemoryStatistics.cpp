@@ -26,9 +26,16 @@
 #include "config.h"
 #include "MemoryStatistics.h"
 
+#include "CodeBlock.h"
+#include "Executable.h"
 #include "ExecutableAllocator.h"
+#include "JSArray.h"
 #include "JSGlobalData.h"
+#include "Parser.h"
+#include "RegExp.h"
 #include "RegisterFile.h"
+#include <algorithm>
+#include <wtf/HashSet.h>
 
 namespace JSC {
 
@@ -39,12 +46,222 @@ GlobalMemoryStatistics globalMemoryStatistics()
     stats.stackBytes = RegisterFile::committedByteCount();
 #if ENABLE(EXECUTABLE_ALLOCATOR_FIXED)
     stats.JITBytes = ExecutableAllocator::committedByteCount();
+    stats.JITFreeBytes = ExecutableAllocator::freeByteCount();
+    stats.JITLargestFreeBlock = ExecutableAllocator::largestFreeBlockSize();
 #else
     stats.JITBytes = 0;
+    stats.JITFreeBytes = 0;
+    stats.JITLargestFreeBlock = 0;
 #endif
     return stats;
 }
 
+namespace {
+
+class GatherSizeClassStatistics : public MarkedBlock::VoidFunctor {
+public:
+    GatherSizeClassStatistics(Vector<SizeClassStatistics>&);
+    void operator()(MarkedBlock*);
+
+private:
+    Vector<SizeClassStatistics>& m_sizeClasses;
+};
+
+inline GatherSizeClassStatistics::GatherSizeClassStatistics(Vector<SizeClassStatistics>& sizeClasses)
+    : m_sizeClasses(sizeClasses)
+{
+}
+
+inline void GatherSizeClassStatistics::operator()(MarkedBlock* block)
+{
+    size_t i = 0;
+    while (i < m_sizeClasses.size() && m_sizeClasses[i].cellSize < block->cellSize())
+        ++i;
+    if (i == m_sizeClasses.size() || m_sizeClasses[i].cellSize != block->cellSize()) {
+        SizeClassStatistics sizeClass = { block->cellSize(), 0, 0, 0 };
+        m_sizeClasses.insert(i, sizeClass);
+    }
+
+    SizeClassStatistics& sizeClass = m_sizeClasses[i];
+    sizeClass.blockCount++;
+    sizeClass.cellCount += block->cellCount();
+    sizeClass.liveCellCount += block->markCount();
+}
+
+class GatherMemoryBreakdown : public MarkedBlock::VoidFunctor {
+public:
+    GatherMemoryBreakdown(MemoryBreakdown&);
+    void operator()(JSCell*);
+
+private:
+    void gather(ScriptExecutable*);
+    void gather(CodeBlock*);
+
+    MemoryBreakdown& m_breakdown;
+    HashMap<const ClassInfo*, size_t> m_classIndices;
+    HashSet<StringImpl*> m_strings;
+    HashSet<SourceProvider*> m_sourceProviders;
+};
+
+inline GatherMemoryBreakdown::GatherMemoryBreakdown(MemoryBreakdown& breakdown)
+    : m_breakdown(breakdown)
+{
+}
+
+void GatherMemoryBreakdown::operator()(JSCell* cell)
+{
+    const ClassInfo* classInfo = cell->classInfo();
+    pair<HashMap<const ClassInfo*, size_t>::iterator, bool> result = m_classIndices.add(classInfo, m_breakdown.classes.size());
+    if (result.second) {
+        ClassMemoryStatistics classStatistics = { classInfo, 0, 0 };
+        m_breakdown.classes.append(classStatistics);
+    }
+    ClassMemoryStatistics& classStatistics = m_breakdown.classes[result.first->second];
+    classStatistics.cellCount++;
+    classStatistics.cellBytes += MarkedBlock::blockFor(cell)->cellSize();
+
+    if (cell->isObject()) {
+        JSObject* object = asObject(cell);
+        if (!object->isUsingInlineStorage())
+            m_breakdown.propertyStorageBytes += object->structure()->propertyStorageCapacity() * sizeof(WriteBarrierBase<Unknown>);
+        if (object->inherits(&JSArray::s_info))
+            m_breakdown.arrayStorageBytes += asArray(object)->storageBytes();
+        return;
+    }
+
+    if (cell->isString()) {
+        JSString* string = static_cast<JSString*>(cell);
+        if (string->isRope()) {
+            m_breakdown.ropeCount++;
+            m_breakdown.ropeBytes += string->length() * sizeof(UChar);
+            return;
+        }
+        StringImpl* impl = string->tryGetValue().impl();
+        if (impl && m_strings.add(impl).second) {
+            m_breakdown.stringCount++;
+            m_breakdown.stringBytes += impl->length() * sizeof(UChar);
+        }
+        return;
+    }
+
+    if (classInfo == &Structure::s_info) {
+        m_breakdown.structureCount++;
+        m_breakdown.propertyTableBytes += static_cast<Structure*>(cell)->propertyTableSizeInMemory();
+        return;
+    }
+
+    if (classInfo == &RegExp::s_info) {
+        RegExp* regExp = static_cast<RegExp*>(cell);
+        m_breakdown.regExpCount++;
+#if ENABLE(YARR_JIT)
+        m_breakdown.regExpJITBytes += regExp->jitCodeSize();
+#endif
+        m_breakdown.regExpBytecodeBytes += regExp->bytecodeSize();
+        return;
+    }
+
+    if (cell->inherits(&ScriptExecutable::s_info))
+        gather(static_cast<ScriptExecutable*>(cell));
+}
+
+void GatherMemoryBreakdown::gather(ScriptExecutable* executable)
+{
+    if (SourceProvider* provider = executable->source().provider()) {
+        if (m_sourceProviders.add(provider).second) {
+            m_breakdown.sourceProviderCount++;
+            m_breakdown.sourceBytes += provider->sizeInMemory();
+        }
+    }
+
+    if (executable->inherits(&FunctionExecutable::s_info)) {
+        FunctionExecutable* functionExecutable = static_cast<FunctionExecutable*>(executable);
+        if (functionExecutable->isGeneratedForCall())
+            gather(&functionExecutable->generatedBytecodeForCall());
+        if (functionExecutable->isGeneratedForConstruct())
+            gather(&functionExecutable->generatedBytecodeForConstruct());
+    } else if (executable->inherits(&ProgramExecutable::s_info)) {
+        ProgramExecutable* programExecutable = static_cast<ProgramExecutable*>(executable);
+        if (programExecutable->isGenerated())
+            gather(&programExecutable->generatedBytecode());
+    } else if (executable->inherits(&EvalExecutable::s_info)) {
+        EvalExecutable* evalExecutable = static_cast<EvalExecutable*>(executable);
+        if (evalExecutable->isGenerated())
+            gather(&evalExecutable->generatedBytecode());
+    }
+}
+
+void GatherMemoryBreakdown::gather(CodeBlock* codeBlock)
+{
+    // An optimized code block keeps the baseline one it replaced as its alternative.
+    for (; codeBlock; codeBlock = codeBlock->alternative()) {
+        m_breakdown.codeBlockCount++;
+        m_breakdown.bytecodeBytes += codeBlock->instructions().capacity() * sizeof(Instruction);
+        m_breakdown.codeBlockSideTableBytes += codeBlock->sideTableBytes();
+#if ENABLE(JIT)
+        if (codeBlock->getJITType() == JITCode::DFGJIT)
+            m_breakdown.DFGJITBytes += codeBlock->getJITCode().size();
+        else
+            m_breakdown.baselineJITBytes += codeBlock->getJITCode().size();
+#endif
+    }
+}
+
+inline bool hasMoreCellBytes(const ClassMemoryStatistics& a, const ClassMemoryStatistics& b)
+{
+    return a.cellBytes > b.cellBytes;
+}
+
+} // anonymous namespace
+
+MemoryBreakdown memoryBreakdown(JSGlobalData& globalData)
+{
+    MemoryBreakdown breakdown;
+    breakdown.propertyStorageBytes = 0;
+    breakdown.arrayStorageBytes = 0;
+    breakdown.stringCount = 0;
+    breakdown.stringBytes = 0;
+    breakdown.ropeCount = 0;
+    breakdown.ropeBytes = 0;
+    breakdown.structureCount = 0;
+    breakdown.propertyTableBytes = 0;
+    breakdown.codeBlockCount = 0;
+    breakdown.bytecodeBytes = 0;
+    breakdown.codeBlockSideTableBytes = 0;
+    breakdown.baselineJITBytes = 0;
+    breakdown.DFGJITBytes = 0;
+    breakdown.regExpCount = 0;
+    breakdown.regExpJITBytes = 0;
+    breakdown.regExpBytecodeBytes = 0;
+    breakdown.sourceProviderCount = 0;
+    breakdown.sourceBytes = 0;
+
+    GatherMemoryBreakdown gather(breakdown);
+    globalData.heap.forEachCell(gather);
+    std::sort(breakdown.classes.begin(), breakdown.classes.end(), hasMoreCellBytes);
+
+    breakdown.parserArenaPeakBytes = globalData.parser->peakArenaSize();
+    return breakdown;
+}
+
+HeapStatistics heapStatistics(Heap& heap)
+{
+    HeapStatistics stats;
+
+    GatherSizeClassStatistics gather(stats.sizeClasses);
+    heap.forEachBlock(gather);
+
+    stats.size = heap.size();
+    stats.capacity = heap.capacity();
+    stats.largeObjectBytes = heap.largeObjectSpace().size();
+    stats.collectionCount = heap.collectionCount();
+    stats.liveBytesAfterLastCollection = heap.liveBytesAfterLastCollection();
+    stats.bytesFreed = heap.bytesFreed();
+    stats.bytesPromoted = heap.bytesPromoted();
+    for (size_t i = 0; i < NumberOfGCPhases; ++i)
+        stats.phases[i] = heap.phaseStatistics(static_cast<GCPhase>(i));
+    return stats;
+}
+
 }
 
 
@@ -32,13 +32,72 @@ class JSGlobalData;
 
 namespace JSC {
 
+struct ClassInfo;
+
 struct GlobalMemoryStatistics {
     size_t stackBytes;
     size_t JITBytes;
+    size_t JITFreeBytes;
+    size_t JITLargestFreeBlock;
 };
 
 GlobalMemoryStatistics globalMemoryStatistics();
 
+struct SizeClassStatistics {
+    size_t cellSize;
+    size_t blockCount;
+    size_t cellCount;
+    size_t liveCellCount; // As of the last collection, plus cells allocated since.
+};
+
+struct HeapStatistics {
+    Vector<SizeClassStatistics> sizeClasses; // Only size classes that own blocks, smallest first.
+    size_t size;
+    size_t capacity;
+    size_t largeObjectBytes;
+    size_t collectionCount;
+    size_t liveBytesAfterLastCollection;
+    size_t bytesFreed;
+    size_t bytesPromoted;
+    GCPhaseStatistics phases[NumberOfGCPhases];
+};
+
+HeapStatistics heapStatistics(Heap&);
+
+struct ClassMemoryStatistics {
+    const ClassInfo* classInfo;
+    size_t cellCount;
+    size_t cellBytes;
+};
+
+// Where the memory of a JSGlobalData goes, as of the last collection, plus cells allocated since.
+// Everything is in bytes. Buffers shared by several owners, like strings and source providers,
+// are counted once; memory allocated outside the engine's own structures is not counted.
+struct MemoryBreakdown {
+    Vector<ClassMemoryStatistics> classes; // Largest first.
+    size_t propertyStorageBytes; // Out-of-line property storage of objects.
+    size_t arrayStorageBytes;
+    size_t stringCount;
+    size_t stringBytes; // Characters of resolved strings, always 16-bit.
+    size_t ropeCount;
+    size_t ropeBytes; // Characters unresolved ropes will take once resolved.
+    size_t structureCount;
+    size_t propertyTableBytes;
+    size_t codeBlockCount;
+    size_t bytecodeBytes;
+    size_t codeBlockSideTableBytes;
+    size_t baselineJITBytes;
+    size_t DFGJITBytes;
+    size_t regExpCount;
+    size_t regExpJITBytes;
+    size_t regExpBytecodeBytes;
+    size_t sourceProviderCount;
+    size_t sourceBytes;
+    size_t parserArenaPeakBytes;
+};
+
+MemoryBreakdown memoryBreakdown(JSGlobalData&);
+
 }
 
 #endif // MemoryStatistics_h
@@ -32,6 +32,7 @@
 #include "dtoa.h"
 #include <wtf/Assertions.h>
 #include <wtf/MathExtras.h>
+#include <wtf/StdLibExtras.h>
 #include <wtf/Vector.h>
 #include <wtf/dtoa/double-conversion.h>
 
@@ -327,6 +328,187 @@ static char* toStringWithRadix(RadixBuffer& buffer, double number, unsigned radi
     return startOfResultString;
 }
 
+// The fast paths below handle magnitudes under 2^53 and up to 19 digits after
+// the point or significant figures, so that every rounded digit string fits in
+// a uint64_t. They round the exact binary value, as the converter does.
+static const double maxFastPathMagnitude = 9007199254740992.0;
+static const int maxFastPathDigits = 19;
+
+static const uint64_t powersOfTen[maxFastPathDigits + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static inline void multiply64x64(uint64_t a, uint64_t b, uint64_t& high, uint64_t& low)
+{
+    uint64_t aLow = a & 0xffffffff;
+    uint64_t aHigh = a >> 32;
+    uint64_t bLow = b & 0xffffffff;
+    uint64_t bHigh = b >> 32;
+
+    uint64_t lowLow = aLow * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t middle = (lowLow >> 32) + (lowHigh & 0xffffffff) + (highLow & 0xffffffff);
+
+    low = (middle << 32) | (lowLow & 0xffffffff);
+    high = aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
+// Splits value, 0 <= value < 2^53, into its integer part and its fraction
+// rounded to fractionDigits decimal places, rounding halves up as toFixed
+// requires. A fraction that rounds up to one is carried into the integer part.
+static void roundToFixedPoint(double value, int fractionDigits, uint64_t& integerPart, uint64_t& fraction)
+{
+    ASSERT(value >= 0 && value < maxFastPathMagnitude);
+    ASSERT(fractionDigits >= 0 && fractionDigits <= maxFastPathDigits);
+
+    uint64_t bits = bitwise_cast<uint64_t>(value);
+    int biasedExponent = static_cast<int>(bits >> 52);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    int exponent;
+    if (biasedExponent) {
+        mantissa |= 1ULL << 52;
+        exponent = biasedExponent - 1075;
+    } else
+        exponent = -1074;
+
+    fraction = 0;
+    if (exponent >= 0) {
+        integerPart = mantissa << exponent;
+        return;
+    }
+
+    // value is mantissa / 2^shift; the fraction's bits are numerator / 2^shift.
+    int shift = -exponent;
+    uint64_t numerator;
+    if (shift < 64) {
+        integerPart = mantissa >> shift;
+        numerator = mantissa & ((1ULL << shift) - 1);
+    } else {
+        integerPart = 0;
+        numerator = mantissa;
+    }
+
+    // numerator * 10^fractionDigits is below 2^117, so beyond that shift the
+    // rounded fraction is zero.
+    if (!numerator || shift > 117)
+        return;
+
+    uint64_t high;
+    uint64_t low;
+    multiply64x64(numerator, powersOfTen[fractionDigits], high, low);
+    if (shift <= 64) {
+        uint64_t half = 1ULL << (shift - 1);
+        low += half;
+        high += low < half;
+    } else
+        high += 1ULL << (shift - 65);
+    fraction = shift < 64 ? (low >> shift) | (high << (64 - shift)) : high >> (shift - 64);
+
+    if (fraction == powersOfTen[fractionDigits]) {
+        ++integerPart;
+        fraction = 0;
+    }
+}
+
+// Rounds value, 0 < value < 2^53, to precision significant figures, returning
+// them as an integer in [10^(precision - 1), 10^precision) along with the
+// decimal exponent of the first one. Fails if that would need more than
+// maxFastPathDigits places after the point.
+static bool roundToSignificantFigures(double value, int precision, uint64_t& significand, int& exponent)
+{
+    ASSERT(value > 0 && value < maxFastPathMagnitude);
+    ASSERT(precision >= 1 && precision <= maxFastPathDigits);
+
+    // The estimate is exact when value >= 1; below that it may be off by one,
+    // which the rounded result shows.
+    int estimate = -1;
+    if (value >= 1) {
+        for (uint64_t integerPart = static_cast<uint64_t>(value); integerPart; integerPart /= 10)
+            ++estimate;
+    } else
+        estimate = static_cast<int>(floor(log10(value)));
+
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        int fractionDigits = precision - 1 - estimate;
+        if (fractionDigits > maxFastPathDigits)
+            return false;
+
+        uint64_t rounded;
+        if (fractionDigits >= 0) {
+            uint64_t integerPart;
+            uint64_t fraction;
+            roundToFixedPoint(value, fractionDigits, integerPart, fraction);
+            // Check that integerPart * 10^fractionDigits stays below 10^precision.
+            if (estimate >= 0 ? integerPart >= powersOfTen[estimate + 1] : integerPart > 0) {
+                ++estimate;
+                continue;
+            }
+            rounded = integerPart * powersOfTen[fractionDigits] + fraction;
+        } else {
+            // Rounding off whole units: the discarded fraction of value can't
+            // turn a remainder below half a unit into a tie.
+            uint64_t unit = powersOfTen[-fractionDigits];
+            uint64_t integerPart = static_cast<uint64_t>(value);
+            rounded = integerPart / unit + (integerPart % unit >= unit / 2);
+        }
+
+        if (rounded >= powersOfTen[precision])
+            ++estimate;
+        else if (rounded < powersOfTen[precision - 1])
+            --estimate;
+        else {
+            significand = rounded;
+            exponent = estimate;
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void appendDigits(char*& position, uint64_t value, int count)
+{
+    for (int i = count - 1; i >= 0; --i) {
+        position[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    position += count;
+}
+
+static inline void appendInteger(char*& position, uint64_t value)
+{
+    int count = 1;
+    while (count <= maxFastPathDigits && value >= powersOfTen[count])
+        ++count;
+    appendDigits(position, value, count);
+}
+
+// Writes significand, which has precision digits, as d.ddde+x.
+static void appendExponential(char*& position, uint64_t significand, int precision, int exponent)
+{
+    char digits[maxFastPathDigits];
+    char* digitsEnd = digits;
+    appendDigits(digitsEnd, significand, precision);
+
+    *position++ = digits[0];
+    if (precision > 1) {
+        *position++ = '.';
+        for (int i = 1; i < precision; ++i)
+            *position++ = digits[i];
+    }
+    *position++ = 'e';
+    *position++ = exponent < 0 ? '-' : '+';
+    appendInteger(position, exponent < 0 ? -exponent : exponent);
+}
+
+// Buffer size for the fast paths: a sign, sixteen integer digits, a point and
+// nineteen fraction digits for toFixed, or for toPrecision up to six leading
+// zeros before nineteen digits.
+typedef char FastPathBuffer[48];
+
 // toExponential converts a number to a string, always formatting as an expoential.
 // This method takes an optional argument specifying a number of *decimal places*
 // to round the significand to (or, put another way, this method optionally rounds
@@ -349,6 +531,19 @@ EncodedJSValue JSC_HOST_CALL numberProtoFuncToExponential(ExecState* exec)
         return JSValue::encode(jsString(exec, UString::number(x)));
 
     // Round if the argument is not undefined, always format as exponential.
+    if (!isUndefined && x && fabs(x) < maxFastPathMagnitude && decimalPlacesInExponent < maxFastPathDigits) {
+        uint64_t significand;
+        int exponent;
+        if (roundToSignificantFigures(fabs(x), decimalPlacesInExponent + 1, significand, exponent)) {
+            FastPathBuffer fastBuffer;
+            char* position = fastBuffer;
+            if (x < 0)
+                *position++ = '-';
+            appendExponential(position, significand, decimalPlacesInExponent + 1, exponent);
+            return JSValue::encode(jsString(exec, UString(fastBuffer, position - fastBuffer)));
+        }
+    }
+
     char buffer[WTF::NumberToStringBufferLength];
     DoubleConversionStringBuilder builder(buffer, WTF::NumberToStringBufferLength);
     const DoubleToStringConverter& converter = DoubleToStringConverter::EcmaScriptConverter();
@@ -388,6 +583,23 @@ EncodedJSValue JSC_HOST_CALL numberProtoFuncToFixed(ExecState* exec)
     // handled by numberToString.
     ASSERT(isfinite(x));
 
+    if (fabs(x) < maxFastPathMagnitude && decimalPlaces <= maxFastPathDigits) {
+        uint64_t integerPart;
+        uint64_t fraction;
+        roundToFixedPoint(fabs(x), decimalPlaces, integerPart, fraction);
+
+        FastPathBuffer fastBuffer;
+        char* position = fastBuffer;
+        if (x < 0)
+            *position++ = '-';
+        appendInteger(position, integerPart);
+        if (decimalPlaces) {
+            *position++ = '.';
+            appendDigits(position, fraction, decimalPlaces);
+        }
+        return JSValue::encode(jsString(exec, UString(fastBuffer, position - fastBuffer)));
+    }
+
     char buffer[WTF::NumberToStringBufferLength];
     DoubleConversionStringBuilder builder(buffer, WTF::NumberToStringBufferLength);
     const DoubleToStringConverter& converter = DoubleToStringConverter::EcmaScriptConverter();
@@ -426,6 +638,33 @@ EncodedJSValue JSC_HOST_CALL numberProtoFuncToPrecision(ExecState* exec)
     if (!isfinite(x))
         return JSValue::encode(jsString(exec, UString::number(x)));
 
+    uint64_t significand;
+    int exponent;
+    if (x && fabs(x) < maxFastPathMagnitude && significantFigures <= maxFastPathDigits
+        && roundToSignificantFigures(fabs(x), significantFigures, significand, exponent)) {
+        FastPathBuffer fastBuffer;
+        char* position = fastBuffer;
+        if (x < 0)
+            *position++ = '-';
+        if (exponent < -6 || exponent >= significantFigures)
+            appendExponential(position, significand, significantFigures, exponent);
+        else if (exponent < 0) {
+            *position++ = '0';
+            *position++ = '.';
+            for (int i = -1; i > exponent; --i)
+                *position++ = '0';
+            appendDigits(position, significand, significantFigures);
+        } else {
+            uint64_t unit = powersOfTen[significantFigures - 1 - exponent];
+            appendDigits(position, significand / unit, exponent + 1);
+            if (exponent + 1 < significantFigures) {
+                *position++ = '.';
+                appendDigits(position, significand % unit, significantFigures - 1 - exponent);
+            }
+        }
+        return JSValue::encode(jsString(exec, UString(fastBuffer, position - fastBuffer)));
+    }
+
     char buffer[WTF::NumberToStringBufferLength];
     DoubleConversionStringBuilder builder(buffer, WTF::NumberToStringBufferLength);
     const DoubleToStringConverter& converter = DoubleToStringConverter::EcmaScriptConverter();
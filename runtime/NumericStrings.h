@@ -27,15 +27,41 @@
 #define NumericStrings_h
 
 #include "UString.h"
+#include <limits>
 #include <wtf/FixedArray.h>
 #include <wtf/HashFunctions.h>
+#include <wtf/Vector.h>
 
 namespace JSC {
 
     class NumericStrings {
     public:
+        NumericStrings()
+        {
+            setCacheSize(defaultCacheSize);
+        }
+
+        // Rounded up to a power of two. Entries already cached are dropped.
+        void setCacheSize(unsigned size)
+        {
+            unsigned roundedSize = minimumCacheSize;
+            while (roundedSize < size && roundedSize < maximumCacheSize)
+                roundedSize <<= 1;
+            m_cacheMask = roundedSize - 1;
+            doubleCache.clear();
+            doubleCache.resize(roundedSize);
+            intCache.clear();
+            intCache.resize(roundedSize);
+            unsignedCache.clear();
+            unsignedCache.resize(roundedSize);
+        }
+
         UString add(double d)
         {
+            // Integral doubles format the same as ints, -0 included, and that is much cheaper
+            // than the shortest-representation search.
+            if (d >= std::numeric_limits<int>::min() && d <= std::numeric_limits<int>::max() && d == static_cast<int>(d))
+                return add(static_cast<int>(d));
             CacheEntry<double>& entry = lookup(d);
             if (d == entry.key && !entry.value.isNull())
                 return entry.value;
@@ -46,7 +72,7 @@ namespace JSC {
 
         UString add(int i)
         {
-            if (static_cast<unsigned>(i) < cacheSize)
+            if (static_cast<unsigned>(i) < smallIntCacheSize)
                 return lookupSmallString(static_cast<unsigned>(i));
             CacheEntry<int>& entry = lookup(i);
             if (i == entry.key && !entry.value.isNull())
@@ -58,7 +84,7 @@ namespace JSC {
 
         UString add(unsigned i)
         {
-            if (i < cacheSize)
+            if (i < smallIntCacheSize)
                 return lookupSmallString(static_cast<unsigned>(i));
             CacheEntry<unsigned>& entry = lookup(i);
             if (i == entry.key && !entry.value.isNull())
@@ -68,7 +94,10 @@ namespace JSC {
             return entry.value;
         }
     private:
-        static const size_t cacheSize = 64;
+        static const unsigned defaultCacheSize = 64;
+        static const unsigned minimumCacheSize = 16;
+        static const unsigned maximumCacheSize = 16 * 1024;
+        static const unsigned smallIntCacheSize = 64;
 
         template<typename T>
         struct CacheEntry {
@@ -76,21 +105,22 @@ namespace JSC {
             UString value;
         };
 
-        CacheEntry<double>& lookup(double d) { return doubleCache[WTF::FloatHash<double>::hash(d) & (cacheSize - 1)]; }
-        CacheEntry<int>& lookup(int i) { return intCache[WTF::IntHash<int>::hash(i) & (cacheSize - 1)]; }
-        CacheEntry<unsigned>& lookup(unsigned i) { return unsignedCache[WTF::IntHash<unsigned>::hash(i) & (cacheSize - 1)]; }
+        CacheEntry<double>& lookup(double d) { return doubleCache[WTF::FloatHash<double>::hash(d) & m_cacheMask]; }
+        CacheEntry<int>& lookup(int i) { return intCache[WTF::IntHash<int>::hash(i) & m_cacheMask]; }
+        CacheEntry<unsigned>& lookup(unsigned i) { return unsignedCache[WTF::IntHash<unsigned>::hash(i) & m_cacheMask]; }
         const UString& lookupSmallString(unsigned i)
         {
-            ASSERT(i < cacheSize);
+            ASSERT(i < smallIntCacheSize);
             if (smallIntCache[i].isNull())
                 smallIntCache[i] = UString::number(i);
             return smallIntCache[i];
         }
 
-        FixedArray<CacheEntry<double>, cacheSize> doubleCache;
-        FixedArray<CacheEntry<int>, cacheSize> intCache;
-        FixedArray<CacheEntry<unsigned>, cacheSize> unsignedCache;
-        FixedArray<UString, cacheSize> smallIntCache;
+        unsigned m_cacheMask;
+        Vector<CacheEntry<double> > doubleCache;
+        Vector<CacheEntry<int> > intCache;
+        Vector<CacheEntry<unsigned> > unsignedCache;
+        FixedArray<UString, smallIntCacheSize> smallIntCache;
     };
 
 } // namespace JSC
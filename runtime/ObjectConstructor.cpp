@@ -26,6 +26,7 @@
 #include "JSFunction.h"
 #include "JSArray.h"
 #include "JSGlobalObject.h"
+#include "JSPropertyNameIterator.h"
 #include "Lookup.h"
 #include "ObjectPrototype.h"
 #include "PropertyDescriptor.h"
@@ -173,10 +174,46 @@ EncodedJSValue JSC_HOST_CALL objectConstructorGetOwnPropertyDescriptor(ExecState
 }
 
 // FIXME: Use the enumeration cache.
+// When an object's own enumerable names are fully determined by its Structure, keep them on the
+// Structure as interned strings, so repeated calls on same-shaped objects only copy a vector.
+// This holds under the same conditions as the for-in enumeration cache.
+static JSPropertyNameIterator* cachedOwnKeys(ExecState* exec, JSObject* object)
+{
+    Structure* structure = object->structure();
+    if (structure->isDictionary() || structure->typeInfo().overridesGetPropertyNames())
+        return 0;
+
+    if (JSPropertyNameIterator* ownKeys = structure->ownKeysCache())
+        return ownKeys;
+
+    PropertyNameArray properties(exec);
+    object->getOwnPropertyNames(exec, properties);
+    JSPropertyNameIterator* ownKeys = JSPropertyNameIterator::create(exec, properties.data(), 0);
+    structure->setOwnKeysCache(exec->globalData(), ownKeys);
+    return ownKeys;
+}
+
+static JSArray* constructArrayFromOwnKeys(ExecState* exec, JSPropertyNameIterator* ownKeys)
+{
+    size_t numProperties = ownKeys->size();
+    JSArray* keys = JSArray::create(exec->globalData(), exec->lexicalGlobalObject()->arrayStructure(), numProperties, CreateCompact);
+    JSGlobalData& globalData = exec->globalData();
+    for (size_t i = 0; i < numProperties; i++)
+        keys->uncheckedSetIndex(globalData, i, ownKeys->name(i));
+    keys->setLength(numProperties);
+    return keys;
+}
+
 EncodedJSValue JSC_HOST_CALL objectConstructorGetOwnPropertyNames(ExecState* exec)
 {
     if (!exec->argument(0).isObject())
         return throwVMError(exec, createTypeError(exec, "Requested property names of a value that is not an object."));
+    JSObject* object = asObject(exec->argument(0));
+    // Plain objects without DontEnum properties have the same names with and without them.
+    if (object->classInfo() == &JSObject::s_info && !object->structure()->hasNonEnumerableProperties()) {
+        if (JSPropertyNameIterator* ownKeys = cachedOwnKeys(exec, object))
+            return JSValue::encode(constructArrayFromOwnKeys(exec, ownKeys));
+    }
     PropertyNameArray properties(exec);
     asObject(exec->argument(0))->getOwnPropertyNames(exec, properties, IncludeDontEnumProperties);
     JSArray* names = constructEmptyArray(exec);
@@ -186,11 +223,12 @@ EncodedJSValue JSC_HOST_CALL objectConstructorGetOwnPropertyNames(ExecState* exe
     return JSValue::encode(names);
 }
 
-// FIXME: Use the enumeration cache.
 EncodedJSValue JSC_HOST_CALL objectConstructorKeys(ExecState* exec)
 {
     if (!exec->argument(0).isObject())
         return throwVMError(exec, createTypeError(exec, "Requested keys of a value that is not an object."));
+    if (JSPropertyNameIterator* ownKeys = cachedOwnKeys(exec, asObject(exec->argument(0))))
+        return JSValue::encode(constructArrayFromOwnKeys(exec, ownKeys));
     PropertyNameArray properties(exec);
     asObject(exec->argument(0))->getOwnPropertyNames(exec, properties);
     JSArray* keys = constructEmptyArray(exec);
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PauseTelemetry_h
+#define PauseTelemetry_h
+
+#include <wtf/AlwaysInline.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/Noncopyable.h>
+
+namespace JSC {
+
+// Times the engine holds up the thread running JavaScript, for correlating them with dropped
+// frames. See JSSetPauseCallback() in JSSettingsEA.h, whose kinds and fields match these.
+enum PauseKind {
+    GarbageCollectionPause,
+    GCPhasePause,
+    CompilationPause,
+    RegisterFileGrowthPause,
+    ExecutableMemoryExhaustionPause
+};
+
+struct PauseEvent {
+    PauseKind kind;
+    bool isEnd;
+    int detail;
+    double startTime;
+    double duration;
+    size_t bytes;
+};
+
+typedef void (*PauseCallback)(const PauseEvent&);
+extern PauseCallback pauseCallback;
+
+// Reports a pause for as long as it is in scope. The callback is read once, so a pause whose
+// start was reported always reports its end; without a callback, this is a load and a branch.
+class PauseScope {
+    WTF_MAKE_NONCOPYABLE(PauseScope);
+public:
+    PauseScope(PauseKind kind, int detail, size_t bytes)
+        : m_callback(pauseCallback)
+    {
+        if (UNLIKELY(!!m_callback))
+            begin(kind, detail, bytes);
+    }
+
+    ~PauseScope()
+    {
+        if (UNLIKELY(!!m_callback))
+            end();
+    }
+
+    // Sets the byte count reported with the end of the pause.
+    void setBytes(size_t bytes) { m_event.bytes = bytes; }
+
+private:
+    void begin(PauseKind kind, int detail, size_t bytes)
+    {
+        m_event.kind = kind;
+        m_event.isEnd = false;
+        m_event.detail = detail;
+        m_event.startTime = monotonicallyIncreasingTime();
+        m_event.duration = 0;
+        m_event.bytes = bytes;
+        m_callback(m_event);
+    }
+
+    void end()
+    {
+        m_event.isEnd = true;
+        m_event.duration = monotonicallyIncreasingTime() - m_event.startTime;
+        m_callback(m_event);
+    }
+
+    PauseCallback m_callback;
+    PauseEvent m_event;
+};
+
+} // namespace JSC
+
+#endif // PauseTelemetry_h
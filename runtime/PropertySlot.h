@@ -142,6 +142,19 @@ namespace JSC {
             m_cachedPropertyType = Custom;
         }
 
+        // The value has already been computed for this access; caches call getValue on later ones.
+        void setCacheableCustomValue(JSValue slotBase, JSValue value, GetValueFunc getValue)
+        {
+            ASSERT(slotBase);
+            ASSERT(value);
+            ASSERT(getValue);
+            m_getValue = JSC_VALUE_MARKER;
+            m_slotBase = slotBase;
+            m_value = value;
+            m_data.customGetter = getValue;
+            m_cachedPropertyType = Custom;
+        }
+
         void setCustomIndex(JSValue slotBase, unsigned index, GetIndexValueFunc getIndexValue)
         {
             ASSERT(slotBase);
@@ -215,7 +228,7 @@ namespace JSC {
         GetValueFunc customGetter() const
         {
             ASSERT(m_cachedPropertyType == Custom);
-            return m_getValue;
+            return m_getValue == JSC_VALUE_MARKER ? m_data.customGetter : m_getValue;
         }
     private:
         JSValue functionGetter(ExecState*) const;
@@ -227,6 +240,7 @@ namespace JSC {
         union {
             JSObject* getterFunc;
             unsigned index;
+            GetValueFunc customGetter;
         } m_data;
 
         JSValue m_value;
@@ -36,7 +36,7 @@ namespace JSC {
     
     class PutPropertySlot {
     public:
-        enum Type { Uncachable, ExistingProperty, NewProperty };
+        enum Type { Uncachable, ExistingProperty, NewProperty, SetterProperty };
 
         PutPropertySlot(bool isStrictMode = false)
             : m_type(Uncachable)
@@ -59,13 +59,23 @@ namespace JSC {
             m_offset = offset;
         }
 
+        // The put called the setter of the accessor stored at offset in base, which
+        // may be a prototype of the object being written to.
+        void setSetterProperty(JSObject* base, size_t offset)
+        {
+            m_type = SetterProperty;
+            m_base = base;
+            m_offset = offset;
+        }
+
         Type type() const { return m_type; }
         JSObject* base() const { return m_base; }
 
         bool isStrictMode() const { return m_isStrictMode; }
-        bool isCacheable() const { return m_type != Uncachable; }
+        bool isCacheable() const { return m_type == ExistingProperty || m_type == NewProperty; }
+        bool isCacheableSetter() const { return m_type == SetterProperty; }
         size_t cachedOffset() const {
-            ASSERT(isCacheable());
+            ASSERT(isCacheable() || isCacheableSetter());
             return m_offset;
         }
 
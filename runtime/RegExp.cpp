@@ -23,14 +23,20 @@
 #include "config.h"
 #include "RegExp.h"
 
+#include "Error.h"
 #include "Lexer.h"
+#include "PauseTelemetry.h"
 #include "RegExpCache.h"
+#include "Tracing.h"
 #include "yarr/Yarr.h"
 #include "yarr/YarrJIT.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <JSSettingsEA.h>
 #include <wtf/Assertions.h>
+#include <wtf/Atomics.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/OwnArrayPtr.h>
 
 
@@ -220,10 +226,20 @@ void RegExpFunctionalTestCollector::outputEscapedUString(const UString& s, bool
 struct RegExpRepresentation {
 #if ENABLE(YARR_JIT)
     Yarr::YarrCodeBlock m_regExpJITCode;
+    // Compiled on first use by matches(), from the pattern with every group made non-capturing.
+    Yarr::YarrCodeBlock m_matchOnlyJITCode;
 #endif
     OwnPtr<Yarr::BytecodePattern> m_regExpBytecode;
+
+    // Literal text every match starts with, and a longer run every match contains. Searching
+    // for these lets match() skip start offsets, or the whole input, without running the pattern.
+    UString m_requiredPrefix;
+    UString m_requiredLiteral;
 };
 
+static const unsigned minimumRequiredPrefixLength = 2;
+static const unsigned minimumRequiredLiteralLength = 3;
+
 RegExp::RegExp(JSGlobalData& globalData, const UString& patternString, RegExpFlags flags)
     : JSCell(globalData, globalData.regExpStructure.get())
     , m_state(NotCompiled)
@@ -231,6 +247,11 @@ RegExp::RegExp(JSGlobalData& globalData, const UString& patternString, RegExpFla
     , m_flags(flags)
     , m_constructionError(0)
     , m_numSubpatterns(0)
+    , m_compileCount(0)
+    , m_compileTime(0)
+#if ENABLE(YARR_JIT)
+    , m_lastJITUse(0)
+#endif
 #if ENABLE(REGEXP_TRACING)
     , m_rtMatchCallCount(0)
     , m_rtMatchFoundCount(0)
@@ -268,6 +289,45 @@ RegExp* RegExp::create(JSGlobalData& globalData, const UString& patternString, R
 }
 
 void RegExp::compile(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
+{
+    FastMallocTagScope tagScope("JSC/RegExp");
+
+    CString tracedPattern;
+    if (JAVASCRIPTCORE_REGEXP_COMPILE_BEGIN_ENABLED()) {
+        tracedPattern = m_patternString.utf8();
+        JAVASCRIPTCORE_REGEXP_COMPILE_BEGIN(const_cast<char*>(tracedPattern.data()));
+    }
+
+    double startTime = currentTime();
+    PauseScope pause(CompilationPause, CompilationStatistics::RegExpTier, 0);
+#if ENABLE(YARR_JIT)
+    size_t previousCodeSize = jitCodeSize();
+#endif
+
+    compileInternal(globalData, charSize);
+
+    double compileTime = currentTime() - startTime;
+    ++m_compileCount;
+    m_compileTime += compileTime;
+#if ENABLE(YARR_JIT)
+    globalData->compilationStatistics.record(CompilationStatistics::RegExpTier, compileTime, jitCodeSize() - previousCodeSize);
+    pause.setBytes(jitCodeSize() - previousCodeSize);
+#else
+    globalData->compilationStatistics.record(CompilationStatistics::RegExpTier, compileTime, 0);
+#endif
+
+    if (!tracedPattern.isNull())
+        JAVASCRIPTCORE_REGEXP_COMPILE_END(const_cast<char*>(tracedPattern.data()), m_state == JITCode);
+}
+
+static int s_interpreterFallbackCount;
+
+unsigned RegExp::interpreterFallbackCount()
+{
+    return s_interpreterFallbackCount;
+}
+
+void RegExp::compileInternal(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
 {
     Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
     if (m_constructionError) {
@@ -282,23 +342,45 @@ void RegExp::compile(JSGlobalData* globalData, Yarr::YarrCharSize charSize)
         m_representation = adoptPtr(new RegExpRepresentation);
         globalData->regExpCache()->addToStrongCache(this);
         m_state = ByteCode;
+
+        Vector<UChar> prefix;
+        Vector<UChar> longestRun;
+        pattern.requiredLiterals(prefix, longestRun);
+        if (prefix.size() >= minimumRequiredPrefixLength)
+            m_representation->m_requiredPrefix = UString(prefix.data(), prefix.size());
+        if (longestRun.size() >= minimumRequiredLiteralLength && longestRun.size() > m_representation->m_requiredPrefix.length())
+            m_representation->m_requiredLiteral = UString(longestRun.data(), longestRun.size());
     }
 
 #if ENABLE(YARR_JIT)
-    if (!pattern.m_containsBackreferences && globalData->canUseJIT()) {
+    // Only the interpreter counts steps and looks at the clock part way through a match, so
+    // patterns that can backtrack catastrophically stay out of the JIT whenever either budget
+    // has been configured. The default step budget leaves them JIT compiled, as before.
+    unsigned matchLimit = JSGetRegExpMatchLimit();
+    bool hasBudget = JSGetRegExpTimeLimit() || (matchLimit && matchLimit != Yarr::matchLimit);
+    bool needsBudget = hasBudget && pattern.containsNestedQuantifiers();
+
+    if (!pattern.m_containsBackreferences && !needsBudget && globalData->canUseJIT()) {
         Yarr::jitCompile(pattern, charSize, globalData, m_representation->m_regExpJITCode);
 #if ENABLE(YARR_JIT_DEBUG)
-        if (!m_representation->m_regExpJITCode.isFallBack())
+        if (!m_representation->m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
-        else
+            globalData->regExpCache()->didCompileJITCode(this);
+        } else
             m_state = ByteCode;
 #else
         if (!m_representation->m_regExpJITCode.isFallBack()) {
             m_state = JITCode;
+            globalData->regExpCache()->didCompileJITCode(this);
             return;
         }
 #endif
     }
+
+    // Count patterns the JIT could have taken but had to leave to the interpreter, i.e. those
+    // with backreferences or with a construct YarrJIT does not generate code for.
+    if (globalData->canUseJIT() && !needsBudget && m_state != JITCode)
+        atomicIncrement(&s_interpreterFallbackCount);
 #else
     UNUSED_PARAM(charSize);
 #endif
@@ -329,6 +411,32 @@ void RegExp::compileIfNecessary(JSGlobalData& globalData, Yarr::YarrCharSize cha
 }
 
 
+static void abandonMatch(JSGlobalData& globalData, const UString& pattern)
+{
+    if (JSLogCallback logger = JSGetLogCallback()) {
+        eastl::string8 message;
+        message.sprintf("RegExp /%s/ ran out of backtracking budget; the match was abandoned.\n", pattern.utf8().data());
+        logger(message, false);
+    }
+
+    if (globalData.dynamicGlobalObject && !globalData.exception)
+        globalData.exception = createError(globalData.dynamicGlobalObject, "Regular expression too complex");
+}
+
+// Returns the first offset at or after startOffset where a match could begin, or -1 if the
+// input lacks the pattern's required literal text.
+static int firstPossibleMatchStart(const RegExpRepresentation* representation, const UString& s, int startOffset)
+{
+    if (!representation->m_requiredLiteral.isEmpty() && s.find(representation->m_requiredLiteral, startOffset) == notFound)
+        return -1;
+
+    if (representation->m_requiredPrefix.isEmpty())
+        return startOffset;
+
+    size_t prefixStart = s.find(representation->m_requiredPrefix, startOffset);
+    return prefixStart == notFound ? -1 : static_cast<int>(prefixStart);
+}
+
 int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, Vector<int, 32>* ovector)
 {
     if (startOffset < 0)
@@ -343,6 +451,10 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, V
 
     if (m_state != ParseError) {
         compileIfNecessary(globalData, s.is8Bit() ? Yarr::Char8 : Yarr::Char16);
+#if ENABLE(YARR_JIT)
+        if (m_state == JITCode)
+            m_lastJITUse = globalData.regExpCache()->nextUse();
+#endif
 
         int offsetVectorSize = (m_numSubpatterns + 1) * 2;
         int* offsetVector;
@@ -362,19 +474,26 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, V
         for (unsigned j = 0, i = 0; i < m_numSubpatterns + 1; j += 2, i++)            
             offsetVector[j] = -1;
 
-        int result;
+        int result = -1;
+        int matchStart = firstPossibleMatchStart(m_representation.get(), s, startOffset);
+        if (matchStart != -1) {
 #if ENABLE(YARR_JIT)
-        if (m_state == JITCode) {
-            if (s.is8Bit())
-                result = Yarr::execute(m_representation->m_regExpJITCode, s.latin1().data(), startOffset, s.length(), offsetVector);
-            else
-                result = Yarr::execute(m_representation->m_regExpJITCode, s.characters(), startOffset, s.length(), offsetVector);
+            if (m_state == JITCode) {
+                if (s.is8Bit())
+                    result = Yarr::execute(m_representation->m_regExpJITCode, s.latin1().data(), matchStart, s.length(), offsetVector);
+                else
+                    result = Yarr::execute(m_representation->m_regExpJITCode, s.characters(), matchStart, s.length(), offsetVector);
 #if ENABLE(YARR_JIT_DEBUG)
-            matchCompareWithInterpreter(s, startOffset, offsetVector, result);
+                matchCompareWithInterpreter(s, matchStart, offsetVector, result);
 #endif
-        } else
+            } else
 #endif
-            result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s, startOffset, s.length(), offsetVector);
+                result = Yarr::interpret(m_representation->m_regExpBytecode.get(), s, matchStart, s.length(), offsetVector);
+        }
+        if (result == Yarr::JSRegExpErrorHitLimit) {
+            abandonMatch(globalData, m_patternString);
+            result = -1;
+        }
         ASSERT(result >= -1);
 
 #if REGEXP_FUNC_TEST_DATA_GEN
@@ -392,6 +511,73 @@ int RegExp::match(JSGlobalData& globalData, const UString& s, int startOffset, V
     return -1;
 }
 
+#if ENABLE(YARR_JIT)
+// Returns false if there is no capture-free code for this character size and there never will be.
+bool RegExp::compileMatchOnlyIfNecessary(JSGlobalData& globalData, Yarr::YarrCharSize charSize)
+{
+    ASSERT(m_state == JITCode);
+    Yarr::YarrCodeBlock& codeBlock = m_representation->m_matchOnlyJITCode;
+    if (codeBlock.isFallBack())
+        return false;
+    if (charSize == Yarr::Char8 ? codeBlock.has8BitCode() : codeBlock.has16BitCode())
+        return true;
+
+    Yarr::YarrPattern pattern(m_patternString, ignoreCase(), multiline(), &m_constructionError);
+    ASSERT(!m_constructionError);
+    pattern.removeCaptures();
+    Yarr::jitCompile(pattern, charSize, &globalData, codeBlock);
+    if (codeBlock.isFallBack())
+        return false;
+    globalData.regExpCache()->didCompileJITCode(this);
+    return true;
+}
+
+size_t RegExp::jitCodeSize() const
+{
+    if (!m_representation)
+        return 0;
+    return m_representation->m_regExpJITCode.size() + m_representation->m_matchOnlyJITCode.size();
+}
+#endif
+
+size_t RegExp::bytecodeSize() const
+{
+    if (!m_representation || !m_representation->m_regExpBytecode)
+        return 0;
+    return m_representation->m_regExpBytecode->sizeInMemory();
+}
+
+bool RegExp::matches(JSGlobalData& globalData, const UString& s, int startOffset)
+{
+#if ENABLE(YARR_JIT)
+    if (startOffset < 0)
+        startOffset = 0;
+
+    // Without groups the ovector match() fills in is already just the match bounds.
+    if (m_numSubpatterns && m_state != ParseError && static_cast<unsigned>(startOffset) <= s.length() && !s.isNull()) {
+        Yarr::YarrCharSize charSize = s.is8Bit() ? Yarr::Char8 : Yarr::Char16;
+        compileIfNecessary(globalData, charSize);
+        if (m_state == JITCode && compileMatchOnlyIfNecessary(globalData, charSize)) {
+            m_lastJITUse = globalData.regExpCache()->nextUse();
+            int matchStart = firstPossibleMatchStart(m_representation.get(), s, startOffset);
+            if (matchStart == -1)
+                return false;
+
+            int offsetVector[2] = { -1, -1 };
+            int result;
+            if (s.is8Bit())
+                result = Yarr::execute(m_representation->m_matchOnlyJITCode, s.latin1().data(), matchStart, s.length(), offsetVector);
+            else
+                result = Yarr::execute(m_representation->m_matchOnlyJITCode, s.characters(), matchStart, s.length(), offsetVector);
+            ASSERT(result >= -1);
+            return result >= 0;
+        }
+    }
+#endif
+
+    return match(globalData, s, startOffset) >= 0;
+}
+
 void RegExp::invalidateCode()
 {
     if (!m_representation)
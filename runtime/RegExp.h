@@ -54,6 +54,8 @@ namespace JSC {
         const char* errorMessage() const { return m_constructionError; }
 
         int match(JSGlobalData&, const UString&, int startOffset, Vector<int, 32>* ovector = 0);
+        // Like match() without an ovector, but JIT code compiled without captures does the work.
+        bool matches(JSGlobalData&, const UString&, int startOffset);
         unsigned numSubpatterns() const { return m_numSubpatterns; }
 
         bool hasCode()
@@ -62,6 +64,20 @@ namespace JSC {
         }
 
         void invalidateCode();
+
+        // Every compile of this pattern, including those for a second character size and
+        // those after invalidateCode(). The time is in seconds.
+        unsigned compileCount() const { return m_compileCount; }
+        double compileTime() const { return m_compileTime; }
+
+        // The memory held by the compiled code, in bytes.
+#if ENABLE(YARR_JIT)
+        size_t jitCodeSize() const;
+#endif
+        size_t bytecodeSize() const;
+
+        // The number of patterns compiled to bytecode although the JIT was available.
+        static unsigned interpreterFallbackCount();
         
 #if ENABLE(REGEXP_TRACING)
         void printTraceData();
@@ -93,7 +109,11 @@ namespace JSC {
         } m_state;
 
         void compile(JSGlobalData*, Yarr::YarrCharSize);
+        void compileInternal(JSGlobalData*, Yarr::YarrCharSize);
         void compileIfNecessary(JSGlobalData&, Yarr::YarrCharSize);
+#if ENABLE(YARR_JIT)
+        bool compileMatchOnlyIfNecessary(JSGlobalData&, Yarr::YarrCharSize);
+#endif
 
 #if ENABLE(YARR_JIT_DEBUG)
         void matchCompareWithInterpreter(const UString&, int startOffset, int* offsetVector, int jitResult);
@@ -103,6 +123,11 @@ namespace JSC {
         RegExpFlags m_flags;
         const char* m_constructionError;
         unsigned m_numSubpatterns;
+        unsigned m_compileCount;
+        double m_compileTime;
+#if ENABLE(YARR_JIT)
+        unsigned m_lastJITUse; // RegExpCache's use clock when the JIT code last ran.
+#endif
 #if ENABLE(REGEXP_TRACING)
         unsigned m_rtMatchCallCount;
         unsigned m_rtMatchFoundCount;
@@ -29,6 +29,8 @@
 
 #include "RegExpCache.h"
 #include "RegExpObject.h"
+#include <JSSettingsEA.h>
+#include <algorithm>
 
 namespace JSC {
 
@@ -52,6 +54,11 @@ RegExp* RegExpCache::lookupOrCreate(const UString& patternString, RegExpFlags fl
 RegExpCache::RegExpCache(JSGlobalData* globalData)
     : m_nextEntryInStrongCache(0)
     , m_globalData(globalData)
+#if ENABLE(YARR_JIT)
+    , m_jitCodeSize(0)
+    , m_jitCodeBudget(JSGetRegExpJITCodeBudget())
+    , m_useClock(0)
+#endif
 {
 }
 
@@ -59,9 +66,60 @@ void RegExpCache::finalize(Handle<Unknown> handle, void*)
 {
     RegExp* regExp = static_cast<RegExp*>(handle.get().asCell());
     m_weakCache.remove(regExp->key());
+#if ENABLE(YARR_JIT)
+    JITCodeSizeMap::iterator jitCode = m_jitCodeSizes.find(regExp);
+    if (jitCode != m_jitCodeSizes.end()) {
+        m_jitCodeSize -= jitCode->second;
+        m_jitCodeSizes.remove(jitCode);
+    }
+#endif
     regExp->invalidateCode();
 }
 
+#if ENABLE(YARR_JIT)
+void RegExpCache::didCompileJITCode(RegExp* regExp)
+{
+    size_t codeSize = regExp->jitCodeSize();
+    std::pair<JITCodeSizeMap::iterator, bool> result = m_jitCodeSizes.add(regExp, 0);
+    m_jitCodeSize -= result.first->second;
+    m_jitCodeSize += codeSize;
+    result.first->second = codeSize;
+
+    if (m_jitCodeBudget && m_jitCodeSize > m_jitCodeBudget)
+        discardJITCodeOverBudget(regExp);
+}
+
+static bool isYounger(const std::pair<unsigned, RegExp*>& a, const std::pair<unsigned, RegExp*>& b)
+{
+    return a.first < b.first;
+}
+
+// Throws away the least recently used JIT code, other than that of the regular expression that
+// was just compiled, until the total fits the budget. Anything discarded is recompiled from
+// scratch on its next match.
+void RegExpCache::discardJITCodeOverBudget(RegExp* compiled)
+{
+    Vector<std::pair<unsigned, RegExp*> > candidates;
+    candidates.reserveInitialCapacity(m_jitCodeSizes.size());
+    JITCodeSizeMap::iterator end = m_jitCodeSizes.end();
+    for (JITCodeSizeMap::iterator it = m_jitCodeSizes.begin(); it != end; ++it) {
+        // Sort by age rather than by last use, which stays correct when the clock wraps.
+        if (it->first != compiled)
+            candidates.append(std::make_pair(m_useClock - it->first->m_lastJITUse, it->first));
+    }
+    std::sort(candidates.begin(), candidates.end(), isYounger);
+
+    while (m_jitCodeSize > m_jitCodeBudget && !candidates.isEmpty()) {
+        RegExp* regExp = candidates.last().second;
+        candidates.removeLast();
+        JITCodeSizeMap::iterator jitCode = m_jitCodeSizes.find(regExp);
+        m_jitCodeSize -= jitCode->second;
+        m_jitCodeSizes.remove(jitCode);
+        regExp->invalidateCode();
+    }
+}
+#endif
+
 void RegExpCache::addToStrongCache(RegExp* regExp)
 {
     UString pattern = regExp->pattern();
@@ -78,6 +136,10 @@ void RegExpCache::invalidateCode()
     for (int i = 0; i < maxStrongCacheableEntries; i++)
         m_strongCache[i].clear();
     m_nextEntryInStrongCache = 0;
+#if ENABLE(YARR_JIT)
+    m_jitCodeSizes.clear();
+    m_jitCodeSize = 0;
+#endif
     RegExpCacheMap::iterator end = m_weakCache.end();
     for (RegExpCacheMap::iterator ptr = m_weakCache.begin(); ptr != end; ++ptr)
         ptr->second->invalidateCode();
@@ -56,10 +56,25 @@ private:
 
     RegExp* lookupOrCreate(const UString& patternString, RegExpFlags);
     void addToStrongCache(RegExp*);
+
+#if ENABLE(YARR_JIT)
+    unsigned nextUse() { return ++m_useClock; }
+    void didCompileJITCode(RegExp*);
+    void discardJITCodeOverBudget(RegExp* compiled);
+#endif
+
     RegExpCacheMap m_weakCache; // Holds all regular expressions currently live.
     int m_nextEntryInStrongCache;
     WTF::FixedArray<Strong<RegExp>, maxStrongCacheableEntries> m_strongCache; // Holds a select few regular expressions that have compiled and executed
     JSGlobalData* m_globalData;
+
+#if ENABLE(YARR_JIT)
+    typedef HashMap<RegExp*, size_t> JITCodeSizeMap;
+    JITCodeSizeMap m_jitCodeSizes; // Holds every regular expression with JIT code, and the code's size.
+    size_t m_jitCodeSize;
+    size_t m_jitCodeBudget; // 0 for no limit.
+    unsigned m_useClock;
+#endif
 };
 
 } // namespace JSC
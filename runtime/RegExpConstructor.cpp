@@ -113,6 +113,16 @@ void RegExpConstructor::finishCreation(ExecState* exec, RegExpPrototype* regExpP
     putDirectWithoutTransition(exec->globalData(), exec->propertyNames().length, jsNumber(2), ReadOnly | DontDelete | DontEnum);
 }
 
+// What a RegExpMatchesArray needs to fill itself in on first use. Only the result part of the
+// constructor's ovector is kept, and the inline capacity covers up to three subpatterns.
+struct RegExpMatchesArrayData {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    UString input;
+    unsigned numSubpatterns;
+    Vector<int, 8> ovector;
+};
+
 RegExpMatchesArray::RegExpMatchesArray(ExecState* exec)
     : JSArray(exec->globalData(), exec->lexicalGlobalObject()->regExpMatchesArrayStructure())
 {
@@ -121,40 +131,34 @@ RegExpMatchesArray::RegExpMatchesArray(ExecState* exec)
 void RegExpMatchesArray::finishCreation(JSGlobalData& globalData, RegExpConstructorPrivate* data)
 {
     Base::finishCreation(globalData, data->lastNumSubPatterns + 1, CreateInitialized);
-    RegExpConstructorPrivate* d = new RegExpConstructorPrivate;
+    RegExpMatchesArrayData* d = new RegExpMatchesArrayData;
     d->input = data->lastInput;
-    d->lastInput = data->lastInput;
-    d->lastNumSubPatterns = data->lastNumSubPatterns;
-    unsigned offsetVectorSize = (data->lastNumSubPatterns + 1) * 2; // only copying the result part of the vector
-    d->lastOvector().resize(offsetVectorSize);
-    memcpy(d->lastOvector().data(), data->lastOvector().data(), offsetVectorSize * sizeof(int));
-    // d->multiline is not needed, and remains uninitialized
+    d->numSubpatterns = data->lastNumSubPatterns;
+    d->ovector.append(data->lastOvector().data(), (data->lastNumSubPatterns + 1) * 2);
 
     setSubclassData(d);
 }
 
 RegExpMatchesArray::~RegExpMatchesArray()
 {
-    delete static_cast<RegExpConstructorPrivate*>(subclassData());
+    delete static_cast<RegExpMatchesArrayData*>(subclassData());
 }
 
 void RegExpMatchesArray::fillArrayInstance(ExecState* exec)
 {
-    RegExpConstructorPrivate* d = static_cast<RegExpConstructorPrivate*>(subclassData());
+    RegExpMatchesArrayData* d = static_cast<RegExpMatchesArrayData*>(subclassData());
     ASSERT(d);
 
-    unsigned lastNumSubpatterns = d->lastNumSubPatterns;
-
-    for (unsigned i = 0; i <= lastNumSubpatterns; ++i) {
-        int start = d->lastOvector()[2 * i];
+    for (unsigned i = 0; i <= d->numSubpatterns; ++i) {
+        int start = d->ovector[2 * i];
         if (start >= 0)
-            JSArray::put(exec, i, jsSubstring(exec, d->lastInput, start, d->lastOvector()[2 * i + 1] - start));
+            JSArray::put(exec, i, jsSubstring(exec, d->input, start, d->ovector[2 * i + 1] - start));
         else
             JSArray::put(exec, i, jsUndefined());
     }
 
     PutPropertySlot slot;
-    JSArray::put(exec, exec->propertyNames().index, jsNumber(d->lastOvector()[0]), slot);
+    JSArray::put(exec, exec->propertyNames().index, jsNumber(d->ovector[0]), slot);
     JSArray::put(exec, exec->propertyNames().input, jsString(exec, d->input), slot);
 
     delete d;
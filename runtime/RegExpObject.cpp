@@ -182,6 +182,11 @@ JSValue RegExpObject::exec(ExecState* exec)
 }
 
 // Shared implementation used by test and exec.
+//
+// Calling exec repeatedly on one string, as tokenizers do, costs no setup per call that a
+// cached input descriptor would save. A rope is resolved once and the JSString keeps the
+// result. Getting that UString, its characters and the compiled code takes constant time, and
+// the match starts directly at lastIndex.
 bool RegExpObject::match(ExecState* exec)
 {
     RegExpConstructor* regExpConstructor = exec->lexicalGlobalObject()->regExpConstructor();
@@ -41,11 +41,16 @@ public:
     static PassRefPtr<RopeImpl> tryCreateUninitialized(unsigned fiberCount)
     {
         void* allocation;
-        if (tryFastMalloc(sizeof(RopeImpl) + (fiberCount - 1) * sizeof(Fiber)).getValue(allocation))
+        if (tryFastMalloc(allocationSize(fiberCount)).getValue(allocation))
             return adoptRef(new (allocation) RopeImpl(fiberCount));
         return 0;
     }
 
+    static size_t allocationSize(unsigned fiberCount)
+    {
+        return sizeof(RopeImpl) + (fiberCount - 1) * sizeof(Fiber);
+    }
+
     static bool isRope(Fiber fiber)
     {
         return !fiber->isStringImpl();
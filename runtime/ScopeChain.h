@@ -32,6 +32,11 @@ namespace JSC {
     class JSObject;
     class ScopeChainIterator;
     class SlotVisitor;
+    class ScopeChainNode;
+
+    template <> struct NeedsDestructor<ScopeChainNode> {
+        static const bool value = false;
+    };
     
     class ScopeChainNode : public JSCell {
     private:
@@ -49,8 +49,8 @@ public:
     
     void set(JSGlobalData& globalData, JSCell* owner, PropertyStorage newStorage)
     {
-        if (!globalData.heap.inPropertyStorageNursery(m_storage))
-            globalData.heap.writeBarrier(owner, JSValue());
+        if (globalData.heap.inPropertyStorageNursery(newStorage))
+            Heap::writeBarrierForNurseryStorage(owner);
         m_storage = newStorage;
     }
     
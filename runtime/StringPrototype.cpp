@@ -231,9 +231,11 @@ static inline UString substituteBackreferences(const UString& replacement, const
     return replacement;
 }
 
-static inline int localeCompare(const UString& a, const UString& b)
+static inline int localeCompare(ExecState* exec, const UString& a, const UString& b)
 {
-    return Collator::userDefault()->collate(reinterpret_cast<const ::UChar*>(a.characters()), a.length(), reinterpret_cast<const ::UChar*>(b.characters()), b.length());
+    if (a.impl() == b.impl())
+        return 0;
+    return exec->globalData().defaultCollator().collate(reinterpret_cast<const ::UChar*>(a.characters()), a.length(), reinterpret_cast<const ::UChar*>(b.characters()), b.length());
 }
 
 struct StringRange {
@@ -456,6 +458,8 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
                 }
             }
         } else {
+            // Where the replacement's first $ is doesn't depend on the match, so look for it once.
+            size_t firstDollar = callType == CallTypeNone ? replacementString.find('$', 0) : notFound;
             do {
                 int matchIndex;
                 int matchLen = 0;
@@ -491,8 +495,10 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
                     if (lastIndex < matchIndex || replLen) {
                         sourceRanges.append(StringRange(lastIndex, matchIndex - lastIndex));
  
-                        if (replLen)
-                            replacements.append(substituteBackreferences(replacementString, source, ovector, reg));
+                        if (firstDollar != notFound)
+                            replacements.append(substituteBackreferencesSlow(replacementString, source, ovector, reg, firstDollar));
+                        else if (replLen)
+                            replacements.append(replacementString);
                         else
                             replacements.append(UString());
                     }
@@ -543,8 +549,13 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncReplace(ExecState* exec)
     }
     
     size_t matchEnd = matchPos + matchLen;
-    int ovector[2] = { matchPos, matchEnd };
-    return JSValue::encode(jsString(exec, source.substringSharingImpl(0, matchPos), substituteBackreferences(replacementString, source, ovector, 0), source.substringSharingImpl(matchEnd)));
+    // A replacer function's result is used as it is (ES5 15.5.4.11); only a replacement
+    // string is scanned for $ patterns.
+    if (callType == CallTypeNone) {
+        int ovector[2] = { matchPos, matchEnd };
+        replacementString = substituteBackreferences(replacementString, source, ovector, 0);
+    }
+    return JSValue::encode(jsString(exec, source.substringSharingImpl(0, matchPos), replacementString, source.substringSharingImpl(matchEnd)));
 }
 
 EncodedJSValue JSC_HOST_CALL stringProtoFuncToString(ExecState* exec)
@@ -566,6 +577,15 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    if (thisValue.isString() && exec->argument(0).isUInt32()) {
+        // Reads straight from a rope's fibers, so that looking at a string that is still being
+        // built up doesn't flatten it.
+        JSString* string = asString(thisValue);
+        uint32_t i = exec->argument(0).asUInt32();
+        if (string->canGetIndex(i))
+            return JSValue::encode(string->getIndex(exec, i));
+        return JSValue::encode(jsEmptyString(exec));
+    }
     UString s = thisValue.toString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -586,6 +606,13 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncCharCodeAt(ExecState* exec)
     JSValue thisValue = exec->hostThisValue();
     if (thisValue.isUndefinedOrNull()) // CheckObjectCoercible
         return throwVMTypeError(exec);
+    if (thisValue.isString() && exec->argument(0).isUInt32()) {
+        JSString* string = asString(thisValue);
+        uint32_t i = exec->argument(0).asUInt32();
+        if (string->canGetIndex(i))
+            return JSValue::encode(jsNumber(string->characterAt(exec, i)));
+        return JSValue::encode(jsNaN());
+    }
     UString s = thisValue.toString(exec);
     unsigned len = s.length();
     JSValue a0 = exec->argument(0);
@@ -779,6 +806,36 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSlice(ExecState* exec)
     return JSValue::encode(jsEmptyString(exec));
 }
 
+// Splits a non-empty string on a separator of at most one character. The pieces are gathered in
+// a MarkedArgumentBuffer, which keeps them alive, so that the array is allocated once at its
+// final size rather than grown by a put() per piece.
+static JSArray* splitOnCharacter(ExecState* exec, const UString& s, const UString& separator, unsigned limit)
+{
+    ASSERT(!s.isEmpty() && separator.length() <= 1);
+    MarkedArgumentBuffer pieces;
+    unsigned length = s.length();
+
+    if (separator.isEmpty()) {
+        unsigned count = std::min(length, limit);
+        for (unsigned i = 0; i < count; ++i)
+            pieces.append(jsSingleCharacterSubstring(exec, s, i));
+        return constructArray(exec, pieces);
+    }
+
+    const UChar* characters = s.characters();
+    UChar separatorCharacter = separator[0];
+    unsigned pieceStart = 0;
+    for (unsigned i = 0; i < length && pieces.size() < limit; ++i) {
+        if (characters[i] != separatorCharacter)
+            continue;
+        pieces.append(jsSubstring(exec, s, pieceStart, i - pieceStart));
+        pieceStart = i + 1;
+    }
+    if (pieces.size() < limit)
+        pieces.append(jsSubstring(exec, s, pieceStart, length - pieceStart));
+    return constructArray(exec, pieces);
+}
+
 EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
 {
     JSValue thisValue = exec->hostThisValue();
@@ -790,13 +847,21 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
     JSValue a0 = exec->argument(0);
     JSValue a1 = exec->argument(1);
 
+    unsigned limit = a1.isUndefined() ? 0xFFFFFFFFU : a1.toUInt32(exec);
+    bool separatorIsRegExp = a0.inherits(&RegExpObject::s_info);
+    UString u2;
+    if (!separatorIsRegExp) {
+        u2 = a0.toString(exec);
+        if (u2.length() <= 1 && !s.isEmpty())
+            return JSValue::encode(splitOnCharacter(exec, s, u2, limit));
+    }
+
     JSArray* result = constructEmptyArray(exec);
     unsigned i = 0;
     unsigned p0 = 0;
-    unsigned limit = a1.isUndefined() ? 0xFFFFFFFFU : a1.toUInt32(exec);
-    if (a0.inherits(&RegExpObject::s_info)) {
+    if (separatorIsRegExp) {
         RegExp* reg = asRegExpObject(a0)->regExp();
-        if (s.isEmpty() && reg->match(*globalData, s, 0) >= 0) {
+        if (s.isEmpty() && reg->matches(*globalData, s, 0)) {
             // empty string matched by regexp -> empty array
             return JSValue::encode(result);
         }
@@ -821,7 +886,6 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncSplit(ExecState* exec)
             }
         }
     } else {
-        UString u2 = a0.toString(exec);
         if (u2.isEmpty()) {
             if (s.isEmpty()) {
                 // empty separator matches empty string -> empty array
@@ -1025,7 +1089,7 @@ EncodedJSValue JSC_HOST_CALL stringProtoFuncLocaleCompare(ExecState* exec)
     UString s = thisValue.toString(exec);
 
     JSValue a0 = exec->argument(0);
-    return JSValue::encode(jsNumber(localeCompare(s, a0.toString(exec))));
+    return JSValue::encode(jsNumber(localeCompare(exec, s, a0.toString(exec))));
 }
 
 EncodedJSValue JSC_HOST_CALL stringProtoFuncBig(ExecState* exec)
@@ -27,6 +27,7 @@
 #include "Structure.h"
 
 #include "Identifier.h"
+#include "JSGlobalObject.h"
 #include "JSObject.h"
 #include "JSPropertyNameIterator.h"
 #include "Lookup.h"
@@ -152,6 +153,11 @@ void Structure::dumpStatistics()
     printf("Number of Structures with PropertyMaps: %d\n", numberWithPropertyMaps);
 
     printf("Size of a single Structures: %d\n", static_cast<unsigned>(sizeof(Structure)));
+    printf("Offsets of the hot Structure fields: typeInfo %d, prototype %d, cachedPrototypeChain %d, classInfo %d, enumerationCache %d, propertyTable %d\n",
+        static_cast<int>(OBJECT_OFFSETOF(Structure, m_typeInfo)), static_cast<int>(OBJECT_OFFSETOF(Structure, m_prototype)),
+        static_cast<int>(OBJECT_OFFSETOF(Structure, m_cachedPrototypeChain)), static_cast<int>(OBJECT_OFFSETOF(Structure, m_classInfo)),
+        static_cast<int>(OBJECT_OFFSETOF(Structure, m_enumerationCache)), static_cast<int>(OBJECT_OFFSETOF(Structure, m_propertyTable)));
+    printf("Offset of the first transition field (previous): %d\n", static_cast<int>(OBJECT_OFFSETOF(Structure, m_previous)));
     printf("Size of sum of all property maps: %d\n", totalPropertyMapsSize);
     printf("Size of average of all property maps: %f\n", static_cast<double>(totalPropertyMapsSize) / static_cast<double>(liveStructureSet.size()));
 #else
@@ -162,10 +168,11 @@ void Structure::dumpStatistics()
 Structure::Structure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSValue prototype, const TypeInfo& typeInfo, const ClassInfo* classInfo)
     : JSCell(globalData, globalData.structureStructure.get())
     , m_typeInfo(typeInfo)
-    , m_globalObject(globalData, this, globalObject, WriteBarrier<JSGlobalObject>::MayBeNull)
+    , m_propertyStorageCapacity(typeInfo.isFinal() ? JSFinalObject_inlineStorageCapacity : JSNonFinalObject_inlineStorageCapacity)
     , m_prototype(globalData, this, prototype)
     , m_classInfo(classInfo)
-    , m_propertyStorageCapacity(typeInfo.isFinal() ? JSFinalObject_inlineStorageCapacity : JSNonFinalObject_inlineStorageCapacity)
+    , m_globalObject(globalData, this, globalObject, WriteBarrier<JSGlobalObject>::MayBeNull)
+    , m_outOfLineCapacityHint(0)
     , m_offset(noOffset)
     , m_dictionaryKind(NoneDictionaryKind)
     , m_isPinnedPropertyTable(false)
@@ -175,6 +182,7 @@ Structure::Structure(JSGlobalData& globalData, JSGlobalObject* globalObject, JSV
     , m_specificFunctionThrashCount(0)
     , m_preventExtensions(false)
     , m_didTransition(false)
+    , m_hasBeenFlattenedBefore(false)
 {
 }
 
@@ -183,9 +191,10 @@ const ClassInfo Structure::s_info = { "Structure", 0, 0, 0 };
 Structure::Structure(JSGlobalData& globalData)
     : JSCell(CreatingEarlyCell)
     , m_typeInfo(CompoundType, OverridesVisitChildren)
+    , m_propertyStorageCapacity(0)
     , m_prototype(globalData, this, jsNull())
     , m_classInfo(&s_info)
-    , m_propertyStorageCapacity(0)
+    , m_outOfLineCapacityHint(0)
     , m_offset(noOffset)
     , m_dictionaryKind(NoneDictionaryKind)
     , m_isPinnedPropertyTable(false)
@@ -195,15 +204,17 @@ Structure::Structure(JSGlobalData& globalData)
     , m_specificFunctionThrashCount(0)
     , m_preventExtensions(false)
     , m_didTransition(false)
+    , m_hasBeenFlattenedBefore(false)
 {
 }
 
 Structure::Structure(JSGlobalData& globalData, const Structure* previous)
     : JSCell(globalData, globalData.structureStructure.get())
     , m_typeInfo(previous->typeInfo())
+    , m_propertyStorageCapacity(previous->m_propertyStorageCapacity)
     , m_prototype(globalData, this, previous->storedPrototype())
     , m_classInfo(previous->m_classInfo)
-    , m_propertyStorageCapacity(previous->m_propertyStorageCapacity)
+    , m_outOfLineCapacityHint(previous->m_outOfLineCapacityHint)
     , m_offset(noOffset)
     , m_dictionaryKind(NoneDictionaryKind)
     , m_isPinnedPropertyTable(false)
@@ -213,6 +224,7 @@ Structure::Structure(JSGlobalData& globalData, const Structure* previous)
     , m_specificFunctionThrashCount(previous->m_specificFunctionThrashCount)
     , m_preventExtensions(previous->m_preventExtensions)
     , m_didTransition(true)
+    , m_hasBeenFlattenedBefore(previous->m_hasBeenFlattenedBefore)
 {
     if (previous->m_globalObject)
         m_globalObject.set(globalData, this, previous->m_globalObject.get());
@@ -248,8 +260,12 @@ void Structure::materializePropertyMap(JSGlobalData& globalData)
     if (!m_propertyTable)
         createPropertyMap(m_offset + 1);
 
-    for (ptrdiff_t i = structures.size() - 2; i >= 0; --i) {
+    // The oldest Structure collected is either the root, which names no property, or the
+    // first transition out of the pinned table we copied, whose property is not in that copy.
+    for (ptrdiff_t i = structures.size() - 1; i >= 0; --i) {
         structure = structures[i];
+        if (!structure->m_nameInPrevious)
+            continue;
         PropertyMapEntry entry(globalData, this, structure->m_nameInPrevious.get(), structure->m_offset, structure->m_attributesInPrevious, structure->m_specificValueInPrevious.get());
         m_propertyTable->add(entry);
     }
@@ -257,12 +273,34 @@ void Structure::materializePropertyMap(JSGlobalData& globalData)
 
 void Structure::growPropertyStorageCapacity()
 {
-    if (isUsingInlineStorage())
-        m_propertyStorageCapacity = JSObject::baseExternalStorageCapacity;
-    else
+    if (isUsingInlineStorage()) {
+        unsigned capacity = JSObject::baseExternalStorageCapacity;
+        m_propertyStorageCapacity = m_outOfLineCapacityHint > capacity ? m_outOfLineCapacityHint : capacity;
+    } else
         m_propertyStorageCapacity *= 2;
 }
 
+// Objects from this transition chain had to grow their out-of-line storage a second time. If
+// the chain hangs off a prototype's inheritor ID, remember the capacity on the root and hand
+// the prototype a fresh inheritor ID, so later objects built by its constructor allocate that
+// much storage when they first leave inline storage. The Object literal root is shared by
+// every literal in the program, so it does not learn.
+void Structure::didRegrowOutOfLineStorage(JSGlobalData& globalData)
+{
+    Structure* root = this;
+    while (Structure* previous = root->previousID())
+        root = previous;
+
+    if (root->m_outOfLineCapacityHint >= m_propertyStorageCapacity)
+        return;
+    JSValue prototype = root->storedPrototype();
+    if (!prototype.isObject() || !root->globalObject() || root == root->globalObject()->emptyObjectStructure())
+        return;
+
+    root->m_outOfLineCapacityHint = m_propertyStorageCapacity;
+    asObject(prototype)->refreshInheritorID(globalData, root);
+}
+
 void Structure::despecifyDictionaryFunction(JSGlobalData& globalData, const Identifier& propertyName)
 {
     StringImpl* rep = propertyName.impl();
@@ -336,18 +374,27 @@ Structure* Structure::addPropertyTransition(JSGlobalData& globalData, Structure*
         else
             transition->m_propertyTable = structure->m_propertyTable.release();
     } else {
-        if (structure->m_previous)
-            transition->materializePropertyMap(globalData);
-        else
+        // Rebuild from the parent rather than from the transition, whose own property has no
+        // offset yet. The parent's table may have been handed to another child or discarded
+        // by the collector.
+        if (structure->m_previous) {
+            structure->materializePropertyMap(globalData);
+            transition->m_propertyTable = structure->m_propertyTable.release();
+        } else
             transition->createPropertyMap();
     }
 
     offset = transition->putSpecificValue(globalData, propertyName, attributes, specificValue);
-    if (transition->propertyStorageSize() > transition->propertyStorageCapacity())
+    bool didRegrowOutOfLineStorage = false;
+    if (transition->propertyStorageSize() > transition->propertyStorageCapacity()) {
+        didRegrowOutOfLineStorage = !transition->isUsingInlineStorage();
         transition->growPropertyStorageCapacity();
+    }
 
     transition->m_offset = offset;
     structure->m_transitionTable.add(globalData, transition);
+    if (didRegrowOutOfLineStorage)
+        transition->didRegrowOutOfLineStorage(globalData);
     return transition;
 }
 
@@ -541,6 +588,7 @@ Structure* Structure::flattenDictionaryStructure(JSGlobalData& globalData, JSObj
     }
 
     m_dictionaryKind = NoneDictionaryKind;
+    m_hasBeenFlattenedBefore = true;
     return this;
 }
 
@@ -551,6 +599,9 @@ size_t Structure::addPropertyWithoutTransition(JSGlobalData& globalData, const I
     if (m_specificFunctionThrashCount == maxSpecificFunctionThrashCount)
         specificValue = 0;
 
+    // The name list changes in place, so Object.keys must rebuild it.
+    m_ownKeysCache.clear();
+
     materializePropertyMapIfNecessary(globalData);
 
     m_isPinnedPropertyTable = true;
@@ -744,6 +795,13 @@ void Structure::visitChildren(SlotVisitor& visitor)
         visitor.append(&m_specificValueInPrevious);
     if (m_enumerationCache)
         visitor.append(&m_enumerationCache);
+    if (m_ownKeysCache)
+        visitor.append(&m_ownKeysCache);
+    // An unpinned table holds nothing the transition chain cannot reproduce, so drop it and let
+    // the next lookup materialize it again. Structures that are no longer looked up then stop
+    // costing a table each.
+    if (m_propertyTable && !m_isPinnedPropertyTable && m_previous)
+        m_propertyTable.clear();
     if (m_propertyTable) {
         PropertyTable::iterator end = m_propertyTable->end();
         for (PropertyTable::iterator ptr = m_propertyTable->begin(); ptr != end; ++ptr) {
@@ -118,6 +118,7 @@ namespace JSC {
         
         bool isDictionary() const { return m_dictionaryKind != NoneDictionaryKind; }
         bool isUncacheableDictionary() const { return m_dictionaryKind == UncachedDictionaryKind; }
+        bool hasBeenFlattenedBefore() const { return m_hasBeenFlattenedBefore; }
 
         const TypeInfo& typeInfo() const { ASSERT(structure()->classInfo() == &s_info); return m_typeInfo; }
 
@@ -132,9 +133,12 @@ namespace JSC {
         Structure* previousID() const { ASSERT(structure()->classInfo() == &s_info); return m_previous.get(); }
 
         void growPropertyStorageCapacity();
+        unsigned outOfLineCapacityHint() const { return m_outOfLineCapacityHint; }
+        void setOutOfLineCapacityHint(unsigned capacity) { m_outOfLineCapacityHint = capacity; }
         unsigned propertyStorageCapacity() const { ASSERT(structure()->classInfo() == &s_info); return m_propertyStorageCapacity; }
         unsigned propertyStorageSize() const { ASSERT(structure()->classInfo() == &s_info); return (m_propertyTable ? m_propertyTable->propertyStorageSize() : static_cast<unsigned>(m_offset + 1)); }
         bool isUsingInlineStorage() const;
+        size_t propertyTableSizeInMemory() const { return m_propertyTable ? m_propertyTable->sizeInMemory() : 0; }
 
         size_t get(JSGlobalData&, const Identifier& propertyName);
         size_t get(JSGlobalData&, const UString& name);
@@ -158,6 +162,8 @@ namespace JSC {
 
         void setEnumerationCache(JSGlobalData&, JSPropertyNameIterator* enumerationCache); // Defined in JSPropertyNameIterator.h.
         JSPropertyNameIterator* enumerationCache(); // Defined in JSPropertyNameIterator.h.
+        void setOwnKeysCache(JSGlobalData&, JSPropertyNameIterator* ownKeysCache); // Defined in JSPropertyNameIterator.h.
+        JSPropertyNameIterator* ownKeysCache(); // Defined in JSPropertyNameIterator.h.
         void getPropertyNames(JSGlobalData&, PropertyNameArray&, EnumerationMode mode);
 
         const ClassInfo* classInfo() const { return m_classInfo; }
@@ -167,6 +173,16 @@ namespace JSC {
             return OBJECT_OFFSETOF(Structure, m_prototype);
         }
 
+        static ptrdiff_t cachedPrototypeChainOffset()
+        {
+            return OBJECT_OFFSETOF(Structure, m_cachedPrototypeChain);
+        }
+
+        static ptrdiff_t enumerationCacheOffset()
+        {
+            return OBJECT_OFFSETOF(Structure, m_enumerationCache);
+        }
+
         static ptrdiff_t typeInfoFlagsOffset()
         {
             return OBJECT_OFFSETOF(Structure, m_typeInfo) + TypeInfo::flagsOffset();
@@ -218,6 +234,7 @@ namespace JSC {
 
         PassOwnPtr<PropertyTable> copyPropertyTable(JSGlobalData&, Structure* owner);
         void materializePropertyMap(JSGlobalData&);
+        void didRegrowOutOfLineStorage(JSGlobalData&);
         void materializePropertyMapIfNecessary(JSGlobalData& globalData)
         {
             ASSERT(structure()->classInfo() == &s_info);
@@ -239,25 +256,31 @@ namespace JSC {
 
         static const unsigned maxSpecificFunctionThrashCount = 3;
 
+        // The fields the JIT's property access and prototype chain stubs load, and those that
+        // get(), inherits() and put transitions read on every lookup, come first, so that together
+        // with the JSCell header they share one cache line. Transition bookkeeping, only touched
+        // when the structure graph changes, follows them.
         TypeInfo m_typeInfo;
-        
-        WriteBarrier<JSGlobalObject> m_globalObject;
+        uint32_t m_propertyStorageCapacity;
         WriteBarrier<Unknown> m_prototype;
         mutable WriteBarrier<StructureChain> m_cachedPrototypeChain;
+        const ClassInfo* m_classInfo;
+        WriteBarrier<JSPropertyNameIterator> m_enumerationCache;
+        OwnPtr<PropertyTable> m_propertyTable;
+
+        WriteBarrier<JSGlobalObject> m_globalObject;
 
         WriteBarrier<Structure> m_previous;
         RefPtr<StringImpl> m_nameInPrevious;
         WriteBarrier<JSCell> m_specificValueInPrevious;
 
-        const ClassInfo* m_classInfo;
-
         StructureTransitionTable m_transitionTable;
 
-        WriteBarrier<JSPropertyNameIterator> m_enumerationCache;
+        WriteBarrier<JSPropertyNameIterator> m_ownKeysCache;
 
-        OwnPtr<PropertyTable> m_propertyTable;
-
-        uint32_t m_propertyStorageCapacity;
+        // Out-of-line capacity to use on first leaving inline storage, learned from earlier
+        // objects built from the same inheritor ID.
+        uint32_t m_outOfLineCapacityHint;
 
         // m_offset does not account for anonymous slots
         signed char m_offset;
@@ -277,7 +300,8 @@ namespace JSC {
         unsigned m_specificFunctionThrashCount : 2;
         unsigned m_preventExtensions : 1;
         unsigned m_didTransition : 1;
-        // 8 free bits
+        unsigned m_hasBeenFlattenedBefore : 1;
+        // 7 free bits
     };
 
     inline size_t Structure::get(JSGlobalData& globalData, const Identifier& propertyName)
@@ -335,6 +359,8 @@ namespace JSC {
     {
         ASSERT(!m_isCheckingForDefaultMarkViolation);
         ASSERT(cell);
+        if (UNLIKELY(m_snapshot != 0))
+            recordSnapshotEdge(cell);
         if (Heap::testAndSetMarked(cell))
             return;
         if (cell->structure() && cell->structure()->typeInfo().type() >= CompoundType)
@@ -35,11 +35,13 @@ class Terminator {
 public:
     Terminator() : m_shouldTerminate(false) { }
 
+    // May be called from another thread, such as the Watchdog's.
     void terminateSoon() { m_shouldTerminate = true; }
     bool shouldTerminate() const { return m_shouldTerminate; }
+    void reset() { m_shouldTerminate = false; }
 
 private:
-    bool m_shouldTerminate;
+    volatile bool m_shouldTerminate;
 };
 
 } // namespace JSC
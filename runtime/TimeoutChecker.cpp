@@ -33,6 +33,8 @@
 
 #include "CallFrame.h"
 #include "JSGlobalObject.h"
+#include "SamplingProfiler.h"
+#include "Watchdog.h"
 
 #if OS(DARWIN)
 #include <mach/mach.h>
@@ -123,7 +125,7 @@ void TimeoutChecker::reset()
     m_timeExecuting = 0;
 }
 
-bool TimeoutChecker::didTimeOut(ExecState* exec)
+bool TimeoutChecker::didTimeOut(ExecState* exec, const TimeoutCheckSite& site)
 {
     unsigned currentTime = getCPUTime();
     
@@ -140,10 +142,28 @@ bool TimeoutChecker::didTimeOut(ExecState* exec)
     
     m_timeExecuting += timeDiff;
     m_timeAtLastCheck = currentTime;
+
+    // While a sampling profile is running, every check doubles as a sample and
+    // the checks are spaced by the sampling interval instead.
+    unsigned interval = intervalBetweenChecks;
+    if (SamplingProfiler* samplingProfiler = exec->globalData().samplingProfiler) {
+        samplingProfiler->takeSample(exec, timeDiff, site);
+        interval = samplingProfiler->samplingInterval();
+    }
+
+    // An armed watchdog only sets the Terminator; check often enough that it
+    // is noticed within a tenth of the limit.
+    if (Watchdog* watchdog = exec->globalData().watchdog) {
+        if (watchdog->isArmed()) {
+            unsigned watchdogInterval = watchdog->timeLimit() / 10 ? watchdog->timeLimit() / 10 : 1;
+            if (watchdogInterval < interval)
+                interval = watchdogInterval;
+        }
+    }
     
     // Adjust the tick threshold so we get the next checkTimeout call in the
-    // interval specified in intervalBetweenChecks.
-    m_ticksUntilNextCheck = static_cast<unsigned>((static_cast<float>(intervalBetweenChecks) / timeDiff) * m_ticksUntilNextCheck);
+    // interval chosen above.
+    m_ticksUntilNextCheck = static_cast<unsigned>((static_cast<float>(interval) / timeDiff) * m_ticksUntilNextCheck);
     // If the new threshold is 0 reset it to the default threshold. This can happen if the timeDiff is higher than the
     // preferred script check time interval.
     if (m_ticksUntilNextCheck == 0)
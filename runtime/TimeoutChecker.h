@@ -35,6 +35,29 @@ namespace JSC {
 
     class ExecState;
 
+    // Where a check was made, so that a running sampling profile can attribute its
+    // sample to an opcode and to the tier running it. The interpreter and the JIT's
+    // timeout check stub fill this in; other callers leave it unknown.
+    struct TimeoutCheckSite {
+        TimeoutCheckSite()
+            : bytecodeOffset(0)
+            , isKnown(false)
+            , inInterpreter(false)
+        {
+        }
+
+        TimeoutCheckSite(unsigned bytecodeOffset, bool inInterpreter)
+            : bytecodeOffset(bytecodeOffset)
+            , isKnown(true)
+            , inInterpreter(inInterpreter)
+        {
+        }
+
+        unsigned bytecodeOffset; // In the CodeBlock of the ExecState passed to didTimeOut.
+        bool isKnown;
+        bool inInterpreter;
+    };
+
     class TimeoutChecker {
     public:
         TimeoutChecker();
@@ -59,7 +82,7 @@ namespace JSC {
 
         void reset();
 
-        bool didTimeOut(ExecState*);
+        bool didTimeOut(ExecState*, const TimeoutCheckSite& = TimeoutCheckSite());
 
     private:
         unsigned m_timeoutInterval;
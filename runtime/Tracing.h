@@ -26,18 +26,92 @@
 #ifndef Tracing_h
 #define Tracing_h
 
+// The probes, and their arguments:
+// gc_heap_size(bytesBefore, bytesAfter): fired by each collection, just before gc_end.
+// gc_phase_begin(phase, bytes), gc_phase_end(phase, bytes): phase is a GCPhase, and bytes
+//     is what has been allocated since the last collection.
+// jit_compile_begin(codeBlock, tier), jit_compile_end(codeBlock, tier, codeBytes): tier is 0
+//     for the baseline JIT and 1 for the DFG JIT. codeBytes is 0 if the DFG gave up.
+// osr_entry(codeBlock, bytecodeIndex), osr_exit(codeBlock, bytecodeIndex): codeBlock is the
+//     optimized code block. Exits are only reported from code compiled while the probe was on.
+// regexp_compile_begin(pattern), regexp_compile_end(pattern, isJIT): pattern is UTF-8.
+// executable_pool_grow(bytes): JIT code memory was reserved or committed.
+
 #if HAVE(DTRACE)
 #include "TracingDtrace.h"
 #else
 
-#define JAVASCRIPTCORE_GC_BEGIN()
-#define JAVASCRIPTCORE_GC_BEGIN_ENABLED() 0
+#include <wtf/AlwaysInline.h>
+
+namespace JSC {
+
+// Without DTrace, the probes call the embedder's trace callback, if there is one. See
+// JSSetTraceCallback() in JSSettingsEA.h, whose events match these.
+enum TraceEvent {
+    TraceGCBegin,
+    TraceGCMarked,
+    TraceGCEnd,
+    TraceGCHeapSize,
+    TraceGCPhaseBegin,
+    TraceGCPhaseEnd,
+    TraceJITCompileBegin,
+    TraceJITCompileEnd,
+    TraceOSREntry,
+    TraceOSRExit,
+    TraceRegExpCompileBegin,
+    TraceRegExpCompileEnd,
+    TraceExecutablePoolGrow
+};
+
+typedef void (*TraceCallback)(TraceEvent, const void* subject, size_t arg0, size_t arg1);
+extern TraceCallback traceCallback;
+
+inline void trace(TraceEvent event, const void* subject, size_t arg0, size_t arg1)
+{
+    if (UNLIKELY(traceCallback != 0))
+        traceCallback(event, subject, arg0, arg1);
+}
+
+} // namespace JSC
+
+#define JAVASCRIPTCORE_GC_BEGIN() JSC::trace(JSC::TraceGCBegin, 0, 0, 0)
+#define JAVASCRIPTCORE_GC_BEGIN_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_GC_END() JSC::trace(JSC::TraceGCEnd, 0, 0, 0)
+#define JAVASCRIPTCORE_GC_END_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_GC_MARKED() JSC::trace(JSC::TraceGCMarked, 0, 0, 0)
+#define JAVASCRIPTCORE_GC_MARKED_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_GC_HEAP_SIZE(arg0, arg1) JSC::trace(JSC::TraceGCHeapSize, 0, arg0, arg1)
+#define JAVASCRIPTCORE_GC_HEAP_SIZE_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_GC_PHASE_BEGIN(arg0, arg1) JSC::trace(JSC::TraceGCPhaseBegin, 0, arg0, arg1)
+#define JAVASCRIPTCORE_GC_PHASE_BEGIN_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_GC_PHASE_END(arg0, arg1) JSC::trace(JSC::TraceGCPhaseEnd, 0, arg0, arg1)
+#define JAVASCRIPTCORE_GC_PHASE_END_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_JIT_COMPILE_BEGIN(arg0, arg1) JSC::trace(JSC::TraceJITCompileBegin, arg0, arg1, 0)
+#define JAVASCRIPTCORE_JIT_COMPILE_BEGIN_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_JIT_COMPILE_END(arg0, arg1, arg2) JSC::trace(JSC::TraceJITCompileEnd, arg0, arg1, arg2)
+#define JAVASCRIPTCORE_JIT_COMPILE_END_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_OSR_ENTRY(arg0, arg1) JSC::trace(JSC::TraceOSREntry, arg0, arg1, 0)
+#define JAVASCRIPTCORE_OSR_ENTRY_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_OSR_EXIT(arg0, arg1) JSC::trace(JSC::TraceOSRExit, arg0, arg1, 0)
+#define JAVASCRIPTCORE_OSR_EXIT_ENABLED() (!!JSC::traceCallback)
+
+#define JAVASCRIPTCORE_REGEXP_COMPILE_BEGIN(arg0) JSC::trace(JSC::TraceRegExpCompileBegin, arg0, 0, 0)
+#define JAVASCRIPTCORE_REGEXP_COMPILE_BEGIN_ENABLED() (!!JSC::traceCallback)
 
-#define JAVASCRIPTCORE_GC_END()
-#define JAVASCRIPTCORE_GC_END_ENABLED() 0
+#define JAVASCRIPTCORE_REGEXP_COMPILE_END(arg0, arg1) JSC::trace(JSC::TraceRegExpCompileEnd, arg0, arg1, 0)
+#define JAVASCRIPTCORE_REGEXP_COMPILE_END_ENABLED() (!!JSC::traceCallback)
 
-#define JAVASCRIPTCORE_GC_MARKED()
-#define JAVASCRIPTCORE_GC_MARKED_ENABLED() 0
+#define JAVASCRIPTCORE_EXECUTABLE_POOL_GROW(arg0) JSC::trace(JSC::TraceExecutablePoolGrow, 0, arg0, 0)
+#define JAVASCRIPTCORE_EXECUTABLE_POOL_GROW_ENABLED() (!!JSC::traceCallback)
 
 #define JAVASCRIPTCORE_PROFILE_WILL_EXECUTE(arg0, arg1, arg2, arg3)
 #define JAVASCRIPTCORE_PROFILE_WILL_EXECUTE_ENABLED() 0
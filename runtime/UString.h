@@ -178,6 +178,10 @@ inline bool operator==(const char *s1, const UString& s2)
     return operator==(s2, s1);
 }
 
+// Lets HashTable rehashing, which swaps entries that need destruction, move UStrings without ref
+// count churn instead of copying them through std::swap.
+inline void swap(UString& a, UString& b) { a.swap(b); }
+
 inline bool operator!=(const char *s1, const UString& s2)
 {
     return !JSC::operator==(s1, s2);
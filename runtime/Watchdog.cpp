@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "Watchdog.h"
+
+#include "JSGlobalData.h"
+#include <wtf/CurrentTime.h>
+
+namespace JSC {
+
+Watchdog::Watchdog(JSGlobalData* globalData)
+    : m_globalData(globalData)
+    , m_timeLimit(0)
+    , m_entryCount(0)
+    , m_thread(0)
+    , m_deadline(0)
+    , m_didTerminate(false)
+    , m_shouldExit(false)
+{
+}
+
+Watchdog::~Watchdog()
+{
+    if (!m_thread)
+        return;
+
+    {
+        MutexLocker locker(m_lock);
+        m_shouldExit = true;
+        m_condition.signal();
+    }
+    waitForThreadCompletion(m_thread, 0);
+}
+
+void Watchdog::setTimeLimit(unsigned timeLimit)
+{
+    MutexLocker locker(m_lock);
+    m_timeLimit = timeLimit;
+    if (!timeLimit) {
+        m_deadline = 0;
+        return;
+    }
+
+    if (!m_thread)
+        m_thread = createThread(threadEntryPoint, this, "JavaScriptCore::Watchdog");
+    if (m_entryCount)
+        m_deadline = currentTime() + timeLimit / 1000.0;
+    m_condition.signal();
+}
+
+void Watchdog::willEnterVM()
+{
+    if (m_entryCount++ || !m_timeLimit)
+        return;
+
+    MutexLocker locker(m_lock);
+    m_deadline = currentTime() + m_timeLimit / 1000.0;
+    m_condition.signal();
+}
+
+void Watchdog::didExitVM()
+{
+    ASSERT(m_entryCount);
+    if (--m_entryCount || !m_thread)
+        return;
+
+    // The script the limit applied to is gone, so a termination requested on
+    // its behalf must not leak into the next entry.
+    MutexLocker locker(m_lock);
+    m_deadline = 0;
+    if (m_didTerminate) {
+        m_globalData->terminator.reset();
+        m_didTerminate = false;
+    }
+}
+
+void* Watchdog::threadEntryPoint(void* watchdog)
+{
+    static_cast<Watchdog*>(watchdog)->run();
+    return 0;
+}
+
+void Watchdog::run()
+{
+    MutexLocker locker(m_lock);
+    while (!m_shouldExit) {
+        if (!m_deadline) {
+            m_condition.wait(m_lock);
+            continue;
+        }
+
+        if (currentTime() < m_deadline) {
+            m_condition.timedWait(m_lock, m_deadline);
+            continue;
+        }
+
+        m_globalData->terminator.terminateSoon();
+        m_didTerminate = true;
+        m_deadline = 0;
+    }
+}
+
+} // namespace JSC
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef Watchdog_h
+#define Watchdog_h
+
+#include <wtf/Noncopyable.h>
+#include <wtf/Threading.h>
+
+namespace JSC {
+
+    class JSGlobalData;
+
+    // Enforces an execution time limit on each entry into a JSGlobalData from
+    // the API. A thread of its own sleeps until the deadline and then asks the
+    // Terminator to stop script, which the script thread notices at its next
+    // TimeoutChecker check, so nothing is added to the JIT's loop back edges.
+    // Entering and leaving only take the lock while a limit is set.
+    class Watchdog {
+        WTF_MAKE_NONCOPYABLE(Watchdog); WTF_MAKE_FAST_ALLOCATED;
+    public:
+        explicit Watchdog(JSGlobalData*);
+        ~Watchdog();
+
+        // In milliseconds; 0 means no limit.
+        void setTimeLimit(unsigned);
+        unsigned timeLimit() const { return m_timeLimit; }
+        bool isArmed() const { return m_entryCount && m_timeLimit; }
+
+        void willEnterVM();
+        void didExitVM();
+
+    private:
+        static void* threadEntryPoint(void*);
+        void run();
+
+        JSGlobalData* m_globalData;
+        unsigned m_timeLimit;
+        unsigned m_entryCount;
+
+        Mutex m_lock;
+        ThreadCondition m_condition;
+        ThreadIdentifier m_thread;
+        // These are guarded by m_lock.
+        double m_deadline;
+        bool m_didTerminate;
+        bool m_shouldExit;
+    };
+
+} // namespace JSC
+
+#endif // Watchdog_h
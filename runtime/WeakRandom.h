@@ -73,6 +73,10 @@ public:
         return advance();
     }
 
+    // The Math.random thunk steps the generator in JIT code.
+    static size_t offsetOfLow() { return OBJECT_OFFSETOF(WeakRandom, m_low); }
+    static size_t offsetOfHigh() { return OBJECT_OFFSETOF(WeakRandom, m_high); }
+
 private:
     unsigned advance()
     {
@@ -25,6 +25,8 @@
 #include "InitializeThreading.h"
 #include "JSGlobalObject.h"
 #include "UStringBuilder.h"
+#include "yarr/Yarr.h"
+#include "yarr/YarrJIT.h"
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -60,11 +62,13 @@ struct Options {
     Options()
         : interactive(false)
         , verbose(false)
+        , benchmarkIterations(0)
     {
     }
 
     bool interactive;
     bool verbose;
+    unsigned benchmarkIterations;
     Vector<UString> arguments;
     Vector<UString> files;
 };
@@ -244,6 +248,85 @@ static bool testOneRegExp(JSGlobalData& globalData, RegExp* regexp, RegExpTest*
     return result;
 }
 
+// Times one pattern under the interpreter and, where available, the JIT. Each test line gets one
+// tab-separated "bench" line on stdout: the pattern's line, the test's line, the compile time
+// and nanoseconds per match of each engine, and whether the JIT fell back. Times are -1 where
+// an engine did not run.
+class RegExpBenchmark {
+public:
+    RegExpBenchmark(JSGlobalData& globalData, RegExp* regexp, unsigned regExpLineNumber)
+        : m_regExpLineNumber(regExpLineNumber)
+        , m_interpreterCompileNS(-1)
+        , m_jitCompileNS(-1)
+        , m_jitFellBack(false)
+    {
+        const char* error = 0;
+        double start = currentTime();
+        Yarr::YarrPattern interpreterPattern(regexp->pattern(), regexp->ignoreCase(), regexp->multiline(), &error);
+        if (error)
+            return;
+        m_bytecode = Yarr::byteCompile(interpreterPattern, &globalData.m_regExpAllocator);
+        m_interpreterCompileNS = (currentTime() - start) * 1e9;
+
+#if ENABLE(YARR_JIT)
+        if (!globalData.canUseJIT())
+            return;
+        start = currentTime();
+        Yarr::YarrPattern jitPattern(regexp->pattern(), regexp->ignoreCase(), regexp->multiline(), &error);
+        if (jitPattern.m_containsBackreferences)
+            m_jitFellBack = true;
+        else {
+            Yarr::jitCompile(jitPattern, Yarr::Char16, &globalData, m_jitCode);
+            m_jitFellBack = m_jitCode.isFallBack();
+        }
+        if (!m_jitFellBack)
+            m_jitCompileNS = (currentTime() - start) * 1e9;
+#endif
+    }
+
+    static void printHeader()
+    {
+        printf("bench\tregexpLine\ttestLine\tinterpreterCompileNS\tinterpreterMatchNS\tjitCompileNS\tjitMatchNS\tjitFellBack\n");
+    }
+
+    void run(RegExpTest* regExpTest, unsigned lineNumber, unsigned iterations)
+    {
+        double interpreterMatchNS = -1;
+        double jitMatchNS = -1;
+        Vector<int, 32> ovector;
+        ovector.resize(regExpTest->expectVector.size() ? regExpTest->expectVector.size() : 2);
+
+        if (m_bytecode) {
+            double start = currentTime();
+            for (unsigned i = 0; i < iterations; ++i)
+                Yarr::interpret(m_bytecode.get(), regExpTest->subject, regExpTest->offset, regExpTest->subject.length(), ovector.data());
+            interpreterMatchNS = (currentTime() - start) * 1e9 / iterations;
+        }
+
+#if ENABLE(YARR_JIT)
+        if (m_jitCompileNS >= 0) {
+            double start = currentTime();
+            for (unsigned i = 0; i < iterations; ++i)
+                Yarr::execute(m_jitCode, regExpTest->subject.characters(), regExpTest->offset, regExpTest->subject.length(), ovector.data());
+            jitMatchNS = (currentTime() - start) * 1e9 / iterations;
+        }
+#endif
+
+        printf("bench\t%u\t%u\t%.0f\t%.1f\t%.0f\t%.1f\t%d\n", m_regExpLineNumber, lineNumber,
+            m_interpreterCompileNS, interpreterMatchNS, m_jitCompileNS, jitMatchNS, m_jitFellBack);
+    }
+
+private:
+    unsigned m_regExpLineNumber;
+    OwnPtr<Yarr::BytecodePattern> m_bytecode;
+#if ENABLE(YARR_JIT)
+    Yarr::YarrCodeBlock m_jitCode;
+#endif
+    double m_interpreterCompileNS;
+    double m_jitCompileNS;
+    bool m_jitFellBack;
+};
+
 static int scanString(char* buffer, int bufferLength, UStringBuilder& builder, char termChar)
 {
     bool escape = false;
@@ -399,7 +482,7 @@ static RegExpTest* parseTestLine(char* line, int lineLength)
     return result;
 }
 
-static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& files, bool verbose)
+static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& files, bool verbose, unsigned benchmarkIterations)
 {
     UString script;
     UString fileName;
@@ -410,6 +493,9 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
 
     JSGlobalData& globalData = globalObject->globalData();
 
+    if (benchmarkIterations)
+        RegExpBenchmark::printHeader();
+
     bool success = true;
     for (size_t i = 0; i < files.size(); i++) {
         FILE* testCasesFile = fopen(files[i].utf8().data(), "rb");
@@ -420,6 +506,7 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
         }
             
         RegExp* regexp = 0;
+        OwnPtr<RegExpBenchmark> benchmark;
         size_t lineLength = 0;
         char* linePtr = 0;
         unsigned int lineNumber = 0;
@@ -437,6 +524,10 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
 
             if (linePtr[0] == '/') {
                 regexp = parseRegExpLine(globalData, linePtr, lineLength);
+                if (regexp && benchmarkIterations)
+                    benchmark = adoptPtr(new RegExpBenchmark(globalData, regexp, lineNumber));
+                else
+                    benchmark.clear();
             } else if (linePtr[0] == ' ') {
                 RegExpTest* regExpTest = parseTestLine(linePtr, lineLength);
                 
@@ -446,6 +537,8 @@ static bool runFromFiles(GlobalObject* globalObject, const Vector<UString>& file
                         failures++;
                         printf("Failure on line %u\n", lineNumber);
                     }
+                    if (benchmark)
+                        benchmark->run(regExpTest, lineNumber, benchmarkIterations);
                 }
                 
                 if (regExpTest)
@@ -477,6 +570,7 @@ static NO_RETURN void printUsageStatement(JSGlobalData* globalData, bool help =
     fprintf(stderr, "Usage: regexp_test [options] file\n");
     fprintf(stderr, "  -h|--help  Prints this help message\n");
     fprintf(stderr, "  -v|--verbose  Verbose output\n");
+    fprintf(stderr, "  -b|--benchmark <n>  Also time each test <n> times under the interpreter and the JIT\n");
 
     cleanupGlobalData(globalData);
     exit(help ? EXIT_SUCCESS : EXIT_FAILURE);
@@ -491,7 +585,10 @@ static void parseArguments(int argc, char** argv, Options& options, JSGlobalData
             printUsageStatement(globalData, true);
         if (!strcmp(arg, "-v") || !strcmp(arg, "--verbose"))
             options.verbose = true;
-        else
+        else if (!strcmp(arg, "-b") || !strcmp(arg, "--benchmark")) {
+            if (++i == argc || !(options.benchmarkIterations = strtoul(argv[i], 0, 10)))
+                printUsageStatement(globalData);
+        } else
             options.files.append(argv[i]);
     }
 
@@ -507,7 +604,7 @@ int realMain(int argc, char** argv, JSGlobalData* globalData)
     parseArguments(argc, argv, options, globalData);
 
     GlobalObject* globalObject = GlobalObject::create(*globalData, GlobalObject::createStructure(*globalData, jsNull()), options.arguments);
-    bool success = runFromFiles(globalObject, options.files, options.verbose);
+    bool success = runFromFiles(globalObject, options.files, options.verbose, options.benchmarkIterations);
 
     return success ? 0 : 3;
 }
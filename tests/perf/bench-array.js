@@ -0,0 +1,15 @@
+(function () {
+    var sum = 0;
+    for (var j = 0; j < 50; ++j) {
+        var array = [];
+        for (var i = 0; i < 10000; ++i)
+            array.push(i);
+        for (var i = 0; i < array.length; ++i)
+            array[i] = array[i] * 2;
+        array.reverse();
+        sum += array.slice(100, 200).length + array.indexOf(5000);
+        while (array.length)
+            sum += array.pop();
+    }
+    return sum;
+})();
@@ -0,0 +1,17 @@
+(function () {
+    function add(a, b) {
+        return a + b;
+    }
+
+    var receiver = {
+        value: 1,
+        get: function () { return this.value; }
+    };
+
+    var sum = 0;
+    for (var i = 0; i < 1000000; ++i) {
+        sum = add(sum, i);
+        sum += receiver.get();
+    }
+    return sum;
+})();
@@ -0,0 +1,16 @@
+(function () {
+    function makeCounter(start) {
+        var count = start;
+        return function () {
+            return ++count;
+        };
+    }
+
+    var sum = 0;
+    for (var i = 0; i < 20000; ++i) {
+        var counter = makeCounter(i);
+        for (var j = 0; j < 20; ++j)
+            sum += counter();
+    }
+    return sum;
+})();
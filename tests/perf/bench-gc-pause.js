@@ -0,0 +1,14 @@
+(function () {
+    // Keeps a large tree alive while allocating garbage, so that each collection marks the
+    // retained heap; in benchmark mode jsc reports the mark time and the longest mark.
+    function makeTree(depth) {
+        if (!depth)
+            return { value: 0 };
+        return { left: makeTree(depth - 1), right: makeTree(depth - 1) };
+    }
+
+    var retained = makeTree(16);
+    for (var i = 0; i < 200000; ++i)
+        var garbage = [i, { i: i }, "s" + i];
+    return retained.left ? 1 : 0;
+})();
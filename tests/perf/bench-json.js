@@ -0,0 +1,13 @@
+(function () {
+    var records = [];
+    for (var i = 0; i < 1000; ++i)
+        records.push({ id: i, name: "item" + i, price: i * 1.5, tags: ["a", "b", "c"], available: !!(i % 2) });
+
+    var total = 0;
+    for (var j = 0; j < 20; ++j) {
+        var text = JSON.stringify(records);
+        var parsed = JSON.parse(text);
+        total += parsed.length + text.length;
+    }
+    return total;
+})();
@@ -0,0 +1,17 @@
+(function () {
+    // More shapes at one access site than any inline cache holds.
+    var objects = [];
+    for (var i = 0; i < 1000; ++i) {
+        var object = {};
+        object["p" + (i % 64)] = 0;
+        object.x = i;
+        objects.push(object);
+    }
+
+    var sum = 0;
+    for (var j = 0; j < 500; ++j) {
+        for (var i = 0; i < objects.length; ++i)
+            sum += objects[i].x;
+    }
+    return sum;
+})();
@@ -0,0 +1,17 @@
+(function () {
+    function Point(x, y) {
+        this.x = x;
+        this.y = y;
+    }
+
+    var points = [];
+    for (var i = 0; i < 1000; ++i)
+        points.push(new Point(i, i + 1));
+
+    var sum = 0;
+    for (var j = 0; j < 1000; ++j) {
+        for (var i = 0; i < points.length; ++i)
+            sum += points[i].x + points[i].y;
+    }
+    return sum;
+})();
@@ -0,0 +1,19 @@
+(function () {
+    // Four shapes at one access site, as seen by inline caches that hold a short list of structures.
+    var objects = [];
+    for (var i = 0; i < 1000; ++i) {
+        switch (i % 4) {
+        case 0: objects.push({ x: i }); break;
+        case 1: objects.push({ a: 0, x: i }); break;
+        case 2: objects.push({ a: 0, b: 0, x: i }); break;
+        case 3: objects.push({ a: 0, b: 0, c: 0, x: i }); break;
+        }
+    }
+
+    var sum = 0;
+    for (var j = 0; j < 1000; ++j) {
+        for (var i = 0; i < objects.length; ++i)
+            sum += objects[i].x;
+    }
+    return sum;
+})();
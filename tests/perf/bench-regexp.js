@@ -0,0 +1,18 @@
+(function () {
+    var lines = [];
+    for (var i = 0; i < 1000; ++i)
+        lines.push("user" + i + "@example" + (i % 10) + ".com visited /page/" + i + "?q=" + (i * 7));
+
+    var email = /^([a-z0-9]+)@([a-z0-9]+)\.com/;
+    var number = /\d+/g;
+    var matches = 0;
+    for (var j = 0; j < 20; ++j) {
+        for (var i = 0; i < lines.length; ++i) {
+            if (email.test(lines[i]))
+                ++matches;
+            matches += lines[i].match(number).length;
+            matches += lines[i].replace(/\//g, "-").length;
+        }
+    }
+    return matches;
+})();
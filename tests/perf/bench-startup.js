@@ -0,0 +1,18 @@
+// Measures parsing and running top-level code, as a page's first script does: each run
+// evaluates the whole file afresh, so declaring many functions is most of the work.
+var startupTable = {};
+function startup0(a) { return a + 0; }
+function startup1(a) { return a * 1; }
+function startup2(a) { return [a, 2]; }
+function startup3(a) { return { value: a, index: 3 }; }
+function startup4(a) { return "" + a + 4; }
+function startup5(a) { var b = a; for (var i = 0; i < 5; ++i) b += i; return b; }
+function startup6(a) { return typeof a == "number" ? a : 6; }
+function startup7(a) { try { return a.x; } catch (e) { return 7; } }
+(function () {
+    var functions = [startup0, startup1, startup2, startup3, startup4, startup5, startup6, startup7];
+    for (var i = 0; i < functions.length; ++i)
+        startupTable["f" + i] = functions[i](i);
+    for (var i = 0; i < 200; ++i)
+        startupTable["g" + i] = new Function("a", "return a + " + i + ";")(i);
+})();
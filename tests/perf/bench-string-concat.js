@@ -0,0 +1,11 @@
+(function () {
+    // Builds ropes by repeated concatenation, then flattens them by reading characters.
+    var length = 0;
+    for (var j = 0; j < 100; ++j) {
+        var string = "";
+        for (var i = 0; i < 2000; ++i)
+            string += "item" + i + ",";
+        length += string.charCodeAt(string.length - 1) + string.split(",").length;
+    }
+    return length;
+})();
@@ -0,0 +1,9 @@
+(function () {
+    var text = "The quick brown fox jumps over the lazy dog. ";
+    var count = 0;
+    for (var i = 0; i < 100000; ++i) {
+        count += text.indexOf("lazy") + text.substring(4, 9).length;
+        count += text.toUpperCase().charCodeAt(i % text.length);
+    }
+    return count;
+})();
@@ -0,0 +1,195 @@
+#!/usr/bin/perl -w
+
+# Copyright (C) 2011 Apple Inc. All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+# EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+# PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+# CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+# EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+# PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+# PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+# OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Compares two jsc builds on the benchmarks in this directory, and on any
+# directories of self-contained SunSpider or V8 style scripts given with
+# --suite. Each sample is the median of one jsc --bench process, and the two
+# builds' processes are interleaved, alternating which goes first, so that
+# drift in the machine's state hits both alike. A difference is reported as
+# significant when the 95% confidence interval of the difference of the means
+# (Welch's t-test) excludes zero and the change exceeds --threshold.
+#
+# With --heap-watermark, the GC benchmarks run again at each of the given
+# watermarks, in KB, and the collection counts and mark times are reported
+# alongside the times. The heap doesn't accept watermarks under 512KB.
+#
+# The exit status is 1 when the candidate build has a significant regression.
+
+use strict;
+use File::Basename;
+use Getopt::Long;
+
+my $runs = 10;
+my $iterations = 5;
+my $warmUp = 3;
+my $threshold = 1;
+my @suites = ();
+my @watermarks = ();
+my $help = 0;
+
+my $usage = <<EOF;
+Usage: $0 [options] baseline-jsc candidate-jsc [benchmark.js ...]
+  --runs N             Processes per build and benchmark (default $runs)
+  --bench N            Timed runs in each process (default $iterations)
+  --warmup N           Untimed runs in each process (default $warmUp)
+  --threshold PERCENT  Smallest change reported as significant (default $threshold)
+  --suite DIR          Also runs every .js file in DIR; may be repeated
+  --heap-watermark KB  Runs the GC benchmarks at this watermark; may be repeated
+EOF
+
+GetOptions("runs=i" => \$runs,
+           "bench=i" => \$iterations,
+           "warmup=i" => \$warmUp,
+           "threshold=f" => \$threshold,
+           "suite=s" => \@suites,
+           "heap-watermark=i" => \@watermarks,
+           "help" => \$help) or die $usage;
+die $usage if $help || @ARGV < 2 || $runs < 2 || $iterations < 1;
+
+my ($baseline, $candidate, @benchmarks) = @ARGV;
+my $perfDirectory = dirname($0);
+if (!@benchmarks) {
+    @benchmarks = sort glob("$perfDirectory/bench-*.js");
+    push @benchmarks, sort glob("$_/*.js") foreach @suites;
+}
+my @gcBenchmarks = grep { m/bench-(gc|allocate)-/ } @benchmarks;
+
+my $regressions = 0;
+$regressions += compare("default heap", [], @benchmarks);
+foreach my $watermark (@watermarks) {
+    $regressions += compare("heap watermark ${watermark}KB", ["--heap-watermark", $watermark], @gcBenchmarks);
+}
+exit($regressions ? 1 : 0);
+
+# Runs one jsc process and returns the fields of the JSON line it prints.
+sub runBenchmark
+{
+    my ($jsc, $options, $benchmark) = @_;
+    my @command = ($jsc, @$options, "--bench", $iterations, "--warmup", $warmUp, $benchmark);
+    open(my $output, "-|", @command) or die "Couldn't run @command: $!\n";
+    my %result;
+    while (<$output>) {
+        next unless m/^\{"benchmark": /;
+        while (m/"(\w+)": ([-\d.]+)/g) {
+            $result{$1} = $2;
+        }
+    }
+    close($output);
+    die "@command didn't print benchmark results\n" unless defined $result{medianMS};
+    return \%result;
+}
+
+sub mean
+{
+    my $total = 0;
+    $total += $_ foreach @_;
+    return $total / @_;
+}
+
+sub variance
+{
+    my $mean = mean(@_);
+    my $squaredDeviations = 0;
+    $squaredDeviations += ($_ - $mean) ** 2 foreach @_;
+    return $squaredDeviations / (@_ - 1);
+}
+
+# Two-sided 95% critical values of Student's t, rounding the degrees of
+# freedom down to the nearest entry so the interval errs on the wide side.
+sub tCritical
+{
+    my ($degreesOfFreedom) = @_;
+    my @table = ([1, 12.706], [2, 4.303], [3, 3.182], [4, 2.776], [5, 2.571],
+                 [6, 2.447], [7, 2.365], [8, 2.306], [9, 2.262], [10, 2.228],
+                 [12, 2.179], [15, 2.131], [20, 2.086], [30, 2.042], [60, 2.000],
+                 [120, 1.980]);
+    my $critical = $table[0][1];
+    foreach my $entry (@table) {
+        last if $entry->[0] > $degreesOfFreedom;
+        $critical = $entry->[1];
+    }
+    return $critical;
+}
+
+# Returns the difference of the means and the half width of its 95%
+# confidence interval.
+sub compareSamples
+{
+    my ($baselineSamples, $candidateSamples) = @_;
+    my $baselineError = variance(@$baselineSamples) / @$baselineSamples;
+    my $candidateError = variance(@$candidateSamples) / @$candidateSamples;
+    my $difference = mean(@$candidateSamples) - mean(@$baselineSamples);
+    my $standardError = sqrt($baselineError + $candidateError);
+    return ($difference, 0) unless $standardError;
+
+    my $degreesOfFreedom = ($baselineError + $candidateError) ** 2
+        / ($baselineError ** 2 / (@$baselineSamples - 1) + $candidateError ** 2 / (@$candidateSamples - 1));
+    return ($difference, tCritical($degreesOfFreedom) * $standardError);
+}
+
+sub compare
+{
+    my ($title, $options, @benchmarks) = @_;
+    return 0 unless @benchmarks;
+
+    my %samples;
+    for (my $run = 0; $run < $runs; ++$run) {
+        foreach my $benchmark (@benchmarks) {
+            # Indexed by build rather than path, so a build can be compared with itself.
+            my @order = $run % 2 ? (1, 0) : (0, 1);
+            foreach my $build (@order) {
+                push @{$samples{$benchmark}[$build]}, runBenchmark(($baseline, $candidate)[$build], $options, $benchmark);
+            }
+        }
+    }
+
+    print "\n$title: $runs processes per build, $iterations timed runs each\n";
+    printf("%-36s %12s %12s %20s\n", "benchmark", "baseline ms", "candidate ms", "change");
+    my $regressions = 0;
+    foreach my $benchmark (@benchmarks) {
+        my @baselineTimes = map { $_->{medianMS} } @{$samples{$benchmark}[0]};
+        my @candidateTimes = map { $_->{medianMS} } @{$samples{$benchmark}[1]};
+        my ($difference, $halfWidth) = compareSamples(\@baselineTimes, \@candidateTimes);
+        my $baselineMean = mean(@baselineTimes);
+        my $percent = $baselineMean ? 100 * $difference / $baselineMean : 0;
+        my $halfWidthPercent = $baselineMean ? 100 * $halfWidth / $baselineMean : 0;
+
+        my $verdict = "";
+        if (abs($difference) > $halfWidth && abs($percent) >= $threshold) {
+            $verdict = $difference > 0 ? "  REGRESSION" : "  improvement";
+            ++$regressions if $difference > 0;
+        }
+        printf("%-36s %12.3f %12.3f %+8.2f%% +-%6.2f%%%s\n", basename($benchmark),
+            $baselineMean, mean(@candidateTimes), $percent, $halfWidthPercent, $verdict);
+
+        next unless @$options;
+        foreach my $field ("collections", "gcMarkMS") {
+            my @baselineValues = map { $_->{$field} } @{$samples{$benchmark}[0]};
+            my @candidateValues = map { $_->{$field} } @{$samples{$benchmark}[1]};
+            printf("  %-34s %12.3f %12.3f\n", $field, mean(@baselineValues), mean(@candidateValues));
+        }
+    }
+    return $regressions;
+}
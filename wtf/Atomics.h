@@ -64,6 +64,10 @@
 
 #if OS(WINDOWS)
 #include <windows.h>
+//+EAWebKitChange
+#elif defined(EA_PLATFORM_MICROSOFT)
+#include EAWEBKIT_PLATFORM_HEADER
+//-EAWebKitChange
 #elif OS(DARWIN)
 #include <libkern/OSAtomic.h>
 #elif OS(QNX)
@@ -156,6 +160,75 @@ inline int atomicDecrement(int volatile* addend) { return __gnu_cxx::__exchange_
 
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+// Atomically replaces *location with newValue if it still holds expected.
+// This may fail spuriously, so callers must be prepared to retry.
+inline bool weakCompareAndSwap(unsigned* location, unsigned expected, unsigned newValue)
+{
+#if OS(WINDOWS) || defined(EA_PLATFORM_MICROSOFT)
+    return InterlockedCompareExchange(reinterpret_cast<LONG volatile*>(location), static_cast<LONG>(newValue), static_cast<LONG>(expected)) == static_cast<LONG>(expected);
+#else
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+#endif
+}
+
+inline bool weakCompareAndSwap(void* volatile* location, void* expected, void* newValue)
+{
+#if OS(WINDOWS) || defined(EA_PLATFORM_MICROSOFT)
+    return InterlockedCompareExchangePointer(location, newValue, expected) == expected;
+#else
+    return __sync_bool_compare_and_swap(location, expected, newValue);
+#endif
+}
+
+// Atomically adds delta to *location and returns the value it held before.
+inline int atomicExchangeAdd(int volatile* location, int delta)
+{
+#if OS(WINDOWS) || defined(EA_PLATFORM_MICROSOFT)
+    return InterlockedExchangeAdd(reinterpret_cast<LONG volatile*>(location), delta);
+#else
+    return __sync_fetch_and_add(location, delta);
+#endif
+}
+
+// A full fence: neither the compiler nor the processor moves loads or stores across it.
+inline void memoryBarrier()
+{
+#if OS(WINDOWS) || defined(EA_PLATFORM_MICROSOFT)
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+// A load that no later access moves ahead of, and a store that no earlier access moves past. Both
+// use a full fence, which is stronger than needed on x86 but correct on every processor we target.
+template<typename T> inline T loadAcquire(T volatile* location)
+{
+    T value = *location;
+    memoryBarrier();
+    return value;
+}
+
+template<typename T> inline void storeRelease(T volatile* location, T value)
+{
+    memoryBarrier();
+    *location = value;
+}
+
+// Replaces *location with update(*location), retrying the weak compare-and-swap until no other
+// thread has changed it in between, and returns the value it replaced. update must have no side
+// effects, since it may be called more than once.
+template<typename Functor> inline unsigned atomicUpdate(unsigned* location, Functor update)
+{
+    while (true) {
+        unsigned oldValue = *const_cast<unsigned volatile*>(location);
+        if (weakCompareAndSwap(location, oldValue, update(oldValue)))
+            return oldValue;
+    }
+}
+#endif
+
 } // namespace WTF
 
 #if USE(LOCKFREE_THREADSAFEREFCOUNTED)
@@ -163,4 +236,13 @@ using WTF::atomicDecrement;
 using WTF::atomicIncrement;
 #endif
 
+#if ENABLE(COMPARE_AND_SWAP)
+using WTF::atomicExchangeAdd;
+using WTF::atomicUpdate;
+using WTF::loadAcquire;
+using WTF::memoryBarrier;
+using WTF::storeRelease;
+using WTF::weakCompareAndSwap;
+#endif
+
 #endif // Atomics_h
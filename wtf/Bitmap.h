@@ -19,6 +19,7 @@
 #ifndef Bitmap_h
 #define Bitmap_h
 
+#include "Atomics.h"
 #include "FixedArray.h"
 #include "StdLibExtras.h"
 #include <stdint.h>
@@ -37,10 +38,12 @@ public:
     bool get(size_t) const;
     void set(size_t);
     bool testAndSet(size_t);
+    bool concurrentTestAndSet(size_t);
     bool testAndClear(size_t);
     size_t nextPossiblyUnset(size_t) const;
     void clear(size_t);
     void clearAll();
+    void merge(const Bitmap&);
     int64_t findRunOfZeros(size_t) const;
     size_t count(size_t = 0) const;
     size_t isEmpty() const;
@@ -88,6 +91,25 @@ inline bool Bitmap<size>::testAndSet(size_t n)
     return result;
 }
 
+template<size_t size>
+inline bool Bitmap<size>::concurrentTestAndSet(size_t n)
+{
+#if ENABLE(COMPARE_AND_SWAP)
+    WordType mask = one << (n % wordSize);
+    size_t index = n / wordSize;
+    volatile WordType* wordPtr = bits.data() + index;
+    WordType oldValue;
+    do {
+        oldValue = *wordPtr;
+        if (oldValue & mask)
+            return true;
+    } while (!weakCompareAndSwap(const_cast<WordType*>(wordPtr), oldValue, oldValue | mask));
+    return false;
+#else
+    return testAndSet(n);
+#endif
+}
+
 template<size_t size>
 inline bool Bitmap<size>::testAndClear(size_t n)
 {
@@ -110,6 +132,13 @@ inline void Bitmap<size>::clearAll()
     memset(bits.data(), 0, sizeof(bits));
 }
 
+template<size_t size>
+inline void Bitmap<size>::merge(const Bitmap& other)
+{
+    for (size_t i = 0; i < words; ++i)
+        bits[i] |= other.bits[i];
+}
+
 template<size_t size>
 inline size_t Bitmap<size>::nextPossiblyUnset(size_t start) const
 {
@@ -26,12 +26,16 @@
 #ifndef BumpPointerAllocator_h
 #define BumpPointerAllocator_h
 
+#include <algorithm>
 #include <wtf/PageAllocation.h>
 
 namespace WTF {
 
 #define MINIMUM_BUMP_POOL_SIZE 0x1000
 
+// The most memory, in addition to the initial pool, that stopAllocator() keeps for the next run.
+#define MAXIMUM_RETAINED_BUMP_POOL_SIZE 0x10000
+
 class BumpPointerPool {
 public:
     // ensureCapacity will check whether the current pool has capacity to
@@ -125,14 +129,25 @@ private:
         return 0;
     }
 
+    // Resets the chain, keeping the first few pools (up to MAXIMUM_RETAINED_BUMP_POOL_SIZE beyond
+    // this one) so that a client that overflowed the initial pool need not map new pages next time.
     void shrink()
     {
         ASSERT(!m_previous);
         m_current = m_start;
-        while (m_next) {
-            BumpPointerPool* nextNext = m_next->m_next;
-            m_next->destroy();
-            m_next = nextNext;
+
+        BumpPointerPool* lastRetained = this;
+        size_t retainedSize = 0;
+        while (lastRetained->m_next && retainedSize + lastRetained->m_next->m_allocation.size() <= MAXIMUM_RETAINED_BUMP_POOL_SIZE) {
+            lastRetained = lastRetained->m_next;
+            lastRetained->m_current = lastRetained->m_start;
+            retainedSize += lastRetained->m_allocation.size();
+        }
+
+        while (lastRetained->m_next) {
+            BumpPointerPool* nextNext = lastRetained->m_next->m_next;
+            lastRetained->m_next->destroy();
+            lastRetained->m_next = nextNext;
         }
     }
 
@@ -151,19 +166,25 @@ private:
 
         while (true) {
             if (!pool) {
-                // We've run to the end; allocate a new pool.
-                pool = BumpPointerPool::create(size);
+                // We've run to the end; allocate a new pool, at least twice the size of the
+                // last one so that a deep backtrack needs only a few of them.
+                pool = BumpPointerPool::create(std::max(size, previousPool->m_allocation.size()));
+                if (!pool)
+                    return 0;
                 previousPool->m_next = pool;
                 pool->m_previous = previousPool;
                 return pool;
             }
 
-            // 
+            // A pool further along the chain may be too small for this allocation.
             void* current = pool->m_current;
             void* allocationEnd = static_cast<char*>(current) + size;
             ASSERT(allocationEnd > current); // check for overflow
             if (allocationEnd <= static_cast<void*>(pool))
                 return pool;
+
+            previousPool = pool;
+            pool = pool->m_next;
         }
     }
 
@@ -222,8 +243,12 @@ public:
 
     ~BumpPointerAllocator()
     {
-        if (m_head)
-            m_head->destroy();
+        // Destroy the pools shrink() retained, then the initial one.
+        for (BumpPointerPool* pool = m_head; pool; ) {
+            BumpPointerPool* next = pool->m_next;
+            pool->destroy();
+            pool = next;
+        }
     }
 
     BumpPointerPool* startAllocator()
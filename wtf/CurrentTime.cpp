@@ -356,6 +356,32 @@ double monotonicallyIncreasingTime()
     return static_cast<double>(g_get_monotonic_time() / 1000000.0);
 }
 
+//+EAWebKitChange
+#elif PLATFORM(EA)
+
+static double (*monotonicTimeFunction)() = 0;
+
+void setMonotonicallyIncreasingTimeFunction(double (*function)())
+{
+    monotonicTimeFunction = function;
+}
+
+// Profiler and animation timing should not jump when the wall clock is adjusted, so prefer the
+// application's monotonic timer when one has been installed.
+double monotonicallyIncreasingTime()
+{
+    if (monotonicTimeFunction)
+        return monotonicTimeFunction();
+
+    static double lastTime = 0;
+    double currentTimeNow = currentTime();
+    if (currentTimeNow < lastTime)
+        return lastTime;
+    lastTime = currentTimeNow;
+    return currentTimeNow;
+}
+//-EAWebKitChange
+
 #else
 
 double monotonicallyIncreasingTime()
@@ -69,11 +69,22 @@ inline void getLocalTime(const time_t* localTime, struct tm* localTM)
 // On unsupported platforms, this function only guarantees the result will be non-decreasing.
 double monotonicallyIncreasingTime();
 
+//+EAWebKitChange
+#if PLATFORM(EA)
+// Installs a high-resolution monotonic timer (seconds) for monotonicallyIncreasingTime().
+// Without one, the result is the non-decreasing clamp of currentTime().
+void setMonotonicallyIncreasingTimeFunction(double (*)());
+#endif
+//-EAWebKitChange
+
 } // namespace WTF
 
 using WTF::currentTime;
 using WTF::currentTimeMS;
 using WTF::getLocalTime;
 using WTF::monotonicallyIncreasingTime;
+#if PLATFORM(EA)
+using WTF::setMonotonicallyIncreasingTimeFunction;
+#endif
 
 #endif // CurrentTime_h
@@ -219,6 +219,37 @@ static inline int msToWeekDay(double ms)
     return wd;
 }
 
+// Calendar fields of a time value, computed from its day number with integer arithmetic
+// (the days-to-civil conversion over 400-year eras). Exact across the whole ECMAScript time
+// range, plus a day either side for local-time adjustment; returns false outside it.
+static bool decomposeTimeValue(double ms, int& year, int& yearDay, int& month, int& monthDay, int& weekDay, int& msInDay)
+{
+    if (!(fabs(ms) <= maxECMAScriptTime + 2 * msPerDay))
+        return false;
+
+    double days = msToDays(ms);
+    msInDay = static_cast<int>(ms - days * msPerDay);
+    int daysFrom1970 = static_cast<int>(days);
+
+    weekDay = (daysFrom1970 + 4) % 7;
+    if (weekDay < 0)
+        weekDay += 7;
+
+    // Shift the epoch to 0000-03-01 so leap days fall at the end of each year.
+    int daysFromMarch0000 = daysFrom1970 + 719468;
+    int era = (daysFromMarch0000 >= 0 ? daysFromMarch0000 : daysFromMarch0000 - 146096) / 146097;
+    int dayOfEra = daysFromMarch0000 - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfMarchYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int marchMonth = (5 * dayOfMarchYear + 2) / 153;
+
+    monthDay = dayOfMarchYear - (153 * marchMonth + 2) / 5 + 1;
+    month = marchMonth < 10 ? marchMonth + 2 : marchMonth - 10;
+    year = yearOfEra + era * 400 + (month <= 1);
+    yearDay = month <= 1 ? dayOfMarchYear - 306 : dayOfMarchYear + 59 + isLeapYear(year);
+    return true;
+}
+
 static inline int msToSeconds(double ms)
 {
     double result = fmod(floor(ms / msPerSecond), secondsPerMinute);
@@ -1158,7 +1189,23 @@ void msToGregorianDateTime(ExecState* exec, double ms, bool outputIsUTC, Gregori
         ms += dstOff + utcOff;
     }
 
-    const int year = msToYear(ms);
+    int year, yearDay, month, monthDay, weekDay, msInDay;
+    if (decomposeTimeValue(ms, year, yearDay, month, monthDay, weekDay, msInDay)) {
+        tm.second   =  (msInDay / 1000) % 60;
+        tm.minute   =  (msInDay / (60 * 1000)) % 60;
+        tm.hour     =  msInDay / (60 * 60 * 1000);
+        tm.weekDay  =  weekDay;
+        tm.yearDay  =  yearDay;
+        tm.monthDay =  monthDay;
+        tm.month    =  month;
+        tm.year     =  year - 1900;
+        tm.isDST    =  dstOff != 0.0;
+        tm.utcOffset = static_cast<long>((dstOff + utcOff) / WTF::msPerSecond);
+        tm.timeZone = nullptr;
+        return;
+    }
+
+    year = msToYear(ms);
     tm.second   =  msToSeconds(ms);
     tm.minute   =  msToMinutes(ms);
     tm.hour     =  msToHours(ms);
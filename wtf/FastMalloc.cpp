@@ -246,6 +246,25 @@ TryMallocReturnValue tryFastZeroedMalloc(size_t n)
     return result;
 }
 
+static FastMallocTagHook s_fastMallocTagHook;
+
+void setFastMallocTagHook(FastMallocTagHook hook)
+{
+    s_fastMallocTagHook = hook;
+}
+
+FastMallocTagHook fastMallocTagHook()
+{
+    return s_fastMallocTagHook;
+}
+
+#if FORCE_SYSTEM_MALLOC
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t)
+{
+    return 0;
+}
+#endif
+
 } // namespace WTF
 
 //+EAWebKitChange
@@ -4395,6 +4414,23 @@ FastMallocStatistics fastMallocStatistics()
     return statistics;
 }
 
+size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics* sizeClasses, size_t capacity)
+{
+    // Size class 0 is reserved and never handed out.
+    size_t count = 0;
+    SpinLockHolder lockHolder(&pageheap_lock);
+    for (unsigned cl = 1; cl < kNumClasses && count < capacity; ++cl, ++count) {
+        FastMallocSizeClassStatistics& statistics = sizeClasses[count];
+        size_t objectSize = ByteSizeForClass(cl);
+        statistics.objectSize = objectSize;
+        statistics.centralFreeBytes = objectSize * (central_cache[cl].length() + central_cache[cl].tc_length());
+        statistics.threadCacheFreeBytes = 0;
+        for (TCMalloc_ThreadCache* threadCache = thread_heaps; threadCache; threadCache = threadCache->next_)
+            statistics.threadCacheFreeBytes += objectSize * threadCache->freelist_length(cl);
+    }
+    return kNumClasses - 1;
+}
+
 size_t fastMallocSize(const void* ptr)
 {
 #if ENABLE(WTF_MALLOC_VALIDATION)
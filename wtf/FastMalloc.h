@@ -94,6 +94,46 @@ namespace WTF {
     };
     FastMallocStatistics fastMallocStatistics();
 
+    struct FastMallocSizeClassStatistics {
+        size_t objectSize;
+        size_t centralFreeBytes; // Free objects in the central and transfer caches.
+        size_t threadCacheFreeBytes; // Free objects in every thread's cache; approximate, as those are read unlocked.
+    };
+    // Fills in up to capacity size classes, smallest first, and returns how many there are.
+    // Returns 0 when fastMalloc is backed by the system or an embedder's allocator.
+    size_t fastMallocSizeClassStatistics(FastMallocSizeClassStatistics*, size_t capacity);
+
+    // Lets an embedder's memory tracker attribute allocations to subsystems. The hook is
+    // called with entering true when a FastMallocTagScope begins on the current thread, and
+    // with the same tag and false when it ends. Scopes nest, and tags are string literals.
+    typedef void (*FastMallocTagHook)(const char* tag, bool entering);
+    void setFastMallocTagHook(FastMallocTagHook);
+    FastMallocTagHook fastMallocTagHook();
+
+    class FastMallocTagScope {
+    public:
+        explicit FastMallocTagScope(const char* tag)
+            : m_tag(tag)
+            , m_hook(fastMallocTagHook())
+        {
+            if (m_hook)
+                m_hook(m_tag, true);
+        }
+
+        ~FastMallocTagScope()
+        {
+            if (m_hook)
+                m_hook(m_tag, false);
+        }
+
+    private:
+        FastMallocTagScope(const FastMallocTagScope&);
+        FastMallocTagScope& operator=(const FastMallocTagScope&);
+
+        const char* m_tag;
+        FastMallocTagHook m_hook;
+    };
+
     // This defines a type which holds an unsigned integer and is the same
     // size as the minimally aligned memory allocation.
     typedef unsigned long long AllocAlignmentInteger;
@@ -233,6 +273,7 @@ using WTF::fastMalloc;
 using WTF::fastMallocAligned;
 //-EAWebKitChange
 using WTF::fastMallocSize;
+using WTF::FastMallocTagScope;
 using WTF::fastRealloc;
 using WTF::fastStrDup;
 using WTF::fastZeroedMalloc;
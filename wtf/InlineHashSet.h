@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WTF_InlineHashSet_h
+#define WTF_InlineHashSet_h
+
+#include "HashSet.h"
+#include "NotFound.h"
+
+namespace WTF {
+
+    // A set for values compared by ==, such as pointers, that usually holds only a few of them.
+    // Up to inlineCapacity values are kept in the object itself and found by a linear scan,
+    // which touches one or two cache lines and never allocates. Adding one more moves them all
+    // into a HashSet, which is used until the set is empty again.
+    template<typename Value, size_t inlineCapacity = 4, typename HashFunctions = typename DefaultHash<Value>::Hash>
+    class InlineHashSet {
+        WTF_MAKE_FAST_ALLOCATED;
+    public:
+        InlineHashSet()
+            : m_inlineSize(0)
+        {
+        }
+
+        size_t size() const { return m_set.isEmpty() ? m_inlineSize : m_set.size(); }
+        bool isEmpty() const { return !size(); }
+
+        bool contains(const Value& value) const
+        {
+            if (!m_set.isEmpty())
+                return m_set.contains(value);
+            return findInline(value) != notFound;
+        }
+
+        // Returns true if the value was not already in the set.
+        bool add(const Value& value)
+        {
+            if (!m_set.isEmpty())
+                return m_set.add(value).second;
+            if (findInline(value) != notFound)
+                return false;
+            if (m_inlineSize < inlineCapacity) {
+                m_inlineValues[m_inlineSize++] = value;
+                return true;
+            }
+            for (size_t i = 0; i < m_inlineSize; ++i)
+                m_set.add(m_inlineValues[i]);
+            m_inlineSize = 0;
+            return m_set.add(value).second;
+        }
+
+        void remove(const Value& value)
+        {
+            if (!m_set.isEmpty()) {
+                m_set.remove(value);
+                return;
+            }
+            size_t index = findInline(value);
+            if (index == notFound)
+                return;
+            m_inlineValues[index] = m_inlineValues[--m_inlineSize];
+        }
+
+        void clear()
+        {
+            m_set.clear();
+            m_inlineSize = 0;
+        }
+
+    private:
+        size_t findInline(const Value& value) const
+        {
+            for (size_t i = 0; i < m_inlineSize; ++i) {
+                if (m_inlineValues[i] == value)
+                    return i;
+            }
+            return notFound;
+        }
+
+        size_t m_inlineSize;
+        Value m_inlineValues[inlineCapacity];
+        HashSet<Value, HashFunctions> m_set;
+    };
+
+} // namespace WTF
+
+using WTF::InlineHashSet;
+
+#endif // WTF_InlineHashSet_h
@@ -90,6 +90,13 @@ static FunctionQueue& functionQueue()
     return staticFunctionQueue;
 }
 
+// Functions taken from functionQueue() in one go and not yet run. Only accessed from the main thread.
+static FunctionQueue& dispatchBatch()
+{
+    DEFINE_STATIC_LOCAL(FunctionQueue, staticDispatchBatch, ());
+    return staticDispatchBatch;
+}
+
 
 #if !PLATFORM(MAC)
 
@@ -150,14 +157,19 @@ void dispatchFunctionsFromMainThread()
 
     double startTime = currentTime();
 
+    // Take everything queued so far under one lock, so producers contend with the main thread once
+    // per batch rather than once per function. Functions left over when we yield stay at the front
+    // of the batch, ahead of anything queued since.
+    FunctionQueue& batch = dispatchBatch();
     FunctionWithContext invocation;
     while (true) {
-        {
+        if (batch.isEmpty()) {
             MutexLocker locker(mainThreadFunctionQueueMutex());
             if (!functionQueue().size())
                 break;
-            invocation = functionQueue().takeFirst();
+            batch.swap(functionQueue());
         }
+        invocation = batch.takeFirst();
 
         invocation.function(invocation.context);
         if (invocation.syncFlag) {
@@ -215,6 +227,17 @@ void cancelCallOnMainThread(MainThreadFunction* function, void* context)
 
     FunctionWithContextFinder pred(FunctionWithContext(function, context));
 
+    // From another thread, a function already taken for dispatch may run anyway, as it could when
+    // it was taken one at a time.
+    if (isMainThread()) {
+        while (true) {
+            FunctionQueue::iterator i(dispatchBatch().findIf(pred));
+            if (i == dispatchBatch().end())
+                break;
+            dispatchBatch().remove(i);
+        }
+    }
+
     while (true) {
         // We must redefine 'i' each pass, because the itererator's operator= 
         // requires 'this' to be valid, and remove() invalidates all iterators
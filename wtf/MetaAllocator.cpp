@@ -163,6 +163,9 @@ MetaAllocator::Statistics MetaAllocator::currentStatistics()
     result.bytesAllocated = m_bytesAllocated;
     result.bytesReserved = m_bytesReserved;
     result.bytesCommitted = m_bytesCommitted;
+    result.freeBlockCount = m_freeSpaceStartAddressMap.size();
+    FreeSpaceNode* largestNode = m_freeSpaceSizeMap.last();
+    result.largestFreeBlock = largestNode ? largestNode->m_key : 0;
     return result;
 }
 
@@ -406,7 +409,14 @@ void MetaAllocator::freeFreeSpaceNode(FreeSpaceNode* node)
 #if ENABLE(META_ALLOCATOR_PROFILE)
 void MetaAllocator::dumpProfile()
 {
+    Statistics statistics = currentStatistics();
+    size_t bytesFree = statistics.bytesReserved - statistics.bytesAllocated;
     printf("num allocations = %u, num frees = %u\n", m_numAllocations, m_numFrees);
+    printf("bytes allocated = %lu, bytes reserved = %lu, bytes committed = %lu\n",
+        static_cast<unsigned long>(statistics.bytesAllocated), static_cast<unsigned long>(statistics.bytesReserved), static_cast<unsigned long>(statistics.bytesCommitted));
+    printf("bytes free = %lu in %lu blocks, largest free block = %lu, fragmentation = %.1f%%\n",
+        static_cast<unsigned long>(bytesFree), static_cast<unsigned long>(statistics.freeBlockCount), static_cast<unsigned long>(statistics.largestFreeBlock),
+        bytesFree ? 100.0 * (bytesFree - statistics.largestFreeBlock) / bytesFree : 0.0);
 }
 #endif
 
@@ -58,11 +58,16 @@ public:
     size_t bytesReserved() { return m_bytesReserved; }
     size_t bytesCommitted() { return m_bytesCommitted; }
     
-    // Atomic method for getting allocator statistics.
+    // Atomic method for getting allocator statistics. The free space is
+    // bytesReserved - bytesAllocated, split into freeBlockCount blocks; when
+    // largestFreeBlock is much smaller than the free space, the allocator is
+    // fragmented and large requests may fail in a fixed pool.
     struct Statistics {
         size_t bytesAllocated;
         size_t bytesReserved;
         size_t bytesCommitted;
+        size_t freeBlockCount;
+        size_t largestFreeBlock;
     };
     Statistics currentStatistics();
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2011 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "NumberOfCores.h"
+
+#if OS(DARWIN)
+#include <sys/param.h>
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#elif OS(WINDOWS)
+#include <windows.h>
+#elif OS(UNIX)
+#include <unistd.h>
+#endif
+
+//+EAWebKitChange
+#if PLATFORM(EA)
+namespace EA { namespace WebKit {
+    // Set by the application when the platform can report its core count.
+    int (*gpProcessorCoreCountCallback)() = 0;
+}}
+#endif
+//-EAWebKitChange
+
+namespace WTF {
+
+int numberOfProcessorCores()
+{
+    const int defaultIfUnavailable = 1;
+    static int s_numberOfCores = -1;
+
+    if (s_numberOfCores > 0)
+        return s_numberOfCores;
+
+//+EAWebKitChange
+#if PLATFORM(EA)
+    if (EA::WebKit::gpProcessorCoreCountCallback) {
+        int result = EA::WebKit::gpProcessorCoreCountCallback();
+        s_numberOfCores = result > 0 ? result : defaultIfUnavailable;
+        return s_numberOfCores;
+    }
+#endif
+//-EAWebKitChange
+
+#if OS(DARWIN)
+    unsigned result;
+    size_t length = sizeof(result);
+    int name[] = {
+        CTL_HW,
+        HW_NCPU
+    };
+    int sysctlResult = sysctl(name, sizeof(name) / sizeof(int), &result, &length, 0, 0);
+
+    s_numberOfCores = sysctlResult < 0 ? defaultIfUnavailable : result;
+#elif OS(WINDOWS)
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+
+    s_numberOfCores = sysInfo.dwNumberOfProcessors;
+#elif OS(UNIX) && defined(_SC_NPROCESSORS_ONLN)
+    long sysconfResult = sysconf(_SC_NPROCESSORS_ONLN);
+
+    s_numberOfCores = sysconfResult < 0 ? defaultIfUnavailable : static_cast<int>(sysconfResult);
+#else
+    s_numberOfCores = defaultIfUnavailable;
+#endif
+    if (s_numberOfCores <= 0)
+        s_numberOfCores = defaultIfUnavailable;
+    return s_numberOfCores;
+}
+
+} // namespace WTF
@@ -30,11 +30,52 @@
 #if ENABLE(PARALLEL_JOBS) && ENABLE(THREADING_GENERIC)
 
 #include "ParallelJobs.h"
+#include "NumberOfCores.h"
 
 namespace WTF {
 
 Vector< RefPtr<ParallelEnvironment::ThreadPrivate> >* ParallelEnvironment::s_threadPool = 0;
 
+unsigned int ParallelEnvironment::s_maxNumberOfParallelThreads = 0;
+
+ParallelEnvironment::ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, unsigned int requestedJobNumber) :
+    m_threadFunction(threadFunction),
+    m_sizeOfParameter(sizeOfParameter)
+{
+    unsigned int maxParallelThreads = maxNumberOfParallelThreads();
+    if (!requestedJobNumber || requestedJobNumber > maxParallelThreads)
+        requestedJobNumber = maxParallelThreads;
+
+    if (!s_threadPool)
+        s_threadPool = new Vector< RefPtr<ThreadPrivate> >();
+
+    // The main thread should be also a worker.
+    unsigned int maxNewThreads = requestedJobNumber - 1;
+
+    // Workers stay in the pool between environments, so only the first few runs create threads.
+    for (unsigned int i = 0; i < maxParallelThreads && m_threads.size() < maxNewThreads; ++i) {
+        if (s_threadPool->size() < i + 1)
+            s_threadPool->append(ThreadPrivate::create());
+
+        if ((*s_threadPool)[i]->tryLockFor(this))
+            m_threads.append((*s_threadPool)[i]);
+    }
+
+    m_numberOfJobs = m_threads.size() + 1;
+}
+
+unsigned int ParallelEnvironment::maxNumberOfParallelThreads()
+{
+    if (!s_maxNumberOfParallelThreads)
+        s_maxNumberOfParallelThreads = numberOfProcessorCores();
+    return s_maxNumberOfParallelThreads;
+}
+
+void ParallelEnvironment::setMaxNumberOfParallelThreads(unsigned int maxNumberOfThreads)
+{
+    s_maxNumberOfParallelThreads = maxNumberOfThreads;
+}
+
 bool ParallelEnvironment::ThreadPrivate::tryLockFor(ParallelEnvironment* parent)
 {
     bool locked = m_mutex.tryLock();
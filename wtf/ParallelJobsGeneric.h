@@ -35,36 +35,17 @@
 
 namespace WTF {
 
-static const unsigned int maxParallelThreads = 2;
-
 class ParallelEnvironment {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     typedef void (*ThreadFunction)(void*);
 
-    ParallelEnvironment(ThreadFunction threadFunction, size_t sizeOfParameter, unsigned int requestedJobNumber) :
-        m_threadFunction(threadFunction),
-        m_sizeOfParameter(sizeOfParameter)
-    {
-        if (!requestedJobNumber || requestedJobNumber > maxParallelThreads)
-            requestedJobNumber = maxParallelThreads;
-
-        if (!s_threadPool)
-            s_threadPool = new Vector< RefPtr<ThreadPrivate> >();
-
-        // The main thread should be also a worker.
-        unsigned int maxNewThreads = requestedJobNumber - 1;
+    ParallelEnvironment(ThreadFunction, size_t sizeOfParameter, unsigned int requestedJobNumber);
 
-        for (unsigned int i = 0; i < maxParallelThreads && m_threads.size() < maxNewThreads; ++i) {
-            if (s_threadPool->size() < i + 1)
-                s_threadPool->append(ThreadPrivate::create());
-
-            if ((*s_threadPool)[i]->tryLockFor(this))
-                m_threads.append((*s_threadPool)[i]);
-        }
-
-        m_numberOfJobs = m_threads.size() + 1;
-    }
+    // The most jobs, the calling thread included, that run at once. Defaults to the number of
+    // processor cores; setting 0 restores the default. Workers already in the pool are kept.
+    static unsigned int maxNumberOfParallelThreads();
+    static void setMaxNumberOfParallelThreads(unsigned int);
 
     int numberOfJobs()
     {
@@ -128,6 +109,7 @@ private:
 
     Vector< RefPtr<ThreadPrivate> > m_threads;
     static Vector< RefPtr<ThreadPrivate> >* s_threadPool;
+    static unsigned int s_maxNumberOfParallelThreads;
 };
 
 } // namespace WTF
@@ -1029,6 +1029,9 @@
 #endif
 
 /* The JIT is enabled by default on all x86, x64-64, ARM & MIPS platforms. */
+/* There is no MacroAssembler backend for PowerPC, so CPU(PPC) and CPU(PPC64)
+   builds run the interpreter and the Yarr interpreter. Console builds do too
+   whatever their CPU, because they can't map memory as executable. */
 //+EAWebKitChange
 //01/03/2013 
 #if !defined(ENABLE_JIT) \
@@ -1041,7 +1044,10 @@
 #endif
 //-EAWebKitChange
 
-/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC) */
+/* Currently only implemented for JSVALUE64, only tested on PLATFORM(MAC). The
+   code generators assume the System V x86-64 calling convention, which Linux
+   shares, so a Linux x86-64 build can define ENABLE_DFG_JIT to 1 to try it; it
+   is not on by default there until that build has passed the test suites. */
 #if !defined(ENABLE_DFG_JIT) && ENABLE(JIT) && USE(JSVALUE64) && PLATFORM(MAC)
 #define ENABLE_DFG_JIT 1
 #endif
@@ -1071,6 +1077,24 @@
 #define ENABLE_SIMPLE_HEAP_PROFILING 0
 #endif
 
+/* Generational collection: blocks allocated since the last collection form a
+   nursery that is collected separately, with old-to-young stores tracked by
+   the write barrier. Experimental. */
+#if !defined(ENABLE_GGC)
+#define ENABLE_GGC 0
+#endif
+
+/* Incremental marking: a full collection's marking can be spread over slices
+   driven by the embedder, with stores into already traced objects tracked by
+   the generational write barrier. Experimental. */
+#if !defined(ENABLE_INCREMENTAL_MARKING)
+#define ENABLE_INCREMENTAL_MARKING 0
+#endif
+
+#if ENABLE(INCREMENTAL_MARKING) && !ENABLE(GGC)
+#error "ENABLE(INCREMENTAL_MARKING) requires ENABLE(GGC)"
+#endif
+
 /* Counts uses of write barriers using sampling counters. Be sure to also
    set ENABLE_SAMPLING_COUNTERS to 1. */
 #if !defined(ENABLE_WRITE_BARRIER_PROFILING)
@@ -1138,6 +1162,12 @@
 #define ENABLE_ASSEMBLER_WX_EXCLUSIVE 1
 #endif
 
+/* Batching defers the reprotection and instruction cache flushes of patched code
+   to the end of a batch, so it's only worth having where either is needed. */
+#if !defined(ENABLE_EXECUTABLE_MEMORY_BATCHING) && (ENABLE(ASSEMBLER_WX_EXCLUSIVE) || !(CPU(X86) || CPU(X86_64)))
+#define ENABLE_EXECUTABLE_MEMORY_BATCHING 1
+#endif
+
 /* Pick which allocator to use; we only need an executable allocator if the assembler is compiled in.
    On x86-64 we use a single fixed mmap, on other platforms we mmap on demand. */
 #if ENABLE(ASSEMBLER)
@@ -1154,6 +1184,30 @@
 #endif
 #endif
 
+/* Atomic compare-and-swap on 32-bit words, see wtf/Atomics.h. */
+#if !defined(ENABLE_COMPARE_AND_SWAP) && (OS(WINDOWS) || defined(EA_PLATFORM_MICROSOFT) || (COMPILER(GCC) && (CPU(X86) || CPU(X86_64) || CPU(ARM_THUMB2))))
+#define ENABLE_COMPARE_AND_SWAP 1
+#endif
+
+/* Parallel marking with one SlotVisitor per marking thread. Marking threads
+   set mark bits with compare-and-swap. Experimental. */
+#if !defined(ENABLE_PARALLEL_GC)
+#define ENABLE_PARALLEL_GC 0
+#endif
+#if ENABLE(PARALLEL_GC) && !(ENABLE(JSC_MULTIPLE_THREADS) && ENABLE(COMPARE_AND_SWAP))
+#error ENABLE(PARALLEL_GC) requires ENABLE(JSC_MULTIPLE_THREADS) and ENABLE(COMPARE_AND_SWAP)
+#endif
+
+/* After a collection the block-freeing thread sweeps blocks whose dead cells
+   can be destroyed off the main thread, and leaves their free lists for the
+   allocator. Experimental. */
+#if !defined(ENABLE_CONCURRENT_SWEEPING)
+#define ENABLE_CONCURRENT_SWEEPING 0
+#endif
+#if ENABLE(CONCURRENT_SWEEPING) && !(ENABLE(LAZY_BLOCK_FREEING) && ENABLE(COMPARE_AND_SWAP))
+#error ENABLE(CONCURRENT_SWEEPING) requires ENABLE(LAZY_BLOCK_FREEING) and ENABLE(COMPARE_AND_SWAP)
+#endif
+
 #ifndef ENABLE_LARGE_HEAP
 #if CPU(X86) || CPU(X86_64)
 #define ENABLE_LARGE_HEAP 1
@@ -60,49 +60,29 @@ public:
 
     inline unsigned hash() const
     {
-        unsigned result = m_hash;
-
-        // Handle end case.
-        if (m_hasPendingCharacter) {
-            result += m_pendingCharacter;
-            result ^= result << 11;
-            result += result >> 17;
-        }
-
-        // Force "avalanching" of final 31 bits.
-        result ^= result << 3;
-        result += result >> 5;
-        result ^= result << 2;
-        result += result >> 15;
-        result ^= result << 10;
-
-        // First bit is used in UStringImpl for m_isIdentifier.
-        result &= 0x7fffffff;
-
-        // This avoids ever returning a hash code of 0, since that is used to
-        // signal "hash not computed yet", using a value that is likely to be
-        // effectively the same as 0 when the low bits are masked.
-        if (!result)
-            return 0x40000000;
-
-        return result;
+        return finalize(m_hash, m_hasPendingCharacter, m_pendingCharacter);
     }
 
+    // The hash is kept in a local here rather than in a StringHasher, and four characters are
+    // taken per iteration, so that the loop carries nothing but the hash itself. The result is
+    // the same as feeding the characters through addCharacter() one at a time: the hashes of the
+    // static property tables are precomputed by create_hash_table, so the function can't change.
     template<typename T, UChar Converter(T)> static inline unsigned computeHash(const T* data, unsigned length)
     {
-        StringHasher hasher;
-        bool rem = length & 1;
-        length >>= 1;
-
-        while (length--) {
-            hasher.addCharacters(Converter(data[0]), Converter(data[1]));
+        unsigned hash = stringHashingStartValue;
+        const T* end = data + (length & ~3u);
+        while (data != end) {
+            hash = addCharactersToHash(hash, Converter(data[0]), Converter(data[1]));
+            hash = addCharactersToHash(hash, Converter(data[2]), Converter(data[3]));
+            data += 4;
+        }
+        if (length & 2) {
+            hash = addCharactersToHash(hash, Converter(data[0]), Converter(data[1]));
             data += 2;
         }
-
-        if (rem)
-            hasher.addCharacter(Converter(*data));
-
-        return hasher.hash();
+        if (length & 1)
+            return finalize(hash, true, Converter(*data));
+        return finalize(hash, false, 0);
     }
 
     template<typename T, UChar Converter(T)> static inline unsigned computeHash(const T* data)
@@ -158,12 +138,46 @@ private:
         return static_cast<unsigned char>(ch);
     }
 
+    static inline unsigned addCharactersToHash(unsigned hash, UChar a, UChar b)
+    {
+        hash += a;
+        unsigned tmp = (b << 11) ^ hash;
+        hash = (hash << 16) ^ tmp;
+        hash += hash >> 11;
+        return hash;
+    }
+
     inline void addCharactersToHash(UChar a, UChar b)
     {
-        m_hash += a;
-        unsigned tmp = (b << 11) ^ m_hash;
-        m_hash = (m_hash << 16) ^ tmp;
-        m_hash += m_hash >> 11;
+        m_hash = addCharactersToHash(m_hash, a, b);
+    }
+
+    static inline unsigned finalize(unsigned result, bool hasPendingCharacter, UChar pendingCharacter)
+    {
+        // Handle end case.
+        if (hasPendingCharacter) {
+            result += pendingCharacter;
+            result ^= result << 11;
+            result += result >> 17;
+        }
+
+        // Force "avalanching" of final 31 bits.
+        result ^= result << 3;
+        result += result >> 5;
+        result ^= result << 2;
+        result += result >> 15;
+        result ^= result << 10;
+
+        // First bit is used in UStringImpl for m_isIdentifier.
+        result &= 0x7fffffff;
+
+        // This avoids ever returning a hash code of 0, since that is used to
+        // signal "hash not computed yet", using a value that is likely to be
+        // effectively the same as 0 when the low bits are masked.
+        if (!result)
+            return 0x40000000;
+
+        return result;
     }
 
     unsigned m_hash;
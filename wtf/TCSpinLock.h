@@ -244,6 +244,53 @@ static void TCMalloc_SlowLock(LPLONG lockword) {
         Sleep(2);
 }
 
+//+EAWebKitChange
+#elif ENABLE(COMPARE_AND_SWAP)
+
+#include <wtf/Atomics.h>
+
+namespace WTF {
+    void yield();
+}
+
+static void TCMalloc_SlowLock(unsigned* lockword);
+
+// Built on the portable atomics, for compilers without the inline assembly above, such as
+// the EA port's. Spins briefly on a plain load before yielding the processor.
+struct TCMalloc_SpinLock {
+
+    inline void Lock() {
+        if (!WTF::weakCompareAndSwap(&m_lockword, 0, 1))
+            TCMalloc_SlowLock(&m_lockword);
+    }
+
+    inline void Unlock() {
+        WTF::storeRelease(&m_lockword, 0u);
+    }
+
+    inline bool IsHeld() const {
+        return m_lockword != 0;
+    }
+
+    inline void Init() { m_lockword = 0; }
+
+    unsigned m_lockword;
+};
+
+#define SPINLOCK_INITIALIZER { 0 }
+
+static void TCMalloc_SlowLock(unsigned* lockword) {
+    const unsigned spinsBeforeYield = 64;
+    while (true) {
+        for (unsigned i = 0; i < spinsBeforeYield; ++i) {
+            if (!*const_cast<unsigned volatile*>(lockword) && WTF::weakCompareAndSwap(lockword, 0, 1))
+                return;
+        }
+        WTF::yield();
+    }
+}
+//-EAWebKitChange
+
 #else
 
 #include <pthread.h>
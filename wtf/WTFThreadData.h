@@ -52,6 +52,10 @@ namespace JSC {
 
 typedef HashMap<const char*, RefPtr<StringImpl>, PtrHash<const char*> > LiteralIdentifierTable;
 
+// One table per thread (or per context group). The interned StringImpls can't be shared with
+// other threads: their reference counts are not atomic, and the count shares a word with the
+// identifier and atomic flags, so even a static string's flags could be corrupted by a
+// concurrent ref(). A process-wide table would first need atomic StringImpl reference counts.
 class IdentifierTable {
     WTF_MAKE_FAST_ALLOCATED;
 public:
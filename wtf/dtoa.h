@@ -21,6 +21,8 @@
 #ifndef WTF_dtoa_h
 #define WTF_dtoa_h
 
+#include <stdint.h>
+#include <wtf/ASCIICType.h>
 #include <wtf/dtoa/double-conversion.h>
 #include <wtf/unicode/Unicode.h>
 
@@ -39,6 +41,95 @@ void dtoaRoundDP(DtoaBuffer result, double dd, int ndigits, bool& sign, int& exp
 // se: *se will have the last consumed character position + 1.
 double strtod(const char* s00, char** se);
 
+// Reads the longest prefix of [begin, end) of the form [+-]? digits ('.' digits?)? ([eE] [+-]? digits)?,
+// or with the digits only after the '.', the way strtod would. When the significant digits fit in 53
+// bits and the power of ten is at most 10^22, one correctly rounded multiplication or division by an
+// exactly representable power of ten gives the exact result, with no bignum arithmetic. Returns false
+// otherwise, without reading anything, so the caller can fall back to strtod.
+template<typename CharType>
+bool strtodFastPath(const CharType* begin, const CharType* end, double& result, size_t& parsedLength)
+{
+    static const double exactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const int maxExactPowerOfTen = 22;
+    const int maxSignificantDigits = 19; // Any 19 digit number fits in a uint64_t.
+    const uint64_t maxExactMantissa = static_cast<uint64_t>(1) << 53;
+
+    const CharType* position = begin;
+    bool negative = false;
+    if (position < end && (*position == '+' || *position == '-')) {
+        negative = *position == '-';
+        ++position;
+    }
+
+    uint64_t mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool sawDigit = false;
+    for (; position < end && isASCIIDigit(*position); ++position) {
+        sawDigit = true;
+        if (!mantissa && *position == '0')
+            continue;
+        if (++significantDigits > maxSignificantDigits)
+            return false;
+        mantissa = mantissa * 10 + (*position - '0');
+    }
+    if (position < end && *position == '.') {
+        ++position;
+        for (; position < end && isASCIIDigit(*position); ++position) {
+            sawDigit = true;
+            --exponent;
+            if (!mantissa && *position == '0')
+                continue;
+            if (++significantDigits > maxSignificantDigits)
+                return false;
+            mantissa = mantissa * 10 + (*position - '0');
+        }
+    }
+    if (!sawDigit)
+        return false;
+
+    if (position < end && (*position == 'e' || *position == 'E')) {
+        const CharType* exponentIndicator = position++;
+        bool exponentIsNegative = false;
+        if (position < end && (*position == '+' || *position == '-')) {
+            exponentIsNegative = *position == '-';
+            ++position;
+        }
+        if (position < end && isASCIIDigit(*position)) {
+            int explicitExponent = 0;
+            for (; position < end && isASCIIDigit(*position); ++position) {
+                if (explicitExponent > 9999)
+                    return false;
+                explicitExponent = explicitExponent * 10 + (*position - '0');
+            }
+            exponent += exponentIsNegative ? -explicitExponent : explicitExponent;
+        } else
+            position = exponentIndicator; // As strtod does, leave an incomplete exponent unread.
+    }
+
+    if (mantissa > maxExactMantissa)
+        return false;
+    // Shift surplus powers of ten into the mantissa for as long as it stays exact.
+    while (exponent > maxExactPowerOfTen && mantissa <= maxExactMantissa / 10) {
+        mantissa *= 10;
+        --exponent;
+    }
+    if (exponent > maxExactPowerOfTen || exponent < -maxExactPowerOfTen)
+        return false;
+
+    double value = static_cast<double>(mantissa);
+    if (exponent > 0)
+        value *= exactPowersOfTen[exponent];
+    else if (exponent < 0)
+        value /= exactPowersOfTen[-exponent];
+    result = negative ? -value : value;
+    parsedLength = position - begin;
+    return true;
+}
+
 // Size = 80 for sizeof(DtoaBuffer) + some sign bits, decimal point, 'e', exponent digits.
 const unsigned NumberToStringBufferLength = 96;
 typedef char NumberToStringBuffer[NumberToStringBufferLength];
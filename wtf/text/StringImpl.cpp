@@ -41,6 +41,19 @@ static const unsigned minLengthToShare = 20;
 
 COMPILE_ASSERT(sizeof(StringImpl) == 2 * sizeof(int) + 3 * sizeof(void*), StringImpl_should_stay_small);
 
+struct ExternalStringBuffer {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    ExternalStringBuffer(ExternalStringReleaseFunction release, void* context)
+        : release(release)
+        , context(context)
+    {
+    }
+
+    ExternalStringReleaseFunction release;
+    void* context;
+};
+
 StringImpl::~StringImpl()
 {
     ASSERT(!isStatic());
@@ -57,9 +70,12 @@ StringImpl::~StringImpl()
     BufferOwnership ownership = bufferOwnership();
     if (ownership != BufferInternal) {
         if (ownership == BufferOwned) {
-            ASSERT(!m_sharedBuffer);
             ASSERT(m_data);
-            fastFree(const_cast<UChar*>(m_data));
+            if (m_externalBuffer) {
+                m_externalBuffer->release(m_data, m_externalBuffer->context);
+                delete m_externalBuffer;
+            } else
+                fastFree(const_cast<UChar*>(m_data));
         } else if (ownership == BufferSubstring) {
             ASSERT(m_substringBuffer);
             m_substringBuffer->deref();
@@ -132,6 +148,16 @@ PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned leng
     return adoptRef(new StringImpl(characters, length, sharedBuffer));
 }
 
+PassRefPtr<StringImpl> StringImpl::createExternal(const UChar* characters, unsigned length, ExternalStringReleaseFunction release, void* context)
+{
+    ASSERT(release);
+    if (!characters || !length) {
+        release(characters, context);
+        return empty();
+    }
+    return adoptRef(new StringImpl(characters, length, new ExternalStringBuffer(release, context)));
+}
+
 SharedUChar* StringImpl::sharedBuffer()
 {
     if (m_length < minLengthToShare)
@@ -145,6 +171,9 @@ SharedUChar* StringImpl::sharedBuffer()
         return 0;
     if (ownership == BufferSubstring)
         return m_substringBuffer->sharedBuffer();
+    // A SharedUChar frees its buffer with fastFree, which an embedder's buffer cannot take.
+    if (ownership == BufferOwned && m_externalBuffer)
+        return 0;
     if (ownership == BufferOwned) {
         ASSERT(!m_sharedBuffer);
         m_sharedBuffer = SharedUChar::create(new SharableUChar(m_data)).leakRef();
@@ -651,6 +680,35 @@ size_t StringImpl::findIgnoringCase(const char* matchString, unsigned index)
     return index + i;
 }
 
+// Below these sizes building the skip table costs more than the rolling hash scan it replaces.
+static const unsigned boyerMooreMinimumMatchLength = 4;
+static const unsigned boyerMooreMinimumSearchLength = 256;
+
+// Boyer-Moore-Horspool. The skip table is indexed by the low byte of each character, and a slot
+// keeps the smallest skip of all the match characters sharing it, so collisions only make the
+// skips shorter, never wrong.
+static size_t findBoyerMooreHorspool(const UChar* searchCharacters, unsigned searchLength, const UChar* matchCharacters, unsigned matchLength)
+{
+    ASSERT(matchLength >= 2 && matchLength <= searchLength);
+    unsigned skip[256];
+    for (unsigned i = 0; i < 256; ++i)
+        skip[i] = matchLength;
+    unsigned lastIndex = matchLength - 1;
+    for (unsigned i = 0; i < lastIndex; ++i)
+        skip[matchCharacters[i] & 0xFF] = lastIndex - i;
+
+    UChar lastCharacter = matchCharacters[lastIndex];
+    unsigned lastStart = searchLength - matchLength;
+    unsigned position = 0;
+    while (position <= lastStart) {
+        UChar candidate = searchCharacters[position + lastIndex];
+        if (candidate == lastCharacter && !memcmp(searchCharacters + position, matchCharacters, lastIndex * sizeof(UChar)))
+            return position;
+        position += skip[candidate & 0xFF];
+    }
+    return notFound;
+}
+
 size_t StringImpl::find(StringImpl* matchString, unsigned index)
 {
     // Check for null or empty string to match against
@@ -676,7 +734,13 @@ size_t StringImpl::find(StringImpl* matchString, unsigned index)
     const UChar* searchCharacters = characters() + index;
     const UChar* matchCharacters = matchString->characters();
 
-    // Optimization 2: keep a running hash of the strings,
+    // Optimization 2: for long needles in long haystacks, skip ahead with Boyer-Moore-Horspool.
+    if (matchLength >= boyerMooreMinimumMatchLength && searchLength >= boyerMooreMinimumSearchLength) {
+        size_t offset = findBoyerMooreHorspool(searchCharacters, searchLength, matchCharacters, matchLength);
+        return offset == notFound ? notFound : index + offset;
+    }
+
+    // Optimization 3: keep a running hash of the strings,
     // only call memcmp if the hashes match.
     unsigned searchHash = 0;
     unsigned matchHash = 0;
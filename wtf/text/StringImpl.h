@@ -62,6 +62,9 @@ typedef OwnFastMallocPtr<const UChar> SharableUChar;
 typedef CrossThreadRefCounted<SharableUChar> SharedUChar;
 typedef bool (*CharacterMatchFunctionPtr)(UChar);
 typedef bool (*IsWhiteSpaceFunctionPtr)(UChar);
+typedef void (*ExternalStringReleaseFunction)(const UChar* characters, void* context);
+
+struct ExternalStringBuffer;
 
 class StringImpl : public StringImplBase {
     friend struct JSC::IdentifierCStringTranslator;
@@ -121,6 +124,18 @@ private:
         ASSERT(m_substringBuffer->bufferOwnership() != BufferSubstring);
     }
 
+    // Create a StringImpl over a buffer someone else allocated (BufferOwned with an m_externalBuffer)
+    StringImpl(const UChar* characters, unsigned length, ExternalStringBuffer* externalBuffer)
+        : StringImplBase(length, BufferOwned)
+        , m_data(characters)
+        , m_externalBuffer(externalBuffer)
+        , m_hash(0)
+    {
+        ASSERT(m_data);
+        ASSERT(m_length);
+        ASSERT(m_externalBuffer);
+    }
+
     // Used to construct new strings sharing an existing SharedUChar (BufferShared)
     StringImpl(const UChar* characters, unsigned length, PassRefPtr<SharedUChar> sharedBuffer)
         : StringImplBase(length, BufferShared)
@@ -148,6 +163,9 @@ public:
     static PassRefPtr<StringImpl> create(const char*, unsigned length);
     static PassRefPtr<StringImpl> create(const char*);
     static PassRefPtr<StringImpl> create(const UChar*, unsigned length, PassRefPtr<SharedUChar> sharedBuffer);
+    // Wraps characters without copying them. The buffer must stay unchanged until release is
+    // called, which happens on whichever thread drops the last reference.
+    static PassRefPtr<StringImpl> createExternal(const UChar*, unsigned length, ExternalStringReleaseFunction release, void* context);
     static ALWAYS_INLINE PassRefPtr<StringImpl> create(PassRefPtr<StringImpl> rep, unsigned offset, unsigned length)
     {
         ASSERT(rep);
@@ -182,6 +200,7 @@ public:
     }
 
     static unsigned dataOffset() { return OBJECT_OFFSETOF(StringImpl, m_data); }
+    static unsigned hashOffset() { return OBJECT_OFFSETOF(StringImpl, m_hash); }
     static PassRefPtr<StringImpl> createWithTerminatingNullCharacter(const StringImpl&);
     static PassRefPtr<StringImpl> createStrippingNullCharacters(const UChar*, unsigned length);
 
@@ -199,8 +218,17 @@ public:
     static PassRefPtr<StringImpl> adopt(StringBuffer&);
 
     SharedUChar* sharedBuffer();
+    // Always UTF-16. More than a hundred callers (the lexer, the JIT's string thunks,
+    // Yarr and its JIT, the hash translators) read this pointer directly. A Latin-1
+    // representation would first need this accessor to upconvert 8-bit strings into a
+    // lazily allocated UTF-16 copy, so that every existing reader stays correct, and
+    // then the hot readers moved one at a time to an is8Bit() branch; only the second
+    // step saves any memory.
     const UChar* characters() const { return m_data; }
 
+    // The number of bytes of character data this string keeps alive, the
+    // first time it is asked for. Later calls return 0, so a buffer shared by
+    // several owners is only counted once.
     size_t cost()
     {
         // For substrings, return the cost of the base string.
@@ -209,7 +237,7 @@ public:
 
         if (m_refCountAndFlags & s_refCountFlagShouldReportedCost) {
             m_refCountAndFlags &= ~s_refCountFlagShouldReportedCost;
-            return m_length;
+            return static_cast<size_t>(m_length) * sizeof(UChar);
         }
         return 0;
     }
@@ -340,6 +368,7 @@ private:
         void* m_buffer;
         StringImpl* m_substringBuffer;
         SharedUChar* m_sharedBuffer;
+        ExternalStringBuffer* m_externalBuffer;
     };
     mutable unsigned m_hash;
 };
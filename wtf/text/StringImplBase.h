@@ -28,10 +28,16 @@
 
 #include <wtf/unicode/Unicode.h>
 
+namespace JSC {
+class JIT;
+}
+
 namespace WTF {
 
 class StringImplBase {
     WTF_MAKE_NONCOPYABLE(StringImplBase); WTF_MAKE_FAST_ALLOCATED;
+    // Takes references and checks the reported cost when it builds ropes inline.
+    friend class JSC::JIT;
 public:
     bool isStringImpl() { return (m_refCountAndFlags & s_refCountInvalidForStringImpl) != s_refCountInvalidForStringImpl; }
     unsigned length() const { return m_length; }
@@ -25,6 +25,7 @@
 #include "UnicodeEA.h"
 
 #include <WTF/assertions.h>
+#include <wtf/ASCIICType.h>
 #include <EABase/eabase.h>
 #if defined(EA_PLATFORM_MICROSOFT)
 #include EAWEBKIT_PLATFORM_HEADER
@@ -47,6 +48,8 @@ namespace WTF {
 		UChar32 foldCase(UChar32 c)
 		{
 			// For most unicode characters, foldCase is same as toLower. 
+			if (isASCII(c))
+				return toASCIILower(c);
 			return toLower(c);
 		}
 
@@ -68,6 +71,10 @@ namespace WTF {
 		{
             ASSERT_WITH_MESSAGE(c <= 0xffff || c==0xffffffff, "We don't support chars above 0xffff");
 
+            // ASCII maps the same way in every locale, so it never needs the text layer.
+            if (isASCII(c))
+                return toASCIILower(c);
+
             const JSText::Char source = static_cast<const JSText::Char>(c);
             JSText::Char result; 
             JSTextInterface* pTI = JSGetTextInterface();
@@ -90,6 +97,9 @@ namespace WTF {
 		UChar32 toUpper(UChar32 c)
 		{
             ASSERT_WITH_MESSAGE(c <= 0xffff || c==0xffffffff, "We don't support chars above 0xffff");
+
+            if (isASCII(c))
+                return toASCIIUpper(c);
             
             const JSText::Char source = static_cast<const JSText::Char>(c);
             JSText::Char result; 
@@ -449,6 +459,17 @@ namespace WTF {
 		{
 			for (int i = 0; i < len; ++i)
 			{
+				// Identical characters fold identically, and ASCII pairs fold without the text layer.
+				if (a[i] == b[i])
+					continue;
+				if (isASCII(a[i] | b[i])) {
+					const int c1 = toASCIILower(a[i]);
+					const int c2 = toASCIILower(b[i]);
+					if (c1 != c2)
+						return (c1 - c2);
+					continue;
+				}
+
 				const UChar32 c1 = foldCase(a[i]);
 				const UChar32 c2 = foldCase(b[i]);
 
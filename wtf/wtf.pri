@@ -24,6 +24,7 @@ SOURCES += \
     wtf/MainThread.cpp \
     wtf/MetaAllocator.cpp \
     wtf/NullPtr.cpp \
+    wtf/NumberOfCores.cpp \
     wtf/OSRandomSource.cpp \
     wtf/qt/MainThreadQt.cpp \
     wtf/qt/StringQt.cpp \
@@ -45,7 +45,8 @@ namespace JSC { namespace Yarr {
 static const unsigned quantifyInfinite = UINT_MAX;
 
 // The below limit restricts the number of "recursive" match calls in order to
-// avoid spending exponential time on complex regular expressions.
+// avoid spending exponential time on complex regular expressions. It is the
+// default for JSSetRegExpMatchLimit().
 static const unsigned matchLimit = 1000000;
 
 enum JSRegExpResult {
@@ -63,6 +64,7 @@ enum YarrCharSize {
 };
 
 PassOwnPtr<BytecodePattern> byteCompile(YarrPattern&, BumpPointerAllocator*);
+// Returns the match start, -1 for no match, or JSRegExpErrorHitLimit if the match ran out of budget.
 int interpret(BytecodePattern*, const UString& input, unsigned start, unsigned length, int* output);
 
 } } // namespace JSC::Yarr
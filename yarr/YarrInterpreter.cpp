@@ -29,7 +29,9 @@
 
 #include "UString.h"
 #include "Yarr.h"
+#include <JSSettingsEA.h>
 #include <wtf/BumpPointerAllocator.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/text/CString.h>
 
 #ifndef NDEBUG
@@ -353,6 +355,8 @@ public:
                 if ((ch >= characterClass->m_rangesUnicode[i].begin) && (ch <= characterClass->m_rangesUnicode[i].end))
                     return true;
         } else {
+            if (characterClass->m_hasASCIIBitmap)
+                return characterClass->m_asciiBitmap[ch >> 5] & (1u << (ch & 31));
             for (unsigned i = 0; i < characterClass->m_matches.size(); ++i)
                 if (ch == characterClass->m_matches[i])
                     return true;
@@ -1148,6 +1152,8 @@ public:
     {
         if (!--remainingMatchCount)
             return JSRegExpErrorHitLimit;
+        if (deadline && !(remainingMatchCount % deadlineCheckInterval) && currentTime() > deadline)
+            return JSRegExpErrorHitLimit;
 
         if (btrack)
             BACKTRACK();
@@ -1475,7 +1481,9 @@ public:
 
         pattern->m_allocator->stopAllocator();
 
-        // RegExp.cpp currently expects all error to be converted to -1.
+        // RegExp.cpp reports running out of budget; all other errors are converted to -1.
+        if (result == JSRegExpErrorHitLimit)
+            return JSRegExpErrorHitLimit;
         ASSERT((result == JSRegExpMatch) == (output[0] != -1));
         return output[0];
     }
@@ -1485,16 +1493,21 @@ public:
         , output(output)
         , input(input, start, length)
         , allocatorPool(0)
-        , remainingMatchCount(matchLimit)
+        , remainingMatchCount(JSGetRegExpMatchLimit() ? JSGetRegExpMatchLimit() : std::numeric_limits<unsigned>::max())
+        , deadline(JSGetRegExpTimeLimit() ? currentTime() + JSGetRegExpTimeLimit() / 1000.0 : 0)
     {
     }
 
 private:
+    // How many steps run between looks at the clock, when there is a time limit.
+    static const unsigned deadlineCheckInterval = 4096;
+
     BytecodePattern* pattern;
     int* output;
     InputStream input;
     BumpPointerPool* allocatorPool;
     unsigned remainingMatchCount;
+    double deadline;
 };
 
 
@@ -352,6 +352,12 @@ public:
         // array, so that it won't delete them on destruction.  We'll
         // take responsibility for that.
         pattern.m_userCharacterClasses.clear();
+
+        // Let the interpreter test ASCII characters with one bit lookup.
+        for (unsigned i = 0; i < m_userCharacterClasses.size(); ++i) {
+            m_userCharacterClasses[i]->computeASCIIBitmap(m_userCharacterClasses[i]->m_asciiBitmap);
+            m_userCharacterClasses[i]->m_hasASCIIBitmap = true;
+        }
     }
 
     ~BytecodePattern()
@@ -360,6 +366,15 @@ public:
         deleteAllValues(m_userCharacterClasses);
     }
 
+    // The memory held by the terms of the pattern, not counting its character classes.
+    size_t sizeInMemory() const
+    {
+        size_t size = sizeof(BytecodePattern) + sizeof(ByteDisjunction) + m_body->terms.capacity() * sizeof(ByteTerm);
+        for (size_t i = 0; i < m_allParenthesesInfo.size(); ++i)
+            size += sizeof(ByteDisjunction) + m_allParenthesesInfo[i]->terms.capacity() * sizeof(ByteTerm);
+        return size;
+    }
+
     OwnPtr<ByteDisjunction> m_body;
     bool m_ignoreCase;
     bool m_multiline;
@@ -29,6 +29,7 @@
 #include "ASCIICType.h"
 #include "LinkBuffer.h"
 #include "Yarr.h"
+#include <wtf/HashMap.h>
 
 #if ENABLE(YARR_JIT)
 
@@ -158,6 +159,28 @@ class YarrGenerator : private MacroAssembler {
         } while (count);
     }
 
+    static const unsigned minimumComparesForASCIITable = 4;
+
+    // Returns a table with a nonzero byte for each ASCII character in the class, shared by every
+    // place the class is matched, or 0 if a few compares are as quick.
+    const char* asciiTableFor(const CharacterClass* charClass)
+    {
+        if (charClass->m_matches.size() + 2 * charClass->m_ranges.size() < minimumComparesForASCIITable)
+            return 0;
+
+        HashMap<const CharacterClass*, const char*>::iterator cached = m_asciiTables.find(charClass);
+        if (cached != m_asciiTables.end())
+            return cached->second;
+
+        uint32_t bitmap[4];
+        charClass->computeASCIIBitmap(bitmap);
+        char* table = m_codeBlock->createCharacterClassTable();
+        for (unsigned ch = 0; ch < 128; ++ch)
+            table[ch] = (bitmap[ch >> 5] >> (ch & 31)) & 1;
+        m_asciiTables.add(charClass, table);
+        return table;
+    }
+
     void matchCharacterClass(RegisterID character, JumpList& matchDest, const CharacterClass* charClass)
     {
         if (charClass->m_table) {
@@ -191,7 +214,11 @@ class YarrGenerator : private MacroAssembler {
             isAscii.link(this);
         }
 
-        if (charClass->m_ranges.size()) {
+        if (const char* asciiTable = asciiTableFor(charClass)) {
+            Jump notASCII = branch32(Above, character, TrustedImm32(0x7f));
+            matchDest.append(branchTest8(NonZero, ExtendedAddress(character, reinterpret_cast<intptr_t>(asciiTable))));
+            notASCII.link(this);
+        } else if (charClass->m_ranges.size()) {
             unsigned matchIndex = 0;
             JumpList failures;
             matchCharacterClassRange(character, failures, matchDest, charClass->m_ranges.begin(), charClass->m_ranges.size(), &matchIndex, charClass->m_matches.begin(), charClass->m_matches.size());
@@ -2445,11 +2472,14 @@ public:
         , m_charScale(m_charSize == Char8 ? TimesOne: TimesTwo)
         , m_shouldFallBack(false)
         , m_checked(0)
+        , m_codeBlock(0)
     {
     }
 
     void compile(JSGlobalData* globalData, YarrCodeBlock& jitObject)
     {
+        m_codeBlock = &jitObject;
+
         generateEnter();
 
         if (!m_pattern.m_body->m_hasFixedSize)
@@ -2475,9 +2505,9 @@ public:
         LinkBuffer linkBuffer(*globalData, this);
         m_backtrackingState.linkDataLabels(linkBuffer);
         if (m_charSize == Char8)
-            jitObject.set8BitCode(linkBuffer.finalizeCode());
+            jitObject.set8BitCode(linkBuffer.finalizeCode("RegExp (8-bit)"));
         else
-            jitObject.set16BitCode(linkBuffer.finalizeCode());
+            jitObject.set16BitCode(linkBuffer.finalizeCode("RegExp (16-bit)"));
         jitObject.setFallBack(m_shouldFallBack);
     }
 
@@ -2507,6 +2537,10 @@ private:
     // on the YarrOp structure.
     int m_checked;
 
+    // Owns the tables asciiTableFor() builds, which are cached per character class.
+    YarrCodeBlock* m_codeBlock;
+    HashMap<const CharacterClass*, const char*> m_asciiTables;
+
     // This class records state whilst generating the backtracking path of code.
     BacktrackingState m_backtrackingState;
 };
@@ -59,12 +59,24 @@ public:
 
     ~YarrCodeBlock()
     {
+        for (unsigned i = 0; i < m_characterClassTables.size(); ++i)
+            fastFree(m_characterClassTables[i]);
+    }
+
+    // Returns a zeroed 128-entry table for the JIT code to index by ASCII character. It lives as
+    // long as this code block.
+    char* createCharacterClassTable()
+    {
+        char* table = static_cast<char*>(fastZeroedMalloc(128));
+        m_characterClassTables.append(table);
+        return table;
     }
 
     void setFallBack(bool fallback) { m_needFallBack = fallback; }
     bool isFallBack() { return m_needFallBack; }
     bool has8BitCode() { return m_ref8.size(); }
     bool has16BitCode() { return m_ref16.size(); }
+    size_t size() const { return m_ref8.size() + m_ref16.size(); }
     void set8BitCode(MacroAssembler::CodeRef ref) { m_ref8 = ref; }
     void set16BitCode(MacroAssembler::CodeRef ref) { m_ref16 = ref; }
 
@@ -86,6 +98,7 @@ public:
 private:
     MacroAssembler::CodeRef m_ref8;
     MacroAssembler::CodeRef m_ref16;
+    Vector<char*> m_characterClassTables;
     bool m_needFallBack;
 };
 
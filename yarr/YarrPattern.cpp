@@ -802,6 +802,153 @@ const char* YarrPattern::compile(const UString& patternString)
     return 0;
 }
 
+void CharacterClass::computeASCIIBitmap(uint32_t bitmap[4]) const
+{
+    bitmap[0] = bitmap[1] = bitmap[2] = bitmap[3] = 0;
+    for (unsigned i = 0; i < m_matches.size(); ++i) {
+        ASSERT(m_matches[i] <= 0x7f);
+        bitmap[m_matches[i] >> 5] |= 1u << (m_matches[i] & 31);
+    }
+    for (unsigned i = 0; i < m_ranges.size(); ++i) {
+        ASSERT(m_ranges[i].end <= 0x7f);
+        for (unsigned ch = m_ranges[i].begin; ch <= m_ranges[i].end; ++ch)
+            bitmap[ch >> 5] |= 1u << (ch & 31);
+    }
+}
+
+class RequiredLiteralFinder {
+public:
+    RequiredLiteralFinder(Vector<UChar>& prefix, Vector<UChar>& longestRun)
+        : m_prefix(prefix)
+        , m_longestRun(longestRun)
+        , m_atStart(true)
+    {
+    }
+
+    void find(const PatternAlternative* alternative)
+    {
+        visit(alternative);
+        endRun();
+    }
+
+private:
+    static const unsigned maximumRepeatedCharacters = 64;
+
+    void visit(const PatternAlternative* alternative)
+    {
+        for (unsigned i = 0; i < alternative->m_terms.size(); ++i) {
+            const PatternTerm& term = alternative->m_terms[i];
+            switch (term.type) {
+            case PatternTerm::TypePatternCharacter:
+                if (term.quantityType == QuantifierFixedCount && term.quantityCount.unsafeGet() <= maximumRepeatedCharacters) {
+                    for (unsigned j = 0; j < term.quantityCount.unsafeGet(); ++j)
+                        m_run.append(term.patternCharacter);
+                } else
+                    endRun();
+                break;
+
+            case PatternTerm::TypeAssertionBOL:
+            case PatternTerm::TypeAssertionEOL:
+            case PatternTerm::TypeAssertionWordBoundary:
+                // Zero width, so the characters on either side are still adjacent in the input.
+                break;
+
+            case PatternTerm::TypeParenthesesSubpattern:
+                if (term.quantityType == QuantifierFixedCount && term.quantityCount.unsafeGet() == 1
+                    && term.parentheses.disjunction->m_alternatives.size() == 1)
+                    visit(term.parentheses.disjunction->m_alternatives[0]);
+                else
+                    endRun();
+                break;
+
+            default:
+                endRun();
+                break;
+            }
+        }
+    }
+
+    void endRun()
+    {
+        if (m_atStart) {
+            m_prefix = m_run;
+            m_atStart = false;
+        }
+        if (m_run.size() > m_longestRun.size())
+            m_longestRun.swap(m_run);
+        m_run.clear();
+    }
+
+    Vector<UChar>& m_prefix;
+    Vector<UChar>& m_longestRun;
+    Vector<UChar> m_run;
+    bool m_atStart;
+};
+
+void YarrPattern::requiredLiterals(Vector<UChar>& prefix, Vector<UChar>& longestRun) const
+{
+    prefix.clear();
+    longestRun.clear();
+
+    // Under ignoreCase a pattern character stands for more than one input character.
+    if (m_ignoreCase || m_body->m_alternatives.size() != 1)
+        return;
+
+    RequiredLiteralFinder(prefix, longestRun).find(m_body->m_alternatives[0]);
+}
+
+static bool containsVariableCount(const PatternDisjunction* disjunction)
+{
+    if (disjunction->m_alternatives.size() > 1)
+        return true;
+
+    for (unsigned i = 0; i < disjunction->m_alternatives.size(); ++i) {
+        const Vector<PatternTerm>& terms = disjunction->m_alternatives[i]->m_terms;
+        for (unsigned j = 0; j < terms.size(); ++j) {
+            const PatternTerm& term = terms[j];
+            if (term.quantityType != QuantifierFixedCount)
+                return true;
+            if ((term.type == PatternTerm::TypeParenthesesSubpattern || term.type == PatternTerm::TypeParentheticalAssertion)
+                && containsVariableCount(term.parentheses.disjunction))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool YarrPattern::containsNestedQuantifiers() const
+{
+    for (unsigned i = 0; i < m_disjunctions.size(); ++i) {
+        const Vector<PatternAlternative*>& alternatives = m_disjunctions[i]->m_alternatives;
+        for (unsigned j = 0; j < alternatives.size(); ++j) {
+            const Vector<PatternTerm>& terms = alternatives[j]->m_terms;
+            for (unsigned k = 0; k < terms.size(); ++k) {
+                const PatternTerm& term = terms[k];
+                if (term.type == PatternTerm::TypeParenthesesSubpattern && term.quantityType != QuantifierFixedCount
+                    && containsVariableCount(term.parentheses.disjunction))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void YarrPattern::removeCaptures()
+{
+    ASSERT(!m_containsBackreferences);
+
+    for (unsigned i = 0; i < m_disjunctions.size(); ++i) {
+        Vector<PatternAlternative*>& alternatives = m_disjunctions[i]->m_alternatives;
+        for (unsigned j = 0; j < alternatives.size(); ++j) {
+            Vector<PatternTerm>& terms = alternatives[j]->m_terms;
+            for (unsigned k = 0; k < terms.size(); ++k) {
+                if (terms[k].type == PatternTerm::TypeParenthesesSubpattern)
+                    terms[k].m_capture = false;
+            }
+        }
+    }
+}
+
 YarrPattern::YarrPattern(const UString& pattern, bool ignoreCase, bool multiline, const char** error)
     : m_ignoreCase(ignoreCase)
     , m_multiline(multiline)
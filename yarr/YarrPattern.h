@@ -71,13 +71,21 @@ public:
     // specified matches and ranges)
     CharacterClass(PassRefPtr<CharacterClassTable> table)
         : m_table(table)
+        , m_hasASCIIBitmap(false)
     {
     }
+
+    // Sets one bit per character in m_matches and m_ranges, which only hold characters up to 0x7f.
+    void computeASCIIBitmap(uint32_t bitmap[4]) const;
+
     Vector<UChar> m_matches;
     Vector<CharacterRange> m_ranges;
     Vector<UChar> m_matchesUnicode;
     Vector<CharacterRange> m_rangesUnicode;
     RefPtr<CharacterClassTable> m_table;
+    // Filled in for the interpreter by BytecodePattern.
+    uint32_t m_asciiBitmap[4];
+    bool m_hasASCIIBitmap;
 };
 
 enum QuantifierType {
@@ -350,6 +358,18 @@ struct YarrPattern {
         return m_maxBackReference > m_numSubpatterns;
     }
 
+    // Finds literal text every match must contain: the characters every match starts with,
+    // and the longest run of characters every match contains. Either may be left empty.
+    void requiredLiterals(Vector<UChar>& prefix, Vector<UChar>& longestRun) const;
+
+    // Makes every group non-capturing, for code that only reports whether and where a match
+    // starts. Backreferences still refer to the groups, so the pattern must not contain any.
+    void removeCaptures();
+
+    // True if a group with a variable count contains alternatives or a variable-count term,
+    // the shape behind catastrophic backtracking such as /(a+)+b/ or /(a|aa)*b/.
+    bool containsNestedQuantifiers() const;
+
     CharacterClass* newlineCharacterClass()
     {
         if (!newlineCached)